@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace AT2::Benchmarks
+{
+    // Prevents compiler from optimizing away results of measured code
+    template <typename T>
+    void DoNotOptimize(const T& value)
+    {
+        static_cast<void>(*reinterpret_cast<const volatile char*>(&value));
+    }
+
+    struct Result
+    {
+        std::chrono::duration<double, std::milli> Best;
+        std::chrono::duration<double, std::milli> Median;
+    };
+
+    // Runs func several times and prints best and median time
+    template <typename Func>
+    Result Measure(std::string_view name, Func&& func, int repetitions = 7)
+    {
+        std::vector<std::chrono::duration<double, std::milli>> timings;
+        timings.reserve(repetitions);
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            timings.emplace_back(std::chrono::steady_clock::now() - start);
+        }
+
+        std::sort(timings.begin(), timings.end());
+        const Result result {timings.front(), timings[timings.size() / 2]};
+
+        std::cout << std::left << std::setw(64) << name << std::right << std::fixed << std::setprecision(3)
+                  << " best " << std::setw(10) << result.Best.count() << " ms"
+                  << " median " << std::setw(10) << result.Median.count() << " ms" << std::endl;
+
+        return result;
+    }
+
+    // Every benchmark group registers itself in main.cpp
+    void RunClusterCullingBenchmarks();
+    void RunLightClustersBenchmarks();
+    void RunLruCacheBenchmarks();
+    void RunMeshOptimizerBenchmarks();
+    void RunOcclusionCullingBenchmarks();
+    void RunRangeAllocatorBenchmarks();
+    void RunSceneLoadBenchmarks();
+    void RunTextureDecodeBenchmarks();
+
+} // namespace AT2::Benchmarks
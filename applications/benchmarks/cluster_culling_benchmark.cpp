@@ -0,0 +1,104 @@
+#include "benchmark.h"
+
+#include <ClusterCuller.h>
+#include <MeshOptimizer.h>
+#include <ThreadPool.h>
+
+#include <cmath>
+#include <string>
+
+using namespace AT2;
+using namespace AT2::Benchmarks;
+
+namespace
+{
+    constexpr int GridSize = 32;        // instances along every side of the city block
+    constexpr float InstanceSpacing = 4.0f;
+
+    struct TestMesh
+    {
+        std::vector<glm::vec3> Positions;
+        std::vector<uint32_t> Indices;
+    };
+
+    // Unit UV sphere, closed and curved, so about a half of it's meshlets face away from any viewer
+    TestMesh MakeSphere(uint32_t numRings, uint32_t numSegments)
+    {
+        TestMesh result;
+        for (uint32_t ring = 0; ring <= numRings; ++ring)
+        {
+            const float theta = glm::pi<float>() * static_cast<float>(ring) / static_cast<float>(numRings);
+            for (uint32_t segment = 0; segment <= numSegments; ++segment)
+            {
+                const float phi = glm::two_pi<float>() * static_cast<float>(segment) / static_cast<float>(numSegments);
+                result.Positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            }
+        }
+
+        for (uint32_t ring = 0; ring < numRings; ++ring)
+            for (uint32_t segment = 0; segment < numSegments; ++segment)
+            {
+                const uint32_t corner = ring * (numSegments + 1) + segment;
+                result.Indices.insert(result.Indices.end(), {corner, corner + 1, corner + numSegments + 1});
+                result.Indices.insert(result.Indices.end(), {corner + 1, corner + numSegments + 2, corner + numSegments + 1});
+            }
+
+        return result;
+    }
+
+    void PrintStatistics(const ClusterCuller::Statistics& statistics)
+    {
+        const auto percentOf = [&](size_t count) { return 100.0 * static_cast<double>(count) / static_cast<double>(statistics.NumClusters); };
+
+        std::cout << "    " << statistics.NumClusters << " clusters: " << percentOf(statistics.NumFrustumCulled) << "% out of frustum, "
+                  << percentOf(statistics.NumBackfaceCulled) << "% back facing, " << percentOf(statistics.GetNumVisible()) << "% visible"
+                  << std::endl;
+    }
+} // namespace
+
+void AT2::Benchmarks::RunClusterCullingBenchmarks()
+{
+    const auto sphere = MakeSphere(128, 256);
+    const auto indices = MeshOptimizer::OptimizeVertexCache(sphere.Indices, sphere.Positions.size());
+
+    std::vector<Meshlet> meshlets;
+    Measure("build meshlets of " + std::to_string(indices.size() / 3) + " triangles",
+            [&] { meshlets = MeshletSet::Build(indices, sphere.Positions); }, 3);
+
+    MeshletSet meshletSet;
+    meshletSet.Append(meshlets, MeshChunk {Primitives::Triangles {}, 0, static_cast<unsigned int>(indices.size())});
+    std::cout << "    " << meshletSet.Size() << " meshlets, " << static_cast<double>(indices.size() / 3) / static_cast<double>(meshletSet.Size())
+              << " triangles per meshlet" << std::endl;
+
+    // camera stands between instances in the middle of the grid and looks along it's rows
+    std::vector<ClusterCuller::Instance> instances;
+    for (int z = 0; z < GridSize; ++z)
+        for (int x = 0; x < GridSize; ++x)
+        {
+            const glm::vec3 position {static_cast<float>(x - GridSize / 2), 0.0f, static_cast<float>(z - GridSize / 2)};
+            instances.push_back({&meshletSet, glm::translate(glm::mat4 {1.0f}, position * InstanceSpacing)});
+        }
+
+    const auto view = glm::lookAt(glm::vec3 {2.0f, 2.0f, 2.0f}, glm::vec3 {100.0f, 2.0f, 2.0f}, glm::vec3 {0.0f, 1.0f, 0.0f});
+    const auto projection = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    ClusterCuller culler {view, projection};
+
+    const auto name = std::to_string(instances.size()) + " instances, " + std::to_string(instances.size() * meshletSet.Size()) + " clusters";
+    const auto measureCulling = [&](std::string_view mode, ThreadPool* threadPool) {
+        DrawBatch batch;
+        ClusterCuller::Statistics statistics;
+        const auto result = Measure(name + " " + std::string {mode}, [&] {
+            batch.Clear();
+            statistics = culler.Cull(instances, batch, threadPool);
+        });
+
+        PrintStatistics(statistics);
+        std::cout << "    " << batch.GetCommands().size() << " commands, "
+                  << static_cast<double>(statistics.NumClusters) / result.Best.count() / 1000.0 << " M clusters/s" << std::endl;
+    };
+
+    measureCulling("serial", nullptr);
+
+    ThreadPool threadPool;
+    measureCulling("threads x" + std::to_string(threadPool.GetNumThreads()), &threadPool);
+}
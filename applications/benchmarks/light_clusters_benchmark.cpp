@@ -0,0 +1,61 @@
+#include "benchmark.h"
+
+#include <LightBudget.h>
+#include <LightClusters.h>
+#include <ThreadPool.h>
+
+#include <random>
+#include <string>
+
+using namespace AT2;
+using namespace AT2::Benchmarks;
+
+void AT2::Benchmarks::RunLightClustersBenchmarks()
+{
+    // lights are scattered over a street level area around the camera, most of them are small
+    std::mt19937 random {1};
+    std::uniform_real_distribution<float> position {-300.0f, 300.0f}, height {0.0f, 20.0f};
+    std::exponential_distribution<float> radius {0.1f};
+
+    std::vector<LightClusters::Light> lights(16384);
+    for (auto& light : lights)
+        light = {{position(random), height(random), position(random)}, std::min(radius(random) + 1.0f, 100.0f)};
+
+    const auto view = glm::lookAt(glm::vec3 {0.0f, 2.0f, 0.0f}, glm::vec3 {0.0f, 2.0f, -100.0f}, glm::vec3 {0.0f, 1.0f, 0.0f});
+    const auto projection = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+    ThreadPool threadPool;
+    for (const size_t numLights : {1024, 4096, 16384})
+    {
+        const auto subset = std::span {lights}.first(numLights);
+
+        LightClusters clusters;
+        clusters.SetView(view, projection);
+
+        LightClusters::Statistics statistics;
+        Measure("assign " + std::to_string(numLights) + " lights", [&] { statistics = clusters.Assign(subset); });
+        Measure("assign " + std::to_string(numLights) + " lights in parallel", [&] { statistics = clusters.Assign(subset, &threadPool); });
+
+        std::cout << "    " << statistics.NumVisibleLights << " visible, " << statistics.NumOccupiedClusters << " of "
+                  << clusters.GetNumClusters() << " clusters occupied, " << statistics.NumIndices << " indices, up to "
+                  << statistics.MaxLightsPerCluster << " lights per cluster" << std::endl;
+    }
+
+    // same lights with the intensities they fall off to the default cutoff at their radii
+    std::vector<LightBudget::Light> budgetLights(lights.size());
+    std::ranges::transform(lights, budgetLights.begin(), [](const LightClusters::Light& light) {
+        return LightBudget::Light {light.Position, glm::vec3 {DefaultLightLuminanceCutoff * (light.Radius * light.Radius + 1.0f)}, light.Radius};
+    });
+
+    for (const size_t maxLights : {256, 1024})
+    {
+        LightBudget budget {maxLights};
+
+        LightBudget::Statistics statistics;
+        Measure("select " + std::to_string(maxLights) + " of " + std::to_string(budgetLights.size()) + " lights",
+                [&] { statistics = budget.Select(budgetLights, view, projection); });
+
+        std::cout << "    " << statistics.NumCulled << " culled, " << statistics.NumMerged << " merged, "
+                  << statistics.NumDropped << " dropped" << std::endl;
+    }
+}
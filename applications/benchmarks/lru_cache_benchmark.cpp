@@ -0,0 +1,148 @@
+#include "benchmark.h"
+
+#include <lru_cache.h>
+
+#include <cassert>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace AT2::Benchmarks;
+
+namespace
+{
+    // Previous std::list + std::unordered_map based implementation, kept for comparison
+    template <typename Key, typename Value>
+    class list_lru_cache
+    {
+    public:
+        using key_type = Key;
+        using value_type = std::pair<key_type, Value>;
+
+        explicit list_lru_cache(size_t capacity) : m_index {capacity * 2}, m_capacity {capacity} {}
+
+        template <typename ValueFactoryFunc, typename ValueDroppedFunc>
+        value_type& put(const key_type& key, ValueFactoryFunc&& valueFactory, ValueDroppedFunc&& valueDroppedCallback)
+        {
+            const auto [iterator, isNew] = m_index.emplace(key, ListIterator {});
+            if (isNew)
+            {
+                if (m_cache.size() == m_capacity)
+                {
+                    std::forward<ValueDroppedFunc>(valueDroppedCallback)(std::move(m_cache.back()));
+
+                    m_index.erase(m_cache.back().first);
+                    m_cache.pop_back();
+                }
+
+                m_cache.emplace_front(std::piecewise_construct, std::tuple {key}, std::forward_as_tuple(std::forward<ValueFactoryFunc>(valueFactory)(key)));
+            }
+            else
+                m_cache.splice(m_cache.begin(), m_cache, iterator->second);
+
+            iterator->second = m_cache.begin();
+            return m_cache.front();
+        }
+
+        [[nodiscard]] std::optional<const std::reference_wrapper<Value>> find(const key_type& key) const noexcept
+        {
+            if (auto it = m_index.find(key); it != m_index.end())
+                return it->second->second;
+
+            return std::nullopt;
+        }
+
+    private:
+        using ListType = std::list<value_type>;
+        using ListIterator = typename ListType::iterator;
+
+        ListType m_cache;
+        std::unordered_map<key_type, ListIterator> m_index;
+        size_t m_capacity;
+    };
+
+    // Keys are drawn from range [0, capacity / hitRate), so with uniform distribution the steady state hit rate is about hitRate
+    std::vector<size_t> MakeKeys(size_t capacity, double hitRate, size_t count)
+    {
+        std::mt19937_64 generator {42};
+        std::uniform_int_distribution<size_t> distribution {0, static_cast<size_t>(static_cast<double>(capacity) / hitRate) - 1};
+
+        std::vector<size_t> keys(count);
+        for (auto& key : keys)
+            key = distribution(generator);
+
+        return keys;
+    }
+
+    template <typename Cache, typename Key>
+    void PutAll(size_t capacity, const std::vector<Key>& keys)
+    {
+        Cache cache {capacity};
+        size_t checksum = 0;
+        for (const auto& key : keys)
+            checksum += cache.put(key, [](const Key&) { return size_t {1}; }, [](auto&&) {}).second;
+
+        DoNotOptimize(checksum);
+    }
+
+    // Cache is filled with distinct resident keys first, so lookups start from the full cache
+    template <typename Cache, typename Key>
+    void FindAll(const std::vector<Key>& residentKeys, const std::vector<Key>& keys)
+    {
+        Cache cache {residentKeys.size()};
+        for (const auto& key : residentKeys)
+            cache.put(key, [](const Key&) { return size_t {1}; }, [](auto&&) {});
+
+        size_t checksum = 0;
+        for (const auto& key : keys)
+            if (const auto value = cache.find(key))
+                checksum += value->get();
+
+        DoNotOptimize(checksum);
+    }
+
+    template <typename Key>
+    void CompareImplementations(std::string_view keyName, double hitRate, const std::vector<Key>& residentKeys, const std::vector<Key>& keys)
+    {
+        const size_t capacity = residentKeys.size();
+        const auto suffix = std::string {keyName} + " capacity " + std::to_string(capacity) + " hit rate " + std::to_string(static_cast<int>(hitRate * 100)) + "%";
+
+        Measure("put  list_lru_cache " + suffix, [&] { PutAll<list_lru_cache<Key, size_t>>(capacity, keys); });
+        Measure("put  lru_cache      " + suffix, [&] { PutAll<lru_cache<Key, size_t>>(capacity, keys); });
+        Measure("find list_lru_cache " + suffix, [&] { FindAll<list_lru_cache<Key, size_t>>(residentKeys, keys); });
+        Measure("find lru_cache      " + suffix, [&] { FindAll<lru_cache<Key, size_t>>(residentKeys, keys); });
+    }
+} // namespace
+
+void AT2::Benchmarks::RunLruCacheBenchmarks()
+{
+    constexpr size_t numOperations = 1'000'000;
+
+    for (const size_t capacity : {16, 32, 256, 4096})
+    {
+        for (const double hitRate : {0.5, 0.9, 0.99})
+        {
+            const auto keys = MakeKeys(capacity, hitRate, numOperations);
+            std::vector<size_t> residentKeys(capacity);
+            std::iota(residentKeys.begin(), residentKeys.end(), size_t {0});
+            CompareImplementations("size_t", hitRate, residentKeys, keys);
+
+            // pointer keys are hashed and copied differently from integers
+            std::vector<std::shared_ptr<int>> pool(static_cast<size_t>(static_cast<double>(capacity) / hitRate));
+            for (auto& ptr : pool)
+                ptr = std::make_shared<int>();
+
+            std::vector<std::shared_ptr<int>> pointerKeys;
+            pointerKeys.reserve(keys.size());
+            for (const auto key : keys)
+                pointerKeys.push_back(pool[key]);
+
+            const std::vector residentPointerKeys(pool.begin(), pool.begin() + static_cast<std::ptrdiff_t>(capacity));
+            CompareImplementations("shared_ptr", hitRate, residentPointerKeys, pointerKeys);
+        }
+    }
+}
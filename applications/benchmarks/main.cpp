@@ -0,0 +1,46 @@
+#include "benchmark.h"
+
+#include <map>
+#include <string>
+
+using namespace AT2::Benchmarks;
+
+// Usage: AT2_benchmarks [group names...], runs all groups when no names are given
+int main(int argc, char* argv[])
+{
+    const std::map<std::string, std::function<void()>, std::less<>> groups {
+        {"cluster_culling", RunClusterCullingBenchmarks},
+        {"light_clusters", RunLightClustersBenchmarks},
+        {"lru_cache", RunLruCacheBenchmarks},
+        {"mesh_optimizer", RunMeshOptimizerBenchmarks},
+        {"occlusion_culling", RunOcclusionCullingBenchmarks},
+        {"range_allocator", RunRangeAllocatorBenchmarks},
+        {"scene_load", RunSceneLoadBenchmarks},
+        {"texture_decode", RunTextureDecodeBenchmarks},
+    };
+
+    if (argc <= 1)
+    {
+        for (const auto& [name, run] : groups)
+        {
+            std::cout << "== " << name << " ==" << std::endl;
+            run();
+        }
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto it = groups.find(std::string_view {argv[i]});
+        if (it == groups.end())
+        {
+            std::cerr << "Unknown benchmark group: " << argv[i] << std::endl;
+            return 1;
+        }
+
+        std::cout << "== " << it->first << " ==" << std::endl;
+        it->second();
+    }
+
+    return 0;
+}
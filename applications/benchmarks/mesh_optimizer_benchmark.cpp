@@ -0,0 +1,89 @@
+#include "benchmark.h"
+
+#include <MeshOptimizer.h>
+#include <MeshSimplifier.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+
+using namespace AT2;
+using namespace AT2::Benchmarks;
+
+namespace
+{
+    struct TestMesh
+    {
+        std::string Name;
+        std::vector<glm::vec3> Positions;
+        std::vector<uint32_t> Indices;
+    };
+
+    // UV sphere with triangles in the random order, like meshes exported without any optimization
+    TestMesh MakeShuffledSphere(uint32_t numRings, uint32_t numSegments)
+    {
+        TestMesh result {"shuffled sphere " + std::to_string(numRings) + "x" + std::to_string(numSegments)};
+        for (uint32_t ring = 0; ring <= numRings; ++ring)
+        {
+            const float theta = glm::pi<float>() * static_cast<float>(ring) / static_cast<float>(numRings);
+            for (uint32_t segment = 0; segment <= numSegments; ++segment)
+            {
+                const float phi = glm::two_pi<float>() * static_cast<float>(segment) / static_cast<float>(numSegments);
+                result.Positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            }
+        }
+
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t ring = 0; ring < numRings; ++ring)
+            for (uint32_t segment = 0; segment < numSegments; ++segment)
+            {
+                const uint32_t corner = ring * (numSegments + 1) + segment;
+                triangles.push_back({corner, corner + numSegments + 1, corner + 1});
+                triangles.push_back({corner + 1, corner + numSegments + 1, corner + numSegments + 2});
+            }
+
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937 {1234});
+        for (const auto& triangle : triangles)
+            result.Indices.insert(result.Indices.end(), triangle.begin(), triangle.end());
+
+        return result;
+    }
+
+    void PrintStatistics(std::string_view stage, const MeshOptimizer::Statistics& statistics)
+    {
+        std::cout << "    " << std::left << std::setw(16) << stage << std::right << " ACMR " << statistics.GetACMR() << ", ATVR "
+                  << statistics.GetATVR() << std::endl;
+    }
+} // namespace
+
+void AT2::Benchmarks::RunMeshOptimizerBenchmarks()
+{
+    for (const auto& mesh : {MakeShuffledSphere(64, 128), MakeShuffledSphere(256, 512)})
+    {
+        const auto numVertices = mesh.Positions.size();
+
+        std::vector<uint32_t> cacheOptimized, overdrawOptimized, fetchOptimized;
+        Measure(mesh.Name + " vertex cache", [&] { cacheOptimized = MeshOptimizer::OptimizeVertexCache(mesh.Indices, numVertices); }, 3);
+        Measure(mesh.Name + " overdraw", [&] { overdrawOptimized = MeshOptimizer::OptimizeOverdraw(cacheOptimized, mesh.Positions); }, 3);
+        Measure(mesh.Name + " vertex fetch", [&] {
+            fetchOptimized = overdrawOptimized;
+            DoNotOptimize(MeshOptimizer::OptimizeVertexFetch(fetchOptimized, numVertices));
+        }, 3);
+
+        PrintStatistics("original", MeshOptimizer::AnalyzeVertexCache(mesh.Indices, numVertices));
+        PrintStatistics("vertex cache", MeshOptimizer::AnalyzeVertexCache(cacheOptimized, numVertices));
+        PrintStatistics("overdraw", MeshOptimizer::AnalyzeVertexCache(overdrawOptimized, numVertices));
+
+        std::vector<uint32_t> withLods;
+        std::vector<MeshSimplifier::LodRange> lods;
+        Measure(mesh.Name + " lod chain", [&] {
+            withLods = overdrawOptimized;
+            lods = MeshSimplifier::AppendLods(withLods, mesh.Positions);
+        }, 1);
+
+        for (size_t lod = 0; lod < lods.size(); ++lod)
+            std::cout << "    lod " << lod + 1 << ": " << lods[lod].Count / 3 << " of " << mesh.Indices.size() / 3 << " triangles, error "
+                      << lods[lod].Error << std::endl;
+    }
+}
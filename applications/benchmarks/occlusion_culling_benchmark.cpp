@@ -0,0 +1,80 @@
+#include "benchmark.h"
+
+#include <OcclusionBuffer.h>
+
+#include <string>
+
+using namespace AT2;
+using namespace AT2::Benchmarks;
+
+namespace
+{
+    constexpr int NumBlocks = 16;        // city blocks along every side
+    constexpr float BlockSpacing = 40.0f;
+    constexpr int ObjectsPerBlock = 64;  // small objects at every block, the outer ones are at the streets
+
+    // Unit cube with counter-clockwise faces looking outside
+    OccluderMesh MakeBox()
+    {
+        OccluderMesh box;
+        for (unsigned int corner = 0; corner < 8; ++corner)
+            box.Positions.emplace_back(corner & 1 ? 0.5f : -0.5f, corner & 2 ? 0.5f : -0.5f, corner & 4 ? 0.5f : -0.5f);
+
+        box.Indices = {0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6, 0, 1, 5, 0, 5, 4,
+                       2, 6, 7, 2, 7, 3, 0, 4, 6, 0, 6, 2, 1, 3, 7, 1, 7, 5};
+        return box;
+    }
+
+    struct Bounds
+    {
+        glm::vec3 Min, Max;
+    };
+} // namespace
+
+void AT2::Benchmarks::RunOcclusionCullingBenchmarks()
+{
+    // buildings stand in a grid of streets, the camera is at the street level and looks along one of them
+    const auto box = MakeBox();
+    std::vector<glm::mat4> buildings;
+    std::vector<Bounds> objects;
+    for (int z = 0; z < NumBlocks; ++z)
+        for (int x = 0; x < NumBlocks; ++x)
+        {
+            const glm::vec3 center {static_cast<float>(x - NumBlocks / 2) * BlockSpacing, 0.0f,
+                                    static_cast<float>(z - NumBlocks / 2) * BlockSpacing};
+            buildings.push_back(glm::scale(glm::translate(glm::mat4 {1.0f}, center + glm::vec3 {0.0f, 15.0f, 0.0f}), {30.0f, 30.0f, 30.0f}));
+
+            for (int i = 0; i < ObjectsPerBlock; ++i)
+            {
+                const glm::vec3 offset {static_cast<float>(i % 8) * 5.0f - 17.5f, 1.0f, static_cast<float>(i / 8) * 5.0f - 17.5f};
+                objects.push_back({center + offset - 0.5f, center + offset + 0.5f});
+            }
+        }
+
+    const auto view = glm::lookAt(glm::vec3 {BlockSpacing / 2, 2.0f, 0.0f}, glm::vec3 {BlockSpacing / 2, 2.0f, -100.0f},
+                                  glm::vec3 {0.0f, 1.0f, 0.0f});
+    const auto projection = glm::perspective(glm::radians(90.0f), 2.0f, 0.1f, 1000.0f);
+
+    for (const auto size : {glm::uvec2 {256, 128}, glm::uvec2 {512, 256}})
+    {
+        OcclusionBuffer buffer {size};
+        const auto sizeName = std::to_string(size.x) + "x" + std::to_string(size.y);
+
+        Measure("render " + std::to_string(buildings.size()) + " occluders at " + sizeName, [&] {
+            buffer.Clear(projection * view);
+            for (const auto& model : buildings)
+                buffer.RenderOccluder(box, model);
+            buffer.Resolve();
+        });
+        std::cout << "    " << buffer.GetNumRasterizedTriangles() << " triangles rasterized" << std::endl;
+
+        size_t numOccluded = 0;
+        const auto result = Measure("test " + std::to_string(objects.size()) + " boxes at " + sizeName, [&] {
+            numOccluded = 0;
+            for (const auto& [min, max] : objects)
+                numOccluded += buffer.IsOccluded(min, max, glm::mat4 {1.0f});
+        });
+        std::cout << "    " << 100.0 * static_cast<double>(numOccluded) / static_cast<double>(objects.size()) << "% occluded, "
+                  << static_cast<double>(objects.size()) / result.Best.count() / 1000.0 << " M boxes/s" << std::endl;
+    }
+}
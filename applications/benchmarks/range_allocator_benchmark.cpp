@@ -0,0 +1,75 @@
+#include "benchmark.h"
+
+#include <RangeAllocator.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+using namespace AT2;
+using namespace AT2::Benchmarks;
+
+namespace
+{
+    struct WorkloadResult
+    {
+        size_t FailedAllocations = 0;
+        double Fragmentation = 0.0;
+        size_t NumFreeBlocks = 0;
+        double Occupancy = 0.0;
+    };
+
+    // Simulates meshes streaming in and out: allocations with log-uniform sizes, random frees keeping occupancy near targetOccupancy
+    WorkloadResult RunWorkload(size_t capacity, size_t minSize, size_t maxSize, double targetOccupancy, size_t numOperations)
+    {
+        RangeAllocator allocator {capacity};
+        std::mt19937_64 generator {1234};
+        std::uniform_real_distribution<double> logSize {std::log(static_cast<double>(minSize)), std::log(static_cast<double>(maxSize))};
+
+        std::vector<RangeAllocator::Allocation> allocations;
+        WorkloadResult result;
+
+        for (size_t i = 0; i < numOperations; ++i)
+        {
+            const double occupancy = 1.0 - static_cast<double>(allocator.GetFreeSpace()) / static_cast<double>(capacity);
+            if (!allocations.empty() && occupancy > targetOccupancy)
+            {
+                const size_t index = generator() % allocations.size();
+                allocator.Free(allocations[index]);
+                allocations[index] = allocations.back();
+                allocations.pop_back();
+                continue;
+            }
+
+            if (const auto allocation = allocator.Allocate(static_cast<size_t>(std::exp(logSize(generator)))))
+                allocations.push_back(*allocation);
+            else
+                ++result.FailedAllocations;
+        }
+
+        result.Fragmentation = allocator.GetFragmentation();
+        result.NumFreeBlocks = allocator.GetNumFreeBlocks();
+        result.Occupancy = 1.0 - static_cast<double>(allocator.GetFreeSpace()) / static_cast<double>(capacity);
+        return result;
+    }
+} // namespace
+
+void AT2::Benchmarks::RunRangeAllocatorBenchmarks()
+{
+    constexpr size_t capacity = 1 << 24;
+    constexpr size_t numOperations = 200'000;
+
+    for (const auto& [minSize, maxSize] : {std::pair<size_t, size_t> {64, 4096}, {256, 65536}, {1024, 1 << 20}})
+    {
+        for (const double targetOccupancy : {0.5, 0.75, 0.9})
+        {
+            WorkloadResult result;
+            Measure("sizes " + std::to_string(minSize) + ".." + std::to_string(maxSize) + " occupancy " +
+                        std::to_string(static_cast<int>(targetOccupancy * 100)) + "%",
+                    [&] { result = RunWorkload(capacity, minSize, maxSize, targetOccupancy, numOperations); }, 3);
+
+            std::cout << "    fragmentation " << result.Fragmentation << ", free blocks " << result.NumFreeBlocks
+                      << ", occupancy " << result.Occupancy << ", failed allocations " << result.FailedAllocations << std::endl;
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include "benchmark.h"
+
+#include <Resources/CookedScene.h>
+#include <Resources/GltfSceneLoader.h>
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace AT2;
+using namespace AT2::Resources;
+using namespace AT2::Benchmarks;
+
+namespace
+{
+    // glTF scene of numMeshes shuffled grids, each one has positions, normals, texture coordinates and 32-bit indices
+    std::filesystem::path WriteTestScene(const std::filesystem::path& directory, int numMeshes, uint32_t gridSize)
+    {
+        std::vector<std::byte> binary;
+        const auto append = [&binary](const auto& values) {
+            const auto bytes = std::as_bytes(std::span {values});
+            const auto offset = binary.size();
+            binary.insert(binary.end(), bytes.begin(), bytes.end());
+            return std::pair {offset, bytes.size()};
+        };
+
+        std::ostringstream bufferViews, accessors, meshes, nodes;
+        std::mt19937 generator {1234};
+        int numViews = 0;
+        const auto addAccessor = [&](std::pair<size_t, size_t> view, size_t count, int componentType, std::string_view type) {
+            bufferViews << (numViews ? "," : "") << R"({"buffer":0,"byteOffset":)" << view.first << R"(,"byteLength":)" << view.second << "}";
+            accessors << (numViews ? "," : "") << R"({"bufferView":)" << numViews << R"(,"componentType":)" << componentType
+                      << R"(,"count":)" << count << R"(,"type":")" << type << R"("})";
+            return numViews++;
+        };
+
+        for (int mesh = 0; mesh < numMeshes; ++mesh)
+        {
+            std::vector<glm::vec3> positions, normals;
+            std::vector<glm::vec2> texCoords;
+            for (uint32_t y = 0; y <= gridSize; ++y)
+                for (uint32_t x = 0; x <= gridSize; ++x)
+                {
+                    const glm::vec2 uv {static_cast<float>(x) / gridSize, static_cast<float>(y) / gridSize};
+                    positions.emplace_back(uv.x, uv.y, 0.1f * std::sin(uv.x * 6.0f + static_cast<float>(mesh)));
+                    normals.emplace_back(0.0f, 0.0f, 1.0f);
+                    texCoords.push_back(uv);
+                }
+
+            std::vector<std::array<uint32_t, 3>> triangles;
+            for (uint32_t y = 0; y < gridSize; ++y)
+                for (uint32_t x = 0; x < gridSize; ++x)
+                {
+                    const uint32_t corner = y * (gridSize + 1) + x;
+                    triangles.push_back({corner, corner + 1, corner + gridSize + 2});
+                    triangles.push_back({corner, corner + gridSize + 2, corner + gridSize + 1});
+                }
+            std::shuffle(triangles.begin(), triangles.end(), generator);
+
+            const auto position = addAccessor(append(positions), positions.size(), 5126, "VEC3");
+            const auto normal = addAccessor(append(normals), normals.size(), 5126, "VEC3");
+            const auto texCoord = addAccessor(append(texCoords), texCoords.size(), 5126, "VEC2");
+            const auto indices = addAccessor(append(triangles), triangles.size() * 3, 5125, "SCALAR");
+
+            meshes << (mesh ? "," : "") << R"({"name":"grid )" << mesh << R"(","primitives":[{"attributes":{"POSITION":)" << position
+                   << R"(,"NORMAL":)" << normal << R"(,"TEXCOORD_0":)" << texCoord << R"(},"indices":)" << indices << "}]}";
+            nodes << (mesh ? "," : "") << R"({"mesh":)" << mesh << R"(,"translation":[)" << mesh << ",0,0]}";
+        }
+
+        std::filesystem::create_directories(directory);
+        const auto binaryPath = directory / "scene.bin";
+        std::ofstream {binaryPath, std::ios::binary}.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+
+        std::ostringstream sceneNodes;
+        for (int node = 0; node < numMeshes; ++node)
+            sceneNodes << (node ? "," : "") << node;
+
+        const auto scenePath = directory / "scene.gltf";
+        std::ofstream {scenePath} << R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[)" << sceneNodes.str() << R"(]}],"nodes":[)"
+                                  << nodes.str() << R"(],"meshes":[)" << meshes.str() << R"(],"accessors":[)" << accessors.str()
+                                  << R"(],"bufferViews":[)" << bufferViews.str() << R"(],"buffers":[{"uri":"scene.bin","byteLength":)"
+                                  << binary.size() << "}]}";
+
+        return scenePath;
+    }
+} // namespace
+
+// CPU-side part of the scene loading: glTF has to be parsed and it's geometry converted and optimized at every start,
+// cooked scene is just mapped, so it's cost is the metadata only
+void AT2::Benchmarks::RunSceneLoadBenchmarks()
+{
+    const auto directory = std::filesystem::temp_directory_path() / "at2_scene_load_benchmark";
+    const auto cookedPath = directory / "scene.at2scene";
+
+    for (const auto [numMeshes, gridSize] : {std::pair {16, 64u}, std::pair {256, 16u}})
+    {
+        const auto scenePath = WriteTestScene(directory, numMeshes, gridSize);
+        const auto name = std::to_string(numMeshes) + " meshes of " + std::to_string(2 * gridSize * gridSize) + " triangles";
+
+        Measure(name + " glTF parse and prepare", [&] { DoNotOptimize(GltfMeshLoader::Cook(scenePath)); }, 3);
+        GltfMeshLoader::Cook(scenePath).Save(cookedPath);
+
+        Measure(name + " cooked load", [&] { DoNotOptimize(CookedScene::Load(cookedPath)); });
+        std::cout << "    cooked file is " << std::filesystem::file_size(cookedPath) / 1024 << " KB" << std::endl;
+    }
+
+    std::filesystem::remove_all(directory);
+}
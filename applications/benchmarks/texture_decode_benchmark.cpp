@@ -0,0 +1,94 @@
+#include "benchmark.h"
+
+#include <Resources/TextureLoader.h>
+#include <ThreadPool.h>
+
+#include <random>
+#include <string>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+using namespace AT2;
+using namespace AT2::Benchmarks;
+
+namespace
+{
+    using EncodedImage = std::vector<std::byte>;
+
+    // Smooth gradients with some noise, so images are compressed like real textures rather than flat fills
+    std::vector<std::uint8_t> GeneratePixels(int size, int numChannels, std::mt19937& generator)
+    {
+        std::uniform_int_distribution<int> noise {0, 31};
+
+        std::vector<std::uint8_t> pixels(static_cast<size_t>(size) * size * numChannels);
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                for (int c = 0; c < numChannels; ++c)
+                    pixels[(static_cast<size_t>(y) * size + x) * numChannels + c] =
+                        static_cast<std::uint8_t>((x * (c + 1) + y * (3 - c)) / 16 + noise(generator));
+
+        return pixels;
+    }
+
+    std::vector<EncodedImage> EncodeImages(bool usePng, int size, int numImages)
+    {
+        constexpr int numChannels = 4;
+        std::mt19937 generator {1234};
+
+        const auto writeCallback = [](void* context, void* data, int length) {
+            const auto bytes = std::span {static_cast<const std::byte*>(data), static_cast<size_t>(length)};
+            static_cast<EncodedImage*>(context)->insert(static_cast<EncodedImage*>(context)->end(), bytes.begin(), bytes.end());
+        };
+
+        std::vector<EncodedImage> images(numImages);
+        for (auto& image : images)
+        {
+            const auto pixels = GeneratePixels(size, numChannels, generator);
+            if (usePng)
+                stbi_write_png_to_func(writeCallback, &image, size, size, numChannels, pixels.data(), size * numChannels);
+            else
+                stbi_write_jpg_to_func(writeCallback, &image, size, size, numChannels, pixels.data(), 90);
+        }
+
+        return images;
+    }
+
+    void PrintThroughput(const Result& result, size_t decodedBytes)
+    {
+        const double seconds = std::chrono::duration<double>(result.Median).count();
+        std::cout << "    " << static_cast<double>(decodedBytes) / (1 << 20) / seconds << " MB/s decoded" << std::endl;
+    }
+} // namespace
+
+void AT2::Benchmarks::RunTextureDecodeBenchmarks()
+{
+    constexpr int imageSize = 2048;
+    constexpr int numImages = 16;
+
+    for (const bool usePng : {false, true})
+    {
+        const auto images = EncodeImages(usePng, imageSize, numImages);
+        const std::string prefix = std::string {usePng ? "png" : "jpg"} + " " + std::to_string(numImages) + "x" + std::to_string(imageSize) + "^2";
+
+        size_t decodedBytes = 0;
+        const auto serialResult = Measure(prefix + " serial", [&] {
+            decodedBytes = 0;
+            for (const auto& image : images)
+                decodedBytes += Resources::TextureLoader::DecodeImage(image).DataLength;
+        }, 3);
+        PrintThroughput(serialResult, decodedBytes);
+
+        ThreadPool threadPool;
+        const auto parallelResult = Measure(prefix + " thread pool (" + std::to_string(threadPool.GetNumThreads()) + " threads)", [&] {
+            std::vector<std::future<Resources::DecodedImage>> decodedImages;
+            for (const auto& image : images)
+                decodedImages.push_back(threadPool.Submit([&image] { return Resources::TextureLoader::DecodeImage(image); }));
+
+            decodedBytes = 0;
+            for (auto& decodedImage : decodedImages)
+                decodedBytes += decodedImage.get().DataLength;
+        }, 3);
+        PrintThroughput(parallelResult, decodedBytes);
+    }
+}
@@ -1,5 +1,10 @@
+#include <ClusterCuller.h>
+#include <DrawBatch.h>
 #include <Mesh.h>
 
+#include <optional>
+#include <ranges>
+
 namespace AT2::Utils::MeshRenderer
 {
 	static void DrawSubmesh(IRenderer& renderer, const Mesh& mesh, const SubMesh& subMesh, size_t numInstances = 1)
@@ -9,9 +14,66 @@ namespace AT2::Utils::MeshRenderer
 	    if (!mesh.Materials.empty())
 	        mesh.Materials.at(subMesh.MaterialIndex)->Bind(stateManager);
 
-	    for (const auto& primitive : subMesh.Primitives)
-	        renderer.Draw(primitive.Type, primitive.StartElement, primitive.Count, static_cast<int>(numInstances),
-	                       primitive.BaseVertex);
+        static thread_local DrawBatch batch;
+        batch.Clear();
+        batch.Add(subMesh, static_cast<unsigned int>(numInstances));
+        batch.Submit(renderer);
+	}
+
+    // Consecutive submeshes with the same material are submitted by one batch. lods are levels of detail of the submeshes,
+    // full detail is drawn if they aren't given. When clusterCuller is given, only visible meshlets of the full detail are
+    // drawn, model is the transform they are culled by
+    template <std::ranges::input_range SubmeshIndices>
+	static void DrawSubmeshes(IRenderer& renderer, const Mesh& mesh, const SubmeshIndices& submeshIndices, size_t numInstances = 1,
+                              std::span<const unsigned> lods = {}, const ClusterCuller* clusterCuller = nullptr,
+                              const glm::mat4& model = glm::mat4 {1.0f})
+	{
+        auto& stateManager = renderer.GetStateManager();
+
+        static thread_local DrawBatch batch;
+        batch.Clear();
+
+        std::optional<unsigned int> batchMaterial;
+        const auto flush = [&] {
+            if (batch.Empty())
+                return;
+
+            if (!mesh.Materials.empty())
+                mesh.Materials.at(*batchMaterial)->Bind(stateManager);
+
+            batch.Submit(renderer);
+            batch.Clear();
+        };
+
+        for (size_t i = 0; const auto submeshIndex : submeshIndices)
+        {
+            const auto& subMesh = mesh.SubMeshes.at(submeshIndex);
+            if (batchMaterial != subMesh.MaterialIndex)
+            {
+                flush();
+                batchMaterial = subMesh.MaterialIndex;
+            }
+
+            const auto lod = i < lods.size() ? lods[i] : 0u;
+            if (lod == 0 && clusterCuller && subMesh.Meshlets && numInstances == 1)
+            {
+                static thread_local std::vector<uint32_t> visibleMeshlets;
+                visibleMeshlets.clear();
+                clusterCuller->Cull(*subMesh.Meshlets, model, visibleMeshlets);
+
+                const auto meshlets = subMesh.Meshlets->GetMeshlets();
+                for (const auto meshletIndex : visibleMeshlets)
+                    batch.Add(meshlets[meshletIndex].GetChunk());
+            }
+            else
+            {
+                for (const auto& chunk : subMesh.GetPrimitives(lod))
+                    batch.Add(chunk, static_cast<unsigned int>(numInstances));
+            }
+            ++i;
+        }
+
+        flush();
 	}
 
 	static void DrawMesh(IRenderer& renderer, const Mesh& mesh, const std::shared_ptr<IShaderProgram>& program)
@@ -23,8 +85,7 @@ namespace AT2::Utils::MeshRenderer
 
 	    stateManager.BindVertexArray(mesh.VertexArray);
 
-	    for (const auto& submesh : mesh.SubMeshes)
-	        DrawSubmesh(renderer, mesh, submesh);
+	    DrawSubmeshes(renderer, mesh, std::views::iota(size_t {0}, mesh.SubMeshes.size()));
 	}
 
-} // namespace AT2::Utils
\ No newline at end of file
+} // namespace AT2::Utils
@@ -3,8 +3,13 @@
 #include "../mesh_renderer.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
 #include <utility>
 
+#include <Hashing.h>
 #include <Scene/Animation.h>
 
 #include "DataLayout/BufferLayout.h"
@@ -22,12 +27,70 @@ namespace
 
         return temporaryData;
     }
+
+    // Width of the textures packing light lists and light data by rows
+    constexpr unsigned int LightTextureWidth = 1024;
+
+    // Recreates the texture when it has less rows than needed, so the size grows to the peak number of lights
+    void ReserveLightTexture(AT2::IRenderer& renderer, std::shared_ptr<AT2::ITexture>& texture, size_t numTexels,
+                             AT2::ExternalTextureFormat format)
+    {
+        const auto numRows = static_cast<unsigned int>(std::max<size_t>((numTexels + LightTextureWidth - 1) / LightTextureWidth, 1));
+        if (texture && texture->GetSize().y >= numRows)
+            return;
+
+        texture = renderer.GetResourceFactory().CreateTexture(AT2::Texture2D {{LightTextureWidth, std::bit_ceil(numRows)}}, format);
+        texture->SetSamplingMode(AT2::TextureSamplingParams::Uniform(AT2::TextureSamplingMode::Nearest));
+    }
+
+    // Data is padded to whole rows
+    template <typename T>
+    void UploadLightTexture(AT2::ITexture& texture, std::vector<T>& data, AT2::ExternalTextureFormat format)
+    {
+        const auto numRows = static_cast<unsigned int>((data.size() + LightTextureWidth - 1) / LightTextureWidth);
+        if (numRows == 0)
+            return;
+
+        data.resize(static_cast<size_t>(numRows) * LightTextureWidth);
+        texture.SubImage2D({0, 0}, {LightTextureWidth, numRows}, 0, format, data.data());
+    }
+
+    // Shadow views of sphere lights are keyed by handle * 6 + face, cascades are above all of them
+    constexpr AT2::ShadowCache::ViewKey CascadeViewKeys = AT2::ShadowCache::ViewKey {1} << 40;
+
+    // Cube faces in +X, -X, +Y, -Y, +Z, -Z order, see getCubeFace of shadows.glsl
+    constexpr std::array<std::pair<glm::vec3, glm::vec3>, 6> CubeFaces {{
+        {{1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}},
+        {{-1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}},
+        {{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+        {{0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+        {{0.0f, 0.0f, 1.0f}, {0.0f, -1.0f, 0.0f}},
+        {{0.0f, 0.0f, -1.0f}, {0.0f, -1.0f, 0.0f}},
+    }};
+
+    // Extends the box by the transformed one, transform must be affine
+    void ExtendBounds(glm::vec3& resultMin, glm::vec3& resultMax, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                      const glm::mat4& transform)
+    {
+        const auto center = glm::vec3 {transform * glm::vec4 {(boundsMin + boundsMax) * 0.5f, 1.0f}};
+        const auto halfSize = (boundsMax - boundsMin) * 0.5f;
+
+        glm::vec3 extent {0.0f};
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                extent[i] += std::abs(transform[j][i]) * halfSize[j];
+
+        resultMin = glm::min(resultMin, center - extent);
+        resultMax = glm::max(resultMax, center + extent);
+    }
 }
 
 namespace AT2::Scene
 {
-    RenderVisitor::RenderVisitor(IRenderer& renderer, SceneRenderer& sceneRenderer, const Camera& camera) :
-        renderer {renderer}, camera {camera}, scene_renderer {sceneRenderer}
+    RenderVisitor::RenderVisitor(IRenderer& renderer, SceneRenderer& sceneRenderer, const Camera& camera, const LodSelector& lodSelector,
+                                 const ClusterCuller* clusterCuller, const OcclusionBuffer* occlusionBuffer) :
+        renderer {renderer}, camera {camera}, lod_selector {lodSelector}, cluster_culler {clusterCuller},
+        occlusion_buffer {occlusionBuffer}, scene_renderer {sceneRenderer}
     {
     }
 
@@ -56,64 +119,198 @@ namespace AT2::Scene
 
                 stateManager.Commit([&](IUniformsWriter& writer) {
                     writer.Write("u_skeletonMatrices", skeletonMatrices);
-                    writer.Write("u_useSkinning", 1);
                 });
             }
-            else
+
+            stateManager.Commit([&](IUniformsWriter& writer) {
+                writer.Write("u_matModel", transforms.getModelView());
+                writer.Write("u_matNormal", glm::mat3(transpose(inverse(camera.getView() * transforms.getModelView()))));
+            });
+
+            const auto submeshIndices = meshComponent->GetSubmeshIndices();
+            const auto submeshLods = meshComponent->GetSubmeshLods();
+            const auto modelView = camera.getView() * transforms.getModelView();
+            for (size_t i = 0; i < submeshLods.size(); ++i)
+                submeshLods[i] = lod_selector.Select(active_mesh->SubMeshes.at(submeshIndices[i]), modelView, submeshLods[i]);
+
+            // skinned vertices leave bounds of meshlets
+            const bool isSkinned = meshComponent->getSkeletonInstance() != nullptr;
+
+            std::span<const unsigned> visibleIndices = submeshIndices, visibleLods = submeshLods;
+            if (occlusion_buffer && !isSkinned)
             {
-                stateManager.SetUniform("u_useSkinning", 0);
+                static thread_local std::vector<unsigned> unoccludedIndices, unoccludedLods;
+                unoccludedIndices.clear();
+                unoccludedLods.clear();
+
+                for (size_t i = 0; i < submeshIndices.size(); ++i)
+                {
+                    const auto& meshlets = active_mesh->SubMeshes.at(submeshIndices[i]).Meshlets;
+                    if (meshlets && !meshlets->Empty() &&
+                        occlusion_buffer->IsOccluded(meshlets->GetBoundsMin(), meshlets->GetBoundsMax(), transforms.getModelView()))
+                        continue;
+
+                    unoccludedIndices.push_back(submeshIndices[i]);
+                    unoccludedLods.push_back(submeshLods[i]);
+                }
+
+                visibleIndices = unoccludedIndices;
+                visibleLods = unoccludedLods;
             }
 
-            for (const size_t submeshIndex : meshComponent->GetSubmeshIndices())
+            Utils::MeshRenderer::DrawSubmeshes(renderer, *active_mesh, visibleIndices, 1, visibleLods,
+                                               isSkinned ? nullptr : cluster_culler, transforms.getModelView());
+        }
+
+
+        return true;
+    }
+
+    void RenderVisitor::UnVisit(Node&) { transforms.popModelView(); }
+
+    OccluderRenderVisitor::OccluderRenderVisitor(OcclusionBuffer& occlusionBuffer) : occlusion_buffer(occlusionBuffer) {}
+
+    bool OccluderRenderVisitor::Visit(Node& node)
+    {
+        transforms.pushModelView(node.GetTransform());
+
+        for (const auto* occluderComponent : node.getComponents<OccluderComponent>())
+            if (const auto& occluder = occluderComponent->getOccluder())
+                occlusion_buffer.RenderOccluder(*occluder, transforms.getModelView());
+
+        return true;
+    }
+
+    void OccluderRenderVisitor::UnVisit(Node&) { transforms.popModelView(); }
+
+    ShadowRenderVisitor::ShadowRenderVisitor(IRenderer& renderer, const Camera& camera, const LodSelector& lodSelector) :
+        renderer {renderer}, camera {camera}, lod_selector {lodSelector}
+    {
+    }
+
+    bool ShadowRenderVisitor::Visit(Node& node)
+    {
+        transforms.pushModelView(node.GetTransform());
+
+        auto& stateManager = renderer.GetStateManager();
+
+        for (auto* meshComponent : node.getComponents<MeshComponent>())
+        {
+            if (active_mesh != meshComponent->getMesh())
+            {
+                active_mesh = meshComponent->getMesh();
+
+                stateManager.BindShader(active_mesh->Shader);
+                stateManager.BindVertexArray(active_mesh->VertexArray);
+            }
+
+            if (const auto& skinRef = meshComponent->getSkeletonInstance())
             {
+                auto skeletonMatrices = MakeTransformedSpan(
+                    skinRef->getResultJointTransforms(),
+                    [mvInverse = transforms.getModelViewInverse()](const glm::mat4& transform) { return mvInverse * transform; });
+
                 stateManager.Commit([&](IUniformsWriter& writer) {
-                    writer.Write("u_matModel", transforms.getModelView());
-                    writer.Write("u_matNormal", glm::mat3(transpose(inverse(camera.getView() * transforms.getModelView()))));
+                    writer.Write("u_skeletonMatrices", skeletonMatrices);
                 });
-
-                Utils::MeshRenderer::DrawSubmesh(renderer, *active_mesh, active_mesh->SubMeshes[submeshIndex]);
             }
-        }
 
+            stateManager.Commit([&](IUniformsWriter& writer) {
+                writer.Write("u_matModel", transforms.getModelView());
+                writer.Write("u_matNormal", glm::mat3(transpose(inverse(camera.getView() * transforms.getModelView()))));
+            });
+
+            // the main view levels are the previous ones, but they are not overwritten
+            const auto submeshIndices = meshComponent->GetSubmeshIndices();
+            const auto currentLods = std::as_const(*meshComponent).GetSubmeshLods();
+            const auto modelView = camera.getView() * transforms.getModelView();
+
+            static thread_local std::vector<unsigned> shadowLods;
+            shadowLods.resize(submeshIndices.size());
+            for (size_t i = 0; i < shadowLods.size(); ++i)
+                shadowLods[i] = lod_selector.Select(active_mesh->SubMeshes.at(submeshIndices[i]), modelView, currentLods[i]);
+
+            Utils::MeshRenderer::DrawSubmeshes(renderer, *active_mesh, submeshIndices, 1, shadowLods);
+        }
 
         return true;
     }
 
-    void RenderVisitor::UnVisit(Node&) { transforms.popModelView(); }
+    void ShadowRenderVisitor::UnVisit(Node&) { transforms.popModelView(); }
 
-    LightRenderVisitor::LightRenderVisitor(SceneRenderer& sceneRenderer) : scene_renderer(sceneRenderer) {}
+    ShadowCasterVisitor::ShadowCasterVisitor(ShadowCache& shadowCache) : shadow_cache(shadowCache) {}
 
-    bool LightRenderVisitor::Visit(Node& node)
+    bool ShadowCasterVisitor::Visit(Node& node)
     {
         transforms.pushModelView(node.GetTransform());
 
-        if (const auto* lightNode = dynamic_cast<LightNode*>(&node))
+        for (const auto* meshComponent : node.getComponents<MeshComponent>())
         {
-            if (!lightNode->GetEnabled())
-                return true;
+            const auto& mesh = *meshComponent->getMesh();
 
-            const auto lightPos = glm::vec3(transforms.getModelView() * glm::vec4 {0, 0, 0, 1});
-
-            if (std::holds_alternative<SphereLight>(lightNode->GetFlavor()))
+            constexpr auto maxFloat = std::numeric_limits<float>::max();
+            glm::vec3 localMin {maxFloat}, localMax {-maxFloat};
+            bool isBounded = true;
+            for (const auto index : meshComponent->GetSubmeshIndices())
             {
-                collectedLights.push_back({lightPos, lightNode->GetIntensity(), lightNode->GetEffectiveRadius()});
+                const auto& meshlets = mesh.SubMeshes.at(index).Meshlets;
+                isBounded = isBounded && meshlets && !meshlets->Empty();
+                if (!isBounded)
+                    break;
+
+                localMin = glm::min(localMin, meshlets->GetBoundsMin());
+                localMax = glm::max(localMax, meshlets->GetBoundsMax());
             }
-            else if (const auto* skyLight = std::get_if<SkyLight>(&lightNode->GetFlavor()))
+
+            // the transforms are the caster's state, so moving casters are changed even if their bounds are the same, as
+            // the unbounded ones
+            const auto& skinRef = meshComponent->getSkeletonInstance();
+            const auto casterTransforms = skinRef ? skinRef->getResultJointTransforms()
+                                                  : std::span<const glm::mat4> {&transforms.getModelView(), 1};
+
+            Fnv1a stateHash;
+            stateHash.Update(std::as_bytes(casterTransforms));
+
+            if (!isBounded)
             {
-                collectedDirectionalLights.push_back({lightPos, lightNode->GetIntensity(),
-                                                      glm::mat3(transforms.getModelView()) * skyLight->Direction,
-                                                      skyLight->EnvironmentMap});
+                shadow_cache.UpdateCaster(meshComponent, glm::vec3 {-maxFloat}, glm::vec3 {maxFloat}, stateHash.Get());
+                continue;
             }
+
+            // skinned vertices are blends of the vertex transformed by the joints, so they are in the union of the bounds
+            // transformed by every joint
+            glm::vec3 worldMin {maxFloat}, worldMax {-maxFloat};
+            for (const auto& transform : casterTransforms)
+                ExtendBounds(worldMin, worldMax, localMin, localMax, transform);
+
+            shadow_cache.UpdateCaster(meshComponent, worldMin, worldMax, stateHash.Get());
         }
 
         return true;
     }
 
-    void LightRenderVisitor::UnVisit(Node&) { transforms.popModelView(); }
+    void ShadowCasterVisitor::UnVisit(Node&) { transforms.popModelView(); }
 
-    void SceneRenderer::DrawPointLights(IRenderer& renderer, const LightRenderVisitor& lrv) const
+    std::span<const LightBudget::Light> SceneRenderer::SelectPointLights(const LightRegistry& lights, const RenderParameters& params)
     {
-        using LightAttribs = LightRenderVisitor::LightAttribs;
+        const auto& sphereLights = lights.GetSphereLights();
+
+        budgetLights.resize(sphereLights.Positions.size());
+        for (size_t i = 0; i < budgetLights.size(); ++i)
+            budgetLights[i] = {sphereLights.Positions[i], sphereLights.Intensities[i], sphereLights.Radii[i]};
+
+        lightBudget.SetMaxLights(params.MaxLights);
+        budgetStatistics = lightBudget.Select(budgetLights, params.Camera->getView(), params.Camera->getProjection());
+
+        return lightBudget.GetSelectedLights();
+    }
+
+    void SceneRenderer::DrawPointLights(IRenderer& renderer, std::span<const LightBudget::Light> lights) const
+    {
+        using Light = LightBudget::Light;
+
+        if (lights.empty())
+            return;
 
         //update our vertex buffer...
         auto& rf = renderer.GetResourceFactory();
@@ -121,16 +318,16 @@ namespace AT2::Scene
 
 
         //TODO: map buffer instead of recreating it
-        auto vertexBuffer = rf.MakeBufferFrom(VertexBufferType::ArrayBuffer, lrv.collectedLights);
+        auto vertexBuffer = rf.MakeBufferFrom(VertexBufferType::ArrayBuffer, lights);
 
         vao->SetAttributeBinding(2, vertexBuffer,
-            BufferBindingParams {BufferDataType::Float, 3, sizeof(LightAttribs), offsetof(LightAttribs, position), false, 1} );
+            BufferBindingParams {BufferDataType::Float, 3, sizeof(Light), offsetof(Light, Position), false, 1});
 
         vao->SetAttributeBinding(3, vertexBuffer,
-            BufferBindingParams {BufferDataType::Float, 3, sizeof(LightAttribs), offsetof(LightAttribs, intensity), false, 1});
+            BufferBindingParams {BufferDataType::Float, 3, sizeof(Light), offsetof(Light, Intensity), false, 1});
 
         vao->SetAttributeBinding(4, vertexBuffer,
-            BufferBindingParams {BufferDataType::Float, 1, sizeof(LightAttribs), offsetof(LightAttribs, effective_radius), false, 1});
+            BufferBindingParams {BufferDataType::Float, 1, sizeof(Light), offsetof(Light, Radius), false, 1});
 
 
         auto& stateManager = renderer.GetStateManager();
@@ -138,44 +335,332 @@ namespace AT2::Scene
         stateManager.BindVertexArray(lightMesh->VertexArray);
         sphereLightsUniforms->Bind(stateManager);
 
-        Utils::MeshRenderer::DrawSubmesh(renderer, *lightMesh, lightMesh->SubMeshes.front(), lrv.collectedLights.size());
+        Utils::MeshRenderer::DrawSubmesh(renderer, *lightMesh, lightMesh->SubMeshes.front(), lights.size());
     }
 
-    void SceneRenderer::DrawSkyLight( IRenderer& renderer, const LightRenderVisitor& lrv, const Camera& camera ) const
+    void SceneRenderer::DrawClusteredLights(IRenderer& renderer, std::span<const LightBudget::Light> lights, const RenderParameters& params)
     {
-        using LightAttribs = LightRenderVisitor::DirectionalLightAttribs;
+        static thread_local std::vector<LightClusters::Light> clusteredLights;
+        clusteredLights.resize(lights.size());
+        std::ranges::transform(lights, clusteredLights.begin(), [](const LightBudget::Light& light) {
+            return LightClusters::Light {light.Position, light.Radius};
+        });
+
+        lightClusters.SetView(params.Camera->getView(), params.Camera->getProjection());
+        lightStatistics = lightClusters.Assign(clusteredLights, params.ThreadPool);
 
-        const auto comparator = Utils::make_unary_less<LightAttribs>(
-            [&](const LightAttribs& lhv) { return length(camera.getPosition() - lhv.position); });
+        const auto clusters = lightClusters.GetClusters();
+        clusterMapData.resize(clusters.size());
+        std::ranges::transform(clusters, clusterMapData.begin(), [](const LightClusters::Cluster& cluster) {
+            return glm::vec2 {static_cast<float>(cluster.FirstLight), static_cast<float>(cluster.NumLights)};
+        });
 
-        const auto nearestLightIt =
-            std::min_element(lrv.collectedDirectionalLights.begin(), lrv.collectedDirectionalLights.end(), comparator);
+        const auto lightIndices = lightClusters.GetLightIndices();
+        lightIndicesData.assign(lightIndices.begin(), lightIndices.end());
 
-        if (nearestLightIt != lrv.collectedDirectionalLights.end())
+        const auto viewLights = lightClusters.GetViewSpaceLights();
+        lightData.resize(viewLights.size() * 2);
+        for (size_t i = 0; i < viewLights.size(); ++i)
         {
+            lightData[i * 2] = {viewLights[i].Position, viewLights[i].Radius};
+            lightData[i * 2 + 1] = {lights[i].Intensity, i < pointShadowIndices.size() ? pointShadowIndices[i] : -1.0f};
+        }
+
+        if (!clusterMapTexture || clusterMapTexture->GetSize() != lightClusters.GetGridSize())
+        {
+            clusterMapTexture = renderer.GetResourceFactory().CreateTexture(Texture3D {lightClusters.GetGridSize()}, TextureFormats::RG32F);
+            clusterMapTexture->SetSamplingMode(TextureSamplingParams::Uniform(TextureSamplingMode::Nearest));
+        }
+        ReserveLightTexture(renderer, lightIndicesTexture, lightIndicesData.size(), TextureFormats::R32F);
+        ReserveLightTexture(renderer, lightDataTexture, lightData.size(), TextureFormats::RGBA32F);
+
+        clusterMapTexture->SubImage3D({0, 0, 0}, lightClusters.GetGridSize(), 0, TextureFormats::RG32F, clusterMapData.data());
+        UploadLightTexture(*lightIndicesTexture, lightIndicesData, TextureFormats::R32F);
+        UploadLightTexture(*lightDataTexture, lightData, TextureFormats::RGBA32F);
+
+        clusteredLightsUniforms->Commit([&](AT2::IUniformsWriter& writer) {
+            writer.Write("u_clusterMap", clusterMapTexture);
+            writer.Write("u_lightIndices", lightIndicesTexture);
+            writer.Write("u_lightData", lightDataTexture);
+            writer.Write("u_clusterGridSize", glm::ivec3 {lightClusters.GetGridSize()});
+            writer.Write("u_clusterDepthParams", glm::vec2 {lightClusters.GetNear(), lightClusters.GetSliceScale()});
+
+            if (!pointShadowMatrices.empty())
+            {
+                writer.Write("u_shadowAtlas", shadowAtlasFBO->GetDepthAttachment().Texture);
+                writer.Write("u_pointShadowMatrices",
+                             MakeTransformedSpan(std::span<const glm::mat4> {pointShadowMatrices},
+                                                 [&viewInverse = params.Camera->getViewInverse()](const glm::mat4& matrix) {
+                                                     return matrix * viewInverse;
+                                                 }));
+            }
+        });
+
+        DrawQuad(renderer, resources.clusteredLightsShader, *clusteredLightsUniforms);
+    }
+
+    void SceneRenderer::DrawSkyLight(IRenderer& renderer, const LightRegistry& lights, const Camera& camera) const
+    {
+        if (const auto nearestLight = lights.FindNearestSkyLight(camera.getPosition()))
+        {
+            const auto& skyLights = lights.GetSkyLights();
+
             skyLightsUniforms->Commit([&](AT2::IUniformsWriter& writer) {
-                writer.Write("u_lightDirection", nearestLightIt->direction);
-                writer.Write("u_lightIntensity", nearestLightIt->intensity);
-                writer.Write("u_environmentMap", nearestLightIt->environment_map);
+                writer.Write("u_lightDirection", skyLights.Directions[*nearestLight]);
+                writer.Write("u_lightIntensity", skyLights.Intensities[*nearestLight]);
+                writer.Write("u_environmentMap", skyLights.EnvironmentMaps[*nearestLight]);
+
+                writer.Write("u_numCascades", static_cast<int>(cascadeMatrices.size()));
+                if (!cascadeMatrices.empty())
+                {
+                    writer.Write("u_shadowAtlas", shadowAtlasFBO->GetDepthAttachment().Texture);
+                    writer.Write("u_cascadeSplits", cascadeSplits);
+                    writer.Write("u_cascadeBiases", cascadeBiases);
+                    writer.Write("u_cascadeMatrices",
+                                 MakeTransformedSpan(std::span<const glm::mat4> {cascadeMatrices},
+                                                     [&viewInverse = camera.getViewInverse()](const glm::mat4& matrix) {
+                                                         return matrix * viewInverse;
+                                                     }));
+                }
             });
 
             DrawQuad(renderer, resources.skyLightsShader, *skyLightsUniforms);
         }
     }
 
+    void SceneRenderer::UpdateShadows(IRenderer& renderer, const LightRegistry& lights, std::span<const LightBudget::Light> pointLights,
+                                      const RenderParameters& params, const ITime& time)
+    {
+        if (!params.Shadows)
+        {
+            ReleaseShadows();
+            return;
+        }
+
+        if (!shadowAtlasFBO)
+        {
+            auto& rf = renderer.GetResourceFactory();
+
+            auto atlasTexture = rf.CreateTexture(Texture2D {glm::uvec2 {shadowAtlas.GetSize()}}, TextureFormats::DEPTH32F);
+            atlasTexture->SetSamplingMode(TextureSamplingParams::Uniform(TextureSamplingMode::Nearest));
+
+            // not cleared, tiles are cleared one by one when they are rendered
+            shadowAtlasFBO = rf.CreateFrameBuffer();
+            shadowAtlasFBO->SetDepthAttachment(atlasTexture);
+        }
+
+        shadowCache.BeginFrame();
+        ShadowCasterVisitor scv {shadowCache};
+        params.Scene->GetRoot().Accept(scv);
+        shadowCache.EndCasterUpdates();
+
+        staleShadowViews.clear();
+        UpdateCascadedShadows(lights, params);
+        UpdatePointShadows(lights, pointLights, params);
+
+        if (staleShadowViews.empty())
+            return;
+
+        shadowAtlasFBO->Render([&](IRenderer& renderer) {
+            auto& stateManager = renderer.GetStateManager();
+            stateManager.ApplyState(BlendMode {});
+            stateManager.ApplyState(PolygonRasterizationMode::Fill);
+            stateManager.ApplyState(FaceCullMode {false, true});
+
+            for (const auto& [view, projection, tile] : staleShadowViews)
+            {
+                const auto tileOffset = glm::vec2 {tile.Offset};
+                renderer.SetViewport(AABB2d {tileOffset, tileOffset + glm::vec2 {static_cast<float>(tile.Size)}});
+
+                stateManager.ApplyState(DepthState {CompareFunction::Always, true, true});
+                DrawQuad(renderer, resources.shadowClearShader, *shadowClearUniforms);
+
+                Camera shadowCamera;
+                shadowCamera.setView(view).setProjection(projection);
+                SetupCamera(renderer, shadowCamera, time);
+
+                stateManager.ApplyState(DepthState {CompareFunction::Less, true, true});
+                const LodSelector lodSelector {projection, static_cast<float>(tile.Size), params.LodThreshold};
+                ShadowRenderVisitor srv {renderer, shadowCamera, lodSelector};
+                params.Scene->GetRoot().Accept(srv);
+            }
+        });
+    }
+
+    void SceneRenderer::UpdateCascadedShadows(const LightRegistry& lights, const RenderParameters& params)
+    {
+        cascadeMatrices.clear();
+
+        const auto nearestLight = lights.FindNearestSkyLight(params.Camera->getPosition());
+        if (!nearestLight)
+            return;
+
+        ShadowCascades::Parameters parameters;
+        parameters.ShadowDistance = params.ShadowDistance;
+        parameters.CasterDistance = params.ShadowDistance;
+        parameters.Resolution = CascadeTileSize;
+        shadowCascades.Update(params.Camera->getView(), params.Camera->getProjection(), lights.GetSkyLights().Directions[*nearestLight],
+                              parameters);
+
+        const auto cascades = shadowCascades.GetCascades();
+        for (size_t i = 0; i < cascades.size(); ++i)
+        {
+            const bool isNewTile = !cascadeTiles[i];
+            if (isNewTile)
+                cascadeTiles[i] = shadowAtlas.Allocate(CascadeTileSize);
+            if (!cascadeTiles[i])
+                break;
+
+            const auto& cascade = cascades[i];
+            RequestShadowView(CascadeViewKeys + i, cascade.View, cascade.Projection, *cascadeTiles[i], isNewTile);
+
+            cascadeMatrices.push_back(shadowAtlas.GetTileMatrix(*cascadeTiles[i]) * cascade.Projection * cascade.View);
+            cascadeSplits[static_cast<int>(i)] = cascade.FarDepth;
+            // a couple of texels, in the depth units of the orthographic projection
+            const float depthRange = 2.0f / std::abs(cascade.Projection[2][2]);
+            cascadeBiases[static_cast<int>(i)] = 2.0f * cascade.TexelSize / depthRange;
+        }
+    }
+
+    void SceneRenderer::UpdatePointShadows(const LightRegistry& lights, std::span<const LightBudget::Light> pointLights,
+                                           const RenderParameters& params)
+    {
+        pointShadowMatrices.clear();
+        pointShadowIndices.assign(pointLights.size(), -1.0f);
+
+        for (auto& [handle, shadow] : pointShadows)
+            shadow.Used = false;
+
+        // shadows are sampled by the clustered lighting only
+        if (params.ClusteredLighting)
+        {
+            const auto& view = params.Camera->getView();
+            const auto& projection = params.Camera->getProjection();
+
+            static thread_local std::vector<std::pair<float, size_t>> ranking;
+            ranking.resize(pointLights.size());
+            for (size_t i = 0; i < pointLights.size(); ++i)
+                ranking[i] = {LightBudget::GetImportance(pointLights[i], view, projection), i};
+
+            const auto numShadowed = std::min(ranking.size(), MaxShadowedLights);
+            std::ranges::partial_sort(ranking, ranking.begin() + static_cast<std::ptrdiff_t>(numShadowed), std::greater {});
+
+            // all of the 6 faces or nothing, smaller tiles are tried when the atlas is full
+            const auto allocateFaces = [this](unsigned int tileSize) -> std::optional<PointShadow> {
+                for (; tileSize >= shadowAtlas.GetMinTileSize(); tileSize /= 2)
+                {
+                    PointShadow shadow;
+                    size_t numAllocated = 0;
+                    for (; numAllocated < shadow.Tiles.size(); ++numAllocated)
+                    {
+                        const auto tile = shadowAtlas.Allocate(tileSize);
+                        if (!tile)
+                            break;
+                        shadow.Tiles[numAllocated] = *tile;
+                    }
+
+                    if (numAllocated == shadow.Tiles.size())
+                        return shadow;
+
+                    for (size_t i = 0; i < numAllocated; ++i)
+                        shadowAtlas.Free(shadow.Tiles[i]);
+                }
+
+                return std::nullopt;
+            };
+
+            for (const auto& [importance, index] : std::span {ranking}.first(numShadowed))
+            {
+                const auto& light = pointLights[index];
+                const auto handle = lights.GetSphereLightHandles()[lightBudget.GetSelectedIndices()[index]];
+                const auto tileSize =
+                    shadowAtlas.GetTileSize(LightBudget::GetScreenCoverage(light, view, projection), MaxPointShadowTileSize);
+
+                // tiles follow the size with some hysteresis, so a light doesn't reallocate them at every step
+                auto it = pointShadows.find(handle);
+                if (it != pointShadows.end() && (it->second.Tiles.front().Size < tileSize || it->second.Tiles.front().Size >= tileSize * 4))
+                {
+                    for (const auto& tile : it->second.Tiles)
+                        shadowAtlas.Free(tile);
+                    pointShadows.erase(it);
+                    it = pointShadows.end();
+                }
+
+                bool isNewTile = false;
+                if (it == pointShadows.end())
+                {
+                    const auto shadow = allocateFaces(tileSize);
+                    if (!shadow)
+                        continue;
+
+                    it = pointShadows.emplace(handle, *shadow).first;
+                    isNewTile = true;
+                }
+
+                auto& shadow = it->second;
+                shadow.Used = true;
+
+                const auto faceProjection = glm::perspective(glm::radians(90.0f), 1.0f, light.Radius * 0.01f, light.Radius);
+                pointShadowIndices[index] = static_cast<float>(pointShadowMatrices.size() / CubeFaces.size());
+                for (size_t face = 0; face < CubeFaces.size(); ++face)
+                {
+                    const auto& [direction, up] = CubeFaces[face];
+                    const auto faceView = glm::lookAt(light.Position, light.Position + direction, up);
+
+                    RequestShadowView(ShadowCache::ViewKey {handle} * CubeFaces.size() + face, faceView, faceProjection,
+                                      shadow.Tiles[face], isNewTile);
+                    pointShadowMatrices.push_back(shadowAtlas.GetTileMatrix(shadow.Tiles[face]) * faceProjection * faceView);
+                }
+            }
+        }
+
+        std::erase_if(pointShadows, [this](const auto& pointShadow) {
+            if (pointShadow.second.Used)
+                return false;
+
+            for (const auto& tile : pointShadow.second.Tiles)
+                shadowAtlas.Free(tile);
+            return true;
+        });
+    }
+
+    void SceneRenderer::ReleaseShadows()
+    {
+        shadowAtlas.Clear();
+        shadowCache.Clear();
+        cascadeTiles = {};
+        pointShadows.clear();
+
+        cascadeMatrices.clear();
+        pointShadowMatrices.clear();
+        pointShadowIndices.clear();
+    }
+
+    void SceneRenderer::RequestShadowView(ShadowCache::ViewKey key, const glm::mat4& view, const glm::mat4& projection,
+                                          const ShadowAtlas::Tile& tile, bool isNewTile)
+    {
+        if (shadowCache.UpdateView(key, projection * view) || isNewTile)
+            staleShadowViews.push_back({view, projection, tile});
+    }
+
     void SceneRenderer::Initialize(IVisualizationSystem& renderer)
     {
         resources.postprocessShader = renderer.GetResourceFactory().CreateShaderProgramFromFiles(
             {"resources/shaders/postprocess.vs.glsl", "resources/shaders/postprocess.fs.glsl"});
 
         resources.sphereLightsShader = renderer.GetResourceFactory().CreateShaderProgramFromFiles(
-            {"resources/shaders/spherelight2.vs.glsl", "resources/shaders/pbr.fs.glsl",
-             "resources/shaders/spherelight2.fs.glsl"});
+            {"resources/shaders/spherelight2.vs.glsl", "resources/shaders/spherelight2.fs.glsl"});
+
+        resources.clusteredLightsShader = renderer.GetResourceFactory().CreateShaderProgramFromFiles(
+            {"resources/shaders/skylight.vs.glsl", "resources/shaders/clusteredlights.fs.glsl"});
 
         resources.skyLightsShader = renderer.GetResourceFactory().CreateShaderProgramFromFiles(
-            {"resources/shaders/skylight.vs.glsl", "resources/shaders/pbr.fs.glsl",
-             "resources/shaders/skylight.fs.glsl"});
+            {"resources/shaders/skylight.vs.glsl", "resources/shaders/skylight.fs.glsl"});
+
+        resources.shadowClearShader = renderer.GetResourceFactory().CreateShaderProgramFromFiles(
+            {"resources/shaders/shadowclear.vs.glsl", "resources/shaders/shadowclear.fs.glsl"});
 
+        shadowClearUniforms = std::make_shared<UniformContainer>();
 
         lightMesh = Utils::MakeSphere(renderer, {32, 16});
         quadMesh = Utils::MakeFullscreenQuadMesh(renderer);
@@ -194,6 +679,19 @@ namespace AT2::Scene
         {
             const auto& rf = renderer.GetResourceFactory();
 
+            // G-buffer textures are used by every lighting pass, so they have permanent texture units
+            const auto pinFramebufferTextures = [this, &stateManager = renderer.GetStateManager()](bool pinned) {
+                if (!gBufferFBO || !postProcessFBO)
+                    return;
+
+                for (unsigned int i = 0; i < 3; ++i)
+                    stateManager.PinTexture(gBufferFBO->GetColorAttachment(i).Texture, pinned);
+                stateManager.PinTexture(gBufferFBO->GetDepthAttachment().Texture, pinned);
+                stateManager.PinTexture(postProcessFBO->GetColorAttachment(0).Texture, pinned);
+            };
+
+            pinFramebufferTextures(false);
+
             gBufferFBO = renderer.GetResourceFactory().CreateFrameBuffer();
             gBufferFBO->SetColorAttachment(0,{ rf.CreateTexture(Texture2D {framebuffer_size}, TextureFormats::RGBA8   ), glm::vec4{0.0, 0.0, 1.0, 0.0}});   //FragColor
             gBufferFBO->SetColorAttachment(1,  rf.CreateTexture(Texture2D {framebuffer_size}, TextureFormats::RGBA32F ) );                                  //FragNormal
@@ -204,6 +702,8 @@ namespace AT2::Scene
             postProcessFBO->SetColorAttachment(0, {rf.CreateTexture(Texture2D {framebuffer_size}, TextureFormats::RGBA32F), glm::vec4{}});
             postProcessFBO->SetDepthAttachment(gBufferFBO->GetDepthAttachment().Texture); //depth is common with previous stage
 
+            pinFramebufferTextures(true);
+
             {
                 sphereLightsUniforms = std::make_shared<UniformContainer>();
 
@@ -215,6 +715,17 @@ namespace AT2::Scene
                 });
             }
 
+            {
+                clusteredLightsUniforms = std::make_shared<UniformContainer>();
+
+                clusteredLightsUniforms->Commit([&](AT2::IUniformsWriter& writer) {
+                    writer.Write("u_colorMap", gBufferFBO->GetColorAttachment(0).Texture);
+                    writer.Write("u_normalMap", gBufferFBO->GetColorAttachment(1).Texture);
+                    writer.Write("u_roughnessMetallicMap", gBufferFBO->GetColorAttachment(2).Texture);
+                    writer.Write("u_depthMap", gBufferFBO->GetDepthAttachment().Texture);
+                });
+            }
+
             {
                 skyLightsUniforms = std::make_shared<UniformContainer>();
 
@@ -242,6 +753,11 @@ namespace AT2::Scene
         if (!params.Camera || !params.Scene)
             return;
 
+        // shadow maps are rendered before the main camera is set up, they use the camera block too
+        const auto& lights = params.Scene->GetLightRegistry();
+        const auto pointLights = SelectPointLights(lights, params);
+        UpdateShadows(renderer, lights, pointLights, params, time);
+
         SetupCamera(renderer, *params.Camera, time);
 
 
@@ -253,8 +769,23 @@ namespace AT2::Scene
             stateManager.ApplyState(DepthState {CompareFunction::Less, true, true});
             stateManager.ApplyState(FaceCullMode {false, true});
 
-            RenderVisitor rv {renderer, *this, *params.Camera};
+            const LodSelector lodSelector {params.Camera->getProjection(), static_cast<float>(framebuffer_size.y), params.LodThreshold};
+            RecordingRenderer recordingRenderer {renderer};
+            const ClusterCuller clusterCuller {params.Camera->getView(), params.Camera->getProjection()};
+
+            if (params.OcclusionCulling)
+            {
+                occlusionBuffer.Clear(params.Camera->getProjection() * params.Camera->getView());
+                OccluderRenderVisitor orv {occlusionBuffer};
+                params.Scene->GetRoot().Accept(orv);
+                occlusionBuffer.Resolve();
+            }
+
+            RenderVisitor rv {recordingRenderer, *this, *params.Camera, lodSelector, params.ClusterCulling ? &clusterCuller : nullptr,
+                              params.OcclusionCulling ? &occlusionBuffer : nullptr};
             params.Scene->GetRoot().Accept(rv);
+
+            statistics = recordingRenderer.GetStatistics();
         });
 
         // Lighting pass
@@ -265,13 +796,19 @@ namespace AT2::Scene
             stateManager.ApplyState(DepthState {CompareFunction::Greater, true, false});
             stateManager.ApplyState(FaceCullMode {false, true});
 
-            LightRenderVisitor lrv {*this};
-            params.Scene->GetRoot().Accept(lrv);
-
-            DrawPointLights(renderer, lrv);
+            if (params.ClusteredLighting)
+            {
+                stateManager.ApplyState(DepthState {CompareFunction::Greater, false, false});
+                DrawClusteredLights(renderer, pointLights, params);
+            }
+            else
+            {
+                DrawPointLights(renderer, pointLights);
+                lightStatistics = {};
+            }
 
             stateManager.ApplyState(DepthState {CompareFunction::Greater, false, false});
-            DrawSkyLight(renderer, lrv, *params.Camera );
+            DrawSkyLight(renderer, lights, *params.Camera);
         });
 
         // Postprocess pass
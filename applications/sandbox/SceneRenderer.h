@@ -1,9 +1,21 @@
 #pragma once
 
 #include <Scene/Scene.h>
+#include <ClusterCuller.h>
+#include <LightBudget.h>
+#include <LightClusters.h>
+#include <LodSelector.h>
+#include <OcclusionBuffer.h>
+#include <ShadowAtlas.h>
+#include <ShadowCache.h>
+#include <ShadowCascades.h>
 #include <matrix_stack.h>
+#include <RecordingRenderer.h>
 #include <DataLayout/StructuredBuffer.h>
 
+#include <map>
+#include <optional>
+
 namespace AT2::Scene
 {
 
@@ -11,7 +23,9 @@ namespace AT2::Scene
 
     struct RenderVisitor : NodeVisitor
     {
-        RenderVisitor(IRenderer&, SceneRenderer&, const Camera& camera);
+        // clusterCuller and occlusionBuffer are optional, the latter must be resolved
+        RenderVisitor(IRenderer&, SceneRenderer&, const Camera& camera, const LodSelector& lodSelector,
+                      const ClusterCuller* clusterCuller = nullptr, const OcclusionBuffer* occlusionBuffer = nullptr);
 
         bool Visit(Node& node) override;
 
@@ -20,6 +34,9 @@ namespace AT2::Scene
     private:
         IRenderer& renderer;
         const Camera& camera;
+        LodSelector lod_selector;
+        const ClusterCuller* cluster_culler;
+        const OcclusionBuffer* occlusion_buffer;
 
         MatrixStack transforms;
         std::shared_ptr<const Mesh> active_mesh;
@@ -27,40 +44,59 @@ namespace AT2::Scene
     };
 
 
-    //TODO: make lights components, collect with usual update visitor
-    struct LightRenderVisitor : NodeVisitor
+    // Renders occluder components of the scene to the buffer
+    struct OccluderRenderVisitor : NodeVisitor
     {
-        friend class SceneRenderer;
+        OccluderRenderVisitor(OcclusionBuffer& occlusionBuffer);
+
+        bool Visit(Node& node) override;
 
-        LightRenderVisitor(SceneRenderer& sceneRenderer);
+        void UnVisit(Node& node) override;
+
+    private:
+        OcclusionBuffer& occlusion_buffer;
+
+        MatrixStack transforms;
+    };
+
+
+    // Draws mesh components to a shadow map. Levels of detail are selected for the shadow view, but the ones of the main
+    // view are kept.
+    struct ShadowRenderVisitor : NodeVisitor
+    {
+        ShadowRenderVisitor(IRenderer&, const Camera& camera, const LodSelector& lodSelector);
 
         bool Visit(Node& node) override;
 
         void UnVisit(Node& node) override;
 
     private:
-        SceneRenderer& scene_renderer;
+        IRenderer& renderer;
+        const Camera& camera;
+        LodSelector lod_selector;
 
         MatrixStack transforms;
+        std::shared_ptr<const Mesh> active_mesh;
+    };
 
-        struct DirectionalLightAttribs
-        {
-            glm::vec3 position;
-            glm::vec3 intensity;
-            glm::vec3 direction;
-            std::shared_ptr<ITexture> environment_map;
-        };
-        std::vector<DirectionalLightAttribs> collectedDirectionalLights;
 
-        struct LightAttribs
-        {
-            glm::vec3 position;
-            glm::vec3 intensity;
-            float effective_radius;
-        };
-        std::vector<LightAttribs> collectedLights;
+    // Reports world-space bounds of mesh components to the shadow cache. Bounds are taken from meshlets, skinned meshes are
+    // bounded by their meshlets transformed by every joint; meshes without meshlets are unbounded.
+    struct ShadowCasterVisitor : NodeVisitor
+    {
+        ShadowCasterVisitor(ShadowCache& shadowCache);
+
+        bool Visit(Node& node) override;
+
+        void UnVisit(Node& node) override;
+
+    private:
+        ShadowCache& shadow_cache;
+
+        MatrixStack transforms;
     };
 
+
     struct RenderParameters
     {
         Scene* Scene = nullptr;
@@ -69,6 +105,23 @@ namespace AT2::Scene
 
         float Exposure = 1.0f;
         bool Wireframe = false;
+        // Allowed screen-space error of mesh levels of detail in pixels, 0 disables them
+        float LodThreshold = LodSelector::DefaultThreshold;
+        // Meshlets of the full detail submeshes are culled, if they were built by the loader
+        bool ClusterCulling = true;
+        // Submeshes with meshlets are tested against occluder components of the scene
+        bool OcclusionCulling = true;
+        // Sphere lights are assigned to view frustum clusters and shaded by one full screen pass instead of light volumes
+        bool ClusteredLighting = true;
+        // Sphere lights over the budget are merged to the more important ones or dropped
+        size_t MaxLights = LightBudget::DefaultMaxLights;
+        // Sky light has cascaded shadow maps and the most important sphere lights have cube ones, the latter only with
+        // clustered lighting. Maps are kept in one atlas and rendered again only when their views or casters change.
+        bool Shadows = true;
+        float ShadowDistance = 2000.0f;
+        // Optional, light clusters are assigned by it's threads and the render thread. It may be busy with loading, the
+        // render thread doesn't wait for the queued tasks then
+        ThreadPool* ThreadPool = nullptr;
     };
 
     class SceneRenderer
@@ -82,9 +135,35 @@ namespace AT2::Scene
         void ResizeFramebuffers(glm::ivec2 newSize);
         void RenderScene(IRenderer& renderer, const RenderParameters& params, const ITime& time);
 
+        // Geometry submitted by the G-buffer pass of the last frame
+        [[nodiscard]] const RecordingRenderer::Statistics& GetStatistics() const noexcept { return statistics; }
+        // Sphere lights selection of the last frame
+        [[nodiscard]] const LightBudget::Statistics& GetLightBudgetStatistics() const noexcept { return budgetStatistics; }
+        // Light assignment of the last frame, empty when clustered lighting is off
+        [[nodiscard]] const LightClusters::Statistics& GetLightStatistics() const noexcept { return lightStatistics; }
+        // Shadow views of the last frame
+        [[nodiscard]] const ShadowCache::Statistics& GetShadowStatistics() const noexcept { return shadowCache.GetStatistics(); }
+        [[nodiscard]] const ShadowAtlas& GetShadowAtlas() const noexcept { return shadowAtlas; }
+
+        static constexpr unsigned int ShadowAtlasSize = 4096;
+        static constexpr unsigned int CascadeTileSize = 1024;
+        static constexpr unsigned int MaxPointShadowTileSize = 512;
+        static constexpr size_t MaxShadowedLights = 4; // must match clusteredlights.fs.glsl
+
     private:
-        void DrawPointLights(IRenderer& renderer, const LightRenderVisitor& lrv) const;
-        void DrawSkyLight( IRenderer& renderer, const LightRenderVisitor& lrv, const Camera& camera ) const;
+        std::span<const LightBudget::Light> SelectPointLights(const LightRegistry& lights, const RenderParameters& params);
+        void DrawPointLights(IRenderer& renderer, std::span<const LightBudget::Light> lights) const;
+        void DrawClusteredLights(IRenderer& renderer, std::span<const LightBudget::Light> lights, const RenderParameters& params);
+        void DrawSkyLight(IRenderer& renderer, const LightRegistry& lights, const Camera& camera) const;
+
+        void UpdateShadows(IRenderer& renderer, const LightRegistry& lights, std::span<const LightBudget::Light> pointLights,
+                           const RenderParameters& params, const ITime& time);
+        void UpdateCascadedShadows(const LightRegistry& lights, const RenderParameters& params);
+        void UpdatePointShadows(const LightRegistry& lights, std::span<const LightBudget::Light> pointLights, const RenderParameters& params);
+        void ReleaseShadows();
+        // Adds the view to the rendered ones if the cache has no valid map for it
+        void RequestShadowView(ShadowCache::ViewKey key, const glm::mat4& view, const glm::mat4& projection,
+                               const ShadowAtlas::Tile& tile, bool isNewTile);
 
         void SetupCamera(IRenderer& renderer, const Camera& camera, const ITime& time);
         void DrawQuad(IRenderer& renderer, const std::shared_ptr<IShaderProgram>&, const IUniformContainer&) const noexcept;
@@ -92,14 +171,55 @@ namespace AT2::Scene
     private:
         struct Resources
         {
-            std::shared_ptr<IShaderProgram> sphereLightsShader, skyLightsShader, postprocessShader;
+            std::shared_ptr<IShaderProgram> sphereLightsShader, clusteredLightsShader, skyLightsShader, postprocessShader, shadowClearShader;
         } resources;
 
         std::unique_ptr<Mesh> lightMesh, quadMesh;
         std::unique_ptr<StructuredBuffer> cameraUniformBuffer;
         std::shared_ptr<AT2::IFrameBuffer> gBufferFBO, postProcessFBO;
 
-        std::shared_ptr<IUniformContainer> sphereLightsUniforms, skyLightsUniforms, postprocessUniforms;
+        std::shared_ptr<IUniformContainer> sphereLightsUniforms, clusteredLightsUniforms, skyLightsUniforms, postprocessUniforms,
+            shadowClearUniforms;
+
+        RecordingRenderer::Statistics statistics;
+        OcclusionBuffer occlusionBuffer {glm::uvec2 {256, 128}};
+
+        LightBudget lightBudget;
+        LightBudget::Statistics budgetStatistics;
+        std::vector<LightBudget::Light> budgetLights;
+
+        struct ShadowView
+        {
+            glm::mat4 View, Projection;
+            ShadowAtlas::Tile Tile;
+        };
+
+        // 6 faces of the cube map of a sphere light, tiles have the same size
+        struct PointShadow
+        {
+            std::array<ShadowAtlas::Tile, 6> Tiles;
+            bool Used = false;
+        };
+
+        ShadowAtlas shadowAtlas {ShadowAtlasSize};
+        ShadowCache shadowCache;
+        ShadowCascades shadowCascades;
+        std::shared_ptr<IFrameBuffer> shadowAtlasFBO;
+        std::array<std::optional<ShadowAtlas::Tile>, ShadowCascades::MaxCascades> cascadeTiles;
+        std::map<LightRegistry::Handle, PointShadow> pointShadows;
+        std::vector<ShadowView> staleShadowViews;
+
+        // world-space shadow matrices, they are moved to the view space when the lights are drawn
+        std::vector<glm::mat4> cascadeMatrices, pointShadowMatrices;
+        glm::vec4 cascadeSplits {0.0f}, cascadeBiases {0.0f};
+        std::vector<float> pointShadowIndices; // by selected sphere light, negative for lights without shadows
+
+        LightClusters lightClusters;
+        LightClusters::Statistics lightStatistics;
+        std::shared_ptr<ITexture> clusterMapTexture, lightIndicesTexture, lightDataTexture;
+        std::vector<glm::vec2> clusterMapData;
+        std::vector<float> lightIndicesData;
+        std::vector<glm::vec4> lightData;
 
         glm::ivec2 framebuffer_size = {512, 512};
         bool dirtyFramebuffers = false;
@@ -5,16 +5,24 @@
 //#include <Platform/Renderers/OpenGL/GlTimerQuery.h>
 #include <Platform/Application.h>
 #include <Resources/MeshLoader.h>
+#include <Resources/AsyncTextureLoader.h>
 #include <Resources/GltfSceneLoader.h>
+#include <Resources/MipmapGenerator.h>
+#include <Resources/TextureCache.h>
 #include <Resources/TextureLoader.h>
+#include <Resources/TextureManifest.h>
+#include <ShaderPermutations.h>
+#include <ThreadPool.h>
 
 #include <execution>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <random>
 
 #include <glm/gtc/random.hpp>
+#include <glm/packing.hpp>
 
 #include "SceneRenderer.h"
 #include "../procedural_meshes.h"
@@ -25,6 +33,9 @@ using TextureLoader = AT2::Resources::TextureLoader;
 using MeshLoader = AT2::Resources::MeshLoader;
 
 constexpr size_t NumActiveLights = 50;
+constexpr auto TextureUploadBudget = std::chrono::milliseconds {2};
+// written by AT2_texture_cooker, textures are loaded from their sources if it's absent
+constexpr auto CookedTexturesManifest = "resources/cooked/textures.json";
 
 class Sandbox final : public AT2::WindowContextBase
 {
@@ -50,6 +61,15 @@ private:
         return resultTex;
     }
 
+    static std::shared_ptr<AT2::ITexture> MakePlaceholderTexture(AT2::IVisualizationSystem& visualizationSystem, const glm::vec4& color)
+    {
+        const auto packedColor = glm::packUnorm4x8(color);
+
+        auto texture = visualizationSystem.GetResourceFactory().CreateTexture(Texture2D {{1, 1}}, AT2::TextureFormats::RGBA8);
+        texture->SubImage2D({}, {1, 1}, 0, AT2::TextureFormats::RGBA8, &packedColor);
+        return texture;
+    }
+
     void OnInitialized( AT2::IVisualizationSystem& visualizationSystem ) override
     {
         getWindow().setVSyncInterval(1).setCursorMode(CursorMode::Disabled);
@@ -59,24 +79,33 @@ private:
              "resources/shaders/terrain.tes.glsl", "resources/shaders/terrain.fs.glsl"});
 
 
-        MeshShader = visualizationSystem.GetResourceFactory().CreateShaderProgramFromFiles(
-            {"resources/shaders/mesh.vs.glsl", "resources/shaders/mesh.fs.glsl"});
+        MeshShaders.emplace(visualizationSystem.GetResourceFactory(),
+                            std::vector<AT2::str> {"resources/shaders/mesh.vs.glsl", "resources/shaders/mesh.fs.glsl"},
+                            std::vector<AT2::str> {"SKINNING"});
 
 
-        Noise3Tex = visualizationSystem.GetResourceFactory().CreateTexture(Texture3D {{64, 64, 64}, 1}, AT2::TextureFormats::RGBA8);
+        constexpr glm::uvec3 NoiseSize {64, 64, 64};
+        Noise3Tex = visualizationSystem.GetResourceFactory().CreateTexture(
+            Texture3D {NoiseSize, AT2::Resources::MipmapGenerator::GetNumLevels(NoiseSize)}, AT2::TextureFormats::RGBA8);
         {
-            const auto arr = std::make_unique<std::uint8_t[]>(Noise3Tex->GetDataLength());
-            
-            std::generate(arr.get(), arr.get() + Noise3Tex->GetDataLength(),
+            std::vector<std::byte> noise(AT2::GetImageDataLength(AT2::TextureFormats::RGBA8, NoiseSize));
+
+            std::generate(noise.begin(), noise.end(),
                           [rng = std::mt19937{std::random_device {}()}]() mutable {
-                              return std::uniform_int_distribution {0, 255}(rng);
+                              return static_cast<std::byte>(std::uniform_int_distribution {0, 255}(rng));
                           });
-            
-            Noise3Tex->SubImage3D({}, Noise3Tex->GetSize(), 0, AT2::TextureFormats::RGBA8, arr.get());
+
+            AT2::Resources::MipmapGenerator {AT2::Resources::MipmapFilter::Box, false, &m_threadPool}.Upload(
+                *Noise3Tex, AT2::TextureFormats::RGBA8, noise);
         }
 
-        auto GrassTex = TextureLoader::LoadTexture(visualizationSystem, "resources/Ground037_2K-JPG/Ground037_2K_Color.jpg");
-        auto NormalMapTex = TextureLoader::LoadTexture(visualizationSystem, "resources/Ground037_2K-JPG/Ground037_2K_Normal.jpg");
+        if (std::filesystem::exists(CookedTexturesManifest))
+            AT2::Resources::TextureManifest::SetActive(
+                std::make_shared<AT2::Resources::TextureManifest>(AT2::Resources::TextureManifest::Load(CookedTexturesManifest)));
+
+        m_textureCache.emplace(visualizationSystem);
+        m_asyncTextureLoader.emplace(visualizationSystem, m_threadPool, &*m_textureCache);
+
         //auto RockTex = TextureLoader::LoadTexture(visualizationSystem, "resources/Rock035_2K-JPG/Rock035_2K_Color.jpg");
         //auto RockNormalTex = TextureLoader::LoadTexture(visualizationSystem, "resources/Rock035_2K-JPG/Rock035_2K_Normal.jpg");
         //auto RockDisplacementTex = TextureLoader::LoadTexture(visualizationSystem, "resources/Rock035_2K-JPG/Rock035_2K_Displacement.jpg");
@@ -89,17 +118,16 @@ private:
 
         for (size_t i = 0; i < NumActiveLights; ++i)
         {
-            lightsRoot
-                ->AddChild(std::make_shared<AT2::Scene::LightNode>(
-                    AT2::Scene::SphereLight {}, linearRand(glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(1.0f, 1.0f, 1.0f)) * 10000.0f,
-                    "PointLight[" + std::to_string(i) + "]"))
-                .SetTransform(glm::translate(glm::mat4 {1.0},
-                                             {glm::linearRand(-5000.0, 5000.0), glm::linearRand(-300.0, 100.0),
-                                              glm::linearRand(-5000.0, 5000.0)}));
+            auto& lightNode = lightsRoot->AddChild(std::make_shared<AT2::Scene::Node>("PointLight[" + std::to_string(i) + "]"));
+            lightNode.SetTransform(glm::translate(glm::mat4 {1.0}, {glm::linearRand(-5000.0, 5000.0), glm::linearRand(-300.0, 100.0),
+                                                                     glm::linearRand(-5000.0, 5000.0)}));
+            lightNode.addComponent(std::make_unique<AT2::Scene::LightComponent>(
+                AT2::Scene::SphereLight {}, linearRand(glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(1.0f, 1.0f, 1.0f)) * 10000.0f));
         }
 
-        lightsRoot->AddChild(std::make_shared<AT2::Scene::LightNode>(AT2::Scene::SkyLight {glm::vec3(0.0f, 0.707f, 0.707f), EnvironmentMapTex},
-                                                                     glm::vec3(500.0f), "SkyLight"));
+        lightsRoot->AddChild(std::make_shared<AT2::Scene::Node>("SkyLight"s))
+            .addComponent(std::make_unique<AT2::Scene::LightComponent>(
+                AT2::Scene::SkyLight {glm::vec3(0.0f, 0.707f, 0.707f), EnvironmentMapTex}, glm::vec3(500.0f)));
 
         //m_scene
         auto matBallNode = MeshLoader::LoadNode(visualizationSystem, "resources/matball.glb");
@@ -131,7 +159,7 @@ private:
 
         AT2::Scene::FuncNodeVisitor shaderSetter {[&](AT2::Scene::Node& node) {
             for (auto* meshComponent : node.getComponents<AT2::Scene::MeshComponent>())
-                meshComponent->getMesh()->Shader = MeshShader;
+                meshComponent->getMesh()->Shader = MeshShaders->Get(meshComponent->getSkeletonInstance() ? MeshFeatureSkinning : 0);
             return true;
         }};
         m_scene.GetRoot().Accept(shaderSetter);
@@ -146,16 +174,30 @@ private:
             mesh->GetOrCreateDefaultMaterial().Commit([&](AT2::IUniformsWriter& writer) {
                 writer.Write("u_texNoise", Noise3Tex);
                 writer.Write("u_texHeight", HeightMapTex);
-                writer.Write("u_texNormalMap", NormalMapTex);
-                writer.Write("u_texGrass", GrassTex);
-                writer.Write("u_texRock", GrassTex);
+                writer.Write("u_texNormalMap", MakePlaceholderTexture(visualizationSystem, {0.5, 0.5, 1.0, 1.0}));
+                writer.Write("u_texGrass", MakePlaceholderTexture(visualizationSystem, {0.3, 0.3, 0.2, 1.0}));
+                writer.Write("u_texRock", MakePlaceholderTexture(visualizationSystem, {0.3, 0.3, 0.2, 1.0}));
             });
+
+            // terrain is rendered with placeholders until textures are uploaded
+            const auto setTerrainTextures = [weakMesh = std::weak_ptr {mesh}](std::initializer_list<std::string_view> names) {
+                return [weakMesh, names = std::vector<std::string_view> {names}](const AT2::TextureRef& texture) {
+                    if (const auto terrainMesh = weakMesh.lock())
+                        for (const auto name : names)
+                            terrainMesh->GetOrCreateDefaultMaterial().SetUniform(name, texture);
+                };
+            };
+            static_cast<void>(m_asyncTextureLoader->LoadTexture("resources/Ground037_2K-JPG/Ground037_2K_Color.jpg",
+                                                                setTerrainTextures({"u_texGrass", "u_texRock"})));
+            static_cast<void>(m_asyncTextureLoader->LoadTexture("resources/Ground037_2K-JPG/Ground037_2K_Normal.jpg",
+                                                                setTerrainTextures({"u_texNormalMap"})));
         }
         m_scene.GetRoot().AddChild(std::move(terrainNode));
 
         m_renderParameters.Scene = &m_scene;
         m_renderParameters.Camera = &m_camera;
         m_renderParameters.TargetFramebuffer = &visualizationSystem.GetDefaultFramebuffer();
+        m_renderParameters.ThreadPool = &m_threadPool;
 
         sr.Initialize(visualizationSystem);
     }
@@ -169,6 +211,8 @@ private:
             NeedResourceReload = false;
         }
 
+        m_asyncTextureLoader->ProcessUploads(TextureUploadBudget);
+
         visualizationSystem.GetDefaultFramebuffer().Render([this](AT2::IRenderer& renderer){ sr.RenderScene(renderer, m_renderParameters, m_time);});
 
 //        const double frameTime = glTimer.WaitForResult() * 0.000001; // in ms
@@ -188,8 +232,35 @@ private:
             NeedResourceReload = true;
         else if (key == AT2::Keys::Key_L)
         {
-            if (auto* skyLight = m_scene.FindNode<AT2::Scene::LightNode>("SkyLight"sv))
-                skyLight->SetEnabled(!skyLight->GetEnabled());
+            if (auto* skyLightNode = m_scene.FindNode("SkyLight"sv))
+                if (auto* skyLight = skyLightNode->getComponent<AT2::Scene::LightComponent>())
+                    skyLight->SetEnabled(!skyLight->GetEnabled());
+        }
+        else if (key == AT2::Keys::Key_T)
+        {
+            m_textureCache->LogMemoryReport();
+
+            const auto& statistics = sr.GetStatistics();
+            AT2::Log::Info() << "Frame geometry: " << statistics.NumTriangles << " triangles, " << statistics.NumCommands
+                             << " draws in " << statistics.NumDrawCalls << " calls" << std::endl;
+
+            const auto& budgetStatistics = sr.GetLightBudgetStatistics();
+            AT2::Log::Info() << "Light budget: " << budgetStatistics.NumSelected << " of " << budgetStatistics.NumLights
+                             << " lights selected, " << budgetStatistics.NumCulled << " culled, " << budgetStatistics.NumMerged
+                             << " merged, " << budgetStatistics.NumDropped << " dropped" << std::endl;
+
+            const auto& lightStatistics = sr.GetLightStatistics();
+            AT2::Log::Info() << "Light clusters: " << lightStatistics.NumVisibleLights << " of " << lightStatistics.NumLights
+                             << " lights in " << lightStatistics.NumOccupiedClusters << " clusters, "
+                             << lightStatistics.NumIndices << " indices, up to " << lightStatistics.MaxLightsPerCluster
+                             << " lights per cluster" << std::endl;
+
+            const auto& shadowStatistics = sr.GetShadowStatistics();
+            const auto& shadowAtlas = sr.GetShadowAtlas();
+            AT2::Log::Info() << "Shadows: " << shadowStatistics.NumStaleViews << " of " << shadowStatistics.NumViews
+                             << " views rendered, " << shadowStatistics.NumChangedCasters << " of " << shadowStatistics.NumCasters
+                             << " casters changed, " << shadowAtlas.GetNumTiles() << " atlas tiles, " << shadowAtlas.GetFreeArea()
+                             << " texels free" << std::endl;
         }
     }
 
@@ -221,7 +292,6 @@ private:
     void OnUpdate(AT2::Seconds dt) override
     {
         m_time.Update(dt);
-        m_scene.Update(m_time);
 
         if (getWindow().isKeyDown(AT2::Keys::Key_LShift))
             acceleration = std::min(acceleration + static_cast<float>(dt.count()), 200.0f);
@@ -250,9 +320,12 @@ private:
 
         if (MovingLightMode)
         {
-            if (auto* light = m_scene.FindNode<AT2::Scene::LightNode>("PointLight[0]"sv))
+            if (auto* light = m_scene.FindNode("PointLight[0]"sv))
                 light->SetTransform(m_camera.getViewInverse());
         }
+
+        // light components pick up the transforms changed above
+        m_scene.Update(m_time);
     }
    
 private:
@@ -273,9 +346,15 @@ private:
         AT2::Seconds getDeltaTime() const override { return m_deltaTime; }
     } m_time;
 
-    std::shared_ptr<AT2::IShaderProgram> MeshShader, TerrainShader;
+    static constexpr AT2::ShaderPermutations::FeatureMask MeshFeatureSkinning = 1 << 0;
+    std::optional<AT2::ShaderPermutations> MeshShaders;
+    std::shared_ptr<AT2::IShaderProgram> TerrainShader;
     std::shared_ptr<AT2::ITexture> Noise3Tex, HeightMapTex, EnvironmentMapTex;
 
+    AT2::ThreadPool m_threadPool;
+    std::optional<AT2::Resources::TextureCache> m_textureCache;
+    std::optional<AT2::Resources::AsyncTextureLoader> m_asyncTextureLoader;
+
     AT2::Camera m_camera;
     AT2::Scene::Scene m_scene;
     AT2::Scene::SceneRenderer sr;
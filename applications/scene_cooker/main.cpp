@@ -0,0 +1,190 @@
+// Offline scene cooker: imports glTF scenes and other models supported by Assimp, optimizes and packs their geometry and
+// writes them as cooked scenes, which CookedSceneLoader maps and uploads without any parsing. Doesn't need GPU or window.
+
+#include <ThreadPool.h>
+#include <Resources/CookedScene.h>
+#include <Resources/GltfSceneLoader.h>
+#include <Resources/MeshLoader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    constexpr auto CookedExtension = ".at2scene";
+
+    struct Options
+    {
+        std::filesystem::path OutputDirectory = "cooked";
+        size_t NumThreads = ThreadPool::GetDefaultNumThreads() + 1; // there is no render thread to spare
+        bool Force = false;
+        std::vector<std::filesystem::path> Inputs;
+    };
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: AT2_scene_cooker [options] <glTF scenes or other models...>\n"
+                     "  -o, --output <dir>         directory for cooked scenes, 'cooked' by default\n"
+                     "  -j, --threads <number>     number of worker threads\n"
+                     "      --force                cook even if cooked file is newer than the source\n"
+                     "Cooked scene of <name>.gltf is <output>/<name>" << CookedExtension << ", textures are referenced relative to it."
+                  << std::endl;
+    }
+
+    std::optional<Options> ParseOptions(int argc, char* argv[])
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view argument {argv[i]};
+            const auto nextValue = [&]() -> std::optional<std::string_view> {
+                if (i + 1 >= argc)
+                {
+                    std::cerr << "Missing value for " << argument << std::endl;
+                    return std::nullopt;
+                }
+                return argv[++i];
+            };
+
+            if (argument == "-h" || argument == "--help")
+                return std::nullopt;
+
+            if (argument == "-o" || argument == "--output")
+            {
+                const auto value = nextValue();
+                if (!value)
+                    return std::nullopt;
+                options.OutputDirectory = *value;
+            }
+            else if (argument == "-j" || argument == "--threads")
+            {
+                const auto value = nextValue();
+                if (!value)
+                    return std::nullopt;
+                options.NumThreads = std::max<size_t>(std::stoul(std::string {*value}), 1);
+            }
+            else if (argument == "--force")
+                options.Force = true;
+            else if (argument.starts_with('-'))
+            {
+                std::cerr << "Unknown option " << argument << std::endl;
+                return std::nullopt;
+            }
+            else
+                options.Inputs.emplace_back(argument);
+        }
+
+        if (options.Inputs.empty())
+            return std::nullopt;
+
+        return options;
+    }
+
+    template <typename Func>
+    auto Measure(Milliseconds& duration, Func&& func)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = func();
+        duration = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+
+    size_t CountSubMeshes(const CookedScene& scene)
+    {
+        size_t result = 0;
+        for (const auto& mesh : scene.Meshes)
+            result += mesh.SubMeshes.size();
+
+        return result;
+    }
+
+    // Returns false if the cooked file is up to date
+    bool Cook(const Options& options, const std::filesystem::path& source, ThreadPool& threadPool)
+    {
+        const auto cookedPath = options.OutputDirectory / (source.stem().string() + CookedExtension);
+        if (!options.Force)
+        {
+            std::error_code errorCode;
+            const auto cookedTime = std::filesystem::last_write_time(cookedPath, errorCode);
+            if (!errorCode && cookedTime >= std::filesystem::last_write_time(source))
+            {
+                std::cout << source.string() << ": up to date" << std::endl;
+                return false;
+            }
+        }
+
+        Milliseconds importTime {}, writeTime {}, loadTime {};
+        const auto extension = source.extension();
+        const auto scene = Measure(importTime, [&] {
+            return extension == ".gltf" || extension == ".glb" ? GltfMeshLoader::Cook(source, &threadPool) : MeshLoader::Cook(source);
+        });
+
+        const auto writeStart = std::chrono::steady_clock::now();
+        scene.Save(cookedPath);
+        writeTime = std::chrono::steady_clock::now() - writeStart;
+
+        // the whole point of cooking, reading it back is what the application pays at startup
+        const auto cooked = Measure(loadTime, [&] { return CookedScene::Load(cookedPath); });
+
+        constexpr double Megabyte = 1024.0 * 1024.0;
+        std::cout << std::fixed << std::setprecision(1) << source.string() << " -> " << cookedPath.string() << ": " << cooked.Nodes.size()
+                  << " nodes, " << cooked.Meshes.size() << " meshes of " << CountSubMeshes(cooked) << " submeshes, "
+                  << cooked.Animations.size() << " animations, " << cooked.GetData().size() / Megabyte << " MB of data: import "
+                  << importTime.count() << " ms, write " << writeTime.count() << " ms, load " << loadTime.count() << " ms" << std::endl;
+
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const auto options = ParseOptions(argc, argv);
+    if (!options)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    try
+    {
+        std::filesystem::create_directories(options->OutputDirectory);
+
+        // scenes are cooked one by one, their meshes are prepared in parallel
+        ThreadPool threadPool {options->NumThreads};
+
+        size_t numFailed = 0, numCooked = 0, numUpToDate = 0;
+        for (const auto& source : options->Inputs)
+        {
+            try
+            {
+                if (Cook(*options, source, threadPool))
+                    ++numCooked;
+                else
+                    ++numUpToDate;
+            }
+            catch (const std::exception& exception)
+            {
+                std::cerr << source.string() << ": " << exception.what() << std::endl;
+                ++numFailed;
+            }
+        }
+
+        std::cout << "Cooked " << numCooked << " scenes (" << numUpToDate << " up to date, " << numFailed << " failed)" << std::endl;
+        return numFailed == 0 ? 0 : 1;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,456 @@
+// Offline texture cooker: builds gamma-correct mip chains, compresses images to BCn and writes them as DDS files, along
+// with a manifest which TextureLoader uses to load cooked versions instead of the sources. Doesn't need GPU or window.
+
+#include <Hashing.h>
+#include <ThreadPool.h>
+#include <Resources/BlockCompressor.h>
+#include <Resources/MipmapGenerator.h>
+#include <Resources/TextureContainer.h>
+#include <Resources/TextureLoader.h>
+#include <Resources/TextureManifest.h>
+
+#include <fx/gltf.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    // Color images are filtered in linear space, data (normals, roughness, etc.) as is
+    enum class TextureUsage
+    {
+        Color,
+        Data
+    };
+
+    struct Options
+    {
+        std::filesystem::path OutputDirectory = "cooked";
+        std::optional<std::filesystem::path> ManifestPath;
+        MipmapFilter Filter = MipmapFilter::Kaiser;
+        size_t NumThreads = ThreadPool::GetDefaultNumThreads() + 1; // there is no render thread to spare
+        TextureUsage DefaultUsage = TextureUsage::Color;
+        bool Force = false;
+        std::vector<std::filesystem::path> Inputs;
+    };
+
+    struct CookResult
+    {
+        enum class Status
+        {
+            Cooked,
+            UpToDate,
+            Skipped
+        };
+
+        Status Result = Status::Cooked;
+        std::string SkipReason;
+
+        std::filesystem::path Cooked;
+        glm::uvec2 Size {};
+        BlockCompression Compression = BlockCompression::None;
+        size_t NumLevels = 0;
+        size_t DecodedLength = 0;
+        size_t CookedLength = 0;
+
+        Milliseconds DecodeTime {}, MipmapsTime {}, CompressTime {}, WriteTime {};
+    };
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: AT2_texture_cooker [options] <images or glTF scenes...>\n"
+                     "  -o, --output <dir>         directory for cooked textures, 'cooked' by default\n"
+                     "  -m, --manifest <file>      manifest to update, <output>/textures.json by default\n"
+                     "  -f, --filter <box|kaiser>  mipmaps filter, kaiser by default\n"
+                     "  -j, --threads <number>     number of worker threads\n"
+                     "      --data                 standalone images are data, not colors (no gamma correction)\n"
+                     "      --force                cook even if cooked file is newer than the source\n"
+                     "Images referenced by scenes are classified by their usage in materials."
+                  << std::endl;
+    }
+
+    std::optional<Options> ParseOptions(int argc, char* argv[])
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view argument {argv[i]};
+            const auto nextValue = [&]() -> std::optional<std::string_view> {
+                if (i + 1 >= argc)
+                {
+                    std::cerr << "Missing value for " << argument << std::endl;
+                    return std::nullopt;
+                }
+                return argv[++i];
+            };
+
+            if (argument == "-h" || argument == "--help")
+                return std::nullopt;
+
+            if (argument == "-o" || argument == "--output")
+            {
+                const auto value = nextValue();
+                if (!value)
+                    return std::nullopt;
+                options.OutputDirectory = *value;
+            }
+            else if (argument == "-m" || argument == "--manifest")
+            {
+                const auto value = nextValue();
+                if (!value)
+                    return std::nullopt;
+                options.ManifestPath = *value;
+            }
+            else if (argument == "-f" || argument == "--filter")
+            {
+                const auto value = nextValue();
+                if (!value || (*value != "box" && *value != "kaiser"))
+                    return std::nullopt;
+                options.Filter = *value == "box" ? MipmapFilter::Box : MipmapFilter::Kaiser;
+            }
+            else if (argument == "-j" || argument == "--threads")
+            {
+                const auto value = nextValue();
+                if (!value)
+                    return std::nullopt;
+
+                size_t numThreads = 0;
+                const auto [end, error] = std::from_chars(value->data(), value->data() + value->size(), numThreads);
+                if (error != std::errc {} || end != value->data() + value->size() || numThreads == 0)
+                {
+                    std::cerr << "Invalid number of threads " << *value << std::endl;
+                    return std::nullopt;
+                }
+                options.NumThreads = numThreads;
+            }
+            else if (argument == "--data")
+                options.DefaultUsage = TextureUsage::Data;
+            else if (argument == "--force")
+                options.Force = true;
+            else if (argument.starts_with('-'))
+            {
+                std::cerr << "Unknown option " << argument << std::endl;
+                return std::nullopt;
+            }
+            else
+                options.Inputs.emplace_back(argument);
+        }
+
+        if (options.Inputs.empty())
+            return std::nullopt;
+
+        return options;
+    }
+
+    // Color usage wins if the image is used both ways
+    void AddImage(std::map<std::filesystem::path, TextureUsage>& images, const std::filesystem::path& path, TextureUsage usage)
+    {
+        const auto [it, isNew] = images.emplace(path.lexically_normal(), usage);
+        if (!isNew && usage == TextureUsage::Color)
+            it->second = usage;
+    }
+
+    void CollectSceneImages(const std::filesystem::path& scenePath, std::map<std::filesystem::path, TextureUsage>& images)
+    {
+        constexpr fx::gltf::ReadQuotas quotas {64, 1024 * 1024 * 1024, 1024 * 1024 * 1024};
+        const auto document = scenePath.extension() == ".glb" ? fx::gltf::LoadFromBinary(scenePath.string(), quotas)
+                                                              : fx::gltf::LoadFromText(scenePath.string(), quotas);
+
+        const auto addTexture = [&](const fx::gltf::Material::Texture& texture, TextureUsage usage) {
+            if (texture.empty())
+                return;
+
+            const auto source = document.textures.at(texture.index).source;
+            if (source < 0)
+                return;
+
+            const auto& image = document.images.at(source);
+            if (image.uri.empty() || image.IsEmbeddedResource())
+            {
+                std::cout << scenePath.string() << ": embedded image #" << source << " is left as is" << std::endl;
+                return;
+            }
+
+            AddImage(images, scenePath.parent_path() / image.uri, usage);
+        };
+
+        for (const auto& material : document.materials)
+        {
+            addTexture(material.pbrMetallicRoughness.baseColorTexture, TextureUsage::Color);
+            addTexture(material.emissiveTexture, TextureUsage::Color);
+            addTexture(material.pbrMetallicRoughness.metallicRoughnessTexture, TextureUsage::Data);
+            addTexture(material.normalTexture, TextureUsage::Data);
+            addTexture(material.occlusionTexture, TextureUsage::Data);
+        }
+    }
+
+    std::filesystem::path MakeCookedPath(const Options& options, const std::filesystem::path& source)
+    {
+        // different directories could have images with the same name
+        Fnv1a hash;
+        hash.Update(std::filesystem::absolute(source).lexically_normal().generic_string());
+
+        std::ostringstream name;
+        name << source.stem().string() << '_' << std::hex << std::setw(8) << std::setfill('0') << (hash.Get() & 0xffffffffu) << ".dds";
+        return options.OutputDirectory / name.str();
+    }
+
+    template <typename Func>
+    auto Measure(Milliseconds& duration, Func&& func)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = func();
+        duration = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+
+    // Uncompressed layouts are expanded to RGBA like GPU does, returns nullopt for HDR images
+    std::optional<MipmapGenerator::Image> ConvertToRGBA8(const DecodedImage& decodedImage)
+    {
+        const auto format = decodedImage.Format;
+        if (format.DataType != BufferDataType::UByte && format.DataType != BufferDataType::UShort)
+            return std::nullopt;
+
+        const size_t numChannels = GetPixelLength(format) / (format.DataType == BufferDataType::UShort ? 2 : 1);
+        const bool isBgr = format.ChannelsLayout == TextureLayout::BGR || format.ChannelsLayout == TextureLayout::BGRA;
+
+        MipmapGenerator::Image image {decodedImage.Size, std::vector<glm::u8vec4>(size_t {decodedImage.Size.x} * decodedImage.Size.y)};
+        const auto getChannel = [&](size_t texel, size_t channel) -> glm::u8 {
+            const size_t index = texel * numChannels + channel;
+            if (format.DataType == BufferDataType::UShort)
+                return static_cast<glm::u8>(static_cast<const std::uint16_t*>(decodedImage.Data.get())[index] >> 8);
+
+            return static_cast<const std::uint8_t*>(decodedImage.Data.get())[index];
+        };
+
+        for (size_t i = 0; i < image.Texels.size(); ++i)
+        {
+            auto& texel = image.Texels[i];
+            texel = {0, 0, 0, 255};
+            for (size_t channel = 0; channel < numChannels; ++channel)
+                texel[static_cast<glm::length_t>(channel)] = getChannel(i, channel);
+
+            if (isBgr)
+                std::swap(texel.r, texel.b);
+        }
+
+        return image;
+    }
+
+    BlockCompression ChooseCompression(TextureLayout layout, const MipmapGenerator::Image& image)
+    {
+        switch (layout)
+        {
+        case TextureLayout::Red: return BlockCompression::BC4;
+        case TextureLayout::RG: return BlockCompression::BC5;
+        case TextureLayout::RGBA:
+        case TextureLayout::BGRA:
+            if (std::ranges::any_of(image.Texels, [](glm::u8vec4 texel) { return texel.a != 255; }))
+                return BlockCompression::BC3;
+            [[fallthrough]];
+        default: return BlockCompression::BC1;
+        }
+    }
+
+    // Cooked textures are sampled exactly like the sources, which are loaded without sRGB decoding
+    ExternalTextureFormat MakeCookedFormat(BlockCompression compression)
+    {
+        switch (compression)
+        {
+        case BlockCompression::BC4: return {TextureLayout::Red, BufferDataType::UByte, false, compression};
+        case BlockCompression::BC5: return {TextureLayout::RG, BufferDataType::UByte, false, compression};
+        default: return {TextureLayout::RGBA, BufferDataType::UByte, false, compression};
+        }
+    }
+
+    CookResult Cook(const Options& options, const std::filesystem::path& source, TextureUsage usage, ThreadPool& tilesThreadPool)
+    {
+        CookResult result;
+        result.Cooked = MakeCookedPath(options, source);
+
+        if (!options.Force)
+        {
+            std::error_code errorCode;
+            const auto cookedTime = std::filesystem::last_write_time(result.Cooked, errorCode);
+            if (!errorCode && cookedTime >= std::filesystem::last_write_time(source))
+            {
+                result.Result = CookResult::Status::UpToDate;
+                return result;
+            }
+        }
+
+        const auto decodedImage = Measure(result.DecodeTime, [&] { return TextureLoader::DecodeImage(source); });
+        result.Size = decodedImage.Size;
+        result.DecodedLength = decodedImage.DataLength;
+
+        if (decodedImage.Container)
+        {
+            result.Result = CookResult::Status::Skipped;
+            result.SkipReason = "already GPU-ready";
+            return result;
+        }
+
+        const auto baseLevel = ConvertToRGBA8(decodedImage);
+        if (!baseLevel)
+        {
+            result.Result = CookResult::Status::Skipped;
+            result.SkipReason = "HDR images aren't supported";
+            return result;
+        }
+
+        result.Compression = ChooseCompression(decodedImage.Format.ChannelsLayout, *baseLevel);
+
+        const MipmapGenerator generator {options.Filter, usage == TextureUsage::Color, &tilesThreadPool};
+        const auto levels = Measure(result.MipmapsTime, [&] { return generator.Generate(*baseLevel); });
+        result.NumLevels = levels.size();
+
+        TextureContainerLayout layout;
+        layout.Format = MakeCookedFormat(result.Compression);
+        layout.Size = decodedImage.Size;
+        layout.NumLevels = static_cast<unsigned>(levels.size());
+
+        const auto compressedData = Measure(result.CompressTime, [&] {
+            std::vector<std::byte> data;
+            for (unsigned level = 0; level < levels.size(); ++level)
+            {
+                const auto compressedLevel = BlockCompressor::Compress(levels[level].Texels, levels[level].Size, result.Compression, &tilesThreadPool);
+                layout.Images.push_back({level, 0, levels[level].Size, data.size(), compressedLevel.size()});
+                data.insert(data.end(), compressedLevel.begin(), compressedLevel.end());
+            }
+            return data;
+        });
+
+        result.CookedLength = Measure(result.WriteTime, [&] {
+            const auto dds = TextureContainer::WriteDds(layout, compressedData);
+
+            std::ofstream stream {result.Cooked, std::ios::binary};
+            stream.write(reinterpret_cast<const char*>(dds.data()), static_cast<std::streamsize>(dds.size()));
+            if (!stream)
+                throw AT2IOException("can't write '" + result.Cooked.string() + "'");
+
+            return dds.size();
+        });
+
+        return result;
+    }
+
+    std::string_view GetCompressionName(BlockCompression compression)
+    {
+        switch (compression)
+        {
+        case BlockCompression::BC1: return "BC1";
+        case BlockCompression::BC3: return "BC3";
+        case BlockCompression::BC4: return "BC4";
+        case BlockCompression::BC5: return "BC5";
+        default: return "?";
+        }
+    }
+
+    void PrintResult(const std::filesystem::path& source, const CookResult& result)
+    {
+        constexpr double Megabyte = 1024.0 * 1024.0;
+
+        std::cout << source.string() << ": ";
+        switch (result.Result)
+        {
+        case CookResult::Status::UpToDate: std::cout << "up to date" << std::endl; return;
+        case CookResult::Status::Skipped: std::cout << "skipped, " << result.SkipReason << std::endl; return;
+        case CookResult::Status::Cooked: break;
+        }
+
+        std::cout << std::fixed << std::setprecision(1) << result.Size.x << "x" << result.Size.y << " -> " << GetCompressionName(result.Compression)
+                  << ", " << result.NumLevels << " levels: decode " << result.DecodeTime.count() << " ms, mipmaps " << result.MipmapsTime.count()
+                  << " ms, compress " << result.CompressTime.count() << " ms, write " << result.WriteTime.count() << " ms ("
+                  << result.DecodedLength / Megabyte << " MB -> " << result.CookedLength / Megabyte << " MB)" << std::endl;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const auto options = ParseOptions(argc, argv);
+    if (!options)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    try
+    {
+        std::map<std::filesystem::path, TextureUsage> images;
+        for (const auto& input : options->Inputs)
+        {
+            const auto extension = input.extension();
+            if (extension == ".gltf" || extension == ".glb")
+                CollectSceneImages(input, images);
+            else
+                AddImage(images, input, options->DefaultUsage);
+        }
+
+        std::filesystem::create_directories(options->OutputDirectory);
+
+        const auto manifestPath = options->ManifestPath.value_or(options->OutputDirectory / "textures.json");
+        auto manifest = std::filesystem::exists(manifestPath) ? TextureManifest::Load(manifestPath) : TextureManifest {};
+
+        // images are cooked in parallel, and their rows are processed in parallel too at a separate pool,
+        // so image tasks don't wait for the tasks queued behind them
+        const auto startTime = std::chrono::steady_clock::now();
+        ThreadPool tilesThreadPool {options->NumThreads};
+        ThreadPool imagesThreadPool {std::clamp<size_t>(images.size(), 1, options->NumThreads)};
+
+        std::vector<std::pair<std::filesystem::path, std::future<CookResult>>> tasks;
+        for (const auto& [source, usage] : images)
+            tasks.emplace_back(source, imagesThreadPool.Submit([&, source = source, usage = usage] { return Cook(*options, source, usage, tilesThreadPool); }));
+
+        size_t numFailed = 0, numCooked = 0, numUpToDate = 0, numSkipped = 0;
+        for (auto& [source, task] : tasks)
+        {
+            try
+            {
+                const auto result = task.get();
+                PrintResult(source, result);
+
+                switch (result.Result)
+                {
+                case CookResult::Status::Cooked: ++numCooked; break;
+                case CookResult::Status::UpToDate: ++numUpToDate; break;
+                case CookResult::Status::Skipped: ++numSkipped; continue;
+                }
+
+                manifest.Add(source, result.Cooked);
+            }
+            catch (const std::exception& exception)
+            {
+                std::cerr << source.string() << ": " << exception.what() << std::endl;
+                ++numFailed;
+            }
+        }
+
+        manifest.Save(manifestPath);
+
+        const Milliseconds totalTime = std::chrono::steady_clock::now() - startTime;
+        std::cout << "Cooked " << numCooked << " textures (" << numUpToDate << " up to date, " << numSkipped << " skipped, " << numFailed
+                  << " failed) in " << totalTime.count() / 1000.0 << " s using " << options->NumThreads << " threads, manifest: "
+                  << manifestPath.string() << std::endl;
+
+        return numFailed == 0 ? 0 : 1;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,93 @@
+#version 420 core
+
+precision mediump float;
+
+in vec2 v_texCoord;
+
+layout(binding = 1) uniform CameraBlock
+{
+	mat4 u_matView, u_matInverseView, u_matProjection, u_matInverseProjection, u_matViewProjection;
+    double u_time;
+};
+
+uniform sampler2D u_colorMap;
+uniform sampler2D u_normalMap;
+uniform sampler2D u_roughnessMetallicMap;
+uniform sampler2D u_depthMap;
+
+// cluster lists are (first index, number of lights), indices and light data are packed by rows, 2 texels per light:
+// view-space position with radius, then intensity with the shadow index, it's negative for lights without shadows
+uniform sampler3D u_clusterMap;
+uniform sampler2D u_lightIndices;
+uniform sampler2D u_lightData;
+
+uniform ivec3 u_clusterGridSize;
+uniform vec2 u_clusterDepthParams; // near plane and slice scale
+
+// cube faces of the shadowed lights, 6 matrices by shadow index
+const int MaxShadowedLights = 4;
+uniform mat4 u_pointShadowMatrices[MaxShadowedLights * 6];
+// depth of the perspective faces is not linear, so the bias is tiny
+const float PointShadowBias = 0.0002;
+
+layout (location = 0) out vec4 FragColor;
+
+#include "pbr.glsl"
+#include "shadows.glsl"
+
+vec3 getFragPos(in vec3 screenCoord)
+{
+    vec4 pos = u_matInverseProjection * vec4(screenCoord*2.0-1.0, 1.0);
+    return pos.xyz/pos.w;
+}
+
+ivec2 getTexelCoord(in int index, in int width)
+{
+	return ivec2(index % width, index / width);
+}
+
+void main()
+{
+	vec2 texCoord = gl_FragCoord.xy / textureSize(u_colorMap, 0);
+
+	vec4 color = texture(u_colorMap, texCoord);
+	if (color.a < 0.5)
+		discard;
+
+	float z = texture (u_depthMap, texCoord).r;
+	vec3 fragPos = getFragPos(vec3(texCoord, z));
+
+	vec3 normal = texture(u_normalMap, texCoord).rgb;
+	vec2 roughnessMetallic = texture (u_roughnessMetallicMap, texCoord).rg;
+	vec3 F0 = mix(vec3(0.05), color.rgb, roughnessMetallic.g);
+	float roughness = roughnessMetallic.r;
+	vec3 viewDir = normalize(-fragPos);
+
+	int slice = int(floor(log(max(-fragPos.z / u_clusterDepthParams.x, 1.0)) * u_clusterDepthParams.y));
+	ivec3 cluster = clamp(ivec3(ivec2(texCoord * u_clusterGridSize.xy), slice), ivec3(0), u_clusterGridSize - 1);
+
+	vec2 lightList = texelFetch(u_clusterMap, cluster, 0).rg;
+	int firstLight = int(lightList.x), numLights = int(lightList.y);
+	int indicesWidth = textureSize(u_lightIndices, 0).x, dataWidth = textureSize(u_lightData, 0).x;
+
+	vec3 lighting = vec3(0.0);
+	for (int i = 0; i < numLights; ++i)
+	{
+		int light = int(texelFetch(u_lightIndices, getTexelCoord(firstLight + i, indicesWidth), 0).r);
+		vec4 positionRadius = texelFetch(u_lightData, getTexelCoord(light * 2, dataWidth), 0);
+		vec4 intensityShadow = texelFetch(u_lightData, getTexelCoord(light * 2 + 1, dataWidth), 0);
+
+		vec3 lightVec = positionRadius.xyz - fragPos;
+		float lit = 1.0;
+		if (intensityShadow.w >= 0.0)
+		{
+			int face = getCubeFace(mat3(u_matInverseView) * -lightVec);
+			lit = getShadow(u_pointShadowMatrices[int(intensityShadow.w) * 6 + face], fragPos, PointShadowBias);
+		}
+
+		if (lit > 0.0)
+			lighting += computeLighting(lightVec, positionRadius.w, intensityShadow.rgb, normal, viewDir, roughness, F0, color.rgb) * lit;
+	}
+
+	FragColor = vec4(lighting, 1.0);
+}
@@ -4,11 +4,12 @@ layout(location = 1) in vec3 a_Position;
 layout(location = 2) in vec3 a_TexCoord;
 layout(location = 3) in vec3 a_Normal;
 
+#ifdef SKINNING
 layout(location = 4) in uvec4 a_Joints;
 layout(location = 5) in vec4 a_Weights;
 
-uniform bool u_useSkinning = false;
 uniform mat4 u_skeletonMatrices[200];
+#endif
 
 layout (binding = 1) uniform CameraBlock
 {
@@ -28,7 +29,7 @@ void main()
 {
 	mat3 normalMatrix = u_matNormal;
 	mat4 modelView = u_matView * u_matModel;
-	if (u_useSkinning)
+#ifdef SKINNING
 	{
 		modelView = modelView * (
 			a_Weights.x * u_skeletonMatrices[int(a_Joints.x)] +
@@ -38,6 +39,7 @@ void main()
 
 		normalMatrix = mat3(transpose(inverse(modelView)));
 	}
+#endif
 	vec4 viewSpacePos = modelView * vec4(a_Position, 1.0);
 
 
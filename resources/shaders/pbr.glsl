@@ -1,9 +1,14 @@
-#version 420 core
+// Lighting library, included by light pass shaders. Define PBR_IBL before including to get image based lighting,
+// in that case getReflection must be implemented by the includer.
 
+#ifndef M_PI
 #define M_PI 3.1415926535897932384626433832795
+#endif
 #define M_INV_PI 0.31830988618379067153776752674503
 
+#ifdef PBR_IBL
 vec4 getReflection(vec3 dir, float lod);
+#endif
 
 
 
@@ -154,6 +159,7 @@ vec3 computeLighting (
 	return lightColor * (F * attenuation);
 }
 
+#ifdef PBR_IBL
 // Hammersley function (return random low-discrepency points)
 vec2 Hammersley(uint i, uint N)
 {
@@ -246,4 +252,6 @@ vec3 computeIBL (
 	return lighting/numSamples;
 }
 
-#endif
\ No newline at end of file
+#endif // PBR_IBL
+
+#endif
@@ -0,0 +1,5 @@
+#version 420 core
+
+void main()
+{
+}
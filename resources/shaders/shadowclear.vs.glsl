@@ -0,0 +1,9 @@
+#version 420 core
+
+layout(location = 1) in vec4 a_Position;
+
+// Fullscreen quad at the far plane, clears depth of the viewport
+void main()
+{
+	gl_Position = vec4(a_Position.xy, 1.0, 1.0);
+}
@@ -0,0 +1,42 @@
+// Shadow maps library, included by light pass shaders. Shadow maps of all of the lights are tiles of one depth atlas,
+// shadow matrices transform view-space positions to texture coordinates of the atlas and the depth of the tile.
+
+uniform sampler2D u_shadowAtlas;
+
+// 1 when the position is lit, bias is in depth units of the tile
+float sampleShadow(in vec3 shadowCoord, in float bias)
+{
+	return texture(u_shadowAtlas, shadowCoord.xy).r + bias >= shadowCoord.z ? 1.0 : 0.0;
+}
+
+float getShadow(in mat4 shadowMatrix, in vec3 fragPos, in float bias)
+{
+	vec4 shadowCoord = shadowMatrix * vec4(fragPos, 1.0);
+	return sampleShadow(shadowCoord.xyz / shadowCoord.w, bias);
+}
+
+// 3x3 percentage closer filtering
+float getShadowPCF(in mat4 shadowMatrix, in vec3 fragPos, in float bias)
+{
+	vec4 shadowCoord = shadowMatrix * vec4(fragPos, 1.0);
+	shadowCoord.xyz /= shadowCoord.w;
+
+	vec2 texelSize = 1.0 / vec2(textureSize(u_shadowAtlas, 0));
+	float lit = 0.0;
+	for (int x = -1; x <= 1; ++x)
+		for (int y = -1; y <= 1; ++y)
+			lit += sampleShadow(vec3(shadowCoord.xy + vec2(x, y) * texelSize, shadowCoord.z), bias);
+
+	return lit / 9.0;
+}
+
+// Face of the cube shadow map by the world-space direction from the light, in +X, -X, +Y, -Y, +Z, -Z order
+int getCubeFace(in vec3 direction)
+{
+	vec3 a = abs(direction);
+	if (a.x >= a.y && a.x >= a.z)
+		return direction.x > 0.0 ? 0 : 1;
+	if (a.y >= a.z)
+		return direction.y > 0.0 ? 2 : 3;
+	return direction.z > 0.0 ? 4 : 5;
+}
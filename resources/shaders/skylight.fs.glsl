@@ -26,8 +26,18 @@ uniform sampler2D u_depthMap;
 uniform vec3 u_lightIntensity;
 uniform vec3 u_lightDirection = vec3(0.0, 0.707, 0.707);
 
+// cascades end at the split view depths, biases are in depth units of the cascades
+uniform int u_numCascades = 0;
+uniform vec4 u_cascadeSplits;
+uniform vec4 u_cascadeBiases;
+uniform mat4 u_cascadeMatrices[4];
+
 layout (location = 0) out vec4 FragColor;
 
+#define PBR_IBL
+#include "pbr.glsl"
+#include "shadows.glsl"
+
 vec4 getReflection(vec3 dirVS, float lod) // SphereMap
 {
 	vec3 dir = mat3(u_matInverseView) * dirVS;
@@ -42,18 +52,15 @@ vec3 getFragPos(in vec3 screenCoord)
     return pos.xyz/pos.w;
 }
 
-vec3 computeLighting (
-		in vec3 lightVec, in float lightRadius, in vec3 lightColor,
- 		in vec3 normal, in vec3 viewDir,
-		in float roughtness, in vec3 F0,
-		in vec3 diffuseColor
- 	);
+float getCascadedShadow(in vec3 fragPos)
+{
+	float depth = -fragPos.z;
+	for (int i = 0; i < u_numCascades; ++i)
+		if (depth < u_cascadeSplits[i])
+			return getShadowPCF(u_cascadeMatrices[i], fragPos, u_cascadeBiases[i]);
 
-vec3 computeIBL (
-	in int numSamples,
-	in vec3 normal, in vec3 viewDir,
-	in float roughtness, in vec3 F0
-);
+	return 1.0;
+}
 
 void main()
 {
@@ -71,6 +78,7 @@ void main()
 	float roughness = roughnessMetallic.r;
 
 	vec3 lighting = computeLighting(mat3(u_matView) * u_lightDirection, 0.0, u_lightIntensity*0.001, normal, normalize(-fragPos), roughness, F0, color.rgb);
+	lighting *= getCascadedShadow(fragPos);
 	lighting = lighting + computeIBL(20, normal, normalize(-fragPos), roughness, F0) * 5.0;
 
 	
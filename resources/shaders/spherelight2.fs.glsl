@@ -36,12 +36,7 @@ uniform sampler2D u_depthMap;
 layout (location = 0) out vec4 FragColor;
 
 
-vec3 computeLighting (
-		in vec3 lightVec, in float lightRadius, in vec3 lightColor,
- 		in vec3 normal, in vec3 viewDir,
-		in float roughtness, in vec3 F0,
-		in vec3 diffuseColor
- 	);
+#include "pbr.glsl"
 
 vec3 getFragPos(in vec3 screenCoord) 
 {
@@ -11,7 +11,9 @@
 
 
 #include <array>
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <span>
 #include <set>
 #include <string>
@@ -48,6 +50,7 @@ namespace AT2
     class IStateManager;
     class IResourceFactory;
     class IVisualizationSystem;
+    struct ShaderDefine;
     class IRenderer;
 
     class ITime
@@ -78,6 +81,13 @@ namespace AT2
 
     public:
         virtual void Reload() = 0;
+
+        // Files the resource is made from, used to reload it when any of them is changed.
+        // nullopt means they aren't known yet (e.g. resource is still loading)
+        [[nodiscard]] virtual std::optional<std::vector<std::filesystem::path>> getDependencies() const
+        {
+            return std::vector<std::filesystem::path> {};
+        }
     };
 
     //TODO: make it usable for vertex buffers, textures etc
@@ -217,6 +227,7 @@ namespace AT2
                                  BufferUsage usage = BufferUsage::ReadWrite) const = 0;
         virtual void BuildMipmaps() = 0;
 
+        // Depth of layered textures is the number of layers, it's 6 faces for cube maps
         [[nodiscard]] virtual glm::uvec3 GetSize() const noexcept = 0;
         [[nodiscard]] virtual size_t GetDataLength() const noexcept = 0;
 
@@ -229,7 +240,7 @@ namespace AT2
         // Set data of a Texture1DArray and Texture2D
         virtual void SubImage2D(glm::uvec2 offset, glm::uvec2 size, glm::u32 level, ExternalTextureFormat dataFormat,
                                 const void* data) = 0;
-        // Set data of a Texture2DArray, Texture3D, TextureCubeArray, TextureCube
+        // Set data of a Texture2DArray, Texture3D, TextureCubeArray, TextureCube. Faces of cube maps are layers of z
         virtual void SubImage3D(glm::uvec3 offset, glm::uvec3 size, glm::u32 level, ExternalTextureFormat dataFormat,
                                 const void* data) = 0;
     };
@@ -339,6 +350,8 @@ namespace AT2
         [[nodiscard]] virtual std::optional<BufferDataType> GetIndexDataType() const noexcept = 0;
 
     	[[nodiscard]] virtual std::optional<unsigned int> GetActiveTextureIndex(std::shared_ptr<ITexture> texture) const noexcept = 0;
+        //Pinned texture keeps it's texture unit until unpinned, useful for frequently used textures like G-buffer
+        virtual void PinTexture(const std::shared_ptr<ITexture>& texture, bool pinned) = 0;
     };
 
     class IResourceFactory
@@ -362,6 +375,8 @@ namespace AT2
                                                                                      const glm::uvec2& size) const = 0;
         [[nodiscard]] virtual std::shared_ptr<ITexture> CreateTexture(const Texture& declaration,
                                                                       ExternalTextureFormat desiredFormat) const = 0;
+        // New texture object sharing storage (texels) with the given one, but with it's own sampling state
+        [[nodiscard]] virtual std::shared_ptr<ITexture> CreateTextureView(const std::shared_ptr<ITexture>& texture) const = 0;
         [[nodiscard]] virtual std::shared_ptr<IFrameBuffer> CreateFrameBuffer() const = 0;
         [[nodiscard]] virtual std::shared_ptr<IVertexArray> CreateVertexArray() const = 0;
 
@@ -369,8 +384,13 @@ namespace AT2
         [[nodiscard]] virtual std::shared_ptr<IBuffer> CreateBuffer(VertexBufferType type, std::span<const std::byte> data) const = 0;
         [[nodiscard]] virtual std::shared_ptr<IShaderProgram>
             CreateShaderProgramFromFiles(std::initializer_list<str> files) const = 0;
+        // Sources are preprocessed: includes are resolved, defines are injected (see ShaderPreprocessor)
+        [[nodiscard]] virtual std::shared_ptr<IShaderProgram>
+            CreateShaderProgramFromFiles(std::span<const str> files, std::span<const ShaderDefine> defines) const = 0;
 
         virtual void ReloadResources(ReloadableGroup group) = 0;
+        // Makes externally created resource (e.g. loaded texture) reloadable, factory doesn't own it
+        virtual void RegisterReloadable(std::weak_ptr<IReloadable> resource) const = 0;
     };
 
     class IVisualizationSystem
@@ -404,8 +424,19 @@ namespace AT2
 
     public:
 
-        //Draws count vertices connected by primitive type.
+        //Draws count vertices connected by primitive type. Base vertex is added to indices and could be negative.
         virtual void Draw(Primitives::Primitive type, size_t first, long int count, int numInstances = 1, int baseVertex = 0) = 0;
+        //Draws several ranges of the bound index buffer by one call if possible
+        virtual void MultiDrawIndexed(Primitives::Primitive type, std::span<const DrawElementsIndirectCommand> commands)
+        {
+            for (const auto& command : commands)
+            {
+                if (command.BaseInstance != 0)
+                    throw AT2NotImplementedException("IRenderer: base instance is not supported");
+
+                Draw(type, command.FirstIndex, command.Count, static_cast<int>(command.InstanceCount), command.BaseVertex);
+            }
+        }
         virtual void SetViewport(const AABB2d& viewport) = 0;
         virtual void SetScissorWindow(const AABB2d& viewport) = 0;
         
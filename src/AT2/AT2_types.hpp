@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 
 #include <chrono>
+#include <cstdint>
 #include <type_traits>
 #include <span>
 #include <variant>
@@ -26,14 +27,16 @@ namespace AT2
         HalfFloat,
         Float,
         Double,
-        Fixed
+        Fixed,
+        Int2101010Rev // signed x, y, z (10 bits) and w (2 bits) packed into 32 bits, for vertex attributes with Count 4
     };
 
     enum class VertexBufferType : unsigned char//TODO: Not full list of types!
     {
         ArrayBuffer,
         IndexBuffer,
-        UniformBuffer
+        UniformBuffer,
+        IndirectBuffer
     };
 
     struct BufferBindingParams
@@ -73,6 +76,26 @@ namespace AT2
             return BufferDataType::Byte; //TODO: think what to do here :)
         }
 
+        constexpr size_t GetSizeOf(BufferDataType type)
+        {
+            switch (type)
+            {
+            case BufferDataType::Byte:
+            case BufferDataType::UByte: return 1;
+            case BufferDataType::Short:
+            case BufferDataType::UShort:
+            case BufferDataType::HalfFloat: return 2;
+            case BufferDataType::Int:
+            case BufferDataType::UInt:
+            case BufferDataType::Float:
+            case BufferDataType::Fixed: return 4;
+            case BufferDataType::Double: return 8;
+            case BufferDataType::Int2101010Rev: return 4; // the whole packed element
+            }
+
+            return 0;
+        }
+
         template <typename T>
         constexpr BufferBindingParams BufferTypeOf = {DeduceBufferDataType<T>(), 1, sizeof(T)};
 
@@ -141,13 +164,83 @@ namespace AT2
         StencilIndex
     };
 
+    // Block compression formats (S3TC, RGTC, BPTC), all of them encode 4x4 texel blocks.
+    // BC1 has 1-bit alpha when ChannelsLayout is RGBA, PreferSRGB is respected by BC1-BC3 and BC7
+    enum class BlockCompression : unsigned char
+    {
+        None,
+        BC1,
+        BC2,
+        BC3,
+        BC4,
+        BC4Signed,
+        BC5,
+        BC5Signed,
+        BC6H,
+        BC6HSigned,
+        BC7
+    };
+
     struct ExternalTextureFormat
     {
         TextureLayout ChannelsLayout;
         BufferDataType DataType;
         bool PreferSRGB = false;
+        BlockCompression Compression = BlockCompression::None;
+
+        bool operator==(const ExternalTextureFormat&) const = default;
     };
 
+    // Size of the 4x4 texels block
+    constexpr size_t GetBlockLength(BlockCompression compression)
+    {
+        switch (compression)
+        {
+        case BlockCompression::None: return 0;
+        case BlockCompression::BC1:
+        case BlockCompression::BC4:
+        case BlockCompression::BC4Signed: return 8;
+        default: return 16;
+        }
+    }
+
+    constexpr size_t GetPixelLength(ExternalTextureFormat format)
+    {
+        const size_t numChannels = [&]() -> size_t {
+            switch (format.ChannelsLayout)
+            {
+            case TextureLayout::RG: return 2;
+            case TextureLayout::RGB:
+            case TextureLayout::BGR: return 3;
+            case TextureLayout::RGBA:
+            case TextureLayout::BGRA: return 4;
+            default: return 1;
+            }
+        }();
+
+        switch (format.DataType)
+        {
+        case BufferDataType::Short:
+        case BufferDataType::UShort:
+        case BufferDataType::HalfFloat: return numChannels * 2;
+        case BufferDataType::Int:
+        case BufferDataType::UInt:
+        case BufferDataType::Float:
+        case BufferDataType::Fixed: return numChannels * 4;
+        case BufferDataType::Double: return numChannels * 8;
+        default: return numChannels;
+        }
+    }
+
+    // Tightly packed image size, compressed images are padded to the whole blocks
+    constexpr size_t GetImageDataLength(ExternalTextureFormat format, glm::uvec3 size)
+    {
+        if (format.Compression != BlockCompression::None)
+            return size_t {(size.x + 3) / 4} * ((size.y + 3) / 4) * size.z * GetBlockLength(format.Compression);
+
+        return size_t {size.x} * size.y * size.z * GetPixelLength(format);
+    }
+
     enum class TextureWrapMode
     {
         ClampToEdge,
@@ -164,6 +257,8 @@ namespace AT2
         TextureWrapMode WrapR = TextureWrapMode::Repeat;
 
         static constexpr TextureWrapParams Uniform(TextureWrapMode mode) { return {mode, mode, mode}; }
+
+        bool operator==(const TextureWrapParams&) const = default;
     };
 
     enum class TextureSamplingMode
@@ -197,6 +292,8 @@ namespace AT2
 
             return {samplingMode, {samplingMode, MipmapSamplingMode::Manual}};
         }
+
+        bool operator==(const TextureSamplingParams&) const = default;
     };
 
     enum class BufferUsage : char
@@ -216,6 +313,8 @@ namespace AT2
         constexpr auto RGBA8 = ExternalTextureFormat{ TextureLayout::RGBA, BufferDataType::UByte };
         constexpr auto RGBA16F = ExternalTextureFormat{ TextureLayout::RGBA, BufferDataType::HalfFloat };
         constexpr auto RGBA32F = ExternalTextureFormat{ TextureLayout::RGBA, BufferDataType::Float };
+        constexpr auto R32F = ExternalTextureFormat{ TextureLayout::Red, BufferDataType::Float };
+        constexpr auto RG32F = ExternalTextureFormat{ TextureLayout::RG, BufferDataType::Float };
         constexpr auto DEPTH32F = ExternalTextureFormat{ TextureLayout::DepthComponent, BufferDataType::Float };
     }
 
@@ -251,6 +350,18 @@ namespace AT2
             >;
     }
 
+    // One draw of the indexed multi-draw, layout is the same as the OpenGL/Vulkan indirect command has
+    struct DrawElementsIndirectCommand
+    {
+        std::uint32_t Count = 0;
+        std::uint32_t InstanceCount = 1;
+        // Index of the first element in the index buffer
+        std::uint32_t FirstIndex = 0;
+        std::int32_t BaseVertex = 0;
+        std::uint32_t BaseInstance = 0;
+    };
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
 }
 
 using Uniform = std::variant
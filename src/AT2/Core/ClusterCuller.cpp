@@ -0,0 +1,132 @@
+#include "ClusterCuller.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+using namespace AT2;
+using namespace AT2::Simd;
+
+namespace
+{
+    // instances differ a lot in meshlet count, so tasks are small
+    constexpr size_t MinInstancesPerTask = 4;
+
+    static_assert(MeshletSet::BlockSize == 4, "blocks are processed by 4-wide vectors");
+
+    struct Plane4
+    {
+        Float4 X, Y, Z, W;
+    };
+
+    // Frustum planes of the clip matrix (Gribb and Hartmann), normalized so the distances are in the units of it's source space.
+    // Near plane is the one of OpenGL depth range, it's conservative for zero to one depth.
+    std::array<Plane4, 6> GetFrustumPlanes(const glm::mat4& clip)
+    {
+        const auto rows = glm::transpose(clip);
+        const auto planes = std::to_array<glm::vec4>(
+            {rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2]});
+
+        std::array<Plane4, 6> result;
+        for (size_t i = 0; i < planes.size(); ++i)
+        {
+            const auto length = glm::length(glm::vec3 {planes[i]});
+            const auto plane = length > 0.0f ? planes[i] / length : planes[i];
+            result[i] = {Splat(plane.x), Splat(plane.y), Splat(plane.z), Splat(plane.w)};
+        }
+
+        return result;
+    }
+} // namespace
+
+void ClusterCuller::SetView(const glm::mat4& view, const glm::mat4& projection) noexcept
+{
+    m_viewProjection = projection * view;
+
+    const bool isPerspective = projection[2][3] != 0.0f;
+    m_cameraPosition = isPerspective ? glm::vec4 {glm::vec3 {glm::inverse(view)[3]}, 1.0f} : glm::vec4 {0.0f};
+}
+
+ClusterCuller::Statistics ClusterCuller::Cull(const MeshletSet& meshlets, const glm::mat4& model, std::vector<uint32_t>& visibleMeshlets) const
+{
+    Statistics statistics;
+    statistics.NumClusters = meshlets.Size();
+
+    const auto planes = GetFrustumPlanes(m_viewProjection * model);
+
+    // back faces stay back faces under affine transforms unless they mirror the winding
+    const bool useCones = m_cameraPosition.w != 0.0f && glm::determinant(model) > 0.0f;
+    const auto camera = useCones ? glm::vec3 {glm::inverse(model) * m_cameraPosition} : glm::vec3 {0.0f};
+    const auto cameraX = Splat(camera.x), cameraY = Splat(camera.y), cameraZ = Splat(camera.z);
+
+    const auto blocks = meshlets.GetBlocks();
+    for (size_t first = 0; first < meshlets.Size(); first += MeshletSet::BlockSize)
+    {
+        const float* block = blocks.data() + first / MeshletSet::BlockSize * MeshletSet::BlockFloats;
+        const auto centerX = Load(block), centerY = Load(block + 4), centerZ = Load(block + 8), radius = Load(block + 12);
+
+        const auto negativeRadius = Sub(Splat(0.0f), radius);
+        unsigned int outside = 0;
+        for (const auto& [x, y, z, w] : planes)
+            outside |= ToBits(Less(Add(Add(Mul(x, centerX), Mul(y, centerY)), Add(Mul(z, centerZ), w)), negativeRadius));
+
+        // sphere is entirely within the cone of back facing view directions
+        unsigned int backfacing = 0;
+        if (useCones)
+        {
+            const auto axisX = Load(block + 16), axisY = Load(block + 20), axisZ = Load(block + 24), cutoff = Load(block + 28);
+            const auto dx = Sub(centerX, cameraX), dy = Sub(centerY, cameraY), dz = Sub(centerZ, cameraZ);
+
+            const auto distance = Sqrt(Add(Add(Mul(dx, dx), Mul(dy, dy)), Mul(dz, dz)));
+            const auto projection = Add(Add(Mul(dx, axisX), Mul(dy, axisY)), Mul(dz, axisZ));
+            backfacing = ToBits(GreaterEqual(projection, Add(Mul(cutoff, distance), radius)));
+        }
+
+        const auto numValid = std::min(meshlets.Size() - first, MeshletSet::BlockSize);
+        const auto valid = (1u << numValid) - 1;
+        outside &= valid;
+        backfacing &= valid & ~outside;
+
+        statistics.NumFrustumCulled += static_cast<size_t>(std::popcount(outside));
+        statistics.NumBackfaceCulled += static_cast<size_t>(std::popcount(backfacing));
+
+        for (auto visible = valid & ~(outside | backfacing); visible != 0; visible &= visible - 1)
+            visibleMeshlets.push_back(static_cast<uint32_t>(first + static_cast<size_t>(std::countr_zero(visible))));
+    }
+
+    return statistics;
+}
+
+ClusterCuller::Statistics ClusterCuller::Cull(std::span<const Instance> instances, DrawBatch& batch, ThreadPool* threadPool)
+{
+    m_visibleMeshlets.resize(instances.size());
+    m_statistics.assign(instances.size(), {});
+
+    const auto cullInstances = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_visibleMeshlets[i].clear();
+            if (instances[i].Meshlets)
+                m_statistics[i] = Cull(*instances[i].Meshlets, instances[i].Model, m_visibleMeshlets[i]);
+        }
+    };
+
+    if (threadPool)
+        threadPool->ParallelFor(instances.size(), MinInstancesPerTask, cullInstances);
+    else
+        cullInstances(0, instances.size());
+
+    Statistics statistics;
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        statistics += m_statistics[i];
+
+        const auto meshlets = instances[i].Meshlets ? instances[i].Meshlets->GetMeshlets() : std::span<const Meshlet> {};
+        for (const auto meshletIndex : m_visibleMeshlets[i])
+            batch.Add(meshlets[meshletIndex].GetChunk());
+    }
+
+    return statistics;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "DrawBatch.h"
+#include "MeshletSet.h"
+
+namespace AT2
+{
+    class ThreadPool;
+
+    // Culls meshlets by the view frustum and by their normal cones. Tests are done in object space of every instance, the
+    // frustum planes and the camera position are transformed there once, so bounds of meshlets are used as they are. Blocks
+    // of meshlets are tested by SSE2 or NEON when they are available.
+    // Cone culling is disabled for orthographic projections and mirroring transforms.
+    class ClusterCuller
+    {
+    public:
+        struct Statistics
+        {
+            size_t NumClusters = 0;
+            size_t NumFrustumCulled = 0;
+            size_t NumBackfaceCulled = 0; // inside of the frustum
+
+            [[nodiscard]] size_t GetNumVisible() const noexcept { return NumClusters - NumFrustumCulled - NumBackfaceCulled; }
+
+            Statistics& operator+=(const Statistics& other) noexcept
+            {
+                NumClusters += other.NumClusters;
+                NumFrustumCulled += other.NumFrustumCulled;
+                NumBackfaceCulled += other.NumBackfaceCulled;
+                return *this;
+            }
+        };
+
+        struct Instance
+        {
+            const MeshletSet* Meshlets = nullptr;
+            glm::mat4 Model {1.0f};
+        };
+
+        ClusterCuller(const glm::mat4& view, const glm::mat4& projection) noexcept { SetView(view, projection); }
+
+        // The culler could be kept between frames, so it's buffers are reused
+        void SetView(const glm::mat4& view, const glm::mat4& projection) noexcept;
+
+        // Appends indices of visible meshlets of the instance to the result, thread-safe
+        Statistics Cull(const MeshletSet& meshlets, const glm::mat4& model, std::vector<uint32_t>& visibleMeshlets) const;
+
+        // Culls the instances at workers of the pool if it's given and adds visible meshlets to the batch in the order of
+        // instances. Commands don't tell their instances apart, BaseInstance is 0 as no shader reads it, so the batch is for
+        // statistics and measurements. Instances drawn with own transforms should be culled one by one.
+        Statistics Cull(std::span<const Instance> instances, DrawBatch& batch, ThreadPool* threadPool = nullptr);
+
+    private:
+        glm::mat4 m_viewProjection;
+        glm::vec4 m_cameraPosition; // w is 0 for orthographic projection
+
+        std::vector<std::vector<uint32_t>> m_visibleMeshlets; // per instance
+        std::vector<Statistics> m_statistics;
+    };
+
+} // namespace AT2
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace AT2
+{
+    // Many-to-many relation between resources and files they are made from, used to find what to rebuild on file change.
+    // Paths are compared after normalization, so "a/../b.glsl" and "b.glsl" are the same file.
+    template <typename Id>
+    class DependencyGraph
+    {
+    public:
+        [[nodiscard]] static std::filesystem::path Normalize(const std::filesystem::path& path)
+        {
+            std::error_code errorCode;
+            auto absolutePath = std::filesystem::absolute(path, errorCode);
+            return (errorCode ? path : absolutePath).lexically_normal();
+        }
+
+        // Replaces previously known dependencies of the resource. Returns files which have no dependents anymore, like Remove
+        std::vector<std::filesystem::path> SetDependencies(const Id& id, std::span<const std::filesystem::path> files)
+        {
+            auto unusedFiles = Remove(id);
+
+            auto& dependencies = m_dependencies[id];
+            for (const auto& file : files)
+            {
+                auto normalizedPath = Normalize(file);
+                if (std::ranges::find(dependencies, normalizedPath) != dependencies.end())
+                    continue;
+
+                m_dependents[normalizedPath].push_back(id);
+                dependencies.push_back(std::move(normalizedPath));
+            }
+
+            // kept ones are used again
+            std::erase_if(unusedFiles, [this](const std::filesystem::path& file) { return m_dependents.contains(file); });
+            return unusedFiles;
+        }
+
+        // Returns files which have no dependents anymore, so they don't have to be watched
+        std::vector<std::filesystem::path> Remove(const Id& id)
+        {
+            std::vector<std::filesystem::path> unusedFiles;
+
+            const auto it = m_dependencies.find(id);
+            if (it == m_dependencies.end())
+                return unusedFiles;
+
+            for (auto& file : it->second)
+            {
+                const auto dependentsIt = m_dependents.find(file);
+                std::erase(dependentsIt->second, id);
+                if (dependentsIt->second.empty())
+                {
+                    m_dependents.erase(dependentsIt);
+                    unusedFiles.push_back(std::move(file));
+                }
+            }
+
+            m_dependencies.erase(it);
+            return unusedFiles;
+        }
+
+        // Every resource is listed once, even if several of it's files were changed
+        [[nodiscard]] std::vector<Id> GetDependents(std::span<const std::filesystem::path> changedFiles) const
+        {
+            std::vector<Id> result;
+            for (const auto& file : changedFiles)
+            {
+                const auto it = m_dependents.find(Normalize(file));
+                if (it == m_dependents.end())
+                    continue;
+
+                for (const auto& id : it->second)
+                    if (std::ranges::find(result, id) == result.end())
+                        result.push_back(id);
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] bool Contains(const Id& id) const { return m_dependencies.contains(id); }
+        [[nodiscard]] size_t GetNumFiles() const noexcept { return m_dependents.size(); }
+
+    private:
+        struct PathHash
+        {
+            size_t operator()(const std::filesystem::path& path) const noexcept { return std::filesystem::hash_value(path); }
+        };
+
+        std::unordered_map<std::filesystem::path, std::vector<Id>, PathHash> m_dependents;
+        std::unordered_map<Id, std::vector<std::filesystem::path>> m_dependencies;
+    };
+
+} // namespace AT2
@@ -0,0 +1,94 @@
+#include "DrawBatch.h"
+
+using namespace AT2;
+
+namespace
+{
+    bool IsSamePrimitive(const Primitives::Primitive& lhs, const Primitives::Primitive& rhs)
+    {
+        if (lhs.index() != rhs.index())
+            return false;
+
+        const auto* lhsPatches = std::get_if<Primitives::Patches>(&lhs);
+        const auto* rhsPatches = std::get_if<Primitives::Patches>(&rhs);
+        return !lhsPatches || lhsPatches->NumControlPoints == rhsPatches->NumControlPoints;
+    }
+
+    // strips, loops and fans can't be concatenated without changing topology
+    bool IsListPrimitive(const Primitives::Primitive& type)
+    {
+        return std::visit(Utils::overloaded {
+            [](const Primitives::LineStrip&) { return false; },
+            [](const Primitives::LineLoop&) { return false; },
+            [](const Primitives::LineStripAdjacency&) { return false; },
+            [](const Primitives::TriangleStrip&) { return false; },
+            [](const Primitives::TriangleFan&) { return false; },
+            [](const Primitives::TriangleStripAdjacency&) { return false; },
+            [](const auto&) { return true; }
+        }, type);
+    }
+}
+
+void DrawBatch::Add(const Primitives::Primitive& type, const DrawElementsIndirectCommand& command)
+{
+    if (command.Count == 0 || command.InstanceCount == 0)
+        return;
+
+    if (m_runs.empty() || !IsSamePrimitive(m_runs.back().Type, type))
+    {
+        m_runs.push_back({type, m_commands.size(), 0});
+    }
+    else if (IsListPrimitive(type))
+    {
+        auto& previous = m_commands.back();
+        if (previous.FirstIndex + previous.Count == command.FirstIndex && previous.BaseVertex == command.BaseVertex &&
+            previous.InstanceCount == command.InstanceCount && previous.BaseInstance == command.BaseInstance)
+        {
+            previous.Count += command.Count;
+            return;
+        }
+    }
+
+    m_commands.push_back(command);
+    ++m_runs.back().NumCommands;
+}
+
+void DrawBatch::Add(const MeshChunk& chunk, unsigned int numInstances, unsigned int baseInstance)
+{
+    Add(chunk.Type, {chunk.Count, numInstances, chunk.StartElement, chunk.BaseVertex, baseInstance});
+}
+
+void DrawBatch::Add(const SubMesh& subMesh, unsigned int numInstances, unsigned int baseInstance)
+{
+    for (const auto& chunk : subMesh.Primitives)
+        Add(chunk, numInstances, baseInstance);
+}
+
+void DrawBatch::Submit(IRenderer& renderer) const
+{
+    const bool isIndexed = renderer.GetStateManager().GetIndexDataType().has_value();
+
+    for (const auto& run : m_runs)
+    {
+        const auto commands = GetCommands().subspan(run.FirstCommand, run.NumCommands);
+        if (isIndexed)
+        {
+            renderer.MultiDrawIndexed(run.Type, commands);
+            continue;
+        }
+
+        for (const auto& command : commands)
+        {
+            if (command.BaseVertex != 0 || command.BaseInstance != 0)
+                throw AT2RendererException("DrawBatch: base vertex and base instance require index buffer");
+
+            renderer.Draw(run.Type, command.FirstIndex, command.Count, static_cast<int>(command.InstanceCount));
+        }
+    }
+}
+
+void DrawBatch::Clear() noexcept
+{
+    m_commands.clear();
+    m_runs.clear();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "AT2.h"
+#include "Mesh.h"
+
+namespace AT2
+{
+    // Collects draw commands to submit them by as few draw calls as possible.
+    // Consecutive commands with the same primitive type become one multi-draw call,
+    // adjacent index ranges of list primitives with the same base vertex and instancing are merged into one command.
+    class DrawBatch
+    {
+    public:
+        struct Run
+        {
+            Primitives::Primitive Type;
+            size_t FirstCommand;
+            size_t NumCommands;
+        };
+
+    public:
+        void Add(const Primitives::Primitive& type, const DrawElementsIndirectCommand& command);
+        void Add(const MeshChunk& chunk, unsigned int numInstances = 1, unsigned int baseInstance = 0);
+        void Add(const SubMesh& subMesh, unsigned int numInstances = 1, unsigned int baseInstance = 0);
+
+        // Uses MultiDrawIndexed when vertex array has index buffer, one Draw per command otherwise
+        void Submit(IRenderer& renderer) const;
+        void Clear() noexcept;
+
+        [[nodiscard]] bool Empty() const noexcept { return m_commands.empty(); }
+        [[nodiscard]] std::span<const DrawElementsIndirectCommand> GetCommands() const noexcept { return m_commands; }
+        [[nodiscard]] std::span<const Run> GetRuns() const noexcept { return m_runs; }
+
+    private:
+        std::vector<DrawElementsIndirectCommand> m_commands;
+        std::vector<Run> m_runs;
+    };
+
+} // namespace AT2
@@ -0,0 +1,217 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace AT2;
+
+namespace
+{
+    struct PathHash
+    {
+        size_t operator()(const std::filesystem::path& path) const noexcept { return std::filesystem::hash_value(path); }
+    };
+
+    std::filesystem::path Normalize(const std::filesystem::path& path)
+    {
+        std::error_code errorCode;
+        auto absolutePath = std::filesystem::absolute(path, errorCode);
+        return (errorCode ? path : absolutePath).lexically_normal();
+    }
+} // namespace
+
+class FileWatcher::Impl
+{
+public:
+    virtual ~Impl() = default;
+
+    virtual void Watch(const std::filesystem::path& file) = 0;
+    virtual void Unwatch(const std::filesystem::path& file) = 0;
+    virtual std::vector<std::filesystem::path> PollChanges() = 0;
+    [[nodiscard]] virtual bool IsNative() const noexcept = 0;
+    [[nodiscard]] virtual size_t GetNumWatchedDirectories() const noexcept = 0;
+};
+
+class FileWatcher::PollingImpl : public FileWatcher::Impl
+{
+public:
+    explicit PollingImpl(std::chrono::milliseconds pollInterval) : m_pollInterval {pollInterval} {}
+
+    void Watch(const std::filesystem::path& file) override { m_files.try_emplace(file, GetModificationTime(file)); }
+    void Unwatch(const std::filesystem::path& file) override { m_files.erase(file); }
+
+    std::vector<std::filesystem::path> PollChanges() override
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - m_lastPollTime < m_pollInterval)
+            return {};
+        m_lastPollTime = now;
+
+        std::vector<std::filesystem::path> changedFiles;
+        for (auto& [file, modificationTime] : m_files)
+        {
+            const auto actualModificationTime = GetModificationTime(file);
+            if (actualModificationTime != modificationTime)
+            {
+                modificationTime = actualModificationTime;
+                changedFiles.push_back(file);
+            }
+        }
+
+        return changedFiles;
+    }
+
+    [[nodiscard]] bool IsNative() const noexcept override { return false; }
+    [[nodiscard]] size_t GetNumWatchedDirectories() const noexcept override { return 0; }
+
+private:
+    static std::filesystem::file_time_type GetModificationTime(const std::filesystem::path& file)
+    {
+        std::error_code errorCode;
+        const auto time = std::filesystem::last_write_time(file, errorCode);
+        return errorCode ? std::filesystem::file_time_type::min() : time;
+    }
+
+private:
+    std::unordered_map<std::filesystem::path, std::filesystem::file_time_type, PathHash> m_files;
+    std::chrono::milliseconds m_pollInterval;
+    std::chrono::steady_clock::time_point m_lastPollTime {};
+};
+
+#ifdef __linux__
+class FileWatcher::InotifyImpl : public FileWatcher::Impl
+{
+public:
+    static std::unique_ptr<InotifyImpl> Create()
+    {
+        const int descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        return descriptor >= 0 ? std::make_unique<InotifyImpl>(descriptor) : nullptr;
+    }
+
+    explicit InotifyImpl(int descriptor) : m_descriptor {descriptor} {}
+    ~InotifyImpl() override { close(m_descriptor); }
+
+    void Watch(const std::filesystem::path& file) override
+    {
+        if (!m_files.insert(file).second)
+            return;
+
+        // editors often write to a temporary file and rename it, so the directory is watched rather than file itself
+        auto directory = file.parent_path();
+        if (const auto it = m_directoryWatches.find(directory); it != m_directoryWatches.end())
+        {
+            ++it->second.NumFiles;
+            return;
+        }
+
+        const int watchDescriptor = inotify_add_watch(m_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watchDescriptor < 0)
+        {
+            m_files.erase(file);
+            return;
+        }
+
+        m_watchedDirectories.emplace(watchDescriptor, directory);
+        m_directoryWatches.emplace(std::move(directory), DirectoryWatch {watchDescriptor, 1});
+    }
+
+    // Directory watch is removed with the last file in it
+    void Unwatch(const std::filesystem::path& file) override
+    {
+        if (m_files.erase(file) == 0)
+            return;
+
+        const auto it = m_directoryWatches.find(file.parent_path());
+        if (it == m_directoryWatches.end() || --it->second.NumFiles > 0)
+            return;
+
+        inotify_rm_watch(m_descriptor, it->second.Descriptor);
+        m_watchedDirectories.erase(it->second.Descriptor);
+        m_directoryWatches.erase(it);
+    }
+
+
+    std::vector<std::filesystem::path> PollChanges() override
+    {
+        std::vector<std::filesystem::path> changedFiles;
+
+        alignas(inotify_event) char buffer[4096];
+        for (ssize_t length; (length = read(m_descriptor, buffer, sizeof(buffer))) > 0;)
+        {
+            for (const char* position = buffer; position < buffer + length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(position);
+                position += sizeof(inotify_event) + event->len;
+
+                const auto directoryIt = m_watchedDirectories.find(event->wd);
+                if (event->len == 0 || directoryIt == m_watchedDirectories.end())
+                    continue;
+
+                auto file = directoryIt->second / event->name;
+                if (m_files.contains(file) && std::ranges::find(changedFiles, file) == changedFiles.end())
+                    changedFiles.push_back(std::move(file));
+            }
+        }
+
+        return changedFiles;
+    }
+
+    [[nodiscard]] bool IsNative() const noexcept override { return true; }
+    [[nodiscard]] size_t GetNumWatchedDirectories() const noexcept override { return m_directoryWatches.size(); }
+
+private:
+    struct DirectoryWatch
+    {
+        int Descriptor;
+        size_t NumFiles; // watched files in the directory
+    };
+
+    int m_descriptor;
+    std::unordered_set<std::filesystem::path, PathHash> m_files;
+    std::unordered_map<int, std::filesystem::path> m_watchedDirectories;
+    std::unordered_map<std::filesystem::path, DirectoryWatch, PathHash> m_directoryWatches;
+};
+#endif
+
+FileWatcher::FileWatcher(std::chrono::milliseconds pollInterval)
+{
+#ifdef __linux__
+    m_impl = InotifyImpl::Create();
+#endif
+
+    if (!m_impl)
+        m_impl = std::make_unique<PollingImpl>(pollInterval);
+}
+
+FileWatcher::~FileWatcher() = default;
+
+void FileWatcher::Watch(const std::filesystem::path& file)
+{
+    m_impl->Watch(Normalize(file));
+}
+
+void FileWatcher::Unwatch(const std::filesystem::path& file)
+{
+    m_impl->Unwatch(Normalize(file));
+}
+
+std::vector<std::filesystem::path> FileWatcher::PollChanges()
+{
+    return m_impl->PollChanges();
+}
+
+bool FileWatcher::IsNative() const noexcept
+{
+    return m_impl->IsNative();
+}
+
+size_t FileWatcher::GetNumWatchedDirectories() const noexcept
+{
+    return m_impl->GetNumWatchedDirectories();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace AT2
+{
+    // Reports modifications of the watched files without blocking.
+    // Uses inotify on Linux (directories are watched, so files replaced by editors are tracked too),
+    // elsewhere falls back to polling of modification times, not more often than pollInterval.
+    class FileWatcher
+    {
+    public:
+        explicit FileWatcher(std::chrono::milliseconds pollInterval = std::chrono::milliseconds {500});
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        void Watch(const std::filesystem::path& file);
+        void Unwatch(const std::filesystem::path& file);
+
+        // Returns normalized paths of watched files changed since the previous call
+        [[nodiscard]] std::vector<std::filesystem::path> PollChanges();
+
+        [[nodiscard]] bool IsNative() const noexcept;
+        // Directories watched by the native backend, the polling one has none
+        [[nodiscard]] size_t GetNumWatchedDirectories() const noexcept;
+
+    private:
+        class Impl;
+        class PollingImpl;
+        class InotifyImpl;
+
+        std::unique_ptr<Impl> m_impl;
+    };
+
+} // namespace AT2
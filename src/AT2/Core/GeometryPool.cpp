@@ -0,0 +1,232 @@
+#include "GeometryPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "BufferMapperGuard.h"
+
+using namespace AT2;
+
+namespace
+{
+    void Upload(IBuffer& buffer, size_t offset, std::span<const std::byte> data)
+    {
+        BufferMapperGuard guard {buffer, offset, data.size(), BufferUsage::Write};
+        std::memcpy(guard.data(), data.data(), data.size());
+    }
+
+    // 8-bit indices are slow on most of hardware, so they are stored as 16-bit
+    std::vector<std::uint16_t> WidenIndices(std::span<const std::byte> data)
+    {
+        std::vector<std::uint16_t> result(data.size());
+        std::ranges::transform(data, result.begin(), [](std::byte index) { return std::to_integer<std::uint16_t>(index); });
+        return result;
+    }
+} // namespace
+
+GeometryPool::GeometryPool(IResourceFactory& resourceFactory, size_t verticesPerPage, size_t indicesPerPage) :
+    m_resourceFactory {resourceFactory},
+    m_verticesPerPage {verticesPerPage},
+    m_indicesPerPage {indicesPerPage}
+{
+}
+
+GeometryPool::Placement GeometryPool::Place(std::span<const VertexStream> streams, std::optional<IndexData> indices,
+                                            Primitives::Primitive type)
+{
+    if (streams.empty())
+        throw AT2Exception("GeometryPool: at least one vertex stream required");
+
+    Format format;
+
+    const size_t numVertices = streams.front().Data.size() / streams.front().BindingParams.Stride;
+    for (const auto& [attributeIndex, bindingParams, data] : streams)
+    {
+        if (bindingParams.Stride == 0 || data.size() != numVertices * bindingParams.Stride)
+            throw AT2Exception("GeometryPool: all vertex streams must have the same number of tightly packed elements");
+
+        format.Attributes.push_back({attributeIndex, bindingParams.Type, bindingParams.Count, bindingParams.IsNormalized, bindingParams.Stride});
+    }
+    std::ranges::sort(format.Attributes, {}, &AttributeFormat::AttributeIndex);
+
+    return Place(std::move(format), numVertices, indices, type, [streams](const Page& page, size_t firstVertex) {
+        for (const auto& [attributeIndex, bindingParams, data] : streams)
+            Upload(*page.VertexArray->GetVertexBuffer(attributeIndex), firstVertex * bindingParams.Stride, data);
+    });
+}
+
+GeometryPool::Placement GeometryPool::Place(const VertexPacker::PackedVertices& vertices, std::optional<IndexData> indices,
+                                            Primitives::Primitive type)
+{
+    if (vertices.Attributes.empty() || vertices.Stride == 0)
+        throw AT2Exception("GeometryPool: at least one vertex attribute required");
+
+    Format format {{}, std::nullopt, vertices.Stride};
+    for (const auto& [attributeIndex, bindingParams] : vertices.Attributes)
+        format.Attributes.push_back({attributeIndex, bindingParams.Type, bindingParams.Count, bindingParams.IsNormalized,
+                                     bindingParams.Stride, bindingParams.Offset});
+    std::ranges::sort(format.Attributes, {}, &AttributeFormat::AttributeIndex);
+
+    const auto bufferAttributeIndex = format.Attributes.front().AttributeIndex;
+    return Place(std::move(format), vertices.NumVertices, indices, type, [&vertices, bufferAttributeIndex](const Page& page, size_t firstVertex) {
+        Upload(*page.VertexArray->GetVertexBuffer(bufferAttributeIndex), firstVertex * vertices.Stride, vertices.Data);
+    });
+}
+
+GeometryPool::Placement GeometryPool::Place(Format format, size_t numVertices, std::optional<IndexData> indices, Primitives::Primitive type,
+                                            const std::function<void(const Page&, size_t)>& uploadVertices)
+{
+    std::vector<std::uint16_t> widenedIndices;
+    if (indices && indices->Type == BufferDataType::UByte)
+    {
+        widenedIndices = WidenIndices(indices->Data);
+        indices = IndexData {BufferDataType::UShort, std::as_bytes(std::span {widenedIndices})};
+    }
+
+    format.IndexType = indices ? std::optional {indices->Type} : std::nullopt;
+
+    const size_t indexSize = indices ? BufferDataTypes::GetSizeOf(indices->Type) : 0;
+    const size_t numIndices = indices ? indices->Data.size() / indexSize : 0;
+    if (numVertices == 0 || (indices && numIndices == 0))
+        throw AT2Exception("GeometryPool: empty geometry");
+
+    auto& formatPool = GetFormatPool(format);
+
+    Page* page = nullptr;
+    std::optional<RangeAllocator::Allocation> vertexAllocation, indexAllocation;
+    for (auto& candidate : formatPool.Pages)
+    {
+        vertexAllocation = candidate->Vertices.Allocate(numVertices);
+        if (!vertexAllocation)
+            continue;
+
+        if (indices)
+        {
+            indexAllocation = candidate->Indices->Allocate(numIndices);
+            if (!indexAllocation)
+            {
+                candidate->Vertices.Free(*vertexAllocation);
+                continue;
+            }
+        }
+
+        page = candidate.get();
+        break;
+    }
+
+    if (!page)
+    {
+        page = formatPool.Pages.emplace_back(CreatePage(format, numVertices, numIndices)).get();
+        vertexAllocation = page->Vertices.Allocate(numVertices);
+        if (indices)
+            indexAllocation = page->Indices->Allocate(numIndices);
+    }
+
+    uploadVertices(*page, vertexAllocation->Offset);
+
+    if (indices)
+        Upload(*page->VertexArray->GetIndexBuffer(), indexAllocation->Offset * indexSize, indices->Data);
+
+    // without index buffer the offset is just a first vertex
+    const auto chunk = indices
+        ? MeshChunk {type, static_cast<unsigned int>(indexAllocation->Offset), static_cast<unsigned int>(numIndices), static_cast<int>(vertexAllocation->Offset)}
+        : MeshChunk {type, static_cast<unsigned int>(vertexAllocation->Offset), static_cast<unsigned int>(numVertices), 0};
+
+    return {page->VertexArray, chunk, *vertexAllocation, indexAllocation};
+}
+
+void GeometryPool::Free(const Placement& placement)
+{
+    for (auto& formatPool : m_pools)
+    {
+        for (auto& page : formatPool.Pages)
+        {
+            if (page->VertexArray != placement.VertexArray)
+                continue;
+
+            page->Vertices.Free(placement.Vertices);
+            if (placement.Indices)
+                page->Indices->Free(*placement.Indices);
+            return;
+        }
+    }
+
+    throw AT2Exception("GeometryPool: placement doesn't belong to the pool");
+}
+
+GeometryPool::Statistics GeometryPool::GetStatistics() const
+{
+    Statistics statistics;
+    for (const auto& formatPool : m_pools)
+    {
+        size_t vertexSize = formatPool.VertexFormat.InterleavedStride;
+        if (vertexSize == 0)
+            for (const auto& attribute : formatPool.VertexFormat.Attributes)
+                vertexSize += attribute.ElementSize;
+        const size_t indexSize = formatPool.VertexFormat.IndexType ? BufferDataTypes::GetSizeOf(*formatPool.VertexFormat.IndexType) : 0;
+
+        for (const auto& page : formatPool.Pages)
+        {
+            ++statistics.NumVertexArrays;
+
+            statistics.AllocatedBytes += page->Vertices.GetCapacity() * vertexSize;
+            statistics.UsedBytes += (page->Vertices.GetCapacity() - page->Vertices.GetFreeSpace()) * vertexSize;
+            if (page->Indices)
+            {
+                statistics.AllocatedBytes += page->Indices->GetCapacity() * indexSize;
+                statistics.UsedBytes += (page->Indices->GetCapacity() - page->Indices->GetFreeSpace()) * indexSize;
+            }
+        }
+    }
+
+    return statistics;
+}
+
+std::unique_ptr<GeometryPool::Page> GeometryPool::CreatePage(const Format& format, size_t numVertices, size_t numIndices) const
+{
+    const size_t vertexCapacity = std::max(numVertices, m_verticesPerPage);
+    const size_t indexCapacity = std::max(numIndices, m_indicesPerPage);
+
+    auto vertexArray = m_resourceFactory.CreateVertexArray();
+
+    std::shared_ptr<IBuffer> interleavedBuffer;
+    if (format.InterleavedStride > 0)
+    {
+        interleavedBuffer = m_resourceFactory.CreateBuffer(VertexBufferType::ArrayBuffer);
+        interleavedBuffer->ReserveSpace(vertexCapacity * format.InterleavedStride);
+    }
+
+    for (const auto& attribute : format.Attributes)
+    {
+        auto buffer = interleavedBuffer;
+        if (!buffer)
+        {
+            buffer = m_resourceFactory.CreateBuffer(VertexBufferType::ArrayBuffer);
+            buffer->ReserveSpace(vertexCapacity * attribute.ElementSize);
+        }
+
+        BufferBindingParams bindingParams {attribute.Type, attribute.Count, attribute.ElementSize, attribute.Offset};
+        bindingParams.IsNormalized = attribute.IsNormalized;
+        vertexArray->SetAttributeBinding(attribute.AttributeIndex, std::move(buffer), bindingParams);
+    }
+
+    std::optional<RangeAllocator> indexAllocator;
+    if (format.IndexType)
+    {
+        auto buffer = m_resourceFactory.CreateBuffer(VertexBufferType::IndexBuffer);
+        buffer->ReserveSpace(indexCapacity * BufferDataTypes::GetSizeOf(*format.IndexType));
+        vertexArray->SetIndexBuffer(std::move(buffer), *format.IndexType);
+
+        indexAllocator.emplace(indexCapacity);
+    }
+
+    return std::make_unique<Page>(Page {std::move(vertexArray), RangeAllocator {vertexCapacity}, std::move(indexAllocator)});
+}
+
+GeometryPool::FormatPool& GeometryPool::GetFormatPool(const Format& format)
+{
+    if (const auto it = std::ranges::find(m_pools, format, &FormatPool::VertexFormat); it != m_pools.end())
+        return *it;
+
+    return m_pools.emplace_back(FormatPool {format, {}});
+}
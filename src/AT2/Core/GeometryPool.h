@@ -0,0 +1,110 @@
+#pragma once
+
+#include "AT2.h"
+#include "Mesh.h"
+#include "RangeAllocator.h"
+#include "VertexPacker.h"
+
+#include <functional>
+
+namespace AT2
+{
+    // Places geometry of many meshes into a few big buffers: there is one vertex array per vertex format and index type,
+    // meshes refer to their part of it by MeshChunk::BaseVertex and MeshChunk::StartElement. Interleaved vertices are
+    // stored in a single buffer per page, separate streams get a buffer per attribute.
+    class GeometryPool
+    {
+    public:
+        NON_COPYABLE_OR_MOVABLE(GeometryPool)
+
+        struct VertexStream
+        {
+            unsigned int AttributeIndex;
+            // Stride must be equal to the element size, Offset is ignored
+            BufferBindingParams BindingParams;
+            std::span<const std::byte> Data;
+        };
+
+        struct IndexData
+        {
+            BufferDataType Type;
+            std::span<const std::byte> Data;
+        };
+
+        struct Placement
+        {
+            std::shared_ptr<IVertexArray> VertexArray;
+            MeshChunk Chunk;
+
+            RangeAllocator::Allocation Vertices;
+            std::optional<RangeAllocator::Allocation> Indices;
+        };
+
+        struct Statistics
+        {
+            size_t NumVertexArrays = 0;
+            size_t AllocatedBytes = 0;
+            size_t UsedBytes = 0;
+        };
+
+    public:
+        explicit GeometryPool(IResourceFactory& resourceFactory, size_t verticesPerPage = 1 << 16, size_t indicesPerPage = 1 << 18);
+
+        Placement Place(std::span<const VertexStream> streams, std::optional<IndexData> indices,
+                        Primitives::Primitive type = Primitives::Triangles {});
+        Placement Place(const VertexPacker::PackedVertices& vertices, std::optional<IndexData> indices,
+                        Primitives::Primitive type = Primitives::Triangles {});
+        void Free(const Placement& placement);
+
+        [[nodiscard]] Statistics GetStatistics() const;
+
+    private:
+        struct AttributeFormat
+        {
+            unsigned int AttributeIndex;
+            BufferDataType Type;
+            unsigned char Count;
+            bool IsNormalized;
+            unsigned int ElementSize;
+            unsigned int Offset = 0; // within the interleaved vertex
+
+            friend bool operator==(const AttributeFormat&, const AttributeFormat&) = default;
+        };
+
+        struct Format
+        {
+            std::vector<AttributeFormat> Attributes;
+            std::optional<BufferDataType> IndexType;
+            unsigned int InterleavedStride = 0; // zero if every attribute has own buffer
+
+            friend bool operator==(const Format&, const Format&) = default;
+        };
+
+        struct Page
+        {
+            std::shared_ptr<IVertexArray> VertexArray;
+            RangeAllocator Vertices;
+            std::optional<RangeAllocator> Indices;
+        };
+
+        struct FormatPool
+        {
+            Format VertexFormat;
+            std::vector<std::unique_ptr<Page>> Pages;
+        };
+
+        // uploadVertices(page, firstVertex) fills the allocated vertices
+        Placement Place(Format format, size_t numVertices, std::optional<IndexData> indices, Primitives::Primitive type,
+                        const std::function<void(const Page&, size_t)>& uploadVertices);
+        std::unique_ptr<Page> CreatePage(const Format& format, size_t numVertices, size_t numIndices) const;
+        FormatPool& GetFormatPool(const Format& format);
+
+    private:
+        IResourceFactory& m_resourceFactory;
+        size_t m_verticesPerPage;
+        size_t m_indicesPerPage;
+
+        std::vector<FormatPool> m_pools;
+    };
+
+} // namespace AT2
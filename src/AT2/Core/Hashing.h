@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace AT2
+{
+    // 64-bit FNV-1a, simple and stable between runs and platforms, so suitable for on-disk keys
+    class Fnv1a
+    {
+    public:
+        void Update(std::span<const std::byte> data) noexcept
+        {
+            for (const auto byte : data)
+            {
+                m_hash ^= static_cast<std::uint64_t>(byte);
+                m_hash *= 0x100000001b3ull;
+            }
+        }
+
+        void Update(std::string_view str) noexcept { Update(std::as_bytes(std::span {str})); }
+
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        void UpdateValue(const T& value) noexcept
+        {
+            Update(std::as_bytes(std::span {&value, 1}));
+        }
+
+        [[nodiscard]] std::uint64_t Get() const noexcept { return m_hash; }
+
+    private:
+        std::uint64_t m_hash = 0xcbf29ce484222325ull;
+    };
+
+} // namespace AT2
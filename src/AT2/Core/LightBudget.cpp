@@ -0,0 +1,198 @@
+#include "LightBudget.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+using namespace AT2;
+
+namespace
+{
+    constexpr auto NotMerged = std::numeric_limits<std::uint32_t>::max();
+
+    // World-space planes of the view frustum, normals look inside
+    struct Frustum
+    {
+        explicit Frustum(const glm::mat4& viewProjection) noexcept
+        {
+            const auto row = [&](int i) {
+                return glm::vec4 {viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+            };
+
+            Planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(3) + row(2), row(3) - row(2)};
+            for (auto& plane : Planes)
+                plane = plane / glm::length(glm::vec3 {plane});
+        }
+
+        [[nodiscard]] bool Intersects(const glm::vec3& center, float radius) const noexcept
+        {
+            return std::ranges::all_of(Planes, [&](const glm::vec4& plane) { return glm::dot(glm::vec3 {plane}, center) + plane.w >= -radius; });
+        }
+
+        std::array<glm::vec4, 6> Planes;
+    };
+
+    float GetScreenCoverage(const LightBudget::Light& light, const glm::mat4& view, const glm::mat4& projection, const Frustum& frustum) noexcept
+    {
+        if (!(light.Radius > 0.0f) || !frustum.Intersects(light.Position, light.Radius))
+            return 0.0f;
+
+        // sphere around the camera covers the whole screen, otherwise it's projection is approximated by the ellipse of
+        // the radius at the center depth
+        const bool isPerspective = projection[2][3] != 0.0f;
+        const float depth = isPerspective ? -glm::vec3 {view * glm::vec4 {light.Position, 1.0f}}.z : 1.0f;
+        if (isPerspective && depth <= light.Radius)
+            return 1.0f;
+
+        // NDC square has area of 4
+        const float width = projection[0][0] * light.Radius / depth, height = projection[1][1] * light.Radius / depth;
+        return std::min(std::numbers::pi_v<float> * width * height / 4.0f, 1.0f);
+    }
+
+    float GetImportance(const LightBudget::Light& light, const glm::mat4& view, const glm::mat4& projection, const Frustum& frustum) noexcept
+    {
+        const float luminance = GetLuminance(light.Intensity);
+        return luminance > 0.0f ? GetScreenCoverage(light, view, projection, frustum) * luminance : 0.0f;
+    }
+} // namespace
+
+float AT2::GetLightInfluenceRadius(const glm::vec3& intensity, float luminanceCutoff)
+{
+    if (!(luminanceCutoff > 0.0f))
+        throw AT2Exception("GetLightInfluenceRadius: luminance cutoff must be positive");
+
+    const float luminance = GetLuminance(intensity);
+    return luminance > luminanceCutoff ? std::sqrt(luminance / luminanceCutoff - 1.0f) : 0.0f;
+}
+
+float LightBudget::GetScreenCoverage(const Light& light, const glm::mat4& view, const glm::mat4& projection) noexcept
+{
+    return ::GetScreenCoverage(light, view, projection, Frustum {projection * view});
+}
+
+float LightBudget::GetImportance(const Light& light, const glm::mat4& view, const glm::mat4& projection) noexcept
+{
+    return ::GetImportance(light, view, projection, Frustum {projection * view});
+}
+
+LightBudget::Statistics LightBudget::Select(std::span<const Light> lights, const glm::mat4& view, const glm::mat4& projection)
+{
+    Statistics statistics;
+    statistics.NumLights = lights.size();
+
+    const Frustum frustum {projection * view};
+    m_importance.resize(lights.size());
+    m_ranking.clear();
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        m_importance[i] = ::GetImportance(lights[i], view, projection, frustum);
+        if (m_importance[i] > 0.0f)
+            m_ranking.push_back(static_cast<std::uint32_t>(i));
+    }
+    statistics.NumCulled = lights.size() - m_ranking.size();
+
+    // the most important lights are at the beginning, ties are broken by the index to keep the selection stable
+    const size_t numKept = std::min(m_maxLights, m_ranking.size());
+    if (numKept < m_ranking.size())
+        std::ranges::nth_element(m_ranking, m_ranking.begin() + static_cast<std::ptrdiff_t>(numKept), [&](std::uint32_t lhs, std::uint32_t rhs) {
+            return m_importance[lhs] > m_importance[rhs] || (m_importance[lhs] == m_importance[rhs] && lhs < rhs);
+        });
+
+    const auto kept = std::span {m_ranking}.first(numKept);
+    const auto overBudget = std::span {m_ranking}.subspan(numKept);
+    std::ranges::sort(kept);
+
+    m_selectedLights.resize(kept.size());
+    std::ranges::transform(kept, m_selectedLights.begin(), [&](std::uint32_t index) { return lights[index]; });
+    statistics.NumSelected = m_selectedLights.size();
+
+    if (overBudget.empty())
+        return statistics;
+
+    if (kept.empty())
+    {
+        statistics.NumDropped = overBudget.size();
+        return statistics;
+    }
+
+    // kept lights sorted by x, so only the ones whose spheres could contain the light are checked
+    m_keptByX.resize(kept.size());
+    for (std::uint32_t i = 0; i < m_keptByX.size(); ++i)
+        m_keptByX[i] = i;
+    std::ranges::sort(m_keptByX, {}, [&](std::uint32_t i) { return m_selectedLights[i].Position.x; });
+
+    const float maxRadius = std::ranges::max(m_selectedLights, {}, &Light::Radius).Radius;
+
+    m_mergeTargets.assign(overBudget.size(), NotMerged);
+    for (size_t i = 0; i < overBudget.size(); ++i)
+    {
+        const auto& position = lights[overBudget[i]].Position;
+        const auto getX = [&](std::uint32_t keptIndex) { return m_selectedLights[keptIndex].Position.x; };
+        const auto first = std::ranges::lower_bound(m_keptByX, position.x - maxRadius, {}, getX);
+        const auto last = std::ranges::upper_bound(m_keptByX, position.x + maxRadius, {}, getX);
+
+        float nearestDistance = std::numeric_limits<float>::max();
+        for (auto it = first; it != last; ++it)
+        {
+            const auto& target = m_selectedLights[*it];
+            const auto offset = target.Position - position;
+            const float distance = glm::dot(offset, offset);
+            if (distance <= target.Radius * target.Radius && distance < nearestDistance)
+            {
+                nearestDistance = distance;
+                m_mergeTargets[i] = *it;
+            }
+        }
+    }
+
+    // luminance-weighted centers of the merged lights
+    m_weightedCenters.resize(m_selectedLights.size());
+    for (size_t i = 0; i < m_selectedLights.size(); ++i)
+    {
+        const float luminance = GetLuminance(m_selectedLights[i].Intensity);
+        m_weightedCenters[i] = {m_selectedLights[i].Position * luminance, luminance};
+    }
+
+    m_isMerged.assign(m_selectedLights.size(), false);
+    for (size_t i = 0; i < overBudget.size(); ++i)
+    {
+        const auto target = m_mergeTargets[i];
+        if (target == NotMerged)
+            continue;
+
+        const auto& light = lights[overBudget[i]];
+        const float luminance = GetLuminance(light.Intensity);
+        m_weightedCenters[target] = m_weightedCenters[target] + glm::vec4 {light.Position * luminance, luminance};
+        m_isMerged[target] = true;
+        ++statistics.NumMerged;
+    }
+    statistics.NumDropped = overBudget.size() - statistics.NumMerged;
+
+    // spheres of the merged lights bound the spheres of all of their parts
+    for (size_t i = 0; i < m_selectedLights.size(); ++i)
+    {
+        if (!m_isMerged[i])
+            continue;
+
+        auto& light = m_selectedLights[i];
+        const auto center = glm::vec3 {m_weightedCenters[i]} / m_weightedCenters[i].w;
+        light.Radius += glm::length(light.Position - center);
+        light.Position = center;
+    }
+
+    for (size_t i = 0; i < overBudget.size(); ++i)
+    {
+        const auto target = m_mergeTargets[i];
+        if (target == NotMerged)
+            continue;
+
+        const auto& source = lights[overBudget[i]];
+        auto& light = m_selectedLights[target];
+        light.Intensity += source.Intensity;
+        light.Radius = std::max(light.Radius, glm::length(source.Position - light.Position) + source.Radius);
+    }
+
+    return statistics;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AT2.h"
+
+namespace AT2
+{
+    // Luminance the light contributions are cut off at by default, in units of the lighting pass output
+    constexpr float DefaultLightLuminanceCutoff = 0.05f;
+
+    // Relative luminance of the linear color, Rec. 709 primaries
+    [[nodiscard]] inline float GetLuminance(const glm::vec3& color) noexcept
+    {
+        return glm::dot(color, glm::vec3 {0.2126f, 0.7152f, 0.0722f});
+    }
+
+    // Distance the light falls off to the cutoff luminance at. It matches the lightAttenuation of pbr.glsl, which
+    // is intensity / (distance^2 + 1) windowed to zero at the radius. Zero for lights not brighter than the cutoff.
+    [[nodiscard]] float GetLightInfluenceRadius(const glm::vec3& intensity, float luminanceCutoff = DefaultLightLuminanceCutoff);
+
+    // Keeps the most important sphere lights of the frame within the budget. Importance is the screen coverage of the
+    // light's influence sphere times it's luminance, lights out of the view frustum are culled.
+    // A light over the budget is merged to the nearest kept light whose sphere contains it: the merged light is placed
+    // at the luminance-weighted center, gets the sum of the intensities and a sphere bounding all of the merged ones.
+    // Other lights over the budget are dropped.
+    class LightBudget
+    {
+    public:
+        static constexpr size_t DefaultMaxLights = 1024;
+
+        struct Light
+        {
+            glm::vec3 Position {0.0f}; // world space
+            glm::vec3 Intensity {0.0f};
+            float Radius = 0.0f;
+        };
+
+        struct Statistics
+        {
+            size_t NumLights = 0;
+            size_t NumCulled = 0; // out of the frustum or black
+            size_t NumMerged = 0;
+            size_t NumDropped = 0;
+            size_t NumSelected = 0;
+        };
+
+        explicit LightBudget(size_t maxLights = DefaultMaxLights) noexcept : m_maxLights {maxLights} {}
+
+        void SetMaxLights(size_t maxLights) noexcept { m_maxLights = maxLights; }
+        [[nodiscard]] size_t GetMaxLights() const noexcept { return m_maxLights; }
+
+        // Selected lights keep the order of the source ones
+        Statistics Select(std::span<const Light> lights, const glm::mat4& view, const glm::mat4& projection);
+        [[nodiscard]] std::span<const Light> GetSelectedLights() const noexcept { return m_selectedLights; }
+        // Indices of the source lights the selected ones were kept from
+        [[nodiscard]] std::span<const std::uint32_t> GetSelectedIndices() const noexcept
+        {
+            return std::span {m_ranking}.first(m_selectedLights.size());
+        }
+
+        // Fraction of the screen covered by the light's influence sphere, zero for lights out of the frustum
+        [[nodiscard]] static float GetScreenCoverage(const Light& light, const glm::mat4& view, const glm::mat4& projection) noexcept;
+        // Zero for lights out of the frustum
+        [[nodiscard]] static float GetImportance(const Light& light, const glm::mat4& view, const glm::mat4& projection) noexcept;
+
+    private:
+        size_t m_maxLights;
+
+        std::vector<float> m_importance;
+        std::vector<std::uint32_t> m_ranking; // kept lights are at the beginning, by index
+        std::vector<std::uint32_t> m_keptByX;
+        std::vector<std::uint32_t> m_mergeTargets; // by light over the budget
+        std::vector<glm::vec4> m_weightedCenters;  // by selected light, w is the sum of weights
+        std::vector<bool> m_isMerged;
+        std::vector<Light> m_selectedLights;
+    };
+
+} // namespace AT2
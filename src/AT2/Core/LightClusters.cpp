@@ -0,0 +1,227 @@
+#include "LightClusters.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+using namespace AT2;
+
+namespace
+{
+    bool Intersects(const glm::vec3& center, float radius, const glm::vec3& boxMin, const glm::vec3& boxMax) noexcept
+    {
+        const auto offset = center - glm::clamp(center, boxMin, boxMax);
+        return glm::dot(offset, offset) <= radius * radius;
+    }
+} // namespace
+
+LightClusters::LightClusters(glm::uvec3 gridSize) : m_gridSize {gridSize}
+{
+    if (gridSize.x == 0 || gridSize.y == 0 || gridSize.z == 0)
+        throw AT2Exception("LightClusters: grid size must not be zero");
+
+    m_clusters.resize(static_cast<size_t>(gridSize.x) * gridSize.y * gridSize.z);
+    m_sliceEntries.resize(gridSize.z);
+}
+
+void LightClusters::SetView(const glm::mat4& view, const glm::mat4& projection)
+{
+    m_view = view;
+    if (projection == m_projection)
+        return;
+
+    if (projection[2][3] == 0.0f)
+        throw AT2Exception("LightClusters: projection must be perspective");
+
+    // OpenGL depth range of glm::perspective and similar matrices
+    const float near = projection[3][2] / (projection[2][2] - 1.0f);
+    const float far = projection[3][2] / (projection[2][2] + 1.0f);
+    if (!(near > 0.0f && far > near && std::isfinite(far)))
+        throw AT2Exception("LightClusters: projection must have finite positive depth range");
+
+    m_projection = projection;
+    m_near = near;
+    m_far = far;
+    m_sliceScale = static_cast<float>(m_gridSize.z) / std::log(far / near);
+
+    BuildBoxes();
+}
+
+void LightClusters::BuildBoxes()
+{
+    const auto inverseProjection = glm::inverse(m_projection);
+
+    // directions through the tile corners, scaled to the unit view depth
+    const auto getRay = [&](unsigned int x, unsigned int y) {
+        const glm::vec2 ndc = glm::vec2 {x, y} / glm::vec2 {m_gridSize} * 2.0f - 1.0f;
+        const auto nearPoint = inverseProjection * glm::vec4 {ndc, -1.0f, 1.0f};
+        const auto ray = glm::vec3 {nearPoint} / nearPoint.w;
+        return ray / -ray.z;
+    };
+
+    m_boxes.resize(m_clusters.size());
+    for (unsigned int y = 0; y < m_gridSize.y; ++y)
+        for (unsigned int x = 0; x < m_gridSize.x; ++x)
+        {
+            const std::array rays {getRay(x, y), getRay(x + 1, y), getRay(x, y + 1), getRay(x + 1, y + 1)};
+            for (unsigned int z = 0; z < m_gridSize.z; ++z)
+            {
+                const float sliceNear = m_near * std::exp(static_cast<float>(z) / m_sliceScale);
+                const float sliceFar = m_near * std::exp(static_cast<float>(z + 1) / m_sliceScale);
+
+                Box box {glm::vec3 {std::numeric_limits<float>::max()}, glm::vec3 {std::numeric_limits<float>::lowest()}};
+                for (const auto& ray : rays)
+                    for (const auto depth : {sliceNear, sliceFar})
+                    {
+                        box.Min = glm::min(box.Min, ray * depth);
+                        box.Max = glm::max(box.Max, ray * depth);
+                    }
+
+                m_boxes[GetClusterIndex({x, y, z})] = box;
+            }
+        }
+}
+
+unsigned int LightClusters::GetSlice(float depth) const noexcept
+{
+    if (depth <= m_near)
+        return 0;
+
+    const auto slice = std::floor(std::log(depth / m_near) * m_sliceScale);
+    return std::min(static_cast<unsigned int>(slice), m_gridSize.z - 1);
+}
+
+LightClusters::LightRange LightClusters::GetRange(const Light& viewLight) const noexcept
+{
+    const float depth = -viewLight.Position.z;
+    if (depth + viewLight.Radius < m_near || depth - viewLight.Radius > m_far)
+        return {};
+
+    LightRange range {glm::uvec3 {0, 0, GetSlice(std::max(depth - viewLight.Radius, m_near))},
+                      glm::uvec3 {m_gridSize.x, m_gridSize.y, GetSlice(std::min(depth + viewLight.Radius, m_far)) + 1}};
+
+    // sphere crossing the near plane could cover any tile, otherwise tiles are limited by the projection of it's box
+    if (depth - viewLight.Radius <= m_near)
+        return range;
+
+    glm::vec2 screenMin {std::numeric_limits<float>::max()}, screenMax {std::numeric_limits<float>::lowest()};
+    for (unsigned int corner = 0; corner < 8; ++corner)
+    {
+        const glm::vec3 offset {corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f};
+        const auto clip = m_projection * glm::vec4 {viewLight.Position + offset * viewLight.Radius, 1.0f};
+        const auto ndc = glm::vec2 {clip} / clip.w;
+        screenMin = glm::min(screenMin, ndc);
+        screenMax = glm::max(screenMax, ndc);
+    }
+
+    const auto gridSize = glm::vec2 {m_gridSize};
+    const auto tilesBegin = glm::clamp(glm::floor((screenMin * 0.5f + 0.5f) * gridSize), glm::vec2 {0.0f}, gridSize);
+    const auto tilesEnd = glm::clamp(glm::ceil((screenMax * 0.5f + 0.5f) * gridSize), glm::vec2 {0.0f}, gridSize);
+    if (tilesBegin.x >= tilesEnd.x || tilesBegin.y >= tilesEnd.y)
+        return {};
+
+    range.Begin = {glm::uvec2 {tilesBegin}, range.Begin.z};
+    range.End = {glm::uvec2 {tilesEnd}, range.End.z};
+    return range;
+}
+
+LightClusters::Statistics LightClusters::Assign(std::span<const Light> lights, ThreadPool* threadPool)
+{
+    if (m_boxes.empty())
+        throw AT2Exception("LightClusters: SetView must be called before the assignment");
+
+    m_viewLights.resize(lights.size());
+    m_lightRanges.resize(lights.size());
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        m_viewLights[i] = {glm::vec3 {m_view * glm::vec4 {lights[i].Position, 1.0f}}, lights[i].Radius};
+        m_lightRanges[i] = GetRange(m_viewLights[i]);
+    }
+
+    // every slice collects it's own pairs of clusters and lights, by ascending light index
+    const auto assignSlices = [&](size_t begin, size_t end) {
+        for (auto z = static_cast<unsigned int>(begin); z < end; ++z)
+        {
+            auto& entries = m_sliceEntries[z];
+            entries.clear();
+
+            for (size_t i = 0; i < m_viewLights.size(); ++i)
+            {
+                const auto& [rangeBegin, rangeEnd] = m_lightRanges[i];
+                if (z < rangeBegin.z || z >= rangeEnd.z)
+                    continue;
+
+                for (auto y = rangeBegin.y; y < rangeEnd.y; ++y)
+                    for (auto x = rangeBegin.x; x < rangeEnd.x; ++x)
+                    {
+                        const auto clusterIndex = GetClusterIndex({x, y, z});
+                        const auto& box = m_boxes[clusterIndex];
+                        if (Intersects(m_viewLights[i].Position, m_viewLights[i].Radius, box.Min, box.Max))
+                            entries.push_back({static_cast<std::uint32_t>(clusterIndex), static_cast<std::uint32_t>(i)});
+                    }
+            }
+        }
+    };
+
+    if (threadPool)
+        threadPool->ParallelFor(m_gridSize.z, 1, assignSlices);
+    else
+        assignSlices(0, m_gridSize.z);
+
+    // counting sort of the pairs by cluster keeps lights of every cluster ascending
+    std::ranges::fill(m_clusters, Cluster {});
+    for (const auto& entries : m_sliceEntries)
+        for (const auto& entry : entries)
+            ++m_clusters[entry.Cluster].NumLights;
+
+    Statistics statistics;
+    statistics.NumLights = lights.size();
+
+    std::uint32_t numIndices = 0;
+    for (auto& cluster : m_clusters)
+    {
+        cluster.FirstLight = numIndices;
+        numIndices += cluster.NumLights;
+
+        statistics.NumOccupiedClusters += cluster.NumLights > 0;
+        statistics.MaxLightsPerCluster = std::max<size_t>(statistics.MaxLightsPerCluster, cluster.NumLights);
+        cluster.NumLights = 0;
+    }
+    statistics.NumIndices = numIndices;
+
+    std::vector<bool> isVisible(lights.size());
+    m_lightIndices.resize(numIndices);
+    for (const auto& entries : m_sliceEntries)
+        for (const auto& [clusterIndex, lightIndex] : entries)
+        {
+            auto& cluster = m_clusters[clusterIndex];
+            m_lightIndices[cluster.FirstLight + cluster.NumLights++] = lightIndex;
+            isVisible[lightIndex] = true;
+        }
+
+    statistics.NumVisibleLights = static_cast<size_t>(std::ranges::count(isVisible, true));
+    return statistics;
+}
+
+std::optional<glm::uvec3> LightClusters::FindCluster(const glm::vec3& viewPosition) const
+{
+    const float depth = -viewPosition.z;
+    if (depth < m_near || depth > m_far)
+        return std::nullopt;
+
+    const auto clip = m_projection * glm::vec4 {viewPosition, 1.0f};
+    const auto ndc = glm::vec2 {clip} / clip.w;
+    if (std::abs(ndc.x) > 1.0f || std::abs(ndc.y) > 1.0f)
+        return std::nullopt;
+
+    const auto tile = glm::min(glm::uvec2 {(ndc * 0.5f + 0.5f) * glm::vec2 {m_gridSize}}, glm::uvec2 {m_gridSize} - 1u);
+    return glm::uvec3 {tile, GetSlice(depth)};
+}
+
+std::span<const std::uint32_t> LightClusters::GetLights(const glm::uvec3& cluster) const
+{
+    const auto& [firstLight, numLights] = m_clusters.at(GetClusterIndex(cluster));
+    return std::span {m_lightIndices}.subspan(firstLight, numLights);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "AT2.h"
+
+#include <optional>
+
+namespace AT2
+{
+    class ThreadPool;
+
+    // Assigns point lights to clusters of the view frustum. The screen is split into tiles and the depth range into slices
+    // which get exponentially thicker with the distance, every cluster gets the list of lights whose spheres touch it's
+    // view-space box. Shading finds the cluster of the fragment and loops over it's lights only.
+    // Lists of all clusters are packed to one array of light indices, a cluster refers to it's range of the array. Indices
+    // within a list are ascending. Slices are assigned in parallel when a thread pool is given.
+    class LightClusters
+    {
+    public:
+        static constexpr unsigned int DefaultNumTilesX = 16;
+        static constexpr unsigned int DefaultNumTilesY = 9;
+        static constexpr unsigned int DefaultNumSlices = 24;
+
+        struct Light
+        {
+            glm::vec3 Position {0.0f}; // world space
+            float Radius = 0.0f;
+        };
+
+        struct Cluster
+        {
+            std::uint32_t FirstLight = 0; // in the light indices
+            std::uint32_t NumLights = 0;
+        };
+
+        struct Statistics
+        {
+            size_t NumLights = 0;
+            size_t NumVisibleLights = 0; // touching at least one cluster
+            size_t NumIndices = 0;
+            size_t NumOccupiedClusters = 0;
+            size_t MaxLightsPerCluster = 0;
+        };
+
+        explicit LightClusters(glm::uvec3 gridSize = {DefaultNumTilesX, DefaultNumTilesY, DefaultNumSlices});
+
+        // Only perspective projections with a finite far plane are supported. Boxes of the clusters are rebuilt when the
+        // projection changes.
+        void SetView(const glm::mat4& view, const glm::mat4& projection);
+
+        Statistics Assign(std::span<const Light> lights, ThreadPool* threadPool = nullptr);
+
+        [[nodiscard]] glm::uvec3 GetGridSize() const noexcept { return m_gridSize; }
+        [[nodiscard]] size_t GetNumClusters() const noexcept { return m_clusters.size(); }
+        [[nodiscard]] size_t GetClusterIndex(const glm::uvec3& cluster) const noexcept
+        {
+            return (static_cast<size_t>(cluster.z) * m_gridSize.y + cluster.y) * m_gridSize.x + cluster.x;
+        }
+
+        // Slice of the view-space distance is floor(log(depth / near) * sliceScale), shaders repeat it with these values
+        [[nodiscard]] float GetNear() const noexcept { return m_near; }
+        [[nodiscard]] float GetSliceScale() const noexcept { return m_sliceScale; }
+
+        // Cluster of the view-space point, empty if the point is out of the frustum
+        [[nodiscard]] std::optional<glm::uvec3> FindCluster(const glm::vec3& viewPosition) const;
+
+        [[nodiscard]] std::span<const Cluster> GetClusters() const noexcept { return m_clusters; }
+        [[nodiscard]] std::span<const std::uint32_t> GetLightIndices() const noexcept { return m_lightIndices; }
+        [[nodiscard]] std::span<const std::uint32_t> GetLights(const glm::uvec3& cluster) const;
+
+        // Light positions transformed by the last assignment
+        [[nodiscard]] std::span<const Light> GetViewSpaceLights() const noexcept { return m_viewLights; }
+
+    private:
+        struct Box
+        {
+            glm::vec3 Min, Max;
+        };
+
+        // Clusters a light may touch, end is exclusive. Empty for lights out of the frustum.
+        struct LightRange
+        {
+            glm::uvec3 Begin {0u}, End {0u};
+        };
+
+        struct Entry
+        {
+            std::uint32_t Cluster;
+            std::uint32_t Light;
+        };
+
+        void BuildBoxes();
+        [[nodiscard]] unsigned int GetSlice(float depth) const noexcept;
+        [[nodiscard]] LightRange GetRange(const Light& viewLight) const noexcept;
+
+    private:
+        glm::uvec3 m_gridSize;
+        glm::mat4 m_view {1.0f};
+        glm::mat4 m_projection {0.0f};
+        float m_near = 0.0f, m_far = 0.0f, m_sliceScale = 0.0f;
+
+        std::vector<Box> m_boxes; // view space, by cluster index
+
+        std::vector<Light> m_viewLights;
+        std::vector<LightRange> m_lightRanges;
+        std::vector<std::vector<Entry>> m_sliceEntries;
+
+        std::vector<Cluster> m_clusters;
+        std::vector<std::uint32_t> m_lightIndices;
+    };
+
+} // namespace AT2
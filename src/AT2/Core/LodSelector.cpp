@@ -0,0 +1,55 @@
+#include "LodSelector.h"
+
+#include <algorithm>
+
+using namespace AT2;
+
+namespace
+{
+    // avoids division by zero when the camera is at the origin of the mesh
+    constexpr float MinDistance = 1e-3f;
+}
+
+LodSelector::LodSelector(const glm::mat4& projection, float viewportHeight, float threshold, float hysteresis) noexcept
+    : m_pixelsPerUnit {projection[1][1] * viewportHeight * 0.5f}
+    , m_isPerspective {projection[2][3] != 0.0f}
+    , m_threshold {threshold}
+    , m_hysteresis {hysteresis}
+{
+}
+
+float LodSelector::GetProjectedSize(float length, float distance) const noexcept
+{
+    const auto size = length * m_pixelsPerUnit;
+    return m_isPerspective ? size / std::max(distance, MinDistance) : size;
+}
+
+unsigned int LodSelector::Select(const SubMesh& subMesh, const glm::mat4& modelView, unsigned int currentLod) const noexcept
+{
+    if (subMesh.Lods.empty() || m_threshold <= 0.0f)
+        return 0;
+
+    const auto scale = std::max({glm::length(glm::vec3 {modelView[0]}), glm::length(glm::vec3 {modelView[1]}),
+                                 glm::length(glm::vec3 {modelView[2]})});
+    const auto distance = glm::length(glm::vec3 {modelView[3]});
+    const auto getProjectedError = [&](unsigned int lod) {
+        return lod == 0 ? 0.0f : GetProjectedSize(subMesh.Lods[lod - 1].Error * scale, distance);
+    };
+
+    const auto numLods = static_cast<unsigned int>(subMesh.GetNumLods());
+    auto lod = std::min(currentLod, numLods - 1);
+
+    // current level became too coarse, the finest level which fits the threshold is taken
+    if (getProjectedError(lod) > m_threshold * (1.0f + m_hysteresis))
+    {
+        while (lod > 0 && getProjectedError(lod) > m_threshold)
+            --lod;
+
+        return lod;
+    }
+
+    while (lod + 1 < numLods && getProjectedError(lod + 1) <= m_threshold * (1.0f - m_hysteresis))
+        ++lod;
+
+    return lod;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Mesh.h"
+
+namespace AT2
+{
+    // Chooses levels of detail of submeshes by the projected size of their simplification error. A coarser level is taken
+    // when it's error is below threshold * (1 - hysteresis) pixels, the current one is kept until it's error exceeds
+    // threshold * (1 + hysteresis), so levels don't flip back and forth near the switching distance.
+    class LodSelector
+    {
+    public:
+        static constexpr float DefaultThreshold = 1.0f;
+        static constexpr float DefaultHysteresis = 0.25f;
+
+        // Zero threshold always selects the full detail
+        LodSelector(const glm::mat4& projection, float viewportHeight, float threshold = DefaultThreshold,
+                    float hysteresis = DefaultHysteresis) noexcept;
+
+        // Size in pixels of the length seen at the given view-space distance
+        [[nodiscard]] float GetProjectedSize(float length, float distance) const noexcept;
+
+        // modelView transforms the submesh to the view space, the distance is measured to it's origin. currentLod is the
+        // level selected the previous time.
+        [[nodiscard]] unsigned int Select(const SubMesh& subMesh, const glm::mat4& modelView, unsigned int currentLod) const noexcept;
+
+    private:
+        float m_pixelsPerUnit;
+        bool m_isPerspective;
+        float m_threshold;
+        float m_hysteresis;
+    };
+
+} // namespace AT2
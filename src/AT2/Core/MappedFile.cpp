@@ -0,0 +1,89 @@
+#include "MappedFile.h"
+
+#include <AT2_exceptions.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace AT2;
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path) : m_path {path}
+{
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw AT2IOException("can't open file '" + path.string() + "'");
+
+    LARGE_INTEGER size {};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        throw AT2IOException("can't get size of file '" + path.string() + "'");
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+    // empty files can't be mapped
+    if (m_size > 0)
+    {
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping)
+            m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    // mapping holds it's own reference to the file
+    CloseHandle(file);
+
+    if (m_size > 0 && !m_data)
+    {
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        throw AT2IOException("can't map file '" + path.string() + "'");
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path) : m_path {path}
+{
+    const int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+        throw AT2IOException("can't open file '" + path.string() + "'");
+
+    struct stat fileStatus {};
+    if (fstat(descriptor, &fileStatus) != 0)
+    {
+        close(descriptor);
+        throw AT2IOException("can't get size of file '" + path.string() + "'");
+    }
+
+    m_size = static_cast<size_t>(fileStatus.st_size);
+    // empty files can't be mapped
+    void* data = m_size > 0 ? mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0) : nullptr;
+    // mapping holds it's own reference to the file
+    close(descriptor);
+
+    if (data == MAP_FAILED)
+        throw AT2IOException("can't map file '" + path.string() + "'");
+
+    m_data = static_cast<const std::byte*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        munmap(const_cast<std::byte*>(m_data), m_size);
+}
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace AT2
+{
+    // Read-only view of the whole file contents. Uses mmap on POSIX systems and file mappings on Windows, so pages are
+    // loaded on demand and shared with the OS file cache instead of being copied into the process heap.
+    class MappedFile
+    {
+    public:
+        // Throws AT2IOException if the file can't be opened or mapped
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] std::span<const std::byte> GetData() const noexcept { return {m_data, m_size}; }
+        [[nodiscard]] const std::filesystem::path& GetPath() const noexcept { return m_path; }
+
+    private:
+        std::filesystem::path m_path;
+        const std::byte* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_mapping = nullptr;
+#endif
+    };
+
+} // namespace AT2
@@ -5,6 +5,7 @@
 
 namespace AT2
 {
+    class MeshletSet;
 
     struct MeshChunk
     {
@@ -16,6 +17,13 @@ namespace AT2
         int BaseVertex = 0;
     };
 
+    // Coarser version of the submesh drawn by other ranges of the same vertex and index buffers
+    struct SubMeshLod
+    {
+        float Error = 0.0f; // object-space distance from the full detail surface
+        std::vector<MeshChunk> Primitives;
+    };
+
     struct SubMesh
     {
         SubMesh() = default;
@@ -26,9 +34,18 @@ namespace AT2
         {
         }
 
+        // Level 0 is the full detail
+        [[nodiscard]] const std::vector<MeshChunk>& GetPrimitives(size_t lod) const
+        {
+            return lod == 0 ? Primitives : Lods.at(lod - 1).Primitives;
+        }
+        [[nodiscard]] size_t GetNumLods() const noexcept { return Lods.size() + 1; }
+
         unsigned int MaterialIndex = 0;
         std::string Name;
         std::vector<MeshChunk> Primitives;
+        std::vector<SubMeshLod> Lods; // by increasing error, see LodSelector
+        std::shared_ptr<const MeshletSet> Meshlets; // clusters of the full detail primitives if they were built, see ClusterCuller
     };
 
     struct Mesh
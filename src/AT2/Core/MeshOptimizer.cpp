@@ -0,0 +1,344 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+using namespace AT2;
+
+namespace
+{
+    // Forsyth's scoring parameters, see "Linear-Speed Vertex Cache Optimisation"
+    constexpr size_t ScoringCacheSize = 32;
+    constexpr float CacheDecayPower = 1.5f;
+    constexpr float LastTriangleScore = 0.75f;
+    constexpr float ValenceBoostScale = 2.0f;
+    constexpr float ValenceBoostPower = 0.5f;
+
+    // soft clusters smaller than that break the cache too often
+    constexpr size_t MinClusterSize = 8;
+
+    void ValidateIndices(std::span<const uint32_t> indices, size_t numVertices)
+    {
+        if (indices.size() % 3 != 0)
+            throw AT2Exception("MeshOptimizer: indices must form a triangle list");
+
+        if (std::ranges::any_of(indices, [numVertices](uint32_t index) { return index >= numVertices; }))
+            throw AT2Exception("MeshOptimizer: index is out of vertices range");
+    }
+
+    float GetVertexScore(int cachePosition, uint32_t remainingTriangles)
+    {
+        // vertex will not be used anymore
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            // vertices of the last triangle have fixed score, so the next triangle isn't forced to share an edge
+            if (cachePosition < 3)
+                score = LastTriangleScore;
+            else
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (ScoringCacheSize - 3), CacheDecayPower);
+        }
+
+        // vertices with few triangles left are finished first
+        return score + ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+    }
+
+    // FIFO cache simulation, returns number of misses for each triangle
+    std::vector<uint8_t> SimulateCache(std::span<const uint32_t> indices, size_t numVertices, unsigned int cacheSize)
+    {
+        std::vector<uint8_t> result(indices.size() / 3);
+
+        // vertex is in cache while less than cacheSize vertices were added after it
+        std::vector<size_t> timestamps(numVertices, 0);
+        size_t time = cacheSize + 1;
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            if (time - timestamps[indices[i]] > cacheSize)
+            {
+                timestamps[indices[i]] = time++;
+                ++result[i / 3];
+            }
+        }
+
+        return result;
+    }
+} // namespace
+
+MeshOptimizer::Statistics MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices, size_t numVertices, unsigned int cacheSize)
+{
+    ValidateIndices(indices, numVertices);
+
+    Statistics result;
+    result.NumTriangles = indices.size() / 3;
+
+    const auto misses = SimulateCache(indices, numVertices, cacheSize);
+    result.NumTransformedVertices = std::accumulate(misses.begin(), misses.end(), size_t {0});
+
+    std::vector<bool> isUsed(numVertices);
+    for (const auto index : indices)
+        isUsed[index] = true;
+    result.NumUsedVertices = static_cast<size_t>(std::ranges::count(isUsed, true));
+
+    return result;
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexCache(std::span<const uint32_t> indices, size_t numVertices)
+{
+    ValidateIndices(indices, numVertices);
+
+    const size_t numTriangles = indices.size() / 3;
+
+    // not emitted triangles of every vertex, first remainingTriangles[vertex] entries of it's adjacency range are valid
+    std::vector<uint32_t> remainingTriangles(numVertices, 0);
+    for (const auto index : indices)
+        ++remainingTriangles[index];
+
+    std::vector<uint32_t> adjacencyOffsets(numVertices + 1, 0);
+    std::partial_sum(remainingTriangles.begin(), remainingTriangles.end(), adjacencyOffsets.begin() + 1);
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        auto fillPositions = adjacencyOffsets;
+        for (size_t i = 0; i < indices.size(); ++i)
+            adjacency[fillPositions[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<int> cachePositions(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+    for (size_t vertex = 0; vertex < numVertices; ++vertex)
+        vertexScores[vertex] = GetVertexScore(-1, remainingTriangles[vertex]);
+
+    const auto getTriangleScore = [&](size_t triangle) {
+        return vertexScores[indices[triangle * 3]] + vertexScores[indices[triangle * 3 + 1]] + vertexScores[indices[triangle * 3 + 2]];
+    };
+
+    std::vector<bool> isEmitted(numTriangles, false);
+    std::vector<uint32_t> cache, newCache;
+    cache.reserve(ScoringCacheSize + 3);
+    newCache.reserve(ScoringCacheSize + 3);
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    constexpr auto noTriangle = std::numeric_limits<size_t>::max();
+    size_t bestTriangle = noTriangle;
+    size_t inputCursor = 0;
+    for (size_t emitted = 0; emitted < numTriangles; ++emitted)
+    {
+        // nothing is adjacent to cached vertices, so continue with the next triangle in the original order
+        if (bestTriangle == noTriangle)
+        {
+            while (isEmitted[inputCursor])
+                ++inputCursor;
+            bestTriangle = inputCursor;
+        }
+
+        const auto triangle = indices.subspan(bestTriangle * 3, 3);
+        result.insert(result.end(), triangle.begin(), triangle.end());
+        isEmitted[bestTriangle] = true;
+
+        for (const auto vertex : triangle)
+        {
+            const auto begin = adjacency.begin() + adjacencyOffsets[vertex];
+            const auto end = begin + remainingTriangles[vertex];
+            std::iter_swap(std::find(begin, end, static_cast<uint32_t>(bestTriangle)), end - 1);
+            --remainingTriangles[vertex];
+        }
+
+        // LRU cache, vertices of the emitted triangle are moved to the front
+        newCache.assign(triangle.begin(), triangle.end());
+        std::ranges::copy_if(cache, std::back_inserter(newCache),
+                             [&](uint32_t vertex) { return std::ranges::find(triangle, vertex) == triangle.end(); });
+
+        for (size_t position = 0; position < newCache.size(); ++position)
+        {
+            const auto vertex = newCache[position];
+            cachePositions[vertex] = position < ScoringCacheSize ? static_cast<int>(position) : -1;
+            vertexScores[vertex] = GetVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+        }
+        newCache.resize(std::min(newCache.size(), ScoringCacheSize));
+        std::swap(cache, newCache);
+
+        bestTriangle = noTriangle;
+        float bestScore = 0.0f;
+        for (const auto vertex : cache)
+        {
+            const auto begin = adjacency.begin() + adjacencyOffsets[vertex];
+            for (auto it = begin; it != begin + remainingTriangles[vertex]; ++it)
+            {
+                if (const float score = getTriangleScore(*it); score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = *it;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeOverdraw(std::span<const uint32_t> indices, std::span<const glm::vec3> positions, float threshold)
+{
+    ValidateIndices(indices, positions.size());
+
+    const size_t numTriangles = indices.size() / 3;
+    const auto misses = SimulateCache(indices, positions.size(), DefaultCacheSize);
+
+    // Hard boundaries are where cache is empty anyway, then they are divided further while cluster's ACMR is good enough
+    std::vector<size_t> clusterStarts;
+    for (size_t hardStart = 0; hardStart < numTriangles;)
+    {
+        size_t hardEnd = hardStart + 1;
+        while (hardEnd < numTriangles && misses[hardEnd] < 3)
+            ++hardEnd;
+
+        const auto hardMisses = std::accumulate(misses.begin() + hardStart, misses.begin() + hardEnd, size_t {0});
+        const float acceptableACMR = threshold * hardMisses / (hardEnd - hardStart);
+
+        size_t softStart = hardStart, softMisses = 0;
+        clusterStarts.push_back(hardStart);
+        for (size_t triangle = hardStart; triangle < hardEnd; ++triangle)
+        {
+            softMisses += misses[triangle];
+
+            const size_t softSize = triangle + 1 - softStart;
+            if (softSize >= MinClusterSize && hardEnd - triangle > MinClusterSize &&
+                static_cast<float>(softMisses) / softSize <= acceptableACMR)
+            {
+                softStart = triangle + 1;
+                softMisses = 0;
+                clusterStarts.push_back(softStart);
+            }
+        }
+
+        hardStart = hardEnd;
+    }
+    clusterStarts.push_back(numTriangles);
+
+    // area weighted centroid and normal of every cluster
+    struct Cluster
+    {
+        size_t Start, End;
+        glm::vec3 Centroid {0.0f};
+        glm::vec3 Normal {0.0f};
+        float Area = 0.0f;
+        float SortKey = 0.0f;
+    };
+
+    std::vector<Cluster> clusters;
+    clusters.reserve(clusterStarts.size() - 1);
+    glm::vec3 meshCentroid {0.0f};
+    float meshArea = 0.0f;
+    for (size_t i = 0; i + 1 < clusterStarts.size(); ++i)
+    {
+        auto& cluster = clusters.emplace_back(Cluster {clusterStarts[i], clusterStarts[i + 1]});
+        for (size_t triangle = cluster.Start; triangle < cluster.End; ++triangle)
+        {
+            const auto& a = positions[indices[triangle * 3]];
+            const auto& b = positions[indices[triangle * 3 + 1]];
+            const auto& c = positions[indices[triangle * 3 + 2]];
+
+            const auto normal = glm::cross(b - a, c - a);
+            const float area = glm::length(normal);
+
+            cluster.Normal += normal;
+            cluster.Centroid += (a + b + c) * (area / 3.0f);
+            cluster.Area += area;
+        }
+
+        meshCentroid += cluster.Centroid;
+        meshArea += cluster.Area;
+        if (cluster.Area > 0.0f)
+            cluster.Centroid /= cluster.Area;
+    }
+
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // clusters facing outwards are likely to occlude the others
+    for (auto& cluster : clusters)
+        if (const float length = glm::length(cluster.Normal); length > 0.0f)
+            cluster.SortKey = glm::dot(cluster.Centroid - meshCentroid, cluster.Normal / length);
+
+    std::ranges::stable_sort(clusters, std::greater {}, &Cluster::SortKey);
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (const auto& cluster : clusters)
+        result.insert(result.end(), indices.begin() + cluster.Start * 3, indices.begin() + cluster.End * 3);
+
+    const auto originalStatistics = AnalyzeVertexCache(indices, positions.size());
+    const auto resultStatistics = AnalyzeVertexCache(result, positions.size());
+    if (resultStatistics.GetACMR() > originalStatistics.GetACMR() * threshold)
+        return {indices.begin(), indices.end()};
+
+    return result;
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexFetch(std::span<uint32_t> indices, size_t numVertices)
+{
+    ValidateIndices(indices, numVertices);
+
+    std::vector<uint32_t> remap(numVertices, UnusedVertex);
+    uint32_t nextVertex = 0;
+    for (auto& index : indices)
+    {
+        if (remap[index] == UnusedVertex)
+            remap[index] = nextVertex++;
+
+        index = remap[index];
+    }
+
+    return remap;
+}
+
+std::vector<std::byte> MeshOptimizer::RemapVertices(std::span<const std::byte> vertices, size_t elementSize, std::span<const uint32_t> remap)
+{
+    if (vertices.size() != remap.size() * elementSize)
+        throw AT2Exception("MeshOptimizer: remap table doesn't match the vertices");
+
+    const auto numUsed = static_cast<size_t>(std::ranges::count_if(remap, [](uint32_t index) { return index != UnusedVertex; }));
+
+    std::vector<std::byte> result(numUsed * elementSize);
+    for (size_t vertex = 0; vertex < remap.size(); ++vertex)
+    {
+        if (remap[vertex] == UnusedVertex)
+            continue;
+
+        if (remap[vertex] >= numUsed)
+            throw AT2Exception("MeshOptimizer: remap table isn't dense");
+
+        std::memcpy(result.data() + remap[vertex] * elementSize, vertices.data() + vertex * elementSize, elementSize);
+    }
+
+    return result;
+}
+
+std::optional<std::vector<uint16_t>> MeshOptimizer::NarrowIndices(std::span<const uint32_t> indices)
+{
+    if (std::ranges::any_of(indices, [](uint32_t index) { return index > std::numeric_limits<uint16_t>::max(); }))
+        return std::nullopt;
+
+    std::vector<uint16_t> result(indices.size());
+    std::ranges::transform(indices, result.begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+    return result;
+}
+
+MeshOptimizer::PackedIndices MeshOptimizer::PackIndices(std::span<const uint32_t> indices)
+{
+    const auto toBytes = [](const auto& values) {
+        const auto bytes = std::as_bytes(std::span {values});
+        return std::vector<std::byte>(bytes.begin(), bytes.end());
+    };
+
+    if (const auto narrowedIndices = NarrowIndices(indices))
+        return {BufferDataType::UShort, toBytes(*narrowedIndices)};
+
+    return {BufferDataType::UInt, toBytes(indices)};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "AT2.h"
+
+#include <limits>
+#include <optional>
+
+namespace AT2
+{
+    // CPU-side reordering of indexed triangle lists for faster rendering:
+    //  vertex cache - triangles are reordered to reuse recently transformed vertices (Forsyth's linear-speed algorithm);
+    //  overdraw - clusters of triangles are sorted to draw outer faces first, keeping most of the cache efficiency;
+    //  vertex fetch - vertices are renumbered in the order of first use, so memory is read sequentially.
+    // Optimizations should be applied in this order. Triangle winding is always kept.
+    class MeshOptimizer
+    {
+    public:
+        static constexpr unsigned int DefaultCacheSize = 16;
+        static constexpr uint32_t UnusedVertex = std::numeric_limits<uint32_t>::max();
+
+        struct Statistics
+        {
+            size_t NumTriangles = 0;
+            size_t NumUsedVertices = 0;
+            size_t NumTransformedVertices = 0; // cache misses
+
+            // transformed vertices per triangle, 0.5 - 3.0, lower is better
+            [[nodiscard]] float GetACMR() const noexcept { return NumTriangles ? static_cast<float>(NumTransformedVertices) / NumTriangles : 0.0f; }
+            // transformed vertices per used vertex, 1.0 is optimal
+            [[nodiscard]] float GetATVR() const noexcept { return NumUsedVertices ? static_cast<float>(NumTransformedVertices) / NumUsedVertices : 0.0f; }
+
+            Statistics& operator+=(const Statistics& other) noexcept
+            {
+                NumTriangles += other.NumTriangles;
+                NumUsedVertices += other.NumUsedVertices;
+                NumTransformedVertices += other.NumTransformedVertices;
+                return *this;
+            }
+        };
+
+        // Simulates FIFO post-transform cache of the given size
+        [[nodiscard]] static Statistics AnalyzeVertexCache(std::span<const uint32_t> indices, size_t numVertices,
+                                                           unsigned int cacheSize = DefaultCacheSize);
+
+        [[nodiscard]] static std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices, size_t numVertices);
+
+        // Expects cache optimized indices, the result ACMR is at most threshold times higher than the original one
+        [[nodiscard]] static std::vector<uint32_t> OptimizeOverdraw(std::span<const uint32_t> indices,
+                                                                    std::span<const glm::vec3> positions, float threshold = 1.05f);
+
+        // Renumbers indices in place and returns table from old vertex numbers to new ones, unreferenced vertices are
+        // mapped to UnusedVertex
+        [[nodiscard]] static std::vector<uint32_t> OptimizeVertexFetch(std::span<uint32_t> indices, size_t numVertices);
+
+        // Moves tightly packed elements of the given size to their new places, unused ones are dropped
+        [[nodiscard]] static std::vector<std::byte> RemapVertices(std::span<const std::byte> vertices, size_t elementSize,
+                                                                  std::span<const uint32_t> remap);
+
+        // Returns nullopt if some index doesn't fit into 16 bits
+        [[nodiscard]] static std::optional<std::vector<uint16_t>> NarrowIndices(std::span<const uint32_t> indices);
+
+        struct PackedIndices
+        {
+            BufferDataType Type;
+            std::vector<std::byte> Data;
+        };
+
+        // 16-bit indices take half of the memory and bandwidth, so they are used whenever all indices fit, otherwise 32-bit
+        [[nodiscard]] static PackedIndices PackIndices(std::span<const uint32_t> indices);
+    };
+
+} // namespace AT2
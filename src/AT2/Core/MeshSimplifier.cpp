@@ -0,0 +1,313 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace AT2;
+
+namespace
+{
+    // level which removes less than that part of triangles isn't worth of it's indices
+    constexpr double MinLodReduction = 0.1;
+
+    void ValidateIndices(std::span<const uint32_t> indices, size_t numVertices)
+    {
+        if (indices.size() % 3 != 0)
+            throw AT2Exception("MeshSimplifier: indices must form a triangle list");
+
+        if (std::ranges::any_of(indices, [numVertices](uint32_t index) { return index >= numVertices; }))
+            throw AT2Exception("MeshSimplifier: index is out of vertices range");
+    }
+
+    // Sum of squared distances to planes as symmetric 4x4 matrix, weighted by areas of triangles
+    struct Quadric
+    {
+        double A00 = 0, A01 = 0, A02 = 0, A03 = 0;
+        double A11 = 0, A12 = 0, A13 = 0;
+        double A22 = 0, A23 = 0;
+        double A33 = 0;
+        double Weight = 0;
+
+        static Quadric FromPlane(const glm::dvec3& normal, double distance, double weight) noexcept
+        {
+            const auto a = normal.x, b = normal.y, c = normal.z, d = distance;
+            return {a * a * weight, a * b * weight, a * c * weight, a * d * weight,
+                    b * b * weight, b * c * weight, b * d * weight,
+                    c * c * weight, c * d * weight,
+                    d * d * weight,
+                    weight};
+        }
+
+        Quadric& operator+=(const Quadric& other) noexcept
+        {
+            A00 += other.A00; A01 += other.A01; A02 += other.A02; A03 += other.A03;
+            A11 += other.A11; A12 += other.A12; A13 += other.A13;
+            A22 += other.A22; A23 += other.A23;
+            A33 += other.A33;
+            Weight += other.Weight;
+            return *this;
+        }
+
+        // Mean squared distance from the point to the planes
+        [[nodiscard]] double GetError(const glm::dvec3& point) const noexcept
+        {
+            if (Weight <= 0)
+                return 0;
+
+            const auto x = point.x, y = point.y, z = point.z;
+            const double error = A00 * x * x + 2 * A01 * x * y + 2 * A02 * x * z + 2 * A03 * x +
+                                 A11 * y * y + 2 * A12 * y * z + 2 * A13 * y +
+                                 A22 * z * z + 2 * A23 * z +
+                                 A33;
+
+            return std::max(error, 0.0) / Weight;
+        }
+    };
+
+    // Topology of vertices ignoring their attributes: vertices at the same position are one point of the surface
+    class Topology
+    {
+    public:
+        Topology(std::span<const uint32_t> indices, std::span<const glm::vec3> positions)
+            : m_points(positions.size()), m_isLocked(positions.size(), false)
+        {
+            const auto hashPosition = [](const glm::vec3& position) {
+                const auto hashFloat = std::hash<float> {};
+                return hashFloat(position.x) ^ (hashFloat(position.y) * 31) ^ (hashFloat(position.z) * 961);
+            };
+
+            std::unordered_map<glm::vec3, uint32_t, decltype(hashPosition)> firstVertices(positions.size(), hashPosition);
+            std::vector<uint32_t> numWedges(positions.size(), 0);
+            for (uint32_t vertex = 0; vertex < positions.size(); ++vertex)
+            {
+                m_points[vertex] = firstVertices.try_emplace(positions[vertex], vertex).first->second;
+                ++numWedges[m_points[vertex]];
+            }
+
+            // moving a vertex of the seam would tear the surface apart
+            for (uint32_t vertex = 0; vertex < positions.size(); ++vertex)
+                if (numWedges[m_points[vertex]] > 1)
+                    m_isLocked[vertex] = true;
+
+            // edges without the opposite half-edge are at the open border
+            const auto makeEdge = [](uint32_t from, uint32_t to) { return (static_cast<uint64_t>(from) << 32) | to; };
+            std::unordered_set<uint64_t> halfEdges;
+            halfEdges.reserve(indices.size());
+            ForEachEdge(indices, [&](uint32_t from, uint32_t to) { halfEdges.insert(makeEdge(m_points[from], m_points[to])); });
+            ForEachEdge(indices, [&](uint32_t from, uint32_t to) {
+                if (!halfEdges.contains(makeEdge(m_points[to], m_points[from])))
+                    m_isLocked[from] = m_isLocked[to] = true;
+            });
+        }
+
+        [[nodiscard]] uint32_t GetPoint(uint32_t vertex) const noexcept { return m_points[vertex]; }
+        [[nodiscard]] bool IsLocked(uint32_t vertex) const noexcept { return m_isLocked[vertex]; }
+
+        template <typename Func>
+        static void ForEachEdge(std::span<const uint32_t> indices, Func&& func)
+        {
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                func(indices[i], indices[i + 1]);
+                func(indices[i + 1], indices[i + 2]);
+                func(indices[i + 2], indices[i]);
+            }
+        }
+
+    private:
+        std::vector<uint32_t> m_points; // first vertex with the same position
+        std::vector<bool> m_isLocked;
+    };
+
+    struct Collapse
+    {
+        uint32_t From;
+        uint32_t To;
+        double Error; // squared
+    };
+
+    // Triangles of every vertex, in CSR form
+    struct Adjacency
+    {
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Triangles;
+
+        Adjacency(std::span<const uint32_t> indices, size_t numVertices) : Offsets(numVertices + 1, 0), Triangles(indices.size())
+        {
+            for (const auto index : indices)
+                ++Offsets[index + 1];
+            std::partial_sum(Offsets.begin(), Offsets.end(), Offsets.begin());
+
+            auto fillPositions = Offsets;
+            for (size_t i = 0; i < indices.size(); ++i)
+                Triangles[fillPositions[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        [[nodiscard]] std::span<const uint32_t> Get(uint32_t vertex) const noexcept
+        {
+            return std::span {Triangles}.subspan(Offsets[vertex], Offsets[vertex + 1] - Offsets[vertex]);
+        }
+    };
+
+    glm::vec3 GetNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) { return glm::cross(p1 - p0, p2 - p0); }
+} // namespace
+
+std::vector<uint32_t> MeshSimplifier::Simplify(std::span<const uint32_t> indices, std::span<const glm::vec3> positions,
+                                               size_t targetIndexCount, float targetError, float* resultError)
+{
+    ValidateIndices(indices, positions.size());
+
+    std::vector<uint32_t> result {indices.begin(), indices.end()};
+    double maxError = 0.0;
+
+    const Topology topology {indices, positions};
+    const auto numVertices = static_cast<uint32_t>(positions.size());
+
+    // quadrics are shared by the vertices at the same position
+    std::vector<Quadric> quadrics(numVertices);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const glm::dvec3 p0 = positions[indices[i]], p1 = positions[indices[i + 1]], p2 = positions[indices[i + 2]];
+        const auto normal = glm::cross(p1 - p0, p2 - p0);
+        const auto doubleArea = glm::length(normal);
+        if (doubleArea <= 0)
+            continue;
+
+        const auto unitNormal = normal / doubleArea;
+        const auto quadric = Quadric::FromPlane(unitNormal, -glm::dot(unitNormal, p0), doubleArea * 0.5);
+        for (size_t j = 0; j < 3; ++j)
+            quadrics[topology.GetPoint(indices[i + j])] += quadric;
+    }
+
+    const auto targetErrorSquared = static_cast<double>(targetError) * targetError;
+    const auto getCollapseError = [&](uint32_t from, uint32_t to) {
+        auto quadric = quadrics[topology.GetPoint(from)];
+        quadric += quadrics[topology.GetPoint(to)];
+        return quadric.GetError(positions[to]);
+    };
+
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> remap(numVertices);
+    std::vector<bool> isTouched;
+
+    // every pass collapses independent edges in the order of their error, so 1-rings of collapsed vertices don't overlap
+    while (result.size() > targetIndexCount)
+    {
+        const Adjacency adjacency {result, numVertices};
+
+        collapses.clear();
+        Topology::ForEachEdge(result, [&](uint32_t from, uint32_t to) {
+            if (!topology.IsLocked(from))
+                collapses.push_back({from, to, getCollapseError(from, to)});
+            if (!topology.IsLocked(to))
+                collapses.push_back({to, from, getCollapseError(to, from)});
+        });
+        std::ranges::sort(collapses, std::less {}, &Collapse::Error);
+
+        std::iota(remap.begin(), remap.end(), 0u);
+        isTouched.assign(numVertices, false);
+
+        const auto getTriangle = [&](uint32_t triangle) { return std::span {result}.subspan(triangle * 3, 3); };
+        const auto flipsTriangles = [&](uint32_t from, uint32_t to) {
+            for (const auto triangle : adjacency.Get(from))
+            {
+                const auto vertices = getTriangle(triangle);
+                if (std::ranges::find(vertices, to) != vertices.end())
+                    continue; // it's removed by the collapse
+
+                std::array<glm::vec3, 3> moved {positions[vertices[0]], positions[vertices[1]], positions[vertices[2]]};
+                const auto oldNormal = GetNormal(moved[0], moved[1], moved[2]);
+                moved[std::ranges::find(vertices, from) - vertices.begin()] = positions[to];
+
+                if (glm::dot(oldNormal, GetNormal(moved[0], moved[1], moved[2])) <= 0.0f)
+                    return true;
+            }
+
+            return false;
+        };
+
+        auto numTriangles = result.size() / 3;
+        const auto targetTriangles = targetIndexCount / 3;
+        size_t numCollapsed = 0;
+        for (const auto& [from, to, error] : collapses)
+        {
+            if (error > targetErrorSquared || numTriangles <= targetTriangles)
+                break;
+
+            if (isTouched[from] || isTouched[to] || flipsTriangles(from, to))
+                continue;
+
+            remap[from] = to;
+            quadrics[topology.GetPoint(to)] += quadrics[topology.GetPoint(from)];
+            maxError = std::max(maxError, error);
+            ++numCollapsed;
+
+            for (const auto triangle : adjacency.Get(from))
+            {
+                const auto vertices = getTriangle(triangle);
+                if (std::ranges::find(vertices, to) != vertices.end())
+                    --numTriangles;
+
+                for (const auto vertex : vertices)
+                    isTouched[vertex] = true;
+            }
+        }
+
+        if (numCollapsed == 0)
+            break;
+
+        // degenerate triangles are dropped
+        size_t writePosition = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            const auto v0 = remap[result[i]], v1 = remap[result[i + 1]], v2 = remap[result[i + 2]];
+            if (v0 == v1 || v1 == v2 || v2 == v0)
+                continue;
+
+            result[writePosition++] = v0;
+            result[writePosition++] = v1;
+            result[writePosition++] = v2;
+        }
+        result.resize(writePosition);
+    }
+
+    if (resultError)
+        *resultError = static_cast<float>(std::sqrt(maxError));
+
+    return result;
+}
+
+std::vector<MeshSimplifier::LodRange> MeshSimplifier::AppendLods(std::vector<uint32_t>& indices, std::span<const glm::vec3> positions,
+                                                                 size_t maxLods, float ratio, float maxError)
+{
+    // every level is simplified from the full detail, so errors are measured against the original surface
+    const std::vector<uint32_t> original = indices;
+
+    std::vector<LodRange> result;
+    size_t previousCount = original.size();
+    float previousError = 0.0f;
+    while (result.size() < maxLods)
+    {
+        const auto targetCount = static_cast<size_t>(static_cast<double>(previousCount) * ratio) / 3 * 3;
+        if (targetCount == 0)
+            break;
+
+        float error = 0.0f;
+        auto lod = Simplify(original, positions, targetCount, maxError, &error);
+        if (lod.empty() || static_cast<double>(lod.size()) > static_cast<double>(previousCount) * (1.0 - MinLodReduction))
+            break;
+
+        lod = MeshOptimizer::OptimizeVertexCache(lod, positions.size());
+
+        previousError = std::max(previousError, error);
+        result.push_back({static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.size()), previousError});
+        indices.insert(indices.end(), lod.begin(), lod.end());
+        previousCount = lod.size();
+    }
+
+    return result;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "AT2.h"
+
+#include <limits>
+
+namespace AT2
+{
+    // Quadric error simplification of indexed triangle lists (Garland and Heckbert). Edges are collapsed into one of their
+    // vertices, so simplified indices refer to the same vertex buffer and could be stored as additional index ranges.
+    // Open borders and vertices split by attribute seams are never moved, collapses flipping triangles are rejected.
+    class MeshSimplifier
+    {
+    public:
+        static constexpr size_t DefaultMaxLods = 4;
+
+        // Range of the index buffer holding a level of detail
+        struct LodRange
+        {
+            uint32_t FirstIndex = 0;
+            uint32_t Count = 0;
+            float Error = 0.0f; // estimated object-space distance from the original surface
+        };
+
+        // Collapses edges until there are at most targetIndexCount indices left or the next collapse would move the
+        // surface further than targetError. resultError receives the error of the result if it's given.
+        [[nodiscard]] static std::vector<uint32_t> Simplify(std::span<const uint32_t> indices, std::span<const glm::vec3> positions,
+                                                            size_t targetIndexCount,
+                                                            float targetError = std::numeric_limits<float>::max(),
+                                                            float* resultError = nullptr);
+
+        // Appends coarser levels to the indices, each one has about ratio of the triangles of the previous one and is vertex
+        // cache optimized. Returns ranges of appended levels by increasing error, the chain stops when simplification
+        // doesn't reduce triangle count noticeably or exceeds maxError.
+        [[nodiscard]] static std::vector<LodRange> AppendLods(std::vector<uint32_t>& indices, std::span<const glm::vec3> positions,
+                                                              size_t maxLods = DefaultMaxLods, float ratio = 0.5f,
+                                                              float maxError = std::numeric_limits<float>::max());
+    };
+
+} // namespace AT2
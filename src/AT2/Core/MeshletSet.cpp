@@ -0,0 +1,154 @@
+#include "MeshletSet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace AT2;
+
+namespace
+{
+    // cones of meshlets with faces this close to perpendicular to the axis couldn't cull anything meaningful
+    constexpr float MinConeSpread = 0.1f;
+
+    constexpr uint32_t NoMeshlet = std::numeric_limits<uint32_t>::max();
+
+    void ComputeBounds(Meshlet& meshlet, std::span<const uint32_t> indices, std::span<const glm::vec3> positions,
+                       std::span<const uint32_t> vertices)
+    {
+        glm::vec3 minBound {std::numeric_limits<float>::max()}, maxBound {std::numeric_limits<float>::lowest()};
+        for (const auto vertex : vertices)
+        {
+            minBound = glm::min(minBound, positions[vertex]);
+            maxBound = glm::max(maxBound, positions[vertex]);
+        }
+
+        meshlet.Center = (minBound + maxBound) * 0.5f;
+        for (const auto vertex : vertices)
+            meshlet.Radius = std::max(meshlet.Radius, glm::length(positions[vertex] - meshlet.Center));
+
+        const auto forEachNormal = [&](auto&& func) {
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                const auto& p0 = positions[indices[i]];
+                const auto normal = glm::cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+                if (const auto area = glm::length(normal); area > 0.0f)
+                    func(normal / area);
+            }
+        };
+
+        glm::vec3 axis {0.0f};
+        forEachNormal([&](const glm::vec3& normal) { axis += normal; });
+
+        const auto axisLength = glm::length(axis);
+        if (axisLength == 0.0f)
+            return;
+
+        axis /= axisLength;
+        float minDot = 1.0f;
+        forEachNormal([&](const glm::vec3& normal) { minDot = std::min(minDot, glm::dot(normal, axis)); });
+
+        // faces are visible from the directions within 90 degrees of their normals, so the cone of view directions seeing
+        // only back faces is the normal cone inverted and narrowed by 90 degrees: cos(90 - spread) = sin(spread)
+        if (minDot <= MinConeSpread)
+            return;
+
+        meshlet.ConeAxis = axis;
+        meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+} // namespace
+
+MeshletSet::MeshletSet(std::vector<Meshlet> meshlets) : m_meshlets {std::move(meshlets)}
+{
+    m_blocks.reserve((m_meshlets.size() + BlockSize - 1) / BlockSize * BlockFloats);
+    for (size_t i = 0; i < m_meshlets.size(); ++i)
+        AppendBounds(i);
+}
+
+std::vector<Meshlet> MeshletSet::Build(std::span<const uint32_t> indices, std::span<const glm::vec3> positions, size_t maxVertices,
+                                       size_t maxTriangles)
+{
+    if (indices.size() % 3 != 0)
+        throw AT2Exception("MeshletSet: indices must form a triangle list");
+    if (maxVertices < 3 || maxTriangles == 0)
+        throw AT2Exception("MeshletSet: meshlet must hold at least one triangle");
+    if (std::ranges::any_of(indices, [&](uint32_t index) { return index >= positions.size(); }))
+        throw AT2Exception("MeshletSet: index is out of vertices range");
+
+    std::vector<Meshlet> result;
+
+    // the meshlet which last used the vertex, so vertices are counted without clearing of the table
+    std::vector<uint32_t> vertexMeshlet(positions.size(), NoMeshlet);
+    std::vector<uint32_t> vertices;
+    vertices.reserve(maxVertices);
+
+    size_t firstIndex = 0;
+    const auto finishMeshlet = [&](size_t endIndex) {
+        auto& meshlet = result.emplace_back();
+        meshlet.FirstIndex = static_cast<uint32_t>(firstIndex);
+        meshlet.Count = static_cast<uint32_t>(endIndex - firstIndex);
+        ComputeBounds(meshlet, indices.subspan(firstIndex, endIndex - firstIndex), positions, vertices);
+
+        vertices.clear();
+        firstIndex = endIndex;
+    };
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const auto a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        const auto current = static_cast<uint32_t>(result.size());
+        const auto isNew = [&](uint32_t vertex) { return vertexMeshlet[vertex] != current; };
+        const size_t numNewVertices = isNew(a) + (isNew(b) && b != a) + (isNew(c) && c != a && c != b);
+
+        if ((i - firstIndex) / 3 == maxTriangles || vertices.size() + numNewVertices > maxVertices)
+            finishMeshlet(i);
+
+        for (const auto vertex : {a, b, c})
+        {
+            if (vertexMeshlet[vertex] == result.size())
+                continue;
+
+            vertexMeshlet[vertex] = static_cast<uint32_t>(result.size());
+            vertices.push_back(vertex);
+        }
+    }
+
+    if (firstIndex < indices.size())
+        finishMeshlet(indices.size());
+
+    return result;
+}
+
+void MeshletSet::Append(std::span<const Meshlet> meshlets, const MeshChunk& chunk)
+{
+    for (auto meshlet : meshlets)
+    {
+        meshlet.FirstIndex += chunk.StartElement;
+        meshlet.BaseVertex += chunk.BaseVertex;
+
+        m_meshlets.push_back(meshlet);
+        AppendBounds(m_meshlets.size() - 1);
+    }
+}
+
+void MeshletSet::AppendBounds(size_t index)
+{
+    const auto lane = index % BlockSize;
+    if (lane == 0)
+    {
+        // padding has zero radius and can't be cone culled
+        m_blocks.resize(m_blocks.size() + BlockFloats, 0.0f);
+        std::fill_n(m_blocks.end() - BlockSize, BlockSize, 1.0f);
+    }
+
+    const auto& meshlet = m_meshlets[index];
+    m_boundsMin = glm::min(m_boundsMin, meshlet.Center - meshlet.Radius);
+    m_boundsMax = glm::max(m_boundsMax, meshlet.Center + meshlet.Radius);
+
+    const auto values = std::to_array({meshlet.Center.x, meshlet.Center.y, meshlet.Center.z, meshlet.Radius, meshlet.ConeAxis.x,
+                                       meshlet.ConeAxis.y, meshlet.ConeAxis.z, meshlet.ConeCutoff});
+
+    auto* block = m_blocks.data() + index / BlockSize * BlockFloats;
+    for (size_t i = 0; i < values.size(); ++i)
+        block[i * BlockSize + lane] = values[i];
+}
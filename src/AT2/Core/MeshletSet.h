@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <limits>
+
+namespace AT2
+{
+    // Small cluster of triangles, which is culled as a whole. Triangles are consecutive in the index buffer, so the meshlet
+    // is drawn by one indexed command.
+    struct Meshlet
+    {
+        std::uint32_t FirstIndex = 0;
+        std::uint32_t Count = 0; // indices
+        std::int32_t BaseVertex = 0;
+
+        glm::vec3 Center {0.0f}; // bounding sphere
+        float Radius = 0.0f;
+
+        // Normal cone: all triangles face away from the viewer when dot(normalize(Center - viewer), ConeAxis) is at least
+        // ConeCutoff plus the sphere correction, see ClusterCuller. Cutoff 1 means the cone is too wide to cull anything.
+        glm::vec3 ConeAxis {0.0f, 0.0f, 1.0f};
+        float ConeCutoff = 1.0f;
+
+        [[nodiscard]] MeshChunk GetChunk() const noexcept { return {Primitives::Triangles {}, FirstIndex, Count, BaseVertex}; }
+    };
+
+    static_assert(std::is_trivially_copyable_v<Meshlet>);
+
+    // Meshlets of the full detail primitives of a submesh. Besides the meshlets themselves their bounds are kept in blocks
+    // of BlockSize meshlets, each block is a run of BlockSize centers x, centers y, centers z, radii, cone axes x, y, z and
+    // cone cutoffs, so they are tested by SIMD without gathering. The last block is padded, culling ignores the padding.
+    class MeshletSet
+    {
+    public:
+        static constexpr size_t DefaultMaxVertices = 64;
+        static constexpr size_t DefaultMaxTriangles = 124;
+        static constexpr size_t BlockSize = 4;
+        static constexpr size_t BlockFloats = BlockSize * 8;
+
+        MeshletSet() = default;
+        explicit MeshletSet(std::vector<Meshlet> meshlets);
+
+        // Splits the triangle list into meshlets of consecutive triangles, a meshlet ends when the next triangle would exceed
+        // one of the limits. The index order is kept, so vertex cache optimized indices give spatially compact meshlets.
+        // Returned meshlets refer to the given indices, see Append.
+        [[nodiscard]] static std::vector<Meshlet> Build(std::span<const uint32_t> indices, std::span<const glm::vec3> positions,
+                                                        size_t maxVertices = DefaultMaxVertices,
+                                                        size_t maxTriangles = DefaultMaxTriangles);
+
+        // Adds meshlets built of the indices the chunk draws, they are moved to the chunk's range of the index buffer
+        void Append(std::span<const Meshlet> meshlets, const MeshChunk& chunk);
+
+        [[nodiscard]] std::span<const Meshlet> GetMeshlets() const noexcept { return m_meshlets; }
+        [[nodiscard]] size_t Size() const noexcept { return m_meshlets.size(); }
+        [[nodiscard]] bool Empty() const noexcept { return m_meshlets.empty(); }
+
+        [[nodiscard]] std::span<const float> GetBlocks() const noexcept { return m_blocks; }
+
+        // Box around bounding spheres of all meshlets, min is greater than max while the set is empty
+        [[nodiscard]] const glm::vec3& GetBoundsMin() const noexcept { return m_boundsMin; }
+        [[nodiscard]] const glm::vec3& GetBoundsMax() const noexcept { return m_boundsMax; }
+
+    private:
+        void AppendBounds(size_t index);
+
+    private:
+        std::vector<Meshlet> m_meshlets;
+        std::vector<float> m_blocks;
+        glm::vec3 m_boundsMin {std::numeric_limits<float>::max()};
+        glm::vec3 m_boundsMax {std::numeric_limits<float>::lowest()};
+    };
+
+} // namespace AT2
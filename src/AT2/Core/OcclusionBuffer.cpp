@@ -0,0 +1,275 @@
+#include "OcclusionBuffer.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace AT2;
+using namespace AT2::Simd;
+
+namespace
+{
+    static_assert(OcclusionBuffer::TileSize % 4 == 0, "rows of tiles are processed by 4-wide vectors");
+
+    // Distance to the OpenGL near plane, z = -w, in clip space
+    float NearDistance(const glm::vec4& position) noexcept { return position.z + position.w; }
+
+    // Linear function A * x + B * y + C of the screen position
+    struct ScreenPlane
+    {
+        float A = 0.0f, B = 0.0f, C = 0.0f;
+
+        // It's non-negative at the left side of the edge from p to q, depths of the points are ignored
+        static ScreenPlane Edge(const glm::vec3& p, const glm::vec3& q) noexcept
+        {
+            return {p.y - q.y, q.x - p.x, (q.y - p.y) * p.x - (q.x - p.x) * p.y};
+        }
+    };
+} // namespace
+
+OccluderMesh OccluderMesh::Build(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, float inset)
+{
+    if (indices.size() % 3 != 0)
+        throw AT2Exception("OccluderMesh: triangle list is expected");
+
+    constexpr auto Unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(positions.size(), Unused);
+
+    OccluderMesh result;
+    result.Indices.reserve(indices.size());
+    for (const auto index : indices)
+    {
+        if (index >= positions.size())
+            throw AT2Exception("OccluderMesh: index is out of range");
+
+        if (remap[index] == Unused)
+        {
+            remap[index] = static_cast<uint32_t>(result.Positions.size());
+            result.Positions.push_back(positions[index]);
+        }
+        result.Indices.push_back(remap[index]);
+    }
+
+    if (inset <= 0.0f)
+        return result;
+
+    // area-weighted normals, triangles of bigger area contribute more
+    std::vector<glm::vec3> normals(result.Positions.size(), glm::vec3 {0.0f});
+    for (size_t i = 0; i < result.Indices.size(); i += 3)
+    {
+        const auto a = result.Indices[i], b = result.Indices[i + 1], c = result.Indices[i + 2];
+        const auto normal = glm::cross(result.Positions[b] - result.Positions[a], result.Positions[c] - result.Positions[a]);
+        normals[a] += normal;
+        normals[b] += normal;
+        normals[c] += normal;
+    }
+
+    for (size_t i = 0; i < result.Positions.size(); ++i)
+        if (const auto length = glm::length(normals[i]); length > 0.0f)
+            result.Positions[i] -= normals[i] * (inset / length);
+
+    return result;
+}
+
+OcclusionBuffer::OcclusionBuffer(glm::uvec2 size)
+{
+    if (size.x == 0 || size.y == 0)
+        throw AT2Exception("OcclusionBuffer: size must not be zero");
+
+    m_numTiles = (size + TileSize - 1u) / TileSize;
+    m_size = m_numTiles * TileSize;
+    m_depth.assign(static_cast<size_t>(m_size.x) * m_size.y, ClearDepth);
+    m_tileMaxDepth.assign(static_cast<size_t>(m_numTiles.x) * m_numTiles.y, ClearDepth);
+}
+
+void OcclusionBuffer::Clear(const glm::mat4& viewProjection)
+{
+    m_viewProjection = viewProjection;
+    std::ranges::fill(m_depth, ClearDepth);
+    std::ranges::fill(m_tileMaxDepth, ClearDepth);
+    m_numRasterizedTriangles = 0;
+}
+
+void OcclusionBuffer::RenderOccluder(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, const glm::mat4& model)
+{
+    if (indices.size() % 3 != 0)
+        throw AT2Exception("OcclusionBuffer: occluder indices must be a triangle list");
+
+    const auto modelViewProjection = m_viewProjection * model;
+    m_clipPositions.resize(positions.size());
+    std::ranges::transform(positions, m_clipPositions.begin(),
+                           [&](const glm::vec3& position) { return modelViewProjection * glm::vec4 {position, 1.0f}; });
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        if (std::max({indices[i], indices[i + 1], indices[i + 2]}) >= m_clipPositions.size())
+            throw AT2Exception("OcclusionBuffer: occluder index is out of positions");
+
+        const std::array triangle {m_clipPositions[indices[i]], m_clipPositions[indices[i + 1]], m_clipPositions[indices[i + 2]]};
+
+        // entirely at the outer side of one of the side planes
+        const auto isOutside = [&](int axis) {
+            return std::ranges::all_of(triangle, [axis](const glm::vec4& v) { return v[axis] > v.w; }) ||
+                std::ranges::all_of(triangle, [axis](const glm::vec4& v) { return v[axis] < -v.w; });
+        };
+        if (isOutside(0) || isOutside(1))
+            continue;
+
+        const auto numInFront = std::ranges::count_if(triangle, [](const glm::vec4& v) { return NearDistance(v) >= 0.0f; });
+        if (numInFront == 3)
+        {
+            RasterizeTriangle(triangle[0], triangle[1], triangle[2]);
+            continue;
+        }
+        if (numInFront == 0)
+            continue;
+
+        // clipped triangle is a triangle or a quad
+        std::array<glm::vec4, 4> polygon;
+        size_t numVertices = 0;
+        for (size_t j = 0; j < triangle.size(); ++j)
+        {
+            const auto& current = triangle[j];
+            const auto& next = triangle[(j + 1) % triangle.size()];
+            const auto currentDistance = NearDistance(current), nextDistance = NearDistance(next);
+
+            if (currentDistance >= 0.0f)
+                polygon[numVertices++] = current;
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+                polygon[numVertices++] = glm::mix(current, next, currentDistance / (currentDistance - nextDistance));
+        }
+
+        RasterizeTriangle(polygon[0], polygon[1], polygon[2]);
+        if (numVertices == 4)
+            RasterizeTriangle(polygon[0], polygon[2], polygon[3]);
+    }
+}
+
+void OcclusionBuffer::RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    const auto size = glm::vec2 {m_size};
+    const auto toScreen = [&](const glm::vec4& v) { return glm::vec3 {(glm::vec2 {v} / v.w * 0.5f + 0.5f) * size, v.z / v.w}; };
+    const auto p0 = toScreen(a), p1 = toScreen(b), p2 = toScreen(c);
+
+    const float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+    if (!(area > 0.0f))
+        return;
+
+    const auto boundsMin = glm::max(glm::floor(glm::min(glm::min(glm::vec2 {p0}, glm::vec2 {p1}), glm::vec2 {p2})), glm::vec2 {0.0f});
+    const auto boundsMax = glm::min(glm::ceil(glm::max(glm::max(glm::vec2 {p0}, glm::vec2 {p1}), glm::vec2 {p2})), size);
+    if (boundsMin.x >= boundsMax.x || boundsMin.y >= boundsMax.y)
+        return;
+
+    ++m_numRasterizedTriangles;
+
+    // weights of the vertices are the edge functions of the opposite edges divided by the area, so depth is a plane too
+    const std::array edges {ScreenPlane::Edge(p1, p2), ScreenPlane::Edge(p2, p0), ScreenPlane::Edge(p0, p1)};
+    const auto interpolate = [&](float ScreenPlane::*member) {
+        return (edges[0].*member * p0.z + edges[1].*member * p1.z + edges[2].*member * p2.z) / area;
+    };
+    const ScreenPlane depth {interpolate(&ScreenPlane::A), interpolate(&ScreenPlane::B), interpolate(&ScreenPlane::C)};
+
+    const auto xBegin = static_cast<unsigned int>(boundsMin.x) & ~3u, xEnd = static_cast<unsigned int>(boundsMax.x);
+    const auto yBegin = static_cast<unsigned int>(boundsMin.y), yEnd = static_cast<unsigned int>(boundsMax.y);
+
+    // values at pixel centers of the first 4 pixels of a row and their steps to the next 4 pixels
+    const auto centers = Add(Splat(static_cast<float>(xBegin)), Set(0.5f, 1.5f, 2.5f, 3.5f));
+    const auto zero = Splat(0.0f);
+    const auto step = [](const ScreenPlane& plane) { return Splat(plane.A * 4.0f); };
+    const std::array edgeSteps {step(edges[0]), step(edges[1]), step(edges[2])};
+    const auto depthStep = step(depth);
+
+    for (auto y = yBegin; y < yEnd; ++y)
+    {
+        const float centerY = static_cast<float>(y) + 0.5f;
+        const auto rowStart = [&](const ScreenPlane& plane) { return Add(Mul(Splat(plane.A), centers), Splat(plane.B * centerY + plane.C)); };
+
+        std::array rowEdges {rowStart(edges[0]), rowStart(edges[1]), rowStart(edges[2])};
+        auto rowDepth = rowStart(depth);
+
+        float* pixels = m_depth.data() + static_cast<size_t>(y) * m_size.x;
+        for (auto x = xBegin; x < xEnd; x += 4)
+        {
+            const auto covered = And(And(GreaterEqual(rowEdges[0], zero), GreaterEqual(rowEdges[1], zero)), GreaterEqual(rowEdges[2], zero));
+            if (ToBits(covered) != 0)
+            {
+                const auto current = Load(pixels + x);
+                Store(pixels + x, Select(covered, Min(current, rowDepth), current));
+            }
+
+            for (size_t i = 0; i < rowEdges.size(); ++i)
+                rowEdges[i] = Add(rowEdges[i], edgeSteps[i]);
+            rowDepth = Add(rowDepth, depthStep);
+        }
+    }
+}
+
+void OcclusionBuffer::Resolve()
+{
+    for (unsigned int tileY = 0; tileY < m_numTiles.y; ++tileY)
+        for (unsigned int tileX = 0; tileX < m_numTiles.x; ++tileX)
+        {
+            auto maxDepth = Splat(std::numeric_limits<float>::lowest());
+            for (unsigned int y = 0; y < TileSize; ++y)
+            {
+                const float* row = m_depth.data() + static_cast<size_t>(tileY * TileSize + y) * m_size.x + tileX * TileSize;
+                for (unsigned int x = 0; x < TileSize; x += 4)
+                    maxDepth = Max(maxDepth, Load(row + x));
+            }
+
+            std::array<float, 4> lanes;
+            Store(lanes.data(), maxDepth);
+            m_tileMaxDepth[static_cast<size_t>(tileY) * m_numTiles.x + tileX] = std::ranges::max(lanes);
+        }
+}
+
+bool OcclusionBuffer::IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model) const
+{
+    const auto modelViewProjection = m_viewProjection * model;
+
+    glm::vec3 screenMin {std::numeric_limits<float>::max()}, screenMax {std::numeric_limits<float>::lowest()};
+    for (unsigned int corner = 0; corner < 8; ++corner)
+    {
+        const glm::vec3 position {corner & 1 ? boundsMax.x : boundsMin.x, corner & 2 ? boundsMax.y : boundsMin.y,
+                                  corner & 4 ? boundsMax.z : boundsMin.z};
+        const auto clip = modelViewProjection * glm::vec4 {position, 1.0f};
+        if (NearDistance(clip) < 0.0f)
+            return false;
+
+        const auto ndc = glm::vec3 {clip} / clip.w;
+        screenMin = glm::min(screenMin, ndc);
+        screenMax = glm::max(screenMax, ndc);
+    }
+
+    // every pixel the box touches, not only ones with covered centers
+    const auto size = glm::vec2 {m_size};
+    const auto pixelsMin = glm::max(glm::floor((glm::vec2 {screenMin} * 0.5f + 0.5f) * size), glm::vec2 {0.0f});
+    const auto pixelsMax = glm::min(glm::ceil((glm::vec2 {screenMax} * 0.5f + 0.5f) * size), size);
+    if (pixelsMin.x >= pixelsMax.x || pixelsMin.y >= pixelsMax.y)
+        return false;
+
+    const glm::uvec2 begin {pixelsMin}, end {pixelsMax};
+    const float nearestDepth = screenMin.z;
+
+    for (auto tileY = begin.y / TileSize; tileY <= (end.y - 1) / TileSize; ++tileY)
+        for (auto tileX = begin.x / TileSize; tileX <= (end.x - 1) / TileSize; ++tileX)
+        {
+            if (m_tileMaxDepth[static_cast<size_t>(tileY) * m_numTiles.x + tileX] < nearestDepth)
+                continue;
+
+            const glm::uvec2 tileBegin {tileX * TileSize, tileY * TileSize};
+            const auto rectBegin = glm::max(begin, tileBegin), rectEnd = glm::min(end, tileBegin + TileSize);
+
+            // the farthest pixel of the tile is inside of the box
+            if (rectBegin == tileBegin && rectEnd == tileBegin + TileSize)
+                return false;
+
+            for (auto y = rectBegin.y; y < rectEnd.y; ++y)
+                for (auto x = rectBegin.x; x < rectEnd.x; ++x)
+                    if (m_depth[static_cast<size_t>(y) * m_size.x + x] >= nearestDepth)
+                        return false;
+        }
+
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "AT2.h"
+
+#include <limits>
+
+namespace AT2
+{
+    // Coarse stand-in of a mesh used for occlusion, it must be inside of the surface it stands for, otherwise it hides
+    // objects which are actually visible.
+    struct OccluderMesh
+    {
+        std::vector<glm::vec3> Positions;
+        std::vector<uint32_t> Indices; // triangle list, counter-clockwise front faces
+
+        // Occluder of the triangles, only the referenced vertices are kept. Vertices are moved inward along their normals
+        // by the inset, so a proxy of a simplified mesh built with it's simplification error stays inside of the original
+        // surface. Throws AT2Exception when indices are out of range.
+        [[nodiscard]] static OccluderMesh Build(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, float inset = 0.0f);
+    };
+
+    // Low resolution depth buffer rasterized by CPU. Every frame it's cleared, the occluders are rendered into it, then
+    // bounds of objects are tested against it before they are drawn.
+    // Triangles are rasterized by rows of 4 pixels: SIMD edge functions give the coverage mask of the row, depths of the
+    // covered pixels are min-ed with the interpolated depth. Back faces are skipped and triangles are clipped by the near
+    // plane, so occluders close to the camera still work. Resolve builds maximum depths of tiles, tests read single pixels
+    // only at tiles which aren't decided by the tile depth.
+    // Depth is OpenGL normalized device depth, buffer rows go bottom to top like the viewport ones.
+    class OcclusionBuffer
+    {
+    public:
+        static constexpr unsigned int TileSize = 8;
+        static constexpr float ClearDepth = std::numeric_limits<float>::max();
+
+        // Size is rounded up to whole tiles
+        explicit OcclusionBuffer(glm::uvec2 size);
+
+        // Starts a new frame viewed by the matrix
+        void Clear(const glm::mat4& viewProjection);
+
+        void RenderOccluder(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, const glm::mat4& model);
+        void RenderOccluder(const OccluderMesh& occluder, const glm::mat4& model) { RenderOccluder(occluder.Positions, occluder.Indices, model); }
+
+        // Must be called after the occluders are rendered and before the tests
+        void Resolve();
+
+        // True if the box is entirely behind the occluders. Boxes crossing the near plane and ones out of the buffer aren't
+        // occluded, the latter are left to frustum culling. Thread-safe.
+        [[nodiscard]] bool IsOccluded(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model) const;
+
+        [[nodiscard]] glm::uvec2 GetSize() const noexcept { return m_size; }
+        [[nodiscard]] float GetDepth(unsigned int x, unsigned int y) const { return m_depth.at(y * m_size.x + x); }
+        [[nodiscard]] size_t GetNumRasterizedTriangles() const noexcept { return m_numRasterizedTriangles; }
+
+    private:
+        void RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+    private:
+        glm::uvec2 m_size;
+        glm::uvec2 m_numTiles;
+        glm::mat4 m_viewProjection {1.0f};
+
+        std::vector<float> m_depth;        // row-major
+        std::vector<float> m_tileMaxDepth; // row-major, valid after Resolve
+        std::vector<glm::vec4> m_clipPositions;
+        size_t m_numRasterizedTriangles = 0;
+    };
+
+} // namespace AT2
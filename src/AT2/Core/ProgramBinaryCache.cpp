@@ -0,0 +1,162 @@
+#include "ProgramBinaryCache.h"
+#include "Hashing.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+
+using namespace AT2;
+
+namespace
+{
+    constexpr std::array<char, 4> FileMagic {'A', 'T', '2', 'P'};
+    constexpr std::uint32_t FileVersion = 1;
+
+    // Binaries are hundreds of kilobytes at most, so anything bigger is a garbage
+    constexpr std::uint64_t MaxBinarySize = 256ull << 20;
+
+    template <typename T>
+    void WriteValue(std::ostream& stream, const T& value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool ReadValue(std::istream& stream, T& value)
+    {
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    std::uint64_t Checksum(std::span<const std::byte> data)
+    {
+        Fnv1a hash;
+        hash.Update(data);
+        return hash.Get();
+    }
+} // namespace
+
+ProgramBinaryCache::ProgramBinaryCache(std::filesystem::path directory, std::string driverSignature) :
+    m_directory {std::move(directory)}, m_driverSignature {std::move(driverSignature)}
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(m_directory, errorCode);
+}
+
+ProgramBinaryCache::Key ProgramBinaryCache::ComputeKey(std::span<const Stage> stages, std::string_view driverSignature)
+{
+    std::vector<Stage> sortedStages {stages.begin(), stages.end()};
+    std::ranges::sort(sortedStages, [](const Stage& lhs, const Stage& rhs) {
+        return std::tie(lhs.Type, lhs.Source) < std::tie(rhs.Type, rhs.Source);
+    });
+
+    // lengths are hashed too, so moving text between stages changes the key
+    Fnv1a hash;
+    for (const auto& stage : sortedStages)
+    {
+        hash.UpdateValue(stage.Type);
+        hash.UpdateValue(static_cast<std::uint64_t>(stage.Source.size()));
+        hash.Update(stage.Source);
+    }
+
+    hash.UpdateValue(static_cast<std::uint64_t>(driverSignature.size()));
+    hash.Update(driverSignature);
+
+    return hash.Get();
+}
+
+void ProgramBinaryCache::Write(std::ostream& stream, Key key, const Entry& entry)
+{
+    stream.write(FileMagic.data(), FileMagic.size());
+    WriteValue(stream, FileVersion);
+    WriteValue(stream, key);
+    WriteValue(stream, entry.BinaryFormat);
+    WriteValue(stream, static_cast<std::uint64_t>(entry.Data.size()));
+    WriteValue(stream, Checksum(entry.Data));
+    stream.write(reinterpret_cast<const char*>(entry.Data.data()), static_cast<std::streamsize>(entry.Data.size()));
+}
+
+std::optional<ProgramBinaryCache::Entry> ProgramBinaryCache::Read(std::istream& stream, Key expectedKey)
+{
+    std::array<char, 4> magic {};
+    std::uint32_t version = 0;
+    Key key = 0;
+    Entry entry;
+    std::uint64_t size = 0, checksum = 0;
+
+    if (!stream.read(magic.data(), magic.size()) || magic != FileMagic)
+        return std::nullopt;
+
+    if (!ReadValue(stream, version) || version != FileVersion)
+        return std::nullopt;
+
+    if (!ReadValue(stream, key) || key != expectedKey)
+        return std::nullopt;
+
+    if (!ReadValue(stream, entry.BinaryFormat) || !ReadValue(stream, size) || !ReadValue(stream, checksum))
+        return std::nullopt;
+
+    if (size == 0 || size > MaxBinarySize)
+        return std::nullopt;
+
+    entry.Data.resize(size);
+    if (!stream.read(reinterpret_cast<char*>(entry.Data.data()), static_cast<std::streamsize>(size)))
+        return std::nullopt;
+
+    if (Checksum(entry.Data) != checksum)
+        return std::nullopt;
+
+    return entry;
+}
+
+std::filesystem::path ProgramBinaryCache::GetEntryPath(Key key) const
+{
+    std::ostringstream filename;
+    filename << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return m_directory / filename.str();
+}
+
+std::optional<ProgramBinaryCache::Entry> ProgramBinaryCache::Load(Key key) const
+{
+    std::ifstream stream {GetEntryPath(key), std::ios::binary};
+    if (!stream.is_open())
+        return std::nullopt;
+
+    return Read(stream, key);
+}
+
+bool ProgramBinaryCache::Store(Key key, const Entry& entry) const
+{
+    const auto path = GetEntryPath(key);
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    {
+        std::ofstream stream {temporaryPath, std::ios::binary | std::ios::trunc};
+        if (!stream.is_open())
+            return false;
+
+        Write(stream, key, entry);
+        if (!stream.flush())
+            return false;
+    }
+
+    // readers never see partially written file
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryPath, path, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(temporaryPath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+void ProgramBinaryCache::Invalidate(Key key) const
+{
+    std::error_code errorCode;
+    std::filesystem::remove(GetEntryPath(key), errorCode);
+}
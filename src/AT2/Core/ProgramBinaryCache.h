@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AT2
+{
+    // On-disk storage of linked program binaries.
+    // Entries are keyed by a hash of all stage sources and a driver signature, so any change of the sources,
+    // driver or GPU just leads to cache miss. Cache is an optimization only: every failure is reported as miss.
+    class ProgramBinaryCache
+    {
+    public:
+        using Key = std::uint64_t;
+
+        struct Stage
+        {
+            std::uint32_t Type;
+            std::string_view Source;
+        };
+
+        struct Entry
+        {
+            std::uint32_t BinaryFormat = 0;
+            std::vector<std::byte> Data;
+        };
+
+        // driverSignature should identify driver version and device
+        ProgramBinaryCache(std::filesystem::path directory, std::string driverSignature);
+
+        // Stages order doesn't matter
+        [[nodiscard]] static Key ComputeKey(std::span<const Stage> stages, std::string_view driverSignature);
+        [[nodiscard]] Key ComputeKey(std::span<const Stage> stages) const { return ComputeKey(stages, m_driverSignature); }
+
+        // Serialization of a single entry, Read returns nullopt for corrupted, truncated or foreign data
+        static void Write(std::ostream& stream, Key key, const Entry& entry);
+        [[nodiscard]] static std::optional<Entry> Read(std::istream& stream, Key expectedKey);
+
+        [[nodiscard]] std::optional<Entry> Load(Key key) const;
+        bool Store(Key key, const Entry& entry) const;
+        // Removes entry, e.g. when driver refused to accept it
+        void Invalidate(Key key) const;
+
+        [[nodiscard]] const std::filesystem::path& GetDirectory() const noexcept { return m_directory; }
+        [[nodiscard]] std::filesystem::path GetEntryPath(Key key) const;
+
+    private:
+        std::filesystem::path m_directory;
+        std::string m_driverSignature;
+    };
+
+} // namespace AT2
@@ -0,0 +1,122 @@
+#include "RangeAllocator.h"
+
+#include <cassert>
+#include <stdexcept>
+
+using namespace AT2;
+
+namespace
+{
+    constexpr size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+}
+
+RangeAllocator::RangeAllocator(size_t capacity) : m_capacity {0}, m_freeSpace {0}
+{
+    Grow(capacity);
+}
+
+std::optional<RangeAllocator::Allocation> RangeAllocator::Allocate(size_t size, size_t alignment)
+{
+    if (size == 0 || alignment == 0)
+        throw std::invalid_argument("RangeAllocator: size and alignment must be positive");
+
+    for (auto it = m_freeBlocksBySize.lower_bound(size); it != m_freeBlocksBySize.end(); ++it)
+    {
+        const auto [blockSize, blockOffset] = *it;
+        const size_t alignedOffset = AlignUp(blockOffset, alignment);
+        const size_t padding = alignedOffset - blockOffset;
+        if (padding + size > blockSize)
+            continue;
+
+        EraseFreeBlock(m_freeBlocksByOffset.find(blockOffset));
+
+        if (padding > 0)
+            InsertFreeBlock(blockOffset, padding);
+        if (const size_t tailSize = blockSize - padding - size; tailSize > 0)
+            InsertFreeBlock(alignedOffset + size, tailSize);
+
+        m_freeSpace -= size;
+        return Allocation {alignedOffset, size};
+    }
+
+    return std::nullopt;
+}
+
+void RangeAllocator::Free(const Allocation& allocation)
+{
+    assert(allocation.Size > 0 && allocation.Offset + allocation.Size <= m_capacity);
+
+    size_t offset = allocation.Offset;
+    size_t size = allocation.Size;
+    m_freeSpace += size;
+
+    auto next = m_freeBlocksByOffset.lower_bound(offset);
+    assert(next == m_freeBlocksByOffset.end() || next->first >= offset + size); // double free
+
+    if (next != m_freeBlocksByOffset.begin())
+    {
+        const auto previous = std::prev(next);
+        assert(previous->first + previous->second <= offset); // double free
+
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            size += previous->second;
+            EraseFreeBlock(previous);
+        }
+    }
+
+    if (next != m_freeBlocksByOffset.end() && next->first == offset + size)
+    {
+        size += next->second;
+        EraseFreeBlock(next);
+    }
+
+    InsertFreeBlock(offset, size);
+}
+
+void RangeAllocator::Grow(size_t newCapacity)
+{
+    if (newCapacity <= m_capacity)
+        return;
+
+    const size_t oldCapacity = m_capacity;
+    m_capacity = newCapacity;
+    Free({oldCapacity, newCapacity - oldCapacity});
+}
+
+size_t RangeAllocator::GetLargestFreeBlock() const noexcept
+{
+    return m_freeBlocksBySize.empty() ? 0 : m_freeBlocksBySize.rbegin()->first;
+}
+
+double RangeAllocator::GetFragmentation() const noexcept
+{
+    if (m_freeSpace == 0)
+        return 0.0;
+
+    return 1.0 - static_cast<double>(GetLargestFreeBlock()) / static_cast<double>(m_freeSpace);
+}
+
+void RangeAllocator::InsertFreeBlock(size_t offset, size_t size)
+{
+    m_freeBlocksByOffset.emplace(offset, size);
+    m_freeBlocksBySize.emplace(size, offset);
+}
+
+void RangeAllocator::EraseFreeBlock(OffsetMap::iterator offsetIt)
+{
+    const auto [offset, size] = *offsetIt;
+
+    auto [first, last] = m_freeBlocksBySize.equal_range(size);
+    for (; first != last; ++first)
+    {
+        if (first->second == offset)
+        {
+            m_freeBlocksBySize.erase(first);
+            break;
+        }
+    }
+
+    m_freeBlocksByOffset.erase(offsetIt);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <map>
+#include <optional>
+
+namespace AT2
+{
+    // Best-fit free-list suballocator of the abstract [0, capacity) range, e.g. elements of a big GPU buffer.
+    // Adjacent free blocks are coalesced on deallocation.
+    class RangeAllocator
+    {
+    public:
+        struct Allocation
+        {
+            size_t Offset = 0;
+            size_t Size = 0;
+
+            friend bool operator==(const Allocation&, const Allocation&) = default;
+        };
+
+    public:
+        explicit RangeAllocator(size_t capacity);
+
+        // Returns nullopt if there is no free block large enough
+        [[nodiscard]] std::optional<Allocation> Allocate(size_t size, size_t alignment = 1);
+        void Free(const Allocation& allocation);
+
+        // Adds space to the end of the range, existing allocations stay valid
+        void Grow(size_t newCapacity);
+
+        [[nodiscard]] size_t GetCapacity() const noexcept { return m_capacity; }
+        [[nodiscard]] size_t GetFreeSpace() const noexcept { return m_freeSpace; }
+        [[nodiscard]] size_t GetLargestFreeBlock() const noexcept;
+        [[nodiscard]] size_t GetNumFreeBlocks() const noexcept { return m_freeBlocksByOffset.size(); }
+
+        // 0 when all free space is one block, close to 1 when it's scattered to small pieces
+        [[nodiscard]] double GetFragmentation() const noexcept;
+
+    private:
+        using OffsetMap = std::map<size_t, size_t>;
+        using SizeMap = std::multimap<size_t, size_t>;
+
+        void InsertFreeBlock(size_t offset, size_t size);
+        void EraseFreeBlock(OffsetMap::iterator offsetIt);
+
+    private:
+        size_t m_capacity;
+        size_t m_freeSpace;
+
+        OffsetMap m_freeBlocksByOffset; // offset -> size
+        SizeMap m_freeBlocksBySize;     // size -> offset
+    };
+
+} // namespace AT2
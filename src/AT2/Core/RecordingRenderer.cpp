@@ -0,0 +1,41 @@
+#include "RecordingRenderer.h"
+
+using namespace AT2;
+
+size_t RecordingRenderer::GetNumTriangles(const Primitives::Primitive& type, size_t count) noexcept
+{
+    const auto stripLength = [count](size_t firstTriangle, size_t step) { return count >= firstTriangle ? (count - firstTriangle) / step + 1 : 0; };
+
+    return std::visit(Utils::overloaded {
+        [&](const Primitives::Triangles&) { return count / 3; },
+        [&](const Primitives::TrianglesAdjacency&) { return count / 6; },
+        [&](const Primitives::TriangleStrip&) { return stripLength(3, 1); },
+        [&](const Primitives::TriangleFan&) { return stripLength(3, 1); },
+        [&](const Primitives::TriangleStripAdjacency&) { return stripLength(6, 2); },
+        [](const auto&) { return size_t {0}; }
+    }, type);
+}
+
+void RecordingRenderer::Draw(Primitives::Primitive type, size_t first, long int count, int numInstances, int baseVertex)
+{
+    Record(type, static_cast<size_t>(std::max(count, 0l)), static_cast<size_t>(std::max(numInstances, 0)));
+    ++m_statistics.NumDrawCalls;
+
+    m_renderer.Draw(std::move(type), first, count, numInstances, baseVertex);
+}
+
+void RecordingRenderer::MultiDrawIndexed(Primitives::Primitive type, std::span<const DrawElementsIndirectCommand> commands)
+{
+    for (const auto& command : commands)
+        Record(type, command.Count, command.InstanceCount);
+    ++m_statistics.NumDrawCalls;
+
+    m_renderer.MultiDrawIndexed(std::move(type), commands);
+}
+
+void RecordingRenderer::Record(const Primitives::Primitive& type, size_t count, size_t numInstances) noexcept
+{
+    ++m_statistics.NumCommands;
+    m_statistics.NumInstances += numInstances;
+    m_statistics.NumTriangles += GetNumTriangles(type, count) * numInstances;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "AT2.h"
+
+namespace AT2
+{
+    // Renderer decorator counting the submitted work, e.g. to measure the effect of levels of detail. Calls are forwarded
+    // to the wrapped renderer, statistics are accumulated until they are reset.
+    class RecordingRenderer : public IRenderer
+    {
+    public:
+        struct Statistics
+        {
+            size_t NumDrawCalls = 0; // multi-draw is one call
+            size_t NumCommands = 0;  // draws of all calls
+            size_t NumInstances = 0;
+            size_t NumTriangles = 0; // of all instances, patches aren't counted as their tessellation isn't known
+
+            Statistics& operator+=(const Statistics& other) noexcept
+            {
+                NumDrawCalls += other.NumDrawCalls;
+                NumCommands += other.NumCommands;
+                NumInstances += other.NumInstances;
+                NumTriangles += other.NumTriangles;
+                return *this;
+            }
+        };
+
+        explicit RecordingRenderer(IRenderer& renderer) noexcept : m_renderer {renderer} {}
+
+        void Draw(Primitives::Primitive type, size_t first, long int count, int numInstances = 1, int baseVertex = 0) override;
+        void MultiDrawIndexed(Primitives::Primitive type, std::span<const DrawElementsIndirectCommand> commands) override;
+        void SetViewport(const AABB2d& viewport) override { m_renderer.SetViewport(viewport); }
+        void SetScissorWindow(const AABB2d& viewport) override { m_renderer.SetScissorWindow(viewport); }
+
+        [[nodiscard]] IVisualizationSystem& GetVisualizationSystem() override { return m_renderer.GetVisualizationSystem(); }
+        [[nodiscard]] IStateManager& GetStateManager() override { return m_renderer.GetStateManager(); }
+
+        [[nodiscard]] const Statistics& GetStatistics() const noexcept { return m_statistics; }
+        void ResetStatistics() noexcept { m_statistics = {}; }
+
+        // Triangles assembled from count vertices, zero for points, lines and patches
+        [[nodiscard]] static size_t GetNumTriangles(const Primitives::Primitive& type, size_t count) noexcept;
+
+    private:
+        void Record(const Primitives::Primitive& type, size_t count, size_t numInstances) noexcept;
+
+    private:
+        IRenderer& m_renderer;
+        Statistics m_statistics;
+    };
+
+} // namespace AT2
@@ -0,0 +1,166 @@
+#include "AsyncTextureLoader.h"
+#include "TextureCache.h"
+
+#include "../ThreadPool.h"
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+struct AsyncTextureLoader::Request
+{
+    std::optional<std::filesystem::path> SourceFile;
+    ReadyCallback OnReady;
+    std::promise<TextureRef> Promise;
+
+    // found in the cache, nothing to decode
+    TextureRef Texture;
+
+    // filled by worker
+    std::optional<TextureCache::ContentHash> ContentHash;
+    std::optional<DecodedImage> Image;
+    std::exception_ptr Error;
+};
+
+AsyncTextureLoader::AsyncTextureLoader(IVisualizationSystem& renderer, ThreadPool& threadPool, TextureCache* cache) :
+    m_renderer {renderer}, m_threadPool {threadPool}, m_cache {cache}, m_uploadQueue {std::make_shared<UploadQueue>()}
+{
+}
+
+AsyncTextureLoader::~AsyncTextureLoader() = default;
+
+std::shared_future<TextureRef> AsyncTextureLoader::LoadTexture(std::filesystem::path path, ReadyCallback onReady)
+{
+    auto request = std::make_shared<Request>();
+    request->SourceFile = std::move(path);
+    request->OnReady = std::move(onReady);
+
+    if (m_cache)
+    {
+        if (auto texture = m_cache->Find(*request->SourceFile))
+        {
+            request->Texture = std::move(texture);
+            auto future = request->Promise.get_future().share();
+            EnqueueReady(std::move(request));
+            return future;
+        }
+    }
+
+    return Enqueue(request, [path = *request->SourceFile](Request&) { return TextureLoader::DecodeImage(path); });
+}
+
+std::shared_future<TextureRef> AsyncTextureLoader::LoadTexture(std::vector<std::byte> data, ReadyCallback onReady)
+{
+    auto request = std::make_shared<Request>();
+    request->OnReady = std::move(onReady);
+
+    return Enqueue(request, [data = std::move(data), needHash = m_cache != nullptr](Request& request) {
+        if (needHash)
+            request.ContentHash = TextureCache::ComputeHash(data);
+
+        return TextureLoader::DecodeImage(data);
+    });
+}
+
+std::shared_future<TextureRef> AsyncTextureLoader::Enqueue(std::shared_ptr<Request> request, std::function<DecodedImage(Request&)> decode)
+{
+    auto future = request->Promise.get_future().share();
+    ++m_numPending;
+
+    static_cast<void>(m_threadPool.Submit([request = std::move(request), decode = std::move(decode), weakQueue = std::weak_ptr {m_uploadQueue}] {
+        try
+        {
+            request->Image = decode(*request);
+        }
+        catch (...)
+        {
+            request->Error = std::current_exception();
+        }
+
+        if (const auto queue = weakQueue.lock())
+        {
+            std::scoped_lock lock {queue->Mutex};
+            queue->Requests.push_back(request);
+        }
+    }));
+
+    return future;
+}
+
+void AsyncTextureLoader::EnqueueReady(std::shared_ptr<Request> request)
+{
+    // goes through the queue anyway, so onReady is always called from ProcessUploads
+    ++m_numPending;
+
+    std::scoped_lock lock {m_uploadQueue->Mutex};
+    m_uploadQueue->Requests.push_back(std::move(request));
+}
+
+TextureRef AsyncTextureLoader::CreateTexture(Request& request)
+{
+    if (request.Texture)
+        return std::move(request.Texture);
+
+    if (request.Error)
+        std::rethrow_exception(request.Error);
+
+    // the same image could be requested again while this one was decoding
+    if (m_cache)
+    {
+        auto texture = request.SourceFile ? m_cache->Find(*request.SourceFile) : request.ContentHash ? m_cache->Find(*request.ContentHash) : nullptr;
+        if (texture)
+            return texture;
+    }
+
+    auto texture = TextureLoader::CreateTexture(m_renderer, *request.Image, request.SourceFile);
+    request.Image.reset();
+
+    if (m_cache)
+    {
+        if (request.SourceFile)
+            m_cache->Insert(*request.SourceFile, texture);
+        else if (request.ContentHash)
+            m_cache->Insert(*request.ContentHash, texture);
+    }
+
+    return texture;
+}
+
+size_t AsyncTextureLoader::ProcessUploads(std::chrono::microseconds budget)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    size_t numProcessed = 0;
+    while (numProcessed == 0 || std::chrono::steady_clock::now() - startTime < budget)
+    {
+        std::shared_ptr<Request> request;
+        {
+            std::scoped_lock lock {m_uploadQueue->Mutex};
+            if (m_uploadQueue->Requests.empty())
+                break;
+
+            request = std::move(m_uploadQueue->Requests.front());
+            m_uploadQueue->Requests.pop_front();
+        }
+
+        ++numProcessed;
+        --m_numPending;
+
+        const auto sourceName = request->SourceFile ? request->SourceFile->string() : std::string {"<memory>"};
+        try
+        {
+            auto texture = CreateTexture(*request);
+
+            if (request->OnReady)
+                request->OnReady(texture);
+
+            request->Promise.set_value(std::move(texture));
+        }
+        catch (const std::exception& exception)
+        {
+            Log::Error() << "Texture loading failed (" << sourceName << "): " << exception.what() << std::endl;
+            request->Promise.set_exception(std::current_exception());
+        }
+    }
+
+    return numProcessed;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "TextureLoader.h"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+
+namespace AT2
+{
+    class ThreadPool;
+}
+
+namespace AT2::Resources
+{
+    class TextureCache;
+
+    // Reads and decodes textures at the thread pool, uploads them at the render thread within a time budget per frame.
+    // Until texture is ready users are expected to bind some placeholder and replace it at onReady callback.
+    // With a cache, files already loaded aren't read again, and decoded images are checked against it before upload.
+    class AsyncTextureLoader
+    {
+    public:
+        using ReadyCallback = std::function<void(const TextureRef&)>;
+
+        AsyncTextureLoader(IVisualizationSystem& renderer, ThreadPool& threadPool, TextureCache* cache = nullptr);
+        ~AsyncTextureLoader();
+
+        AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+        AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+        // onReady is called from ProcessUploads, right before the future becomes ready. So the future shouldn't be waited
+        // at the render thread, it would never be ready. Failures are logged and passed by the future, onReady isn't called then.
+        std::shared_future<TextureRef> LoadTexture(std::filesystem::path path, ReadyCallback onReady = {});
+        std::shared_future<TextureRef> LoadTexture(std::vector<std::byte> data, ReadyCallback onReady = {});
+
+        // Must be called at render thread every frame. Uploads decoded textures until budget is exceeded,
+        // but at least one, so loading always advances. Returns number of processed textures
+        size_t ProcessUploads(std::chrono::microseconds budget);
+
+        // Textures being decoded or waiting for upload
+        [[nodiscard]] size_t GetNumPending() const noexcept { return m_numPending; }
+
+    private:
+        struct Request;
+        struct UploadQueue
+        {
+            std::mutex Mutex;
+            std::deque<std::shared_ptr<Request>> Requests;
+        };
+
+        std::shared_future<TextureRef> Enqueue(std::shared_ptr<Request> request, std::function<DecodedImage(Request&)> decode);
+        void EnqueueReady(std::shared_ptr<Request> request);
+        TextureRef CreateTexture(Request& request);
+
+    private:
+        IVisualizationSystem& m_renderer;
+        ThreadPool& m_threadPool;
+        TextureCache* m_cache;
+
+        // shared with tasks, which could outlive the loader
+        std::shared_ptr<UploadQueue> m_uploadQueue;
+        size_t m_numPending = 0;
+    };
+
+} // namespace AT2::Resources
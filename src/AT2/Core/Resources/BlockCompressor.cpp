@@ -0,0 +1,119 @@
+#include "BlockCompressor.h"
+
+#include "../ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    constexpr unsigned BlockSize = 4;
+
+    // one task compresses at least that many blocks
+    constexpr size_t MinBlocksPerTask = 1024;
+
+    void CompressBlock(unsigned char* destination, const std::array<glm::u8vec4, BlockSize * BlockSize>& block, BlockCompression compression)
+    {
+        static_assert(sizeof(glm::u8vec4) == 4);
+
+        switch (compression)
+        {
+        case BlockCompression::BC1:
+            stb_compress_dxt_block(destination, reinterpret_cast<const unsigned char*>(block.data()), 0, STB_DXT_HIGHQUAL);
+            break;
+
+        case BlockCompression::BC3:
+            stb_compress_dxt_block(destination, reinterpret_cast<const unsigned char*>(block.data()), 1, STB_DXT_HIGHQUAL);
+            break;
+
+        case BlockCompression::BC4:
+        {
+            std::array<unsigned char, BlockSize * BlockSize> red {};
+            for (size_t i = 0; i < block.size(); ++i)
+                red[i] = block[i].r;
+
+            stb_compress_bc4_block(destination, red.data());
+            break;
+        }
+
+        case BlockCompression::BC5:
+        {
+            std::array<unsigned char, BlockSize * BlockSize * 2> redGreen {};
+            for (size_t i = 0; i < block.size(); ++i)
+            {
+                redGreen[i * 2] = block[i].r;
+                redGreen[i * 2 + 1] = block[i].g;
+            }
+
+            stb_compress_bc5_block(destination, redGreen.data());
+            break;
+        }
+
+        default: assert(false);
+        }
+    }
+} // namespace
+
+bool BlockCompressor::IsSupported(BlockCompression compression) noexcept
+{
+    switch (compression)
+    {
+    case BlockCompression::BC1:
+    case BlockCompression::BC3:
+    case BlockCompression::BC4:
+    case BlockCompression::BC5: return true;
+    default: return false;
+    }
+}
+
+std::vector<std::byte> BlockCompressor::Compress(std::span<const glm::u8vec4> texels, glm::uvec2 size, BlockCompression compression,
+                                                 ThreadPool* threadPool)
+{
+    if (!IsSupported(compression))
+        throw AT2NotImplementedException("BlockCompressor: unsupported compression format");
+
+    if (texels.size() != size_t {size.x} * size.y || texels.empty())
+        throw AT2TextureException("BlockCompressor: image size doesn't match the data");
+
+    const glm::uvec2 numBlocks = (size + (BlockSize - 1)) / BlockSize;
+    const size_t blockLength = GetBlockLength(compression);
+
+    std::vector<std::byte> result(size_t {numBlocks.x} * numBlocks.y * blockLength);
+
+    const auto compressRows = [&](size_t begin, size_t end) {
+        std::array<glm::u8vec4, BlockSize * BlockSize> block;
+
+        for (size_t blockY = begin; blockY < end; ++blockY)
+        {
+            for (size_t blockX = 0; blockX < numBlocks.x; ++blockX)
+            {
+                for (unsigned y = 0; y < BlockSize; ++y)
+                {
+                    const size_t sourceY = std::min<size_t>(blockY * BlockSize + y, size.y - 1);
+                    for (unsigned x = 0; x < BlockSize; ++x)
+                    {
+                        const size_t sourceX = std::min<size_t>(blockX * BlockSize + x, size.x - 1);
+                        block[y * BlockSize + x] = texels[sourceY * size.x + sourceX];
+                    }
+                }
+
+                auto* destination = reinterpret_cast<unsigned char*>(result.data() + (blockY * numBlocks.x + blockX) * blockLength);
+                CompressBlock(destination, block, compression);
+            }
+        }
+    };
+
+    if (threadPool)
+        threadPool->ParallelFor(numBlocks.y, std::max<size_t>(MinBlocksPerTask / numBlocks.x, 1), compressRows);
+    else
+        compressRows(0, numBlocks.y);
+
+    return result;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <AT2.h>
+
+#include <span>
+#include <vector>
+
+namespace AT2
+{
+    class ThreadPool;
+}
+
+namespace AT2::Resources
+{
+    // Encodes RGBA8 images into BC1, BC3, BC4 (red) or BC5 (red and green) blocks. Values are encoded as is, so the same
+    // data could be used with sRGB formats. Partial blocks at the edges are padded by repeating the edge texels.
+    class BlockCompressor
+    {
+    public:
+        [[nodiscard]] static bool IsSupported(BlockCompression compression) noexcept;
+
+        // Rows of blocks are distributed between threadPool workers if it's given
+        [[nodiscard]] static std::vector<std::byte> Compress(std::span<const glm::u8vec4> texels, glm::uvec2 size, BlockCompression compression,
+                                                             ThreadPool* threadPool = nullptr);
+    };
+
+} // namespace AT2::Resources
@@ -0,0 +1,563 @@
+#include "CookedScene.h"
+
+#include <AT2_exceptions.hpp>
+#include <MappedFile.h>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    constexpr std::array<char, 4> FileMagic {'A', 'T', '2', 'S'};
+
+    struct Header
+    {
+        std::array<char, 4> Magic = FileMagic;
+        std::uint32_t Version = CookedScene::Version;
+        std::uint64_t MetadataSize = 0;
+        std::uint64_t DataOffset = 0;
+        std::uint64_t DataSize = 0;
+    };
+    static_assert(sizeof(Header) == 32 && std::has_unique_object_representations_v<Header>);
+
+    constexpr size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Variant alternatives by their index, so chunks are stored as a number
+    Primitives::Primitive MakePrimitive(std::uint8_t index, std::int32_t numControlPoints)
+    {
+        using namespace Primitives;
+        switch (index)
+        {
+        case 0: return Points {};
+        case 1: return LineStrip {};
+        case 2: return LineLoop {};
+        case 3: return Lines {};
+        case 4: return LineStripAdjacency {};
+        case 5: return LinesAdjacency {};
+        case 6: return TriangleStrip {};
+        case 7: return TriangleFan {};
+        case 8: return Triangles {};
+        case 9: return TriangleStripAdjacency {};
+        case 10: return TrianglesAdjacency {};
+        case 11:
+            if (numControlPoints <= 0)
+                throw AT2IOException("cooked scene has patches without control points");
+            return Patches {numControlPoints};
+        default: throw AT2IOException("cooked scene has unknown primitive type");
+        }
+    }
+
+    // Enums are stored by their values, ones after the last enumerator are garbage
+    template <typename T>
+    requires std::is_enum_v<T>
+    T ToEnum(std::underlying_type_t<T> value, T last)
+    {
+        if (static_cast<std::uint64_t>(value) > static_cast<std::uint64_t>(last))
+            throw AT2IOException("cooked scene has unknown enumeration value");
+
+        return static_cast<T>(value);
+    }
+
+    // Serialization of metadata, values are written in the native byte order
+
+    class Writer
+    {
+    public:
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        void Write(const T& value)
+        {
+            const auto bytes = std::as_bytes(std::span {&value, 1});
+            m_data.insert(m_data.end(), bytes.begin(), bytes.end());
+        }
+
+        void Write(std::string_view value)
+        {
+            Write(static_cast<std::uint32_t>(value.size()));
+            const auto bytes = std::as_bytes(std::span {value});
+            m_data.insert(m_data.end(), bytes.begin(), bytes.end());
+        }
+
+        [[nodiscard]] std::vector<std::byte>& GetData() noexcept { return m_data; }
+
+    private:
+        std::vector<std::byte> m_data;
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(std::span<const std::byte> data) : m_data {data} {}
+
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        T Read()
+        {
+            T value;
+            std::memcpy(&value, Take(sizeof(T)).data(), sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        requires std::is_enum_v<T>
+        T ReadEnum(T last)
+        {
+            return ToEnum(Read<std::underlying_type_t<T>>(), last);
+        }
+
+        std::string ReadString()
+        {
+            const auto bytes = Take(Read<std::uint32_t>());
+            return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+        }
+
+        // Every element takes at least a byte, so bigger sizes are garbage
+        size_t ReadSize()
+        {
+            const auto size = Read<std::uint32_t>();
+            if (size > m_data.size() - m_offset)
+                throw AT2IOException("cooked scene is corrupted");
+
+            return size;
+        }
+
+        [[nodiscard]] bool IsFinished() const noexcept { return m_offset == m_data.size(); }
+
+    private:
+        std::span<const std::byte> Take(size_t size)
+        {
+            if (size > m_data.size() - m_offset)
+                throw AT2IOException("cooked scene is truncated");
+
+            const auto result = m_data.subspan(m_offset, size);
+            m_offset += size;
+            return result;
+        }
+
+    private:
+        std::span<const std::byte> m_data;
+        size_t m_offset = 0;
+    };
+
+    template <typename T, typename Func>
+    void WriteVector(Writer& writer, const std::vector<T>& values, Func&& writeElement)
+    {
+        writer.Write(static_cast<std::uint32_t>(values.size()));
+        for (const auto& value : values)
+            writeElement(writer, value);
+    }
+
+    template <typename T, typename Func>
+    std::vector<T> ReadVector(Reader& reader, Func&& readElement)
+    {
+        // elements aren't assigned, as MeshChunk isn't assignable
+        const auto size = reader.ReadSize();
+        std::vector<T> result;
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            result.push_back(readElement(reader));
+
+        return result;
+    }
+
+    template <typename T>
+    void WriteValues(Writer& writer, const std::vector<T>& values)
+    {
+        WriteVector(writer, values, [](Writer& w, const T& value) { w.Write(value); });
+    }
+
+    template <typename T>
+    std::vector<T> ReadValues(Reader& reader)
+    {
+        return ReadVector<T>(reader, [](Reader& r) { return r.Read<T>(); });
+    }
+
+    void WriteRange(Writer& writer, const CookedScene::Range& range)
+    {
+        writer.Write(range.Offset);
+        writer.Write(range.Size);
+    }
+
+    CookedScene::Range ReadRange(Reader& reader)
+    {
+        CookedScene::Range range;
+        range.Offset = reader.Read<std::uint64_t>();
+        range.Size = reader.Read<std::uint64_t>();
+        return range;
+    }
+
+    void WriteTexture(Writer& writer, const CookedScene::Texture& texture)
+    {
+        writer.Write(texture.Path.generic_string());
+        WriteRange(writer, texture.EmbeddedData);
+
+        writer.Write(static_cast<std::uint8_t>(texture.Sampler.has_value()));
+        if (const auto& sampler = texture.Sampler)
+        {
+            const auto& [minification, mipmapping] = sampler->Sampling.Minification;
+            writer.Write(std::array {static_cast<std::uint8_t>(sampler->Wrap.WrapS), static_cast<std::uint8_t>(sampler->Wrap.WrapT),
+                                     static_cast<std::uint8_t>(sampler->Wrap.WrapR), static_cast<std::uint8_t>(sampler->Sampling.Magnification),
+                                     static_cast<std::uint8_t>(minification), static_cast<std::uint8_t>(mipmapping)});
+        }
+    }
+
+    CookedScene::Texture ReadTexture(Reader& reader)
+    {
+        CookedScene::Texture texture;
+        texture.Path = reader.ReadString();
+        texture.EmbeddedData = ReadRange(reader);
+
+        if (reader.Read<std::uint8_t>())
+        {
+            const auto values = reader.Read<std::array<std::uint8_t, 6>>();
+            auto& sampler = texture.Sampler.emplace();
+            constexpr auto LastWrapMode = TextureWrapMode::MirrorClampToEdge;
+            sampler.Wrap = {ToEnum(values[0], LastWrapMode), ToEnum(values[1], LastWrapMode), ToEnum(values[2], LastWrapMode)};
+            sampler.Sampling = {ToEnum(values[3], TextureSamplingMode::Linear),
+                                {ToEnum(values[4], TextureSamplingMode::Linear), ToEnum(values[5], MipmapSamplingMode::Linear)}};
+        }
+
+        return texture;
+    }
+
+    void WriteMaterial(Writer& writer, const CookedScene::Material& material)
+    {
+        WriteVector(writer, material.Textures, [](Writer& w, const CookedScene::MaterialTexture& texture) {
+            w.Write(texture.UniformName);
+            w.Write(texture.Texture);
+            w.Write(static_cast<std::uint8_t>(texture.Fallback.has_value()));
+            if (texture.Fallback)
+                w.Write(*texture.Fallback);
+        });
+    }
+
+    CookedScene::Material ReadMaterial(Reader& reader)
+    {
+        CookedScene::Material material;
+        material.Textures = ReadVector<CookedScene::MaterialTexture>(reader, [](Reader& r) {
+            CookedScene::MaterialTexture texture;
+            texture.UniformName = r.ReadString();
+            texture.Texture = r.Read<std::int32_t>();
+            if (r.Read<std::uint8_t>())
+                texture.Fallback = r.Read<glm::vec4>();
+            return texture;
+        });
+
+        return material;
+    }
+
+    void WriteChunks(Writer& writer, const std::vector<MeshChunk>& chunks)
+    {
+        WriteVector(writer, chunks, [](Writer& w, const MeshChunk& chunk) {
+            const auto* patches = std::get_if<Primitives::Patches>(&chunk.Type);
+            w.Write(static_cast<std::uint8_t>(chunk.Type.index()));
+            w.Write(static_cast<std::int32_t>(patches ? patches->NumControlPoints : 0));
+            w.Write(chunk.StartElement);
+            w.Write(chunk.Count);
+            w.Write(chunk.BaseVertex);
+        });
+    }
+
+    std::vector<MeshChunk> ReadChunks(Reader& reader)
+    {
+        return ReadVector<MeshChunk>(reader, [](Reader& r) {
+            const auto type = r.Read<std::uint8_t>();
+            const auto numControlPoints = r.Read<std::int32_t>();
+
+            MeshChunk chunk {MakePrimitive(type, numControlPoints)};
+            chunk.StartElement = r.Read<unsigned int>();
+            chunk.Count = r.Read<unsigned int>();
+            chunk.BaseVertex = r.Read<int>();
+            return chunk;
+        });
+    }
+
+    void WriteMesh(Writer& writer, const CookedScene::Mesh& mesh)
+    {
+        writer.Write(mesh.Name);
+        WriteVector(writer, mesh.Attributes, [](Writer& w, const VertexPacker::PackedAttribute& attribute) {
+            const auto& params = attribute.BindingParams;
+            w.Write(attribute.AttributeIndex);
+            w.Write(params.Type);
+            w.Write(params.Count);
+            w.Write(params.Stride);
+            w.Write(params.Offset);
+            w.Write(static_cast<std::uint8_t>(params.IsNormalized));
+            w.Write(params.Divisor);
+        });
+        WriteRange(writer, mesh.Vertices);
+
+        writer.Write(static_cast<std::uint8_t>(mesh.IndexType.has_value()));
+        if (mesh.IndexType)
+            writer.Write(*mesh.IndexType);
+        WriteRange(writer, mesh.Indices);
+
+        WriteValues(writer, mesh.Materials);
+        WriteVector(writer, mesh.SubMeshes, [](Writer& w, const CookedScene::SubMesh& subMesh) {
+            w.Write(subMesh.Name);
+            w.Write(subMesh.MaterialIndex);
+            WriteChunks(w, subMesh.Chunks);
+            WriteVector(w, subMesh.Lods, [](Writer& lodWriter, const CookedScene::Lod& lod) {
+                lodWriter.Write(lod.Error);
+                WriteChunks(lodWriter, lod.Chunks);
+            });
+            WriteValues(w, subMesh.Meshlets);
+        });
+    }
+
+    CookedScene::Mesh ReadMesh(Reader& reader)
+    {
+        CookedScene::Mesh mesh;
+        mesh.Name = reader.ReadString();
+        mesh.Attributes = ReadVector<VertexPacker::PackedAttribute>(reader, [](Reader& r) {
+            VertexPacker::PackedAttribute attribute {};
+            auto& params = attribute.BindingParams;
+            attribute.AttributeIndex = r.Read<unsigned int>();
+            params.Type = r.ReadEnum(BufferDataType::Int2101010Rev);
+            params.Count = r.Read<unsigned char>();
+            params.Stride = r.Read<unsigned int>();
+            params.Offset = r.Read<unsigned int>();
+            params.IsNormalized = r.Read<std::uint8_t>() != 0;
+            params.Divisor = r.Read<unsigned int>();
+            return attribute;
+        });
+        mesh.Vertices = ReadRange(reader);
+
+        if (reader.Read<std::uint8_t>())
+        {
+            const auto indexType = reader.ReadEnum(BufferDataType::Int2101010Rev);
+            if (indexType != BufferDataType::UByte && indexType != BufferDataType::UShort && indexType != BufferDataType::UInt)
+                throw AT2IOException("cooked scene has unsupported index type");
+
+            mesh.IndexType = indexType;
+        }
+        mesh.Indices = ReadRange(reader);
+
+        mesh.Materials = ReadValues<std::uint32_t>(reader);
+        mesh.SubMeshes = ReadVector<CookedScene::SubMesh>(reader, [](Reader& r) {
+            CookedScene::SubMesh subMesh;
+            subMesh.Name = r.ReadString();
+            subMesh.MaterialIndex = r.Read<std::uint32_t>();
+            subMesh.Chunks = ReadChunks(r);
+            subMesh.Lods = ReadVector<CookedScene::Lod>(r, [](Reader& lodReader) {
+                CookedScene::Lod lod;
+                lod.Error = lodReader.Read<float>();
+                lod.Chunks = ReadChunks(lodReader);
+                return lod;
+            });
+            subMesh.Meshlets = ReadValues<Meshlet>(r);
+            return subMesh;
+        });
+
+        return mesh;
+    }
+
+    void WriteNode(Writer& writer, const CookedScene::Node& node)
+    {
+        writer.Write(node.Name);
+        writer.Write(node.Parent);
+        writer.Write(node.Transform);
+        WriteVector(writer, node.Meshes, [](Writer& w, const CookedScene::MeshInstance& instance) {
+            w.Write(instance.Mesh);
+            WriteValues(w, instance.SubMeshes);
+        });
+        writer.Write(node.Skin);
+    }
+
+    CookedScene::Node ReadNode(Reader& reader)
+    {
+        CookedScene::Node node;
+        node.Name = reader.ReadString();
+        node.Parent = reader.Read<std::int32_t>();
+        node.Transform = reader.Read<glm::mat4>();
+        node.Meshes = ReadVector<CookedScene::MeshInstance>(reader, [](Reader& r) {
+            CookedScene::MeshInstance instance;
+            instance.Mesh = r.Read<std::uint32_t>();
+            instance.SubMeshes = ReadValues<std::uint32_t>(r);
+            return instance;
+        });
+        node.Skin = reader.Read<std::int32_t>();
+        return node;
+    }
+
+    void WriteSkin(Writer& writer, const CookedScene::Skin& skin)
+    {
+        WriteRange(writer, skin.InverseBindMatrices);
+        WriteValues(writer, skin.Joints);
+    }
+
+    CookedScene::Skin ReadSkin(Reader& reader)
+    {
+        CookedScene::Skin skin;
+        skin.InverseBindMatrices = ReadRange(reader);
+        skin.Joints = ReadValues<std::uint32_t>(reader);
+        return skin;
+    }
+
+    void WriteAnimation(Writer& writer, const CookedScene::Animation& animation)
+    {
+        writer.Write(animation.Name);
+        WriteVector(writer, animation.Tracks, [](Writer& w, const CookedScene::Track& track) {
+            w.Write(track.Node);
+            w.Write(track.Target);
+            w.Write(track.Mode);
+            WriteRange(w, track.Keys);
+            WriteRange(w, track.Values);
+        });
+    }
+
+    CookedScene::Animation ReadAnimation(Reader& reader)
+    {
+        CookedScene::Animation animation;
+        animation.Name = reader.ReadString();
+        animation.Tracks = ReadVector<CookedScene::Track>(reader, [](Reader& r) {
+            CookedScene::Track track;
+            track.Node = r.Read<std::uint32_t>();
+            track.Target = r.ReadEnum(CookedScene::TrackTarget::Scale);
+            track.Mode = r.ReadEnum(CookedScene::Interpolation::CubicSpline);
+            track.Keys = ReadRange(r);
+            track.Values = ReadRange(r);
+            return track;
+        });
+
+        return animation;
+    }
+} // namespace
+
+CookedScene CookedScene::Load(const std::filesystem::path& path)
+{
+    auto file = std::make_shared<MappedFile>(path);
+    const auto data = file->GetData();
+
+    auto scene = Deserialize(data, std::move(file));
+
+    const auto baseDirectory = path.parent_path();
+    for (auto& texture : scene.Textures)
+        if (!texture.Path.empty())
+            texture.Path = (baseDirectory / texture.Path).lexically_normal();
+
+    return scene;
+}
+
+void CookedScene::Save(const std::filesystem::path& path) const
+{
+    // textures are referenced relative to the file, so cooked scenes could be moved along with their sources
+    auto scene = *this;
+    const auto baseDirectory = std::filesystem::absolute(path).parent_path();
+    for (auto& texture : scene.Textures)
+        if (!texture.Path.empty())
+            if (auto relativePath = std::filesystem::absolute(texture.Path).lexically_relative(baseDirectory); !relativePath.empty())
+                texture.Path = std::move(relativePath);
+
+    const auto file = scene.Serialize();
+
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream stream {temporaryPath, std::ios::binary | std::ios::trunc};
+        if (!stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size())))
+            throw AT2IOException("can't write cooked scene '" + temporaryPath.string() + "'");
+    }
+
+    // readers never see partially written file
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryPath, path, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(temporaryPath, errorCode);
+        throw AT2IOException("can't write cooked scene '" + path.string() + "'");
+    }
+}
+
+std::vector<std::byte> CookedScene::Serialize() const
+{
+    Writer writer;
+    writer.Write(Header {});
+
+    WriteVector(writer, Textures, WriteTexture);
+    WriteVector(writer, Materials, WriteMaterial);
+    WriteVector(writer, Meshes, WriteMesh);
+    WriteVector(writer, Nodes, WriteNode);
+    WriteVector(writer, Skins, WriteSkin);
+    WriteVector(writer, Animations, WriteAnimation);
+
+    auto& file = writer.GetData();
+
+    Header header;
+    header.MetadataSize = file.size() - sizeof(Header);
+    header.DataOffset = AlignUp(file.size(), DataAlignment);
+    header.DataSize = m_data.size();
+    std::memcpy(file.data(), &header, sizeof(Header));
+
+    file.resize(header.DataOffset);
+    file.insert(file.end(), m_data.begin(), m_data.end());
+    return std::move(file);
+}
+
+CookedScene CookedScene::Deserialize(std::span<const std::byte> file, std::shared_ptr<const void> owner)
+{
+    Header header;
+    if (file.size() < sizeof(Header))
+        throw AT2IOException("cooked scene is truncated");
+
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (header.Magic != FileMagic)
+        throw AT2IOException("file is not a cooked scene");
+    if (header.Version != Version)
+        throw AT2IOException("cooked scene has version " + std::to_string(header.Version) + ", but " + std::to_string(Version) +
+                             " is expected, it should be cooked again");
+
+    if (header.MetadataSize > file.size() - sizeof(Header) || header.DataOffset < sizeof(Header) + header.MetadataSize ||
+        header.DataOffset > file.size() || header.DataSize > file.size() - header.DataOffset)
+        throw AT2IOException("cooked scene is truncated");
+
+    CookedScene scene;
+    scene.m_data = file.subspan(header.DataOffset, header.DataSize);
+    scene.m_dataOwner = std::move(owner);
+
+    Reader reader {file.subspan(sizeof(Header), header.MetadataSize)};
+    scene.Textures = ReadVector<Texture>(reader, ReadTexture);
+    scene.Materials = ReadVector<Material>(reader, ReadMaterial);
+    scene.Meshes = ReadVector<Mesh>(reader, ReadMesh);
+    scene.Nodes = ReadVector<Node>(reader, ReadNode);
+    scene.Skins = ReadVector<Skin>(reader, ReadSkin);
+    scene.Animations = ReadVector<Animation>(reader, ReadAnimation);
+
+    if (!reader.IsFinished())
+        throw AT2IOException("cooked scene is corrupted");
+
+    return scene;
+}
+
+CookedScene::Range CookedScene::AppendData(std::span<const std::byte> data)
+{
+    if (!m_ownedData)
+    {
+        m_ownedData = std::make_shared<std::vector<std::byte>>(m_data.begin(), m_data.end());
+        m_dataOwner = m_ownedData;
+    }
+
+    auto& blob = *m_ownedData;
+    blob.resize(AlignUp(blob.size(), DataAlignment));
+
+    const Range range {blob.size(), data.size()};
+    blob.insert(blob.end(), data.begin(), data.end());
+    m_data = blob;
+
+    return range;
+}
+
+std::span<const std::byte> CookedScene::GetData(Range range) const
+{
+    if (range.Offset > m_data.size() || range.Size > m_data.size() - range.Offset)
+        throw AT2IOException("cooked scene range is out of the data");
+
+    return m_data.subspan(range.Offset, range.Size);
+}
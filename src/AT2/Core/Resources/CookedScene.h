@@ -0,0 +1,161 @@
+#pragma once
+
+#include <Mesh.h>
+#include <MeshletSet.h>
+#include <VertexPacker.h>
+#include "TextureCache.h"
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+namespace AT2::Resources
+{
+    // Scene which was already processed by one of loaders: node transforms are baked into matrices, geometry is optimized
+    // and interleaved in the GPU layout, materials refer to textures by index. Bulk data (vertices, indices, animation
+    // tracks, embedded images) lives in one blob referenced by Range, metadata is small.
+    // Scene is stored in a versioned binary file, which is mapped on load, so buffers and animation tracks are created
+    // right from the file data. See CookedSceneLoader for building a scene graph of it.
+    class CookedScene
+    {
+    public:
+        static constexpr std::uint32_t Version = 3;
+        static constexpr size_t DataAlignment = 16;
+
+        // Bytes of the data blob
+        struct Range
+        {
+            std::uint64_t Offset = 0;
+            std::uint64_t Size = 0;
+        };
+
+        struct Texture
+        {
+            std::filesystem::path Path; // absolute in memory, relative to the scene file on the disk
+            Range EmbeddedData;         // encoded image, used when Path is empty
+            std::optional<TextureCache::SamplerState> Sampler;
+        };
+
+        struct MaterialTexture
+        {
+            std::string UniformName;
+            std::int32_t Texture = -1;
+            std::optional<glm::vec4> Fallback; // color of a placeholder which is used if there is no texture
+        };
+
+        struct Material
+        {
+            std::vector<MaterialTexture> Textures;
+        };
+
+        // Coarser level of the submesh, chunks refer to other ranges of the mesh indices
+        struct Lod
+        {
+            float Error = 0.0f; // object-space distance from the full detail surface
+            std::vector<MeshChunk> Chunks;
+        };
+
+        struct SubMesh
+        {
+            std::string Name;
+            std::uint32_t MaterialIndex = 0; // within Mesh::Materials
+            std::vector<MeshChunk> Chunks;
+            std::vector<Lod> Lods; // by increasing error
+            std::vector<Meshlet> Meshlets; // clusters of Chunks, placed to their ranges of the mesh indices
+        };
+
+        struct Mesh
+        {
+            std::string Name;
+            // interleaved vertices, Stride of every attribute is the vertex size
+            std::vector<VertexPacker::PackedAttribute> Attributes;
+            Range Vertices;
+            std::optional<BufferDataType> IndexType;
+            Range Indices;
+            std::vector<std::uint32_t> Materials; // scene materials
+            std::vector<SubMesh> SubMeshes;
+        };
+
+        struct MeshInstance
+        {
+            std::uint32_t Mesh = 0;
+            std::vector<std::uint32_t> SubMeshes;
+        };
+
+        struct Node
+        {
+            std::string Name;
+            std::int32_t Parent = -1; // parents always go before their children
+            glm::mat4 Transform {1.0f};
+            std::vector<MeshInstance> Meshes;
+            std::int32_t Skin = -1;
+        };
+
+        struct Skin
+        {
+            Range InverseBindMatrices;
+            std::vector<std::uint32_t> Joints; // nodes
+        };
+
+        enum class TrackTarget : std::uint8_t
+        {
+            Translation,
+            Rotation,
+            Scale
+        };
+
+        enum class Interpolation : std::uint8_t
+        {
+            Step,
+            Linear,
+            CubicSpline
+        };
+
+        struct Track
+        {
+            std::uint32_t Node = 0;
+            TrackTarget Target = TrackTarget::Translation;
+            Interpolation Mode = Interpolation::Linear;
+            Range Keys;   // floats
+            Range Values; // vec3 or quat, tangents are included for cubic splines
+        };
+
+        struct Animation
+        {
+            std::string Name;
+            std::vector<Track> Tracks;
+        };
+
+    public:
+        // Throws AT2IOException if the file can't be read or it's of other version
+        [[nodiscard]] static CookedScene Load(const std::filesystem::path& path);
+        void Save(const std::filesystem::path& path) const;
+
+        // File image, texture paths are kept as is
+        [[nodiscard]] static CookedScene Deserialize(std::span<const std::byte> file, std::shared_ptr<const void> owner);
+        [[nodiscard]] std::vector<std::byte> Serialize() const;
+
+        // Copies data to the end of the blob
+        Range AppendData(std::span<const std::byte> data);
+
+        [[nodiscard]] std::span<const std::byte> GetData() const noexcept { return m_data; }
+        // Throws AT2IOException if the range is out of the blob
+        [[nodiscard]] std::span<const std::byte> GetData(Range range) const;
+        // Keeps the blob alive, e.g. for animation tracks referencing it
+        [[nodiscard]] const std::shared_ptr<const void>& GetDataOwner() const noexcept { return m_dataOwner; }
+
+    public:
+        std::vector<Node> Nodes;
+        std::vector<Mesh> Meshes;
+        std::vector<Material> Materials;
+        std::vector<Texture> Textures;
+        std::vector<Skin> Skins;
+        std::vector<Animation> Animations;
+
+    private:
+        std::span<const std::byte> m_data;
+        std::shared_ptr<const void> m_dataOwner;
+        std::shared_ptr<std::vector<std::byte>> m_ownedData; // while the scene is being cooked
+    };
+
+} // namespace AT2::Resources
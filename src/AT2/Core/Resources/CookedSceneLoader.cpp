@@ -0,0 +1,478 @@
+#include "CookedSceneLoader.h"
+
+#include <glm/packing.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+
+#include <Scene/Animation.h>
+#include "CookedScene.h"
+#include "TextureCache.h"
+#include "TextureLoader.h"
+
+using namespace AT2;
+using namespace AT2::Scene;
+using namespace AT2::Resources;
+
+namespace
+{
+    constexpr Animation::InterpolationMode TranslateInterpolationMode(CookedScene::Interpolation interpolation)
+    {
+        using Interpolation = CookedScene::Interpolation;
+        switch (interpolation)
+        {
+        case Interpolation::Step: return Animation::Step {};
+        case Interpolation::Linear: return Animation::Linear {};
+        case Interpolation::CubicSpline: return Animation::CubicSpline {};
+        }
+
+        throw AT2IOException("cooked scene has unknown interpolation mode");
+    }
+
+    // Indices of the cooked scene aren't trusted
+    template <typename T>
+    const T& At(const std::vector<T>& values, size_t index)
+    {
+        if (index >= values.size())
+            throw AT2IOException("cooked scene is corrupted: index is out of range");
+
+        return values[index];
+    }
+
+    // Both cookers bind positions at this attribute
+    constexpr unsigned int PositionAttributeIndex = 1;
+    // Occluders are rasterized by CPU, so submeshes which are more detailed even at the coarsest level don't get them
+    constexpr size_t MaxOccluderTriangles = 1024;
+
+    size_t GetElementSize(const BufferBindingParams& bindingParams)
+    {
+        const auto componentSize = BufferDataTypes::GetSizeOf(bindingParams.Type);
+        return bindingParams.Type == BufferDataType::Int2101010Rev ? componentSize : componentSize * bindingParams.Count;
+    }
+
+    // Attributes are interleaved, so all of them must be within the vertex of the same size
+    size_t GetNumVertices(const CookedScene::Mesh& mesh)
+    {
+        if (mesh.Attributes.empty())
+            return 0;
+
+        const auto stride = mesh.Attributes.front().BindingParams.Stride;
+        for (const auto& [attributeIndex, bindingParams] : mesh.Attributes)
+            if (stride == 0 || bindingParams.Stride != stride || bindingParams.Offset + GetElementSize(bindingParams) > stride)
+                throw AT2IOException("cooked scene is corrupted: vertex attribute is out of the vertex");
+
+        return mesh.Vertices.Size / stride;
+    }
+
+    // Binding params must be checked by GetNumVertices
+    std::vector<glm::vec3> ReadPositions(std::span<const std::byte> vertices, const BufferBindingParams& bindingParams)
+    {
+        std::vector<glm::vec3> positions(vertices.size() / bindingParams.Stride);
+        for (size_t i = 0; i < positions.size(); ++i)
+            positions[i] = glm::vec3 {VertexPacker::ReadElement(bindingParams, vertices.data() + i * bindingParams.Stride + bindingParams.Offset)};
+
+        return positions;
+    }
+
+    uint32_t ReadIndex(std::span<const std::byte> indices, BufferDataType indexType, size_t element)
+    {
+        const auto indexSize = BufferDataTypes::GetSizeOf(indexType);
+        if ((element + 1) * indexSize > indices.size())
+            throw AT2IOException("cooked scene is corrupted: index is out of range");
+
+        const auto* data = indices.data() + element * indexSize;
+        switch (indexType)
+        {
+        case BufferDataType::UByte: return std::to_integer<uint32_t>(*data);
+        case BufferDataType::UShort:
+        {
+            std::uint16_t index;
+            std::memcpy(&index, data, sizeof(index));
+            return index;
+        }
+        case BufferDataType::UInt:
+        {
+            std::uint32_t index;
+            std::memcpy(&index, data, sizeof(index));
+            return index;
+        }
+        default: throw AT2IOException("cooked scene has unsupported index type");
+        }
+    }
+
+    // Chunks and meshlets are checked before the GPU reads them, so every vertex they draw must be within the vertex buffer
+    void CheckRange(const CookedScene::Mesh& mesh, std::span<const std::byte> indices, size_t numVertices, size_t first, size_t count,
+                    std::int64_t baseVertex)
+    {
+        if (!mesh.IndexType)
+        {
+            if (first + count > numVertices)
+                throw AT2IOException("cooked scene is corrupted: vertex range is out of the vertex buffer");
+            return;
+        }
+
+        if ((first + count) * BufferDataTypes::GetSizeOf(*mesh.IndexType) > indices.size())
+            throw AT2IOException("cooked scene is corrupted: index range is out of the index buffer");
+
+        for (size_t element = first; element < first + count; ++element)
+            if (const auto index = std::int64_t {ReadIndex(indices, *mesh.IndexType, element)} + baseVertex;
+                index < 0 || static_cast<size_t>(index) >= numVertices)
+                throw AT2IOException("cooked scene is corrupted: vertex index is out of range");
+    }
+
+    class Builder
+    {
+    public:
+        Builder(IVisualizationSystem& renderer, const CookedScene& scene, TextureCache* textureCache)
+            : m_renderer {renderer}
+            , m_scene {scene}
+            , m_textureCache {textureCache}
+            , m_textures(scene.Textures.size())
+            , m_occluders(scene.Meshes.size())
+        {
+        }
+
+        NodeRef Build()
+        {
+            m_meshes.reserve(m_scene.Meshes.size());
+            for (const auto& mesh : m_scene.Meshes)
+                m_meshes.push_back(CreateMesh(mesh));
+
+            std::vector<NodeRef> roots;
+            m_nodes.reserve(m_scene.Nodes.size());
+            for (const auto& node : m_scene.Nodes)
+            {
+                // parents are always before children, so the graph is built in one pass
+                const auto parent = node.Parent >= 0 ? At(m_nodes, static_cast<size_t>(node.Parent)) : nullptr;
+
+                auto& sceneNode = m_nodes.emplace_back(std::make_shared<Node>(node.Name));
+                sceneNode->SetTransform(node.Transform);
+                for (const auto& [meshIndex, subMeshes] : node.Meshes)
+                {
+                    const auto& cookedMesh = At(m_scene.Meshes, meshIndex);
+                    for (const auto subMeshIndex : subMeshes)
+                        At(cookedMesh.SubMeshes, subMeshIndex);
+
+                    sceneNode->addComponent(std::make_unique<MeshComponent>(At(m_meshes, meshIndex), std::vector<unsigned> {subMeshes.begin(), subMeshes.end()}));
+
+                    // skinned meshes are deformed, so they could leave their occluders
+                    if (node.Skin < 0)
+                        for (const auto subMeshIndex : subMeshes)
+                            if (const auto& occluder = At(GetOccluders(meshIndex), subMeshIndex))
+                                sceneNode->addComponent(std::make_unique<OccluderComponent>(occluder));
+                }
+
+                if (parent)
+                    parent->AddChild(sceneNode);
+                else
+                    roots.push_back(sceneNode);
+            }
+
+            SetupSkins();
+            SetupAnimations();
+
+            if (roots.size() == 1)
+                return roots.front();
+
+            auto root = std::make_shared<Node>("Root");
+            for (const auto& node : roots)
+                root->AddChild(node);
+
+            return root;
+        }
+
+    private:
+        MeshRef CreateMesh(const CookedScene::Mesh& cookedMesh)
+        {
+            CheckMesh(cookedMesh);
+
+            auto& factory = m_renderer.GetResourceFactory();
+
+            auto vertexArray = factory.CreateVertexArray();
+            const auto vertexBuffer = factory.CreateBuffer(VertexBufferType::ArrayBuffer, m_scene.GetData(cookedMesh.Vertices));
+            for (const auto& [attributeIndex, bindingParams] : cookedMesh.Attributes)
+                vertexArray->SetAttributeBinding(attributeIndex, vertexBuffer, bindingParams);
+
+            if (cookedMesh.IndexType)
+                vertexArray->SetIndexBuffer(factory.CreateBuffer(VertexBufferType::IndexBuffer, m_scene.GetData(cookedMesh.Indices)),
+                                            *cookedMesh.IndexType);
+
+            auto mesh = std::make_shared<Mesh>(cookedMesh.Name);
+            mesh->VertexArray = std::move(vertexArray);
+            for (const auto materialIndex : cookedMesh.Materials)
+                mesh->Materials.push_back(CreateMaterial(At(m_scene.Materials, materialIndex)));
+
+            for (const auto& subMesh : cookedMesh.SubMeshes)
+            {
+                auto& result = mesh->SubMeshes.emplace_back(subMesh.Chunks, static_cast<int>(subMesh.MaterialIndex), subMesh.Name);
+                for (const auto& [error, chunks] : subMesh.Lods)
+                    result.Lods.push_back({error, chunks});
+                if (!subMesh.Meshlets.empty())
+                    result.Meshlets = std::make_shared<MeshletSet>(subMesh.Meshlets);
+            }
+
+            return mesh;
+        }
+
+        void CheckMesh(const CookedScene::Mesh& cookedMesh) const
+        {
+            const auto numVertices = GetNumVertices(cookedMesh);
+            const auto indices = cookedMesh.IndexType ? m_scene.GetData(cookedMesh.Indices) : std::span<const std::byte> {};
+            const auto checkChunks = [&](const std::vector<MeshChunk>& chunks) {
+                for (const auto& chunk : chunks)
+                    CheckRange(cookedMesh, indices, numVertices, chunk.StartElement, chunk.Count, chunk.BaseVertex);
+            };
+
+            for (const auto& subMesh : cookedMesh.SubMeshes)
+            {
+                if (!cookedMesh.Materials.empty())
+                    At(cookedMesh.Materials, subMesh.MaterialIndex);
+
+                checkChunks(subMesh.Chunks);
+                for (const auto& lod : subMesh.Lods)
+                    checkChunks(lod.Chunks);
+                for (const auto& meshlet : subMesh.Meshlets)
+                    CheckRange(cookedMesh, indices, numVertices, meshlet.FirstIndex, meshlet.Count, meshlet.BaseVertex);
+            }
+        }
+
+        // Occluders are built on the first use
+        const std::vector<std::shared_ptr<const OccluderMesh>>& GetOccluders(size_t meshIndex)
+        {
+            const auto& cookedMesh = At(m_scene.Meshes, meshIndex);
+
+            auto& occluders = m_occluders[meshIndex];
+            if (!occluders)
+                occluders = CreateOccluders(cookedMesh);
+
+            return *occluders;
+        }
+
+        // Occluder of every triangle submesh is it's coarsest level of detail moved inward by the level error
+        std::vector<std::shared_ptr<const OccluderMesh>> CreateOccluders(const CookedScene::Mesh& cookedMesh) const
+        {
+            std::vector<std::shared_ptr<const OccluderMesh>> occluders(cookedMesh.SubMeshes.size());
+
+            const auto positionAttribute =
+                std::ranges::find(cookedMesh.Attributes, PositionAttributeIndex, &VertexPacker::PackedAttribute::AttributeIndex);
+            if (positionAttribute == cookedMesh.Attributes.end())
+                return occluders;
+
+            const auto isTriangles = [](const MeshChunk& chunk) { return std::holds_alternative<Primitives::Triangles>(chunk.Type); };
+            const auto indexData = cookedMesh.IndexType ? m_scene.GetData(cookedMesh.Indices) : std::span<const std::byte> {};
+
+            std::vector<glm::vec3> positions;
+            std::vector<uint32_t> indices;
+            for (size_t subMeshIndex = 0; subMeshIndex < cookedMesh.SubMeshes.size(); ++subMeshIndex)
+            {
+                const auto& subMesh = cookedMesh.SubMeshes[subMeshIndex];
+                const auto& chunks = subMesh.Lods.empty() ? subMesh.Chunks : subMesh.Lods.back().Chunks;
+
+                size_t numIndices = 0;
+                for (const auto& chunk : chunks)
+                    if (isTriangles(chunk))
+                        numIndices += chunk.Count;
+                if (numIndices == 0 || numIndices / 3 > MaxOccluderTriangles)
+                    continue;
+
+                if (positions.empty())
+                    positions = ReadPositions(m_scene.GetData(cookedMesh.Vertices), positionAttribute->BindingParams);
+
+                indices.clear();
+                for (const auto& chunk : chunks)
+                {
+                    if (!isTriangles(chunk))
+                        continue;
+
+                    // ranges are checked by CheckMesh
+                    for (size_t element = chunk.StartElement; element < size_t {chunk.StartElement} + chunk.Count; ++element)
+                        indices.push_back(cookedMesh.IndexType ? ReadIndex(indexData, *cookedMesh.IndexType, element) + chunk.BaseVertex
+                                                               : static_cast<uint32_t>(element));
+                }
+
+                if (indices.size() % 3 != 0)
+                    throw AT2IOException("cooked scene is corrupted: triangle list is incomplete");
+
+                const auto inset = subMesh.Lods.empty() ? 0.0f : subMesh.Lods.back().Error;
+                occluders[subMeshIndex] = std::make_shared<OccluderMesh>(OccluderMesh::Build(positions, indices, inset));
+            }
+
+            return occluders;
+        }
+
+        std::unique_ptr<IUniformContainer> CreateMaterial(const CookedScene::Material& material)
+        {
+            auto container = std::make_unique<UniformContainer>();
+            for (const auto& [uniformName, textureIndex, fallback] : material.Textures)
+            {
+                if (textureIndex >= 0)
+                    if (auto texture = GetTexture(static_cast<size_t>(textureIndex)))
+                    {
+                        container->SetUniform(uniformName, texture);
+                        continue;
+                    }
+
+                if (fallback)
+                    container->SetUniform(uniformName, GetPlaceholder(*fallback));
+            }
+
+            return container;
+        }
+
+        // Textures are loaded on the first use
+        TextureRef GetTexture(size_t textureIndex)
+        {
+            const auto& cookedTexture = At(m_scene.Textures, textureIndex);
+
+            auto& texture = m_textures[textureIndex];
+            if (!texture)
+                texture = LoadTexture(cookedTexture);
+
+            return *texture;
+        }
+
+        TextureRef LoadTexture(const CookedScene::Texture& texture)
+        {
+            TextureRef storage;
+            try
+            {
+                if (!texture.Path.empty())
+                    storage = m_textureCache ? m_textureCache->LoadTexture(texture.Path) : TextureLoader::LoadTexture(m_renderer, texture.Path);
+                else if (texture.EmbeddedData.Size > 0)
+                {
+                    const auto data = m_scene.GetData(texture.EmbeddedData);
+                    storage = m_textureCache ? m_textureCache->LoadTexture(data) : TextureLoader::LoadTexture(m_renderer, data);
+                }
+            }
+            catch (const AT2TextureException& exception)
+            {
+                Log::Warning() << "Texture '" << texture.Path.string() << "': " << exception.what() << std::endl;
+                return nullptr;
+            }
+
+            if (!storage || !texture.Sampler)
+                return storage;
+
+            return m_textureCache ? m_textureCache->GetView(storage, *texture.Sampler)
+                                  : TextureCache::CreateView(m_renderer.GetResourceFactory(), storage, *texture.Sampler);
+        }
+
+        TextureRef GetPlaceholder(const glm::vec4& color)
+        {
+            const auto packedColor = glm::packUnorm4x8(color);
+            if (auto it = m_placeholders.find(packedColor); it != m_placeholders.end())
+                return it->second;
+
+            auto texture = m_renderer.GetResourceFactory().CreateTexture(Texture2D {{1, 1}}, TextureFormats::RGBA8);
+            texture->SubImage2D({}, {1, 1}, 0, TextureFormats::RGBA8, &packedColor);
+
+            m_placeholders.emplace(packedColor, texture);
+            return texture;
+        }
+
+        void SetupSkins()
+        {
+            std::vector<MeshComponent::SkeletonInstanceRef> skeletonInstances;
+            skeletonInstances.reserve(m_scene.Skins.size());
+            for (const auto& skin : m_scene.Skins)
+            {
+                const auto& instance = skeletonInstances.emplace_back(std::make_shared<MeshComponent::SkeletonInstance>(
+                    Utils::reinterpret_span_cast<glm::mat4>(m_scene.GetData(skin.InverseBindMatrices))));
+
+                for (size_t boneIndex = 0; const auto jointNode : skin.Joints)
+                    At(m_nodes, jointNode)->getOrCreateComponent<BoneComponent>(boneIndex++, instance);
+            }
+
+            for (size_t nodeIndex = 0; nodeIndex < m_nodes.size(); ++nodeIndex)
+                if (const auto skinIndex = m_scene.Nodes[nodeIndex].Skin; skinIndex >= 0)
+                    for (auto* meshComponent : m_nodes[nodeIndex]->getComponents<MeshComponent>())
+                        meshComponent->setSkeletonInstance(At(skeletonInstances, static_cast<size_t>(skinIndex)));
+        }
+
+        void SetupAnimations()
+        {
+            if (m_scene.Animations.empty())
+                return;
+
+            auto animationContainer = std::make_shared<Animation::AnimationCollection>();
+            // tracks read keys and values directly from the scene data
+            animationContainer->addExternalStorage(m_scene.GetData(), m_scene.GetDataOwner());
+
+            for (const auto& animation : m_scene.Animations)
+            {
+                auto& configuringAnimation = animationContainer->addAnimation(animation.Name);
+                for (const auto& track : animation.Tracks)
+                    SetupTrack(track, animationContainer, configuringAnimation);
+            }
+
+            animationContainer->setCurrentAnimation(0);
+        }
+
+        void SetupTrack(const CookedScene::Track& track, const Animation::AnimationRef& animationContainer, Animation::Animation& animation)
+        {
+            const auto animationNodeId = static_cast<Animation::AnimationNodeId>(track.Node);
+            const auto& animationComponent =
+                At(m_nodes, track.Node)->getOrCreateComponent<Animation::AnimationComponent>(animationContainer, animationNodeId);
+
+            if (!animationComponent.isSameAs(animationContainer, animationNodeId))
+                throw std::logic_error("different animation components on one node");
+
+            const auto keys = Utils::reinterpret_span_cast<float>(m_scene.GetData(track.Keys));
+            const auto values = m_scene.GetData(track.Values);
+            const auto interpolationMode = TranslateInterpolationMode(track.Mode);
+
+            using Target = CookedScene::TrackTarget;
+            switch (track.Target)
+            {
+            case Target::Translation:
+                animation.addTrack(
+                    animationNodeId, keys, Utils::reinterpret_span_cast<glm::vec3>(values),
+                    [](glm::vec3 value, Node& node) { node.GetTransform().setPosition(value); }, interpolationMode);
+                break;
+            case Target::Rotation:
+                animation.addTrack(
+                    animationNodeId, keys, Utils::reinterpret_span_cast<glm::quat>(values),
+                    [](glm::quat value, Node& node) { node.GetTransform().setRotation(value); }, interpolationMode);
+                break;
+            case Target::Scale:
+                animation.addTrack(
+                    animationNodeId, keys, Utils::reinterpret_span_cast<glm::vec3>(values),
+                    [](glm::vec3 value, Node& node) { node.GetTransform().setScale(value); }, interpolationMode);
+                break;
+            default: throw AT2IOException("cooked scene has unknown animation target");
+            }
+        }
+
+    private:
+        IVisualizationSystem& m_renderer;
+        const CookedScene& m_scene;
+        TextureCache* m_textureCache;
+
+        std::vector<std::optional<TextureRef>> m_textures;
+        std::unordered_map<glm::u32, TextureRef> m_placeholders;
+        std::vector<MeshRef> m_meshes;
+        std::vector<NodeRef> m_nodes;
+        std::vector<std::optional<std::vector<std::shared_ptr<const OccluderMesh>>>> m_occluders;
+    };
+} // namespace
+
+NodeRef CookedSceneLoader::LoadScene(IVisualizationSystem& renderer, const std::filesystem::path& path, TextureCache* textureCache)
+{
+    Log::Info() << "Loading cooked scene from '" << path.string() << "'." << std::endl;
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto scene = CookedScene::Load(path);
+    auto result = BuildScene(renderer, scene, textureCache);
+
+    Log::Info() << "Cooked scene loaded: " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                << " ms" << std::endl;
+
+    return result;
+}
+
+NodeRef CookedSceneLoader::BuildScene(IVisualizationSystem& renderer, const CookedScene& scene, TextureCache* textureCache)
+{
+    return Builder {renderer, scene, textureCache}.Build();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Scene/Scene.h>
+
+#include <filesystem>
+
+namespace AT2::Resources
+{
+    class CookedScene;
+    class TextureCache;
+
+    class CookedSceneLoader
+    {
+    public:
+        // Maps the cooked file, vertex and index buffers are created right from it's data. Throws AT2IOException if the file
+        // isn't a cooked scene of the current version.
+        static std::shared_ptr<Scene::Node> LoadScene(IVisualizationSystem& renderer, const std::filesystem::path& path,
+                                                      TextureCache* textureCache = nullptr);
+
+        // Animations keep the scene data alive while they are used. Nodes of static triangle meshes get occluders of
+        // their coarsest levels of detail.
+        static std::shared_ptr<Scene::Node> BuildScene(IVisualizationSystem& renderer, const CookedScene& scene,
+                                                       TextureCache* textureCache = nullptr);
+    };
+} // namespace AT2::Resources
@@ -1,13 +1,26 @@
 #include "GltfSceneLoader.h"
 
 #include <bit>
+#include <cstring>
+#include <limits>
 //#include <ranges>
 #include <fx/gltf.h>
 #include <glm/packing.hpp>
 #include <filesystem>
 
+#include <nlohmann/json.hpp>
+
 #include <Scene/Animation.h>
-#include <BufferMapperGuard.h>
+#include <GeometryPool.h>
+#include <MappedFile.h>
+#include <MeshletSet.h>
+#include <MeshOptimizer.h>
+#include <MeshSimplifier.h>
+#include <ScopedTimer.h>
+#include <ThreadPool.h>
+#include "AsyncTextureLoader.h"
+#include "CookedScene.h"
+#include "TextureCache.h"
 #include "TextureLoader.h"
 
 using namespace AT2;
@@ -75,6 +88,7 @@ namespace
         case Type::None: throw std::logic_error("unsupported data type");
         }
 
+        result.IsNormalized = accessor.normalized;
         return result;
     }
 
@@ -136,6 +150,168 @@ namespace
     }
 
 
+    glm::mat4 GetNodeTransform(const fx::gltf::Node& node)
+    {
+        if (!std::ranges::equal(node.translation, fx::gltf::defaults::NullVec3) ||
+            !std::ranges::equal(node.rotation , fx::gltf::defaults::IdentityRotation) ||
+            !std::ranges::equal(node.scale , fx::gltf::defaults::IdentityVec3))
+        {
+            auto tr = translate(glm::mat4 {1.0}, std::bit_cast<glm::vec3>(node.translation))
+                * mat4_cast(std::bit_cast<glm::quat>(node.rotation));
+            return scale(tr, std::bit_cast<glm::vec3>(node.scale));
+        }
+
+        return std::bit_cast<glm::mat4>(node.matrix);
+    }
+
+    Primitives::Primitive TranslatePrimitiveMode(fx::gltf::Primitive::Mode mode)
+    {
+        using Mode = fx::gltf::Primitive::Mode;
+        switch (mode)
+        {
+        case Mode::Points: return Primitives::Points {};
+        case Mode::Lines: return Primitives::Lines {};
+        case Mode::LineLoop: return Primitives::LineLoop {};
+        case Mode::LineStrip: return Primitives::LineStrip {};
+        case Mode::Triangles: return Primitives::Triangles {};
+        case Mode::TriangleStrip: return Primitives::TriangleStrip {};
+        case Mode::TriangleFan: return Primitives::TriangleFan {};
+        }
+
+        throw std::logic_error("invalid conversion");
+    }
+
+    constexpr CookedScene::Interpolation TranslateCookedInterpolation(fx::gltf::Animation::Sampler::Type interpolation)
+    {
+        using Type = fx::gltf::Animation::Sampler::Type;
+        switch (interpolation)
+        {
+        case Type::Step: return CookedScene::Interpolation::Step;
+        case Type::Linear: return CookedScene::Interpolation::Linear;
+        case Type::CubicSpline: return CookedScene::Interpolation::CubicSpline;
+        }
+
+        throw std::logic_error("invalid conversion");
+    }
+
+    // Memory of all document buffers. Binary chunk of GLB and external buffers are mapped, so geometry and animations
+    // are read from the OS file cache without copying, only base64-embedded buffers are decoded into the heap.
+    struct BufferStorage
+    {
+        std::vector<std::unique_ptr<MappedFile>> MappedFiles;
+        std::vector<std::vector<uint8_t>> DecodedData;
+        std::vector<std::span<const std::byte>> Buffers; // one per document buffer
+    };
+
+    constexpr uint32_t GlbMagic = 0x46546C67;           // "glTF"
+    constexpr uint32_t GlbJsonChunkType = 0x4E4F534A;   // "JSON"
+    constexpr uint32_t GlbBinaryChunkType = 0x004E4942; // "BIN\0"
+    constexpr size_t GlbHeaderLength = 12, GlbChunkHeaderLength = 8;
+
+    uint32_t ReadUInt32(std::span<const std::byte> data, size_t offset)
+    {
+        uint32_t value;
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+
+    fx::gltf::Document LoadDocument(const std::filesystem::path& path, BufferStorage& storage)
+    {
+        auto file = std::make_unique<MappedFile>(path);
+        const auto fileData = file->GetData();
+
+        auto json = fileData;
+        std::span<const std::byte> binaryChunk;
+        const bool isBinary = fileData.size() >= GlbHeaderLength && ReadUInt32(fileData, 0) == GlbMagic;
+        if (isBinary)
+        {
+            if (ReadUInt32(fileData, 4) != 2)
+                throw AT2IOException("'" + path.string() + "' has unsupported GLB version");
+
+            const size_t length = std::min<size_t>(ReadUInt32(fileData, 8), fileData.size());
+
+            json = {};
+            for (size_t offset = GlbHeaderLength; offset + GlbChunkHeaderLength <= length;)
+            {
+                const size_t chunkLength = ReadUInt32(fileData, offset);
+                const auto chunkType = ReadUInt32(fileData, offset + 4);
+                if (chunkLength > length - offset - GlbChunkHeaderLength)
+                    throw AT2IOException("'" + path.string() + "' is truncated");
+
+                const auto chunk = fileData.subspan(offset + GlbChunkHeaderLength, chunkLength);
+                if (chunkType == GlbJsonChunkType && json.empty())
+                    json = chunk;
+                else if (chunkType == GlbBinaryChunkType && binaryChunk.empty())
+                    binaryChunk = chunk;
+
+                offset += GlbChunkHeaderLength + chunkLength;
+            }
+
+            if (json.empty())
+                throw AT2IOException("'" + path.string() + "' has no JSON chunk");
+        }
+
+        fx::gltf::Document document;
+        try
+        {
+            const auto* text = reinterpret_cast<const char*>(json.data());
+            document = nlohmann::json::parse(text, text + json.size()).get<fx::gltf::Document>();
+        }
+        catch (const nlohmann::json::exception& exception)
+        {
+            throw AT2IOException("'" + path.string() + "' is malformed: " + exception.what());
+        }
+
+        // the text of glTF isn't needed anymore
+        if (isBinary)
+            storage.MappedFiles.push_back(std::move(file));
+
+        const auto basePath = path.parent_path();
+        for (size_t bufferIndex = 0; bufferIndex < document.buffers.size(); ++bufferIndex)
+        {
+            const auto& buffer = document.buffers[bufferIndex];
+
+            std::span<const std::byte> data;
+            if (buffer.uri.empty())
+            {
+                if (bufferIndex != 0 || !isBinary)
+                    throw AT2IOException("'" + path.string() + "' has buffer without uri");
+
+                data = binaryChunk;
+            }
+            else if (buffer.IsEmbeddedResource())
+            {
+                auto& decoded = storage.DecodedData.emplace_back();
+                const auto dataStart = buffer.uri.find(',');
+                if (dataStart == std::string::npos || !fx::base64::TryDecode(buffer.uri.substr(dataStart + 1), decoded))
+                    throw AT2IOException("'" + path.string() + "' has malformed embedded buffer");
+
+                data = std::as_bytes(std::span {decoded});
+            }
+            else
+                data = storage.MappedFiles.emplace_back(std::make_unique<MappedFile>(basePath / buffer.uri))->GetData();
+
+            if (data.size() < buffer.byteLength)
+                throw AT2IOException("'" + path.string() + "' has truncated buffer #" + std::to_string(bufferIndex));
+
+            storage.Buffers.push_back(data.first(buffer.byteLength));
+        }
+
+        return document;
+    }
+
+    std::vector<uint32_t> ReadIndices(BufferDataType type, std::span<const std::byte> data)
+    {
+        const auto widen = [](auto indices) { return std::vector<uint32_t>(indices.begin(), indices.end()); };
+        switch (type)
+        {
+        case BufferDataType::UByte: return widen(Utils::reinterpret_span_cast<uint8_t>(data));
+        case BufferDataType::UShort: return widen(Utils::reinterpret_span_cast<uint16_t>(data));
+        case BufferDataType::UInt: return widen(Utils::reinterpret_span_cast<uint32_t>(data));
+        default: throw AT2Exception("unsupported index type");
+        }
+    }
+
     class PlaceholderTextureCash
     {
         IVisualizationSystem& m_renderer;
@@ -161,31 +337,269 @@ namespace
         }
     };
 
-    class Loader
+    // Parsed document with it's buffers and CPU-side geometry processing, shared by loading and cooking
+    class DocumentReader
     {
-        IVisualizationSystem& m_renderer;
+    protected:
+        explicit DocumentReader(const std::filesystem::path& path)
+        : m_buffers(std::make_shared<BufferStorage>())
+        , m_document(LoadDocument(path, *m_buffers))
+        , m_currentPath(path.parent_path())
+        {
+        }
+
+        std::shared_ptr<BufferStorage> m_buffers;
         fx::gltf::Document m_document;
+        std::filesystem::path m_currentPath;
+
+        struct PreparedPrimitive
+        {
+            std::vector<GeometryPool::VertexStream> VertexStreams;
+            std::optional<GeometryPool::IndexData> Indices;
+            std::vector<std::byte> IndexStorage; // storage of Indices data, if they were converted
+            std::vector<std::vector<std::byte>> VertexStorage; // storage of VertexStreams data, if they were reordered
+            std::optional<VertexPacker::PackedVertices> PackedVertices; // used instead of VertexStreams if present
+
+            // post-transform vertex cache efficiency, if the primitive was optimized
+            std::optional<MeshOptimizer::Statistics> OriginalStatistics;
+            std::optional<MeshOptimizer::Statistics> OptimizedStatistics;
+
+            // levels of detail follow the full detail indices
+            std::vector<MeshSimplifier::LodRange> Lods;
+            // clusters of the full detail indices, if they were requested
+            std::vector<Meshlet> Meshlets;
+        };
+
+        // Returns nullopt for images stored at separate files. Data URIs are decoded into the storage
+        std::optional<std::span<const std::byte>> GetImageData(const fx::gltf::Image& image, std::vector<uint8_t>& storage) const
+        {
+            if (image.bufferView >= 0 && image.uri.empty())
+            {
+                const auto& bufferView = m_document.bufferViews[image.bufferView];
+                return GetBufferData(bufferView.buffer, bufferView.byteOffset, bufferView.byteLength);
+            }
+
+            if (image.IsEmbeddedResource())
+            {
+                image.MaterializeData(storage);
+                return std::as_bytes(std::span {storage});
+            }
+
+            return std::nullopt;
+        }
+
+        // Geometry
+
+        struct BufferDataInfo
+        {
+            BufferBindingParams bindingParams;
+            uint32_t count;
+            std::span<const std::byte> data;
+        };
+
+        //TODO: make type-safe!!!
+        BufferDataInfo GetData(unsigned attribIndex) const
+        {
+            //TODO: support sparce accesors
+
+            const auto& accessor = m_document.accessors[attribIndex];
+            const auto& bufferView = m_document.bufferViews[accessor.bufferView];
+
+            const auto dataType = TranslateDataType(accessor);
+            return {dataType, accessor.count,
+                    GetBufferData(bufferView.buffer, static_cast<uint64_t>(bufferView.byteOffset) + accessor.byteOffset,
+                                  static_cast<uint64_t>(accessor.count) * dataType.Stride)};
+        }
+
+        // Points into the mapped file, valid while m_buffers is alive
+        std::span<const std::byte> GetBufferData(int32_t bufferIndex, uint64_t offset, uint64_t length) const
+        {
+            if (bufferIndex < 0)
+                throw std::logic_error("invalid buffer_view");
+
+            const auto data = m_buffers->Buffers.at(static_cast<size_t>(bufferIndex));
+            if (offset > data.size() || length > data.size() - offset)
+                throw AT2IOException("buffer #" + std::to_string(bufferIndex) + " is too short for the accessor");
+
+            return data.subspan(offset, length);
+        }
+
+        // Thread-safe, data is referenced or converted but not uploaded
+        PreparedPrimitive PreparePrimitive(const fx::gltf::Primitive& primitive, bool packVertices, bool optimizeMeshes,
+                                           bool buildMeshlets) const
+        {
+            using Semantic = VertexPacker::Semantic;
+            const static auto requiredAttributes = std::to_array<std::tuple<uint32_t, std::string, Semantic>>(
+                {{1u, "POSITION"s, Semantic::Position},
+                 {2u, "TEXCOORD_0"s, Semantic::TexCoord},
+                 {3u, "NORMAL"s, Semantic::Normal},
+                 {4u, "JOINTS_0"s, Semantic::Joints},
+                 {5u, "WEIGHTS_0"s, Semantic::Weights}}); //"TANGENT"
+
+            PreparedPrimitive result;
+            std::vector<Semantic> semantics;
+            std::optional<size_t> positionsStream;
+            for (const auto& [attribIndex, attribName, semantic] : requiredAttributes)
+            {
+                if (auto it = primitive.attributes.find(attribName); it != primitive.attributes.end())
+                {
+                    const auto bufferData = GetData(it->second);
+                    if (semantic == Semantic::Position && bufferData.bindingParams.Type == BufferDataType::Float && bufferData.bindingParams.Count == 3)
+                        positionsStream = result.VertexStreams.size();
+
+                    result.VertexStreams.push_back({attribIndex, bufferData.bindingParams, bufferData.data});
+                    semantics.push_back(semantic);
+                }
+            }
+
+            if (primitive.indices >= 0)
+            {
+                const auto indexBufferInfo = GetData(primitive.indices);
+                result.Indices = GeometryPool::IndexData {indexBufferInfo.bindingParams.Type, indexBufferInfo.data};
+
+                if (optimizeMeshes && positionsStream && primitive.mode == fx::gltf::Primitive::Mode::Triangles)
+                    OptimizePrimitive(result, ReadIndices(indexBufferInfo.bindingParams.Type, indexBufferInfo.data), *positionsStream,
+                                      buildMeshlets);
+                else if (indexBufferInfo.bindingParams.Type == BufferDataType::UInt)
+                {
+                    auto [indexType, indexStorage] = MeshOptimizer::PackIndices(Utils::reinterpret_span_cast<uint32_t>(indexBufferInfo.data));
+                    result.IndexStorage = std::move(indexStorage);
+                    result.Indices = GeometryPool::IndexData {indexType, result.IndexStorage};
+                }
+            }
+
+            if (packVertices && !result.VertexStreams.empty())
+            {
+                std::vector<VertexPacker::Attribute> packerAttributes;
+                for (size_t i = 0; i < result.VertexStreams.size(); ++i)
+                {
+                    const auto& [attribIndex, bindingParams, data] = result.VertexStreams[i];
+                    packerAttributes.push_back({attribIndex, semantics[i], bindingParams, data});
+                }
+
+                result.PackedVertices = VertexPacker::Pack(packerAttributes);
+            }
+
+            return result;
+        }
+
+        // Reorders triangles for vertex cache and overdraw, appends levels of detail, then reorders vertices in the order of
+        // use and splits the full detail into meshlets. Streams are copied
+        static void OptimizePrimitive(PreparedPrimitive& primitive, std::vector<uint32_t> indices, size_t positionsStream,
+                                      bool buildMeshlets)
+        {
+            const auto& positions = primitive.VertexStreams[positionsStream];
+            const size_t numVertices = positions.Data.size() / positions.BindingParams.Stride;
+            const auto positionsData = Utils::reinterpret_span_cast<glm::vec3>(positions.Data);
+
+            primitive.OriginalStatistics = MeshOptimizer::AnalyzeVertexCache(indices, numVertices);
+
+            indices = MeshOptimizer::OptimizeVertexCache(indices, numVertices);
+            indices = MeshOptimizer::OptimizeOverdraw(indices, positionsData);
+            const auto numFullDetailIndices = indices.size();
+            primitive.Lods = MeshSimplifier::AppendLods(indices, positionsData);
+            // levels of detail use the subset of full detail vertices, so the order of first use is defined by full detail
+            const auto remap = MeshOptimizer::OptimizeVertexFetch(indices, numVertices);
+
+            primitive.OptimizedStatistics = MeshOptimizer::AnalyzeVertexCache(std::span {indices}.first(numFullDetailIndices),
+                                                                               primitive.OriginalStatistics->NumUsedVertices);
+
+            for (auto& stream : primitive.VertexStreams)
+            {
+                const auto& vertexData = primitive.VertexStorage.emplace_back(
+                    MeshOptimizer::RemapVertices(stream.Data, stream.BindingParams.Stride, remap));
+                stream.Data = vertexData;
+            }
+
+            if (buildMeshlets)
+                primitive.Meshlets = MeshletSet::Build(std::span {indices}.first(numFullDetailIndices),
+                                                       Utils::reinterpret_span_cast<glm::vec3>(primitive.VertexStreams[positionsStream].Data));
+
+            auto [indexType, indexStorage] = MeshOptimizer::PackIndices(indices);
+            primitive.IndexStorage = std::move(indexStorage);
+            primitive.Indices = GeometryPool::IndexData {indexType, primitive.IndexStorage};
+        }
+
+        // chunk covers all indices of the primitive, returns the part of the given level of detail
+        static MeshChunk GetLodChunk(MeshChunk chunk, const PreparedPrimitive& primitive, size_t lod)
+        {
+            if (lod == 0)
+            {
+                if (!primitive.Lods.empty())
+                    chunk.Count = primitive.Lods.front().FirstIndex;
+                return chunk;
+            }
+
+            const auto& range = primitive.Lods.at(lod - 1);
+            chunk.StartElement += range.FirstIndex;
+            chunk.Count = range.Count;
+            return chunk;
+        }
+    };
+
+    class Loader : private DocumentReader
+    {
+        IVisualizationSystem& m_renderer;
+        GeometryPool m_geometryPool;
+
+        // Called when asynchronously loaded texture is ready
+        using TextureListeners = std::vector<std::function<void(const TextureRef&)>>;
+
+        struct LoadedTexture
+        {
+            std::shared_ptr<ITexture> Texture;
+            // not null while texture is being loaded asynchronously, placeholder is used until then
+            std::shared_ptr<TextureListeners> Listeners;
+        };
+
+        AsyncTextureLoader* m_asyncTextureLoader;
+        TextureCache* m_textureCache;
+
+        // Results of the CPU-side work, which is done in parallel before GPU resources creation
+
+        struct PreparedImage
+        {
+            TextureRef CachedTexture;
+            std::optional<DecodedImage> Image;
+            std::optional<TextureCache::ContentHash> Hash; // for images stored inside of the document
+            std::string Error;
+        };
+
+        ThreadPool* m_threadPool;
+        bool m_packVertices;
+        bool m_optimizeMeshes;
+        bool m_buildMeshlets;
+        GltfMeshLoader::Timings& m_timings;
+        std::vector<PreparedImage> m_preparedImages;
+        std::vector<std::vector<PreparedPrimitive>> m_preparedMeshes;
 
         using SubmeshGroup = std::vector<MeshRef>;
         std::vector<SubmeshGroup> m_meshes;
-        std::vector<std::shared_ptr<ITexture>> m_textures;
+        std::vector<std::optional<LoadedTexture>> m_images; // loaded on demand, shared by all textures referencing it
+        std::vector<LoadedTexture> m_textures;
         std::vector<std::shared_ptr<Node>> m_nodes;
         std::vector<MeshComponent::SkeletonInstanceRef> m_skeletonInstances;
-        std::filesystem::path m_currentPath;
 
         PlaceholderTextureCash m_placeholderTextureCash;
 
     public:
-        Loader(IVisualizationSystem& renderer, const str& sv)
-        : m_renderer(renderer)
-        , m_document(fx::gltf::LoadFromText(sv, fx::gltf::ReadQuotas {64, 64 * 1024 * 1024, 64 * 1024 * 1024}))
-        , m_currentPath(sv)
+        Loader(IVisualizationSystem& renderer, const str& sv, AsyncTextureLoader* asyncTextureLoader, TextureCache* textureCache,
+               ThreadPool* threadPool, bool packVertices, bool optimizeMeshes, bool buildMeshlets, GltfMeshLoader::Timings& timings)
+        : DocumentReader(sv)
+        , m_renderer(renderer)
+        , m_geometryPool(m_renderer.GetResourceFactory())
+        , m_asyncTextureLoader(asyncTextureLoader)
+        , m_textureCache(textureCache)
+        , m_threadPool(threadPool)
+        , m_packVertices(packVertices)
+        , m_optimizeMeshes(optimizeMeshes)
+        , m_buildMeshlets(buildMeshlets)
+        , m_timings(timings)
+        , m_images(m_document.images.size())
         , m_nodes(m_document.nodes.size())
         , m_skeletonInstances (m_document.skins.size())
         , m_placeholderTextureCash(m_renderer)
         {
-            m_currentPath.remove_filename();
-
             for (size_t skinIndex = 0; skinIndex < m_document.skins.size(); skinIndex++)
             {
                 const auto& skin = m_document.skins[skinIndex];
@@ -202,6 +616,7 @@ namespace
 
             LoadResources();
 
+            ScopedTimer timer {m_timings.Build};
             NodeRef sceneRoot;
 
             if (m_document.scene >= 0 && static_cast<size_t>(m_document.scene) < m_document.scenes.size())
@@ -292,6 +707,10 @@ namespace
         [[nodiscard]] Animation::AnimationRef SetupAnimations()
         {
             auto animationContainer = std::make_shared<AT2::Animation::AnimationCollection>();
+            // tracks read keys and values directly from the buffers
+            for (const auto buffer : m_buffers->Buffers)
+                animationContainer->addExternalStorage(buffer, m_buffers);
+
             for (const auto& animation: m_document.animations)
             {
                 auto& configuringAnimation = animationContainer->addAnimation(animation.name);
@@ -335,18 +754,7 @@ namespace
             const fx::gltf::Node& node = m_document.nodes[static_cast<size_t>(nodeIndex)];
             
             auto currentNode = std::make_shared<Node>(node.name);
-            if (!std::ranges::equal(node.translation, fx::gltf::defaults::NullVec3) ||
-                !std::ranges::equal(node.rotation , fx::gltf::defaults::IdentityRotation) ||
-                !std::ranges::equal(node.scale , fx::gltf::defaults::IdentityVec3))
-            {
-                auto tr = translate(glm::mat4 {1.0}, std::bit_cast<glm::vec3>(node.translation))
-                    * mat4_cast(std::bit_cast<glm::quat>(node.rotation));
-                auto trs = scale(tr, std::bit_cast<glm::vec3>(node.scale));
-
-                currentNode->SetTransform(trs);
-            }
-            else
-                currentNode->SetTransform(std::bit_cast<glm::mat4>(node.matrix));
+            currentNode->SetTransform(GetNodeTransform(node));
 
             baseNode.AddChild(currentNode);
 
@@ -375,71 +783,254 @@ namespace
 
         void LoadResources()
         {
+            {
+                ScopedTimer timer {m_timings.Decode};
+                PrepareImages();
+                PrepareMeshes();
+            }
+
+            ScopedTimer timer {m_timings.Upload};
             std::ranges::transform(m_document.textures, std::back_inserter(m_textures),
                                    std::bind_front(&Loader::LoadTexture, this));
 
-            std::ranges::transform(m_document.meshes, std::back_inserter(m_meshes),
-                                   std::bind_front(&Loader::LoadMesh, this));
+            for (size_t meshIndex = 0; meshIndex < m_document.meshes.size(); ++meshIndex)
+                m_meshes.push_back(LoadMesh(meshIndex));
+
+            const auto geometryStatistics = m_geometryPool.GetStatistics();
+            Log::Debug() << "Geometry placed into " << geometryStatistics.NumVertexArrays << " vertex arrays, "
+                         << geometryStatistics.UsedBytes << " of " << geometryStatistics.AllocatedBytes << " bytes used" << std::endl;
         }
 
-        std::shared_ptr<ITexture> LoadTexture(const fx::gltf::Texture& texture)
+        LoadedTexture LoadTexture(const fx::gltf::Texture& texture)
         {
-            auto loadedTexture = [&]() -> std::shared_ptr<ITexture> {
-                if (texture.source < 0)
-                    return nullptr;
+            if (texture.source < 0)
+                return {};
+
+            const auto& image = GetImage(static_cast<size_t>(texture.source));
+            if (texture.sampler < 0)
+                return image;
+
+            const auto& sampler = m_document.samplers[texture.sampler];
+            if (sampler.wrapS != sampler.wrapT)
+                Log::Warning() << "wrapS != wrapT, using first" << std::endl;
+
+            //TODO: support all sampler parameters
+            // sampler state is translated in advance, because asynchronous texture could outlive the document
+            const auto makeView = [&factory = m_renderer.GetResourceFactory(), textureCache = m_textureCache,
+                                   samplerState = TextureCache::SamplerState {{TranslateWrappingMode(sampler.wrapS), TranslateWrappingMode(sampler.wrapT)},
+                                                                              {TranslateMagFilter(sampler.magFilter), TranslateMinFilter(sampler.minFilter)}}](const TextureRef& storage) {
+                return textureCache ? textureCache->GetView(storage, samplerState) : TextureCache::CreateView(factory, storage, samplerState);
+            };
 
-                const auto& image = m_document.images[texture.source];
-                if (image.bufferView >= 0 && image.uri.empty())
+            if (image.Texture)
+                return {makeView(image.Texture), nullptr};
+
+            if (!image.Listeners)
+                return {};
+
+            auto listeners = std::make_shared<TextureListeners>();
+            image.Listeners->push_back([listeners, makeView](const TextureRef& storage) {
+                const auto view = makeView(storage);
+                for (const auto& listener : *listeners)
+                    listener(view);
+            });
+
+            return {nullptr, std::move(listeners)};
+        }
+
+        const LoadedTexture& GetImage(size_t imageIndex)
+        {
+            auto& loadedImage = m_images.at(imageIndex);
+            if (!loadedImage)
+                loadedImage = LoadImage(imageIndex);
+
+            return *loadedImage;
+        }
+
+        LoadedTexture LoadImage(size_t imageIndex)
+        {
+            const auto& image = m_document.images[imageIndex];
+
+            if (m_asyncTextureLoader)
+            {
+                auto listeners = std::make_shared<TextureListeners>();
+                auto onReady = [listeners](const TextureRef& loadedTexture) {
+                    for (const auto& listener : *listeners)
+                        listener(loadedTexture);
+                };
+
+                std::vector<uint8_t> embeddedData;
+                if (const auto data = GetImageData(image, embeddedData))
+                    static_cast<void>(m_asyncTextureLoader->LoadTexture(std::vector<std::byte>(data->begin(), data->end()), std::move(onReady)));
+                else
+                    static_cast<void>(m_asyncTextureLoader->LoadTexture(m_currentPath / image.uri, std::move(onReady)));
+
+                return {nullptr, std::move(listeners)};
+            }
+
+            auto& prepared = m_preparedImages.at(imageIndex);
+            if (prepared.CachedTexture)
+                return {prepared.CachedTexture, nullptr};
+
+            if (!prepared.Image)
+            {
+                Log::Warning() << "Image #" << imageIndex << ": " << prepared.Error << std::endl;
+                return {};
+            }
+
+            if (m_textureCache && prepared.Hash)
+                if (auto texture = m_textureCache->Find(*prepared.Hash))
+                    return {texture, nullptr};
+
+            const auto path = m_currentPath / image.uri;
+            try
+            {
+                auto texture = TextureLoader::CreateTexture(m_renderer, *prepared.Image,
+                                                            prepared.Hash ? std::nullopt : std::optional {path});
+                if (m_textureCache && texture)
                 {
-                    const auto& bufferView = m_document.bufferViews[image.bufferView];
-                    if (bufferView.buffer < 0)
-                        throw std::logic_error("invalid buffer_view");
-
-                    const auto& buffer = m_document.buffers[bufferView.buffer];
-                    return TextureLoader::LoadTexture(
-                        m_renderer,
-                        std::as_bytes(std::span {buffer.data}).subspan(bufferView.byteOffset, bufferView.byteLength));
+                    if (prepared.Hash)
+                        m_textureCache->Insert(*prepared.Hash, texture);
+                    else
+                        m_textureCache->Insert(path, texture);
                 }
 
-                if (image.IsEmbeddedResource())
+                // decoded data isn't needed anymore
+                prepared.Image.reset();
+                return {texture, nullptr};
+            }
+            catch (const AT2TextureException& exception)
+            {
+                Log::Warning() << "Image #" << imageIndex << ": " << exception.what() << std::endl;
+                return {};
+            }
+        }
+
+        // Calls func(index) for [0, count), at the thread pool if it's given
+        template <typename Func>
+        void ForEachIndex(size_t count, size_t grainSize, const Func& func)
+        {
+            const auto processRange = [&func](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    func(i);
+            };
+
+            if (m_threadPool)
+                m_threadPool->ParallelFor(count, grainSize, processRange);
+            else
+                processRange(0, count);
+        }
+
+        // Decodes images referenced by textures, unless they are loaded asynchronously or found at the cache
+        void PrepareImages()
+        {
+            if (m_asyncTextureLoader)
+                return;
+
+            m_preparedImages.resize(m_document.images.size());
+
+            std::vector<size_t> imagesToDecode;
+            for (const auto& texture : m_document.textures)
+            {
+                if (texture.source < 0)
+                    continue;
+
+                const auto imageIndex = static_cast<size_t>(texture.source);
+                if (std::ranges::find(imagesToDecode, imageIndex) != imagesToDecode.end())
+                    continue;
+
+                const auto& image = m_document.images.at(imageIndex);
+                if (m_textureCache && image.bufferView < 0 && !image.IsEmbeddedResource())
+                    if (auto cachedTexture = m_textureCache->Find(m_currentPath / image.uri))
+                    {
+                        m_preparedImages[imageIndex].CachedTexture = std::move(cachedTexture);
+                        continue;
+                    }
+
+                imagesToDecode.push_back(imageIndex);
+            }
+
+            ForEachIndex(imagesToDecode.size(), 1, [&](size_t i) {
+                const auto imageIndex = imagesToDecode[i];
+                const auto& image = m_document.images[imageIndex];
+                auto& prepared = m_preparedImages[imageIndex];
+
+                try
                 {
                     std::vector<uint8_t> embeddedData;
-                    image.MaterializeData(embeddedData);
-                    return TextureLoader::LoadTexture(m_renderer, std::as_bytes(std::span {embeddedData}));
+                    if (const auto data = GetImageData(image, embeddedData))
+                    {
+                        if (m_textureCache)
+                            prepared.Hash = TextureCache::ComputeHash(*data);
+                        prepared.Image = TextureLoader::DecodeImage(*data);
+                    }
+                    else
+                        prepared.Image = TextureLoader::DecodeImage(m_currentPath / image.uri);
                 }
+                catch (const std::exception& exception)
+                {
+                    prepared.Error = exception.what();
+                }
+            });
+        }
 
-                auto fullPath = m_currentPath / image.uri;
-                return TextureLoader::LoadTexture(m_renderer, fullPath.generic_string());
-            }();
-
-            if (!loadedTexture || texture.sampler < 0)
-                return loadedTexture;
-
-            const auto& sampler = m_document.samplers[texture.sampler];
+        void PrepareMeshes()
+        {
+            m_preparedMeshes.resize(m_document.meshes.size());
 
-            if (sampler.wrapS != sampler.wrapT)
-                Log::Warning() << "wrapS != wrapT, using first" << std::endl;
+            // meshes are usually small, so they are grouped
+            ForEachIndex(m_document.meshes.size(), 16, [this](size_t meshIndex) {
+                const auto& primitives = m_document.meshes[meshIndex].primitives;
 
-            loadedTexture->SetWrapMode({TranslateWrappingMode(sampler.wrapS), TranslateWrappingMode(sampler.wrapT)});
-            loadedTexture->SetSamplingMode(
-                TextureSamplingParams {TranslateMagFilter(sampler.magFilter), TranslateMinFilter(sampler.minFilter)});
+                auto& preparedPrimitives = m_preparedMeshes[meshIndex];
+                preparedPrimitives.reserve(primitives.size());
+                for (const auto& primitive : primitives)
+                    preparedPrimitives.push_back(PreparePrimitive(primitive, m_packVertices, m_optimizeMeshes, m_buildMeshlets));
+            });
 
-            return loadedTexture;
+            for (size_t meshIndex = 0; meshIndex < m_preparedMeshes.size(); ++meshIndex)
+            {
+                MeshOptimizer::Statistics original, optimized;
+                for (const auto& preparedPrimitive : m_preparedMeshes[meshIndex])
+                {
+                    if (preparedPrimitive.OriginalStatistics && preparedPrimitive.OptimizedStatistics)
+                    {
+                        original += *preparedPrimitive.OriginalStatistics;
+                        optimized += *preparedPrimitive.OptimizedStatistics;
+                    }
+                }
 
-            //TODO: support all sampler parameters
+                if (optimized.NumTriangles > 0)
+                    Log::Debug() << "Mesh '" << m_document.meshes[meshIndex].name << "' optimized: ACMR " << original.GetACMR() << " -> "
+                                 << optimized.GetACMR() << ", ATVR " << original.GetATVR() << " -> " << optimized.GetATVR() << std::endl;
+            }
         }
 
 
-        std::unique_ptr<IUniformContainer> TranslateMaterial(const fx::gltf::Material& material)
+        // materialIndex is the index the material will have in the mesh
+        std::unique_ptr<IUniformContainer> TranslateMaterial(const fx::gltf::Material& material, const MeshRef& mesh, size_t materialIndex)
         {
             auto container = std::make_unique<UniformContainer>();
 
             const auto trySetTexture = [&](const std::string& paramName, const fx::gltf::Material::Texture& texture, auto&& defaultValueGetter) {
                 //Utils::lazy defaultValue {std::forward<decltyle(defaultValueGetter)>(defaultValueGetter)};
                 if (!texture.empty())
-                    container->SetUniform(paramName, m_textures[texture.index]);
-                else
-                    container->SetUniform(paramName, defaultValueGetter());
+                {
+                    const auto& [loadedTexture, listeners] = m_textures[texture.index];
+                    if (loadedTexture)
+                    {
+                        container->SetUniform(paramName, loadedTexture);
+                        return;
+                    }
+
+                    if (listeners)
+                        listeners->push_back([weakMesh = std::weak_ptr {mesh}, materialIndex, paramName](const TextureRef& readyTexture) {
+                            if (const auto readyMesh = weakMesh.lock())
+                                readyMesh->Materials.at(materialIndex)->SetUniform(paramName, readyTexture);
+                        });
+                }
+
+                container->SetUniform(paramName, defaultValueGetter());
             };
 
             //functions to lazily getting default textures
@@ -464,100 +1055,419 @@ namespace
 
         // Geometry
 
-        struct BufferDataInfo
+        SubmeshGroup LoadMesh(size_t meshIndex)
         {
-            BufferBindingParams bindingParams;
-            uint32_t count;
-            std::span<const std::byte> data;
-        };
+            const auto& gltfMesh = m_document.meshes[meshIndex];
 
-        //TODO: make type-safe!!!
-        BufferDataInfo GetData(unsigned attribIndex)
+            SubmeshGroup result {gltfMesh.primitives.size()};
+            for (size_t index = 0; const auto& primitive : gltfMesh.primitives)
+            {
+                const auto& prepared = m_preparedMeshes[meshIndex][index];
+                auto placement = prepared.PackedVertices ? m_geometryPool.Place(*prepared.PackedVertices, prepared.Indices)
+                                                         : m_geometryPool.Place(prepared.VertexStreams, prepared.Indices);
+
+                auto mesh = std::make_shared<Mesh>("Primitive submesh #"s + std::to_string(index));
+                mesh->VertexArray = std::move(placement.VertexArray);
+                auto& subMesh = mesh->SubMeshes.emplace_back(std::vector {GetLodChunk(placement.Chunk, prepared, 0)});
+                for (size_t lod = 1; lod <= prepared.Lods.size(); ++lod)
+                    subMesh.Lods.push_back({prepared.Lods[lod - 1].Error, {GetLodChunk(placement.Chunk, prepared, lod)}});
+                if (!prepared.Meshlets.empty())
+                {
+                    auto meshlets = std::make_shared<MeshletSet>();
+                    meshlets->Append(prepared.Meshlets, subMesh.Primitives.front());
+                    subMesh.Meshlets = std::move(meshlets);
+                }
+                if (primitive.material >= 0)
+                    mesh->Materials.emplace_back(TranslateMaterial(m_document.materials[primitive.material], mesh, mesh->Materials.size()));
+
+
+                result[index++] = std::move(mesh);
+            }
+
+            return result;
+        }
+    };
+
+    // Converts the document into the cooked form: geometry is prepared like for loading, then primitives of the same
+    // vertex format and index type are merged into one mesh, see CookedScene
+    class Cooker : private DocumentReader
+    {
+        // Primitives sharing the vertex format and index type
+        struct GeometryGroup
         {
-            //TODO: support sparce accesors
+            std::vector<VertexPacker::PackedAttribute> Attributes;
+            std::optional<BufferDataType> IndexType;
+            size_t NumVertices = 0;
+            std::vector<std::byte> Vertices;
+            std::vector<std::byte> Indices;
+        };
 
-            const auto& accessor = m_document.accessors[attribIndex];
-            const auto& bufferView = m_document.bufferViews[accessor.bufferView];
-            const auto& buffer = m_document.buffers[bufferView.buffer];
+        ThreadPool* m_threadPool;
+        CookedScene m_scene;
 
+        std::vector<GeometryGroup> m_geometryGroups; // one per cooked mesh
+        std::vector<std::vector<CookedScene::MeshInstance>> m_meshInstances; // per document mesh
+        std::optional<std::uint32_t> m_defaultMaterial;
+        std::vector<std::int32_t> m_nodeIndices; // cooked node of the document node, -1 if it's not in the scene
+        std::unordered_map<std::int32_t, CookedScene::Range> m_accessorData;
 
-            const auto dataType = TranslateDataType(accessor);
-            return {dataType, accessor.count,
-                    std::as_bytes(std::span {buffer.data})
-                        .subspan(static_cast<uint64_t>(bufferView.byteOffset) + accessor.byteOffset,
-                                 accessor.count * dataType.Stride)};
+    public:
+        Cooker(const std::filesystem::path& path, ThreadPool* threadPool)
+        : DocumentReader(path)
+        , m_threadPool(threadPool)
+        , m_meshInstances(m_document.meshes.size())
+        , m_nodeIndices(m_document.nodes.size(), -1)
+        {
         }
 
-        SubmeshGroup LoadMesh(const fx::gltf::Mesh& gltfMesh)
+        CookedScene Cook()
         {
-            const static auto requiredAttributes = std::to_array<std::pair<uint32_t, std::string>>(
-                {{1u, "POSITION"s}, {2u, "TEXCOORD_0"s}, {3u, "NORMAL"s}, {4u, "JOINTS_0"s}, {5u, "WEIGHTS_0"s}}); //"TANGENT"
+            CookTextures();
+            std::ranges::transform(m_document.materials, std::back_inserter(m_scene.Materials), &Cooker::TranslateMaterial);
+            CookMeshes();
+            CookNodes();
+            CookSkins();
+            CookAnimations();
+
+            return std::move(m_scene);
+        }
 
+    private:
+        void CookTextures()
+        {
+            // images could be referenced by several textures with different samplers
+            std::vector<std::optional<CookedScene::Range>> embeddedImages(m_document.images.size());
 
-            SubmeshGroup result {gltfMesh.primitives.size()};
-            for (size_t index = 0; const auto& primitive : gltfMesh.primitives)
+            for (const auto& texture : m_document.textures)
             {
-                const auto& rf = m_renderer.GetResourceFactory();
-                auto vao = rf.CreateVertexArray();
-                auto vb = rf.CreateBuffer(VertexBufferType::ArrayBuffer);
+                auto& cookedTexture = m_scene.Textures.emplace_back();
+                if (texture.sampler >= 0)
+                {
+                    const auto& sampler = m_document.samplers.at(texture.sampler);
+                    cookedTexture.Sampler = TextureCache::SamplerState {{TranslateWrappingMode(sampler.wrapS), TranslateWrappingMode(sampler.wrapT)},
+                                                                        {TranslateMagFilter(sampler.magFilter), TranslateMinFilter(sampler.minFilter)}};
+                }
 
+                if (texture.source < 0)
+                    continue;
 
-                std::vector<std::pair<uint32_t, BufferDataInfo>> buffersData;
-                for (const auto& [attribIndex, attribName] : requiredAttributes)
+                const auto& image = m_document.images.at(texture.source);
+                std::vector<uint8_t> embeddedData;
+                if (const auto data = GetImageData(image, embeddedData))
                 {
-                    if (auto it = primitive.attributes.find(attribName); it != primitive.attributes.end())
-                        buffersData.emplace_back(attribIndex, GetData(it->second));
+                    auto& range = embeddedImages[texture.source];
+                    if (!range)
+                        range = m_scene.AppendData(*data);
+
+                    cookedTexture.EmbeddedData = *range;
                 }
+                else
+                    cookedTexture.Path = std::filesystem::absolute(m_currentPath / image.uri);
+            }
+        }
 
-                const auto totalSize =
-                    std::accumulate(buffersData.begin(), buffersData.end(), size_t {},
-                                    [](size_t size, const auto& bdi) { return size + bdi.second.data.size_bytes(); });
+        // Same textures and placeholders as Loader::TranslateMaterial
+        static CookedScene::Material TranslateMaterial(const fx::gltf::Material& material)
+        {
+            const auto& pbr = material.pbrMetallicRoughness;
+            return {{{"u_texAlbedo"s, pbr.baseColorTexture.index, std::bit_cast<glm::vec4>(pbr.baseColorFactor)},
+                     {"u_texAoRoughnessMetallic"s, pbr.metallicRoughnessTexture.index, glm::vec4 {1.0, pbr.roughnessFactor, pbr.metallicFactor, 1.0}},
+                     {"u_texNormalMap"s, material.normalTexture.index, glm::vec4 {0.5, 0.5, 1.0, 1.0}}}};
+        }
 
-                vb->SetDataRaw(std::span<const std::byte> {static_cast<const std::byte*>(nullptr), totalSize});
+        std::uint32_t GetDefaultMaterial()
+        {
+            if (!m_defaultMaterial)
+            {
+                m_defaultMaterial = static_cast<std::uint32_t>(m_scene.Materials.size());
+                m_scene.Materials.push_back(TranslateMaterial(fx::gltf::Material {}));
+            }
 
-                for (size_t startPos = 0; auto& [attribIndex, bufferData] : buffersData)
-                {
-                    const size_t currentDataLength = bufferData.data.size_bytes();
-                    {
-                        BufferMapperGuard guard {*vb, startPos, currentDataLength, BufferUsage::Write};
-                        std::memcpy(guard.data(), bufferData.data.data(), currentDataLength);
-                    }
-                    bufferData.bindingParams.Offset = startPos;
+            return *m_defaultMaterial;
+        }
 
-                    vao->SetAttributeBinding(attribIndex, vb, bufferData.bindingParams);
-                    startPos += currentDataLength;
-                }
+        void CookMeshes()
+        {
+            std::vector<std::vector<PreparedPrimitive>> preparedMeshes(m_document.meshes.size());
+            const auto prepareMeshes = [&](size_t begin, size_t end) {
+                for (size_t meshIndex = begin; meshIndex < end; ++meshIndex)
+                    for (const auto& primitive : m_document.meshes[meshIndex].primitives)
+                        preparedMeshes[meshIndex].push_back(PreparePrimitive(primitive, true, true, true));
+            };
 
-                unsigned int primitivesCount = buffersData.front().second.count;
-                if (primitive.indices >= 0)
-                {
-                    const auto indexBufferInfo = GetData(primitive.indices);
+            if (m_threadPool)
+                m_threadPool->ParallelFor(preparedMeshes.size(), 16, prepareMeshes);
+            else
+                prepareMeshes(0, preparedMeshes.size());
+
+            for (size_t meshIndex = 0; meshIndex < preparedMeshes.size(); ++meshIndex)
+            {
+                const auto& primitives = m_document.meshes[meshIndex].primitives;
+                for (size_t index = 0; index < primitives.size(); ++index)
+                    AddPrimitive(meshIndex, index, primitives[index], preparedMeshes[meshIndex][index]);
+            }
+
+            for (size_t groupIndex = 0; groupIndex < m_geometryGroups.size(); ++groupIndex)
+            {
+                const auto& group = m_geometryGroups[groupIndex];
+                auto& cookedMesh = m_scene.Meshes[groupIndex];
+                cookedMesh.Vertices = m_scene.AppendData(group.Vertices);
+                if (group.IndexType)
+                    cookedMesh.Indices = m_scene.AppendData(group.Indices);
+            }
+
+            Log::Debug() << m_document.meshes.size() << " meshes are cooked into " << m_scene.Meshes.size() << " vertex formats" << std::endl;
+        }
+
+        void AddPrimitive(size_t meshIndex, size_t primitiveIndex, const fx::gltf::Primitive& primitive, const PreparedPrimitive& prepared)
+        {
+            if (!prepared.PackedVertices)
+                return;
+
+            const auto& vertices = *prepared.PackedVertices;
+            const auto indexType = prepared.Indices ? std::optional {prepared.Indices->Type} : std::nullopt;
+            const auto groupIndex = GetGeometryGroup(vertices.Attributes, indexType);
+            auto& group = m_geometryGroups[groupIndex];
+
+            MeshChunk chunk {TranslatePrimitiveMode(primitive.mode)};
+            if (prepared.Indices)
+            {
+                const auto indexSize = BufferDataTypes::GetSizeOf(prepared.Indices->Type);
+                chunk.StartElement = static_cast<unsigned int>(group.Indices.size() / indexSize);
+                chunk.Count = static_cast<unsigned int>(prepared.Indices->Data.size() / indexSize);
+                chunk.BaseVertex = static_cast<int>(group.NumVertices);
+                group.Indices.insert(group.Indices.end(), prepared.Indices->Data.begin(), prepared.Indices->Data.end());
+            }
+            else
+            {
+                chunk.StartElement = static_cast<unsigned int>(group.NumVertices);
+                chunk.Count = static_cast<unsigned int>(vertices.NumVertices);
+            }
+
+            group.Vertices.insert(group.Vertices.end(), vertices.Data.begin(), vertices.Data.end());
+            group.NumVertices += vertices.NumVertices;
+
+            auto& cookedMesh = m_scene.Meshes[groupIndex];
+            const auto materialIndex = primitive.material >= 0 ? static_cast<std::uint32_t>(primitive.material) : GetDefaultMaterial();
+            auto materialIt = std::ranges::find(cookedMesh.Materials, materialIndex);
+            if (materialIt == cookedMesh.Materials.end())
+            {
+                cookedMesh.Materials.push_back(materialIndex);
+                materialIt = std::prev(cookedMesh.Materials.end());
+            }
+
+            const auto subMeshIndex = static_cast<std::uint32_t>(cookedMesh.SubMeshes.size());
+            auto& subMesh = cookedMesh.SubMeshes.emplace_back();
+            subMesh.Name = "Primitive submesh #"s + std::to_string(primitiveIndex);
+            subMesh.MaterialIndex = static_cast<std::uint32_t>(materialIt - cookedMesh.Materials.begin());
+            subMesh.Chunks.push_back(GetLodChunk(chunk, prepared, 0));
+            for (size_t lod = 1; lod <= prepared.Lods.size(); ++lod)
+                subMesh.Lods.push_back({prepared.Lods[lod - 1].Error, {GetLodChunk(chunk, prepared, lod)}});
+
+            MeshletSet meshlets;
+            meshlets.Append(prepared.Meshlets, subMesh.Chunks.front());
+            subMesh.Meshlets.assign(meshlets.GetMeshlets().begin(), meshlets.GetMeshlets().end());
+
+            // document mesh is instanced by the cooked meshes it's primitives were placed to
+            auto& instances = m_meshInstances[meshIndex];
+            auto instanceIt = std::ranges::find(instances, static_cast<std::uint32_t>(groupIndex), &CookedScene::MeshInstance::Mesh);
+            if (instanceIt == instances.end())
+            {
+                instances.push_back({static_cast<std::uint32_t>(groupIndex)});
+                instanceIt = std::prev(instances.end());
+            }
+
+            instanceIt->SubMeshes.push_back(subMeshIndex);
+        }
+
+        size_t GetGeometryGroup(const std::vector<VertexPacker::PackedAttribute>& attributes, std::optional<BufferDataType> indexType)
+        {
+            const auto isSameAttribute = [](const VertexPacker::PackedAttribute& lhs, const VertexPacker::PackedAttribute& rhs) {
+                const auto& [lhsType, lhsCount, lhsStride, lhsOffset, lhsNormalized, lhsDivisor] = lhs.BindingParams;
+                const auto& [rhsType, rhsCount, rhsStride, rhsOffset, rhsNormalized, rhsDivisor] = rhs.BindingParams;
+                return lhs.AttributeIndex == rhs.AttributeIndex && lhsType == rhsType && lhsCount == rhsCount && lhsStride == rhsStride &&
+                       lhsOffset == rhsOffset && lhsNormalized == rhsNormalized && lhsDivisor == rhsDivisor;
+            };
+
+            const auto it = std::ranges::find_if(m_geometryGroups, [&](const GeometryGroup& group) {
+                return group.IndexType == indexType && std::ranges::equal(group.Attributes, attributes, isSameAttribute);
+            });
+            if (it != m_geometryGroups.end())
+                return static_cast<size_t>(it - m_geometryGroups.begin());
+
+            m_geometryGroups.push_back({attributes, indexType});
+
+            auto& cookedMesh = m_scene.Meshes.emplace_back();
+            cookedMesh.Name = "Geometry #"s + std::to_string(m_scene.Meshes.size() - 1);
+            cookedMesh.Attributes = attributes;
+            cookedMesh.IndexType = indexType;
+
+            return m_geometryGroups.size() - 1;
+        }
+
+        // Nodes are added in depth-first order, so parents are always before their children
+
+        std::int32_t AddNode(std::string name, std::int32_t parent, const glm::mat4& transform)
+        {
+            auto& node = m_scene.Nodes.emplace_back();
+            node.Name = std::move(name);
+            node.Parent = parent;
+            node.Transform = transform;
+
+            return static_cast<std::int32_t>(m_scene.Nodes.size() - 1);
+        }
+
+        void CookNodes()
+        {
+            if (m_document.scene >= 0 && static_cast<size_t>(m_document.scene) < m_document.scenes.size())
+            {
+                const auto& scene = m_document.scenes[m_document.scene];
 
-                    auto ib = rf.CreateBuffer(VertexBufferType::IndexBuffer, indexBufferInfo.data);
-                    vao->SetIndexBuffer(ib, indexBufferInfo.bindingParams.Type);
+                const auto root = AddNode(scene.name + " root"s, -1, glm::mat4 {1.0f});
+                for (const auto nodeIndex : scene.nodes)
+                    CookNode(nodeIndex, root);
+            }
+            else
+            {
+                Log::Info() << "Scene graph is not available, cooking as individual meshes" << std::endl;
 
-                    primitivesCount = indexBufferInfo.count;
+                const auto root = AddNode("Model root"s, -1, glm::mat4 {1.0f});
+                for (size_t meshIndex = 0; meshIndex < m_document.meshes.size(); ++meshIndex)
+                {
+                    const auto node = AddNode("Mesh group '"s + m_document.meshes[meshIndex].name + "'"s, root, glm::mat4 {1.0f});
+                    m_scene.Nodes[node].Meshes = m_meshInstances[meshIndex];
                 }
+            }
+        }
 
-                auto mesh = std::make_unique<Mesh>("Primitive submesh #"s + std::to_string(index));
-                mesh->VertexArray = std::move(vao);
-                mesh->SubMeshes.emplace_back(std::vector {MeshChunk {Primitives::Triangles {}, 0, primitivesCount, 0}});
-                if (primitive.material >= 0)
-                    mesh->Materials.emplace_back(TranslateMaterial(m_document.materials[primitive.material]));
+        void CookNode(std::int32_t nodeIndex, std::int32_t parent)
+        {
+            if (nodeIndex < 0 || static_cast<size_t>(nodeIndex) >= m_document.nodes.size())
+                throw AT2IOException("scene has invalid node index");
+            if (m_nodeIndices[nodeIndex] >= 0)
+                throw AT2IOException("node #" + std::to_string(nodeIndex) + " has several parents");
 
+            const auto& node = m_document.nodes[nodeIndex];
+            const auto name = node.mesh >= 0 ? "Mesh group '"s + m_document.meshes.at(node.mesh).name + "'"s : node.name;
 
-                result[index++] = std::move(mesh);
+            const auto cookedIndex = AddNode(name, parent, GetNodeTransform(node));
+            m_nodeIndices[nodeIndex] = cookedIndex;
+
+            auto& cookedNode = m_scene.Nodes[cookedIndex];
+            if (node.mesh >= 0)
+                cookedNode.Meshes = m_meshInstances[node.mesh];
+            cookedNode.Skin = node.skin;
+
+            for (const auto childIndex : node.children)
+                CookNode(childIndex, cookedIndex);
+        }
+
+        std::uint32_t GetCookedNode(std::int32_t nodeIndex) const
+        {
+            if (nodeIndex < 0 || static_cast<size_t>(nodeIndex) >= m_nodeIndices.size() || m_nodeIndices[nodeIndex] < 0)
+                throw AT2IOException("node #" + std::to_string(nodeIndex) + " isn't a part of the scene");
+
+            return static_cast<std::uint32_t>(m_nodeIndices[nodeIndex]);
+        }
+
+        // Copies accessor data to the scene, data shared by several tracks is copied once
+        CookedScene::Range CookAccessor(std::int32_t accessorIndex)
+        {
+            if (const auto it = m_accessorData.find(accessorIndex); it != m_accessorData.end())
+                return it->second;
+
+            const auto range = m_scene.AppendData(GetData(static_cast<unsigned>(accessorIndex)).data);
+            m_accessorData.emplace(accessorIndex, range);
+            return range;
+        }
+
+        void CookSkins()
+        {
+            for (const auto& skin : m_document.skins)
+            {
+                auto& cookedSkin = m_scene.Skins.emplace_back();
+                std::ranges::transform(skin.joints, std::back_inserter(cookedSkin.Joints), std::bind_front(&Cooker::GetCookedNode, this));
+
+                if (skin.inverseBindMatrices >= 0)
+                    cookedSkin.InverseBindMatrices = CookAccessor(skin.inverseBindMatrices);
+                else
+                {
+                    const std::vector<glm::mat4> identityMatrices(skin.joints.size(), glm::mat4 {1.0f});
+                    cookedSkin.InverseBindMatrices = m_scene.AppendData(std::as_bytes(std::span {identityMatrices}));
+                }
             }
+        }
 
-            return result;
+        void CookAnimations()
+        {
+            for (const auto& animation : m_document.animations)
+            {
+                auto& cookedAnimation = m_scene.Animations.emplace_back();
+                cookedAnimation.Name = animation.name;
+
+                for (const auto& channel : animation.channels)
+                {
+                    if (const auto track = CookTrack(animation.samplers.at(channel.sampler), channel))
+                        cookedAnimation.Tracks.push_back(*track);
+                }
+            }
+        }
+
+        std::optional<CookedScene::Track> CookTrack(const fx::gltf::Animation::Sampler& sampler, const fx::gltf::Animation::Channel& channel)
+        {
+            CookedScene::Track track;
+            if (channel.target.path == "translation")
+                track.Target = CookedScene::TrackTarget::Translation;
+            else if (channel.target.path == "rotation")
+                track.Target = CookedScene::TrackTarget::Rotation;
+            else if (channel.target.path == "scale")
+                track.Target = CookedScene::TrackTarget::Scale;
+            else
+                return std::nullopt; //"weights"
+
+            const unsigned char valueSize = track.Target == CookedScene::TrackTarget::Rotation ? 4 : 3;
+
+            const auto inputChannelData = GetData(sampler.input);
+            const auto outputChannelData = GetData(sampler.output);
+            if (inputChannelData.bindingParams.Type != BufferDataType::Float || inputChannelData.bindingParams.Count != 1)
+                throw std::logic_error("unsupported input channel format");
+            if (outputChannelData.bindingParams.Type != BufferDataType::Float || outputChannelData.bindingParams.Count != valueSize)
+                throw std::logic_error("unsupported output channel format");
+
+            track.Node = GetCookedNode(channel.target.node);
+            track.Mode = TranslateCookedInterpolation(sampler.interpolation);
+            track.Keys = CookAccessor(sampler.input);
+            track.Values = CookAccessor(sampler.output);
+            return track;
         }
     };
 } // namespace
 
-NodeRef GltfMeshLoader::LoadScene(IVisualizationSystem& renderer, const str& sv)
+NodeRef GltfMeshLoader::LoadScene(IVisualizationSystem& renderer, const str& sv, AsyncTextureLoader* asyncTextureLoader,
+                                  TextureCache* textureCache, ThreadPool* threadPool, bool packVertices, bool optimizeMeshes,
+                                  bool buildMeshlets, Timings* timings)
 {
     Log::Info() << "Loading model from '" << sv << "'." << std::endl;
 
-    Loader loader {renderer, sv};
-    return loader.BuildScene();
+    GltfMeshLoader::Timings loadTimings;
+    std::optional<Loader> loader;
+    {
+        ScopedTimer timer {loadTimings.Parse};
+        loader.emplace(renderer, sv, asyncTextureLoader, textureCache, threadPool, packVertices, optimizeMeshes, buildMeshlets, loadTimings);
+    }
+
+    auto scene = loader->BuildScene();
+
+    Log::Info() << "Model loaded: parse " << loadTimings.Parse.count() << " ms, decode " << loadTimings.Decode.count() << " ms, upload "
+                << loadTimings.Upload.count() << " ms, build " << loadTimings.Build.count() << " ms" << std::endl;
+    if (timings)
+        *timings = loadTimings;
+
+    return scene;
+}
+
+CookedScene GltfMeshLoader::Cook(const std::filesystem::path& path, ThreadPool* threadPool)
+{
+    Log::Info() << "Cooking model from '" << path.string() << "'." << std::endl;
+    return Cooker {path, threadPool}.Cook();
 }
@@ -2,11 +2,48 @@
 
 #include <Scene/Scene.h>
 
+#include <chrono>
+#include <filesystem>
+
+namespace AT2
+{
+    class ThreadPool;
+}
+
 namespace AT2::Resources
 {
+    class AsyncTextureLoader;
+    class CookedScene;
+    class TextureCache;
+
     class GltfMeshLoader
     {
     public:
-        static std::shared_ptr<Scene::Node> LoadScene(IVisualizationSystem& renderer, const str& sv);
+        // Wall time of the loading stages
+        struct Timings
+        {
+            using Duration = std::chrono::duration<double, std::milli>;
+
+            Duration Parse {};  // mapping of files and parsing of JSON
+            Duration Decode {}; // CPU-side preparation of images and geometry, parallel when threadPool is given
+            Duration Upload {}; // creation of GPU resources and materials
+            Duration Build {};  // scene graph, animations and skins
+        };
+
+        // When asyncTextureLoader is given, textures are loaded in background and placeholders are used until then.
+        // Every image is loaded once, textures with own samplers are views of it. textureCache shares images between scenes,
+        // it must outlive asynchronous loading. With threadPool images and meshes are prepared at it's workers, while GPU
+        // resources are still created at the calling thread. packVertices enables quantized interleaved vertices, see VertexPacker.
+        // optimizeMeshes reorders indexed triangles and their vertices, see MeshOptimizer, and generates levels of detail of
+        // them, see MeshSimplifier. buildMeshlets splits optimized triangles into meshlets for ClusterCuller.
+        static std::shared_ptr<Scene::Node> LoadScene(IVisualizationSystem& renderer, const str& sv,
+                                                      AsyncTextureLoader* asyncTextureLoader = nullptr,
+                                                      TextureCache* textureCache = nullptr, ThreadPool* threadPool = nullptr,
+                                                      bool packVertices = true, bool optimizeMeshes = true, bool buildMeshlets = false,
+                                                      Timings* timings = nullptr);
+
+        // Converts the model to the cooked form with packed and optimized geometry, it's levels of detail and meshlets, see CookedScene.
+        // Images stored inside of the model are copied as is, external ones are referenced by their paths.
+        static CookedScene Cook(const std::filesystem::path& path, ThreadPool* threadPool = nullptr);
     };
 } // namespace AT2
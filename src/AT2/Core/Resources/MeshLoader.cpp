@@ -5,11 +5,17 @@
 #include <assimp/pbrmaterial.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <cstring>
 #include <filesystem>
 #include <map>
 #include <utility>
 
-#include "TextureLoader.h"
+#include "CookedScene.h"
+#include "CookedSceneLoader.h"
+#include "../MeshletSet.h"
+#include "../MeshOptimizer.h"
+#include "../MeshSimplifier.h"
+#include "../VertexPacker.h"
 
 
 using namespace std::literals;
@@ -20,36 +26,39 @@ using namespace AT2::Resources;
 
 namespace
 {
-    class MeshBuilder
+    // All meshes of the scene are merged into one cooked mesh with a submesh per aiMesh
+    class MeshCooker
     {
     public:
-        MeshBuilder(IVisualizationSystem& _renderer, const aiScene* scene) :
-            m_scene(scene), m_renderer(_renderer)
+        MeshCooker(const aiScene* scene, std::filesystem::path scenePath) :
+            m_scene(scene), m_scenePath(std::move(scenePath))
         {
         }
 
     public:
-        std::shared_ptr<Node> Build()
+        CookedScene Cook()
         {
             assert(m_indicesVec.empty());
-            BuildVAO();
+            CookGeometry();
 
-            m_buildingMesh->Materials.reserve(m_scene->mNumMaterials);
+            m_cookedScene.Materials.reserve(m_scene->mNumMaterials);
             for (size_t i = 0; i < m_scene->mNumMaterials; ++i)
-                m_buildingMesh->Materials.push_back(TranslateMaterial(m_scene->mMaterials[i]));
+                m_cookedScene.Materials.push_back(TranslateMaterial(m_scene->mMaterials[i]));
 
-            auto rootNode = std::make_shared<Node>("Root");
-            TraverseNode(m_scene->mRootNode, *rootNode);
+            auto& cookedMesh = m_cookedScene.Meshes.front();
+            for (std::uint32_t i = 0; i < m_scene->mNumMaterials; ++i)
+                cookedMesh.Materials.push_back(i);
 
-            return rootNode;
+            TraverseNode(m_scene->mRootNode, -1, "Root");
+
+            return std::move(m_cookedScene);
         }
 
     protected:
-        std::shared_ptr<Mesh> m_buildingMesh = std::make_shared<Mesh>();
-        std::filesystem::path m_scenePath;
-        Assimp::Importer m_importer;
         const aiScene* m_scene;
-        IVisualizationSystem& m_renderer;
+        std::filesystem::path m_scenePath;
+        CookedScene m_cookedScene;
+        std::map<std::string, std::int32_t, std::less<>> m_textures;
 
 
         std::vector<glm::vec3> m_verticesVec;
@@ -58,52 +67,92 @@ namespace
         std::vector<std::uint32_t> m_indicesVec;
 
     protected:
-        void AddMesh(const aiMesh* mesh)
+        void AddMesh(const aiMesh* mesh, CookedScene::Mesh& cookedMesh)
         {
             const auto vertexOffset = static_cast<std::uint32_t>(m_verticesVec.size());
             const auto previousIndexOffset = static_cast<unsigned>(m_indicesVec.size());
 
-            m_verticesVec.insert(m_verticesVec.end(), reinterpret_cast<glm::vec3*>(mesh->mVertices),
-                                 reinterpret_cast<glm::vec3*>(mesh->mVertices) + mesh->mNumVertices);
-            m_texCoordVec.insert(m_texCoordVec.end(), reinterpret_cast<glm::vec3*>(mesh->mTextureCoords[0]),
-                                 reinterpret_cast<glm::vec3*>(mesh->mTextureCoords[0]) + mesh->mNumVertices);
-            m_normalsVec.insert(m_normalsVec.end(), reinterpret_cast<glm::vec3*>(mesh->mNormals),
-                                reinterpret_cast<glm::vec3*>(mesh->mNormals) + mesh->mNumVertices);
-
+            std::vector<std::uint32_t> indices;
+            indices.reserve(mesh->mNumFaces * 3);
             for (size_t j = 0; j < mesh->mNumFaces; ++j)
             {
                 const aiFace& face = mesh->mFaces[j];
                 assert(face.mNumIndices == 3);
 
-                m_indicesVec.push_back(face.mIndices[0] + vertexOffset);
-                m_indicesVec.push_back(face.mIndices[1] + vertexOffset);
-                m_indicesVec.push_back(face.mIndices[2] + vertexOffset);
+                indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
             }
 
-            m_buildingMesh->SubMeshes.emplace_back(
-                std::vector<MeshChunk> {MeshChunk {Primitives::Triangles {}, previousIndexOffset, mesh->mNumFaces * 3}},
-                mesh->mMaterialIndex, mesh->mName.C_Str());
+            // reorder triangles for vertex cache and overdraw, append levels of detail, then reorder vertices in the order of use
+            const size_t numVertices = mesh->mNumVertices;
+            const auto positions = std::span {reinterpret_cast<const glm::vec3*>(mesh->mVertices), numVertices};
+            const auto originalStatistics = MeshOptimizer::AnalyzeVertexCache(indices, numVertices);
+            indices = MeshOptimizer::OptimizeVertexCache(indices, numVertices);
+            indices = MeshOptimizer::OptimizeOverdraw(indices, positions);
+            const auto numFullDetailIndices = static_cast<unsigned>(indices.size());
+            const auto lods = MeshSimplifier::AppendLods(indices, positions);
+            const auto remap = MeshOptimizer::OptimizeVertexFetch(indices, numVertices);
+
+            const auto optimizedStatistics =
+                MeshOptimizer::AnalyzeVertexCache(std::span {indices}.first(numFullDetailIndices), originalStatistics.NumUsedVertices);
+            Log::Debug() << "Mesh '" << mesh->mName.C_Str() << "' optimized: ACMR " << originalStatistics.GetACMR() << " -> "
+                         << optimizedStatistics.GetACMR() << ", ATVR " << originalStatistics.GetATVR() << " -> "
+                         << optimizedStatistics.GetATVR() << ", " << lods.size() << " levels of detail" << std::endl;
+
+            const auto appendVertices = [&remap, numVertices](std::vector<glm::vec3>& target, const aiVector3D* source) {
+                const auto remapped = MeshOptimizer::RemapVertices(
+                    std::as_bytes(std::span {reinterpret_cast<const glm::vec3*>(source), numVertices}), sizeof(glm::vec3), remap);
+
+                const auto previousSize = target.size();
+                target.resize(previousSize + remapped.size() / sizeof(glm::vec3));
+                std::memcpy(target.data() + previousSize, remapped.data(), remapped.size());
+            };
+            appendVertices(m_verticesVec, mesh->mVertices);
+            appendVertices(m_texCoordVec, mesh->mTextureCoords[0]);
+            appendVertices(m_normalsVec, mesh->mNormals);
+
+            // meshlets are split of the final indices, so they refer to the remapped positions
+            const auto meshlets = MeshletSet::Build(std::span {indices}.first(numFullDetailIndices),
+                                                    std::span {m_verticesVec}.subspan(vertexOffset));
+
+            std::ranges::transform(indices, std::back_inserter(m_indicesVec), [vertexOffset](std::uint32_t index) { return index + vertexOffset; });
+
+            auto& subMesh = cookedMesh.SubMeshes.emplace_back();
+            subMesh.Name = mesh->mName.C_Str();
+            subMesh.MaterialIndex = mesh->mMaterialIndex;
+            subMesh.Chunks.push_back(MeshChunk {Primitives::Triangles {}, previousIndexOffset, numFullDetailIndices});
+            for (const auto& [firstIndex, count, error] : lods)
+                subMesh.Lods.push_back({error, {MeshChunk {Primitives::Triangles {}, previousIndexOffset + firstIndex, count}}});
+
+            MeshletSet placedMeshlets;
+            placedMeshlets.Append(meshlets, subMesh.Chunks.front());
+            subMesh.Meshlets.assign(placedMeshlets.GetMeshlets().begin(), placedMeshlets.GetMeshlets().end());
         }
 
-        void BuildVAO()
+        void CookGeometry()
         {
+            auto& cookedMesh = m_cookedScene.Meshes.emplace_back();
             for (unsigned i = 0; i < m_scene->mNumMeshes; ++i)
-                AddMesh(m_scene->mMeshes[i]);
-
-            auto& rf = m_renderer.GetResourceFactory();
-
-            auto vao = MakeVertexArray(rf, std::make_pair(1u, std::cref(m_verticesVec)),
-                                       std::make_pair(2u, std::cref(m_texCoordVec)),
-                                       std::make_pair(3u, std::cref(m_normalsVec)));
-            vao->SetIndexBuffer(rf.MakeBufferFrom(VertexBufferType::IndexBuffer, m_indicesVec),
-                                BufferDataType::UInt);
-
-            m_buildingMesh->VertexArray = vao;
+                AddMesh(m_scene->mMeshes[i], cookedMesh);
+
+            using Semantic = VertexPacker::Semantic;
+            const auto vertexAttributes = std::to_array<VertexPacker::Attribute>({
+                {1u, Semantic::Position, BufferDataTypes::Vec3, std::as_bytes(std::span {m_verticesVec})},
+                {2u, Semantic::TexCoord, BufferDataTypes::Vec3, std::as_bytes(std::span {m_texCoordVec})},
+                {3u, Semantic::Normal, BufferDataTypes::Vec3, std::as_bytes(std::span {m_normalsVec})},
+            });
+            const auto packedVertices = VertexPacker::Pack(vertexAttributes);
+
+            cookedMesh.Attributes = packedVertices.Attributes;
+            cookedMesh.Vertices = m_cookedScene.AppendData(packedVertices.Data);
+
+            const auto packedIndices = MeshOptimizer::PackIndices(m_indicesVec);
+            cookedMesh.IndexType = packedIndices.Type;
+            cookedMesh.Indices = m_cookedScene.AppendData(packedIndices.Data);
         }
 
-        std::unique_ptr<IUniformContainer> TranslateMaterial(const aiMaterial* material)
+        CookedScene::Material TranslateMaterial(const aiMaterial* material)
         {
-            std::unique_ptr<IUniformContainer> container = std::make_unique<UniformContainer>();
+            CookedScene::Material result;
 
             constexpr std::tuple<aiTextureType, unsigned, std::string_view> knownTextureFlavors[] = {
                 {aiTextureType_DIFFUSE, 0, "u_texAlbedo"sv},
@@ -112,58 +161,66 @@ namespace
                 {aiTextureType_HEIGHT, 0, "u_texNormalMap"sv},
                 {AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_METALLICROUGHNESS_TEXTURE, "u_texAoRoughnessMetallic"sv}};
 
-            auto loadTexture = [=](const char* path) -> TextureRef {
-                if (const aiTexture* embeddedTexture = m_scene->GetEmbeddedTexture(path))
-                {
-                    if (embeddedTexture->mHeight)
-                        throw AT2TextureException("reading raw texture from memory not implemented yet");
-
-                    return TextureLoader::LoadTexture(m_renderer,
-                                                      std::span {reinterpret_cast<const std::byte*>(embeddedTexture->pcData), embeddedTexture->mWidth});
-                }
-
-                //it's not embedded
-                return TextureLoader::LoadTexture(m_renderer, path);
-            };
-
-            std::map<str, std::shared_ptr<ITexture>, std::less<>> textures;
             for (auto [type, index, name] : knownTextureFlavors)
             {
-                if (textures.find(name) != textures.end())
+                if (std::ranges::find(result.Textures, name, &CookedScene::MaterialTexture::UniformName) != result.Textures.end())
                     continue;
 
                 if (aiString path; material->GetTexture(type, index, &path) == aiReturn_SUCCESS && path.length > 0)
-                {
-                    if (auto texture = loadTexture(path.C_Str()))
-                    {
-                        textures.emplace(name, texture);
-                        container->SetUniform(str {name}, texture);
-                    }
-                }
+                    result.Textures.push_back({str {name}, GetTexture(path.C_Str())});
             }
 
-            return container;
+            return result;
         }
 
-        void TraverseNode(const aiNode* node, Node& baseNode)
+        // Embedded textures are copied to the scene data, textures with the same path are shared by materials
+        std::int32_t GetTexture(const char* path)
         {
-            baseNode.SetTransform(ConvertMatrix(node->mTransformation));
+            if (const auto it = m_textures.find(path); it != m_textures.end())
+                return it->second;
+
+            CookedScene::Texture texture;
+            if (const aiTexture* embeddedTexture = m_scene->GetEmbeddedTexture(path))
+            {
+                if (embeddedTexture->mHeight)
+                    throw AT2TextureException("reading raw texture from memory not implemented yet");
+
+                texture.EmbeddedData = m_cookedScene.AppendData(
+                    std::span {reinterpret_cast<const std::byte*>(embeddedTexture->pcData), embeddedTexture->mWidth});
+            }
+            else
+            {
+                //it's not embedded, usually it's relative to the model
+                const std::filesystem::path texturePath {path};
+                const auto modelRelativePath = m_scenePath.parent_path() / texturePath;
+                texture.Path = std::filesystem::absolute(texturePath.is_relative() && std::filesystem::exists(modelRelativePath) ? modelRelativePath : texturePath);
+            }
+
+            const auto textureIndex = static_cast<std::int32_t>(m_cookedScene.Textures.size());
+            m_cookedScene.Textures.push_back(std::move(texture));
+            m_textures.emplace(path, textureIndex);
+
+            return textureIndex;
+        }
+
+        void TraverseNode(const aiNode* node, std::int32_t parent, std::string name)
+        {
+            const auto nodeIndex = static_cast<std::int32_t>(m_cookedScene.Nodes.size());
+
+            auto& cookedNode = m_cookedScene.Nodes.emplace_back();
+            cookedNode.Name = std::move(name);
+            cookedNode.Parent = parent;
+            cookedNode.Transform = ConvertMatrix(node->mTransformation);
             for (unsigned i = 0; i < node->mNumMeshes; i++)
             {
-                const unsigned meshIndex = node->mMeshes[i];
                 //TODO: don't multiply components when materials are the same
-                baseNode.addComponent(std::make_unique<MeshComponent>(m_buildingMesh, std::vector {meshIndex}));
+                cookedNode.Meshes.push_back({0, {node->mMeshes[i]}});
             }
 
             for (size_t i = 0; i < node->mNumChildren; i++)
             {
                 auto* children = node->mChildren[i];
-
-                auto subNode = std::make_shared<Node>();
-                subNode->SetName(children->mName.C_Str());
-                baseNode.AddChild(subNode);
-
-                TraverseNode(children, *subNode);
+                TraverseNode(children, nodeIndex, children->mName.C_Str());
             }
         }
 
@@ -174,7 +231,7 @@ namespace
         aiProcess_GenSmoothNormals | //can't be specified with aiProcess_GenNormals
         aiProcess_FindInstances | aiProcess_FindDegenerates | aiProcess_FindInvalidData | aiProcess_CalcTangentSpace |
         aiProcess_ValidateDataStructure | aiProcess_OptimizeMeshes | aiProcess_OptimizeGraph |
-        aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality | aiProcess_LimitBoneWeights |
+        aiProcess_JoinIdenticalVertices | aiProcess_LimitBoneWeights | // cache locality is improved by MeshOptimizer
         aiProcess_RemoveRedundantMaterials | aiProcess_SplitLargeMeshes | aiProcess_Triangulate |
         aiProcess_GenUVCoords | aiProcess_GenBoundingBoxes | aiProcess_SplitByBoneCount | aiProcess_SortByPType |
         aiProcess_FlipUVs);
@@ -182,10 +239,17 @@ namespace
 }; // namespace
 
 std::shared_ptr<Node> MeshLoader::LoadNode(IVisualizationSystem& renderer, const str& filename)
+{
+    return CookedSceneLoader::BuildScene(renderer, Cook(filename));
+}
+
+CookedScene MeshLoader::Cook(const std::filesystem::path& path)
 {
     Assimp::Importer importer;
-    const auto* scene = importer.ReadFile(filename, flags);
+    const auto* scene = importer.ReadFile(path.string(), flags);
+    if (!scene || !scene->mRootNode)
+        throw AT2IOException("can't import '" + path.string() + "': " + importer.GetErrorString());
 
-    MeshBuilder builder {renderer, scene};
-    return builder.Build();
+    MeshCooker cooker {scene, path};
+    return cooker.Cook();
 }
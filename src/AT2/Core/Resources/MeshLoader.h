@@ -2,11 +2,19 @@
 
 #include <Scene/Scene.h>
 
+#include <filesystem>
+
 namespace AT2::Resources
 {
+    class CookedScene;
+
     class MeshLoader
     {
     public:
         static std::shared_ptr<Scene::Node> LoadNode(IVisualizationSystem& renderer, const str& sv);
+
+        // Imports the model and converts it to the cooked form, LoadNode builds the scene of it. Throws AT2IOException
+        // if the model can't be imported.
+        static CookedScene Cook(const std::filesystem::path& path);
     };
 } // namespace AT2
@@ -0,0 +1,393 @@
+#include "MipmapGenerator.h"
+
+#include "../ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+#include <glm/gtc/packing.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIPMAPS_USE_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIPMAPS_USE_NEON
+#endif
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    // in destination texels
+    constexpr double KaiserRadius = 2.0;
+    constexpr double KaiserAlpha = 4.0;
+
+    // rows are grouped, so small levels don't produce tiny tasks
+    constexpr size_t MinTexelsPerTask = 16 * 1024;
+
+    // Zeroth order modified Bessel function of the first kind
+    double BesselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32 && term > sum * 1e-12; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    double KaiserSinc(double x)
+    {
+        if (std::abs(x) >= KaiserRadius)
+            return 0.0;
+
+        const double sinc = x == 0.0 ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+        const double t = x / KaiserRadius;
+        return sinc * BesselI0(KaiserAlpha * std::sqrt(1.0 - t * t)) / BesselI0(KaiserAlpha);
+    }
+
+    // Source texels contributing to the destination one, indices should be clamped to the image
+    struct Taps
+    {
+        int First = 0;
+        std::vector<float> Weights;
+    };
+
+    std::vector<Taps> ComputeTaps(unsigned sourceSize, unsigned destinationSize, MipmapFilter filter)
+    {
+        std::vector<Taps> result(destinationSize);
+        if (sourceSize == destinationSize)
+        {
+            for (unsigned i = 0; i < destinationSize; ++i)
+                result[i] = {static_cast<int>(i), {1.0f}};
+            return result;
+        }
+
+        const double scale = static_cast<double>(sourceSize) / destinationSize;
+        const double radius = (filter == MipmapFilter::Box ? 0.5 : KaiserRadius) * scale;
+
+        for (unsigned i = 0; i < destinationSize; ++i)
+        {
+            // texel j covers [j, j + 1]
+            const double center = (i + 0.5) * scale;
+            const auto first = static_cast<int>(std::floor(center - radius));
+            const auto last = static_cast<int>(std::ceil(center + radius));
+
+            auto& taps = result[i];
+            taps.First = first;
+
+            double sum = 0.0;
+            std::vector<double> weights;
+            for (int j = first; j < last; ++j)
+            {
+                const double weight = filter == MipmapFilter::Box
+                    ? std::max(0.0, std::min(j + 1.0, center + radius) - std::max(static_cast<double>(j), center - radius))
+                    : KaiserSinc((j + 0.5 - center) / scale);
+
+                weights.push_back(weight);
+                sum += weight;
+            }
+
+            for (const double weight : weights)
+                taps.Weights.push_back(static_cast<float>(weight / sum));
+        }
+
+        return result;
+    }
+
+    const std::array<float, 256>& GetSRGBToLinearTable()
+    {
+        static const auto table = [] {
+            std::array<float, 256> result {};
+            for (size_t i = 0; i < result.size(); ++i)
+            {
+                const float value = static_cast<float>(i) / 255.0f;
+                result[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+            return result;
+        }();
+
+        return table;
+    }
+
+    float LinearToSRGB(float value)
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    size_t Clamp(int index, size_t size)
+    {
+        return static_cast<size_t>(std::clamp(index, 0, static_cast<int>(size) - 1));
+    }
+
+    static_assert(sizeof(glm::vec4) == 4 * sizeof(float));
+
+    // destination[i] += source[i] * weight, the kernel of all filtering passes
+    void AccumulateRow(glm::vec4* destination, const glm::vec4* source, size_t count, float weight)
+    {
+#if defined(MIPMAPS_USE_SSE2)
+        const __m128 weights = _mm_set1_ps(weight);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float* texel = &destination[i].x;
+            _mm_storeu_ps(texel, _mm_add_ps(_mm_loadu_ps(texel), _mm_mul_ps(_mm_loadu_ps(&source[i].x), weights)));
+        }
+#elif defined(MIPMAPS_USE_NEON)
+        for (size_t i = 0; i < count; ++i)
+        {
+            float* texel = &destination[i].x;
+            vst1q_f32(texel, vmlaq_n_f32(vld1q_f32(texel), vld1q_f32(&source[i].x), weight));
+        }
+#else
+        for (size_t i = 0; i < count; ++i)
+            destination[i] += source[i] * weight;
+#endif
+    }
+
+    bool IsSupportedFormat(ExternalTextureFormat format)
+    {
+        return format.ChannelsLayout == TextureLayout::RGBA && format.Compression == BlockCompression::None &&
+            (format.DataType == BufferDataType::UByte || format.DataType == BufferDataType::HalfFloat || format.DataType == BufferDataType::Float);
+    }
+} // namespace
+
+MipmapGenerator::MipmapGenerator(MipmapFilter filter, bool isSRGB, ThreadPool* threadPool) :
+    m_filter {filter}, m_isSRGB {isSRGB}, m_threadPool {threadPool}
+{
+}
+
+unsigned MipmapGenerator::GetNumLevels(glm::uvec2 size) noexcept
+{
+    return GetNumLevels(glm::uvec3 {size, 1});
+}
+
+unsigned MipmapGenerator::GetNumLevels(glm::uvec3 size) noexcept
+{
+    return static_cast<unsigned>(std::bit_width(std::max({size.x, size.y, size.z})));
+}
+
+std::vector<MipmapGenerator::Image> MipmapGenerator::Generate(const Image& base) const
+{
+    const auto levelsData = Generate(TextureFormats::RGBA8, {base.Size, 1}, std::as_bytes(std::span {base.Texels}), GetNumLevels(base.Size));
+
+    std::vector<Image> levels;
+    levels.reserve(levelsData.size());
+    for (unsigned level = 0; level < levelsData.size(); ++level)
+    {
+        auto& image = levels.emplace_back();
+        image.Size = glm::max(base.Size >> level, glm::uvec2 {1});
+        image.Texels.resize(levelsData[level].size() / sizeof(glm::u8vec4));
+        std::memcpy(image.Texels.data(), levelsData[level].data(), levelsData[level].size());
+    }
+
+    return levels;
+}
+
+std::vector<std::vector<std::byte>> MipmapGenerator::Generate(ExternalTextureFormat format, glm::uvec3 size, std::span<const std::byte> base,
+                                                              unsigned numLevels) const
+{
+    if (!IsSupportedFormat(format))
+        throw AT2TextureException("MipmapGenerator: only RGBA8, RGBA16F and RGBA32F formats are supported");
+
+    if (base.size() != GetImageDataLength(format, size) || base.empty())
+        throw AT2TextureException("MipmapGenerator: image size doesn't match the data");
+
+    numLevels = std::clamp(numLevels, 1u, GetNumLevels(size));
+
+    std::vector<std::vector<std::byte>> levels;
+    levels.reserve(numLevels);
+    levels.emplace_back(base.begin(), base.end());
+
+    auto level = Decode(format, size, base);
+    for (unsigned i = 1; i < numLevels; ++i)
+    {
+        level = Downsample(level);
+        levels.push_back(Encode(format, level));
+    }
+
+    return levels;
+}
+
+void MipmapGenerator::Upload(ITexture& texture, ExternalTextureFormat format, std::span<const std::byte> base) const
+{
+    const auto& type = texture.GetType();
+    const auto size = texture.GetSize();
+
+    const auto numLevels = std::visit(
+        [](const auto& texture) {
+            if constexpr (requires { texture.getLevels(); })
+                return texture.getLevels();
+            else
+                return 1u;
+        },
+        type);
+
+    if (std::holds_alternative<Texture2D>(type))
+    {
+        const auto levels = Generate(format, {glm::xy(size), 1}, base, numLevels);
+        for (unsigned level = 0; level < levels.size(); ++level)
+            texture.SubImage2D({0, 0}, glm::max(glm::xy(size) >> level, glm::uvec2 {1}), level, format, levels[level].data());
+    }
+    else if (std::holds_alternative<Texture3D>(type))
+    {
+        const auto levels = Generate(format, size, base, numLevels);
+        for (unsigned level = 0; level < levels.size(); ++level)
+            texture.SubImage3D({0, 0, 0}, glm::max(size >> level, glm::uvec3 {1}), level, format, levels[level].data());
+    }
+    else if (std::holds_alternative<Texture2DArray>(type) || std::holds_alternative<TextureCube>(type))
+    {
+        // faces of cube maps are layers
+        const unsigned numLayers = size.z;
+        const auto layerLength = GetImageDataLength(format, {glm::xy(size), 1});
+        if (base.size() != layerLength * numLayers)
+            throw AT2TextureException("MipmapGenerator: image size doesn't match the data");
+
+        for (unsigned layer = 0; layer < numLayers; ++layer)
+        {
+            const auto levels = Generate(format, {glm::xy(size), 1}, base.subspan(layer * layerLength, layerLength), numLevels);
+            for (unsigned level = 0; level < levels.size(); ++level)
+                texture.SubImage3D({0, 0, layer}, {glm::max(glm::xy(size) >> level, glm::uvec2 {1}), 1}, level, format, levels[level].data());
+        }
+    }
+    else
+        throw AT2NotImplementedException("MipmapGenerator: unsupported texture type");
+}
+
+template <typename Func>
+void MipmapGenerator::ForEachRow(size_t numRows, size_t rowLength, const Func& func) const
+{
+    if (!m_threadPool)
+    {
+        func(size_t {0}, numRows);
+        return;
+    }
+
+    m_threadPool->ParallelFor(numRows, std::max<size_t>(MinTexelsPerTask / std::max<size_t>(rowLength, 1), 1), func);
+}
+
+MipmapGenerator::LinearImage MipmapGenerator::Decode(ExternalTextureFormat format, glm::uvec3 size, std::span<const std::byte> data) const
+{
+    const auto& toLinear = GetSRGBToLinearTable();
+    const bool isSRGB = m_isSRGB && format.DataType == BufferDataType::UByte;
+    const size_t rowLength = size.x;
+
+    LinearImage result {size, std::vector<glm::vec4>(size_t {size.x} * size.y * size.z)};
+    ForEachRow(size_t {size.y} * size.z, rowLength, [&](size_t begin, size_t end) {
+        for (size_t i = begin * rowLength; i < end * rowLength; ++i)
+        {
+            auto& texel = result.Texels[i];
+            switch (format.DataType)
+            {
+            case BufferDataType::UByte:
+            {
+                glm::u8vec4 value;
+                std::memcpy(&value, data.data() + i * sizeof(value), sizeof(value));
+                texel = isSRGB ? glm::vec4 {toLinear[value.r], toLinear[value.g], toLinear[value.b], value.a / 255.0f} : glm::vec4 {value} / 255.0f;
+                break;
+            }
+
+            case BufferDataType::HalfFloat:
+            {
+                glm::uint64 value;
+                std::memcpy(&value, data.data() + i * sizeof(value), sizeof(value));
+                texel = glm::unpackHalf4x16(value);
+                break;
+            }
+
+            default: std::memcpy(&texel, data.data() + i * sizeof(texel), sizeof(texel));
+            }
+        }
+    });
+
+    return result;
+}
+
+std::vector<std::byte> MipmapGenerator::Encode(ExternalTextureFormat format, const LinearImage& image) const
+{
+    const bool isSRGB = m_isSRGB && format.DataType == BufferDataType::UByte;
+    const size_t rowLength = image.Size.x;
+
+    std::vector<std::byte> result(GetImageDataLength(format, image.Size));
+    ForEachRow(size_t {image.Size.y} * image.Size.z, rowLength, [&](size_t begin, size_t end) {
+        for (size_t i = begin * rowLength; i < end * rowLength; ++i)
+        {
+            switch (format.DataType)
+            {
+            case BufferDataType::UByte:
+            {
+                // sinc filters overshoot a bit
+                auto texel = glm::clamp(image.Texels[i], 0.0f, 1.0f);
+                if (isSRGB)
+                    texel = {LinearToSRGB(texel.r), LinearToSRGB(texel.g), LinearToSRGB(texel.b), texel.a};
+
+                const glm::u8vec4 value {glm::round(texel * 255.0f)};
+                std::memcpy(result.data() + i * sizeof(value), &value, sizeof(value));
+                break;
+            }
+
+            case BufferDataType::HalfFloat:
+            {
+                const auto value = glm::packHalf4x16(image.Texels[i]);
+                std::memcpy(result.data() + i * sizeof(value), &value, sizeof(value));
+                break;
+            }
+
+            default: std::memcpy(result.data() + i * sizeof(glm::vec4), &image.Texels[i], sizeof(glm::vec4));
+            }
+        }
+    });
+
+    return result;
+}
+
+MipmapGenerator::LinearImage MipmapGenerator::Downsample(const LinearImage& image) const
+{
+    // filter is separable, so every axis is resampled on it's own
+    auto result = image;
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        const unsigned destinationLength = std::max(image.Size[axis] / 2, 1u);
+        if (destinationLength != image.Size[axis])
+            result = Resample(result, axis, destinationLength);
+    }
+
+    return result;
+}
+
+MipmapGenerator::LinearImage MipmapGenerator::Resample(const LinearImage& image, glm::length_t axis, unsigned destinationLength) const
+{
+    // image is viewed as [outer][length][inner] array, where the resampled axis is in the middle, so the whole inner
+    // rows (or slices) are accumulated with the same weight
+    const size_t length = image.Size[axis];
+    const size_t inner = axis == 0 ? 1 : axis == 1 ? size_t {image.Size.x} : size_t {image.Size.x} * image.Size.y;
+    const size_t outer = image.Texels.size() / (length * inner);
+
+    const auto taps = ComputeTaps(static_cast<unsigned>(length), destinationLength, m_filter);
+
+    LinearImage result {image.Size, std::vector<glm::vec4>(outer * destinationLength * inner)};
+    result.Size[axis] = destinationLength;
+
+    ForEachRow(outer * destinationLength, inner * taps.front().Weights.size(), [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row)
+        {
+            const size_t outerIndex = row / destinationLength;
+            const auto& rowTaps = taps[row % destinationLength];
+
+            auto* destination = result.Texels.data() + row * inner;
+            for (size_t k = 0; k < rowTaps.Weights.size(); ++k)
+            {
+                const auto* source = image.Texels.data() + (outerIndex * length + Clamp(rowTaps.First + static_cast<int>(k), length)) * inner;
+                AccumulateRow(destination, source, inner, rowTaps.Weights[k]);
+            }
+        }
+    });
+
+    return result;
+}
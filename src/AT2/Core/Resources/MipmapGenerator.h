@@ -0,0 +1,73 @@
+#pragma once
+
+#include <AT2.h>
+
+#include <span>
+#include <vector>
+
+namespace AT2
+{
+    class ThreadPool;
+}
+
+namespace AT2::Resources
+{
+    enum class MipmapFilter
+    {
+        Box,    // averages covered texels, cheap but a bit aliased
+        Kaiser, // Kaiser-windowed sinc, keeps details sharper
+    };
+
+    // Builds mip chains on CPU, so their quality doesn't depend on the driver. Filtering is done in linear space, so sRGB
+    // images don't get darker with every level. Each level is computed from the previous one without requantization.
+    // Supported formats are RGBA8, RGBA16F and RGBA32F, sRGB decoding is applied to RGBA8 only.
+    class MipmapGenerator
+    {
+    public:
+        struct Image
+        {
+            glm::uvec2 Size {};
+            std::vector<glm::u8vec4> Texels; // tightly packed rows
+        };
+
+        // Rows are distributed between threadPool workers if it's given
+        explicit MipmapGenerator(MipmapFilter filter, bool isSRGB, ThreadPool* threadPool = nullptr);
+
+        // Returns all levels down to 1x1, starting with the base one
+        [[nodiscard]] std::vector<Image> Generate(const Image& base) const;
+
+        // Returns numLevels tightly packed levels in the same format, starting with the base one. Volumes (size.z > 1)
+        // are reduced at all dimensions
+        [[nodiscard]] std::vector<std::vector<std::byte>> Generate(ExternalTextureFormat format, glm::uvec3 size, std::span<const std::byte> base,
+                                                                   unsigned numLevels) const;
+
+        // Fills all levels of Texture2D, Texture2DArray, Texture3D or TextureCube from the base level. Layers (cube faces)
+        // are given one after another and filtered independently
+        void Upload(ITexture& texture, ExternalTextureFormat format, std::span<const std::byte> base) const;
+
+        [[nodiscard]] static unsigned GetNumLevels(glm::uvec2 size) noexcept;
+        [[nodiscard]] static unsigned GetNumLevels(glm::uvec3 size) noexcept;
+
+    private:
+        struct LinearImage
+        {
+            glm::uvec3 Size {};
+            std::vector<glm::vec4> Texels;
+        };
+
+        [[nodiscard]] LinearImage Decode(ExternalTextureFormat format, glm::uvec3 size, std::span<const std::byte> data) const;
+        [[nodiscard]] std::vector<std::byte> Encode(ExternalTextureFormat format, const LinearImage& image) const;
+        [[nodiscard]] LinearImage Downsample(const LinearImage& image) const;
+        [[nodiscard]] LinearImage Resample(const LinearImage& image, glm::length_t axis, unsigned destinationLength) const;
+
+        // func(begin, end) is called for row ranges, possibly in parallel
+        template <typename Func>
+        void ForEachRow(size_t numRows, size_t rowLength, const Func& func) const;
+
+    private:
+        MipmapFilter m_filter;
+        bool m_isSRGB;
+        ThreadPool* m_threadPool;
+    };
+
+} // namespace AT2::Resources
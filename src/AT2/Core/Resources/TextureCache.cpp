@@ -0,0 +1,246 @@
+#include "TextureCache.h"
+
+#include "TextureLoader.h"
+#include "../Hashing.h"
+
+#include <algorithm>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    std::optional<std::filesystem::file_time_type> GetLastWriteTime(const std::filesystem::path& path)
+    {
+        std::error_code errorCode;
+        const auto lastWriteTime = std::filesystem::last_write_time(path, errorCode);
+        if (errorCode)
+            return std::nullopt;
+
+        return lastWriteTime;
+    }
+
+    struct StorageLayout
+    {
+        unsigned NumLevels = 1;
+        unsigned NumSamples = 1;
+        bool IsVolume = false;      // depth is reduced at every mip level
+        bool HasLayeredRows = false; // Texture1DArray keeps layers at y
+    };
+
+    StorageLayout GetStorageLayout(const Texture& type)
+    {
+        return std::visit(
+            []<typename T>(const T& texture) {
+                StorageLayout layout;
+                if constexpr (requires { texture.getLevels(); })
+                    layout.NumLevels = std::max(texture.getLevels(), 1u);
+                if constexpr (requires { texture.getSamples(); })
+                    layout.NumSamples = std::max(texture.getSamples(), 1u);
+
+                layout.IsVolume = std::is_same_v<T, Texture3D>;
+                layout.HasLayeredRows = std::is_same_v<T, Texture1DArray>;
+                return layout;
+            },
+            type);
+    }
+} // namespace
+
+TextureCache::TextureCache(IVisualizationSystem& renderer) : m_renderer {renderer} {}
+
+std::string TextureCache::MakeKey(const std::filesystem::path& path)
+{
+    std::error_code errorCode;
+    auto absolutePath = std::filesystem::absolute(path, errorCode);
+    return (errorCode ? path : absolutePath).lexically_normal().generic_string();
+}
+
+TextureRef TextureCache::LoadTexture(const std::filesystem::path& path)
+{
+    if (auto texture = Find(path))
+        return texture;
+
+    auto texture = TextureLoader::LoadTexture(m_renderer, path);
+    if (texture)
+        Insert(path, texture);
+
+    return texture;
+}
+
+TextureRef TextureCache::LoadTexture(std::span<const std::byte> data)
+{
+    const auto hash = ComputeHash(data);
+    if (auto texture = Find(hash))
+        return texture;
+
+    auto texture = TextureLoader::LoadTexture(m_renderer, data);
+    if (texture)
+        Insert(hash, texture);
+
+    return texture;
+}
+
+TextureRef TextureCache::Find(const std::filesystem::path& path)
+{
+    const auto it = m_files.find(MakeKey(path));
+    if (it == m_files.end())
+        return nullptr;
+
+    auto texture = it->second.Texture.lock();
+    if (!texture || GetLastWriteTime(path) != it->second.LastWriteTime)
+    {
+        m_files.erase(it);
+        return nullptr;
+    }
+
+    ++m_numHits;
+    return texture;
+}
+
+TextureRef TextureCache::Find(ContentHash hash)
+{
+    const auto it = m_contents.find(hash);
+    if (it == m_contents.end())
+        return nullptr;
+
+    auto texture = it->second.lock();
+    if (!texture)
+    {
+        m_contents.erase(it);
+        return nullptr;
+    }
+
+    ++m_numHits;
+    return texture;
+}
+
+void TextureCache::Insert(const std::filesystem::path& path, const TextureRef& texture)
+{
+    const auto lastWriteTime = GetLastWriteTime(path);
+    if (!lastWriteTime)
+        return;
+
+    m_files.insert_or_assign(MakeKey(path), FileEntry {*lastWriteTime, texture});
+}
+
+void TextureCache::Insert(ContentHash hash, const TextureRef& texture)
+{
+    m_contents.insert_or_assign(hash, texture);
+}
+
+TextureCache::ContentHash TextureCache::ComputeHash(std::span<const std::byte> data)
+{
+    // length is hashed too, so a prefix of the data doesn't collide with it
+    Fnv1a hash;
+    hash.UpdateValue(static_cast<std::uint64_t>(data.size()));
+    hash.Update(data);
+    return hash.Get();
+}
+
+TextureRef TextureCache::GetView(const TextureRef& texture, const SamplerState& sampler)
+{
+    auto& [storage, views] = m_views[texture.get()];
+    if (storage.expired())
+        views.clear();
+    storage = texture;
+
+    std::erase_if(views, [](const ViewEntry& entry) { return entry.View.expired(); });
+    for (const auto& entry : views)
+    {
+        if (entry.Sampler != sampler)
+            continue;
+
+        if (auto view = entry.View.lock())
+            return view;
+    }
+
+    auto view = CreateView(m_renderer.GetResourceFactory(), texture, sampler);
+    views.push_back({sampler, view});
+    return view;
+}
+
+TextureRef TextureCache::CreateView(IResourceFactory& factory, const TextureRef& texture, const SamplerState& sampler)
+{
+    auto view = factory.CreateTextureView(texture);
+    view->SetWrapMode(sampler.Wrap);
+    view->SetSamplingMode(sampler.Sampling);
+    return view;
+}
+
+size_t TextureCache::EstimateMemorySize(const ITexture& texture)
+{
+    const auto size = glm::max(texture.GetSize(), glm::uvec3 {1});
+    const auto numTexels = size_t {size.x} * size.y * size.z;
+
+    // it's reported for the base level, and could be less than a byte per texel for compressed formats
+    const double bytesPerTexel = static_cast<double>(texture.GetDataLength()) / static_cast<double>(numTexels);
+
+    const auto layout = GetStorageLayout(texture.GetType());
+    size_t numStoredTexels = 0;
+    for (unsigned level = 0; level < layout.NumLevels; ++level)
+    {
+        const auto levelSize = [&](glm::u32 extent, bool isReduced) { return isReduced ? std::max(extent >> level, 1u) : extent; };
+
+        numStoredTexels += size_t {levelSize(size.x, true)} * levelSize(size.y, !layout.HasLayeredRows) * levelSize(size.z, layout.IsVolume);
+    }
+
+    return static_cast<size_t>(bytesPerTexel * static_cast<double>(numStoredTexels)) * layout.NumSamples;
+}
+
+size_t TextureCache::GetNumViews(const ITexture* storage) const
+{
+    const auto it = m_views.find(storage);
+    if (it == m_views.end() || it->second.Storage.expired())
+        return 0;
+
+    return static_cast<size_t>(std::ranges::count_if(it->second.Views, [](const ViewEntry& entry) { return !entry.View.expired(); }));
+}
+
+TextureCache::MemoryReport TextureCache::GetMemoryReport() const
+{
+    MemoryReport report;
+    report.NumHits = m_numHits;
+
+    const auto addEntry = [&](std::string name, const std::weak_ptr<ITexture>& weakTexture) {
+        const auto texture = weakTexture.lock();
+        if (!texture)
+            return;
+
+        // the reference just taken isn't counted
+        const auto& entry = report.Entries.emplace_back(MemoryReportEntry {std::move(name), texture->GetSize(), EstimateMemorySize(*texture),
+                                                                           GetNumViews(texture.get()), texture.use_count() - 1});
+        report.TotalMemorySize += entry.MemorySize;
+    };
+
+    for (const auto& [key, entry] : m_files)
+        addEntry(key, entry.Texture);
+
+    for (const auto& [hash, texture] : m_contents)
+        addEntry("<memory #" + std::to_string(hash) + ">", texture);
+
+    std::ranges::sort(report.Entries, std::ranges::greater {}, &MemoryReportEntry::MemorySize);
+    return report;
+}
+
+void TextureCache::LogMemoryReport() const
+{
+    const auto report = GetMemoryReport();
+
+    constexpr double Megabyte = 1024.0 * 1024.0;
+    Log::Info() << "Texture cache: " << report.Entries.size() << " textures, " << report.TotalMemorySize / Megabyte << " MB, "
+                << report.NumHits << " loads deduplicated" << std::endl;
+
+    for (const auto& [name, size, memorySize, numViews, numReferences] : report.Entries)
+        Log::Info() << "    " << name << " (" << size.x << "x" << size.y << "x" << size.z << "): " << memorySize / Megabyte << " MB, "
+                    << numViews << " views, " << numReferences << " references" << std::endl;
+}
+
+void TextureCache::Purge()
+{
+    std::erase_if(m_files, [](const auto& pair) { return pair.second.Texture.expired(); });
+    std::erase_if(m_contents, [](const auto& pair) { return pair.second.expired(); });
+    std::erase_if(m_views, [](auto& pair) {
+        std::erase_if(pair.second.Views, [](const ViewEntry& entry) { return entry.View.expired(); });
+        return pair.second.Storage.expired() || pair.second.Views.empty();
+    });
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <AT2.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AT2::Resources
+{
+    // Deduplicates texture storage: files are keyed by normalized path and modification time, in-memory images by a hash
+    // of their (encoded) content. Sampling state is separated from the storage: users who need own sampler get a view,
+    // so one image referenced with different samplers is uploaded only once.
+    // Cache doesn't own textures, entries just expire when nobody uses them. Must be used at the render thread only.
+    class TextureCache
+    {
+    public:
+        using ContentHash = std::uint64_t;
+
+        struct SamplerState
+        {
+            TextureWrapParams Wrap;
+            TextureSamplingParams Sampling;
+
+            bool operator==(const SamplerState&) const = default;
+        };
+
+        struct MemoryReportEntry
+        {
+            std::string Name;
+            glm::uvec3 Size {};
+            size_t MemorySize = 0; // including mip chain
+            size_t NumViews = 0;
+            long NumReferences = 0; // views are referencing their storage too
+        };
+
+        struct MemoryReport
+        {
+            std::vector<MemoryReportEntry> Entries;
+            size_t TotalMemorySize = 0;
+            size_t NumHits = 0; // loads which were served from the cache
+        };
+
+        explicit TextureCache(IVisualizationSystem& renderer);
+
+        // Like TextureLoader::LoadTexture, but returns existing texture if possible
+        TextureRef LoadTexture(const std::filesystem::path& path);
+        TextureRef LoadTexture(std::span<const std::byte> data);
+
+        // Returns nullptr if there is no alive texture or the file was modified since it was loaded
+        [[nodiscard]] TextureRef Find(const std::filesystem::path& path);
+        [[nodiscard]] TextureRef Find(ContentHash hash);
+        void Insert(const std::filesystem::path& path, const TextureRef& texture);
+        void Insert(ContentHash hash, const TextureRef& texture);
+
+        [[nodiscard]] static ContentHash ComputeHash(std::span<const std::byte> data);
+
+        // Returns view of the texture storage with given sampling state, views are shared between callers
+        [[nodiscard]] TextureRef GetView(const TextureRef& texture, const SamplerState& sampler);
+        [[nodiscard]] static TextureRef CreateView(IResourceFactory& factory, const TextureRef& texture, const SamplerState& sampler);
+
+        // Estimation of GPU memory occupied by the texture storage
+        [[nodiscard]] static size_t EstimateMemorySize(const ITexture& texture);
+
+        [[nodiscard]] MemoryReport GetMemoryReport() const;
+        void LogMemoryReport() const;
+
+        // Forgets expired entries, it also happens lazily on lookups
+        void Purge();
+
+    private:
+        struct FileEntry
+        {
+            std::filesystem::file_time_type LastWriteTime;
+            std::weak_ptr<ITexture> Texture;
+        };
+
+        struct ViewEntry
+        {
+            SamplerState Sampler;
+            std::weak_ptr<ITexture> View;
+        };
+
+        struct StorageViews
+        {
+            std::weak_ptr<ITexture> Storage; // to detect address reuse by another texture
+            std::vector<ViewEntry> Views;
+        };
+
+        [[nodiscard]] static std::string MakeKey(const std::filesystem::path& path);
+        [[nodiscard]] size_t GetNumViews(const ITexture* storage) const;
+
+    private:
+        IVisualizationSystem& m_renderer;
+
+        std::unordered_map<std::string, FileEntry> m_files;
+        std::unordered_map<ContentHash, std::weak_ptr<ITexture>> m_contents;
+        std::unordered_map<const ITexture*, StorageViews> m_views;
+        size_t m_numHits = 0;
+    };
+
+} // namespace AT2::Resources
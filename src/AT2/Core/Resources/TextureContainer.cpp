@@ -0,0 +1,451 @@
+#include "TextureContainer.h"
+
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <optional>
+#include <tuple>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    static_assert(std::endian::native == std::endian::little, "containers are read without byte swapping");
+
+    constexpr std::array<unsigned char, 4> DdsMagic {'D', 'D', 'S', ' '};
+    constexpr std::array<unsigned char, 12> Ktx2Magic {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    // more levels than it's possible for 2^16 texture is surely garbage
+    constexpr unsigned MaxLevels = 17;
+
+    template <size_t N>
+    bool StartsWith(std::span<const std::byte> data, const std::array<unsigned char, N>& magic) noexcept
+    {
+        return data.size() >= N && std::memcmp(data.data(), magic.data(), N) == 0;
+    }
+
+    template <typename T>
+    T Read(std::span<const std::byte> data, size_t offset)
+    {
+        if (offset > data.size() || data.size() - offset < sizeof(T))
+            throw AT2TextureException("texture container is truncated");
+
+        T value;
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        return value;
+    }
+
+    constexpr std::uint32_t MakeFourCC(const char (&code)[5])
+    {
+        return static_cast<std::uint32_t>(code[0]) | static_cast<std::uint32_t>(code[1]) << 8 | static_cast<std::uint32_t>(code[2]) << 16 |
+            static_cast<std::uint32_t>(code[3]) << 24;
+    }
+
+    constexpr ExternalTextureFormat Compressed(BlockCompression compression, TextureLayout layout = TextureLayout::RGBA, bool isSRGB = false)
+    {
+        return {layout, BufferDataType::UByte, isSRGB, compression};
+    }
+
+    // https://learn.microsoft.com/en-us/windows/win32/api/dxgiformat/ne-dxgiformat-dxgi_format
+    std::optional<ExternalTextureFormat> TranslateDxgiFormat(std::uint32_t format)
+    {
+        switch (format)
+        {
+        case 2: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::Float};
+        case 10: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::HalfFloat};
+        case 28: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::UByte};
+        case 29: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::UByte, true};
+        case 49: return ExternalTextureFormat {TextureLayout::RG, BufferDataType::UByte};
+        case 61: return ExternalTextureFormat {TextureLayout::Red, BufferDataType::UByte};
+        case 87: return ExternalTextureFormat {TextureLayout::BGRA, BufferDataType::UByte};
+        case 91: return ExternalTextureFormat {TextureLayout::BGRA, BufferDataType::UByte, true};
+        case 71: return Compressed(BlockCompression::BC1);
+        case 72: return Compressed(BlockCompression::BC1, TextureLayout::RGBA, true);
+        case 74: return Compressed(BlockCompression::BC2);
+        case 75: return Compressed(BlockCompression::BC2, TextureLayout::RGBA, true);
+        case 77: return Compressed(BlockCompression::BC3);
+        case 78: return Compressed(BlockCompression::BC3, TextureLayout::RGBA, true);
+        case 80: return Compressed(BlockCompression::BC4, TextureLayout::Red);
+        case 81: return Compressed(BlockCompression::BC4Signed, TextureLayout::Red);
+        case 83: return Compressed(BlockCompression::BC5, TextureLayout::RG);
+        case 84: return Compressed(BlockCompression::BC5Signed, TextureLayout::RG);
+        case 95: return Compressed(BlockCompression::BC6H, TextureLayout::RGB);
+        case 96: return Compressed(BlockCompression::BC6HSigned, TextureLayout::RGB);
+        case 98: return Compressed(BlockCompression::BC7);
+        case 99: return Compressed(BlockCompression::BC7, TextureLayout::RGBA, true);
+        default: return std::nullopt;
+        }
+    }
+
+    // https://registry.khronos.org/vulkan/specs/1.3/html/vkspec.html#VkFormat
+    std::optional<ExternalTextureFormat> TranslateVkFormat(std::uint32_t format)
+    {
+        switch (format)
+        {
+        case 9: return ExternalTextureFormat {TextureLayout::Red, BufferDataType::UByte};
+        case 16: return ExternalTextureFormat {TextureLayout::RG, BufferDataType::UByte};
+        case 23: return ExternalTextureFormat {TextureLayout::RGB, BufferDataType::UByte};
+        case 29: return ExternalTextureFormat {TextureLayout::RGB, BufferDataType::UByte, true};
+        case 37: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::UByte};
+        case 43: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::UByte, true};
+        case 44: return ExternalTextureFormat {TextureLayout::BGRA, BufferDataType::UByte};
+        case 50: return ExternalTextureFormat {TextureLayout::BGRA, BufferDataType::UByte, true};
+        case 97: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::HalfFloat};
+        case 109: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::Float};
+        case 131: return Compressed(BlockCompression::BC1, TextureLayout::RGB);
+        case 132: return Compressed(BlockCompression::BC1, TextureLayout::RGB, true);
+        case 133: return Compressed(BlockCompression::BC1);
+        case 134: return Compressed(BlockCompression::BC1, TextureLayout::RGBA, true);
+        case 135: return Compressed(BlockCompression::BC2);
+        case 136: return Compressed(BlockCompression::BC2, TextureLayout::RGBA, true);
+        case 137: return Compressed(BlockCompression::BC3);
+        case 138: return Compressed(BlockCompression::BC3, TextureLayout::RGBA, true);
+        case 139: return Compressed(BlockCompression::BC4, TextureLayout::Red);
+        case 140: return Compressed(BlockCompression::BC4Signed, TextureLayout::Red);
+        case 141: return Compressed(BlockCompression::BC5, TextureLayout::RG);
+        case 142: return Compressed(BlockCompression::BC5Signed, TextureLayout::RG);
+        case 143: return Compressed(BlockCompression::BC6H, TextureLayout::RGB);
+        case 144: return Compressed(BlockCompression::BC6HSigned, TextureLayout::RGB);
+        case 145: return Compressed(BlockCompression::BC7);
+        case 146: return Compressed(BlockCompression::BC7, TextureLayout::RGBA, true);
+        default: return std::nullopt;
+        }
+    }
+
+    // Legacy DDS pixel format, described by FourCC or channel masks
+    std::optional<ExternalTextureFormat> TranslateDdsPixelFormat(std::span<const std::byte> data)
+    {
+        constexpr std::uint32_t AlphaPixels = 0x1, FourCC = 0x4, Rgb = 0x40, Luminance = 0x20000;
+
+        const auto flags = Read<std::uint32_t>(data, 80);
+        const auto fourCC = Read<std::uint32_t>(data, 84);
+        const auto bitCount = Read<std::uint32_t>(data, 88);
+        const auto redMask = Read<std::uint32_t>(data, 92);
+
+        if (flags & FourCC)
+        {
+            switch (fourCC)
+            {
+            case MakeFourCC("DXT1"): return Compressed(BlockCompression::BC1, (flags & AlphaPixels) ? TextureLayout::RGBA : TextureLayout::RGB);
+            case MakeFourCC("DXT2"):
+            case MakeFourCC("DXT3"): return Compressed(BlockCompression::BC2);
+            case MakeFourCC("DXT4"):
+            case MakeFourCC("DXT5"): return Compressed(BlockCompression::BC3);
+            case MakeFourCC("ATI1"):
+            case MakeFourCC("BC4U"): return Compressed(BlockCompression::BC4, TextureLayout::Red);
+            case MakeFourCC("BC4S"): return Compressed(BlockCompression::BC4Signed, TextureLayout::Red);
+            case MakeFourCC("ATI2"):
+            case MakeFourCC("BC5U"): return Compressed(BlockCompression::BC5, TextureLayout::RG);
+            case MakeFourCC("BC5S"): return Compressed(BlockCompression::BC5Signed, TextureLayout::RG);
+            // D3DFMT_A16B16G16R16F and D3DFMT_A32B32G32R32F
+            case 113: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::HalfFloat};
+            case 116: return ExternalTextureFormat {TextureLayout::RGBA, BufferDataType::Float};
+            default: return std::nullopt;
+            }
+        }
+
+        if ((flags & Rgb) && (bitCount == 24 || bitCount == 32))
+        {
+            // masks are for little-endian integer, so 0xff0000 red means BGR byte order
+            const bool isBgr = redMask == 0x00ff0000;
+            if (!isBgr && redMask != 0x000000ff)
+                return std::nullopt;
+
+            if (bitCount == 24)
+                return ExternalTextureFormat {isBgr ? TextureLayout::BGR : TextureLayout::RGB, BufferDataType::UByte};
+
+            return ExternalTextureFormat {isBgr ? TextureLayout::BGRA : TextureLayout::RGBA, BufferDataType::UByte};
+        }
+
+        if ((flags & Luminance) && bitCount == 8)
+            return ExternalTextureFormat {TextureLayout::Red, BufferDataType::UByte};
+
+        return std::nullopt;
+    }
+
+    void AppendImage(TextureContainerLayout& layout, unsigned level, unsigned layer, size_t offset, std::span<const std::byte> data)
+    {
+        const auto size = TextureContainer::GetLevelSize(layout.Size, level);
+        const auto length = GetImageDataLength(layout.Format, {size, 1});
+        if (offset > data.size() || data.size() - offset < length)
+            throw AT2TextureException("texture container is truncated");
+
+        layout.Images.push_back({level, layer, size, offset, length});
+    }
+
+    void ValidateDimensions(const TextureContainerLayout& layout)
+    {
+        if (layout.Size.x == 0 || layout.Size.y == 0)
+            throw AT2TextureException("texture container has zero size");
+
+        if (layout.NumLevels > MaxLevels || (layout.Size >> (layout.NumLevels - 1)) == glm::uvec2 {0})
+            throw AT2TextureException("texture container has too many mip levels");
+    }
+} // namespace
+
+bool TextureContainer::IsDds(std::span<const std::byte> data) noexcept
+{
+    return StartsWith(data, DdsMagic);
+}
+
+bool TextureContainer::IsKtx2(std::span<const std::byte> data) noexcept
+{
+    return StartsWith(data, Ktx2Magic);
+}
+
+TextureContainerLayout TextureContainer::Parse(std::span<const std::byte> data)
+{
+    if (IsDds(data))
+        return ParseDds(data);
+
+    if (IsKtx2(data))
+        return ParseKtx2(data);
+
+    throw AT2TextureException("unknown texture container");
+}
+
+// https://learn.microsoft.com/en-us/windows/win32/direct3ddds/dds-header
+TextureContainerLayout TextureContainer::ParseDds(std::span<const std::byte> data)
+{
+    constexpr size_t HeaderSize = 4 + 124, Dx10HeaderSize = 20;
+    constexpr std::uint32_t MipmapCountFlag = 0x20000, CubemapFlag = 0x200, AllFacesFlags = 0xFC00, VolumeFlag = 0x200000;
+
+    if (!IsDds(data) || Read<std::uint32_t>(data, 4) != 124)
+        throw AT2TextureException("DDS: invalid header");
+
+    TextureContainerLayout layout;
+    layout.Size = {Read<std::uint32_t>(data, 16), Read<std::uint32_t>(data, 12)};
+
+    const auto flags = Read<std::uint32_t>(data, 8);
+    layout.NumLevels = (flags & MipmapCountFlag) ? std::max(Read<std::uint32_t>(data, 28), 1u) : 1u;
+
+    const auto caps2 = Read<std::uint32_t>(data, 112);
+    if (caps2 & VolumeFlag)
+        throw AT2NotImplementedException("DDS: volume textures aren't supported");
+
+    layout.IsCubemap = caps2 & CubemapFlag;
+    if (layout.IsCubemap && (caps2 & AllFacesFlags) != AllFacesFlags)
+        throw AT2NotImplementedException("DDS: cube maps without all faces aren't supported");
+
+    size_t dataOffset = HeaderSize;
+    unsigned numArrayElements = 1;
+
+    if (Read<std::uint32_t>(data, 84) == MakeFourCC("DX10"))
+    {
+        constexpr std::uint32_t Texture2DDimension = 3, TextureCubeMiscFlag = 0x4;
+
+        const auto format = TranslateDxgiFormat(Read<std::uint32_t>(data, HeaderSize));
+        if (!format)
+            throw AT2TextureException("DDS: unsupported DXGI format " + std::to_string(Read<std::uint32_t>(data, HeaderSize)));
+
+        if (Read<std::uint32_t>(data, HeaderSize + 4) != Texture2DDimension)
+            throw AT2NotImplementedException("DDS: only 2D textures are supported");
+
+        layout.Format = *format;
+        layout.IsCubemap = Read<std::uint32_t>(data, HeaderSize + 8) & TextureCubeMiscFlag;
+        numArrayElements = std::max(Read<std::uint32_t>(data, HeaderSize + 12), 1u);
+        dataOffset += Dx10HeaderSize;
+    }
+    else if (const auto format = TranslateDdsPixelFormat(data))
+        layout.Format = *format;
+    else
+        throw AT2TextureException("DDS: unsupported pixel format");
+
+    layout.NumLayers = numArrayElements * (layout.IsCubemap ? 6 : 1);
+    ValidateDimensions(layout);
+
+    // every layer (face) has it's own mip chain
+    for (unsigned layer = 0; layer < layout.NumLayers; ++layer)
+    {
+        for (unsigned level = 0; level < layout.NumLevels; ++level)
+        {
+            AppendImage(layout, level, layer, dataOffset, data);
+            dataOffset += layout.Images.back().Length;
+        }
+    }
+
+    return layout;
+}
+
+// https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+TextureContainerLayout TextureContainer::ParseKtx2(std::span<const std::byte> data)
+{
+    constexpr size_t LevelIndexOffset = 80, LevelIndexEntrySize = 24;
+
+    if (!IsKtx2(data))
+        throw AT2TextureException("KTX2: invalid header");
+
+    const auto vkFormat = Read<std::uint32_t>(data, 12);
+    if (vkFormat == 0)
+        throw AT2NotImplementedException("KTX2: Basis Universal textures aren't supported");
+
+    const auto format = TranslateVkFormat(vkFormat);
+    if (!format)
+        throw AT2TextureException("KTX2: unsupported Vulkan format " + std::to_string(vkFormat));
+
+    if (Read<std::uint32_t>(data, 44) != 0)
+        throw AT2NotImplementedException("KTX2: supercompressed textures aren't supported");
+
+    const auto height = Read<std::uint32_t>(data, 24);
+    if (height == 0 || Read<std::uint32_t>(data, 28) != 0)
+        throw AT2NotImplementedException("KTX2: only 2D textures are supported");
+
+    const auto numFaces = Read<std::uint32_t>(data, 36);
+    if (numFaces != 1 && numFaces != 6)
+        throw AT2TextureException("KTX2: invalid number of faces");
+
+    TextureContainerLayout layout;
+    layout.Format = *format;
+    layout.Size = {Read<std::uint32_t>(data, 20), height};
+    layout.IsCubemap = numFaces == 6;
+    layout.NumLayers = std::max(Read<std::uint32_t>(data, 32), 1u) * numFaces;
+    // zero means that mipmaps should be generated, which doesn't work with compressed formats anyway
+    layout.NumLevels = std::max(Read<std::uint32_t>(data, 40), 1u);
+    ValidateDimensions(layout);
+
+    // images of a level are tightly packed: layers, then faces
+    for (unsigned level = 0; level < layout.NumLevels; ++level)
+    {
+        const auto levelOffset = Read<std::uint64_t>(data, LevelIndexOffset + level * LevelIndexEntrySize);
+        const auto levelLength = Read<std::uint64_t>(data, LevelIndexOffset + level * LevelIndexEntrySize + 8);
+        if (levelOffset > data.size() || data.size() - levelOffset < levelLength)
+            throw AT2TextureException("texture container is truncated");
+
+        auto imageOffset = static_cast<size_t>(levelOffset);
+        for (unsigned layer = 0; layer < layout.NumLayers; ++layer)
+        {
+            AppendImage(layout, level, layer, imageOffset, data);
+            imageOffset += layout.Images.back().Length;
+        }
+
+        if (imageOffset - levelOffset > levelLength)
+            throw AT2TextureException("KTX2: level is smaller than it's images");
+    }
+
+    return layout;
+}
+
+std::vector<std::byte> TextureContainer::WriteDds(const TextureContainerLayout& layout, std::span<const std::byte> data)
+{
+    constexpr std::uint32_t CapsFlag = 0x1, HeightFlag = 0x2, WidthFlag = 0x4, PitchFlag = 0x8, PixelFormatFlag = 0x1000,
+                            MipmapCountFlag = 0x20000, LinearSizeFlag = 0x80000;
+    constexpr std::uint32_t ComplexCaps = 0x8, TextureCaps = 0x1000, MipmapCaps = 0x400000, CubemapCaps2 = 0x200 | 0xFC00;
+    constexpr std::uint32_t FourCCPixelFormat = 0x4, Texture2DDimension = 3, TextureCubeMiscFlag = 0x4;
+    constexpr std::uint32_t MaxDxgiFormat = 132;
+
+    const auto dxgiFormat = [&]() -> std::uint32_t {
+        for (std::uint32_t format = 1; format < MaxDxgiFormat; ++format)
+            if (TranslateDxgiFormat(format) == layout.Format)
+                return format;
+
+        throw AT2TextureException("DDS: format has no DXGI equivalent");
+    }();
+
+    const bool isCompressed = layout.Format.Compression != BlockCompression::None;
+    const bool hasMipmaps = layout.NumLevels > 1;
+
+    std::vector<std::byte> result;
+    const auto put = [&result](size_t offset, std::uint32_t value) { std::memcpy(result.data() + offset, &value, sizeof(value)); };
+
+    result.resize(148);
+    std::memcpy(result.data(), DdsMagic.data(), DdsMagic.size());
+    put(4, 124);
+    put(8, CapsFlag | HeightFlag | WidthFlag | PixelFormatFlag | (hasMipmaps ? MipmapCountFlag : 0) | (isCompressed ? LinearSizeFlag : PitchFlag));
+    put(12, layout.Size.y);
+    put(16, layout.Size.x);
+    put(20, static_cast<std::uint32_t>(isCompressed ? GetImageDataLength(layout.Format, {layout.Size, 1})
+                                                    : GetImageDataLength(layout.Format, {layout.Size.x, 1, 1})));
+    put(28, layout.NumLevels);
+    put(76, 32);
+    put(80, FourCCPixelFormat);
+    put(84, MakeFourCC("DX10"));
+    put(108, TextureCaps | (hasMipmaps || layout.NumLayers > 1 ? ComplexCaps : 0) | (hasMipmaps ? MipmapCaps : 0));
+    put(112, layout.IsCubemap ? CubemapCaps2 : 0);
+
+    put(128, dxgiFormat);
+    put(132, Texture2DDimension);
+    put(136, layout.IsCubemap ? TextureCubeMiscFlag : 0);
+    put(140, layout.NumLayers / (layout.IsCubemap ? 6 : 1));
+
+    // every layer (face) has it's own mip chain
+    auto images = layout.Images;
+    std::ranges::sort(images, [](const auto& lhs, const auto& rhs) { return std::tie(lhs.Layer, lhs.Level) < std::tie(rhs.Layer, rhs.Level); });
+    if (images.size() != size_t {layout.NumLevels} * layout.NumLayers)
+        throw AT2TextureException("DDS: layout doesn't have all images");
+
+    for (const auto& image : images)
+    {
+        const auto imageData = data.subspan(image.Offset, image.Length);
+        result.insert(result.end(), imageData.begin(), imageData.end());
+    }
+
+    return result;
+}
+
+glm::uvec2 TextureContainer::GetLevelSize(glm::uvec2 baseSize, unsigned level) noexcept
+{
+    return glm::max(baseSize >> level, glm::uvec2 {1});
+}
+
+Texture TextureContainer::MakeDeclaration(const TextureContainerLayout& layout)
+{
+    if (layout.IsCubemap)
+    {
+        if (layout.NumLayers == 6)
+            return TextureCube {layout.Size, layout.NumLevels};
+
+        return TextureCubeArray {{layout.Size, layout.NumLayers}, layout.NumLevels};
+    }
+
+    if (layout.NumLayers > 1)
+        return Texture2DArray {{layout.Size, layout.NumLayers}, layout.NumLevels};
+
+    return Texture2D {layout.Size, layout.NumLevels};
+}
+
+void TextureContainer::Upload(ITexture& texture, const TextureContainerLayout& layout, std::span<const std::byte> data)
+{
+    const bool isLayered = !std::holds_alternative<Texture2D>(texture.GetType());
+
+    for (const auto& image : layout.Images)
+    {
+        const auto* imageData = data.subspan(image.Offset, image.Length).data();
+
+        if (isLayered)
+            texture.SubImage3D({0, 0, image.Layer}, {image.Size, 1}, image.Level, layout.Format, imageData);
+        else
+            texture.SubImage2D({0, 0}, image.Size, image.Level, layout.Format, imageData);
+    }
+}
+
+DecodedImage TextureContainer::Decode(std::span<const std::byte> data)
+{
+    auto layout = Parse(data);
+
+    auto* copy = new std::byte[data.size()];
+    std::copy(data.begin(), data.end(), copy);
+
+    DecodedImage image {layout.Format, layout.Size, data.size(), {copy, [](void* ptr) { delete[] static_cast<std::byte*>(ptr); }}};
+    image.Container = std::move(layout);
+    return image;
+}
+
+TextureRef TextureContainer::CreateTexture(IResourceFactory& factory, const DecodedImage& image)
+{
+    assert(image.Container);
+
+    auto texture = factory.CreateTexture(MakeDeclaration(*image.Container), image.Format);
+    Upload(*texture, image);
+    return texture;
+}
+
+void TextureContainer::Upload(ITexture& texture, const DecodedImage& image)
+{
+    assert(image.Container);
+    Upload(texture, *image.Container, {static_cast<const std::byte*>(image.Data.get()), image.DataLength});
+}
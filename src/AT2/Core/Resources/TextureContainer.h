@@ -0,0 +1,63 @@
+#pragma once
+
+#include <AT2.h>
+
+#include <span>
+#include <vector>
+
+namespace AT2::Resources
+{
+    struct DecodedImage;
+
+    // Texture stored in DDS or KTX2 container. Images are in GPU-ready form (possibly block-compressed) and the mip chain
+    // is already built, so they're uploaded as is, without decoding or mipmaps generation.
+    struct TextureContainerLayout
+    {
+        struct Image
+        {
+            unsigned Level = 0;
+            unsigned Layer = 0; // array layer, or layer-face for cube maps
+            glm::uvec2 Size {};
+            size_t Offset = 0; // from the beginning of the container
+            size_t Length = 0;
+        };
+
+        ExternalTextureFormat Format {TextureLayout::RGBA, BufferDataType::UByte};
+        glm::uvec2 Size {};
+        unsigned NumLevels = 1;
+        unsigned NumLayers = 1; // 6 per cube
+        bool IsCubemap = false;
+        std::vector<Image> Images;
+    };
+
+    class TextureContainer
+    {
+    public:
+        [[nodiscard]] static bool IsDds(std::span<const std::byte> data) noexcept;
+        [[nodiscard]] static bool IsKtx2(std::span<const std::byte> data) noexcept;
+        [[nodiscard]] static bool IsContainer(std::span<const std::byte> data) noexcept { return IsDds(data) || IsKtx2(data); }
+
+        // Validates the container, images are guaranteed to be within data. Throws AT2TextureException
+        // for malformed data and AT2NotImplementedException for 1D, volume and supercompressed textures
+        [[nodiscard]] static TextureContainerLayout Parse(std::span<const std::byte> data);
+        [[nodiscard]] static TextureContainerLayout ParseDds(std::span<const std::byte> data);
+        [[nodiscard]] static TextureContainerLayout ParseKtx2(std::span<const std::byte> data);
+
+        [[nodiscard]] static glm::uvec2 GetLevelSize(glm::uvec2 baseSize, unsigned level) noexcept;
+
+        // Declaration of the texture to upload the layout to
+        [[nodiscard]] static Texture MakeDeclaration(const TextureContainerLayout& layout);
+        // Writes images described by the layout as DDS with DX10 header, data is where they are stored.
+        // Throws AT2TextureException if the format has no DXGI equivalent
+        [[nodiscard]] static std::vector<std::byte> WriteDds(const TextureContainerLayout& layout, std::span<const std::byte> data);
+
+        // data is the whole container
+        static void Upload(ITexture& texture, const TextureContainerLayout& layout, std::span<const std::byte> data);
+
+        // Shared by texture loaders: copies the container, so it could be uploaded later at the render thread
+        [[nodiscard]] static DecodedImage Decode(std::span<const std::byte> data);
+        [[nodiscard]] static TextureRef CreateTexture(IResourceFactory& factory, const DecodedImage& image);
+        static void Upload(ITexture& texture, const DecodedImage& image);
+    };
+
+} // namespace AT2::Resources
@@ -1,17 +1,41 @@
 #pragma once
 
 #include <filesystem>
+#include <optional>
 #include <AT2.h>
 
+#include "TextureContainer.h"
+#include "TextureManifest.h"
+
 namespace AT2::Resources
 {
+    // Image decoded to the memory, ready to be uploaded
+    struct DecodedImage
+    {
+        ExternalTextureFormat Format {TextureLayout::RGBA, BufferDataType::UByte};
+        glm::uvec2 Size {};
+        size_t DataLength = 0;
+        std::unique_ptr<void, void (*)(void*)> Data {nullptr, nullptr};
+
+        // For DDS and KTX2 containers Data is the whole container, with all levels and layers
+        std::optional<TextureContainerLayout> Container;
+    };
+
     class TextureLoader
     {
     public:
-        //TODO: make async
-        //TODO: caching!!!
+        // Files which have cooked version in the active TextureManifest are loaded from it
         static TextureRef LoadTexture(IVisualizationSystem& renderer, const std::filesystem::path& path);
         static TextureRef LoadTexture(IVisualizationSystem& renderer, std::span<const std::byte> data);
+
+        // Decoding doesn't touch renderer, so it's safe to do at any thread. Throws on failure
+        static DecodedImage DecodeImage(const std::filesystem::path& path);
+        static DecodedImage DecodeImage(std::span<const std::byte> data);
+
+        // Must be called at render thread. If sourceFile is given, texture is reloaded on change of it or it's cooked
+        // version, so it must be the source path, not the redirected one
+        static TextureRef CreateTexture(IVisualizationSystem& renderer, const DecodedImage& image,
+                                        const std::optional<std::filesystem::path>& sourceFile = std::nullopt);
     };
 
-} // namespace AT2
\ No newline at end of file
+} // namespace AT2
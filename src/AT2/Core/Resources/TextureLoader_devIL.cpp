@@ -10,6 +10,11 @@ using namespace AT2::Resources;
 #include <IL/il.h>
 #include <IL/ilu.h>
 
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
 namespace
 {
     class IlImage
@@ -176,8 +181,15 @@ namespace
     }
 }; // namespace
 
-TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, const std::filesystem::path& path)
+TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, const std::filesystem::path& sourcePath)
 {
+    const auto path = TextureManifest::Redirect(sourcePath);
+
+    // DevIL decompresses DDS and doesn't know KTX2 at all
+    const auto extension = path.extension();
+    if (extension == ".dds" || extension == ".ktx2")
+        return CreateTexture(renderer, DecodeImage(path));
+
     return Load(renderer, [filename = path.generic_u8string()] { return ilLoadImage(reinterpret_cast<const char*>(filename.c_str())) == IL_TRUE; });
 }
 
@@ -186,10 +198,77 @@ TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, std::span<
     if (data.size() > std::numeric_limits<ILuint>::max())
         throw AT2TextureException( "DevIL does not support images more than 4GB");
 
+    if (TextureContainer::IsContainer(data))
+        return CreateTexture(renderer, DecodeImage(data));
+
     const ILenum type = ilDetermineTypeL(data.data(), static_cast<ILuint>(data.size()));
     if (type == IL_TYPE_UNKNOWN)
         throw AT2TextureException("Couldn't determine texture format while reading from memory");
 
     return Load(renderer, [=] { return ilLoadL(type, data.data(), static_cast<ILuint>(data.size())) == IL_TRUE; });
 }
+
+DecodedImage TextureLoader::DecodeImage(const std::filesystem::path& sourcePath)
+{
+    const auto path = TextureManifest::Redirect(sourcePath);
+
+    std::ifstream stream {path, std::ios::binary};
+    if (!stream.is_open())
+        throw AT2IOException("can't open texture file '" + path.string() + "'");
+
+    std::vector<char> data(static_cast<size_t>(file_size(path)));
+    stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+    return DecodeImage(std::as_bytes(std::span {data}));
+}
+
+DecodedImage TextureLoader::DecodeImage(std::span<const std::byte> data)
+{
+    if (TextureContainer::IsContainer(data))
+        return TextureContainer::Decode(data);
+
+    if (data.size() > std::numeric_limits<ILuint>::max())
+        throw AT2TextureException( "DevIL does not support images more than 4GB");
+
+    // DevIL keeps bound image in global state
+    static std::mutex devilMutex;
+    std::scoped_lock lock {devilMutex};
+
+    const ILenum type = ilDetermineTypeL(data.data(), static_cast<ILuint>(data.size()));
+    if (type == IL_TYPE_UNKNOWN)
+        throw AT2TextureException("Couldn't determine texture format while reading from memory");
+
+    const auto image = DevIL_Holder::Get().GenImage();
+    ilBindImage(image.getId());
+
+    if (ilLoadL(type, data.data(), static_cast<ILuint>(data.size())) != IL_TRUE)
+        throw AT2TextureException("TextureLoader: could not load image");
+
+    ILinfo imageInfo;
+    iluGetImageInfo(&imageInfo);
+
+    if (imageInfo.Depth > 1 || ilGetInteger(IL_IMAGE_CUBEFLAGS))
+        throw AT2NotImplementedException("Only 2d textures could be decoded separately");
+
+    DecodedImage result {GetExternalFormat(imageInfo.Format, imageInfo.Type), {imageInfo.Width, imageInfo.Height}, imageInfo.SizeOfData,
+                         {std::malloc(imageInfo.SizeOfData), &std::free}};
+    std::memcpy(result.Data.get(), imageInfo.Data, imageInfo.SizeOfData);
+
+    return result;
+}
+
+TextureRef TextureLoader::CreateTexture(IVisualizationSystem& renderer, const DecodedImage& image,
+                                        const std::optional<std::filesystem::path>&)
+{
+    if (image.Container)
+        return TextureContainer::CreateTexture(renderer.GetResourceFactory(), image);
+
+    const auto storageLevels = static_cast<unsigned>(log(std::max(image.Size.x, image.Size.y)) / log(2));
+
+    auto texture = renderer.GetResourceFactory().CreateTexture(Texture2D {image.Size, storageLevels}, image.Format);
+    texture->SubImage2D({0, 0}, image.Size, 0, image.Format, image.Data.get());
+    texture->BuildMipmaps();
+
+    return texture;
+}
 #endif
\ No newline at end of file
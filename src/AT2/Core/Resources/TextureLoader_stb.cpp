@@ -2,13 +2,10 @@
 
 #include "../AT2.h"
 
-#ifdef USE_GLI
-#include <gli/gli.hpp>
-#endif
-
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <optional>
 
 #if !defined(USE_DEVIL) && defined(USE_PLATFORM_HACKS)
 #include <cstdio>
@@ -54,40 +51,148 @@ namespace
 
         return {format, {w, h}};
     }
-}; // namespace
 
-TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, const std::filesystem::path& path)
-{
+    std::optional<std::vector<std::byte>> ReadFile(const std::filesystem::path& path)
+    {
 #ifdef USE_PLATFORM_HACKS
-    // not so gracefully as with iostream, but much faster under debugger
+        // not so gracefully as with iostream, but much faster under debugger
 #if defined(WIN32) || defined(_WIN32)
-    if (std::unique_ptr<FILE, decltype(&fclose)> file {_wfopen(path.native().c_str(), L"rb"), fclose})
+        if (std::unique_ptr<FILE, decltype(&fclose)> file {_wfopen(path.native().c_str(), L"rb"), fclose})
 #else
-    if (std::unique_ptr<FILE, decltype(&fclose)> file {std::fopen(reinterpret_cast<const char*>(path.c_str()), "rb"), fclose})
+        if (std::unique_ptr<FILE, decltype(&fclose)> file {std::fopen(reinterpret_cast<const char*>(path.c_str()), "rb"), fclose})
 #endif
-    {
-        std::vector<std::byte> data { static_cast<size_t>(file_size(path))};
-        fread(data.data(), 1, data.size(), file.get());
+        {
+            std::vector<std::byte> data(static_cast<size_t>(file_size(path)));
+            fread(data.data(), 1, data.size(), file.get());
 
-        return LoadTexture(renderer, data);
-    }
+            return data;
+        }
 
-    return nullptr;
+        return std::nullopt;
 #else
-    std::basic_ifstream<char> stream {path, std::ios::binary};
-    std::vector< char> data (static_cast<size_t>(file_size(path)));
-    stream.read(data.data(), data.size());
+        std::basic_ifstream<char> stream {path, std::ios::binary};
+        if (!stream.is_open())
+            return std::nullopt;
+
+        std::vector<std::byte> data(static_cast<size_t>(file_size(path)));
+        stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
 
-    //std::vector<std::byte> data{std::istreambuf_iterator<std::byte>(file), {}};
-    return LoadTexture(renderer, std::span{reinterpret_cast<const std::byte*>(data.data()), data.size()} );
+        return data;
 #endif
+    }
+
+    void Upload(ITexture& texture, const DecodedImage& image)
+    {
+        // containers are having prebuilt mip chain
+        if (image.Container)
+        {
+            TextureContainer::Upload(texture, image);
+            return;
+        }
+
+        texture.SubImage2D({0, 0}, image.Size, 0, image.Format, image.Data.get());
+        texture.BuildMipmaps();
+    }
+
+    // Keeps texture loaded from file up to date, the texture object stays the same, so users don't notice reloading.
+    // Source file and it's cooked version are both watched: an edited source is newer than the cooked file, so it's loaded
+    // instead of it, but it can't replace a block-compressed texture until it's cooked again.
+    class TextureFileReloader : public IReloadable
+    {
+    public:
+        TextureFileReloader(std::filesystem::path sourcePath, TextureRef texture, ExternalTextureFormat format) :
+            m_sourcePath {std::move(sourcePath)}, m_texture {std::move(texture)}, m_format {format}
+        {
+        }
+
+        void Reload() override
+        {
+            const auto image = TextureLoader::DecodeImage(m_sourcePath);
+
+            // recreation would invalidate references held by materials
+            if (image.Size != glm::xy(m_texture->GetSize()) || image.Format != m_format)
+            {
+                Log::Warning() << "Texture '" << m_sourcePath.string()
+                               << "' size or format was changed, restart or cook it again to apply" << std::endl;
+                return;
+            }
+
+            Upload(*m_texture, image);
+        }
+
+        [[nodiscard]] ReloadableGroup getReloadableClass() const override { return ReloadableGroup::Textures; }
+        [[nodiscard]] std::optional<std::vector<std::filesystem::path>> getDependencies() const override
+        {
+            return TextureManifest::GetDependencies(m_sourcePath);
+        }
+
+        [[nodiscard]] ITexture& GetTexture() const noexcept { return *m_texture; }
+
+    private:
+        std::filesystem::path m_sourcePath;
+        TextureRef m_texture;
+        ExternalTextureFormat m_format;
+    };
+} // namespace
+
+TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, const std::filesystem::path& sourcePath)
+{
+    const auto path = TextureManifest::Redirect(sourcePath);
+
+    const auto data = ReadFile(path);
+    if (!data)
+        return nullptr;
+
+    try
+    {
+        return CreateTexture(renderer, DecodeImage(*data), sourcePath);
+    }
+    catch (const AT2TextureException& exception)
+    {
+        Log::Warning() << path.string() << ": " << exception.what() << std::endl;
+        return nullptr;
+    }
+}
+
+TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, std::span<const std::byte> data)
+{
+    try
+    {
+        return CreateTexture(renderer, DecodeImage(data));
+    }
+    catch (const AT2TextureException& exception)
+    {
+        Log::Warning() << exception.what() << std::endl;
+        return nullptr;
+    }
+}
+
+DecodedImage TextureLoader::DecodeImage(const std::filesystem::path& sourcePath)
+{
+    const auto path = TextureManifest::Redirect(sourcePath);
+
+    const auto data = ReadFile(path);
+    if (!data)
+        throw AT2IOException("can't open texture file '" + path.string() + "'");
+
+    try
+    {
+        return DecodeImage(*data);
+    }
+    catch (const AT2TextureException& exception)
+    {
+        throw AT2TextureException(path.string() + ": " + exception.what());
+    }
 }
 
-TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, std::span<const std::byte> rawData)
+DecodedImage TextureLoader::DecodeImage(std::span<const std::byte> rawData)
 {
+    if (TextureContainer::IsContainer(rawData))
+        return TextureContainer::Decode(rawData);
+
     auto data = Utils::reinterpret_span_cast<const stbi_uc>(rawData);
     auto [format, size] = DetermineExternalFormat(data);
-    
+
     int requiredNumberOfChannels = 0; // default, no transformations
 #ifdef __APPLE__
     if (format.ChannelsLayout == TextureLayout::RGB)
@@ -96,8 +201,8 @@ TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, std::span<
         requiredNumberOfChannels = 4;
     }
 #endif
-    
-    auto parsedData = [&, format=format]() -> void* {
+
+    auto parsedData = [&, format = format]() -> void* {
         int width, height;
 
         switch (format.DataType)
@@ -110,17 +215,30 @@ TextureRef TextureLoader::LoadTexture(IVisualizationSystem& renderer, std::span<
         return nullptr;
     }();
 
-    TextureRef result = nullptr;
-    if (parsedData)
-    {
-        const auto numMipmaps = static_cast<unsigned>(log(std::max(size.x, size.y)) / log(2));
+    if (!parsedData)
+        throw AT2TextureException(std::string {"couldn't decode image: "} + stbi_failure_reason());
 
-        result = renderer.GetResourceFactory().CreateTexture(Texture2D {size, numMipmaps}, format);
-        result->SubImage2D({0, 0}, glm::xy(size), 0, format, parsedData);
-        result->BuildMipmaps();
-        stbi_image_free(parsedData);
-    }
+    const glm::uvec2 imageSize {size};
+    return {format, imageSize, size_t {imageSize.x} * imageSize.y * GetPixelLength(format), {parsedData, &stbi_image_free}};
+}
+
+TextureRef TextureLoader::CreateTexture(IVisualizationSystem& renderer, const DecodedImage& image,
+                                        const std::optional<std::filesystem::path>& sourceFile)
+{
+    const auto numMipmaps = static_cast<unsigned>(log(std::max(image.Size.x, image.Size.y)) / log(2));
+
+    const auto declaration = image.Container ? TextureContainer::MakeDeclaration(*image.Container) : Texture {Texture2D {image.Size, numMipmaps}};
+
+    auto texture = renderer.GetResourceFactory().CreateTexture(declaration, image.Format);
+    Upload(*texture, image);
+
+    if (!sourceFile)
+        return texture;
+
+    auto reloader = std::make_shared<TextureFileReloader>(*sourceFile, std::move(texture), image.Format);
+    renderer.GetResourceFactory().RegisterReloadable(reloader);
 
-    return result;
+    // reloader lives as long as the texture is used
+    return TextureRef {reloader, &reloader->GetTexture()};
 }
 #endif
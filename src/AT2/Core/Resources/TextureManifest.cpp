@@ -0,0 +1,133 @@
+#include "TextureManifest.h"
+
+#include <AT2.h>
+
+#include <fstream>
+#include <mutex>
+
+#include <nlohmann/json.hpp>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+namespace
+{
+    constexpr int ManifestVersion = 1;
+
+    std::mutex activeManifestMutex;
+    std::shared_ptr<const TextureManifest> activeManifest;
+
+    std::filesystem::path MakeAbsolute(const std::filesystem::path& path)
+    {
+        std::error_code errorCode;
+        auto absolutePath = std::filesystem::absolute(path, errorCode);
+        return (errorCode ? path : absolutePath).lexically_normal();
+    }
+} // namespace
+
+TextureManifest TextureManifest::Load(const std::filesystem::path& manifestPath)
+{
+    std::ifstream stream {manifestPath};
+    if (!stream.is_open())
+        throw AT2IOException("can't open texture manifest '" + manifestPath.string() + "'");
+
+    const auto baseDirectory = MakeAbsolute(manifestPath).parent_path();
+
+    try
+    {
+        const auto json = nlohmann::json::parse(stream);
+        if (json.at("version").get<int>() != ManifestVersion)
+            throw AT2IOException("texture manifest '" + manifestPath.string() + "' has unsupported version");
+
+        TextureManifest manifest;
+        for (const auto& entry : json.at("textures"))
+            manifest.Add(baseDirectory / entry.at("source").get<std::string>(), baseDirectory / entry.at("cooked").get<std::string>());
+
+        return manifest;
+    }
+    catch (const nlohmann::json::exception& exception)
+    {
+        throw AT2IOException("texture manifest '" + manifestPath.string() + "' is malformed: " + exception.what());
+    }
+}
+
+void TextureManifest::Save(const std::filesystem::path& manifestPath) const
+{
+    const auto baseDirectory = MakeAbsolute(manifestPath).parent_path();
+
+    auto textures = nlohmann::json::array();
+    for (const auto& [source, cooked] : m_entries)
+        textures.push_back({{"source", std::filesystem::path {source}.lexically_relative(baseDirectory).generic_string()},
+                            {"cooked", cooked.lexically_relative(baseDirectory).generic_string()}});
+
+    std::ofstream stream {manifestPath};
+    if (!stream.is_open())
+        throw AT2IOException("can't write texture manifest '" + manifestPath.string() + "'");
+
+    stream << nlohmann::json {{"version", ManifestVersion}, {"textures", std::move(textures)}}.dump(4) << std::endl;
+}
+
+void TextureManifest::Add(const std::filesystem::path& source, const std::filesystem::path& cooked)
+{
+    m_entries.insert_or_assign(MakeKey(source), MakeAbsolute(cooked));
+}
+
+std::optional<std::filesystem::path> TextureManifest::Find(const std::filesystem::path& source) const
+{
+    const auto it = m_entries.find(MakeKey(source));
+    if (it == m_entries.end())
+        return std::nullopt;
+
+    std::error_code errorCode;
+    const auto cookedTime = std::filesystem::last_write_time(it->second, errorCode);
+    if (errorCode)
+        return std::nullopt;
+
+    // source could be absent, if only cooked files are shipped
+    const auto sourceTime = std::filesystem::last_write_time(source, errorCode);
+    if (!errorCode && sourceTime > cookedTime)
+        return std::nullopt;
+
+    return it->second;
+}
+
+void TextureManifest::SetActive(std::shared_ptr<const TextureManifest> manifest)
+{
+    std::scoped_lock lock {activeManifestMutex};
+    activeManifest = std::move(manifest);
+}
+
+std::filesystem::path TextureManifest::Redirect(const std::filesystem::path& source)
+{
+    const auto manifest = [] {
+        std::scoped_lock lock {activeManifestMutex};
+        return activeManifest;
+    }();
+
+    if (!manifest)
+        return source;
+
+    return manifest->Find(source).value_or(source);
+}
+
+std::vector<std::filesystem::path> TextureManifest::GetDependencies(const std::filesystem::path& source)
+{
+    const auto manifest = [] {
+        std::scoped_lock lock {activeManifestMutex};
+        return activeManifest;
+    }();
+
+    std::vector dependencies {source};
+    if (!manifest)
+        return dependencies;
+
+    if (const auto it = manifest->m_entries.find(MakeKey(source)); it != manifest->m_entries.end())
+        dependencies.push_back(it->second);
+
+    return dependencies;
+}
+
+std::string TextureManifest::MakeKey(const std::filesystem::path& path)
+{
+    return MakeAbsolute(path).generic_string();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AT2::Resources
+{
+    // Maps source images to their cooked (mipmapped and block-compressed) versions, it's written by texture_cooker.
+    // Paths are stored relative to the manifest file. TextureLoader consults the active manifest when loading files.
+    class TextureManifest
+    {
+    public:
+        // Throws AT2IOException if the file can't be read or parsed
+        [[nodiscard]] static TextureManifest Load(const std::filesystem::path& manifestPath);
+        void Save(const std::filesystem::path& manifestPath) const;
+
+        void Add(const std::filesystem::path& source, const std::filesystem::path& cooked);
+        [[nodiscard]] size_t GetNumEntries() const noexcept { return m_entries.size(); }
+
+        // Cooked file for the source, it's ignored if missing or older than the source
+        [[nodiscard]] std::optional<std::filesystem::path> Find(const std::filesystem::path& source) const;
+
+        // Manifest is shared between loading threads, nullptr disables redirection
+        static void SetActive(std::shared_ptr<const TextureManifest> manifest);
+        // Returns cooked file if the active manifest has an actual one, or the source itself
+        [[nodiscard]] static std::filesystem::path Redirect(const std::filesystem::path& source);
+        // The source and it's cooked file in the active manifest, even an outdated one: loading of the source depends on both
+        [[nodiscard]] static std::vector<std::filesystem::path> GetDependencies(const std::filesystem::path& source);
+
+    private:
+        [[nodiscard]] static std::string MakeKey(const std::filesystem::path& path);
+
+    private:
+        std::unordered_map<std::string, std::filesystem::path> m_entries; // absolute paths
+    };
+
+} // namespace AT2::Resources
@@ -1,4 +1,7 @@
 #include "Animation.h"
+
+#include <cstdint>
+#include <functional>
 //#include <ranges>
 
 //using namespace AT2;
@@ -19,6 +22,24 @@ Animation& AnimationCollection::addAnimation(std::string name)
     return m_animations.emplace_back(*this, std::move(name));
 }
 
+void AnimationCollection::addExternalStorage(std::span<const std::byte> storage, std::shared_ptr<const void> owner)
+{
+    m_externalStorages.emplace_back(storage, std::move(owner));
+}
+
+bool AnimationCollection::isInExternalStorage(std::span<const std::byte> data, size_t alignment) const noexcept
+{
+    if (reinterpret_cast<std::uintptr_t>(data.data()) % alignment != 0)
+        return false;
+
+    // pointers to unrelated objects are comparable only with std::less
+    constexpr std::less<const std::byte*> less;
+    return std::ranges::any_of(m_externalStorages, [&](const auto& storage) {
+        const auto& [storageData, owner] = storage;
+        return !less(data.data(), storageData.data()) && !less(storageData.data() + storageData.size(), data.data() + data.size());
+    });
+}
+
 void AnimationCollection::updateNode(AnimationNodeId nodeId, Node& nodeInstance, const ITime& time)
 {
     if (!m_activeAnimation)
@@ -39,6 +39,8 @@ namespace AT2::Animation
 
     private:
         std::unordered_map<std::span<const std::byte>, std::pair<std::span<const std::byte>, std::any>, span_hash, span_equal> m_dataSources;
+        // memory which is guaranteed to live as long as the collection, so it's referenced without copying
+        std::vector<std::pair<std::span<const std::byte>, std::shared_ptr<const void>>> m_externalStorages;
         std::vector<Animation> m_animations;
 
         Animation* m_activeAnimation = nullptr;
@@ -53,6 +55,12 @@ namespace AT2::Animation
         const std::vector<Animation>& getAnimationsList() const noexcept { return m_animations; }
 
         void updateNode(AnimationNodeId nodeId, Scene::Node& nodeInstance, const ITime& time);
+
+        // Tracks data lying inside of the storage is used directly, owner keeps it alive
+        void addExternalStorage(std::span<const std::byte> storage, std::shared_ptr<const void> owner);
+
+    private:
+        [[nodiscard]] bool isInExternalStorage(std::span<const std::byte> data, size_t alignment) const noexcept;
     };
 
     // Инкапсулирует набор действий, который нужно совершить со сценой, чтобы она анимировалась
@@ -81,9 +89,12 @@ namespace AT2::Animation
         size_t addTrack(AnimationNodeId animationNodeId, std::span<const float> keySpan, std::span<const ValueT> valueSpan,
                         F&& affector, InterpolationMode interpolation)
         {
-            auto getTrustedSpan = [&dataSources = m_sourceCollection.m_dataSources]<typename T>(
+            auto getTrustedSpan = [this, &dataSources = m_sourceCollection.m_dataSources]<typename T>(
                                       std::span<const T> data) -> std::span<const T> {
                 const auto key = std::as_bytes(data);
+                if (m_sourceCollection.isInExternalStorage(key, alignof(T)))
+                    return data;
+
                 if (auto it = dataSources.find(key); it != dataSources.end())
                     return Utils::reinterpret_span_cast<const T>(it->second.first);
 
@@ -0,0 +1,127 @@
+#include "LightRegistry.h"
+
+using namespace AT2;
+using namespace AT2::Scene;
+
+namespace
+{
+    // Moves the last element to the index and drops the last one, so the arrays stay dense
+    template <typename... Columns>
+    void SwapRemove(size_t index, Columns&... columns)
+    {
+        ((columns[index] = std::move(columns.back()), columns.pop_back()), ...);
+    }
+} // namespace
+
+LightRegistry::Handle LightRegistry::AddSphereLight(const glm::vec3& position, const glm::vec3& intensity, float radius)
+{
+    const auto handle = AllocateSlot(Flavor::Sphere, m_sphereHandles.size());
+
+    m_sphereLights.Positions.push_back(position);
+    m_sphereLights.Intensities.push_back(intensity);
+    m_sphereLights.Radii.push_back(radius);
+    m_sphereHandles.push_back(handle);
+
+    return handle;
+}
+
+LightRegistry::Handle LightRegistry::AddSkyLight(const glm::vec3& position, const glm::vec3& intensity, const glm::vec3& direction,
+                                                 std::shared_ptr<ITexture> environmentMap)
+{
+    const auto handle = AllocateSlot(Flavor::Sky, m_skyHandles.size());
+
+    m_skyLights.Positions.push_back(position);
+    m_skyLights.Intensities.push_back(intensity);
+    m_skyLights.Directions.push_back(direction);
+    m_skyLights.EnvironmentMaps.push_back(std::move(environmentMap));
+    m_skyHandles.push_back(handle);
+
+    return handle;
+}
+
+void LightRegistry::Remove(Handle handle)
+{
+    const auto [flavor, index, used] = GetSlot(handle);
+
+    auto& handles = flavor == Flavor::Sphere ? m_sphereHandles : m_skyHandles;
+    m_slots[handles.back()].Index = index;
+
+    if (flavor == Flavor::Sphere)
+        SwapRemove(index, m_sphereLights.Positions, m_sphereLights.Intensities, m_sphereLights.Radii, handles);
+    else
+        SwapRemove(index, m_skyLights.Positions, m_skyLights.Intensities, m_skyLights.Directions, m_skyLights.EnvironmentMaps, handles);
+
+    m_slots[handle] = {flavor, m_firstFreeSlot, false};
+    m_firstFreeSlot = handle;
+}
+
+void LightRegistry::SetTransform(Handle handle, const glm::vec3& position, const glm::vec3& direction)
+{
+    const auto& slot = GetSlot(handle);
+    if (slot.Type == Flavor::Sphere)
+        m_sphereLights.Positions[slot.Index] = position;
+    else
+    {
+        m_skyLights.Positions[slot.Index] = position;
+        m_skyLights.Directions[slot.Index] = direction;
+    }
+}
+
+void LightRegistry::SetIntensity(Handle handle, const glm::vec3& intensity, float radius)
+{
+    const auto& slot = GetSlot(handle);
+    if (slot.Type == Flavor::Sphere)
+    {
+        m_sphereLights.Intensities[slot.Index] = intensity;
+        m_sphereLights.Radii[slot.Index] = radius;
+    }
+    else
+        m_skyLights.Intensities[slot.Index] = intensity;
+}
+
+bool LightRegistry::Contains(Handle handle) const noexcept
+{
+    return handle < m_slots.size() && m_slots[handle].Used;
+}
+
+std::optional<size_t> LightRegistry::FindNearestSkyLight(const glm::vec3& position) const noexcept
+{
+    std::optional<size_t> nearest;
+    float nearestDistance = std::numeric_limits<float>::max();
+
+    for (size_t i = 0; i < m_skyLights.Positions.size(); ++i)
+    {
+        const auto offset = m_skyLights.Positions[i] - position;
+        const float distance = glm::dot(offset, offset);
+        if (distance < nearestDistance)
+        {
+            nearest = i;
+            nearestDistance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+LightRegistry::Handle LightRegistry::AllocateSlot(Flavor flavor, size_t index)
+{
+    const Slot slot {flavor, static_cast<std::uint32_t>(index), true};
+    if (m_firstFreeSlot == InvalidIndex)
+    {
+        m_slots.push_back(slot);
+        return static_cast<Handle>(m_slots.size() - 1);
+    }
+
+    const auto handle = m_firstFreeSlot;
+    m_firstFreeSlot = m_slots[handle].Index;
+    m_slots[handle] = slot;
+    return handle;
+}
+
+const LightRegistry::Slot& LightRegistry::GetSlot(Handle handle) const
+{
+    if (!Contains(handle))
+        throw AT2Exception("LightRegistry: invalid light handle");
+
+    return m_slots[handle];
+}
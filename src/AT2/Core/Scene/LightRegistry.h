@@ -0,0 +1,81 @@
+#pragma once
+
+#include <AT2.h>
+
+#include <limits>
+#include <optional>
+
+namespace AT2::Scene
+{
+    // Dense storage of the scene lights by flavor, so the lighting pass reads contiguous arrays instead of walking the scene.
+    // Handles stay valid until the light is removed, indices of the arrays don't: removal moves the last light of the same
+    // flavor to the freed place.
+    class LightRegistry
+    {
+    public:
+        using Handle = std::uint32_t;
+
+        struct SphereLights
+        {
+            std::vector<glm::vec3> Positions; // world space
+            std::vector<glm::vec3> Intensities;
+            std::vector<float> Radii;
+        };
+
+        struct SkyLights
+        {
+            std::vector<glm::vec3> Positions; // world space
+            std::vector<glm::vec3> Intensities;
+            std::vector<glm::vec3> Directions; // world space, towards the light
+            std::vector<std::shared_ptr<ITexture>> EnvironmentMaps;
+        };
+
+        Handle AddSphereLight(const glm::vec3& position, const glm::vec3& intensity, float radius);
+        Handle AddSkyLight(const glm::vec3& position, const glm::vec3& intensity, const glm::vec3& direction,
+                           std::shared_ptr<ITexture> environmentMap);
+        void Remove(Handle handle);
+
+        // Direction is ignored by sphere lights, radius is ignored by sky lights
+        void SetTransform(Handle handle, const glm::vec3& position, const glm::vec3& direction);
+        void SetIntensity(Handle handle, const glm::vec3& intensity, float radius);
+
+        [[nodiscard]] bool Contains(Handle handle) const noexcept;
+        [[nodiscard]] size_t GetNumLights() const noexcept { return m_sphereHandles.size() + m_skyHandles.size(); }
+
+        [[nodiscard]] const SphereLights& GetSphereLights() const noexcept { return m_sphereLights; }
+        [[nodiscard]] const SkyLights& GetSkyLights() const noexcept { return m_skyLights; }
+        // Handles of the sphere lights by index of the arrays
+        [[nodiscard]] std::span<const Handle> GetSphereLightHandles() const noexcept { return m_sphereHandles; }
+
+        // Index of the sky light nearest to the position, empty if there are no sky lights
+        [[nodiscard]] std::optional<size_t> FindNearestSkyLight(const glm::vec3& position) const noexcept;
+
+    private:
+        enum class Flavor : std::uint8_t
+        {
+            Sphere,
+            Sky
+        };
+
+        struct Slot
+        {
+            Flavor Type = Flavor::Sphere;
+            std::uint32_t Index = InvalidIndex; // in the arrays of the flavor, or the next free slot when it's unused
+            bool Used = false;
+        };
+
+        static constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+        Handle AllocateSlot(Flavor flavor, size_t index);
+        const Slot& GetSlot(Handle handle) const;
+
+    private:
+        std::vector<Slot> m_slots;
+        std::uint32_t m_firstFreeSlot = InvalidIndex;
+
+        SphereLights m_sphereLights;
+        SkyLights m_skyLights;
+        std::vector<Handle> m_sphereHandles, m_skyHandles; // handle of every light of the arrays
+    };
+
+} // namespace AT2::Scene
@@ -62,6 +62,68 @@ void UpdateVisitor::UnVisit(Node& node)
     m_transforms.popModelView();
 }
 
+LightComponent& LightComponent::SetIntensity(glm::vec3 newIntensity)
+{
+    m_intensity = newIntensity;
+    UpdateEffectiveRadius();
+
+    for (const auto& [weakRegistry, handle] : m_registrations)
+        if (const auto registry = weakRegistry.lock())
+            registry->SetIntensity(handle, m_intensity, m_effectiveRadius);
+
+    return *this;
+}
+
+LightComponent& LightComponent::SetLuminanceCutoff(float luminanceCutoff)
+{
+    if (!(luminanceCutoff > 0.0f))
+        throw AT2Exception("LightComponent: luminance cutoff must be positive");
+
+    m_luminanceCutoff = luminanceCutoff;
+    return SetIntensity(m_intensity);
+}
+
+void LightComponent::SetEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!m_enabled)
+        Unregister();
+}
+
+void LightComponent::update(UpdateVisitor& updateVisitor)
+{
+    // registries of destroyed scenes
+    std::erase_if(m_registrations, [](const Registration& registration) { return registration.Registry.expired(); });
+
+    const auto& registry = updateVisitor.getLightRegistry();
+    if (!m_enabled || !registry)
+        return;
+
+    const auto& transform = updateVisitor.getTransformsStack().getModelView();
+    const auto position = glm::vec3 {transform * glm::vec4 {0, 0, 0, 1}};
+    const auto* skyLight = std::get_if<SkyLight>(&m_flavor);
+    const auto direction = skyLight ? glm::mat3 {transform} * skyLight->Direction : glm::vec3 {};
+
+    const auto it = std::ranges::find_if(m_registrations, [&registry](const Registration& registration) {
+        return registration.Registry.lock() == registry;
+    });
+    if (it != m_registrations.end())
+        registry->SetTransform(it->Handle, position, direction);
+    else if (skyLight)
+        m_registrations.push_back({registry, registry->AddSkyLight(position, m_intensity, direction, skyLight->EnvironmentMap)});
+    else
+        m_registrations.push_back({registry, registry->AddSphereLight(position, m_intensity, m_effectiveRadius)});
+}
+
+void LightComponent::Unregister()
+{
+    for (const auto& [weakRegistry, handle] : m_registrations)
+        if (const auto registry = weakRegistry.lock())
+            registry->Remove(handle);
+
+    m_registrations.clear();
+}
+
 Node* AT2::Scene::Scene::FindNode(std::string_view name, const std::type_info* nodeType) const
 {
     NodeFindVisitor visitor {std::move(name), nodeType};
@@ -72,6 +134,6 @@ Node* AT2::Scene::Scene::FindNode(std::string_view name, const std::type_info* n
 
 void AT2::Scene::Scene::Update(const ITime& time)
 {
-    UpdateVisitor updateVisitor {time};
+    UpdateVisitor updateVisitor {time, lightRegistry};
     GetRoot().Accept(updateVisitor);
 }
@@ -6,7 +6,10 @@
 
 #include <Mesh.h>
 #include <Camera.h>
+#include <LightBudget.h>
+#include <OcclusionBuffer.h>
 #include <matrix_stack.h>
+#include "LightRegistry.h"
 
 //TODO: split into different headers
 
@@ -149,12 +152,16 @@ namespace AT2::Scene
     {
         MatrixStack m_transforms;
         const ITime& m_timeSource;
+        std::shared_ptr<LightRegistry> m_lightRegistry;
 
     public:
-        UpdateVisitor(const ITime& timeSource) : m_timeSource(timeSource) {}
+        UpdateVisitor(const ITime& timeSource, std::shared_ptr<LightRegistry> lightRegistry = nullptr) :
+            m_timeSource(timeSource), m_lightRegistry(std::move(lightRegistry)) {}
 
         [[nodiscard]] const MatrixStack& getTransformsStack() const noexcept { return m_transforms; }
         [[nodiscard]] const ITime& getTime() const noexcept { return m_timeSource; }
+        // Registry light components of the visited nodes are kept in, could be null
+        [[nodiscard]] const std::shared_ptr<LightRegistry>& getLightRegistry() const noexcept { return m_lightRegistry; }
 
         //TODO: some way to send messages down to hierarchy
 
@@ -163,7 +170,6 @@ namespace AT2::Scene
         void UnVisit(Node& node) override;
     };
 
-    //TODO: turn into components 
     struct SphereLight
     {
     };
@@ -174,43 +180,59 @@ namespace AT2::Scene
         std::shared_ptr<ITexture> EnvironmentMap;
     };
 
-    struct LightNode : Node
+    // Light at the node position. It's registered at the light registry of the scene by the first update, then every
+    // update writes it's transform there, changes of the intensity are written immediately. Disabled lights are removed
+    // from the registry.
+    // Radius of sphere lights is where they fall off to the luminance cutoff, see GetLightInfluenceRadius.
+    class LightComponent : public NodeComponent
     {
+    public:
         using LightFlavor = std::variant<SphereLight, SkyLight>;
 
-        LightNode() = default;
-        LightNode(LightFlavor flavor, glm::vec3 color, std::string name) :
-            Node(std::move(name)), flavor(std::move(flavor)), intensity(color)
+        LightComponent(LightFlavor flavor, glm::vec3 intensity) : m_flavor(std::move(flavor)), m_intensity(intensity)
         {
             UpdateEffectiveRadius();
         }
+        ~LightComponent() override { Unregister(); }
 
-        LightNode& SetIntensity(glm::vec3 newIntensity)
-        {
-            intensity = newIntensity;
-            UpdateEffectiveRadius();
-
-            return *this;
-        }
+        LightComponent(const LightComponent&) = delete;
+        LightComponent& operator=(const LightComponent&) = delete;
 
-        void SetEnabled(bool _enabled) { enabled = _enabled; }
+        LightComponent& SetIntensity(glm::vec3 newIntensity);
+        LightComponent& SetLuminanceCutoff(float luminanceCutoff);
+        void SetEnabled(bool enabled);
 
-        [[nodiscard]] const glm::vec3& GetIntensity() const noexcept { return intensity; }
-        [[nodiscard]] float GetEffectiveRadius() const noexcept { return effectiveRadius; }
-        [[nodiscard]] const LightFlavor& GetFlavor() const noexcept { return flavor; }
-        [[nodiscard]] bool GetEnabled() const noexcept { return enabled; }
+        [[nodiscard]] const glm::vec3& GetIntensity() const noexcept { return m_intensity; }
+        [[nodiscard]] float GetLuminanceCutoff() const noexcept { return m_luminanceCutoff; }
+        [[nodiscard]] float GetEffectiveRadius() const noexcept { return m_effectiveRadius; }
+        [[nodiscard]] const LightFlavor& GetFlavor() const noexcept { return m_flavor; }
+        [[nodiscard]] bool GetEnabled() const noexcept { return m_enabled; }
 
     protected:
-        void UpdateEffectiveRadius()
+        void update(UpdateVisitor& updateVisitor) override;
+
+    private:
+        void UpdateEffectiveRadius() { m_effectiveRadius = GetLightInfluenceRadius(m_intensity, m_luminanceCutoff); }
+
+        void Unregister();
+
+    private:
+        // Nodes are shared, so a light could be in several scenes and outlive them; it's kept in the registry of every scene
+        // it was updated by, registries are referenced weakly
+        struct Registration
         {
-            effectiveRadius = length(intensity) * 0.5f; //TODO: think about it :)
-        }
+            std::weak_ptr<LightRegistry> Registry;
+            LightRegistry::Handle Handle = 0;
+        };
 
     private:
-        LightFlavor flavor = SphereLight {};
-        glm::vec3 intensity = {100, 100, 100};
-        float effectiveRadius = 10.0;
-        bool enabled = true;
+        LightFlavor m_flavor;
+        glm::vec3 m_intensity;
+        float m_luminanceCutoff = DefaultLightLuminanceCutoff;
+        float m_effectiveRadius = 0.0f;
+        bool m_enabled = true;
+
+        std::vector<Registration> m_registrations;
     };
 
     class MeshComponent : public NodeComponent
@@ -244,7 +266,7 @@ namespace AT2::Scene
 
         MeshComponent() = default;
         MeshComponent(MeshRef mesh, std::vector<unsigned> submeshIndices) :
-            m_mesh(std::move(mesh)), m_submeshIndices(std::move(submeshIndices)) {}
+            m_mesh(std::move(mesh)), m_submeshIndices(std::move(submeshIndices)), m_submeshLods(m_submeshIndices.size()) {}
 
 
         void setSkeletonInstance(SkeletonInstanceRef skeletonInstance) { m_skeletonInstance = std::move(skeletonInstance);}
@@ -255,6 +277,9 @@ namespace AT2::Scene
         [[nodiscard]] MeshRef getMesh() noexcept { return m_mesh; }
 
         std::span<const unsigned> GetSubmeshIndices() const noexcept { return m_submeshIndices; }
+        // Levels of detail the submeshes were drawn with the last time, used for hysteresis by LodSelector
+        std::span<unsigned> GetSubmeshLods() noexcept { return m_submeshLods; }
+        std::span<const unsigned> GetSubmeshLods() const noexcept { return m_submeshLods; }
 
         void update(UpdateVisitor&) override {}
 
@@ -263,7 +288,22 @@ namespace AT2::Scene
         SkeletonInstanceRef m_skeletonInstance;
 
         std::vector<unsigned> m_submeshIndices;
+        std::vector<unsigned> m_submeshLods;
+    };
+
+
+    // Coarse proxy the node occludes other objects by, see OcclusionBuffer
+    class OccluderComponent : public NodeComponent
+    {
+    public:
+        OccluderComponent(std::shared_ptr<const OccluderMesh> occluder) : m_occluder(std::move(occluder)) {}
 
+        [[nodiscard]] const std::shared_ptr<const OccluderMesh>& getOccluder() const noexcept { return m_occluder; }
+
+        void update(UpdateVisitor&) override {}
+
+    private:
+        std::shared_ptr<const OccluderMesh> m_occluder;
     };
 
 
@@ -299,7 +339,12 @@ namespace AT2::Scene
         Node* FindNode(std::string_view name, const std::type_info* nodeType = nullptr) const;
         void Update(const ITime& time);
 
+        // Lights of the last update
+        [[nodiscard]] const LightRegistry& GetLightRegistry() const noexcept { return *lightRegistry; }
+
     private:
+        // light components refer to it weakly, so nodes may outlive the scene
+        std::shared_ptr<LightRegistry> lightRegistry = std::make_shared<LightRegistry>();
         NodeRef root = std::make_shared<Node>();
     };
 
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+
+namespace AT2
+{
+    // Adds the wall time from construction to destruction to the target, so one duration could sum several scopes
+    template <typename Duration>
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Duration& target) : m_target {target} {}
+        ~ScopedTimer() { m_target += std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - m_start); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Duration& m_target;
+        std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+    };
+
+} // namespace AT2
@@ -0,0 +1,42 @@
+#include "ShaderPermutations.h"
+
+using namespace AT2;
+
+ShaderPermutations::ShaderPermutations(const IResourceFactory& resourceFactory, std::vector<str> files, std::vector<str> featureNames) :
+    m_resourceFactory {resourceFactory}, m_files {std::move(files)}, m_featureNames {std::move(featureNames)}
+{
+    if (m_featureNames.size() > sizeof(FeatureMask) * 8)
+        throw AT2Exception("ShaderPermutations: too many features");
+}
+
+const std::shared_ptr<IShaderProgram>& ShaderPermutations::Get(FeatureMask features)
+{
+    auto [it, inserted] = m_variants.try_emplace(features);
+    if (inserted)
+    {
+        try
+        {
+            it->second = m_resourceFactory.CreateShaderProgramFromFiles(m_files, MakeDefines(features));
+        }
+        catch (...)
+        {
+            m_variants.erase(it);
+            throw;
+        }
+    }
+
+    return it->second;
+}
+
+std::vector<ShaderDefine> ShaderPermutations::MakeDefines(FeatureMask features) const
+{
+    if (m_featureNames.size() < sizeof(FeatureMask) * 8 && (features >> m_featureNames.size()) != 0)
+        throw AT2Exception("ShaderPermutations: unknown feature requested");
+
+    std::vector<ShaderDefine> defines;
+    for (size_t i = 0; i < m_featureNames.size(); ++i)
+        if (features & (FeatureMask {1} << i))
+            defines.push_back({m_featureNames[i]});
+
+    return defines;
+}
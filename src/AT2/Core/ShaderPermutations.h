@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "AT2.h"
+#include "ShaderPreprocessor.h"
+
+namespace AT2
+{
+    // Set of program variants sharing the same sources. Every feature is a bit in FeatureMask which is turned into
+    // "#define <FeatureName> 1" at preprocessing, so shaders use #ifdef instead of runtime branches on uniforms.
+    // Variants are built only on request and cached.
+    class ShaderPermutations
+    {
+    public:
+        using FeatureMask = std::uint32_t;
+
+        ShaderPermutations(const IResourceFactory& resourceFactory, std::vector<str> files, std::vector<str> featureNames);
+
+        [[nodiscard]] const std::shared_ptr<IShaderProgram>& Get(FeatureMask features);
+        [[nodiscard]] std::vector<ShaderDefine> MakeDefines(FeatureMask features) const;
+
+        [[nodiscard]] size_t GetNumVariants() const noexcept { return m_variants.size(); }
+
+    private:
+        const IResourceFactory& m_resourceFactory;
+        std::vector<str> m_files;
+        std::vector<str> m_featureNames;
+        std::unordered_map<FeatureMask, std::shared_ptr<IShaderProgram>> m_variants;
+    };
+
+} // namespace AT2
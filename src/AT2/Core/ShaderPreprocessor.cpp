@@ -0,0 +1,237 @@
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include <AT2_exceptions.hpp>
+
+using namespace AT2;
+using namespace std::literals;
+
+namespace
+{
+    constexpr std::string_view Whitespaces = " \t"sv;
+
+    std::string_view TrimLeft(std::string_view str)
+    {
+        const auto position = str.find_first_not_of(Whitespaces);
+        return position == std::string_view::npos ? std::string_view {} : str.substr(position);
+    }
+
+    bool IsIdentifier(std::string_view name)
+    {
+        const auto isIdentifierChar = [](char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        };
+
+        return !name.empty() && !(name.front() >= '0' && name.front() <= '9') && std::ranges::all_of(name, isIdentifierChar);
+    }
+
+    // Splits "#  directive rest" line, returns nullopt for non-directive lines
+    std::optional<std::pair<std::string_view, std::string_view>> ParseDirective(std::string_view line)
+    {
+        line = TrimLeft(line);
+        if (!line.starts_with('#'))
+            return std::nullopt;
+
+        line = TrimLeft(line.substr(1));
+        const auto nameEnd = std::min(line.find_first_of(Whitespaces), line.size());
+        return std::pair {line.substr(0, nameEnd), TrimLeft(line.substr(nameEnd))};
+    }
+
+    // Returns whether the line ends inside of a /* */ comment, when it starts in one or opens it
+    bool EndsInComment(std::string_view line, bool inComment)
+    {
+        while (!line.empty())
+        {
+            if (inComment)
+            {
+                const auto commentEnd = line.find("*/"sv);
+                if (commentEnd == std::string_view::npos)
+                    return true;
+
+                line.remove_prefix(commentEnd + 2);
+                inComment = false;
+            }
+            else
+            {
+                const auto commentStart = line.find('/');
+                if (commentStart == std::string_view::npos || commentStart + 1 == line.size() || line[commentStart + 1] == '/')
+                    return false;
+
+                line.remove_prefix(commentStart + 1);
+                inComment = line.front() == '*';
+                if (inComment)
+                    line.remove_prefix(1);
+            }
+        }
+
+        return inComment;
+    }
+
+    std::string Location(const std::filesystem::path& path, size_t lineNumber)
+    {
+        return path.string() + ":" + std::to_string(lineNumber) + ": ";
+    }
+
+    // Accepts both "file" and <file> forms
+    std::optional<std::string_view> ParseIncludeName(std::string_view argument)
+    {
+        if (argument.size() < 2)
+            return std::nullopt;
+
+        const char closing = argument.front() == '"' ? '"' : argument.front() == '<' ? '>' : '\0';
+        const auto closingPosition = argument.find(closing, 1);
+        if (closing == '\0' || closingPosition == std::string_view::npos || closingPosition == 1)
+            return std::nullopt;
+
+        return argument.substr(1, closingPosition - 1);
+    }
+
+    void AppendLineDirective(std::string& output, size_t lineNumber, size_t sourceIndex)
+    {
+        output.append("#line "sv).append(std::to_string(lineNumber)).append(" "sv).append(std::to_string(sourceIndex)).append("\n"sv);
+    }
+} // namespace
+
+struct ShaderPreprocessor::Context
+{
+    std::string Output;
+    std::vector<std::filesystem::path> Dependencies;
+    std::optional<size_t> VersionEnd; // position in Output right after the root's #version
+    size_t LineAfterVersion = 1;
+};
+
+ShaderPreprocessor::ShaderPreprocessor(FileLoader fileLoader) : m_fileLoader {std::move(fileLoader)} {}
+
+std::optional<std::string> ShaderPreprocessor::LoadFromDisk(const std::filesystem::path& filename)
+{
+    std::ifstream stream {filename, std::ios::binary};
+    if (!stream.is_open())
+        return std::nullopt;
+
+    return std::string {std::istreambuf_iterator<char> {stream}, std::istreambuf_iterator<char> {}};
+}
+
+ShaderPreprocessor::Result ShaderPreprocessor::Process(const std::filesystem::path& filename,
+                                                       std::span<const ShaderDefine> defines) const
+{
+    const auto source = m_fileLoader(filename);
+    if (!source)
+        throw AT2IOException("file '" + filename.string() + "' not found.");
+
+    return ProcessSource(*source, filename, defines);
+}
+
+ShaderPreprocessor::Result ShaderPreprocessor::ProcessSource(std::string_view source, const std::filesystem::path& sourcePath,
+                                                             std::span<const ShaderDefine> defines) const
+{
+    Context context;
+    Expand(context, source, sourcePath.lexically_normal());
+
+    if (!defines.empty())
+    {
+        std::string definesBlock;
+        for (const auto& [name, value] : defines)
+        {
+            if (!IsIdentifier(name))
+                throw AT2ShaderException("ShaderPreprocessor: invalid define name '" + name + "'");
+
+            definesBlock.append("#define "sv).append(name).append(" "sv).append(value).append("\n"sv);
+        }
+        AppendLineDirective(definesBlock, context.LineAfterVersion, 0);
+
+        context.Output.insert(context.VersionEnd.value_or(0), definesBlock);
+    }
+
+    return {std::move(context.Output), std::move(context.Dependencies)};
+}
+
+void ShaderPreprocessor::Expand(Context& context, std::string_view source, const std::filesystem::path& sourcePath) const
+{
+    const bool isRoot = context.Dependencies.empty();
+    const size_t sourceIndex = context.Dependencies.size();
+    context.Dependencies.push_back(sourcePath);
+
+    size_t lineNumber = 0;
+    bool inComment = false;
+    size_t conditionalDepth = 0;
+    while (!source.empty())
+    {
+        ++lineNumber;
+
+        const auto lineEnd = source.find('\n');
+        const auto line = source.substr(0, lineEnd);
+        source.remove_prefix(lineEnd == std::string_view::npos ? source.size() : lineEnd + 1);
+
+        // directives are only recognized outside of block comments
+        const bool startsInComment = std::exchange(inComment, EndsInComment(line, inComment));
+        const auto directive = startsInComment ? std::nullopt : ParseDirective(line);
+        if (!directive)
+        {
+            context.Output.append(line).append("\n"sv);
+            continue;
+        }
+
+        const auto& [name, argument] = *directive;
+        if (name == "version"sv)
+        {
+            // lines are replaced by empty ones to keep numbering
+            if (!isRoot)
+            {
+                context.Output.append("\n"sv);
+                continue;
+            }
+
+            context.Output.append(line).append("\n"sv);
+            if (!context.VersionEnd)
+            {
+                context.VersionEnd = context.Output.size();
+                context.LineAfterVersion = lineNumber + 1;
+            }
+        }
+        else if (name == "include"sv)
+        {
+            // conditions depend on macros which are evaluated by the driver, after includes are resolved
+            if (conditionalDepth > 0)
+                throw AT2ShaderException(Location(sourcePath, lineNumber) + "#include inside of conditional block isn't supported");
+
+            const auto includeName = ParseIncludeName(argument);
+            if (!includeName)
+                throw AT2ShaderException(Location(sourcePath, lineNumber) + "malformed #include directive");
+
+            const auto includePath = (sourcePath.parent_path() / *includeName).lexically_normal();
+            if (std::ranges::find(context.Dependencies, includePath) != context.Dependencies.end())
+            {
+                context.Output.append("\n"sv);
+                continue;
+            }
+
+            const auto includeSource = m_fileLoader(includePath);
+            if (!includeSource)
+                throw AT2IOException(Location(sourcePath, lineNumber) + "can't open included file '" + includePath.string() + "'");
+
+            AppendLineDirective(context.Output, 1, context.Dependencies.size());
+            Expand(context, *includeSource, includePath);
+            AppendLineDirective(context.Output, lineNumber + 1, sourceIndex);
+        }
+        else if (name == "if"sv || name == "ifdef"sv || name == "ifndef"sv || name == "endif"sv)
+        {
+            if (name != "endif"sv)
+                ++conditionalDepth;
+            else if (conditionalDepth > 0)
+                --conditionalDepth;
+
+            context.Output.append(line).append("\n"sv);
+        }
+        else if (name == "pragma"sv && argument.starts_with("once"sv))
+        {
+            // every file is included once anyway
+            context.Output.append("\n"sv);
+        }
+        else
+            context.Output.append(line).append("\n"sv);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AT2
+{
+    struct ShaderDefine
+    {
+        std::string Name;
+        std::string Value = "1";
+    };
+
+    // CPU-side GLSL preprocessing, done before passing sources to the driver.
+    // Resolves #include "file" directives relative to the including file, every file is included only once per program
+    // (as if it had #pragma once), so include guards aren't mandatory. #version of included files is dropped.
+    // Includes are resolved before macros are known, so #include isn't allowed inside of #if/#ifdef blocks.
+    // Defines are injected right after #version of the root file. #line directives keep driver's diagnostics readable:
+    // source string number is an index in Result::Dependencies.
+    class ShaderPreprocessor
+    {
+    public:
+        using FileLoader = std::function<std::optional<std::string>(const std::filesystem::path&)>;
+
+        struct Result
+        {
+            std::string Source;
+            std::vector<std::filesystem::path> Dependencies; // all files used, root first
+        };
+
+        explicit ShaderPreprocessor(FileLoader fileLoader = LoadFromDisk);
+
+        [[nodiscard]] Result Process(const std::filesystem::path& filename, std::span<const ShaderDefine> defines = {}) const;
+        [[nodiscard]] Result ProcessSource(std::string_view source, const std::filesystem::path& sourcePath,
+                                           std::span<const ShaderDefine> defines = {}) const;
+
+        [[nodiscard]] static std::optional<std::string> LoadFromDisk(const std::filesystem::path& filename);
+
+    private:
+        struct Context;
+        void Expand(Context& context, std::string_view source, const std::filesystem::path& sourcePath) const;
+
+    private:
+        FileLoader m_fileLoader;
+    };
+
+} // namespace AT2
@@ -0,0 +1,148 @@
+#include "ShadowAtlas.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace AT2;
+
+ShadowAtlas::ShadowAtlas(unsigned int size, unsigned int minTileSize) :
+    m_size {size}, m_minTileSize {minTileSize}, m_freeArea {static_cast<size_t>(size) * size}
+{
+    if (!std::has_single_bit(size) || !std::has_single_bit(minTileSize))
+        throw AT2Exception("ShadowAtlas: sizes must be powers of two");
+    if (minTileSize > size)
+        throw AT2Exception("ShadowAtlas: min tile size must not exceed the atlas size");
+
+    Clear();
+}
+
+std::optional<ShadowAtlas::Tile> ShadowAtlas::Allocate(unsigned int size)
+{
+    size = std::max(std::bit_ceil(size), m_minTileSize);
+    if (size > m_size)
+        return std::nullopt;
+
+    std::optional<Candidate> best;
+    FindFreeNode(0, {0, 0}, m_size, size, best);
+    if (!best)
+        return std::nullopt;
+
+    // the node is split down to the tile size, the tile takes the first quadrant of every level
+    auto [index, offset, nodeSize] = *best;
+    for (; nodeSize > size; nodeSize /= 2)
+        index = SplitNode(index);
+
+    m_nodes[index].State = NodeState::Used;
+    ++m_numTiles;
+    m_freeArea -= static_cast<size_t>(size) * size;
+
+    return Tile {offset, size};
+}
+
+void ShadowAtlas::Free(const Tile& tile)
+{
+    // path from the root to the tile node, the free quadrants are merged back along it
+    std::uint32_t path[32];
+    size_t depth = 0;
+
+    std::uint32_t index = 0;
+    glm::uvec2 offset {0, 0};
+    unsigned int nodeSize = m_size;
+    while (nodeSize > tile.Size && m_nodes[index].State == NodeState::Split)
+    {
+        path[depth++] = index;
+
+        nodeSize /= 2;
+        const glm::uvec2 quadrant {tile.Offset.x >= offset.x + nodeSize, tile.Offset.y >= offset.y + nodeSize};
+        offset += quadrant * nodeSize;
+        index = m_nodes[index].FirstChild + quadrant.y * 2 + quadrant.x;
+    }
+
+    if (nodeSize != tile.Size || offset != tile.Offset || m_nodes[index].State != NodeState::Used)
+        throw AT2Exception("ShadowAtlas: tile is not allocated");
+
+    m_nodes[index].State = NodeState::Free;
+    --m_numTiles;
+    m_freeArea += static_cast<size_t>(tile.Size) * tile.Size;
+
+    while (depth > 0)
+    {
+        auto& parent = m_nodes[path[--depth]];
+        const auto* quadrants = &m_nodes[parent.FirstChild];
+        if (!std::all_of(quadrants, quadrants + 4, [](const Node& node) { return node.State == NodeState::Free; }))
+            break;
+
+        m_freeChildBlocks.push_back(parent.FirstChild);
+        parent = {};
+    }
+}
+
+void ShadowAtlas::Clear()
+{
+    m_nodes.assign(1, Node {});
+    m_freeChildBlocks.clear();
+    m_numTiles = 0;
+    m_freeArea = static_cast<size_t>(m_size) * m_size;
+}
+
+unsigned int ShadowAtlas::GetTileSize(float screenCoverage, unsigned int maxTileSize) const noexcept
+{
+    maxTileSize = std::min(std::bit_floor(std::max(maxTileSize, m_minTileSize)), m_size);
+
+    const float idealSize = std::sqrt(std::clamp(screenCoverage, 0.0f, 1.0f)) * static_cast<float>(maxTileSize);
+    return std::clamp(std::bit_ceil(static_cast<unsigned int>(idealSize)), m_minTileSize, maxTileSize);
+}
+
+glm::mat4 ShadowAtlas::GetTileMatrix(const Tile& tile) const noexcept
+{
+    const float halfSize = 0.5f * static_cast<float>(tile.Size) / static_cast<float>(m_size);
+    const auto origin = glm::vec2 {tile.Offset} / static_cast<float>(m_size);
+
+    glm::mat4 result {1.0f};
+    result[0][0] = halfSize;
+    result[1][1] = halfSize;
+    result[2][2] = 0.5f;
+    result[3] = glm::vec4 {origin + halfSize, 0.5f, 1.0f};
+    return result;
+}
+
+void ShadowAtlas::FindFreeNode(std::uint32_t index, glm::uvec2 offset, unsigned int nodeSize, unsigned int size,
+                               std::optional<Candidate>& best) const
+{
+    if (nodeSize < size || (best && best->Size == size))
+        return;
+
+    const auto& node = m_nodes[index];
+    if (node.State == NodeState::Free)
+    {
+        if (!best || nodeSize < best->Size)
+            best = Candidate {index, offset, nodeSize};
+    }
+    else if (node.State == NodeState::Split)
+    {
+        const auto childSize = nodeSize / 2;
+        for (std::uint32_t i = 0; i < 4; ++i)
+            FindFreeNode(node.FirstChild + i, offset + glm::uvec2 {i % 2, i / 2} * childSize, childSize, size, best);
+    }
+}
+
+std::uint32_t ShadowAtlas::SplitNode(std::uint32_t index)
+{
+    std::uint32_t firstChild;
+    if (!m_freeChildBlocks.empty())
+    {
+        firstChild = m_freeChildBlocks.back();
+        m_freeChildBlocks.pop_back();
+        std::fill_n(m_nodes.begin() + firstChild, 4, Node {});
+    }
+    else
+    {
+        firstChild = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + 4);
+    }
+
+    // after the resize, the node reference would dangle
+    m_nodes[index] = {NodeState::Split, firstChild};
+    return firstChild;
+}
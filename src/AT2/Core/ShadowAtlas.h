@@ -0,0 +1,80 @@
+#pragma once
+
+#include "AT2.h"
+
+#include <optional>
+
+namespace AT2
+{
+    // Quadtree allocator of square tiles of the shadow map atlas, sizes of the atlas and tiles are powers of two. Every node
+    // of the tree is free, used by a tile or split to four quadrants; freeing the last used quadrant merges them back.
+    // Allocation takes the smallest free node which fits, so big nodes are left for big tiles.
+    class ShadowAtlas
+    {
+    public:
+        static constexpr unsigned int DefaultMinTileSize = 64;
+
+        struct Tile
+        {
+            glm::uvec2 Offset {0}; // in texels
+            unsigned int Size = 0;
+
+            friend bool operator==(const Tile&, const Tile&) = default;
+        };
+
+    public:
+        explicit ShadowAtlas(unsigned int size, unsigned int minTileSize = DefaultMinTileSize);
+
+        // Size is rounded up to a power of two not less than the min tile size. Returns nullopt if there is no free place.
+        [[nodiscard]] std::optional<Tile> Allocate(unsigned int size);
+        void Free(const Tile& tile);
+        void Clear();
+
+        // Tile size for a light covering the fraction of the screen, see LightBudget::GetScreenCoverage. The tile side is
+        // proportional to the side of the covered area, so the texel density on the screen stays about the same.
+        [[nodiscard]] unsigned int GetTileSize(float screenCoverage, unsigned int maxTileSize) const noexcept;
+
+        // Maps clip space of the view rendered to the tile to texture coordinates of the atlas and [0, 1] depth
+        [[nodiscard]] glm::mat4 GetTileMatrix(const Tile& tile) const noexcept;
+
+        [[nodiscard]] unsigned int GetSize() const noexcept { return m_size; }
+        [[nodiscard]] unsigned int GetMinTileSize() const noexcept { return m_minTileSize; }
+        [[nodiscard]] size_t GetNumTiles() const noexcept { return m_numTiles; }
+        [[nodiscard]] size_t GetFreeArea() const noexcept { return m_freeArea; }
+
+    private:
+        enum class NodeState : std::uint8_t
+        {
+            Free,
+            Used,
+            Split
+        };
+
+        struct Node
+        {
+            NodeState State = NodeState::Free;
+            std::uint32_t FirstChild = 0; // quadrants are stored together, by rows from the atlas origin
+        };
+
+        struct Candidate
+        {
+            std::uint32_t Index = 0;
+            glm::uvec2 Offset {0};
+            unsigned int Size = 0;
+        };
+
+        void FindFreeNode(std::uint32_t index, glm::uvec2 offset, unsigned int nodeSize, unsigned int size,
+                          std::optional<Candidate>& best) const;
+        std::uint32_t SplitNode(std::uint32_t index);
+
+    private:
+        unsigned int m_size;
+        unsigned int m_minTileSize;
+        size_t m_numTiles = 0;
+        size_t m_freeArea;
+
+        std::vector<Node> m_nodes;
+        std::vector<std::uint32_t> m_freeChildBlocks; // first nodes of released quadrants
+    };
+
+} // namespace AT2
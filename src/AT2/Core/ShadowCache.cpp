@@ -0,0 +1,97 @@
+#include "ShadowCache.h"
+
+#include <algorithm>
+#include <array>
+
+using namespace AT2;
+
+namespace
+{
+    // Clip-space planes of the view-projection, normals look inside. They are not normalized, the test only needs signs.
+    std::array<glm::vec4, 6> GetFrustumPlanes(const glm::mat4& viewProjection) noexcept
+    {
+        const auto row = [&](int i) {
+            return glm::vec4 {viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+        };
+
+        return {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(3) + row(2), row(3) - row(2)};
+    }
+
+    // Conservative, boxes near the frustum corners may pass
+    bool Intersects(const std::array<glm::vec4, 6>& planes, const glm::vec3& boundsMin, const glm::vec3& boundsMax) noexcept
+    {
+        return std::ranges::all_of(planes, [&](const glm::vec4& plane) {
+            // the box corner farthest along the plane normal
+            const glm::vec3 corner {plane.x > 0.0f ? boundsMax.x : boundsMin.x, plane.y > 0.0f ? boundsMax.y : boundsMin.y,
+                                    plane.z > 0.0f ? boundsMax.z : boundsMin.z};
+            return glm::dot(glm::vec3 {plane}, corner) + plane.w >= 0.0f;
+        });
+    }
+} // namespace
+
+void ShadowCache::BeginFrame()
+{
+    std::erase_if(m_views, [frame = m_frame](const auto& view) { return view.second.Frame != frame; });
+    ++m_frame;
+
+    m_changedBounds.clear();
+    m_statistics = {};
+}
+
+void ShadowCache::UpdateCaster(CasterKey key, const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::uint64_t state)
+{
+    const Bounds bounds {boundsMin, boundsMax};
+
+    const auto [it, isNew] = m_casters.try_emplace(key);
+    auto& caster = it->second;
+
+    const bool isChanged = isNew || caster.WorldBounds != bounds || caster.State != state;
+    if (isChanged)
+    {
+        if (!isNew && caster.WorldBounds != bounds)
+            m_changedBounds.push_back(caster.WorldBounds);
+        m_changedBounds.push_back(bounds);
+        caster.WorldBounds = bounds;
+        caster.State = state;
+    }
+
+    m_statistics.NumCasters += caster.Frame != m_frame;
+    m_statistics.NumChangedCasters += isChanged;
+    caster.Frame = m_frame;
+}
+
+void ShadowCache::EndCasterUpdates()
+{
+    std::erase_if(m_casters, [this](const auto& caster) {
+        if (caster.second.Frame == m_frame)
+            return false;
+
+        m_changedBounds.push_back(caster.second.WorldBounds);
+        ++m_statistics.NumChangedCasters;
+        return true;
+    });
+}
+
+bool ShadowCache::UpdateView(ViewKey key, const glm::mat4& viewProjection)
+{
+    const auto [it, isNew] = m_views.try_emplace(key);
+    auto& view = it->second;
+
+    bool isStale = isNew || view.ViewProjection != viewProjection;
+    if (!isStale)
+    {
+        const auto planes = GetFrustumPlanes(viewProjection);
+        isStale = std::ranges::any_of(m_changedBounds, [&](const Bounds& bounds) { return Intersects(planes, bounds.Min, bounds.Max); });
+    }
+
+    m_statistics.NumViews += view.Frame != m_frame;
+    m_statistics.NumStaleViews += isStale;
+    view = {viewProjection, m_frame};
+
+    return isStale;
+}
+
+void ShadowCache::Clear()
+{
+    m_views.clear();
+}
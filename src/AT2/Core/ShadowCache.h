@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AT2.h"
+
+#include <unordered_map>
+
+namespace AT2
+{
+    // Tracks which shadow views have to be rendered again. Casters are tracked by their world-space bounds and a hash of their
+    // state, e.g. transforms: a caster which appeared, disappeared or changed any of them marks the old and the new bounds as
+    // changed for the frame. The state catches changes which keep the bounds, as of the unbounded casters. A view
+    // is stale when it's new, it's view-projection differs from the rendered one or a changed bounds intersects it's
+    // frustum, otherwise it's map may be reused.
+    // Every frame is BeginFrame, UpdateCaster for all of the casters, EndCasterUpdates, then UpdateView for the views. Views
+    // which were not updated by a frame missed it's changes, so they are forgotten and become stale again.
+    class ShadowCache
+    {
+    public:
+        using ViewKey = std::uint64_t;
+        using CasterKey = const void*;
+
+        struct Statistics
+        {
+            size_t NumCasters = 0;
+            size_t NumChangedCasters = 0;
+            size_t NumViews = 0;
+            size_t NumStaleViews = 0;
+        };
+
+    public:
+        void BeginFrame();
+
+        // Unbounded casters could pass the whole float range
+        void UpdateCaster(CasterKey key, const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::uint64_t state = 0);
+        // Casters which were not updated since BeginFrame are removed
+        void EndCasterUpdates();
+
+        // Returns true if the view must be rendered, the cache assumes it's rendered then
+        [[nodiscard]] bool UpdateView(ViewKey key, const glm::mat4& viewProjection);
+
+        // All of the views become stale, e.g. when their maps are lost
+        void Clear();
+
+        // Of the current frame
+        [[nodiscard]] const Statistics& GetStatistics() const noexcept { return m_statistics; }
+
+    private:
+        struct Bounds
+        {
+            glm::vec3 Min {0.0f}, Max {0.0f};
+
+            friend bool operator==(const Bounds&, const Bounds&) = default;
+        };
+
+        struct CasterState
+        {
+            Bounds WorldBounds;
+            std::uint64_t State = 0;
+            std::uint64_t Frame = 0;
+        };
+
+        struct ViewState
+        {
+            glm::mat4 ViewProjection {1.0f};
+            std::uint64_t Frame = 0;
+        };
+
+    private:
+        std::uint64_t m_frame = 0;
+        std::unordered_map<CasterKey, CasterState> m_casters;
+        std::unordered_map<ViewKey, ViewState> m_views;
+        std::vector<Bounds> m_changedBounds;
+
+        Statistics m_statistics;
+    };
+
+} // namespace AT2
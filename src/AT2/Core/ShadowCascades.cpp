@@ -0,0 +1,96 @@
+#include "ShadowCascades.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+using namespace AT2;
+
+std::vector<float> ShadowCascades::ComputeSplits(float near, float far, size_t numCascades, float lambda)
+{
+    if (!(near > 0.0f && far > near))
+        throw AT2Exception("ShadowCascades: depth range must be positive and not empty");
+    if (numCascades == 0)
+        throw AT2Exception("ShadowCascades: at least one cascade is needed");
+    if (!(lambda >= 0.0f && lambda <= 1.0f))
+        throw AT2Exception("ShadowCascades: split lambda must be in [0, 1]");
+
+    std::vector<float> splits(numCascades + 1);
+    for (size_t i = 0; i <= numCascades; ++i)
+    {
+        const float t = static_cast<float>(i) / static_cast<float>(numCascades);
+        const float logarithmic = near * std::pow(far / near, t);
+        const float uniform = near + (far - near) * t;
+        splits[i] = lambda * logarithmic + (1.0f - lambda) * uniform;
+    }
+
+    // exact ends, the interpolation may be off by the rounding
+    splits.front() = near;
+    splits.back() = far;
+
+    return splits;
+}
+
+void ShadowCascades::Update(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& lightDirection,
+                            const Parameters& parameters)
+{
+    if (projection[2][3] == 0.0f)
+        throw AT2Exception("ShadowCascades: camera projection must be perspective");
+    if (parameters.NumCascades == 0 || parameters.NumCascades > MaxCascades)
+        throw AT2Exception("ShadowCascades: unsupported number of cascades");
+    if (parameters.Resolution == 0)
+        throw AT2Exception("ShadowCascades: resolution must be positive");
+
+    // depth range of the projection, far is infinite for the infinite projection
+    const float near = projection[3][2] / (projection[2][2] - 1.0f);
+    const float far = projection[2][2] != -1.0f ? projection[3][2] / (projection[2][2] + 1.0f) : std::numeric_limits<float>::infinity();
+
+    const auto splits = ComputeSplits(near, std::min(far, parameters.ShadowDistance), parameters.NumCascades, parameters.SplitLambda);
+
+    // view-space frustum corners at the unit depth, corners of a slice are them scaled by the slice depths
+    const auto projectionInverse = glm::inverse(projection);
+    std::array<glm::vec3, 4> unitCorners;
+    for (size_t i = 0; i < unitCorners.size(); ++i)
+    {
+        const auto corner = projectionInverse * glm::vec4 {i % 2 ? 1.0f : -1.0f, i / 2 ? 1.0f : -1.0f, -1.0f, 1.0f};
+        unitCorners[i] = glm::vec3 {corner} / (-corner.z);
+    }
+
+    // rotation of the light views, the z axis looks towards the light
+    const auto forward = -glm::normalize(lightDirection);
+    const auto up = std::abs(forward.y) < 0.99f ? glm::vec3 {0.0f, 1.0f, 0.0f} : glm::vec3 {1.0f, 0.0f, 0.0f};
+    const auto lightRotation = glm::lookAt(glm::vec3 {0.0f}, forward, up);
+    const auto viewInverse = glm::inverse(view);
+
+    m_cascades.resize(parameters.NumCascades);
+    for (size_t i = 0; i < m_cascades.size(); ++i)
+    {
+        // the bounding sphere is computed in view space, so it's radius doesn't depend on the camera transform
+        glm::vec3 center {0.0f};
+        for (const auto depth : {splits[i], splits[i + 1]})
+            for (const auto& corner : unitCorners)
+                center += corner * depth;
+        center /= 8.0f;
+
+        float radius = 0.0f;
+        for (const auto depth : {splits[i], splits[i + 1]})
+            for (const auto& corner : unitCorners)
+                radius = std::max(radius, glm::length(corner * depth - center));
+
+        const float texelSize = 2.0f * radius / static_cast<float>(parameters.Resolution);
+
+        // depth is snapped too, so the view is the same while the camera moves within a texel
+        auto lightCenter = glm::vec3 {lightRotation * viewInverse * glm::vec4 {center, 1.0f}};
+        lightCenter = glm::floor(lightCenter / texelSize) * texelSize;
+
+        // the sphere could be up to a texel closer to the light than the snapped center
+        const float backDistance = radius + texelSize + parameters.CasterDistance;
+
+        auto& cascade = m_cascades[i];
+        cascade.View = glm::translate(glm::mat4 {1.0f}, -(lightCenter + glm::vec3 {0.0f, 0.0f, backDistance})) * lightRotation;
+        cascade.Projection = glm::ortho(-radius, radius, -radius, radius, 0.0f, backDistance + radius);
+        cascade.FarDepth = splits[i + 1];
+        cascade.TexelSize = texelSize;
+    }
+}
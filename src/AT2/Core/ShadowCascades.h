@@ -0,0 +1,48 @@
+#pragma once
+
+#include "AT2.h"
+
+namespace AT2
+{
+    // Cascaded shadow maps of a directional light. The view depth range up to the shadow distance is split to cascades,
+    // every cascade is an orthographic light view around the bounding sphere of it's slice of the camera frustum. The
+    // sphere doesn't change with the camera rotation and it's center is snapped to texels of the shadow map, so static
+    // shadows don't flicker and the view of the cascade only changes when the camera moves by a texel.
+    class ShadowCascades
+    {
+    public:
+        static constexpr size_t MaxCascades = 4;
+        static constexpr float DefaultSplitLambda = 0.75f;
+
+        struct Cascade
+        {
+            glm::mat4 View {1.0f};
+            glm::mat4 Projection {1.0f};
+            float FarDepth = 0.0f;  // view depth of the slice end
+            float TexelSize = 0.0f; // world-space size of a shadow map texel
+        };
+
+        struct Parameters
+        {
+            size_t NumCascades = MaxCascades;
+            float ShadowDistance = 1000.0f; // view depth shadows end at, the far plane of the camera also limits it
+            float SplitLambda = DefaultSplitLambda;
+            float CasterDistance = 1000.0f; // distance before the slice casters are taken from, towards the light
+            unsigned int Resolution = 1024; // of the shadow map of every cascade
+        };
+
+    public:
+        // Split depths blending the uniform (lambda is 0) and logarithmic (lambda is 1) distributions, the first one is near
+        // and the last one is far
+        [[nodiscard]] static std::vector<float> ComputeSplits(float near, float far, size_t numCascades, float lambda);
+
+        // Direction is from the scene towards the light, the camera projection must be perspective
+        void Update(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& lightDirection, const Parameters& parameters);
+
+        [[nodiscard]] std::span<const Cascade> GetCascades() const noexcept { return m_cascades; }
+
+    private:
+        std::vector<Cascade> m_cascades;
+    };
+
+} // namespace AT2
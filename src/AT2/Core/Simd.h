@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AT2_SIMD_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AT2_SIMD_NEON
+#endif
+
+// Minimal set of 4-wide float operations for the CPU culling code, SSE2 or NEON when they are available and a scalar
+// fallback otherwise. Comparisons return lane masks, ToBits packs them to the low bits of an integer.
+namespace AT2::Simd
+{
+#if defined(AT2_SIMD_SSE2)
+    using Float4 = __m128;
+    using Mask4 = __m128;
+
+    inline Float4 Load(const float* data) noexcept { return _mm_loadu_ps(data); }
+    inline void Store(float* data, Float4 value) noexcept { _mm_storeu_ps(data, value); }
+    inline Float4 Splat(float value) noexcept { return _mm_set1_ps(value); }
+    inline Float4 Set(float x, float y, float z, float w) noexcept { return _mm_setr_ps(x, y, z, w); }
+
+    inline Float4 Add(Float4 a, Float4 b) noexcept { return _mm_add_ps(a, b); }
+    inline Float4 Sub(Float4 a, Float4 b) noexcept { return _mm_sub_ps(a, b); }
+    inline Float4 Mul(Float4 a, Float4 b) noexcept { return _mm_mul_ps(a, b); }
+    inline Float4 Min(Float4 a, Float4 b) noexcept { return _mm_min_ps(a, b); }
+    inline Float4 Max(Float4 a, Float4 b) noexcept { return _mm_max_ps(a, b); }
+    inline Float4 Sqrt(Float4 a) noexcept { return _mm_sqrt_ps(a); }
+
+    inline Mask4 Less(Float4 a, Float4 b) noexcept { return _mm_cmplt_ps(a, b); }
+    inline Mask4 GreaterEqual(Float4 a, Float4 b) noexcept { return _mm_cmpge_ps(a, b); }
+    inline Mask4 And(Mask4 a, Mask4 b) noexcept { return _mm_and_ps(a, b); }
+    // Lanes of a where the mask is set, lanes of b otherwise
+    inline Float4 Select(Mask4 mask, Float4 a, Float4 b) noexcept { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    inline unsigned int ToBits(Mask4 mask) noexcept { return static_cast<unsigned int>(_mm_movemask_ps(mask)); }
+#elif defined(AT2_SIMD_NEON)
+    using Float4 = float32x4_t;
+    using Mask4 = uint32x4_t;
+
+    inline Float4 Load(const float* data) noexcept { return vld1q_f32(data); }
+    inline void Store(float* data, Float4 value) noexcept { vst1q_f32(data, value); }
+    inline Float4 Splat(float value) noexcept { return vdupq_n_f32(value); }
+    inline Float4 Set(float x, float y, float z, float w) noexcept { return float32x4_t {x, y, z, w}; }
+
+    inline Float4 Add(Float4 a, Float4 b) noexcept { return vaddq_f32(a, b); }
+    inline Float4 Sub(Float4 a, Float4 b) noexcept { return vsubq_f32(a, b); }
+    inline Float4 Mul(Float4 a, Float4 b) noexcept { return vmulq_f32(a, b); }
+    inline Float4 Min(Float4 a, Float4 b) noexcept { return vminq_f32(a, b); }
+    inline Float4 Max(Float4 a, Float4 b) noexcept { return vmaxq_f32(a, b); }
+    inline Float4 Sqrt(Float4 a) noexcept { return vsqrtq_f32(a); }
+
+    inline Mask4 Less(Float4 a, Float4 b) noexcept { return vcltq_f32(a, b); }
+    inline Mask4 GreaterEqual(Float4 a, Float4 b) noexcept { return vcgeq_f32(a, b); }
+    inline Mask4 And(Mask4 a, Mask4 b) noexcept { return vandq_u32(a, b); }
+    inline Float4 Select(Mask4 mask, Float4 a, Float4 b) noexcept { return vbslq_f32(mask, a, b); }
+    inline unsigned int ToBits(Mask4 mask) noexcept
+    {
+        const uint32x4_t bits = {1, 2, 4, 8};
+        return vaddvq_u32(vandq_u32(mask, bits));
+    }
+#else
+    using Float4 = std::array<float, 4>;
+    using Mask4 = std::array<bool, 4>;
+
+    template <typename T, typename Func>
+    T PerLane(Func&& func)
+    {
+        T result;
+        for (size_t i = 0; i < result.size(); ++i)
+            result[i] = func(i);
+        return result;
+    }
+
+    inline Float4 Load(const float* data) noexcept { return {data[0], data[1], data[2], data[3]}; }
+    inline void Store(float* data, Float4 value) noexcept { std::copy(value.begin(), value.end(), data); }
+    inline Float4 Splat(float value) noexcept { return {value, value, value, value}; }
+    inline Float4 Set(float x, float y, float z, float w) noexcept { return {x, y, z, w}; }
+
+    inline Float4 Add(Float4 a, Float4 b) noexcept { return PerLane<Float4>([&](size_t i) { return a[i] + b[i]; }); }
+    inline Float4 Sub(Float4 a, Float4 b) noexcept { return PerLane<Float4>([&](size_t i) { return a[i] - b[i]; }); }
+    inline Float4 Mul(Float4 a, Float4 b) noexcept { return PerLane<Float4>([&](size_t i) { return a[i] * b[i]; }); }
+    inline Float4 Min(Float4 a, Float4 b) noexcept { return PerLane<Float4>([&](size_t i) { return b[i] < a[i] ? b[i] : a[i]; }); }
+    inline Float4 Max(Float4 a, Float4 b) noexcept { return PerLane<Float4>([&](size_t i) { return a[i] < b[i] ? b[i] : a[i]; }); }
+    inline Float4 Sqrt(Float4 a) noexcept { return PerLane<Float4>([&](size_t i) { return std::sqrt(a[i]); }); }
+
+    inline Mask4 Less(Float4 a, Float4 b) noexcept { return PerLane<Mask4>([&](size_t i) { return a[i] < b[i]; }); }
+    inline Mask4 GreaterEqual(Float4 a, Float4 b) noexcept { return PerLane<Mask4>([&](size_t i) { return a[i] >= b[i]; }); }
+    inline Mask4 And(Mask4 a, Mask4 b) noexcept { return PerLane<Mask4>([&](size_t i) { return a[i] && b[i]; }); }
+    inline Float4 Select(Mask4 mask, Float4 a, Float4 b) noexcept { return PerLane<Float4>([&](size_t i) { return mask[i] ? a[i] : b[i]; }); }
+    inline unsigned int ToBits(Mask4 mask) noexcept
+    {
+        unsigned int bits = 0;
+        for (size_t i = 0; i < mask.size(); ++i)
+            bits |= mask[i] ? 1u << i : 0u;
+        return bits;
+    }
+#endif
+
+} // namespace AT2::Simd
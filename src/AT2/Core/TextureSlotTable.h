@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <AT2_exceptions.hpp>
+
+namespace AT2
+{
+    // Fixed-size mapping between textures and texture units.
+    // All storage is allocated at construction, so binding never allocates.
+    // Pinned keys keep their slot until unpinned, the rest are evicted in least-recently-used order.
+    // Slot changes are accumulated and flushed by contiguous ranges to allow batched binding.
+    template <typename Key, typename Handle = unsigned int>
+    class TextureSlotTable
+    {
+    public:
+        using SlotIndex = unsigned int;
+
+        struct AcquireResult
+        {
+            SlotIndex Slot;
+            bool IsNew;
+        };
+
+        struct Statistics
+        {
+            size_t Hits = 0;
+            size_t Misses = 0;
+            size_t Evictions = 0;
+        };
+
+        explicit TextureSlotTable(size_t numSlots) :
+            m_keys(numSlots), m_handles(numSlots), m_states(numSlots)
+        {
+        }
+
+        [[nodiscard]] std::optional<SlotIndex> Find(const Key& key) const noexcept
+        {
+            for (SlotIndex i = 0; i < m_keys.size(); ++i)
+                if (m_states[i].Occupied && m_keys[i] == key)
+                    return i;
+
+            return std::nullopt;
+        }
+
+        // Returns slot of the key, assigns a new one if key is not present.
+        // handleFactory is called only for the new assignments
+        template <typename HandleFactory>
+        AcquireResult Acquire(const Key& key, HandleFactory&& handleFactory)
+        {
+            if (const auto slot = Find(key))
+            {
+                ++m_statistics.Hits;
+                m_states[*slot].LastUse = ++m_useCounter;
+                return {*slot, false};
+            }
+
+            ++m_statistics.Misses;
+
+            const auto slot = ChooseSlot();
+            m_keys[slot] = key;
+            m_handles[slot] = std::forward<HandleFactory>(handleFactory)(key);
+            m_states[slot] = {++m_useCounter, true, false, true};
+            m_hasDirtySlots = true;
+
+            return {slot, true};
+        }
+
+        // Pinned key is never evicted, so it has stable slot for all the time
+        template <typename HandleFactory>
+        SlotIndex Pin(const Key& key, HandleFactory&& handleFactory)
+        {
+            const auto [slot, isNew] = Acquire(key, std::forward<HandleFactory>(handleFactory));
+            m_states[slot].Pinned = true;
+            return slot;
+        }
+
+        bool Unpin(const Key& key) noexcept
+        {
+            if (const auto slot = Find(key))
+            {
+                m_states[*slot].Pinned = false;
+                return true;
+            }
+
+            return false;
+        }
+
+        [[nodiscard]] bool IsPinned(const Key& key) const noexcept
+        {
+            const auto slot = Find(key);
+            return slot && m_states[*slot].Pinned;
+        }
+
+        // Calls bindRange(firstSlot, std::span<const Handle>) for every contiguous range of changed slots
+        template <typename BindRangeFunc>
+        void FlushDirty(BindRangeFunc&& bindRange)
+        {
+            if (!m_hasDirtySlots)
+                return;
+
+            const auto numSlots = static_cast<SlotIndex>(m_keys.size());
+            for (SlotIndex first = 0; first < numSlots; ++first)
+            {
+                if (!m_states[first].Dirty)
+                    continue;
+
+                SlotIndex last = first;
+                for (; last < numSlots && m_states[last].Dirty; ++last)
+                    m_states[last].Dirty = false;
+
+                bindRange(first, std::span<const Handle> {m_handles.data() + first, last - first});
+                first = last;
+            }
+
+            m_hasDirtySlots = false;
+        }
+
+        [[nodiscard]] const Statistics& GetStatistics() const noexcept { return m_statistics; }
+        void ResetStatistics() noexcept { m_statistics = {}; }
+
+        [[nodiscard]] size_t capacity() const noexcept { return m_keys.size(); }
+
+    private:
+        struct SlotState
+        {
+            std::uint64_t LastUse = 0;
+            bool Occupied = false;
+            bool Pinned = false;
+            bool Dirty = false;
+        };
+
+        SlotIndex ChooseSlot()
+        {
+            std::optional<SlotIndex> leastRecentlyUsed;
+            for (SlotIndex i = 0; i < m_keys.size(); ++i)
+            {
+                if (!m_states[i].Occupied)
+                    return i;
+
+                if (!m_states[i].Pinned && (!leastRecentlyUsed || m_states[i].LastUse < m_states[*leastRecentlyUsed].LastUse))
+                    leastRecentlyUsed = i;
+            }
+
+            if (!leastRecentlyUsed)
+                throw AT2Exception("TextureSlotTable: all slots are pinned");
+
+            ++m_statistics.Evictions;
+            return *leastRecentlyUsed;
+        }
+
+    private:
+        std::vector<Key> m_keys;
+        std::vector<Handle> m_handles;
+        std::vector<SlotState> m_states;
+
+        std::uint64_t m_useCounter = 0;
+        bool m_hasDirtySlots = false;
+        Statistics m_statistics;
+    };
+
+} // namespace AT2
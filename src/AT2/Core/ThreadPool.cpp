@@ -0,0 +1,63 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace AT2;
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    assert(numThreads > 0);
+
+    m_workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock lock {m_mutex};
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+size_t ThreadPool::GetDefaultNumThreads() noexcept
+{
+    return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::scoped_lock lock {m_mutex};
+        assert(!m_stopping);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock {m_mutex};
+            m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+
+            // remaining tasks are finished even when stopping
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace AT2
+{
+    // Fixed set of worker threads executing tasks in submission order.
+    // Destructor waits until all submitted tasks are finished.
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t numThreads = GetDefaultNumThreads());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Exceptions thrown by the task are passed through the future
+        template <typename Func>
+        std::future<std::invoke_result_t<std::decay_t<Func>>> Submit(Func&& func)
+        {
+            using Result = std::invoke_result_t<std::decay_t<Func>>;
+
+            // std::function needs copyable callable
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+            auto future = task->get_future();
+            Enqueue([task = std::move(task)] { (*task)(); });
+
+            return future;
+        }
+
+        // Splits [0, count) into ranges of at least grainSize elements and calls func(begin, end) for them, returns when all
+        // of them are done. The calling thread takes ranges too, and it doesn't wait for the helper tasks queued behind other
+        // work: ranges not taken by the time the caller runs out of them are its own. So the call never waits for unrelated
+        // tasks of the pool, and it may be called from the pool's tasks.
+        template <typename Func>
+        void ParallelFor(size_t count, size_t grainSize, const Func& func)
+        {
+            if (count == 0)
+                return;
+
+            const size_t numChunks = std::clamp<size_t>(count / std::max<size_t>(grainSize, 1), 1, (GetNumThreads() + 1) * 4);
+            if (numChunks == 1)
+            {
+                func(0, count);
+                return;
+            }
+
+            // helpers could start after the call returned, so they share the state, and func is touched only by a taken chunk
+            struct State
+            {
+                std::atomic<size_t> NextChunk {0};
+                std::atomic<size_t> NumFinished {0};
+
+                std::mutex ExceptionMutex;
+                std::exception_ptr Exception;
+            };
+
+            const auto state = std::make_shared<State>();
+            const auto runChunks = [state, numChunks, count, &func] {
+                for (size_t i = state->NextChunk++; i < numChunks; i = state->NextChunk++)
+                {
+                    try
+                    {
+                        func(count * i / numChunks, count * (i + 1) / numChunks);
+                    }
+                    catch (...)
+                    {
+                        std::scoped_lock lock {state->ExceptionMutex};
+                        if (!state->Exception)
+                            state->Exception = std::current_exception();
+                    }
+
+                    if (++state->NumFinished == numChunks)
+                        state->NumFinished.notify_all();
+                }
+            };
+
+            const auto numHelpers = std::min(numChunks - 1, GetNumThreads());
+            for (size_t i = 0; i < numHelpers; ++i)
+                Enqueue(runChunks);
+
+            runChunks();
+
+            // only the chunks being run by the helpers are left
+            for (auto numFinished = state->NumFinished.load(); numFinished != numChunks; numFinished = state->NumFinished.load())
+                state->NumFinished.wait(numFinished);
+
+            if (state->Exception)
+                std::rethrow_exception(state->Exception);
+        }
+
+        [[nodiscard]] size_t GetNumThreads() const noexcept { return m_workers.size(); }
+
+        // One thread is left for the render thread
+        [[nodiscard]] static size_t GetDefaultNumThreads() noexcept;
+
+    private:
+        void Enqueue(std::function<void()> task);
+        void WorkerLoop();
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_stopping = false;
+
+        std::vector<std::thread> m_workers;
+    };
+
+} // namespace AT2
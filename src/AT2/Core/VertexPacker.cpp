@@ -0,0 +1,262 @@
+#include "VertexPacker.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+#include <glm/gtx/component_wise.hpp>
+
+using namespace AT2;
+
+namespace
+{
+    // keeps every attribute aligned for the vertex fetch
+    constexpr unsigned int AttributeAlignment = 4;
+
+    template <typename T>
+    T Read(const std::byte* data)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void Write(std::byte* data, const T& value)
+    {
+        std::memcpy(data, &value, sizeof(T));
+    }
+
+    float ReadComponent(BufferDataType type, bool isNormalized, const std::byte* data)
+    {
+        // signed values are clamped, because both -128 and -127 are mapped to -1
+        switch (type)
+        {
+        case BufferDataType::Byte:
+        {
+            const float value = Read<std::int8_t>(data);
+            return isNormalized ? std::max(value / 127.0f, -1.0f) : value;
+        }
+        case BufferDataType::UByte:
+        {
+            const float value = Read<std::uint8_t>(data);
+            return isNormalized ? value / 255.0f : value;
+        }
+        case BufferDataType::Short:
+        {
+            const float value = Read<std::int16_t>(data);
+            return isNormalized ? std::max(value / 32767.0f, -1.0f) : value;
+        }
+        case BufferDataType::UShort:
+        {
+            const float value = Read<std::uint16_t>(data);
+            return isNormalized ? value / 65535.0f : value;
+        }
+        case BufferDataType::Int:
+        {
+            const double value = Read<std::int32_t>(data);
+            return static_cast<float>(isNormalized ? std::max(value / 2147483647.0, -1.0) : value);
+        }
+        case BufferDataType::UInt:
+        {
+            const double value = Read<std::uint32_t>(data);
+            return static_cast<float>(isNormalized ? value / 4294967295.0 : value);
+        }
+        case BufferDataType::HalfFloat: return glm::unpackHalf1x16(Read<std::uint16_t>(data));
+        case BufferDataType::Float: return Read<float>(data);
+        case BufferDataType::Double: return static_cast<float>(Read<double>(data));
+        default: throw AT2Exception("VertexPacker: unsupported attribute type");
+        }
+    }
+
+    unsigned int GetElementSize(const BufferBindingParams& bindingParams)
+    {
+        if (bindingParams.Type == BufferDataType::Int2101010Rev)
+            return 4;
+
+        return static_cast<unsigned int>(BufferDataTypes::GetSizeOf(bindingParams.Type)) * bindingParams.Count;
+    }
+
+    unsigned int AlignUp(unsigned int value, unsigned int alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    using Semantic = VertexPacker::Semantic;
+
+    bool AreTexCoordsNormalized(const VertexPacker::Attribute& attribute)
+    {
+        for (size_t offset = 0; offset < attribute.Data.size(); offset += attribute.BindingParams.Stride)
+        {
+            const auto texCoord = glm::xy(VertexPacker::ReadElement(attribute.BindingParams, attribute.Data.data() + offset));
+            if (glm::any(glm::lessThan(texCoord, glm::vec2 {0.0f})) || glm::any(glm::greaterThan(texCoord, glm::vec2 {1.0f})))
+                return false;
+        }
+
+        return true;
+    }
+
+    float GetMaxComponent(const VertexPacker::Attribute& attribute)
+    {
+        float result = 0.0f;
+        for (size_t offset = 0; offset < attribute.Data.size(); offset += attribute.BindingParams.Stride)
+            result = std::max(result, glm::compMax(VertexPacker::ReadElement(attribute.BindingParams, attribute.Data.data() + offset)));
+
+        return result;
+    }
+
+    // Stride and Offset are set later
+    BufferBindingParams ChoosePackedFormat(const VertexPacker::Attribute& attribute)
+    {
+        const auto& source = attribute.BindingParams;
+        const auto packed = [&]() -> BufferBindingParams {
+            switch (attribute.Meaning)
+            {
+            case Semantic::Normal:
+            case Semantic::Tangent:
+                if (source.Count < 3)
+                    throw AT2Exception("VertexPacker: normals and tangents must have at least 3 components");
+                return {BufferDataType::Int2101010Rev, 4, 0, 0, true};
+
+            case Semantic::TexCoord:
+                if (source.Count < 2)
+                    throw AT2Exception("VertexPacker: texture coordinates must have at least 2 components");
+                return AreTexCoordsNormalized(attribute) ? BufferBindingParams {BufferDataType::UShort, 2, 0, 0, true}
+                                                         : BufferBindingParams {BufferDataType::HalfFloat, 2, 0, 0, false};
+
+            case Semantic::Weights:
+                if (source.Count != 4)
+                    throw AT2Exception("VertexPacker: joint weights must have 4 components");
+                return {BufferDataType::UByte, 4, 0, 0, true};
+
+            case Semantic::Joints:
+                if (source.Count != 4 || source.IsNormalized)
+                    throw AT2Exception("VertexPacker: joint indices must be 4 integers");
+                return {GetMaxComponent(attribute) < 256.0f ? BufferDataType::UByte : BufferDataType::UShort, 4, 0, 0, false};
+
+            default: return {source.Type, source.Count, 0, 0, source.IsNormalized};
+            }
+        }();
+
+        // already compact enough
+        if (attribute.Meaning != Semantic::Position && attribute.Meaning != Semantic::Other && GetElementSize(source) <= GetElementSize(packed))
+            return {source.Type, source.Count, 0, 0, source.IsNormalized};
+
+        return packed;
+    }
+
+    void PackElement(const VertexPacker::Attribute& attribute, const BufferBindingParams& packed, const std::byte* source, std::byte* destination)
+    {
+        const bool isConverted = packed.Type != attribute.BindingParams.Type || packed.Count != attribute.BindingParams.Count;
+        if (!isConverted)
+        {
+            std::memcpy(destination, source, GetElementSize(packed));
+            return;
+        }
+
+        const auto value = VertexPacker::ReadElement(attribute.BindingParams, source);
+        switch (attribute.Meaning)
+        {
+        case Semantic::Normal:
+        case Semantic::Tangent:
+        {
+            const auto direction = glm::xyz(value);
+            const float length = glm::length(direction);
+            // handedness of tangent frame
+            const float w = attribute.Meaning == Semantic::Tangent && attribute.BindingParams.Count == 4 && value.w < 0.0f ? -1.0f : 1.0f;
+            Write(destination, glm::packSnorm3x10_1x2({length > 0.0f ? direction / length : direction, w}));
+            break;
+        }
+
+        case Semantic::TexCoord:
+            Write(destination, packed.Type == BufferDataType::UShort ? glm::packUnorm2x16(glm::xy(value)) : glm::packHalf2x16(glm::xy(value)));
+            break;
+
+        case Semantic::Weights:
+        {
+            auto weights = glm::ivec4 {glm::round(glm::clamp(value, 0.0f, 1.0f) * 255.0f)};
+
+            // rounding errors are moved to the most significant weight
+            if (const int sum = weights.x + weights.y + weights.z + weights.w; sum > 0)
+            {
+                glm::length_t largest = 0;
+                for (glm::length_t i = 1; i < 4; ++i)
+                    if (weights[i] > weights[largest])
+                        largest = i;
+
+                weights[largest] = std::clamp(weights[largest] + 255 - sum, 0, 255);
+            }
+
+            Write(destination, glm::u8vec4 {weights});
+            break;
+        }
+
+        case Semantic::Joints:
+            if (packed.Type == BufferDataType::UByte)
+                Write(destination, glm::u8vec4 {value});
+            else
+                Write(destination, glm::u16vec4 {value});
+            break;
+
+        default: throw AT2Exception("VertexPacker: unexpected conversion");
+        }
+    }
+} // namespace
+
+VertexPacker::PackedVertices VertexPacker::Pack(std::span<const Attribute> attributes)
+{
+    if (attributes.empty())
+        throw AT2Exception("VertexPacker: at least one attribute required");
+
+    PackedVertices result;
+
+    const auto& firstBinding = attributes.front().BindingParams;
+    result.NumVertices = firstBinding.Stride > 0 ? attributes.front().Data.size() / firstBinding.Stride : 0;
+    for (const auto& attribute : attributes)
+    {
+        const auto& bindingParams = attribute.BindingParams;
+        if (bindingParams.Stride == 0 || bindingParams.Stride != GetElementSize(bindingParams) ||
+            attribute.Data.size() != result.NumVertices * bindingParams.Stride)
+            throw AT2Exception("VertexPacker: all attributes must have the same number of tightly packed elements");
+
+        auto packed = ChoosePackedFormat(attribute);
+        packed.Offset = result.Stride;
+        result.Stride += AlignUp(GetElementSize(packed), AttributeAlignment);
+        result.Attributes.push_back({attribute.AttributeIndex, packed});
+    }
+
+    for (auto& [attributeIndex, bindingParams] : result.Attributes)
+        bindingParams.Stride = result.Stride;
+
+    result.Data.resize(result.NumVertices * result.Stride);
+    for (size_t i = 0; i < attributes.size(); ++i)
+    {
+        const auto& attribute = attributes[i];
+        const auto& packed = result.Attributes[i].BindingParams;
+
+        for (size_t vertex = 0; vertex < result.NumVertices; ++vertex)
+            PackElement(attribute, packed, attribute.Data.data() + vertex * attribute.BindingParams.Stride,
+                        result.Data.data() + vertex * result.Stride + packed.Offset);
+    }
+
+    return result;
+}
+
+glm::vec4 VertexPacker::ReadElement(const BufferBindingParams& bindingParams, const std::byte* element)
+{
+    if (bindingParams.Type == BufferDataType::Int2101010Rev)
+    {
+        if (!bindingParams.IsNormalized)
+            throw AT2Exception("VertexPacker: packed 10-10-10-2 must be normalized");
+
+        return glm::unpackSnorm3x10_1x2(Read<glm::uint32>(element));
+    }
+
+    const auto componentSize = BufferDataTypes::GetSizeOf(bindingParams.Type);
+
+    glm::vec4 result {0.0f};
+    for (glm::length_t i = 0; i < std::min<glm::length_t>(bindingParams.Count, 4); ++i)
+        result[i] = ReadComponent(bindingParams.Type, bindingParams.IsNormalized, element + i * componentSize);
+
+    return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "AT2.h"
+
+namespace AT2
+{
+    // Converts vertex attributes into compact formats and interleaves them into one stream. Quantization depends on the
+    // attribute meaning:
+    //  normals and tangents - signed normalized 10-10-10-2, tangent handedness is kept at w;
+    //  texture coordinates - unsigned normalized 16-bit when they are within [0, 1], half floats otherwise;
+    //  joint weights - unsigned normalized 8-bit, rounded so they still sum to one;
+    //  joint indices - 8-bit integers when all of them are less than 256, 16-bit otherwise.
+    // Positions and other attributes are copied as is. Sources are read according to their BufferBindingParams, so they
+    // could be floats, half floats or (normalized) integers.
+    class VertexPacker
+    {
+    public:
+        enum class Semantic
+        {
+            Position,
+            Normal,
+            Tangent,
+            TexCoord,
+            Joints,
+            Weights,
+            Other
+        };
+
+        struct Attribute
+        {
+            unsigned int AttributeIndex;
+            Semantic Meaning;
+            // Stride must be equal to the element size, Offset is ignored
+            BufferBindingParams BindingParams;
+            std::span<const std::byte> Data;
+        };
+
+        struct PackedAttribute
+        {
+            unsigned int AttributeIndex;
+            // Offset is relative to the vertex start, Stride is the vertex size
+            BufferBindingParams BindingParams;
+        };
+
+        struct PackedVertices
+        {
+            std::vector<PackedAttribute> Attributes;
+            unsigned int Stride = 0;
+            size_t NumVertices = 0;
+            std::vector<std::byte> Data;
+        };
+
+        // Throws AT2Exception when attributes have different number of vertices or unsupported format
+        [[nodiscard]] static PackedVertices Pack(std::span<const Attribute> attributes);
+
+        // Reads element as float vector, integers are normalized if bindingParams says so. Missing components are zero
+        [[nodiscard]] static glm::vec4 ReadElement(const BufferBindingParams& bindingParams, const std::byte* element);
+    };
+
+} // namespace AT2
@@ -1,64 +1,253 @@
 #pragma once
 
-#include <unordered_map>
-#include <list>
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
 
-template <typename Key, typename Value>
+// Fixed-capacity LRU cache.
+// Entries live in a preallocated array and are linked by indices, lookup uses open-addressing index with linear probing,
+// so there are no allocations after construction.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
 class lru_cache
 {
+private:
+    using index_type = std::uint32_t;
+    static constexpr index_type npos = std::numeric_limits<index_type>::max();
+
+    static constexpr bool is_transparent = requires {
+        typename Hash::is_transparent;
+        typename KeyEqual::is_transparent;
+    };
+
 public:
     using key_type = Key;
+    using mapped_type = Value;
     using value_type = std::pair<key_type, Value>;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
 
-    explicit lru_cache(size_t capacity) : m_index {capacity * 2}, m_capacity {capacity} {}
+    explicit lru_cache(size_t capacity, const Hash& hash = {}, const KeyEqual& equal = {}) :
+        m_nodes {std::make_unique<Node[]>(capacity)},
+        m_index {std::make_unique<index_type[]>(std::bit_ceil(capacity * 2))},
+        m_indexMask {std::bit_ceil(capacity * 2) - 1},
+        m_indexShift {64 - static_cast<int>(std::bit_width(m_indexMask))},
+        m_capacity {capacity},
+        m_hash {hash},
+        m_equal {equal}
+    {
+        assert(capacity > 0 && capacity < npos);
 
-	//TODO: add heterogenous lookup, emplace, etc
-    //TODO: make allocator friendly
+        std::fill_n(m_index.get(), m_indexMask + 1, npos);
+        for (index_type i = 0; i < m_capacity; ++i)
+            m_nodes[i].Next = (i + 1 < m_capacity) ? i + 1 : npos;
+    }
 
+    // Returns existing entry and makes it most recently used, otherwise creates value with valueFactory(key).
+    // When cache is full, the least recently used entry is passed to valueDroppedCallback before it's replacement
     template <typename ValueFactoryFunc, typename ValueDroppedFunc>
-	std::add_lvalue_reference_t<value_type> put(const key_type& key, ValueFactoryFunc&& valueFactory, ValueDroppedFunc&& valueDroppedCallback)
-	{
-    	const auto [iterator, isNew] = m_index.emplace(key, ListIterator{});
-        if (isNew)
+    value_type& put(const key_type& key, ValueFactoryFunc&& valueFactory, ValueDroppedFunc&& valueDroppedCallback)
+    {
+        return put_impl(key, std::forward<ValueFactoryFunc>(valueFactory), std::forward<ValueDroppedFunc>(valueDroppedCallback));
+    }
+
+    template <typename K, typename ValueFactoryFunc, typename ValueDroppedFunc> requires is_transparent
+    value_type& put(const K& key, ValueFactoryFunc&& valueFactory, ValueDroppedFunc&& valueDroppedCallback)
+    {
+        return put_impl(key, std::forward<ValueFactoryFunc>(valueFactory), std::forward<ValueDroppedFunc>(valueDroppedCallback));
+    }
+
+    // Constructs value in place from args if key isn't present, dropped entry (if any) is just destroyed
+    template <typename... Args>
+    std::pair<value_type&, bool> try_emplace(const key_type& key, Args&&... args)
+    {
+        return try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename K, typename... Args> requires is_transparent
+    std::pair<value_type&, bool> try_emplace(const K& key, Args&&... args)
+    {
+        return try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] std::optional<const std::reference_wrapper<Value>> find(const key_type& key) const noexcept { return find_impl(key); }
+
+    template <typename K> requires is_transparent
+    [[nodiscard]] std::optional<const std::reference_wrapper<Value>> find(const K& key) const noexcept { return find_impl(key); }
+
+    [[nodiscard]] bool exists(const key_type& key) const noexcept { return lookup(key, m_hash(key)).second; }
+
+    template <typename K> requires is_transparent
+    [[nodiscard]] bool exists(const K& key) const noexcept { return lookup(key, m_hash(key)).second; }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+    [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+
+private:
+    struct Node
+    {
+        std::optional<value_type> Data;
+        size_t HashValue = 0;
+        index_type Prev = npos;
+        index_type Next = npos;
+    };
+
+    // Fibonacci hashing spreads poor hashes (e.g. aligned pointers) over the whole index
+    [[nodiscard]] size_t desired_position(size_t hash) const noexcept
+    {
+        return static_cast<size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> m_indexShift) & m_indexMask;
+    }
+
+    // Returns position of the key in index if found, or position of the empty cell otherwise
+    template <typename K>
+    std::pair<size_t, bool> lookup(const K& key, size_t hash) const noexcept
+    {
+        for (size_t position = desired_position(hash);; position = (position + 1) & m_indexMask)
         {
-            assert(m_cache.size() <= m_capacity);
-            if (m_cache.size() == m_capacity)
-            {
-                std::forward<ValueDroppedFunc>(valueDroppedCallback)(std::move(m_cache.back()));
+            const auto nodeIndex = m_index[position];
+            if (nodeIndex == npos)
+                return {position, false};
 
-                m_index.erase(m_cache.back().first);
-                m_cache.pop_back(); //TODO: could be just rewritten instead of reallocation
+            const auto& node = m_nodes[nodeIndex];
+            if (node.HashValue == hash && m_equal(node.Data->first, key))
+                return {position, true};
+        }
+    }
+
+    // Backward shift deletion keeps probe sequences valid without tombstones
+    void erase_from_index(size_t position) noexcept
+    {
+        for (size_t next = (position + 1) & m_indexMask; m_index[next] != npos; next = (next + 1) & m_indexMask)
+        {
+            const size_t desired = desired_position(m_nodes[m_index[next]].HashValue);
+            if (((next - desired) & m_indexMask) >= ((next - position) & m_indexMask))
+            {
+                m_index[position] = m_index[next];
+                position = next;
             }
+        }
+
+        m_index[position] = npos;
+    }
+
+    void unlink(index_type nodeIndex) noexcept
+    {
+        auto& node = m_nodes[nodeIndex];
+        (node.Prev != npos ? m_nodes[node.Prev].Next : m_head) = node.Next;
+        (node.Next != npos ? m_nodes[node.Next].Prev : m_tail) = node.Prev;
+        node.Prev = node.Next = npos;
+    }
+
+    void link_front(index_type nodeIndex) noexcept
+    {
+        auto& node = m_nodes[nodeIndex];
+        node.Prev = npos;
+        node.Next = m_head;
+        (m_head != npos ? m_nodes[m_head].Prev : m_tail) = nodeIndex;
+        m_head = nodeIndex;
+    }
 
-            m_cache.emplace_front(std::piecewise_construct, std::tuple {key}, std::forward<ValueFactoryFunc>(valueFactory)(key));
+    template <typename ValueDroppedFunc>
+    index_type acquire_node(ValueDroppedFunc&& valueDroppedCallback)
+    {
+        if (m_free != npos)
+        {
+            const auto nodeIndex = m_free;
+            m_free = m_nodes[nodeIndex].Next;
+            return nodeIndex;
         }
-        else
-            m_cache.splice(m_cache.begin(), m_cache, iterator->second);
 
-    	iterator->second = m_cache.begin();
-        return m_cache.front();
+        assert(m_tail != npos);
+        const auto nodeIndex = m_tail;
+        auto& node = m_nodes[nodeIndex];
+
+        erase_from_index(lookup(node.Data->first, node.HashValue).first);
+        unlink(nodeIndex);
+        --m_size;
+
+        std::forward<ValueDroppedFunc>(valueDroppedCallback)(std::move(*node.Data));
+        node.Data.reset();
+
+        return nodeIndex;
     }
 
+    template <typename K, typename ValueFactoryFunc, typename ValueDroppedFunc>
+    value_type& put_impl(const K& key, ValueFactoryFunc&& valueFactory, ValueDroppedFunc&& valueDroppedCallback)
+    {
+        return emplace_impl(key, std::forward<ValueDroppedFunc>(valueDroppedCallback), [&](std::optional<value_type>& data) {
+            data.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<ValueFactoryFunc>(valueFactory)(key)));
+        }).first;
+    }
 
-    [[nodiscard]] std::optional<const std::reference_wrapper<Value>> find(const key_type& key) const noexcept
+    template <typename K, typename... Args>
+    std::pair<value_type&, bool> try_emplace_impl(const K& key, Args&&... args)
     {
-        if (auto it = m_index.find(key); it != m_index.end())
-            return it->second->second;
+        return emplace_impl(key, [](value_type&&) {}, [&](std::optional<value_type>& data) {
+            data.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    template <typename K>
+    std::optional<const std::reference_wrapper<Value>> find_impl(const K& key) const noexcept
+    {
+        if (const auto [position, found] = lookup(key, m_hash(key)); found)
+            return m_nodes[m_index[position]].Data->second;
 
         return std::nullopt;
     }
 
-    [[nodiscard]] bool exists(const key_type& key) const noexcept { return m_index.contains(key); }
-    [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+    template <typename K, typename ValueDroppedFunc, typename ConstructFunc>
+    std::pair<value_type&, bool> emplace_impl(const K& key, ValueDroppedFunc&& valueDroppedCallback, ConstructFunc&& construct)
+    {
+        const size_t hash = m_hash(key);
+        if (const auto [position, found] = lookup(key, hash); found)
+        {
+            const auto nodeIndex = m_index[position];
+            unlink(nodeIndex);
+            link_front(nodeIndex);
+            return {*m_nodes[nodeIndex].Data, false};
+        }
 
-private:
-    //TODO: arena allocator for list
-	using ListType = std::list<value_type>;
-    using ListIterator = typename ListType::iterator;
-    using MapType = std::unordered_map<key_type, ListIterator>;
+        const auto nodeIndex = acquire_node(std::forward<ValueDroppedFunc>(valueDroppedCallback));
+        auto& node = m_nodes[nodeIndex];
+        try
+        {
+            construct(node.Data);
+        }
+        catch (...)
+        {
+            node.Next = m_free;
+            m_free = nodeIndex;
+            throw;
+        }
+
+        node.HashValue = hash;
+        // eviction could shift index entries, so need to search again
+        m_index[lookup(key, hash).first] = nodeIndex;
+        link_front(nodeIndex);
+        ++m_size;
+
+        return {*node.Data, true};
+    }
 
-    ListType m_cache; 
-	MapType m_index;
+private:
+    std::unique_ptr<Node[]> m_nodes;
+    std::unique_ptr<index_type[]> m_index;
+    size_t m_indexMask;
+    int m_indexShift;
     size_t m_capacity;
-};
\ No newline at end of file
+    size_t m_size = 0;
+
+    index_type m_head = npos; // most recently used
+    index_type m_tail = npos; // least recently used
+    index_type m_free = 0;
+
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+};
@@ -13,6 +13,7 @@ namespace AT2::Keys
     extern const int Key_L;
     extern const int Key_R;
     extern const int Key_M;
+    extern const int Key_T;
     extern const int Key_LShift;
     extern const int Key_Escape;
     extern const int Key_Equal;
@@ -11,6 +11,7 @@ namespace AT2::Keys
     extern const int Key_L = GLFW_KEY_L;
     extern const int Key_R = GLFW_KEY_R;
     extern const int Key_M = GLFW_KEY_M;
+    extern const int Key_T = GLFW_KEY_T;
     extern const int Key_LShift = GLFW_KEY_LEFT_SHIFT;
     extern const int Key_Escape = GLFW_KEY_ESCAPE;
     extern const int Key_Equal = GLFW_KEY_EQUAL;
@@ -24,8 +24,29 @@ namespace AT2::Mappings
         throw AT2Exception("Unsupported TextureWrapMode");
     }
 
+    constexpr MTL::PixelFormat TranslateCompressedFormat(ExternalTextureFormat format)
+    {
+        switch (format.Compression)
+        {
+            case BlockCompression::BC1: return format.PreferSRGB ? MTL::PixelFormatBC1_RGBA_sRGB : MTL::PixelFormatBC1_RGBA;
+            case BlockCompression::BC2: return format.PreferSRGB ? MTL::PixelFormatBC2_RGBA_sRGB : MTL::PixelFormatBC2_RGBA;
+            case BlockCompression::BC3: return format.PreferSRGB ? MTL::PixelFormatBC3_RGBA_sRGB : MTL::PixelFormatBC3_RGBA;
+            case BlockCompression::BC4: return MTL::PixelFormatBC4_RUnorm;
+            case BlockCompression::BC4Signed: return MTL::PixelFormatBC4_RSnorm;
+            case BlockCompression::BC5: return MTL::PixelFormatBC5_RGUnorm;
+            case BlockCompression::BC5Signed: return MTL::PixelFormatBC5_RGSnorm;
+            case BlockCompression::BC6H: return MTL::PixelFormatBC6H_RGBUfloat;
+            case BlockCompression::BC6HSigned: return MTL::PixelFormatBC6H_RGBFloat;
+            case BlockCompression::BC7: return format.PreferSRGB ? MTL::PixelFormatBC7_RGBAUnorm_sRGB : MTL::PixelFormatBC7_RGBAUnorm;
+            default: throw AT2Exception("Unsupported block compression");
+        }
+    }
+
     constexpr MTL::PixelFormat TranslateExternalFormat(ExternalTextureFormat format)
     {
+        if (format.Compression != BlockCompression::None)
+            return TranslateCompressedFormat(format);
+
         if (format.DataType == BufferDataType::Double || format.DataType == BufferDataType::Fixed)
             throw AT2NotImplementedException("double and fixed-point buffer layout support not implemented");
 
@@ -154,6 +175,10 @@ namespace AT2::Mappings
                     case BufferDataType::UInt: return MTL::VertexFormatUInt4;
                     case BufferDataType::HalfFloat: return MTL::VertexFormatHalf4;
                     case BufferDataType::Float: return MTL::VertexFormatFloat4;
+                    case BufferDataType::Int2101010Rev:
+                        if (params.IsNormalized)
+                            return MTL::VertexFormatInt1010102Normalized;
+                        throw AT2Exception("Unsupported vertex format: packed 10-10-10-2 must be normalized");
                     default:
                         throw AT2Exception("Unsupported vertex format");
                 };
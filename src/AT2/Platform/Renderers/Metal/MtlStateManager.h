@@ -29,6 +29,7 @@ public:
     [[nodiscard]] std::optional<BufferDataType> GetIndexDataType() const noexcept override;
 
 	[[nodiscard]] std::optional<unsigned int> GetActiveTextureIndex(std::shared_ptr<ITexture> texture) const noexcept override { return std::nullopt; }
+    void PinTexture(const std::shared_ptr<ITexture>& texture, bool pinned) override {}
     
 //IRenderer interface
     void Draw(Primitives::Primitive type, size_t first, long int count, int numInstances, int baseVertex) override;
@@ -8,6 +8,8 @@
 #include "ShaderProgram.h"
 #include "Mappings.h"
 
+#include <ShaderPreprocessor.h>
+
 #include <filesystem>
 #include <fstream>
 
@@ -29,6 +31,18 @@ std::shared_ptr<ITexture> ResourceFactory::CreateTexture(const Texture& declarat
     return std::make_shared<MtlTexture>(m_renderer, declaration, Mappings::TranslateExternalFormat(desiredFormat));
 }
 
+std::shared_ptr<ITexture> ResourceFactory::CreateTextureView(const std::shared_ptr<ITexture>& texture) const
+{
+    // sampling state is kept by MtlTexture itself, so it's enough to share native texture
+    auto& mtlTexture = Utils::safe_dereference_cast<MtlTexture&>(texture.get());
+
+    auto view = std::make_shared<MtlTexture>(m_renderer, MtlPtr<MTL::Texture> {mtlTexture.getNativeHandle()});
+    view->SetWrapMode(mtlTexture.GetWrapMode());
+    view->SetSamplingMode(mtlTexture.GetSamplingParams());
+    view->SetAnisotropy(mtlTexture.GetAnisotropy());
+    return view;
+}
+
 std::shared_ptr<IFrameBuffer> ResourceFactory::CreateFrameBuffer() const
 {
     return std::make_shared<FrameBuffer>(m_renderer, m_renderer.GetRendererCapabilities().GetMaxNumberOfColorAttachments());
@@ -52,6 +66,12 @@ std::shared_ptr<IBuffer> ResourceFactory::CreateBuffer(VertexBufferType type, st
 }
 
 std::shared_ptr<IShaderProgram> ResourceFactory::CreateShaderProgramFromFiles(std::initializer_list<str> files) const
+{
+    return CreateShaderProgramFromFiles(std::span {files.begin(), files.size()}, {});
+}
+
+// Metal libraries are precompiled, so GLSL defines have no effect here
+std::shared_ptr<IShaderProgram> ResourceFactory::CreateShaderProgramFromFiles(std::span<const str> files, std::span<const ShaderDefine>) const
 {
     class LibrariesRegistry
     {
@@ -104,3 +124,8 @@ void AT2::Metal::ResourceFactory::ReloadResources(ReloadableGroup group)
 {
 	
 }
+
+void AT2::Metal::ResourceFactory::RegisterReloadable(std::weak_ptr<IReloadable> resource) const
+{
+    m_reloadableResourcesList.push_back(std::move(resource));
+}
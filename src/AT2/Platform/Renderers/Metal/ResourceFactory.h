@@ -19,12 +19,15 @@ public:
                                                            const glm::uvec2& size) const override;
     std::shared_ptr<ITexture> CreateTexture(const Texture& declaration,
                                             ExternalTextureFormat desiredFormat) const override;
+    std::shared_ptr<ITexture> CreateTextureView(const std::shared_ptr<ITexture>& texture) const override;
     std::shared_ptr<IFrameBuffer> CreateFrameBuffer() const override;
     std::shared_ptr<IVertexArray> CreateVertexArray() const override;
     std::shared_ptr<IBuffer> CreateBuffer(VertexBufferType type) const override;
     std::shared_ptr<IBuffer> CreateBuffer(VertexBufferType type, std::span<const std::byte> data) const override;
     std::shared_ptr<IShaderProgram> CreateShaderProgramFromFiles(std::initializer_list<str> files) const override;
+    std::shared_ptr<IShaderProgram> CreateShaderProgramFromFiles(std::span<const str> files, std::span<const ShaderDefine> defines) const override;
     void ReloadResources(ReloadableGroup group) override;
+    void RegisterReloadable(std::weak_ptr<IReloadable> resource) const override;
 
 private:
     Renderer& m_renderer;
@@ -57,6 +57,10 @@ constexpr size_t GetNumberOfChannelsInLayout(TextureLayout layout)
 
 constexpr size_t GetRowLength(ExternalTextureFormat format, size_t width)
 {
+    // a row of 4x4 blocks
+    if (format.Compression != BlockCompression::None)
+        return (width + 3) / 4 * GetBlockLength(format.Compression);
+
     return width * GetSizeofType(format.DataType)*GetNumberOfChannelsInLayout(format.ChannelsLayout);
 }
 
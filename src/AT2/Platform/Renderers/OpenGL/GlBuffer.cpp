@@ -37,6 +37,16 @@ void GlBuffer::ReserveSpace( size_t size )
     SetDataRaw(std::span {emptyData, size});
 }
 
+void GlBuffer::SetSubDataRaw(size_t offset, std::span<const std::byte> data)
+{
+    assert(!m_mapped);
+
+    if (offset + data.size() > m_length)
+        throw AT2BufferException("GlBuffer: sub data is out of the buffer storage");
+
+    glNamedBufferSubData(m_id, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(data.size()), data.data());
+}
+
 std::span<std::byte> GlBuffer::Map(BufferUsage usage)
 {
     if (m_mapped)
@@ -21,6 +21,8 @@ namespace AT2::OpenGL
 
         void SetDataRaw(std::span<const std::byte> data) override;
         void ReserveSpace(size_t size) override;
+        // Writes into the existing storage, which must be big enough
+        void SetSubDataRaw(size_t offset, std::span<const std::byte> data);
 
         std::span<std::byte> Map(BufferUsage usage) override;
         std::span<std::byte> MapRange(BufferUsage usage, size_t offset, size_t length) override;
@@ -119,7 +119,9 @@ void GlFrameBuffer::Render(RenderFunc renderFunc)
         if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
             throw AT2BufferException("GlFrameBuffer: validation failed");
 
-        m_size = m_colorAttachments[0].Texture->GetSize();
+        // depth-only framebuffers, e.g. shadow maps, take the size of the depth attachment
+        const auto& sizeSource = m_colorAttachments[0].Texture ? m_colorAttachments[0].Texture : m_depthAttachment.Texture;
+        m_size = sizeSource->GetSize();
         m_dirtyFlag = false;
     }
 
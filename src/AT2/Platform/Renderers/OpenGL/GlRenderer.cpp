@@ -1,9 +1,14 @@
 #include "GlRenderer.h"
 
+#include "GlBuffer.h"
+#include "GlShaderProgram.h"
 #include "GlStateManager.h"
 #include "GlFrameBuffer.h"
 #include "Mappings.h"
 
+#include <algorithm>
+#include <bit>
+
 using namespace std::literals;
 using namespace AT2;
 using namespace OpenGL;
@@ -56,6 +61,9 @@ GlRenderer::GlRenderer(IPlatformGraphicsContext& graphicsContext, GLADloadproc g
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
     glEnable(GL_FRAMEBUFFER_SRGB);
 
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(std::numeric_limits<GLuint>::max()); // let driver decide
+
     PrintDiagnosticInfo();
 
     m_rendererCapabilities = std::make_unique<GlRendererCapabilities>();
@@ -64,8 +72,13 @@ GlRenderer::GlRenderer(IPlatformGraphicsContext& graphicsContext, GLADloadproc g
     m_defaultFramebuffer = std::make_unique<GlScreenFrameBuffer>(*this);
 }
 
+GlRenderer::~GlRenderer() = default;
+
 void GlRenderer::BeginFrame()
 {
+    auto& resourceFactory = static_cast<GlResourceFactory&>(*m_resourceFactory);
+    resourceFactory.ReloadChangedResources();
+    resourceFactory.PollPendingPrograms();
 }
 
 void GlRenderer::FinishFrame()
@@ -73,6 +86,11 @@ void GlRenderer::FinishFrame()
     glFinish();
 }
 
+bool GlRenderer::PollActiveProgram()
+{
+    return static_cast<GlStateManager&>(*m_stateManager).PollActiveProgram();
+}
+
 IFrameBuffer& GlRenderer::GetDefaultFramebuffer() const
 {
     return *m_defaultFramebuffer;
@@ -80,7 +98,12 @@ IFrameBuffer& GlRenderer::GetDefaultFramebuffer() const
 
 void GlRenderer::DispatchCompute(const std::shared_ptr<IShaderProgram>& computeProgram, glm::uvec3 threadGroupSize)
 {
+    // dispatches are usually one-shot jobs, so they wait for the program instead of being skipped
+    Utils::safe_dereference_cast<GlShaderProgram&>(computeProgram).WaitReady();
+
     GetStateManager().BindShader(computeProgram);
+    if (!PollActiveProgram())
+        return;
 
     glDispatchCompute(threadGroupSize.x, threadGroupSize.y, threadGroupSize.z);
 
@@ -90,9 +113,13 @@ void GlRenderer::DispatchCompute(const std::shared_ptr<IShaderProgram>& computeP
 //sub-optimal but abstract :)
 void GlRenderer::Draw(Primitives::Primitive type, size_t first, long count, int numInstances, int baseVertex)
 {
-    if (first < 0 || count < 0 || numInstances < 0 || baseVertex < 0)
+    // base vertex could be negative, only the indices with it added should be
+    if (first < 0 || count < 0 || numInstances < 0)
         throw AT2RendererException( "GlRenderer: Draw arguments should be positive!");
 
+    if (!PollActiveProgram())
+        return;
+
     const auto platformPrimitiveMode = Mappings::TranslatePrimitiveType(type);
 
     if (auto* const patchParams = std::get_if<Primitives::Patches>(&type))
@@ -101,16 +128,18 @@ void GlRenderer::Draw(Primitives::Primitive type, size_t first, long count, int
     if (const auto indexDataType = GetStateManager().GetIndexDataType())
     {
         const auto platformIndexBufferType = Mappings::TranslateExternalType(*indexDataType);
+        // first is an index of element, but GL expects offset in bytes
+        auto* const indicesOffset = reinterpret_cast<void*>(first * BufferDataTypes::GetSizeOf(*indexDataType));
         if (numInstances > 1)
         {
             glDrawElementsInstancedBaseVertex(platformPrimitiveMode, static_cast<GLsizei>(count),
-                                              platformIndexBufferType, reinterpret_cast<void*>(first),
+                                              platformIndexBufferType, indicesOffset,
                                               static_cast<GLsizei>(numInstances), baseVertex);
         }
         else
         {
             glDrawElementsBaseVertex(platformPrimitiveMode, static_cast<GLsizei>(count), platformIndexBufferType,
-                                     reinterpret_cast<void*>(first), baseVertex);
+                                     indicesOffset, baseVertex);
         }
     }
     else
@@ -126,6 +155,53 @@ void GlRenderer::Draw(Primitives::Primitive type, size_t first, long count, int
     }
 }
 
+void GlRenderer::MultiDrawIndexed(Primitives::Primitive type, std::span<const DrawElementsIndirectCommand> commands)
+{
+    if (commands.empty() || !PollActiveProgram())
+        return;
+
+    const auto indexDataType = GetStateManager().GetIndexDataType();
+    if (!indexDataType)
+        throw AT2RendererException("GlRenderer: MultiDrawIndexed requires index buffer");
+
+    if (auto* const patchParams = std::get_if<Primitives::Patches>(&type))
+        glPatchParameteri(GL_PATCH_VERTICES, patchParams->NumControlPoints);
+
+    // a single command doesn't need the indirect buffer round trip, it's drawn the same way as the indirect one would be
+    if (const auto& command = commands.front(); commands.size() == 1 && command.BaseInstance == 0)
+    {
+        const auto indicesOffset = static_cast<size_t>(command.FirstIndex) * BufferDataTypes::GetSizeOf(*indexDataType);
+        glDrawElementsInstancedBaseVertex(Mappings::TranslatePrimitiveType(type), static_cast<GLsizei>(command.Count),
+                                          Mappings::TranslateExternalType(*indexDataType),
+                                          reinterpret_cast<const void*>(indicesOffset),
+                                          static_cast<GLsizei>(command.InstanceCount), command.BaseVertex);
+        return;
+    }
+
+    if (!m_drawCommandsBuffer)
+        m_drawCommandsBuffer = std::make_unique<GlBuffer>(VertexBufferType::IndirectBuffer);
+
+    // commands are appended to the buffer like to a ring, so the driver doesn't reallocate it or wait for the previous
+    // draws; the storage is orphaned when it wraps around and grows to the biggest batch
+    const auto data = std::as_bytes(commands);
+    if (m_drawCommandsOffset + data.size() > m_drawCommandsBuffer->GetLength())
+    {
+        constexpr std::byte* emptyData = nullptr;
+        const auto newLength = std::max({m_drawCommandsBuffer->GetLength(), DrawCommandsBufferSize, std::bit_ceil(data.size())});
+        m_drawCommandsBuffer->SetDataRaw(std::span {emptyData, newLength});
+        m_drawCommandsOffset = 0;
+    }
+
+    m_drawCommandsBuffer->SetSubDataRaw(m_drawCommandsOffset, data);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_drawCommandsBuffer->GetId());
+    glMultiDrawElementsIndirect(Mappings::TranslatePrimitiveType(type), Mappings::TranslateExternalType(*indexDataType),
+                                reinterpret_cast<const void*>(m_drawCommandsOffset), static_cast<GLsizei>(commands.size()), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    m_drawCommandsOffset += data.size();
+}
+
 void GlRenderer::SetViewport(const AABB2d& viewport)
 {
     glViewport(static_cast<GLint>(viewport.MinBound.x), static_cast<GLint>(viewport.MinBound.y),
@@ -3,6 +3,9 @@
 
 #include "AT2lowlevel.h"
 #include <GraphicsContextInterface.h>
+#include <DependencyGraph.h>
+#include <FileWatcher.h>
+#include <ProgramBinaryCache.h>
 
 namespace AT2::OpenGL
 {
@@ -10,6 +13,8 @@ namespace AT2::OpenGL
     class GlRenderer;
     class GlTexture;
     class GlFrameBuffer;
+    class GlShaderProgram;
+    class GlBuffer;
 
     class GlResourceFactory : public IResourceFactory
     {
@@ -24,16 +29,38 @@ namespace AT2::OpenGL
                                                                const glm::uvec2& size) const override;
         std::shared_ptr<ITexture> CreateTexture(const Texture& declaration,
                                                 ExternalTextureFormat desiredFormat) const override;
+        std::shared_ptr<ITexture> CreateTextureView(const std::shared_ptr<ITexture>& texture) const override;
         std::shared_ptr<IFrameBuffer> CreateFrameBuffer() const override;
         std::shared_ptr<IVertexArray> CreateVertexArray() const override;
         std::shared_ptr<IBuffer> CreateBuffer(VertexBufferType type) const override;
         std::shared_ptr<IBuffer> CreateBuffer(VertexBufferType type, std::span<const std::byte> data) const override;
         std::shared_ptr<IShaderProgram> CreateShaderProgramFromFiles(std::initializer_list<str> files) const override;
+        std::shared_ptr<IShaderProgram> CreateShaderProgramFromFiles(std::span<const str> files, std::span<const ShaderDefine> defines) const override;
         void ReloadResources(ReloadableGroup group) override;
+        void RegisterReloadable(std::weak_ptr<IReloadable> resource) const override;
+
+        // Advances building of the shader programs without blocking
+        void PollPendingPrograms();
+        // Reloads only resources which files were changed since the previous call
+        void ReloadChangedResources();
+
+    private:
+        void Reload(size_t resourceIndex, IReloadable& resource);
+        void ResolveDependencies();
+        // Frees ids of destroyed resources with their dependencies and watched files
+        void ReleaseExpiredReloadables();
+        // Files which aren't dependencies of any resource anymore
+        void UnwatchFiles(std::span<const std::filesystem::path> files);
 
     private:
         GlRenderer& m_renderer;
-        mutable std::vector<std::weak_ptr<IReloadable>> m_reloadableResourcesList;
+        mutable std::vector<std::weak_ptr<IReloadable>> m_reloadableResourcesList; // index is an id in dependency graph
+        mutable std::vector<size_t> m_freeReloadableIds; // their resources are released, ids are reused by new ones
+        mutable std::vector<size_t> m_unresolvedReloadables; // dependencies are not known yet
+        DependencyGraph<size_t> m_dependencyGraph;
+        std::unique_ptr<FileWatcher> m_fileWatcher;
+        std::unique_ptr<ProgramBinaryCache> m_programBinaryCache;
+        mutable std::vector<std::weak_ptr<GlShaderProgram>> m_shaderPrograms;
     };
 
     class GlRenderer : public IVisualizationSystem, public IRenderer
@@ -42,7 +69,7 @@ namespace AT2::OpenGL
         NON_COPYABLE_OR_MOVABLE(GlRenderer)
 
         GlRenderer(IPlatformGraphicsContext& graphicsContext, GLADloadproc glFunctionsBinder);
-        ~GlRenderer() override = default;
+        ~GlRenderer() override;
 
     public:
         [[nodiscard]] IResourceFactory& GetResourceFactory() const override { return *m_resourceFactory; }
@@ -54,6 +81,7 @@ namespace AT2::OpenGL
 
         void DispatchCompute(const std::shared_ptr<IShaderProgram>& computeProgram, glm::uvec3 threadGroupSize) override;
         void Draw(Primitives::Primitive type, size_t first, long int count, int numInstances = 1, int baseVertex = 0) override;
+        void MultiDrawIndexed(Primitives::Primitive type, std::span<const DrawElementsIndirectCommand> commands) override;
 
         void SetViewport(const AABB2d& viewport) override;
         void SetScissorWindow(const AABB2d& viewport) override;
@@ -67,6 +95,9 @@ namespace AT2::OpenGL
         const IPlatformGraphicsContext& GetGraphicsContext() const { return m_graphicsContext; }
 
     private:
+        // Programs may finish building after they were bound, so the state is checked again for every draw
+        [[nodiscard]] bool PollActiveProgram();
+
         static void __stdcall GlErrorCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
                                     const GLchar* message, const GLvoid* userParam);
 
@@ -76,6 +107,10 @@ namespace AT2::OpenGL
         std::unique_ptr<IResourceFactory> m_resourceFactory;
         std::unique_ptr<IRendererCapabilities> m_rendererCapabilities;
         std::unique_ptr<IFrameBuffer> m_defaultFramebuffer;
+
+        static constexpr size_t DrawCommandsBufferSize = 64 * 1024;
+        std::unique_ptr<GlBuffer> m_drawCommandsBuffer;
+        size_t m_drawCommandsOffset = 0;
     };
 
 } // namespace AT2::OpenGL
@@ -5,9 +5,11 @@
 #include "GlTexture.h"
 #include "GlVertexArray.h"
 
+#include <ShaderPreprocessor.h>
 #include <utils.hpp>
 
-#include <fstream>
+#include <future>
+#include <mutex>
 #include <optional>
 #include "GlFrameBuffer.h"
 
@@ -17,8 +19,45 @@ using namespace OpenGL;
 
 namespace
 {
+    GLint DetermineCompressedInternalFormat(ExternalTextureFormat format)
+    {
+        const bool hasAlpha = format.ChannelsLayout == TextureLayout::RGBA;
+        switch (format.Compression)
+        {
+        case BlockCompression::BC1:
+        case BlockCompression::BC2:
+        case BlockCompression::BC3:
+            // S3TC isn't a part of core profile because of patents, but it's supported by all desktop vendors
+            if (!GLAD_GL_EXT_texture_compression_s3tc || (format.PreferSRGB && !GLAD_GL_EXT_texture_sRGB))
+                throw AT2TextureException("S3TC compressed textures aren't supported");
+
+            if (format.Compression == BlockCompression::BC1)
+            {
+                if (format.PreferSRGB)
+                    return hasAlpha ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT : GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+                return hasAlpha ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            }
+            if (format.Compression == BlockCompression::BC2)
+                return format.PreferSRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT : GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+
+            return format.PreferSRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+        case BlockCompression::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case BlockCompression::BC4Signed: return GL_COMPRESSED_SIGNED_RED_RGTC1;
+        case BlockCompression::BC5: return GL_COMPRESSED_RG_RGTC2;
+        case BlockCompression::BC5Signed: return GL_COMPRESSED_SIGNED_RG_RGTC2;
+        case BlockCompression::BC6H: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+        case BlockCompression::BC6HSigned: return GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+        case BlockCompression::BC7: return format.PreferSRGB ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+        default: throw AT2TextureException("Unsupported block compression");
+        }
+    }
+
     constexpr GLint DetermineInternalFormat(ExternalTextureFormat format)
     {
+        if (format.Compression != BlockCompression::None)
+            return DetermineCompressedInternalFormat(format);
+
         if (format.DataType == BufferDataType::Double || format.DataType == BufferDataType::Fixed)
             throw AT2NotImplementedException("double and fixed-point buffer layout support not implemented");
 
@@ -103,7 +142,28 @@ namespace
 } // namespace
 
 
-GlResourceFactory::GlResourceFactory(GlRenderer& renderer) : m_renderer(renderer) {}
+GlResourceFactory::GlResourceFactory(GlRenderer& renderer) : m_renderer(renderer), m_fileWatcher {std::make_unique<FileWatcher>()}
+{
+    if (GetInteger(GL_NUM_PROGRAM_BINARY_FORMATS, 0) == 0)
+    {
+        Log::Info() << "Program binaries are not supported by driver, shader cache disabled" << std::endl;
+        return;
+    }
+
+    std::error_code errorCode;
+    const auto tempDirectory = std::filesystem::temp_directory_path(errorCode);
+    if (errorCode)
+        return;
+
+    const auto glString = [](GLenum name) {
+        const auto* str = reinterpret_cast<const char*>(glGetString(name));
+        return std::string_view {str ? str : ""};
+    };
+    auto driverSignature =
+        Utils::ConcatStrings(glString(GL_VENDOR), "\n"sv, glString(GL_RENDERER), "\n"sv, glString(GL_VERSION));
+
+    m_programBinaryCache = std::make_unique<ProgramBinaryCache>(tempDirectory / "AT2" / "ProgramBinaries", std::move(driverSignature));
+}
 
 std::shared_ptr<ITexture> GlResourceFactory::CreateTextureFromFramebuffer(const glm::ivec2& pos,
                                                                           const glm::uvec2& size) const
@@ -120,6 +180,15 @@ std::shared_ptr<ITexture> GlResourceFactory::CreateTexture(const Texture& declar
     return std::make_shared<GlTexture>(declaration, DetermineInternalFormat(desiredFormat));
 }
 
+std::shared_ptr<ITexture> GlResourceFactory::CreateTextureView(const std::shared_ptr<ITexture>& texture) const
+{
+    auto glTexture = std::dynamic_pointer_cast<GlTexture>(texture);
+    if (!glTexture)
+        throw AT2TextureException("GlResourceFactory: texture view could be created only from GlTexture");
+
+    return std::make_shared<GlTexture>(std::move(glTexture));
+}
+
 std::shared_ptr<IFrameBuffer> GlResourceFactory::CreateFrameBuffer() const
 {
     return std::make_shared<GlFrameBuffer>(m_renderer);
@@ -143,39 +212,51 @@ std::shared_ptr<IBuffer> GlResourceFactory::CreateBuffer(VertexBufferType type,
     return buffer;
 }
 
-//TODO: Resource system!
 std::shared_ptr<IShaderProgram> GlResourceFactory::CreateShaderProgramFromFiles(std::initializer_list<str> files) const
+{
+    return CreateShaderProgramFromFiles(std::span {files.begin(), files.size()}, {});
+}
+
+//TODO: Resource system!
+std::shared_ptr<IShaderProgram> GlResourceFactory::CreateShaderProgramFromFiles(std::span<const str> files, std::span<const ShaderDefine> defines) const
 {
     class GlShaderProgramFromFileImpl : public IReloadable
     {
     public:
-        GlShaderProgramFromFileImpl(GlRenderer& renderer, std::initializer_list<str> filenames) : m_renderer {renderer},
-        m_filenames {ClassifyFilenames(filenames)}, m_shader {m_renderer, MakeShaderDescriptor(m_filenames)}
+        GlShaderProgramFromFileImpl(GlRenderer& renderer, std::span<const str> filenames, std::span<const ShaderDefine> defines, const ProgramBinaryCache* binaryCache) : m_renderer {renderer},
+        m_binaryCache {binaryCache}, m_filenames {ClassifyFilenames(filenames)}, m_defines {defines.begin(), defines.end()},
+        m_dependencies {std::make_shared<DependencyList>()},
+        m_shader {m_renderer, LoadShaderDescriptorAsync(m_filenames, m_defines, m_dependencies), m_binaryCache}
         {
         }
 
-        void Reload() override { m_shader = GlShaderProgram {m_renderer, MakeShaderDescriptor(m_filenames)}; }
+        void Reload() override
+        {
+            // includes could be changed, so dependencies are collected again
+            m_dependencies = std::make_shared<DependencyList>();
+            m_shader = GlShaderProgram {m_renderer, LoadShaderDescriptorAsync(m_filenames, m_defines, m_dependencies), m_binaryCache};
+        }
 
         ReloadableGroup getReloadableClass() const override { return ReloadableGroup::Shaders; }
 
+        std::optional<std::vector<std::filesystem::path>> getDependencies() const override
+        {
+            std::scoped_lock lock {m_dependencies->Mutex};
+            return m_dependencies->Files;
+        }
+
         GlShaderProgram& GetShader() { return m_shader; }
 
     private:
         using ShaderType = GlShaderProgram::ShaderType;
         using ClassifiedFilenameList = std::vector<std::pair<std::string, ShaderType>>;
 
-        static std::string LoadFile(std::filesystem::path _filename)
+        // filled by the loading task
+        struct DependencyList
         {
-            if (_filename.empty())
-                return "";
-
-            std::ifstream t(_filename);
-            if (!t.is_open())
-                throw AT2IOException(Utils::ConcatStrings("file '"sv, _filename.string(), "' not found."sv));
-
-
-            return std::string((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
-        }
+            std::mutex Mutex;
+            std::optional<std::vector<std::filesystem::path>> Files;
+        };
 
         static ShaderType GetShaderTypeFromExtension(std::string_view filename)
         {
@@ -193,7 +274,7 @@ std::shared_ptr<IShaderProgram> GlResourceFactory::CreateShaderProgramFromFiles(
             return it != knownExtensions.end() ? it->second : throw AT2Exception(Utils::ConcatStrings("Couldn't deduce shader type from filename: "sv, filename));
         }
 
-        static ClassifiedFilenameList ClassifyFilenames(std::initializer_list<str> filenames)
+        static ClassifiedFilenameList ClassifyFilenames(std::span<const str> filenames)
         {
             ClassifiedFilenameList classifiedFilenames {filenames.size()};
             std::transform(filenames.begin(), filenames.end(), classifiedFilenames.begin(), [](const std::string& filename) {
@@ -203,34 +284,187 @@ std::shared_ptr<IShaderProgram> GlResourceFactory::CreateShaderProgramFromFiles(
             return classifiedFilenames;
         }
 
-        static GlShaderProgram::ShaderDescriptor MakeShaderDescriptor(const ClassifiedFilenameList& filesList)
+        static GlShaderProgram::ShaderDescriptor MakeShaderDescriptor(const ClassifiedFilenameList& filesList, std::span<const ShaderDefine> defines,
+                                                                      DependencyList& dependencies)
         {
+            const ShaderPreprocessor preprocessor;
+
+            // root files are known even if loading fails, so fixing of the error triggers reload
+            std::vector<std::filesystem::path> files(filesList.size());
+            std::transform(filesList.begin(), filesList.end(), files.begin(), [](ClassifiedFilenameList::const_reference classifiedPath) {
+                return std::filesystem::path {classifiedPath.first};
+            });
+
+            const auto publishDependencies = [&] {
+                std::scoped_lock lock {dependencies.Mutex};
+                dependencies.Files = std::move(files);
+            };
+
             GlShaderProgram::ShaderDescriptor descriptor;
-            std::transform(filesList.begin(), filesList.end(), std::inserter(descriptor, descriptor.end()),
-                           [](ClassifiedFilenameList::const_reference classifiedPath) {
-                               return GlShaderProgram::ShaderDescriptor::value_type {classifiedPath.second, LoadFile(classifiedPath.first)};
-                           });
+            try
+            {
+                for (const auto& [filename, shaderType] : filesList)
+                {
+                    auto result = preprocessor.Process(filename, defines);
+                    descriptor.emplace(shaderType, std::move(result.Source));
+                    files.insert(files.end(), result.Dependencies.begin(), result.Dependencies.end());
+                }
+            }
+            catch (...)
+            {
+                publishDependencies();
+                throw;
+            }
+
+            publishDependencies();
             return descriptor;
         }
 
+        // program is built when sources are loaded, so startup doesn't wait for the disk
+        static std::future<GlShaderProgram::ShaderDescriptor> LoadShaderDescriptorAsync(const ClassifiedFilenameList& filesList, const std::vector<ShaderDefine>& defines,
+                                                                                        std::shared_ptr<DependencyList> dependencies)
+        {
+            return std::async(std::launch::async, [filesList, defines, dependencies = std::move(dependencies)] {
+                return MakeShaderDescriptor(filesList, defines, *dependencies);
+            });
+        }
+
     private:
         GlRenderer& m_renderer;
+        const ProgramBinaryCache* m_binaryCache;
         ClassifiedFilenameList m_filenames;
+        std::vector<ShaderDefine> m_defines;
+        std::shared_ptr<DependencyList> m_dependencies;
         GlShaderProgram m_shader;
     };
 
-    auto resource = std::make_shared<GlShaderProgramFromFileImpl>(m_renderer, files);
-    m_reloadableResourcesList.push_back(std::weak_ptr<IReloadable>(resource));
+    auto resource = std::make_shared<GlShaderProgramFromFileImpl>(m_renderer, files, defines, m_programBinaryCache.get());
+    RegisterReloadable(resource);
 
-    return {resource, &resource->GetShader()};
+    auto shaderProgram = std::shared_ptr<GlShaderProgram> {resource, &resource->GetShader()};
+    m_shaderPrograms.push_back(shaderProgram);
+
+    return shaderProgram;
+}
+
+void GlResourceFactory::PollPendingPrograms()
+{
+    std::erase_if(m_shaderPrograms, [](const std::weak_ptr<GlShaderProgram>& program) { return program.expired(); });
+
+    for (const auto& weakProgram : m_shaderPrograms)
+        if (const auto program = weakProgram.lock(); program && program->IsPending())
+            program->PollReady();
 }
 
 void GlResourceFactory::ReloadResources(ReloadableGroup group)
 {
-    for (const auto& resource : m_reloadableResourcesList)
+    for (size_t i = 0; i < m_reloadableResourcesList.size(); ++i)
     {
-        if (auto reloadable = resource.lock())
+        if (auto reloadable = m_reloadableResourcesList[i].lock())
             if (reloadable->getReloadableClass() == group)
-                reloadable->Reload();
+                Reload(i, *reloadable);
+    }
+}
+
+void GlResourceFactory::RegisterReloadable(std::weak_ptr<IReloadable> resource) const
+{
+    // streamed resources come and go, so the list only grows to the peak number of them
+    if (m_freeReloadableIds.empty())
+    {
+        m_unresolvedReloadables.push_back(m_reloadableResourcesList.size());
+        m_reloadableResourcesList.push_back(std::move(resource));
+        return;
+    }
+
+    const auto resourceIndex = m_freeReloadableIds.back();
+    m_freeReloadableIds.pop_back();
+
+    m_reloadableResourcesList[resourceIndex] = std::move(resource);
+    m_unresolvedReloadables.push_back(resourceIndex);
+}
+
+void GlResourceFactory::ReloadChangedResources()
+{
+    ReleaseExpiredReloadables();
+    ResolveDependencies();
+
+    const auto changedFiles = m_fileWatcher->PollChanges();
+    if (changedFiles.empty())
+        return;
+
+    for (const auto& file : changedFiles)
+        Log::Debug() << "File changed: " << file.string() << std::endl;
+
+    for (const auto resourceIndex : m_dependencyGraph.GetDependents(changedFiles))
+    {
+        if (auto reloadable = m_reloadableResourcesList[resourceIndex].lock())
+            Reload(resourceIndex, *reloadable);
+        else
+            UnwatchFiles(m_dependencyGraph.Remove(resourceIndex));
+    }
+}
+
+void GlResourceFactory::Reload(size_t resourceIndex, IReloadable& resource)
+{
+    try
+    {
+        resource.Reload();
+    }
+    catch (const std::exception& exception)
+    {
+        Log::Error() << "Resource reloading failed: " << exception.what() << std::endl;
+    }
+
+    // set of files could be changed, e.g. by editing includes
+    if (std::ranges::find(m_unresolvedReloadables, resourceIndex) == m_unresolvedReloadables.end())
+        m_unresolvedReloadables.push_back(resourceIndex);
+}
+
+void GlResourceFactory::ResolveDependencies()
+{
+    std::erase_if(m_unresolvedReloadables, [this](size_t resourceIndex) {
+        const auto reloadable = m_reloadableResourcesList[resourceIndex].lock();
+        if (!reloadable)
+        {
+            UnwatchFiles(m_dependencyGraph.Remove(resourceIndex));
+            return true;
+        }
+
+        const auto dependencies = reloadable->getDependencies();
+        if (!dependencies)
+            return false;
+
+        // e.g. includes removed from a shader
+        UnwatchFiles(m_dependencyGraph.SetDependencies(resourceIndex, *dependencies));
+        for (const auto& file : *dependencies)
+            m_fileWatcher->Watch(file);
+
+        return true;
+    });
+}
+
+void GlResourceFactory::UnwatchFiles(std::span<const std::filesystem::path> files)
+{
+    for (const auto& file : files)
+        m_fileWatcher->Unwatch(file);
+}
+
+void GlResourceFactory::ReleaseExpiredReloadables()
+{
+    // free slots hold empty pointers, they are expired too
+    std::vector<bool> isFree(m_reloadableResourcesList.size(), false);
+    for (const auto resourceIndex : m_freeReloadableIds)
+        isFree[resourceIndex] = true;
+
+    for (size_t i = 0; i < m_reloadableResourcesList.size(); ++i)
+    {
+        if (isFree[i] || !m_reloadableResourcesList[i].expired())
+            continue;
+
+        UnwatchFiles(m_dependencyGraph.Remove(i));
+
+        std::erase(m_unresolvedReloadables, i);
+        m_reloadableResourcesList[i].reset();
+        m_freeReloadableIds.push_back(i);
     }
 }
@@ -93,10 +93,50 @@ namespace
 } // namespace
 
 
-GlShaderProgram::GlShaderProgram(IRenderer& renderer, const ShaderDescriptor& descriptor)
+GlShaderProgram::GlShaderProgram(IRenderer& renderer, const ShaderDescriptor& descriptor, const ProgramBinaryCache* binaryCache)
 	: m_renderer {&renderer}
 	, m_programId{ glCreateProgram() }
+	, m_binaryCache {binaryCache}
 {
+    StartBuilding(descriptor);
+}
+
+GlShaderProgram::GlShaderProgram(IRenderer& renderer, std::future<ShaderDescriptor> pendingDescriptor, const ProgramBinaryCache* binaryCache)
+	: m_renderer {&renderer}
+	, m_programId{ glCreateProgram() }
+	, m_pendingDescriptor {std::move(pendingDescriptor)}
+	, m_binaryCache {binaryCache}
+	, m_currentState {State::Loading}
+{
+}
+
+GlShaderProgram::~GlShaderProgram()
+{
+    for (const auto& [type, shaderId] : m_shaderIds)
+    {
+        glDetachShader(m_programId, shaderId);
+        glDeleteShader(shaderId);
+    }
+
+    glDeleteProgram(m_programId);
+}
+
+void GlShaderProgram::StartBuilding(const ShaderDescriptor& descriptor)
+{
+    if (m_binaryCache)
+    {
+        std::vector<ProgramBinaryCache::Stage> stages;
+        for (const auto& [shaderType, shaderSource] : descriptor)
+            if (!shaderSource.empty())
+                stages.push_back({static_cast<std::uint32_t>(shaderType), shaderSource});
+
+        m_binaryKey = m_binaryCache->ComputeKey(stages);
+        if (TryLoadProgramBinary())
+            return;
+
+        glProgramParameteri(m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     auto tryAttachShader = [this](ShaderType shaderType, std::string_view shaderSource)
     {
         if (shaderSource.empty())
@@ -110,73 +150,143 @@ GlShaderProgram::GlShaderProgram(IRenderer& renderer, const ShaderDescriptor& de
 
     for (const auto& [shaderType, shaderSource] : descriptor)
         tryAttachShader(shaderType, shaderSource);
+
+    // linking is requested right away: with KHR_parallel_shader_compile neither compilation nor linking blocks here,
+    // so all programs are built by the driver threads concurrently
+    glLinkProgram(m_programId);
+    m_currentState = State::Linking;
 }
 
-GlShaderProgram::~GlShaderProgram()
+bool GlShaderProgram::IsLinkCompleted() const
 {
-    for (const auto& [type, shaderId] : m_shaderIds)
-    {
-        glDetachShader(m_programId, shaderId);
-        glDeleteShader(shaderId);
-    }
+    if (!GLAD_GL_KHR_parallel_shader_compile)
+        return true;
 
-    glDeleteProgram(m_programId);
+    GLint isCompleted = GL_FALSE;
+    glGetProgramiv(m_programId, GL_COMPLETION_STATUS_KHR, &isCompleted);
+    return isCompleted == GL_TRUE;
 }
 
-bool GlShaderProgram::TryLinkProgram()
+void GlShaderProgram::FinishLinking()
 {
-    if (m_currentState == State::Dirty)
-    {
-        m_uniformsInfo.reset();
+    m_uniformsInfo.reset();
 
-        for (const auto& [shaderType, shaderId] : m_shaderIds)
+    for (const auto& [shaderType, shaderId] : m_shaderIds)
+    {
+        GLint status = 0;
+        glGetShaderiv(shaderId, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE)
         {
-            GLint infoLogLength = 0;
-            glGetShaderiv(shaderId, GL_INFO_LOG_LENGTH, &infoLogLength);
-            //if (infoLogLength > 0)
-            //{
-            //    std::string infoLog(static_cast<unsigned>(infoLogLength) - 1, '\0');
-
-            //    glGetShaderInfoLog(shaderId, infoLogLength, &infoLogLength, infoLog.data());
-            //    Log::Debug() << "Shader \"" << GetName() << "\" log: " << std::endl << infoLog;
-            //}
-
-            GLint status = 0;
-            glGetShaderiv(shaderId, GL_COMPILE_STATUS, &status);
-            if (status != GL_TRUE)
-            {
-                Log::Warning() << ShaderTypeName(shaderType) << " shader \"" << GetName() << "\" compilation failed!" << std::endl;
-            }
+            Log::Warning() << ShaderTypeName(shaderType) << " shader \"" << GetName() << "\" compilation failed!" << std::endl;
         }
+    }
 
-        //linking program
-        glLinkProgram(m_programId);
-        GLint isLinked = 0;
-        glGetProgramiv(m_programId, GL_LINK_STATUS, &isLinked);
+    GLint isLinked = 0;
+    glGetProgramiv(m_programId, GL_LINK_STATUS, &isLinked);
 
-        if (isLinked)
+    if (isLinked)
+    {
+        m_uniformsInfo = ProgramInfo::Request(m_programId);
+        m_currentState = State::Ready;
+
+        if (m_binaryCache)
+            StoreProgramBinary();
+    }
+    else
+        m_currentState = State::Error;
+
+    //log
+    GLint infoLogLength = 0;
+    glGetProgramiv(m_programId, GL_INFO_LOG_LENGTH, &infoLogLength);
+    if (infoLogLength > 0)
+    {
+        std::string infoLog(static_cast<unsigned>(infoLogLength) - 1, '\0');
+
+        glGetProgramInfoLog(m_programId, infoLogLength, &infoLogLength, infoLog.data());
+        Log::Debug() << "Shader program log: " << std::endl << infoLog;
+    }
+}
+
+bool GlShaderProgram::UpdateState(bool wait)
+{
+    if (m_currentState == State::Loading)
+    {
+        if (!wait && m_pendingDescriptor.wait_for(std::chrono::seconds {0}) != std::future_status::ready)
+            return false;
+
+        try
         {
-            m_uniformsInfo = ProgramInfo::Request(m_programId);
-            m_currentState = State::Ready;
+            StartBuilding(m_pendingDescriptor.get());
         }
-        else
+        catch (const std::exception& exception)
+        {
+            Log::Error() << "Shader program \"" << GetName() << "\" sources loading failed: " << exception.what() << std::endl;
             m_currentState = State::Error;
+        }
+    }
 
-        //log
-        GLint infoLogLength = 0;
-        glGetProgramiv(m_programId, GL_INFO_LOG_LENGTH, &infoLogLength);
-        if (infoLogLength > 0)
-        {
-            std::string infoLog(static_cast<unsigned>(infoLogLength) - 1, '\0');
+    if (m_currentState == State::Linking)
+    {
+        if (!wait && !IsLinkCompleted())
+            return false;
 
-            glGetProgramInfoLog(m_programId, infoLogLength, &infoLogLength, infoLog.data());
-            Log::Debug() << "Shader program log: " << std::endl << infoLog;
-        }
+        FinishLinking();
     }
 
     return m_currentState == State::Ready;
 }
 
+bool GlShaderProgram::TryLinkProgram()
+{
+    return UpdateState(true);
+}
+
+bool GlShaderProgram::PollReady()
+{
+    return UpdateState(false);
+}
+
+bool GlShaderProgram::TryLoadProgramBinary()
+{
+    const auto entry = m_binaryCache->Load(m_binaryKey);
+    if (!entry)
+        return false;
+
+    glProgramBinary(m_programId, entry->BinaryFormat, entry->Data.data(), static_cast<GLsizei>(entry->Data.size()));
+
+    GLint isLinked = 0;
+    glGetProgramiv(m_programId, GL_LINK_STATUS, &isLinked);
+    if (!isLinked)
+    {
+        // driver was updated or binary was produced by another device, so it will be replaced after linking from sources
+        Log::Debug() << "Program binary rejected, falling back to sources" << std::endl;
+        m_binaryCache->Invalidate(m_binaryKey);
+        return false;
+    }
+
+    m_uniformsInfo = ProgramInfo::Request(m_programId);
+    m_currentState = State::Ready;
+    return true;
+}
+
+void GlShaderProgram::StoreProgramBinary()
+{
+    GLint binaryLength = 0;
+    glGetProgramiv(m_programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0)
+        return;
+
+    ProgramBinaryCache::Entry entry {0, std::vector<std::byte>(static_cast<size_t>(binaryLength))};
+
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(m_programId, binaryLength, &binaryLength, &binaryFormat, entry.Data.data());
+    entry.Data.resize(static_cast<size_t>(binaryLength));
+    entry.BinaryFormat = binaryFormat;
+
+    if (!m_binaryCache->Store(m_binaryKey, entry))
+        Log::Warning() << "Failed to store program binary to " << m_binaryCache->GetDirectory() << std::endl;
+}
+
 std::unique_ptr<StructuredBuffer> GlShaderProgram::CreateAssociatedUniformStorage(std::string_view blockName)
 {
     if (!TryLinkProgram())
@@ -193,10 +303,13 @@ std::unique_ptr<StructuredBuffer> GlShaderProgram::CreateAssociatedUniformStorag
     return uniformBuffer;
 }
 
-void GlShaderProgram::Bind()
+bool GlShaderProgram::Bind()
 {
-    if (TryLinkProgram())
-        glUseProgram(m_programId);
+    if (!PollReady())
+        return false;
+
+    glUseProgram(m_programId);
+    return true;
 }
 
 bool GlShaderProgram::IsActive() const noexcept
@@ -1,10 +1,13 @@
 #ifndef AT2_GL_SHADERPROGRAM_H
 #define AT2_GL_SHADERPROGRAM_H
 
+#include <future>
 #include <unordered_map>
 #include "AT2lowlevel.h"
 #include "GlProgramIntrospection.h"
 
+#include <ProgramBinaryCache.h>
+
 namespace AT2::OpenGL
 {
     //TODO: complete immutabilization
@@ -23,7 +26,10 @@ namespace AT2::OpenGL
         };
         using ShaderDescriptor = std::unordered_multimap<ShaderType, std::string>;
 
-        GlShaderProgram(IRenderer& renderer, const ShaderDescriptor& descriptor);
+        // When binaryCache is given, program is restored from the cached binary if possible and stored to it after linking
+        GlShaderProgram(IRenderer& renderer, const ShaderDescriptor& descriptor, const ProgramBinaryCache* binaryCache = nullptr);
+        // Building starts when sources become available, so they could be loaded by a worker thread
+        GlShaderProgram(IRenderer& renderer, std::future<ShaderDescriptor> pendingDescriptor, const ProgramBinaryCache* binaryCache = nullptr);
         ~GlShaderProgram() override;
 
         GlShaderProgram(const GlShaderProgram&) = delete;
@@ -53,10 +59,20 @@ namespace AT2::OpenGL
             std::swap(m_uniformsInfo, rhv.m_uniformsInfo);
             std::swap(m_name, rhv.m_name);
             std::swap(m_currentState, rhv.m_currentState);
+            std::swap(m_pendingDescriptor, rhv.m_pendingDescriptor);
+            std::swap(m_binaryCache, rhv.m_binaryCache);
+            std::swap(m_binaryKey, rhv.m_binaryKey);
         }
 
     //for internal usage
-        void Bind();
+        // Doesn't wait for the program building, returns false if it isn't ready yet
+        bool Bind();
+        // Checks for the building progress without blocking
+        bool PollReady();
+        // Blocks until program is built
+        bool WaitReady() { return TryLinkProgram(); }
+        bool IsReady() const noexcept { return m_currentState == State::Ready; }
+        bool IsPending() const noexcept { return m_currentState == State::Loading || m_currentState == State::Linking; }
         unsigned int GetId() const noexcept { return m_programId; }
         bool IsActive() const noexcept;
 
@@ -65,22 +81,36 @@ namespace AT2::OpenGL
         std::optional<unsigned int> GetUniformBufferLocation(std::string_view name);
 
     protected:
+        // Waits until program is built
         bool TryLinkProgram();
-        
+
+    private:
+        void StartBuilding(const ShaderDescriptor& descriptor);
+        bool UpdateState(bool wait);
+        bool IsLinkCompleted() const;
+        void FinishLinking();
+        bool TryLoadProgramBinary();
+        void StoreProgramBinary();
+
     private:
         IRenderer* m_renderer;
         GLuint m_programId {0};
         std::vector<std::pair<ShaderType, GLuint>> m_shaderIds;
         std::shared_ptr<Introspection::ProgramInfo> m_uniformsInfo;
+        std::future<ShaderDescriptor> m_pendingDescriptor;
 
         str m_name;
 
+        const ProgramBinaryCache* m_binaryCache = nullptr;
+        ProgramBinaryCache::Key m_binaryKey = 0;
+
         enum class State
         {
-            Dirty,
+            Loading,
+            Linking,
             Ready,
             Error
-        } m_currentState = State::Dirty;
+        } m_currentState = State::Linking;
     };
 } // namespace AT2
 
@@ -1,7 +1,5 @@
 #include "GlStateManager.h"
 
-#include <numeric>
-
 #include "AT2lowlevel.h"
 #include "GlBuffer.h"
 #include "GlFrameBuffer.h"
@@ -13,13 +11,18 @@ using namespace AT2;
 using namespace AT2::OpenGL;
 
 
+namespace
+{
+    GLuint GetTextureId(const std::shared_ptr<ITexture>& texture)
+    {
+        return Utils::safe_dereference_cast<const GlTexture&>(texture).GetId();
+    }
+}
+
 GlStateManager::GlStateManager(IVisualizationSystem& renderer)
     : StateManager(renderer)
-	, m_freeTextureSlots(renderer.GetRendererCapabilities().GetMaxNumberOfTextureUnits())
-    , m_activeTextures(renderer.GetRendererCapabilities().GetMaxNumberOfTextureUnits())
+    , m_textureSlots(renderer.GetRendererCapabilities().GetMaxNumberOfTextureUnits())
 {
-    std::iota(m_freeTextureSlots.begin(), m_freeTextureSlots.end(), 0);
-    std::reverse(m_freeTextureSlots.begin(), m_freeTextureSlots.end());
 }
 
 void OpenGL::GlStateManager::ApplyState(RenderState state)
@@ -57,6 +60,10 @@ void OpenGL::GlStateManager::ApplyState(RenderState state)
 
 void OpenGL::GlStateManager::Commit(const std::function<void(IUniformsWriter&)>& writeCommand)
 {
+    // uniforms can't be written without blocking until the program is linked, and it wouldn't be drawn anyway
+    if (!PollActiveProgram())
+        return;
+
     class ImmediateUniformWriter : public IUniformsWriter
     {
     public:
@@ -69,7 +76,7 @@ void OpenGL::GlStateManager::Commit(const std::function<void(IUniformsWriter&)>&
         void Write(std::string_view name, UniformArray value) override { m_activeProgram.SetUniformArray(name, value); }
         void Write(std::string_view name, std::shared_ptr<ITexture> texture) override
         {
-	        m_activeProgram.SetUniform(name, static_cast<int>(m_stateManager.DoBind(std::move(texture))));
+	        m_activeProgram.SetUniform(name, static_cast<int>(m_stateManager.DoBind(texture)));
         }
 
         void Write(std::string_view name, std::shared_ptr<IBuffer> value) override
@@ -85,25 +92,21 @@ void OpenGL::GlStateManager::Commit(const std::function<void(IUniformsWriter&)>&
 
     ImmediateUniformWriter writer {*this};
     writeCommand(writer);
+
+    FlushTextureBindings();
 }
 
-GlStateManager::TextureId OpenGL::GlStateManager::DoBind(std::shared_ptr<ITexture> texture)
+GlStateManager::TextureId OpenGL::GlStateManager::DoBind(const std::shared_ptr<ITexture>& texture)
 {
-    //TODO: use Strategy pattern
     //TODO: release textures with reference count == 1
-    const auto texturesMapper = [this](const std::shared_ptr<ITexture>& texture) {
-        assert(!m_freeTextureSlots.empty());
-
-        const auto textureIndex = m_freeTextureSlots.back();
-        glBindTextureUnit(textureIndex, Utils::safe_dereference_cast<const GlTexture&>(texture).GetId());
-
-        m_freeTextureSlots.pop_back();
-        return std::tuple {textureIndex};
-    };
-
-    const auto textureUnmapper = [this](auto&& kv) { m_freeTextureSlots.push_back(kv.second); };
+    return m_textureSlots.Acquire(texture, GetTextureId).Slot;
+}
 
-	return m_activeTextures.put(texture, texturesMapper, textureUnmapper).second;
+void OpenGL::GlStateManager::FlushTextureBindings()
+{
+    m_textureSlots.FlushDirty([](GLuint firstUnit, std::span<const GLuint> textureIds) {
+        glBindTextureUnits(firstUnit, static_cast<GLsizei>(textureIds.size()), textureIds.data());
+    });
 }
 
 void OpenGL::GlStateManager::DoBind(unsigned int index, const std::shared_ptr<IBuffer>& buffer) 
@@ -118,7 +121,15 @@ void OpenGL::GlStateManager::DoBind(unsigned int index, const std::shared_ptr<IB
 void OpenGL::GlStateManager::DoBind( IShaderProgram& shader )
 {
     auto& glProgram = Utils::safe_dereference_cast<GlShaderProgram&>(&shader);
-    glProgram.Bind();
+    m_pendingProgram = glProgram.Bind() ? nullptr : &glProgram;
+}
+
+bool OpenGL::GlStateManager::PollActiveProgram()
+{
+    if (m_pendingProgram && m_pendingProgram->Bind())
+        m_pendingProgram = nullptr;
+
+    return m_pendingProgram == nullptr;
 }
 
 void OpenGL::GlStateManager::DoBind( IVertexArray& vertexArray )
@@ -133,5 +144,19 @@ void OpenGL::GlStateManager::DoBind( IVertexArray& vertexArray )
 
 std::optional<unsigned> GlStateManager::GetActiveTextureIndex(std::shared_ptr<ITexture> texture) const noexcept
 {
-    return m_activeTextures.find(texture);
+    return m_textureSlots.Find(texture);
+}
+
+void GlStateManager::PinTexture(const std::shared_ptr<ITexture>& texture, bool pinned)
+{
+    if (!texture)
+        return;
+
+    if (pinned)
+    {
+        m_textureSlots.Pin(texture, GetTextureId);
+        FlushTextureBindings();
+    }
+    else
+        m_textureSlots.Unpin(texture);
 }
@@ -2,11 +2,12 @@
 #define GL_STATE_MANAGER_H
 
 #include <StateManager.h>
-#include <lru_cache.h>
+#include <TextureSlotTable.h>
 
 namespace AT2::OpenGL
 {
 class GlTexture;
+class GlShaderProgram;
 
 class GlStateManager final : public StateManager
 {
@@ -18,18 +19,28 @@ public:
 	void Commit(const std::function<void(IUniformsWriter&)>& writer) override;
 
     std::optional<unsigned> GetActiveTextureIndex(std::shared_ptr<ITexture> texture) const noexcept override;
+    void PinTexture(const std::shared_ptr<ITexture>& texture, bool pinned) override;
+
+    // False when active program is still being built (or failed), draws with it should be skipped
+    [[nodiscard]] bool IsActiveProgramReady() const noexcept { return m_pendingProgram == nullptr; }
+    // Binds active program if it's built since the last check
+    bool PollActiveProgram();
+
+    using TextureBindingStatistics = TextureSlotTable<std::shared_ptr<ITexture>, GLuint>::Statistics;
+    [[nodiscard]] const TextureBindingStatistics& GetTextureBindingStatistics() const noexcept { return m_textureSlots.GetStatistics(); }
 
 private:
     using TextureId = unsigned int;
-    TextureId DoBind(std::shared_ptr<ITexture> texture);
+    TextureId DoBind(const std::shared_ptr<ITexture>& texture);
+    void FlushTextureBindings();
     void DoBind(unsigned int index, const std::shared_ptr<IBuffer>& buffer);
     void DoBind(IShaderProgram& shader) override;
     void DoBind(IVertexArray& vertexArray) override;
 
 
 private:
-    std::vector<TextureId> m_freeTextureSlots;
-    lru_cache<std::shared_ptr<ITexture>, TextureId> m_activeTextures;
+    TextureSlotTable<std::shared_ptr<ITexture>, GLuint> m_textureSlots;
+    GlShaderProgram* m_pendingProgram = nullptr; // kept alive by the active shader reference
 };
 
 };
@@ -33,6 +33,21 @@ void GlTexture::ReadChannelSizes()
     glGetInternalformativ(target, m_internalFormat, GL_INTERNALFORMAT_STENCIL_SIZE, 1, &m_channelSizes.stencil);
     glGetInternalformativ(target, m_internalFormat, GL_INTERNALFORMAT_SHARED_SIZE, 1, &m_channelSizes.shared);
 
+    GLint isCompressed = GL_FALSE;
+    glGetInternalformativ(target, m_internalFormat, GL_TEXTURE_COMPRESSED, 1, &isCompressed);
+    if (isCompressed == GL_TRUE)
+    {
+        // channel sizes are reported for decompressed data
+        GLint blockWidth = 1, blockHeight = 1, blockSize = 0;
+        glGetInternalformativ(target, m_internalFormat, GL_TEXTURE_COMPRESSED_BLOCK_WIDTH, 1, &blockWidth);
+        glGetInternalformativ(target, m_internalFormat, GL_TEXTURE_COMPRESSED_BLOCK_HEIGHT, 1, &blockHeight);
+        glGetInternalformativ(target, m_internalFormat, GL_TEXTURE_COMPRESSED_BLOCK_SIZE, 1, &blockSize);
+
+        m_dataSize = static_cast<size_t>((m_size.x + blockWidth - 1) / blockWidth) * ((m_size.y + blockHeight - 1) / blockHeight) *
+            m_size.z * blockSize;
+        return;
+    }
+
     m_dataSize = static_cast<size_t>(m_size.x) * m_size.y * m_size.z * m_channelSizes.InBytes();
 }
 
@@ -96,7 +111,8 @@ GlTexture::GlTexture(Texture flavor, GLint internalFormat) : m_flavor(flavor), m
                 SetSamplingMode(TextureSamplingParams::Uniform(TextureSamplingMode::Linear));
             },
             [&](const TextureCube& texture) {
-                m_size = glm::ivec3 {texture.getSize(), 1};
+                // faces are layers for SubImage3D
+                m_size = glm::ivec3 {texture.getSize(), 6};
                 glTextureStorage2D(m_id, static_cast<GLint>(texture.getLevels()), m_internalFormat, m_size.x, m_size.y);
 
                 SetWrapMode( TextureWrapParams::Uniform(TextureWrapMode::ClampToEdge));
@@ -123,6 +139,43 @@ GlTexture::GlTexture(Texture flavor, GLint internalFormat) : m_flavor(flavor), m
     ReadChannelSizes();
 }
 
+GlTexture::GlTexture(std::shared_ptr<GlTexture> viewedTexture) :
+    m_flavor(viewedTexture->m_flavor),
+    m_internalFormat(viewedTexture->m_internalFormat),
+    m_size(viewedTexture->m_size),
+    m_viewedTexture(std::move(viewedTexture))
+{
+    // glTextureView requires a name which has never been bound, so glCreateTextures isn't suitable here
+    glGenTextures(1, &m_id);
+
+    GLint numLevels = 1;
+    glGetTextureParameteriv(m_viewedTexture->m_id, GL_TEXTURE_IMMUTABLE_LEVELS, &numLevels);
+
+    using namespace std;
+    const auto numLayers = visit(
+        []<typename T>(const T& texture) -> GLuint {
+            if constexpr (is_same_v<T, Texture1DArray>)
+                return texture.getSize().y;
+            else if constexpr (is_same_v<T, Texture2DArray> || is_same_v<T, Texture2DMultisampleArray> || is_same_v<T, TextureCubeArray>)
+                return texture.getSize().z;
+            else if constexpr (is_same_v<T, TextureCube>)
+                return 6;
+            else
+                return 1;
+        },
+        m_flavor);
+
+    glTextureView(m_id, GetTarget(), m_viewedTexture->m_id, m_internalFormat, 0, static_cast<GLuint>(numLevels), 0, numLayers);
+
+    SetWrapMode(m_viewedTexture->m_wrapParams);
+    SetSamplingMode(m_viewedTexture->m_sampling_params);
+    if (m_viewedTexture->m_anisotropy != 1.0f)
+        SetAnisotropy(m_viewedTexture->m_anisotropy);
+
+    m_channelSizes = m_viewedTexture->m_channelSizes;
+    m_dataSize = m_viewedTexture->m_dataSize;
+}
+
 GlTexture::~GlTexture()
 {
     glDeleteTextures(1, &m_id);
@@ -208,11 +261,20 @@ void GlTexture::SubImage2D(glm::uvec2 _offset, glm::uvec2 _size, glm::u32 _level
 
     using namespace std;
 
+    // compressed data is uploaded as is, it's format must match texture's internal format
+    const bool isCompressed = dataFormat.Compression != BlockCompression::None;
+    const auto dataLength = static_cast<GLsizei>(GetImageDataLength(dataFormat, {_size, 1}));
+
     visit(
-        [=, id=m_id]<typename T>(T) {
+        [=, id=m_id, internalFormat=m_internalFormat]<typename T>(T) {
             if constexpr (is_same_v<T, Texture1DArray> || is_same_v<T, Texture2D>)
-                glTextureSubImage2D(id, level, offset.x, offset.y, size.x, size.y, externalFormat,
-                                       externalType, data);
+            {
+                if (isCompressed)
+                    glCompressedTextureSubImage2D(id, level, offset.x, offset.y, size.x, size.y, internalFormat, dataLength, data);
+                else
+                    glTextureSubImage2D(id, level, offset.x, offset.y, size.x, size.y, externalFormat,
+                                           externalType, data);
+            }
             else
                 throw AT2NotImplementedException("SubImage2D supports only Texture1DArray, Texture2D, TextureCube");
         },
@@ -233,20 +295,21 @@ void GlTexture::SubImage3D(glm::uvec3 _offset, glm::uvec3 _size, glm::u32 _level
         maxCoord.x > m_size.x || maxCoord.y > m_size.y || maxCoord.z > m_size.z)
         throw AT2TextureException( "Some SubImage texels out of texture bounds");
 
+    const bool isCompressed = dataFormat.Compression != BlockCompression::None;
+    const auto dataLength = static_cast<GLsizei>(GetImageDataLength(dataFormat, _size));
+
     using namespace std;
     visit(
-        [=, id=m_id]<typename T>(T) {
+        [=, id=m_id, internalFormat=m_internalFormat]<typename T>(T) {
             if constexpr (is_same_v<T, Texture2DArray> || is_same_v<T, Texture3D> || is_same_v<T, TextureCubeArray> ||
                           is_same_v<T, TextureCube>)
             {
-                if constexpr (is_same_v<T, TextureCube>)
-                {
-                    if (size.z > 5)
-                        throw AT2Exception("GlTexture:SubImage3D cube map face must be in range [0-5]");
-                }
-
-                glTextureSubImage3D(id, level, offset.x, offset.y, offset.z, size.x, size.y, size.z, externalFormat,
-                                    externalType, data);
+                if (isCompressed)
+                    glCompressedTextureSubImage3D(id, level, offset.x, offset.y, offset.z, size.x, size.y, size.z, internalFormat,
+                                                  dataLength, data);
+                else
+                    glTextureSubImage3D(id, level, offset.x, offset.y, offset.z, size.x, size.y, size.z, externalFormat,
+                                        externalType, data);
             }
             else
                 throw AT2NotImplementedException("SubImage3D supports only Texture2DArray, Texture3D");
@@ -12,6 +12,8 @@ namespace AT2::OpenGL
         NON_COPYABLE_OR_MOVABLE(GlTexture)
 
         GlTexture(Texture flavor, GLint internalFormat);
+        // Texture view: shares storage with viewedTexture (and keeps it alive), but has it's own sampling state
+        explicit GlTexture(std::shared_ptr<GlTexture> viewedTexture);
         ~GlTexture() override;
 
         void BindAsImage(unsigned int unit, glm::u32 level, glm::u32 layer, bool isLayered,
@@ -77,6 +79,8 @@ namespace AT2::OpenGL
             }
         } m_channelSizes;
         size_t m_dataSize {0};
+
+        std::shared_ptr<GlTexture> m_viewedTexture;
     };
 
 } // namespace AT2::OpenGL
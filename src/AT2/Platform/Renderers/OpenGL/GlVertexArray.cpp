@@ -68,7 +68,11 @@ void GlVertexArray::SetAttributeBinding(unsigned int attributeIndex, std::shared
         case BufferDataType::UShort:
         case BufferDataType::Int:
         case BufferDataType::UInt:
-            glVertexArrayAttribIFormat(m_id, attributeIndex, static_cast<GLint>(binding.Count), platformDataType, 0);
+            // normalized integers are read by shaders as floats
+            if (binding.IsNormalized)
+                glVertexArrayAttribFormat(m_id, attributeIndex, static_cast<GLint>(binding.Count), platformDataType, GL_TRUE, 0);
+            else
+                glVertexArrayAttribIFormat(m_id, attributeIndex, static_cast<GLint>(binding.Count), platformDataType, 0);
             break;
 
         default:
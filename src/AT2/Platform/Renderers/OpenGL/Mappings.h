@@ -54,6 +54,7 @@ namespace AT2::Mappings
         case BufferDataType::Float: return GL_FLOAT;
         case BufferDataType::Double: return GL_DOUBLE;
         case BufferDataType::Fixed: return GL_FIXED;
+        case BufferDataType::Int2101010Rev: return GL_INT_2_10_10_10_REV;
         }
 
         assert(false);
@@ -67,6 +68,7 @@ namespace AT2::Mappings
         case VertexBufferType::ArrayBuffer: return GL_ARRAY_BUFFER;
         case VertexBufferType::IndexBuffer: return GL_ELEMENT_ARRAY_BUFFER;
         case VertexBufferType::UniformBuffer: return GL_UNIFORM_BUFFER;
+        case VertexBufferType::IndirectBuffer: return GL_DRAW_INDIRECT_BUFFER;
         }
 
         assert(false);
@@ -11,6 +11,7 @@ namespace AT2::Keys
     extern const int Key_L = SDL_SCANCODE_L;
     extern const int Key_R = SDL_SCANCODE_R;
     extern const int Key_M = SDL_SCANCODE_M;
+    extern const int Key_T = SDL_SCANCODE_T;
     extern const int Key_LShift = SDL_SCANCODE_LSHIFT;
     extern const int Key_Escape = SDL_SCANCODE_ESCAPE;
     extern const int Key_Equal = SDL_SCANCODE_EQUALS;
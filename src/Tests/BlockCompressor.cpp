@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/Resources/BlockCompressor.h>
+#include <AT2/Core/ThreadPool.h>
+
+#include <cstring>
+
+using namespace AT2;
+using namespace AT2::Resources;
+
+TEST(BlockCompressor, PadsPartialBlocks)
+{
+    const std::vector texels(5 * 3, glm::u8vec4 {255, 0, 0, 255});
+
+    const auto bc1 = BlockCompressor::Compress(texels, {5, 3}, BlockCompression::BC1);
+    ASSERT_EQ(bc1.size(), GetImageDataLength({TextureLayout::RGBA, BufferDataType::UByte, false, BlockCompression::BC1}, {5, 3, 1}));
+    ASSERT_EQ(bc1.size(), 2 * 8);
+
+    // solid red block has pure red endpoint in RGB565
+    std::uint16_t color0 = 0;
+    std::memcpy(&color0, bc1.data(), sizeof(color0));
+    ASSERT_EQ(color0, 0xF800);
+    ASSERT_TRUE(std::equal(bc1.begin(), bc1.begin() + 8, bc1.begin() + 8));
+
+    ASSERT_EQ(BlockCompressor::Compress(texels, {5, 3}, BlockCompression::BC3).size(), 2 * 16);
+    ASSERT_EQ(BlockCompressor::Compress(texels, {5, 3}, BlockCompression::BC4).size(), 2 * 8);
+    ASSERT_EQ(BlockCompressor::Compress(texels, {5, 3}, BlockCompression::BC5).size(), 2 * 16);
+
+    ASSERT_FALSE(BlockCompressor::IsSupported(BlockCompression::BC7));
+    ASSERT_THROW((void)BlockCompressor::Compress(texels, {5, 3}, BlockCompression::BC7), AT2NotImplementedException);
+    ASSERT_THROW((void)BlockCompressor::Compress(texels, {4, 4}, BlockCompression::BC1), AT2TextureException);
+}
+
+TEST(BlockCompressor, ParallelResultIsTheSame)
+{
+    std::vector<glm::u8vec4> texels(256 * 256);
+    for (size_t i = 0; i < texels.size(); ++i)
+        texels[i] = {i % 256, (i / 256) % 256, (i * 13) % 256, (i * 5) % 256};
+
+    ThreadPool threadPool {4};
+    ASSERT_EQ(BlockCompressor::Compress(texels, {256, 256}, BlockCompression::BC3),
+              BlockCompressor::Compress(texels, {256, 256}, BlockCompression::BC3, &threadPool));
+}
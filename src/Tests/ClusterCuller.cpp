@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ClusterCuller.h>
+#include <AT2/Core/ThreadPool.h>
+
+#include "TestUtils.h"
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+namespace
+{
+    // Row of single triangle meshlets at XY plane facing +Z, the first one is at the origin and every next is 10 units right
+    MeshletSet MakeRow(size_t count)
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto x = static_cast<float>(i) * 10.0f;
+            const auto first = static_cast<uint32_t>(positions.size());
+            positions.insert(positions.end(), {glm::vec3 {x - 1.0f, -1.0f, 0.0f}, glm::vec3 {x + 1.0f, -1.0f, 0.0f}, glm::vec3 {x, 1.0f, 0.0f}});
+            indices.insert(indices.end(), {first, first + 1, first + 2});
+        }
+
+        MeshletSet set;
+        set.Append(MeshletSet::Build(indices, positions, MeshletSet::DefaultMaxVertices, 1),
+                   MeshChunk {Primitives::Triangles {}, 0, static_cast<unsigned int>(indices.size())});
+        return set;
+    }
+} // namespace
+
+TEST(ClusterCuller, CullsByFrustum)
+{
+    const auto row = MakeRow(7);
+    const ClusterCuller culler {LookFrom({0.0f, 0.0f, 20.0f}, {0.0f, 0.0f, 0.0f}), Projection};
+
+    // 90 degrees field of view sees 20 units to the sides at the row distance
+    std::vector<uint32_t> visible;
+    const auto statistics = culler.Cull(row, glm::mat4 {1.0f}, visible);
+    EXPECT_EQ(visible, (std::vector<uint32_t> {0, 1, 2}));
+    EXPECT_EQ(statistics.NumClusters, 7);
+    EXPECT_EQ(statistics.NumFrustumCulled, 4);
+    EXPECT_EQ(statistics.NumBackfaceCulled, 0);
+    EXPECT_EQ(statistics.GetNumVisible(), 3);
+
+    // instance moved to the left
+    visible.clear();
+    (void)culler.Cull(row, glm::translate(glm::mat4 {1.0f}, {-30.0f, 0.0f, 0.0f}), visible);
+    EXPECT_EQ(visible, (std::vector<uint32_t> {1, 2, 3, 4, 5}));
+}
+
+TEST(ClusterCuller, CullsBackFaces)
+{
+    const auto row = MakeRow(3);
+
+    std::vector<uint32_t> visible;
+    const ClusterCuller behindCuller {LookFrom({10.0f, 0.0f, -20.0f}, {10.0f, 0.0f, 0.0f}), Projection};
+    const auto statistics = behindCuller.Cull(row, glm::mat4 {1.0f}, visible);
+    EXPECT_TRUE(visible.empty());
+    EXPECT_EQ(statistics.NumBackfaceCulled, 3);
+
+    // the instance is turned to the camera
+    (void)behindCuller.Cull(row, glm::rotate(glm::translate(glm::mat4 {1.0f}, {20.0f, 0.0f, 0.0f}), glm::radians(180.0f), {0.0f, 1.0f, 0.0f}), visible);
+    EXPECT_EQ(visible.size(), 3);
+
+    // triangles seen edge-on aren't culled
+    visible.clear();
+    (void)ClusterCuller {LookFrom({-30.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}), Projection}.Cull(row, glm::mat4 {1.0f}, visible);
+    EXPECT_EQ(visible.size(), 3);
+}
+
+TEST(ClusterCuller, KeepsBackFacesOfMirroredAndOrthographic)
+{
+    const auto row = MakeRow(3);
+    const auto behind = LookFrom({10.0f, 0.0f, -20.0f}, {10.0f, 0.0f, 0.0f});
+
+    std::vector<uint32_t> visible;
+    (void)ClusterCuller {behind, Projection}.Cull(row, glm::scale(glm::mat4 {1.0f}, {1.0f, -1.0f, 1.0f}), visible);
+    EXPECT_EQ(visible.size(), 3);
+
+    visible.clear();
+    (void)ClusterCuller {behind, glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, 0.1f, 100.0f)}.Cull(row, glm::mat4 {1.0f}, visible);
+    EXPECT_EQ(visible.size(), 3);
+}
+
+TEST(ClusterCuller, BuildsCommandsOfInstances)
+{
+    const auto row = MakeRow(7);
+    std::vector<ClusterCuller::Instance> instances;
+    for (int i = 0; i < 64; ++i)
+        instances.push_back({&row, glm::translate(glm::mat4 {1.0f}, {-10.0f * static_cast<float>(i % 8), 0.0f, 0.0f})});
+    instances.push_back({nullptr});
+
+    ClusterCuller culler {LookFrom({0.0f, 0.0f, 20.0f}, {0.0f, 0.0f, 0.0f}), Projection};
+    DrawBatch batch;
+    const auto statistics = culler.Cull(instances, batch);
+    EXPECT_EQ(statistics.NumClusters, 64 * 7);
+
+    // commands don't refer to the instances, visible meshlets of every instance are adjacent, so they become one command
+    const auto commands = batch.GetCommands();
+    ASSERT_EQ(commands.size(), 64);
+    size_t numVisibleIndices = 0;
+    for (const auto& command : commands)
+    {
+        EXPECT_EQ(command.BaseInstance, 0);
+        numVisibleIndices += command.Count;
+    }
+    EXPECT_EQ(numVisibleIndices, statistics.GetNumVisible() * 3);
+
+    ThreadPool threadPool {4};
+    DrawBatch parallelBatch;
+    const auto parallelStatistics = culler.Cull(instances, parallelBatch, &threadPool);
+    EXPECT_EQ(parallelStatistics.GetNumVisible(), statistics.GetNumVisible());
+    ASSERT_EQ(parallelBatch.GetCommands().size(), commands.size());
+    for (size_t i = 0; i < commands.size(); ++i)
+    {
+        EXPECT_EQ(parallelBatch.GetCommands()[i].FirstIndex, commands[i].FirstIndex);
+        EXPECT_EQ(parallelBatch.GetCommands()[i].Count, commands[i].Count);
+    }
+}
@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+
+#include <AT2/AT2_exceptions.hpp>
+#include <AT2/Core/Resources/CookedScene.h>
+#include <AT2/Core/Resources/CookedSceneLoader.h>
+
+#include "FakeResources.h"
+#include "TestUtils.h"
+
+#include <cstring>
+
+using namespace AT2;
+using namespace AT2::Resources;
+using namespace AT2::Tests;
+
+namespace
+{
+    template <typename T>
+    std::vector<T> ReadValues(const CookedScene& scene, CookedScene::Range range)
+    {
+        const auto data = scene.GetData(range);
+        std::vector<T> result(data.size() / sizeof(T));
+        std::memcpy(result.data(), data.data(), data.size());
+        return result;
+    }
+
+    // Two nodes with a mesh of two submeshes, a skin and an animation
+    CookedScene MakeScene()
+    {
+        CookedScene scene;
+
+        const std::vector<float> vertices {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0};
+        const std::vector<std::uint16_t> indices {0, 1, 2, 2, 1, 3};
+        const std::vector<float> keys {0.0f, 1.0f};
+        const std::vector<glm::vec3> translations {{0, 0, 0}, {0, 1, 0}};
+        const std::vector<glm::mat4> inverseBindMatrices {glm::mat4 {1.0f}, glm::mat4 {2.0f}};
+
+        auto& mesh = scene.Meshes.emplace_back();
+        mesh.Name = "mesh";
+        mesh.Attributes.push_back({1u, BufferBindingParams {BufferDataType::Float, 3, 12}});
+        mesh.Attributes.push_back({3u, BufferBindingParams {BufferDataType::Int2101010Rev, 4, 12, 8, true}});
+        mesh.Vertices = scene.AppendData(std::as_bytes(std::span {vertices}));
+        mesh.IndexType = BufferDataType::UShort;
+        mesh.Indices = scene.AppendData(std::as_bytes(std::span {indices}));
+        mesh.Materials = {0};
+        mesh.SubMeshes.push_back({"first", 0, {MeshChunk {Primitives::Triangles {}, 0, 3, 0}}, {{0.5f, {MeshChunk {Primitives::Triangles {}, 3, 3, 0}}}}, {}});
+        mesh.SubMeshes.push_back({"second", 0, {MeshChunk {Primitives::Patches {4}, 3, 3, -1}, MeshChunk {Primitives::LineStrip {}, 0, 2}}, {}, {}});
+        mesh.SubMeshes.front().Meshlets.push_back({0, 3, 0, glm::vec3 {0.5f}, 1.0f, glm::vec3 {0.0f, 0.0f, 1.0f}, 0.25f});
+
+        scene.Textures.emplace_back().Path = "textures/albedo.png";
+        auto& embeddedTexture = scene.Textures.emplace_back();
+        embeddedTexture.EmbeddedData = scene.AppendData(std::as_bytes(std::span {keys}));
+        embeddedTexture.Sampler = TextureCache::SamplerState {TextureWrapParams::Uniform(TextureWrapMode::ClampToEdge),
+                                                              TextureSamplingParams::Uniform(TextureSamplingMode::Nearest, true)};
+
+        scene.Materials.push_back({{{"u_texAlbedo", 0, std::nullopt}, {"u_texNormalMap", -1, glm::vec4 {0.5f, 0.5f, 1.0f, 1.0f}}}});
+
+        auto& root = scene.Nodes.emplace_back();
+        root.Name = "root";
+        auto& child = scene.Nodes.emplace_back();
+        child.Name = "child";
+        child.Parent = 0;
+        child.Transform = glm::mat4 {3.0f};
+        child.Meshes.push_back({0, {1, 0}});
+        child.Skin = 0;
+
+        scene.Skins.push_back({scene.AppendData(std::as_bytes(std::span {inverseBindMatrices})), {1}});
+
+        auto& animation = scene.Animations.emplace_back();
+        animation.Name = "move";
+        animation.Tracks.push_back({1, CookedScene::TrackTarget::Translation, CookedScene::Interpolation::Step,
+                                    scene.AppendData(std::as_bytes(std::span {keys})),
+                                    scene.AppendData(std::as_bytes(std::span {translations}))});
+
+        return scene;
+    }
+} // namespace
+
+TEST(CookedScene, AlignsAppendedData)
+{
+    CookedScene scene;
+    const std::array<std::byte, 3> data {std::byte {1}, std::byte {2}, std::byte {3}};
+
+    const auto first = scene.AppendData(data);
+    const auto second = scene.AppendData(data);
+    EXPECT_EQ(first.Offset, 0u);
+    EXPECT_EQ(second.Offset, CookedScene::DataAlignment);
+    EXPECT_EQ(second.Size, data.size());
+    EXPECT_TRUE(std::ranges::equal(scene.GetData(second), data));
+
+    EXPECT_THROW((void)scene.GetData({second.Offset, 4}), AT2IOException);
+    EXPECT_THROW((void)scene.GetData({100, 1}), AT2IOException);
+}
+
+TEST(CookedScene, SerializationRoundTrip)
+{
+    const auto original = MakeScene();
+    const auto file = std::make_shared<std::vector<std::byte>>(original.Serialize());
+
+    const auto scene = CookedScene::Deserialize(*file, file);
+    EXPECT_EQ(scene.GetDataOwner(), file);
+    EXPECT_TRUE(std::ranges::equal(scene.GetData(), original.GetData()));
+    // data blob is aligned within the file, so it could be referenced directly
+    EXPECT_EQ((scene.GetData().data() - file->data()) % CookedScene::DataAlignment, 0u);
+
+    ASSERT_EQ(scene.Meshes.size(), 1u);
+    const auto& mesh = scene.Meshes[0];
+    EXPECT_EQ(mesh.Name, "mesh");
+    ASSERT_EQ(mesh.Attributes.size(), 2u);
+    EXPECT_EQ(mesh.Attributes[1].AttributeIndex, 3u);
+    EXPECT_EQ(mesh.Attributes[1].BindingParams.Type, BufferDataType::Int2101010Rev);
+    EXPECT_EQ(mesh.Attributes[1].BindingParams.Count, 4);
+    EXPECT_EQ(mesh.Attributes[1].BindingParams.Stride, 12u);
+    EXPECT_EQ(mesh.Attributes[1].BindingParams.Offset, 8u);
+    EXPECT_TRUE(mesh.Attributes[1].BindingParams.IsNormalized);
+    EXPECT_EQ(mesh.IndexType, BufferDataType::UShort);
+    EXPECT_EQ(ReadValues<std::uint16_t>(scene, mesh.Indices), (std::vector<std::uint16_t> {0, 1, 2, 2, 1, 3}));
+    EXPECT_EQ(mesh.Materials, std::vector<std::uint32_t> {0});
+
+    ASSERT_EQ(mesh.SubMeshes.size(), 2u);
+    ASSERT_EQ(mesh.SubMeshes[0].Lods.size(), 1u);
+    EXPECT_EQ(mesh.SubMeshes[0].Lods[0].Error, 0.5f);
+    ASSERT_EQ(mesh.SubMeshes[0].Lods[0].Chunks.size(), 1u);
+    EXPECT_EQ(mesh.SubMeshes[0].Lods[0].Chunks[0].StartElement, 3u);
+    EXPECT_TRUE(mesh.SubMeshes[1].Lods.empty());
+    ASSERT_EQ(mesh.SubMeshes[0].Meshlets.size(), 1u);
+    EXPECT_EQ(mesh.SubMeshes[0].Meshlets[0].Count, 3u);
+    EXPECT_EQ(mesh.SubMeshes[0].Meshlets[0].ConeCutoff, 0.25f);
+    EXPECT_TRUE(mesh.SubMeshes[1].Meshlets.empty());
+
+    const auto& chunks = mesh.SubMeshes[1].Chunks;
+    EXPECT_EQ(mesh.SubMeshes[1].Name, "second");
+    ASSERT_EQ(chunks.size(), 2u);
+    ASSERT_TRUE(std::holds_alternative<Primitives::Patches>(chunks[0].Type));
+    EXPECT_EQ(std::get<Primitives::Patches>(chunks[0].Type).NumControlPoints, 4);
+    EXPECT_EQ(chunks[0].StartElement, 3u);
+    EXPECT_EQ(chunks[0].BaseVertex, -1);
+    EXPECT_TRUE(std::holds_alternative<Primitives::LineStrip>(chunks[1].Type));
+    EXPECT_EQ(chunks[1].Count, 2u);
+
+    ASSERT_EQ(scene.Textures.size(), 2u);
+    EXPECT_EQ(scene.Textures[0].Path, "textures/albedo.png");
+    EXPECT_FALSE(scene.Textures[0].Sampler.has_value());
+    EXPECT_EQ(scene.Textures[1].Sampler, original.Textures[1].Sampler);
+    EXPECT_EQ(scene.Textures[1].EmbeddedData.Offset, original.Textures[1].EmbeddedData.Offset);
+
+    ASSERT_EQ(scene.Materials.size(), 1u);
+    ASSERT_EQ(scene.Materials[0].Textures.size(), 2u);
+    EXPECT_EQ(scene.Materials[0].Textures[0].Texture, 0);
+    EXPECT_FALSE(scene.Materials[0].Textures[0].Fallback.has_value());
+    EXPECT_EQ(scene.Materials[0].Textures[1].UniformName, "u_texNormalMap");
+    EXPECT_EQ(scene.Materials[0].Textures[1].Fallback, (glm::vec4 {0.5f, 0.5f, 1.0f, 1.0f}));
+
+    ASSERT_EQ(scene.Nodes.size(), 2u);
+    EXPECT_EQ(scene.Nodes[1].Name, "child");
+    EXPECT_EQ(scene.Nodes[1].Parent, 0);
+    EXPECT_EQ(scene.Nodes[1].Transform, glm::mat4 {3.0f});
+    EXPECT_EQ(scene.Nodes[1].Skin, 0);
+    ASSERT_EQ(scene.Nodes[1].Meshes.size(), 1u);
+    EXPECT_EQ(scene.Nodes[1].Meshes[0].SubMeshes, (std::vector<std::uint32_t> {1, 0}));
+
+    ASSERT_EQ(scene.Skins.size(), 1u);
+    EXPECT_EQ(ReadValues<glm::mat4>(scene, scene.Skins[0].InverseBindMatrices)[1], glm::mat4 {2.0f});
+
+    ASSERT_EQ(scene.Animations.size(), 1u);
+    ASSERT_EQ(scene.Animations[0].Tracks.size(), 1u);
+    const auto& track = scene.Animations[0].Tracks[0];
+    EXPECT_EQ(track.Node, 1u);
+    EXPECT_EQ(track.Mode, CookedScene::Interpolation::Step);
+    EXPECT_EQ(ReadValues<glm::vec3>(scene, track.Values)[1], (glm::vec3 {0, 1, 0}));
+}
+
+TEST(CookedScene, RejectsOtherVersionsAndTruncatedFiles)
+{
+    const auto file = MakeScene().Serialize();
+
+    auto otherVersion = file;
+    const auto version = CookedScene::Version + 1;
+    std::memcpy(otherVersion.data() + 4, &version, sizeof(version));
+    EXPECT_THROW((void)CookedScene::Deserialize(otherVersion, nullptr), AT2IOException);
+
+    auto otherMagic = file;
+    otherMagic[0] = std::byte {'X'};
+    EXPECT_THROW((void)CookedScene::Deserialize(otherMagic, nullptr), AT2IOException);
+
+    for (const size_t size : {size_t {0}, size_t {16}, size_t {40}, file.size() / 2, file.size() - 1})
+        EXPECT_THROW((void)CookedScene::Deserialize(std::span {file}.first(size), nullptr), AT2IOException) << "size " << size;
+}
+
+TEST(CookedScene, RejectsUnknownEnumerationValues)
+{
+    const auto expectRejected = [](auto&& corrupt) {
+        auto scene = MakeScene();
+        corrupt(scene);
+        EXPECT_THROW((void)CookedScene::Deserialize(scene.Serialize(), nullptr), AT2IOException);
+    };
+
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].IndexType = BufferDataType::Float; });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].Attributes[0].BindingParams.Type = static_cast<BufferDataType>(100); });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].SubMeshes[1].Chunks.push_back({Primitives::Patches {0}, 0, 3}); });
+    expectRejected([](CookedScene& scene) { scene.Textures[1].Sampler->Wrap.WrapS = static_cast<TextureWrapMode>(10); });
+    expectRejected([](CookedScene& scene) { scene.Animations[0].Tracks[0].Target = static_cast<CookedScene::TrackTarget>(3); });
+    expectRejected([](CookedScene& scene) { scene.Animations[0].Tracks[0].Mode = static_cast<CookedScene::Interpolation>(3); });
+}
+
+TEST(CookedScene, RejectsRangesOutOfBuffers)
+{
+    const auto expectRejected = [](auto&& corrupt) {
+        auto scene = MakeScene();
+        scene.Materials[0].Textures.clear();
+        corrupt(scene);
+
+        FakeVisualizationSystem renderer;
+        EXPECT_THROW((void)CookedSceneLoader::BuildScene(renderer, scene), AT2IOException);
+    };
+
+    expectRejected([](CookedScene& scene) { scene.Nodes[1].Meshes[0].SubMeshes.push_back(2); });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].SubMeshes[0].MaterialIndex = 1; });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].SubMeshes[0].Chunks[0].Count = 7; });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].SubMeshes[0].Lods[0].Chunks[0].BaseVertex = 1; });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].SubMeshes[1].Chunks[0].BaseVertex = -2; });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].SubMeshes[0].Meshlets[0].FirstIndex = 4; });
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].Attributes[1].BindingParams.Offset = 10; });
+    // without indices chunks refer to the 4 vertices directly
+    expectRejected([](CookedScene& scene) { scene.Meshes[0].IndexType.reset(); });
+}
+
+TEST(CookedScene, TexturePathsAreRelativeToFile)
+{
+    const TemporaryDirectory directory {"at2_cooked_scene_test"};
+
+    auto scene = MakeScene();
+    scene.Textures[0].Path = directory.GetPath() / "textures" / "albedo.png";
+    scene.Save(directory.GetPath() / "scene.at2scene");
+
+    const auto loaded = CookedScene::Load(directory.GetPath() / "scene.at2scene");
+    EXPECT_EQ(loaded.Textures[0].Path, (directory.GetPath() / "textures" / "albedo.png").lexically_normal());
+    EXPECT_TRUE(loaded.Textures[1].Path.empty());
+    EXPECT_TRUE(std::ranges::equal(loaded.GetData(), scene.GetData()));
+    EXPECT_FALSE(std::filesystem::exists(directory.GetPath() / "scene.at2scene.tmp"));
+}
+
+TEST(CookedScene, BuildsOccludersOfStaticMeshes)
+{
+    auto scene = MakeScene();
+    scene.Materials[0].Textures.clear();
+
+    FakeVisualizationSystem renderer;
+    const auto skinnedRoot = CookedSceneLoader::BuildScene(renderer, scene);
+    EXPECT_TRUE(skinnedRoot->GetChild<Scene::Node>(0).getComponents<Scene::OccluderComponent>().empty());
+
+    scene.Nodes[1].Skin = -1;
+    const auto root = CookedSceneLoader::BuildScene(renderer, scene);
+    const auto occluders = root->GetChild<Scene::Node>(0).getComponents<Scene::OccluderComponent>();
+
+    // only the first submesh is made of triangles, it's coarsest level is moved inward by the level error
+    ASSERT_EQ(occluders.size(), 1u);
+    const auto& occluder = *occluders.front()->getOccluder();
+    EXPECT_EQ(occluder.Indices, (std::vector<uint32_t> {0, 1, 2}));
+    ASSERT_EQ(occluder.Positions.size(), 3u);
+    EXPECT_EQ(occluder.Positions[0], (glm::vec3 {0.0f, 1.0f, -0.5f}));
+    EXPECT_EQ(occluder.Positions[2], (glm::vec3 {1.0f, 1.0f, -0.5f}));
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/DrawBatch.h>
+
+using namespace AT2;
+
+TEST(DrawBatch, MergesAdjacentIndexRanges)
+{
+    DrawBatch batch;
+    batch.Add(MeshChunk {Primitives::Triangles {}, 0, 30, 0});
+    batch.Add(MeshChunk {Primitives::Triangles {}, 30, 60, 0});
+    batch.Add(MeshChunk {Primitives::Triangles {}, 120, 12, 0}); // gap before it
+
+    ASSERT_EQ(batch.GetRuns().size(), 1);
+    ASSERT_EQ(batch.GetCommands().size(), 2);
+
+    const auto& merged = batch.GetCommands()[0];
+    ASSERT_EQ(merged.FirstIndex, 0);
+    ASSERT_EQ(merged.Count, 90);
+    ASSERT_EQ(batch.GetCommands()[1].FirstIndex, 120);
+}
+
+TEST(DrawBatch, KeepsDifferentBaseVerticesSeparate)
+{
+    DrawBatch batch;
+    batch.Add(MeshChunk {Primitives::Triangles {}, 0, 30, 0});
+    batch.Add(MeshChunk {Primitives::Triangles {}, 30, 30, 100});
+
+    ASSERT_EQ(batch.GetRuns().size(), 1);
+    ASSERT_EQ(batch.GetCommands().size(), 2);
+    ASSERT_EQ(batch.GetCommands()[1].BaseVertex, 100);
+}
+
+TEST(DrawBatch, SplitsRunsByPrimitiveType)
+{
+    DrawBatch batch;
+    batch.Add(MeshChunk {Primitives::Triangles {}, 0, 3});
+    batch.Add(MeshChunk {Primitives::Lines {}, 3, 2});
+    batch.Add(MeshChunk {Primitives::Patches {4}, 5, 4});
+    batch.Add(MeshChunk {Primitives::Patches {3}, 9, 3});
+
+    const auto runs = batch.GetRuns();
+    ASSERT_EQ(runs.size(), 4);
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        ASSERT_EQ(runs[i].FirstCommand, i);
+        ASSERT_EQ(runs[i].NumCommands, 1);
+    }
+}
+
+TEST(DrawBatch, DoesNotMergeStrips)
+{
+    DrawBatch batch;
+    batch.Add(MeshChunk {Primitives::TriangleStrip {}, 0, 4});
+    batch.Add(MeshChunk {Primitives::TriangleStrip {}, 4, 4});
+
+    ASSERT_EQ(batch.GetRuns().size(), 1);
+    ASSERT_EQ(batch.GetCommands().size(), 2);
+}
+
+TEST(DrawBatch, PacksInstancingAndSkipsEmptyCommands)
+{
+    DrawBatch batch;
+    const SubMesh subMesh {std::vector {MeshChunk {Primitives::Triangles {}, 0, 6}, MeshChunk {Primitives::Triangles {}, 6, 0}}};
+    batch.Add(subMesh, 16, 32);
+
+    ASSERT_EQ(batch.GetCommands().size(), 1);
+    const auto& command = batch.GetCommands().front();
+    ASSERT_EQ(command.InstanceCount, 16);
+    ASSERT_EQ(command.BaseInstance, 32);
+
+    batch.Clear();
+    ASSERT_TRUE(batch.Empty());
+    ASSERT_TRUE(batch.GetRuns().empty());
+}
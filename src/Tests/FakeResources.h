@@ -0,0 +1,211 @@
+#pragma once
+
+#include <AT2/AT2.h>
+#include <AT2/Core/DataLayout/StructuredBuffer.h>
+
+#include <map>
+#include <memory>
+#include <variant>
+#include <vector>
+
+namespace AT2::Tests
+{
+    // Keeps the data in memory
+    class FakeBuffer : public IBuffer
+    {
+    public:
+        size_t GetLength() const noexcept override { return Data.size(); }
+        void SetDataRaw(std::span<const std::byte> data) override { Data.assign(data.begin(), data.end()); }
+        void ReserveSpace(size_t size) override { Data.resize(size); }
+
+        std::span<std::byte> Map(BufferUsage) override { return Data; }
+        std::span<std::byte> MapRange(BufferUsage, size_t offset, size_t length) override { return std::span {Data}.subspan(offset, length); }
+        void Unmap() override {}
+
+        std::vector<std::byte> Data;
+    };
+
+    class FakeVertexArray : public IVertexArray
+    {
+    public:
+        unsigned int GetId() const noexcept override { return 0; }
+
+        void SetIndexBuffer(std::shared_ptr<IBuffer> buffer, BufferDataType type) override
+        {
+            m_indexBuffer = std::move(buffer);
+            m_indexType = type;
+        }
+        std::shared_ptr<IBuffer> GetIndexBuffer() const override { return m_indexBuffer; }
+        std::optional<BufferDataType> GetIndexBufferType() const override { return m_indexType; }
+
+        void SetAttributeBinding(unsigned int attributeIndex, std::shared_ptr<IBuffer> buffer, const BufferBindingParams& bindingParams) override
+        {
+            m_bindings[attributeIndex] = {std::move(buffer), bindingParams};
+        }
+        std::shared_ptr<IBuffer> GetVertexBuffer(unsigned int index) const override
+        {
+            const auto it = m_bindings.find(index);
+            return it != m_bindings.end() ? it->second.first : nullptr;
+        }
+        std::optional<size_t> GetLastAttributeIndex() const noexcept override
+        {
+            return m_bindings.empty() ? std::nullopt : std::optional<size_t> {m_bindings.rbegin()->first};
+        }
+        std::optional<BufferBindingParams> GetVertexBufferBinding(unsigned int index) const override
+        {
+            const auto it = m_bindings.find(index);
+            return it != m_bindings.end() ? std::optional {it->second.second} : std::nullopt;
+        }
+
+    private:
+        std::shared_ptr<IBuffer> m_indexBuffer;
+        std::optional<BufferDataType> m_indexType;
+        std::map<unsigned int, std::pair<std::shared_ptr<IBuffer>, BufferBindingParams>> m_bindings;
+    };
+
+    // Texture without storage, records uploaded levels. Uploads are checked against bounds of the level, faces of cube
+    // maps are layers like at GlTexture
+    class FakeTexture : public ITexture
+    {
+    public:
+        struct Upload
+        {
+            glm::uvec3 Offset, Size;
+            glm::u32 Level;
+            size_t Length;
+            std::vector<std::byte> Data;
+        };
+
+        explicit FakeTexture(Texture type, size_t bytesPerTexel = 4) : m_type {type}, m_bytesPerTexel {bytesPerTexel}
+        {
+            std::visit(
+                [this](const auto& texture) {
+                    const auto size = texture.getSize();
+                    for (glm::length_t i = 0; i < size.length(); ++i)
+                        m_size[i] = size[i];
+                },
+                type);
+
+            if (std::holds_alternative<TextureCube>(type))
+                m_size.z = 6;
+        }
+
+        void BindAsImage(unsigned int, glm::u32, glm::u32, bool, BufferUsage) const override {}
+        void BuildMipmaps() override {}
+        glm::uvec3 GetSize() const noexcept override { return m_size; }
+        size_t GetDataLength() const noexcept override { return size_t {m_size.x} * m_size.y * m_size.z * m_bytesPerTexel; }
+        const Texture& GetType() const noexcept override { return m_type; }
+        void SubImage1D(glm::u32 offset, glm::u32 size, glm::u32 level, ExternalTextureFormat format, const void* data) override
+        {
+            SubImage3D({offset, 0, 0}, {size, 1, 1}, level, format, data);
+        }
+        void SubImage2D(glm::uvec2 offset, glm::uvec2 size, glm::u32 level, ExternalTextureFormat format, const void* data) override
+        {
+            SubImage3D({offset, 0}, {size, 1}, level, format, data);
+        }
+        void SubImage3D(glm::uvec3 offset, glm::uvec3 size, glm::u32 level, ExternalTextureFormat format, const void* data) override
+        {
+            if (glm::any(glm::greaterThan(offset + size, GetLevelSize(level))))
+                throw AT2TextureException("Some SubImage texels out of texture bounds");
+
+            const auto length = GetImageDataLength(format, size);
+            const auto* bytes = static_cast<const std::byte*>(data);
+            Uploads.push_back({offset, size, level, length, bytes ? std::vector<std::byte>(bytes, bytes + length) : std::vector<std::byte> {}});
+        }
+
+        void SetWrapMode(TextureWrapParams wrapParams) override { m_wrapParams = wrapParams; }
+        const TextureWrapParams& GetWrapMode() const noexcept override { return m_wrapParams; }
+        void SetSamplingMode(TextureSamplingParams samplingParams) override { m_samplingParams = samplingParams; }
+        const TextureSamplingParams& GetSamplingParams() const noexcept override { return m_samplingParams; }
+        void SetAnisotropy(float) override {}
+        float GetAnisotropy() const noexcept override { return 1.0f; }
+
+        [[nodiscard]] size_t GetBytesPerTexel() const noexcept { return m_bytesPerTexel; }
+
+        // Layers aren't reduced
+        [[nodiscard]] glm::uvec3 GetLevelSize(glm::u32 level) const
+        {
+            const bool hasLayeredRows = std::holds_alternative<Texture1DArray>(m_type);
+            const bool isVolume = std::holds_alternative<Texture3D>(m_type);
+            return glm::max(glm::uvec3 {m_size.x >> level, hasLayeredRows ? m_size.y : m_size.y >> level, isVolume ? m_size.z >> level : m_size.z},
+                            glm::uvec3 {1});
+        }
+
+        std::vector<Upload> Uploads;
+        std::shared_ptr<ITexture> ViewedTexture;
+
+    private:
+        Texture m_type;
+        size_t m_bytesPerTexel;
+        glm::uvec3 m_size {1};
+        TextureWrapParams m_wrapParams;
+        TextureSamplingParams m_samplingParams;
+    };
+
+    class FakeShaderProgram : public IShaderProgram
+    {
+    public:
+        explicit FakeShaderProgram(std::vector<ShaderDefine> defines) : Defines {std::move(defines)} {}
+
+        std::unique_ptr<StructuredBuffer> CreateAssociatedUniformStorage(std::string_view) override { return nullptr; }
+
+        std::vector<ShaderDefine> Defines;
+    };
+
+    // Makes fake textures, their views, buffers, vertex arrays and shader programs. Textures and buffers are kept in the
+    // order of creation
+    class FakeResourceFactory : public IResourceFactory
+    {
+    public:
+        std::shared_ptr<ITexture> CreateTextureFromFramebuffer(const glm::ivec2&, const glm::uvec2&) const override { return nullptr; }
+        std::shared_ptr<ITexture> CreateTexture(const Texture& type, ExternalTextureFormat) const override
+        {
+            return Textures.emplace_back(std::make_shared<FakeTexture>(type));
+        }
+        std::shared_ptr<ITexture> CreateTextureView(const std::shared_ptr<ITexture>& texture) const override
+        {
+            ++NumCreatedViews;
+            const auto& storage = dynamic_cast<const FakeTexture&>(*texture);
+            auto view = std::make_shared<FakeTexture>(storage.GetType(), storage.GetBytesPerTexel());
+            view->ViewedTexture = texture;
+            return view;
+        }
+        std::shared_ptr<IFrameBuffer> CreateFrameBuffer() const override { return nullptr; }
+        std::shared_ptr<IVertexArray> CreateVertexArray() const override { return std::make_shared<FakeVertexArray>(); }
+        std::shared_ptr<IBuffer> CreateBuffer(VertexBufferType) const override { return Buffers.emplace_back(std::make_shared<FakeBuffer>()); }
+        std::shared_ptr<IBuffer> CreateBuffer(VertexBufferType type, std::span<const std::byte> data) const override
+        {
+            auto buffer = CreateBuffer(type);
+            buffer->SetDataRaw(data);
+            return buffer;
+        }
+        std::shared_ptr<IShaderProgram> CreateShaderProgramFromFiles(std::initializer_list<str>) const override { return nullptr; }
+        std::shared_ptr<IShaderProgram> CreateShaderProgramFromFiles(std::span<const str>, std::span<const ShaderDefine> defines) const override
+        {
+            ++NumCreatedPrograms;
+            return std::make_shared<FakeShaderProgram>(std::vector<ShaderDefine> {defines.begin(), defines.end()});
+        }
+        void ReloadResources(ReloadableGroup) override {}
+        void RegisterReloadable(std::weak_ptr<IReloadable>) const override {}
+
+        mutable std::vector<std::shared_ptr<FakeTexture>> Textures;
+        mutable std::vector<std::shared_ptr<FakeBuffer>> Buffers;
+        mutable size_t NumCreatedViews = 0;
+        mutable size_t NumCreatedPrograms = 0;
+    };
+
+    // Only resources are needed
+    class FakeVisualizationSystem : public IVisualizationSystem
+    {
+    public:
+        IResourceFactory& GetResourceFactory() const override { return Factory; }
+        IRendererCapabilities& GetRendererCapabilities() const override { throw AT2NotImplementedException("not needed"); }
+        void DispatchCompute(const std::shared_ptr<IShaderProgram>&, glm::uvec3) override {}
+        void BeginFrame() override {}
+        void FinishFrame() override {}
+        IFrameBuffer& GetDefaultFramebuffer() const override { throw AT2NotImplementedException("not needed"); }
+
+        mutable FakeResourceFactory Factory;
+    };
+
+} // namespace AT2::Tests
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/DependencyGraph.h>
+#include <AT2/Core/FileWatcher.h>
+
+#include "TestUtils.h"
+
+#include <thread>
+
+using namespace AT2;
+using namespace AT2::Tests;
+using namespace std::literals;
+
+namespace
+{
+    // Polling fallback has both interval and file time resolution to wait for
+    std::vector<std::filesystem::path> WaitForChanges(FileWatcher& watcher)
+    {
+        for (int attempt = 0; attempt < 50; ++attempt)
+        {
+            if (auto changes = watcher.PollChanges(); !changes.empty())
+                return changes;
+
+            std::this_thread::sleep_for(20ms);
+        }
+
+        return {};
+    }
+} // namespace
+
+TEST(DependencyGraph, FindsDependentsOnce)
+{
+    DependencyGraph<int> graph;
+
+    const std::array firstFiles {std::filesystem::path {"shaders/a.fs.glsl"}, std::filesystem::path {"shaders/common.glsl"}};
+    const std::array secondFiles {std::filesystem::path {"shaders/b.fs.glsl"}, std::filesystem::path {"shaders/lib/../common.glsl"}};
+    graph.SetDependencies(1, firstFiles);
+    graph.SetDependencies(2, secondFiles);
+    ASSERT_EQ(graph.GetNumFiles(), 3);
+
+    const std::array changedCommon {std::filesystem::path {"shaders/common.glsl"}, std::filesystem::path {"shaders/a.fs.glsl"}};
+    auto dependents = graph.GetDependents(changedCommon);
+    std::ranges::sort(dependents);
+    ASSERT_EQ(dependents, (std::vector {1, 2}));
+
+    const std::array changedB {std::filesystem::path {"shaders/b.fs.glsl"}};
+    ASSERT_EQ(graph.GetDependents(changedB), std::vector {2});
+
+    const std::array unrelated {std::filesystem::path {"shaders/c.fs.glsl"}};
+    ASSERT_TRUE(graph.GetDependents(unrelated).empty());
+}
+
+TEST(DependencyGraph, ReplacesAndRemovesDependencies)
+{
+    DependencyGraph<int> graph;
+
+    const std::array oldFiles {std::filesystem::path {"a.glsl"}, std::filesystem::path {"old.glsl"}};
+    const std::array newFiles {std::filesystem::path {"a.glsl"}, std::filesystem::path {"new.glsl"}};
+    ASSERT_TRUE(graph.SetDependencies(1, oldFiles).empty());
+    // dropped include isn't needed anymore
+    ASSERT_EQ(graph.SetDependencies(1, newFiles), std::vector {DependencyGraph<int>::Normalize("old.glsl")});
+
+    const std::array changedOld {std::filesystem::path {"old.glsl"}};
+    const std::array changedNew {std::filesystem::path {"new.glsl"}};
+    ASSERT_TRUE(graph.GetDependents(changedOld).empty());
+    ASSERT_EQ(graph.GetDependents(changedNew), std::vector {1});
+
+    // files shared with other resources stay
+    const std::array sharedFiles {std::filesystem::path {"a.glsl"}};
+    ASSERT_TRUE(graph.SetDependencies(2, sharedFiles).empty());
+    ASSERT_EQ(graph.Remove(1), std::vector {DependencyGraph<int>::Normalize("new.glsl")});
+    ASSERT_FALSE(graph.Contains(1));
+    ASSERT_EQ(graph.GetNumFiles(), 1);
+
+    ASSERT_EQ(graph.Remove(2), std::vector {DependencyGraph<int>::Normalize("a.glsl")});
+    ASSERT_EQ(graph.GetNumFiles(), 0);
+    ASSERT_TRUE(graph.Remove(2).empty());
+}
+
+TEST(FileWatcher, ReportsOnlyWatchedFiles)
+{
+    const TemporaryDirectory directory {"AT2_FileWatcher_Test"};
+    const auto watchedFile = directory.GetPath() / "watched.glsl";
+    const auto otherFile = directory.GetPath() / "other.glsl";
+    WriteFile(watchedFile, "1");
+    WriteFile(otherFile, "1");
+
+    FileWatcher watcher {10ms};
+    watcher.Watch(watchedFile);
+    ASSERT_TRUE(watcher.PollChanges().empty());
+
+    // modification time resolution of some filesystems is quite coarse
+    if (!watcher.IsNative())
+        std::this_thread::sleep_for(1100ms);
+
+    WriteFile(otherFile, "2");
+    WriteFile(watchedFile, "2");
+
+    const auto changes = WaitForChanges(watcher);
+    ASSERT_EQ(changes.size(), 1);
+    ASSERT_EQ(changes.front(), DependencyGraph<int>::Normalize(watchedFile));
+
+    ASSERT_TRUE(watcher.PollChanges().empty());
+}
+
+TEST(FileWatcher, TracksReplacedFiles)
+{
+    const TemporaryDirectory directory {"AT2_FileWatcher_Replace_Test"};
+    const auto watchedFile = directory.GetPath() / "watched.glsl";
+    const auto temporaryFile = directory.GetPath() / "watched.glsl.tmp";
+    WriteFile(watchedFile, "1");
+
+    FileWatcher watcher {10ms};
+    watcher.Watch(watchedFile);
+
+    if (!watcher.IsNative())
+        std::this_thread::sleep_for(1100ms);
+
+    WriteFile(temporaryFile, "2");
+    std::filesystem::rename(temporaryFile, watchedFile);
+
+    const auto changes = WaitForChanges(watcher);
+    ASSERT_EQ(changes.size(), 1);
+    ASSERT_EQ(changes.front(), DependencyGraph<int>::Normalize(watchedFile));
+}
+
+TEST(FileWatcher, RemovesDirectoryWatchesWithLastFile)
+{
+    const TemporaryDirectory directory {"AT2_FileWatcher_Unwatch_Test"};
+    const auto firstFile = directory.GetPath() / "first.glsl";
+    const auto secondFile = directory.GetPath() / "second.glsl";
+    WriteFile(firstFile, "1");
+    WriteFile(secondFile, "1");
+
+    FileWatcher watcher {10ms};
+    watcher.Watch(firstFile);
+    watcher.Watch(secondFile);
+    watcher.Watch(secondFile);
+    const size_t numDirectories = watcher.IsNative() ? 1 : 0;
+    ASSERT_EQ(watcher.GetNumWatchedDirectories(), numDirectories);
+
+    watcher.Unwatch(secondFile);
+    ASSERT_EQ(watcher.GetNumWatchedDirectories(), numDirectories);
+    watcher.Unwatch(firstFile);
+    ASSERT_EQ(watcher.GetNumWatchedDirectories(), 0);
+
+    // watching again after the directory watch was removed
+    watcher.Watch(firstFile);
+    if (!watcher.IsNative())
+        std::this_thread::sleep_for(1100ms);
+
+    WriteFile(secondFile, "2");
+    WriteFile(firstFile, "2");
+
+    const auto changes = WaitForChanges(watcher);
+    ASSERT_EQ(changes.size(), 1);
+    ASSERT_EQ(changes.front(), DependencyGraph<int>::Normalize(firstFile));
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/Resources/CookedScene.h>
+#include <AT2/Core/Resources/GltfSceneLoader.h>
+#include <AT2/Core/ThreadPool.h>
+
+#include "FakeResources.h"
+#include "TestUtils.h"
+
+#include <cmath>
+#include <fstream>
+
+using namespace AT2;
+using namespace AT2::Resources;
+using namespace AT2::Tests;
+
+namespace
+{
+    constexpr size_t NumMeshes = 40;
+    constexpr size_t NumImages = 3;
+
+    void WriteBinaryFile(const std::filesystem::path& path, std::string_view content)
+    {
+        std::ofstream {path, std::ios::binary} << content;
+    }
+
+    template <typename T>
+    void Append(std::string& data, const std::vector<T>& values)
+    {
+        data.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    // 4 x 4 uncompressed 32-bit TGA, it's decoded by any of the texture loaders
+    std::string MakeImage(size_t seed)
+    {
+        std::string image {"\0\0\2\0\0\0\0\0\0\0\0\0\4\0\4\0\x20\x28", 18};
+        for (size_t texel = 0; texel < 16; ++texel)
+            image.append({static_cast<char>(seed * 50), static_cast<char>(texel * 16), '\0', '\xff'});
+
+        return image;
+    }
+
+    // Model of grids of different sizes and shapes, each is a mesh at it's own node. Materials reference the images
+    std::filesystem::path WriteModel(const std::filesystem::path& directory)
+    {
+        // every accessor has it's own buffer view
+        std::string buffer, bufferViews, accessors, meshes, nodes, sceneNodes;
+        size_t numAccessors = 0;
+        const auto addAccessor = [&](size_t offset, size_t length, int target, int componentType, size_t count, std::string_view type) {
+            const auto index = std::to_string(numAccessors++);
+            bufferViews += std::string {bufferViews.empty() ? "" : ","} + R"({"buffer":0,"byteOffset":)" + std::to_string(offset) +
+                           R"(,"byteLength":)" + std::to_string(length) + R"(,"target":)" + std::to_string(target) + "}";
+            accessors += std::string {accessors.empty() ? "" : ","} + R"({"bufferView":)" + index + R"(,"componentType":)" +
+                         std::to_string(componentType) + R"(,"count":)" + std::to_string(count) + R"(,"type":")" + std::string {type} + R"("})";
+            return index;
+        };
+
+        for (size_t meshIndex = 0; meshIndex < NumMeshes; ++meshIndex)
+        {
+            const auto phase = static_cast<float>(meshIndex);
+            const auto grid = MakeGrid(3 + static_cast<uint32_t>(meshIndex % 6),
+                                       [phase](float x, float y) { return std::sin(x * 0.7f + phase) * std::cos(y * 0.5f); });
+
+            const auto positionsOffset = buffer.size();
+            Append(buffer, grid.Positions);
+            const auto positions = addAccessor(positionsOffset, buffer.size() - positionsOffset, 34962, 5126, grid.Positions.size(), "VEC3");
+
+            const auto indicesOffset = buffer.size();
+            Append(buffer, grid.Indices);
+            const auto indices = addAccessor(indicesOffset, buffer.size() - indicesOffset, 34963, 5125, grid.Indices.size(), "SCALAR");
+
+            const auto separator = std::string {meshIndex ? "," : ""};
+            meshes += separator + R"({"primitives":[{"attributes":{"POSITION":)" + positions + R"(},"indices":)" + indices +
+                      R"(,"material":)" + std::to_string(meshIndex % NumImages) + "}]}";
+            nodes += separator + R"({"mesh":)" + std::to_string(meshIndex) + "}";
+            sceneNodes += separator + std::to_string(meshIndex);
+        }
+
+        std::string images, textures, materials;
+        for (size_t imageIndex = 0; imageIndex < NumImages; ++imageIndex)
+        {
+            const auto name = "image" + std::to_string(imageIndex) + ".tga";
+            WriteBinaryFile(directory / name, MakeImage(imageIndex));
+
+            const auto separator = std::string {imageIndex ? "," : ""};
+            images += separator + R"({"uri":")" + name + R"("})";
+            textures += separator + R"({"source":)" + std::to_string(imageIndex) + "}";
+            materials += separator + R"({"pbrMetallicRoughness":{"baseColorTexture":{"index":)" + std::to_string(imageIndex) + "}}}";
+        }
+
+        WriteBinaryFile(directory / "model.bin", buffer);
+        const auto path = directory / "model.gltf";
+        WriteFile(path, R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[)" + sceneNodes + R"(]}],"nodes":[)" + nodes +
+                            R"(],"meshes":[)" + meshes + R"(],"materials":[)" + materials + R"(],"textures":[)" + textures +
+                            R"(],"images":[)" + images + R"(],"accessors":[)" + accessors + R"(],"bufferViews":[)" + bufferViews +
+                            R"(],"buffers":[{"uri":"model.bin","byteLength":)" + std::to_string(buffer.size()) + "}]}");
+        return path;
+    }
+} // namespace
+
+TEST(GltfSceneLoader, PreparesSameResourcesInParallel)
+{
+    const TemporaryDirectory directory {"AT2_GltfSceneLoader"};
+    const auto path = WriteModel(directory.GetPath());
+
+    FakeVisualizationSystem serialRenderer, parallelRenderer;
+    ThreadPool threadPool {4};
+    const auto serialScene = GltfMeshLoader::LoadScene(serialRenderer, path.string(), nullptr, nullptr, nullptr, true, true, true);
+    const auto parallelScene = GltfMeshLoader::LoadScene(parallelRenderer, path.string(), nullptr, nullptr, &threadPool, true, true, true);
+    ASSERT_NE(serialScene, nullptr);
+    ASSERT_NE(parallelScene, nullptr);
+
+    // resources are created at the calling thread in the same order, so only the prepared data could differ
+    const auto& serialBuffers = serialRenderer.Factory.Buffers;
+    const auto& parallelBuffers = parallelRenderer.Factory.Buffers;
+    ASSERT_FALSE(serialBuffers.empty());
+    ASSERT_EQ(serialBuffers.size(), parallelBuffers.size());
+    for (size_t i = 0; i < serialBuffers.size(); ++i)
+        EXPECT_EQ(serialBuffers[i]->Data, parallelBuffers[i]->Data) << "buffer #" << i;
+
+    const auto& serialTextures = serialRenderer.Factory.Textures;
+    const auto& parallelTextures = parallelRenderer.Factory.Textures;
+    ASSERT_GE(serialTextures.size(), NumImages);
+    ASSERT_EQ(serialTextures.size(), parallelTextures.size());
+    for (size_t i = 0; i < serialTextures.size(); ++i)
+    {
+        const auto& serialUploads = serialTextures[i]->Uploads;
+        const auto& parallelUploads = parallelTextures[i]->Uploads;
+        ASSERT_EQ(serialUploads.size(), parallelUploads.size()) << "texture #" << i;
+        for (size_t upload = 0; upload < serialUploads.size(); ++upload)
+        {
+            EXPECT_EQ(serialUploads[upload].Size, parallelUploads[upload].Size);
+            EXPECT_EQ(serialUploads[upload].Level, parallelUploads[upload].Level);
+            EXPECT_EQ(serialUploads[upload].Data, parallelUploads[upload].Data);
+        }
+    }
+}
+
+TEST(GltfSceneLoader, CooksSameSceneInParallel)
+{
+    const TemporaryDirectory directory {"AT2_GltfSceneCooker"};
+    const auto path = WriteModel(directory.GetPath());
+
+    ThreadPool threadPool {4};
+    const auto serialScene = GltfMeshLoader::Cook(path);
+    const auto parallelScene = GltfMeshLoader::Cook(path, &threadPool);
+
+    ASSERT_FALSE(serialScene.Meshes.empty());
+    EXPECT_EQ(serialScene.Serialize(), parallelScene.Serialize());
+}
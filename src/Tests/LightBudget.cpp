@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/LightBudget.h>
+
+#include "TestUtils.h"
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+namespace
+{
+    const glm::mat4 View = LookFrom(glm::vec3 {0.0f}, glm::vec3 {0.0f, 0.0f, -1.0f});
+
+    LightBudget::Light MakeLight(const glm::vec3& position, float intensity)
+    {
+        return {position, glm::vec3 {intensity}, GetLightInfluenceRadius(glm::vec3 {intensity})};
+    }
+} // namespace
+
+TEST(LightBudget, InfluenceRadiusMatchesFalloff)
+{
+    for (const float cutoff : {0.01f, DefaultLightLuminanceCutoff, 1.0f})
+        for (const float intensity : {10.0f, 1000.0f, 100000.0f})
+        {
+            const float radius = GetLightInfluenceRadius(glm::vec3 {intensity}, cutoff);
+            EXPECT_NEAR(intensity / (radius * radius + 1.0f), cutoff, cutoff * 1e-3f);
+        }
+
+    EXPECT_LT(GetLightInfluenceRadius(glm::vec3 {100.0f}), GetLightInfluenceRadius(glm::vec3 {1000.0f}));
+    EXPECT_LT(GetLightInfluenceRadius({0.0f, 0.0f, 100.0f}), GetLightInfluenceRadius({0.0f, 100.0f, 0.0f}));
+    EXPECT_EQ(GetLightInfluenceRadius(glm::vec3 {0.01f}), 0.0f);
+    EXPECT_THROW((void)GetLightInfluenceRadius(glm::vec3 {1.0f}, 0.0f), AT2Exception);
+}
+
+TEST(LightBudget, RanksByCoverageAndLuminance)
+{
+    const auto importance = [](const LightBudget::Light& light) { return LightBudget::GetImportance(light, View, Projection); };
+
+    const auto nearLight = MakeLight({0.0f, 0.0f, -100.0f}, 100.0f);
+    const auto farLight = MakeLight({0.0f, 0.0f, -500.0f}, 100.0f);
+    const auto brightLight = MakeLight({0.0f, 0.0f, -500.0f}, 1000.0f);
+    EXPECT_GT(importance(nearLight), importance(farLight));
+    EXPECT_GT(importance(brightLight), importance(farLight));
+
+    // the camera is inside of the sphere, so it covers the whole screen
+    EXPECT_FLOAT_EQ(importance(MakeLight({0.0f, 0.0f, 1.0f}, 100.0f)), 100.0f);
+
+    EXPECT_EQ(importance(MakeLight({0.0f, 0.0f, 500.0f}, 100.0f)), 0.0f);
+    EXPECT_EQ(importance(MakeLight({500.0f, 0.0f, -100.0f}, 100.0f)), 0.0f);
+    EXPECT_EQ(importance({{0.0f, 0.0f, -10.0f}, glm::vec3 {0.0f}, 10.0f}), 0.0f);
+}
+
+TEST(LightBudget, KeepsMostImportantLights)
+{
+    // lights are too far from each other to be merged
+    const std::vector lights {MakeLight({-200.0f, 0.0f, -300.0f}, 100.0f), MakeLight({0.0f, 0.0f, 500.0f}, 100.0f),
+                              MakeLight({0.0f, 0.0f, -300.0f}, 1000.0f), MakeLight({200.0f, 0.0f, -300.0f}, 10.0f),
+                              MakeLight({0.0f, 0.0f, -100.0f}, 100.0f)};
+
+    LightBudget budget {2};
+    auto statistics = budget.Select(lights, View, Projection);
+    EXPECT_EQ(statistics.NumLights, 5);
+    EXPECT_EQ(statistics.NumCulled, 1);
+    EXPECT_EQ(statistics.NumSelected, 2);
+    EXPECT_EQ(statistics.NumMerged, 0);
+    EXPECT_EQ(statistics.NumDropped, 2);
+
+    // order of the source lights is kept
+    const auto selected = budget.GetSelectedLights();
+    ASSERT_EQ(selected.size(), 2);
+    EXPECT_EQ(selected[0].Position, lights[2].Position);
+    EXPECT_EQ(selected[1].Position, lights[4].Position);
+    EXPECT_EQ(budget.GetSelectedIndices()[0], 2);
+    EXPECT_EQ(budget.GetSelectedIndices()[1], 4);
+
+    budget.SetMaxLights(LightBudget::DefaultMaxLights);
+    statistics = budget.Select(lights, View, Projection);
+    EXPECT_EQ(statistics.NumSelected, 4);
+    EXPECT_EQ(statistics.NumDropped, 0);
+}
+
+TEST(LightBudget, MergesLightsIntoKeptOnes)
+{
+    const auto bright = MakeLight({0.0f, 0.0f, -100.0f}, 1000.0f);
+    const auto dim = MakeLight({10.0f, 0.0f, -100.0f}, 10.0f);
+    ASSERT_LT(glm::length(bright.Position - dim.Position), bright.Radius);
+
+    LightBudget budget {1};
+    const std::vector lights {dim, bright};
+    const auto statistics = budget.Select(lights, View, Projection);
+    EXPECT_EQ(statistics.NumSelected, 1);
+    EXPECT_EQ(statistics.NumMerged, 1);
+    EXPECT_EQ(statistics.NumDropped, 0);
+
+    const auto& merged = budget.GetSelectedLights().front();
+    EXPECT_EQ(merged.Intensity, glm::vec3 {1010.0f});
+    EXPECT_GT(merged.Position.x, bright.Position.x);
+    EXPECT_LT(merged.Position.x, bright.Position.x + 1.0f);
+
+    // the merged sphere contains both of the source ones
+    for (const auto& light : lights)
+        EXPECT_GE(merged.Radius + 1e-3f, glm::length(light.Position - merged.Position) + light.Radius);
+}
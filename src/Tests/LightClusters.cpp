@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/LightClusters.h>
+#include <AT2/Core/ThreadPool.h>
+
+#include <random>
+
+using namespace AT2;
+
+namespace
+{
+    const glm::mat4 Projection = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    const glm::mat4 View = glm::lookAt(glm::vec3 {0.0f, 10.0f, 0.0f}, glm::vec3 {0.0f, 10.0f, -1.0f}, glm::vec3 {0.0f, 1.0f, 0.0f});
+
+    std::vector<LightClusters::Light> MakeLights(size_t count)
+    {
+        std::mt19937 random {42};
+        std::uniform_real_distribution<float> position {-200.0f, 200.0f}, radius {1.0f, 30.0f};
+
+        std::vector<LightClusters::Light> lights(count);
+        for (auto& light : lights)
+            light = {{position(random), position(random) * 0.1f, position(random)}, radius(random)};
+        return lights;
+    }
+} // namespace
+
+TEST(LightClusters, ChecksParameters)
+{
+    EXPECT_THROW(LightClusters {glm::uvec3(16, 0, 24)}, AT2Exception);
+
+    LightClusters clusters;
+    EXPECT_THROW((void)clusters.Assign({}), AT2Exception);
+    EXPECT_THROW(clusters.SetView(View, glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.1f, 100.0f)), AT2Exception);
+}
+
+TEST(LightClusters, FindsClustersOfPoints)
+{
+    LightClusters clusters;
+    clusters.SetView(View, Projection);
+    const auto gridSize = clusters.GetGridSize();
+
+    EXPECT_EQ(clusters.FindCluster({0.0f, 0.0f, -0.11f}), glm::uvec3(gridSize.x / 2, gridSize.y / 2, 0));
+    EXPECT_EQ(clusters.FindCluster({0.0f, 0.0f, -999.0f})->z, gridSize.z - 1);
+    EXPECT_FALSE(clusters.FindCluster({0.0f, 0.0f, -1001.0f}));
+    EXPECT_FALSE(clusters.FindCluster({0.0f, 0.0f, 1.0f}));
+    EXPECT_FALSE(clusters.FindCluster({100.0f, 0.0f, -10.0f}));
+
+    // slices get thicker with the distance
+    unsigned int lastSlice = 0;
+    for (float depth = 0.11f; depth < 1000.0f; depth *= 1.5f)
+    {
+        const auto slice = clusters.FindCluster({0.0f, 0.0f, -depth})->z;
+        EXPECT_GE(slice, lastSlice);
+        lastSlice = slice;
+    }
+}
+
+TEST(LightClusters, AssignsLightsToTouchedClusters)
+{
+    const auto lights = MakeLights(500);
+
+    LightClusters clusters;
+    clusters.SetView(View, Projection);
+    const auto statistics = clusters.Assign(lights);
+
+    EXPECT_EQ(statistics.NumLights, lights.size());
+    EXPECT_GT(statistics.NumVisibleLights, 0);
+    EXPECT_LT(statistics.NumVisibleLights, lights.size());
+    EXPECT_EQ(statistics.NumIndices, clusters.GetLightIndices().size());
+    EXPECT_LT(statistics.NumIndices, statistics.NumVisibleLights * clusters.GetNumClusters());
+
+    // every lit point finds all of it's lights at it's cluster
+    std::mt19937 random {7};
+    std::uniform_real_distribution<float> coordinate {-1.0f, 1.0f}, distance {0.1f, 300.0f};
+    const auto viewLights = clusters.GetViewSpaceLights();
+    for (int i = 0; i < 5000; ++i)
+    {
+        const float depth = distance(random);
+        const glm::vec3 point {coordinate(random) * depth * 1.7f, coordinate(random) * depth, -depth};
+        const auto cluster = clusters.FindCluster(point);
+        if (!cluster)
+            continue;
+
+        const auto clusterLights = clusters.GetLights(*cluster);
+        ASSERT_TRUE(std::ranges::is_sorted(clusterLights));
+        for (uint32_t light = 0; light < viewLights.size(); ++light)
+        {
+            const bool isLit = glm::length(viewLights[light].Position - point) <= viewLights[light].Radius;
+            EXPECT_TRUE(!isLit || std::ranges::binary_search(clusterLights, light)) << "light " << light << " point " << i;
+        }
+    }
+}
+
+TEST(LightClusters, KeepsLightsAroundCamera)
+{
+    LightClusters clusters;
+    clusters.SetView(View, Projection);
+
+    // the camera is inside of the first light, the second one is behind the camera
+    const std::vector<LightClusters::Light> lights {{{0.0f, 10.0f, 0.0f}, 1.0f}, {{0.0f, 10.0f, 20.0f}, 5.0f}};
+    const auto statistics = clusters.Assign(lights);
+    EXPECT_EQ(statistics.NumVisibleLights, 1);
+
+    const auto gridSize = clusters.GetGridSize();
+    for (unsigned int y = 0; y < gridSize.y; ++y)
+        for (unsigned int x = 0; x < gridSize.x; ++x)
+            EXPECT_EQ(clusters.GetLights({x, y, 0}).size(), 1);
+}
+
+TEST(LightClusters, AssignsInParallel)
+{
+    const auto lights = MakeLights(1000);
+
+    LightClusters serial, parallel;
+    serial.SetView(View, Projection);
+    parallel.SetView(View, Projection);
+
+    ThreadPool threadPool {4};
+    const auto serialStatistics = serial.Assign(lights);
+    const auto parallelStatistics = parallel.Assign(lights, &threadPool);
+
+    EXPECT_EQ(parallelStatistics.NumIndices, serialStatistics.NumIndices);
+    EXPECT_EQ(parallelStatistics.MaxLightsPerCluster, serialStatistics.MaxLightsPerCluster);
+    EXPECT_TRUE(std::ranges::equal(parallel.GetLightIndices(), serial.GetLightIndices()));
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/Scene/LightRegistry.h>
+#include <AT2/Core/Scene/Scene.h>
+
+using namespace AT2;
+using namespace AT2::Scene;
+
+namespace
+{
+    class FixedTime : public ITime
+    {
+    public:
+        [[nodiscard]] Seconds getTime() const override { return Seconds {0.0}; }
+        [[nodiscard]] Seconds getDeltaTime() const override { return Seconds {0.0}; }
+    };
+} // namespace
+
+TEST(LightRegistry, KeepsLightsDense)
+{
+    LightRegistry registry;
+    const auto first = registry.AddSphereLight({1.0f, 0.0f, 0.0f}, glm::vec3 {1.0f}, 1.0f);
+    const auto second = registry.AddSphereLight({2.0f, 0.0f, 0.0f}, glm::vec3 {2.0f}, 2.0f);
+    const auto third = registry.AddSphereLight({3.0f, 0.0f, 0.0f}, glm::vec3 {3.0f}, 3.0f);
+    const auto sky = registry.AddSkyLight({0.0f, 100.0f, 0.0f}, glm::vec3 {10.0f}, {0.0f, 1.0f, 0.0f}, nullptr);
+    EXPECT_EQ(registry.GetNumLights(), 4);
+
+    registry.Remove(first);
+    EXPECT_FALSE(registry.Contains(first));
+    EXPECT_THROW(registry.Remove(first), AT2Exception);
+
+    // the last light took the place of the removed one
+    const auto& sphereLights = registry.GetSphereLights();
+    ASSERT_EQ(sphereLights.Positions.size(), 2);
+    EXPECT_EQ(sphereLights.Radii, (std::vector {3.0f, 2.0f}));
+    EXPECT_EQ(sphereLights.Intensities[0], glm::vec3 {3.0f});
+
+    // handles still refer to their lights
+    registry.SetTransform(third, {30.0f, 0.0f, 0.0f}, {});
+    registry.SetIntensity(second, glm::vec3 {20.0f}, 20.0f);
+    EXPECT_EQ(sphereLights.Positions[0], glm::vec3(30.0f, 0.0f, 0.0f));
+    EXPECT_EQ(sphereLights.Intensities[1], glm::vec3 {20.0f});
+    EXPECT_EQ(sphereLights.Radii[1], 20.0f);
+
+    registry.SetTransform(sky, {0.0f, 200.0f, 0.0f}, {1.0f, 0.0f, 0.0f});
+    EXPECT_EQ(registry.GetSkyLights().Directions.front(), glm::vec3(1.0f, 0.0f, 0.0f));
+    EXPECT_EQ(sphereLights.Positions.size(), 2);
+
+    // freed handles are reused
+    const auto fourth = registry.AddSphereLight({4.0f, 0.0f, 0.0f}, glm::vec3 {4.0f}, 4.0f);
+    EXPECT_EQ(fourth, first);
+    EXPECT_EQ(sphereLights.Radii.back(), 4.0f);
+
+    for (const auto handle : {second, third, fourth, sky})
+        registry.Remove(handle);
+    EXPECT_EQ(registry.GetNumLights(), 0);
+    EXPECT_TRUE(registry.GetSphereLights().Positions.empty());
+    EXPECT_TRUE(registry.GetSkyLights().EnvironmentMaps.empty());
+}
+
+TEST(LightRegistry, FindsNearestSkyLight)
+{
+    LightRegistry registry;
+    EXPECT_FALSE(registry.FindNearestSkyLight({}));
+
+    registry.AddSphereLight({0.0f, 0.0f, 0.0f}, glm::vec3 {1.0f}, 1.0f);
+    const auto far = registry.AddSkyLight({100.0f, 0.0f, 0.0f}, glm::vec3 {1.0f}, {0.0f, 1.0f, 0.0f}, nullptr);
+    registry.AddSkyLight({-10.0f, 0.0f, 0.0f}, glm::vec3 {2.0f}, {0.0f, 1.0f, 0.0f}, nullptr);
+
+    auto nearest = registry.FindNearestSkyLight({0.0f, 0.0f, 0.0f});
+    ASSERT_TRUE(nearest);
+    EXPECT_EQ(registry.GetSkyLights().Intensities[*nearest], glm::vec3 {2.0f});
+
+    registry.SetTransform(far, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+    nearest = registry.FindNearestSkyLight({0.0f, 0.0f, 0.0f});
+    EXPECT_EQ(registry.GetSkyLights().Intensities[*nearest], glm::vec3 {1.0f});
+}
+
+TEST(LightRegistry, LightComponentsAreKeptByEveryScene)
+{
+    const FixedTime time;
+
+    auto light = std::make_shared<Node>("light");
+    light->addComponent(std::make_unique<LightComponent>(SphereLight {}, glm::vec3 {1.0f}));
+
+    auto first = std::make_unique<AT2::Scene::Scene>();
+    AT2::Scene::Scene second;
+    first->GetRoot().AddChild(light);
+    second.GetRoot().AddChild(light);
+
+    // updates of one scene don't move the light out of the other one
+    for (int i = 0; i < 2; ++i)
+    {
+        first->Update(time);
+        second.Update(time);
+        EXPECT_EQ(first->GetLightRegistry().GetNumLights(), 1);
+        EXPECT_EQ(second.GetLightRegistry().GetNumLights(), 1);
+    }
+
+    light->getComponent<LightComponent>()->SetIntensity(glm::vec3 {2.0f});
+    EXPECT_EQ(first->GetLightRegistry().GetSphereLights().Intensities.front(), glm::vec3 {2.0f});
+    EXPECT_EQ(second.GetLightRegistry().GetSphereLights().Intensities.front(), glm::vec3 {2.0f});
+
+    // the node outlives the scene
+    first.reset();
+    second.Update(time);
+    light->getComponent<LightComponent>()->SetEnabled(false);
+    EXPECT_EQ(second.GetLightRegistry().GetNumLights(), 0);
+
+    light->getComponent<LightComponent>()->SetEnabled(true);
+    second.Update(time);
+    EXPECT_EQ(second.GetLightRegistry().GetNumLights(), 1);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/LodSelector.h>
+
+#include "TestUtils.h"
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+namespace
+{
+    // with 90 degrees field of view of the Projection an object-space unit at distance 1 is half of the viewport height
+    constexpr float ViewportHeight = 1000.0f;
+
+    SubMesh MakeSubMesh(std::initializer_list<float> lodErrors)
+    {
+        SubMesh subMesh {std::vector {MeshChunk {Primitives::Triangles {}, 0, 3000}}};
+        for (unsigned int count = 1500; const auto error : lodErrors)
+        {
+            subMesh.Lods.push_back({error, {MeshChunk {Primitives::Triangles {}, 0, count}}});
+            count /= 2;
+        }
+
+        return subMesh;
+    }
+
+    glm::mat4 AtDistance(float distance) { return glm::translate(glm::mat4 {1.0f}, {0.0f, 0.0f, -distance}); }
+} // namespace
+
+TEST(LodSelector, ProjectsSizes)
+{
+    const LodSelector selector {Projection, ViewportHeight};
+    EXPECT_NEAR(selector.GetProjectedSize(1.0f, 1.0f), 500.0f, 1e-3f);
+    EXPECT_NEAR(selector.GetProjectedSize(1.0f, 10.0f), 50.0f, 1e-3f);
+
+    const LodSelector orthographicSelector {glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 100.0f), ViewportHeight};
+    EXPECT_NEAR(orthographicSelector.GetProjectedSize(1.0f, 1.0f), orthographicSelector.GetProjectedSize(1.0f, 50.0f), 1e-3f);
+}
+
+TEST(LodSelector, SelectsCoarserLevelsWithDistance)
+{
+    // errors are 1 pixel at distances 50, 100 and 200
+    const auto subMesh = MakeSubMesh({0.1f, 0.2f, 0.4f});
+    const LodSelector selector {Projection, ViewportHeight, 1.0f, 0.0f};
+
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(10.0f), 0), 0);
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(60.0f), 0), 1);
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(150.0f), 0), 2);
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(1000.0f), 0), 3);
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(10.0f), 3), 0);
+
+    // scaled mesh has larger error
+    EXPECT_EQ(selector.Select(subMesh, glm::scale(AtDistance(150.0f), glm::vec3 {2.0f}), 0), 1);
+}
+
+TEST(LodSelector, KeepsLevelWithinHysteresis)
+{
+    const auto subMesh = MakeSubMesh({0.1f});
+    const LodSelector selector {Projection, ViewportHeight, 1.0f, 0.25f};
+
+    // level 1 has 1 pixel error at distance 50, it's taken below 0.75 and dropped above 1.25 pixels
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(55.0f), 0), 0);
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(70.0f), 0), 1);
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(45.0f), 1), 1);
+    EXPECT_EQ(selector.Select(subMesh, AtDistance(35.0f), 1), 0);
+}
+
+TEST(LodSelector, HandlesMissingLevels)
+{
+    const LodSelector selector {Projection, ViewportHeight};
+    EXPECT_EQ(selector.Select(MakeSubMesh({}), AtDistance(1000.0f), 0), 0);
+    EXPECT_EQ(selector.Select(MakeSubMesh({0.1f}), AtDistance(1000.0f), 5), 1);
+
+    const LodSelector disabledSelector {Projection, ViewportHeight, 0.0f};
+    EXPECT_EQ(disabledSelector.Select(MakeSubMesh({0.0f, 0.1f}), AtDistance(1000.0f), 2), 0);
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include <AT2/AT2_exceptions.hpp>
+#include <AT2/Core/MappedFile.h>
+
+#include "TestUtils.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+TEST(MappedFile, MapsWholeFile)
+{
+    const TemporaryDirectory directory {"at2_mapped_file_test"};
+    const auto path = directory.GetPath() / "data.bin";
+
+    std::string content(100000, '\0');
+    for (size_t i = 0; i < content.size(); ++i)
+        content[i] = static_cast<char>(i * 31);
+    std::ofstream {path, std::ios::binary} << content;
+
+    const MappedFile file {path};
+    ASSERT_EQ(file.GetPath(), path);
+    ASSERT_EQ(file.GetData().size(), content.size());
+    ASSERT_EQ(std::memcmp(file.GetData().data(), content.data(), content.size()), 0);
+}
+
+TEST(MappedFile, HandlesEmptyAndMissingFiles)
+{
+    const TemporaryDirectory directory {"at2_mapped_file_test"};
+    const auto path = directory.GetPath() / "empty.bin";
+    std::ofstream {path};
+
+    ASSERT_TRUE(MappedFile {path}.GetData().empty());
+    ASSERT_THROW(MappedFile {directory.GetPath() / "missing.bin"}, AT2IOException);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <AT2/AT2_exceptions.hpp>
+#include <AT2/Core/MeshOptimizer.h>
+
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+namespace
+{
+    // size x size quads, triangles are shuffled
+    Grid MakeShuffledGrid(uint32_t size)
+    {
+        auto grid = MakeGrid(size);
+
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i < grid.Indices.size(); i += 3)
+            triangles.push_back({grid.Indices[i], grid.Indices[i + 1], grid.Indices[i + 2]});
+
+        std::ranges::shuffle(triangles, std::mt19937 {42});
+        grid.Indices.clear();
+        for (const auto& triangle : triangles)
+            grid.Indices.insert(grid.Indices.end(), triangle.begin(), triangle.end());
+
+        return grid;
+    }
+
+    // triangles in canonical form: rotated to start with the smallest index, so winding is kept
+    std::vector<std::array<uint32_t, 3>> GetSortedTriangles(std::span<const uint32_t> indices)
+    {
+        std::vector<std::array<uint32_t, 3>> result;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            std::array triangle {indices[i], indices[i + 1], indices[i + 2]};
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            result.push_back(triangle);
+        }
+
+        std::ranges::sort(result);
+        return result;
+    }
+} // namespace
+
+TEST(MeshOptimizer, AnalyzesVertexCache)
+{
+    // two triangles sharing an edge, and one vertex isn't used
+    const std::vector<uint32_t> indices {0, 1, 2, 2, 1, 3};
+
+    const auto statistics = MeshOptimizer::AnalyzeVertexCache(indices, 5);
+    EXPECT_EQ(statistics.NumTriangles, 2u);
+    EXPECT_EQ(statistics.NumUsedVertices, 4u);
+    EXPECT_EQ(statistics.NumTransformedVertices, 4u);
+    EXPECT_FLOAT_EQ(statistics.GetACMR(), 2.0f);
+    EXPECT_FLOAT_EQ(statistics.GetATVR(), 1.0f);
+
+    // with cache of 3 vertices the first one is evicted
+    const std::vector<uint32_t> fan {0, 1, 2, 0, 2, 3, 0, 3, 4};
+    EXPECT_EQ(MeshOptimizer::AnalyzeVertexCache(fan, 5, 3).NumTransformedVertices, 6u);
+    EXPECT_EQ(MeshOptimizer::AnalyzeVertexCache(fan, 5, 16).NumTransformedVertices, 5u);
+
+    EXPECT_THROW((void)MeshOptimizer::AnalyzeVertexCache(indices, 3), AT2Exception);
+    EXPECT_THROW((void)MeshOptimizer::AnalyzeVertexCache(std::span {indices}.first(4), 5), AT2Exception);
+}
+
+TEST(MeshOptimizer, ImprovesVertexCacheUsage)
+{
+    const auto grid = MakeShuffledGrid(32);
+
+    const auto optimized = MeshOptimizer::OptimizeVertexCache(grid.Indices, grid.Positions.size());
+    ASSERT_EQ(GetSortedTriangles(optimized), GetSortedTriangles(grid.Indices));
+
+    const auto original = MeshOptimizer::AnalyzeVertexCache(grid.Indices, grid.Positions.size());
+    const auto result = MeshOptimizer::AnalyzeVertexCache(optimized, grid.Positions.size());
+    EXPECT_GT(original.GetACMR(), 2.0f);
+    // regular grid can't be better than 0.5, good ordering is close to 0.7 with 16 vertices cache
+    EXPECT_LT(result.GetACMR(), 0.85f);
+    EXPECT_LT(result.GetATVR(), 1.5f);
+}
+
+TEST(MeshOptimizer, ReordersForOverdrawWithinThreshold)
+{
+    // two parallel layers facing +z, the upper one should be drawn first
+    Grid mesh;
+    for (float z : {0.0f, 1.0f})
+    {
+        const auto layer = MakeGrid(8, z);
+        const auto first = static_cast<uint32_t>(mesh.Positions.size());
+        mesh.Positions.insert(mesh.Positions.end(), layer.Positions.begin(), layer.Positions.end());
+        for (const auto index : layer.Indices)
+            mesh.Indices.push_back(first + index);
+    }
+
+    const auto cacheOptimized = MeshOptimizer::OptimizeVertexCache(mesh.Indices, mesh.Positions.size());
+    const auto optimized = MeshOptimizer::OptimizeOverdraw(cacheOptimized, mesh.Positions, 1.05f);
+    ASSERT_EQ(GetSortedTriangles(optimized), GetSortedTriangles(mesh.Indices));
+
+    EXPECT_GE(optimized.front(), 81u);
+    EXPECT_LT(optimized.back(), 81u);
+
+    const auto before = MeshOptimizer::AnalyzeVertexCache(cacheOptimized, mesh.Positions.size());
+    const auto after = MeshOptimizer::AnalyzeVertexCache(optimized, mesh.Positions.size());
+    EXPECT_LE(after.GetACMR(), before.GetACMR() * 1.05f);
+}
+
+TEST(MeshOptimizer, ReordersVertexFetch)
+{
+    std::vector<uint32_t> indices {4, 2, 0, 0, 2, 3};
+    const std::vector<float> vertices {10, 11, 12, 13, 14};
+
+    const auto remap = MeshOptimizer::OptimizeVertexFetch(indices, vertices.size());
+    EXPECT_EQ(indices, (std::vector<uint32_t> {0, 1, 2, 2, 1, 3}));
+    EXPECT_EQ(remap, (std::vector<uint32_t> {2, MeshOptimizer::UnusedVertex, 1, 3, 0}));
+
+    const auto remapped = MeshOptimizer::RemapVertices(std::as_bytes(std::span {vertices}), sizeof(float), remap);
+    ASSERT_EQ(remapped.size(), 4 * sizeof(float));
+
+    std::vector<float> result(4);
+    std::memcpy(result.data(), remapped.data(), remapped.size());
+    EXPECT_EQ(result, (std::vector<float> {14, 12, 10, 13}));
+}
+
+TEST(MeshOptimizer, NarrowsIndices)
+{
+    const std::vector<uint32_t> small {0, 65535, 7};
+    const std::vector<uint32_t> large {0, 65536, 7};
+
+    EXPECT_EQ(MeshOptimizer::NarrowIndices(small), (std::vector<uint16_t> {0, 65535, 7}));
+    EXPECT_FALSE(MeshOptimizer::NarrowIndices(large).has_value());
+}
+
+TEST(MeshOptimizer, PacksIndicesIntoNarrowestType)
+{
+    const std::vector<uint32_t> small {0, 65535, 7};
+    const auto packedSmall = MeshOptimizer::PackIndices(small);
+    ASSERT_EQ(packedSmall.Type, BufferDataType::UShort);
+    ASSERT_EQ(packedSmall.Data.size(), small.size() * sizeof(uint16_t));
+    const auto narrowed = Utils::reinterpret_span_cast<uint16_t>(std::span {packedSmall.Data});
+    EXPECT_EQ((std::vector<uint16_t> {narrowed.begin(), narrowed.end()}), (std::vector<uint16_t> {0, 65535, 7}));
+
+    const std::vector<uint32_t> large {0, 65536, 7};
+    const auto packedLarge = MeshOptimizer::PackIndices(large);
+    ASSERT_EQ(packedLarge.Type, BufferDataType::UInt);
+    ASSERT_EQ(packedLarge.Data.size(), large.size() * sizeof(uint32_t));
+    EXPECT_EQ(std::memcmp(packedLarge.Data.data(), large.data(), packedLarge.Data.size()), 0);
+
+    const auto packedEmpty = MeshOptimizer::PackIndices({});
+    EXPECT_EQ(packedEmpty.Type, BufferDataType::UShort);
+    EXPECT_TRUE(packedEmpty.Data.empty());
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/MeshSimplifier.h>
+
+#include "TestUtils.h"
+
+#include <cmath>
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+namespace
+{
+    Grid MakeWavyGrid(uint32_t size)
+    {
+        return MakeGrid(size, [](float x, float y) { return std::sin(x * 0.5f) * std::cos(y * 0.5f); });
+    }
+
+    bool IsBorder(const glm::vec3& position, uint32_t size)
+    {
+        return position.x == 0.0f || position.y == 0.0f || position.x == static_cast<float>(size) || position.y == static_cast<float>(size);
+    }
+} // namespace
+
+TEST(MeshSimplifier, FlatSurfaceIsSimplifiedWithoutError)
+{
+    const auto grid = MakeGrid(16);
+
+    float error = -1.0f;
+    const auto result = MeshSimplifier::Simplify(grid.Indices, grid.Positions, 0, std::numeric_limits<float>::max(), &error);
+
+    ASSERT_EQ(result.size() % 3, 0);
+    EXPECT_LT(result.size(), grid.Indices.size() / 4);
+    EXPECT_NEAR(error, 0.0f, 1e-5f);
+
+    // no triangle is flipped or degenerate
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        const auto& p0 = grid.Positions[result[i]];
+        const auto normal = glm::cross(grid.Positions[result[i + 1]] - p0, grid.Positions[result[i + 2]] - p0);
+        EXPECT_GT(normal.z, 0.0f) << "triangle " << i / 3;
+    }
+}
+
+TEST(MeshSimplifier, KeepsBorders)
+{
+    constexpr uint32_t size = 8;
+    const auto grid = MakeGrid(size);
+    const auto result = MeshSimplifier::Simplify(grid.Indices, grid.Positions, 0);
+
+    for (uint32_t vertex = 0; vertex < grid.Positions.size(); ++vertex)
+    {
+        const bool isUsed = std::ranges::find(result, vertex) != result.end();
+        EXPECT_EQ(isUsed, IsBorder(grid.Positions[vertex], size)) << "vertex " << vertex;
+    }
+}
+
+TEST(MeshSimplifier, KeepsSeams)
+{
+    // the right half of the grid uses own copies of the middle column, as if they had other texture coordinates
+    constexpr uint32_t size = 8;
+    auto grid = MakeGrid(size);
+    std::vector<uint32_t> seamCopies(grid.Positions.size(), 0);
+    for (uint32_t vertex = 0; vertex < seamCopies.size(); ++vertex)
+    {
+        if (grid.Positions[vertex].x != size / 2)
+            continue;
+
+        seamCopies[vertex] = static_cast<uint32_t>(grid.Positions.size());
+        grid.Positions.push_back(grid.Positions[vertex]);
+    }
+
+    for (size_t i = 0; i < grid.Indices.size(); i += 3)
+    {
+        const bool isRightHalf = std::ranges::all_of(std::span {grid.Indices}.subspan(i, 3),
+                                                     [&](uint32_t vertex) { return grid.Positions[vertex].x >= size / 2; });
+        if (!isRightHalf)
+            continue;
+
+        for (size_t j = i; j < i + 3; ++j)
+            if (seamCopies[grid.Indices[j]] != 0)
+                grid.Indices[j] = seamCopies[grid.Indices[j]];
+    }
+
+    const auto result = MeshSimplifier::Simplify(grid.Indices, grid.Positions, 0);
+    for (uint32_t vertex = 0; vertex < grid.Positions.size(); ++vertex)
+    {
+        if (grid.Positions[vertex].x != size / 2)
+            continue;
+
+        EXPECT_NE(std::ranges::find(result, vertex), result.end()) << "seam vertex " << vertex;
+    }
+}
+
+TEST(MeshSimplifier, StopsAtTargetError)
+{
+    const auto grid = MakeWavyGrid(32);
+
+    float smallError = 0.0f, largeError = 0.0f;
+    const auto precise = MeshSimplifier::Simplify(grid.Indices, grid.Positions, 0, 0.05f, &smallError);
+    const auto coarse = MeshSimplifier::Simplify(grid.Indices, grid.Positions, 0, 0.2f, &largeError);
+
+    EXPECT_LE(smallError, 0.05f);
+    EXPECT_LE(largeError, 0.2f);
+    EXPECT_LT(precise.size(), grid.Indices.size());
+    EXPECT_LT(coarse.size(), precise.size());
+}
+
+TEST(MeshSimplifier, StopsAtTargetCount)
+{
+    const auto grid = MakeWavyGrid(32);
+    const auto result = MeshSimplifier::Simplify(grid.Indices, grid.Positions, grid.Indices.size() / 2);
+
+    EXPECT_LE(result.size(), grid.Indices.size() / 2);
+    // collapses are done in passes, so the target could be exceeded only by the last pass
+    EXPECT_GT(result.size(), grid.Indices.size() / 4);
+}
+
+TEST(MeshSimplifier, AppendsLodChain)
+{
+    auto grid = MakeWavyGrid(32);
+    const auto originalSize = grid.Indices.size();
+
+    const auto lods = MeshSimplifier::AppendLods(grid.Indices, grid.Positions, 3);
+    ASSERT_FALSE(lods.empty());
+    ASSERT_LE(lods.size(), 3);
+
+    uint32_t expectedFirst = static_cast<uint32_t>(originalSize), previousCount = expectedFirst;
+    float previousError = 0.0f;
+    for (const auto& [firstIndex, count, error] : lods)
+    {
+        EXPECT_EQ(firstIndex, expectedFirst);
+        EXPECT_EQ(count % 3, 0);
+        EXPECT_LT(count, previousCount);
+        EXPECT_GE(error, previousError);
+
+        expectedFirst += count;
+        previousCount = count;
+        previousError = error;
+    }
+    EXPECT_EQ(grid.Indices.size(), expectedFirst);
+    EXPECT_TRUE(std::ranges::all_of(grid.Indices, [&](uint32_t index) { return index < grid.Positions.size(); }));
+}
+
+TEST(MeshSimplifier, ChecksInput)
+{
+    const auto grid = MakeGrid(2);
+    EXPECT_THROW((void)MeshSimplifier::Simplify(std::span {grid.Indices}.first(4), grid.Positions, 0), AT2Exception);
+    EXPECT_THROW((void)MeshSimplifier::Simplify(grid.Indices, std::span {grid.Positions}.first(4), 0), AT2Exception);
+}
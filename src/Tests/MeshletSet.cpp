@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/MeshletSet.h>
+
+#include "TestUtils.h"
+
+#include <cmath>
+#include <unordered_set>
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+TEST(MeshletSet, SplitsByLimits)
+{
+    const auto grid = MakeGrid(16);
+    constexpr size_t maxVertices = 32, maxTriangles = 40;
+    const auto meshlets = MeshletSet::Build(grid.Indices, grid.Positions, maxVertices, maxTriangles);
+    ASSERT_GT(meshlets.size(), 1);
+
+    uint32_t expectedFirst = 0;
+    for (const auto& meshlet : meshlets)
+    {
+        EXPECT_EQ(meshlet.FirstIndex, expectedFirst);
+        EXPECT_EQ(meshlet.Count % 3, 0);
+        EXPECT_LE(meshlet.Count / 3, maxTriangles);
+
+        const auto indices = std::span {grid.Indices}.subspan(meshlet.FirstIndex, meshlet.Count);
+        EXPECT_LE(std::unordered_set<uint32_t>(indices.begin(), indices.end()).size(), maxVertices);
+        expectedFirst += meshlet.Count;
+    }
+    EXPECT_EQ(expectedFirst, grid.Indices.size());
+}
+
+TEST(MeshletSet, ComputesBounds)
+{
+    auto grid = MakeGrid(8);
+    for (auto& position : grid.Positions)
+        position.z = std::sin(position.x) * 0.1f;
+
+    const auto meshlets = MeshletSet::Build(grid.Indices, grid.Positions);
+    for (const auto& meshlet : meshlets)
+    {
+        for (const auto index : std::span {grid.Indices}.subspan(meshlet.FirstIndex, meshlet.Count))
+            EXPECT_LE(glm::length(grid.Positions[index] - meshlet.Center), meshlet.Radius + 1e-4f);
+
+        // mostly flat surface facing +Z
+        EXPECT_GT(meshlet.ConeAxis.z, 0.9f);
+        EXPECT_LT(meshlet.ConeCutoff, 0.5f);
+    }
+}
+
+TEST(MeshletSet, DisablesWideCones)
+{
+    // two triangles facing opposite directions
+    const std::vector positions {glm::vec3 {0.0f, 0.0f, 0.0f}, glm::vec3 {1.0f, 0.0f, 0.0f}, glm::vec3 {0.0f, 1.0f, 0.0f}};
+    const std::vector<uint32_t> indices {0, 1, 2, 0, 2, 1};
+
+    const auto meshlets = MeshletSet::Build(indices, positions);
+    ASSERT_EQ(meshlets.size(), 1);
+    EXPECT_EQ(meshlets[0].ConeCutoff, 1.0f);
+}
+
+TEST(MeshletSet, PlacesMeshletsAndBlocks)
+{
+    const auto grid = MakeGrid(16);
+    const auto meshlets = MeshletSet::Build(grid.Indices, grid.Positions, 16, 16);
+    ASSERT_GT(meshlets.size(), MeshletSet::BlockSize);
+    ASSERT_NE(meshlets.size() % MeshletSet::BlockSize, 0);
+
+    MeshletSet set;
+    set.Append(meshlets, MeshChunk {Primitives::Triangles {}, 100, static_cast<unsigned int>(grid.Indices.size()), 10});
+    ASSERT_EQ(set.Size(), meshlets.size());
+
+    const auto blocks = set.GetBlocks();
+    EXPECT_EQ(blocks.size(), (meshlets.size() + MeshletSet::BlockSize - 1) / MeshletSet::BlockSize * MeshletSet::BlockFloats);
+
+    for (size_t i = 0; i < set.Size(); ++i)
+    {
+        const auto& meshlet = set.GetMeshlets()[i];
+        EXPECT_EQ(meshlet.FirstIndex, meshlets[i].FirstIndex + 100);
+        EXPECT_EQ(meshlet.BaseVertex, 10);
+
+        const auto* block = blocks.data() + i / MeshletSet::BlockSize * MeshletSet::BlockFloats + i % MeshletSet::BlockSize;
+        EXPECT_EQ(block[0], meshlet.Center.x);
+        EXPECT_EQ(block[4], meshlet.Center.y);
+        EXPECT_EQ(block[12], meshlet.Radius);
+        EXPECT_EQ(block[24], meshlet.ConeAxis.z);
+        EXPECT_EQ(block[28], meshlet.ConeCutoff);
+    }
+
+    // box of the set contains the whole grid
+    EXPECT_LE(set.GetBoundsMin().x, 0.0f);
+    EXPECT_LE(set.GetBoundsMin().y, 0.0f);
+    EXPECT_GE(set.GetBoundsMax().x, 16.0f);
+    EXPECT_GE(set.GetBoundsMax().y, 16.0f);
+    EXPECT_GT(MeshletSet {}.GetBoundsMin().x, MeshletSet {}.GetBoundsMax().x);
+
+    // same layout when constructed of placed meshlets
+    const MeshletSet copy {std::vector(set.GetMeshlets().begin(), set.GetMeshlets().end())};
+    EXPECT_TRUE(std::ranges::equal(copy.GetBlocks(), blocks));
+}
+
+TEST(MeshletSet, ChecksInput)
+{
+    const auto grid = MakeGrid(2);
+    EXPECT_THROW((void)MeshletSet::Build(std::span {grid.Indices}.first(4), grid.Positions), AT2Exception);
+    EXPECT_THROW((void)MeshletSet::Build(grid.Indices, std::span {grid.Positions}.first(4)), AT2Exception);
+    EXPECT_THROW((void)MeshletSet::Build(grid.Indices, grid.Positions, 2), AT2Exception);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/Resources/MipmapGenerator.h>
+#include <AT2/Core/ThreadPool.h>
+
+#include "FakeResources.h"
+
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+
+using namespace AT2;
+using namespace AT2::Resources;
+using namespace AT2::Tests;
+
+namespace
+{
+    MipmapGenerator::Image MakeCheckerboard(glm::uvec2 size, glm::u8vec4 first, glm::u8vec4 second)
+    {
+        MipmapGenerator::Image image {size, {}};
+        for (unsigned y = 0; y < size.y; ++y)
+            for (unsigned x = 0; x < size.x; ++x)
+                image.Texels.push_back((x + y) % 2 ? second : first);
+
+        return image;
+    }
+
+    template <typename T>
+    std::span<const std::byte> AsBytes(const std::vector<T>& data)
+    {
+        return std::as_bytes(std::span {data});
+    }
+
+    template <typename T>
+    std::vector<T> FromBytes(const std::vector<std::byte>& data)
+    {
+        std::vector<T> result(data.size() / sizeof(T));
+        std::memcpy(result.data(), data.data(), data.size());
+        return result;
+    }
+} // namespace
+
+TEST(MipmapGenerator, BuildsChainDownToOneTexel)
+{
+    ASSERT_EQ(MipmapGenerator::GetNumLevels({1, 1}), 1);
+    ASSERT_EQ(MipmapGenerator::GetNumLevels({256, 256}), 9);
+    ASSERT_EQ(MipmapGenerator::GetNumLevels({300, 20}), 9);
+
+    const MipmapGenerator generator {MipmapFilter::Box, false};
+    const auto levels = generator.Generate(MakeCheckerboard({16, 4}, {0, 0, 0, 255}, {255, 255, 255, 255}));
+    ASSERT_EQ(levels.size(), 5);
+
+    const glm::uvec2 expectedSizes[] {{16, 4}, {8, 2}, {4, 1}, {2, 1}, {1, 1}};
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        ASSERT_EQ(levels[i].Size, expectedSizes[i]);
+        ASSERT_EQ(levels[i].Texels.size(), size_t {expectedSizes[i].x} * expectedSizes[i].y);
+    }
+
+    ASSERT_THROW((void)generator.Generate({{2, 2}, {{0, 0, 0, 0}}}), AT2TextureException);
+}
+
+TEST(MipmapGenerator, AveragesInLinearSpace)
+{
+    const auto checkerboard = MakeCheckerboard({8, 8}, {0, 0, 0, 0}, {255, 255, 255, 255});
+
+    // half of the light is 0.5 in linear space, which is 188 in sRGB; alpha is always linear
+    const auto srgbLevels = MipmapGenerator {MipmapFilter::Box, true}.Generate(checkerboard);
+    for (const auto texel : srgbLevels[1].Texels)
+        ASSERT_EQ(texel, glm::u8vec4(188, 188, 188, 128));
+
+    const auto linearLevels = MipmapGenerator {MipmapFilter::Box, false}.Generate(checkerboard);
+    for (const auto texel : linearLevels[1].Texels)
+        ASSERT_EQ(texel, glm::u8vec4(128));
+}
+
+TEST(MipmapGenerator, KaiserKeepsFlatImagesAndMatchesParallelResult)
+{
+    MipmapGenerator::Image flat {{13, 7}, std::vector<glm::u8vec4>(13 * 7, glm::u8vec4 {10, 100, 200, 255})};
+    for (const auto& level : MipmapGenerator {MipmapFilter::Kaiser, true}.Generate(flat))
+        for (const auto texel : level.Texels)
+            ASSERT_EQ(texel, glm::u8vec4(10, 100, 200, 255));
+
+    MipmapGenerator::Image gradient {{300, 200}, std::vector<glm::u8vec4>(300 * 200)};
+    for (size_t i = 0; i < gradient.Texels.size(); ++i)
+        gradient.Texels[i] = {i % 256, (i / 300) % 256, (i * 7) % 256, 255};
+
+    ThreadPool threadPool {4};
+    const auto serialLevels = MipmapGenerator {MipmapFilter::Kaiser, true}.Generate(gradient);
+    const auto parallelLevels = MipmapGenerator {MipmapFilter::Kaiser, true, &threadPool}.Generate(gradient);
+
+    ASSERT_EQ(serialLevels.size(), parallelLevels.size());
+    for (size_t i = 0; i < serialLevels.size(); ++i)
+        ASSERT_EQ(serialLevels[i].Texels, parallelLevels[i].Texels);
+}
+
+TEST(MipmapGenerator, ReducesVolumesAtAllDimensions)
+{
+    ASSERT_EQ(MipmapGenerator::GetNumLevels(glm::uvec3 {64, 64, 64}), 7);
+    ASSERT_EQ(MipmapGenerator::GetNumLevels(glm::uvec3 {4, 2, 8}), 4);
+
+    // 2x2x2 blocks are averaged exactly
+    const glm::uvec3 size {4, 4, 2};
+    std::vector<glm::u8vec4> volume;
+    for (unsigned z = 0; z < size.z; ++z)
+        for (unsigned y = 0; y < size.y; ++y)
+            for (unsigned x = 0; x < size.x; ++x)
+                volume.emplace_back(x * 60, y * 60, z * 200, (x + y + z) % 2 ? 255 : 0);
+
+    ThreadPool threadPool {2};
+    const auto levels = MipmapGenerator {MipmapFilter::Box, false, &threadPool}.Generate(TextureFormats::RGBA8, size, AsBytes(volume), 16);
+    ASSERT_EQ(levels.size(), 3);
+    ASSERT_EQ(levels[1].size(), 2 * 2 * 1 * 4);
+    ASSERT_EQ(levels[2].size(), 4);
+
+    const auto secondLevel = FromBytes<glm::u8vec4>(levels[1]);
+    ASSERT_EQ(secondLevel[0], glm::u8vec4(30, 30, 100, 128));
+    ASSERT_EQ(secondLevel[3], glm::u8vec4(150, 150, 100, 128));
+    ASSERT_EQ(FromBytes<glm::u8vec4>(levels[2])[0], glm::u8vec4(90, 90, 100, 128));
+
+    ASSERT_THROW((void)MipmapGenerator(MipmapFilter::Box, false).Generate(TextureFormats::RGBA8, size, AsBytes(volume).first(8), 2),
+                 AT2TextureException);
+}
+
+TEST(MipmapGenerator, KeepsFloatRangeAndPrecision)
+{
+    const MipmapGenerator generator {MipmapFilter::Box, true};
+
+    // float formats are never sRGB-decoded or clamped
+    const std::vector<glm::vec4> floats {{0.0f, -1.0f, 10.0f, 1.0f}, {1.0f, 3.0f, 20.0f, 0.0f}};
+    const auto floatLevels = generator.Generate(TextureFormats::RGBA32F, {2, 1, 1}, AsBytes(floats), 2);
+    ASSERT_EQ(floatLevels.size(), 2);
+    ASSERT_EQ(FromBytes<glm::vec4>(floatLevels[1])[0], glm::vec4(0.5f, 1.0f, 15.0f, 0.5f));
+
+    std::vector<glm::uint64> halfs;
+    for (const auto& texel : floats)
+        halfs.push_back(glm::packHalf4x16(texel));
+
+    const auto halfLevels = generator.Generate(TextureFormats::RGBA16F, {2, 1, 1}, AsBytes(halfs), 2);
+    ASSERT_EQ(glm::unpackHalf4x16(FromBytes<glm::uint64>(halfLevels[1])[0]), glm::vec4(0.5f, 1.0f, 15.0f, 0.5f));
+
+    ASSERT_THROW((void)generator.Generate({TextureLayout::RGB, BufferDataType::UByte}, {2, 1, 1}, AsBytes(halfs).first(6), 2),
+                 AT2TextureException);
+}
+
+TEST(MipmapGenerator, UploadsAllLevelsOfEveryLayer)
+{
+    const MipmapGenerator generator {MipmapFilter::Kaiser, false};
+
+    FakeTexture texture2D {Texture2D {{8, 4}, 3}};
+    generator.Upload(texture2D, TextureFormats::RGBA8, AsBytes(std::vector<glm::u8vec4>(8 * 4)));
+    ASSERT_EQ(texture2D.Uploads.size(), 3);
+    ASSERT_EQ(texture2D.Uploads[2].Size, glm::uvec3(2, 1, 1));
+    ASSERT_EQ(texture2D.Uploads[2].Level, 2);
+
+    // the fake rejects faces out of the texture bounds, like GlTexture does
+    FakeTexture cube {TextureCube {{4, 4}, 3}};
+    ASSERT_EQ(cube.GetSize(), glm::uvec3(4, 4, 6));
+    ASSERT_THROW(cube.SubImage3D({0, 0, 6}, {4, 4, 1}, 0, TextureFormats::RGBA16F, nullptr), AT2TextureException);
+    generator.Upload(cube, TextureFormats::RGBA16F, AsBytes(std::vector<glm::uint64>(4 * 4 * 6)));
+    ASSERT_EQ(cube.Uploads.size(), 6 * 3);
+    for (unsigned face = 0; face < 6; ++face)
+        for (unsigned level = 0; level < 3; ++level)
+        {
+            const auto& upload = cube.Uploads[face * 3 + level];
+            ASSERT_EQ(upload.Offset, glm::uvec3(0, 0, face));
+            ASSERT_EQ(upload.Size, glm::uvec3(4 >> level, 4 >> level, 1));
+            ASSERT_EQ(upload.Level, level);
+            ASSERT_EQ(upload.Length, size_t {4u >> level} * (4u >> level) * 8);
+        }
+
+    // faces are missing
+    ASSERT_THROW(generator.Upload(cube, TextureFormats::RGBA16F, AsBytes(std::vector<glm::uint64>(4 * 4))), AT2TextureException);
+}
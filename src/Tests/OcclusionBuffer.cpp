@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/OcclusionBuffer.h>
+
+#include "TestUtils.h"
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+namespace
+{
+    glm::mat4 ViewProjectionFrom(const glm::vec3& eye, const glm::vec3& target) { return Projection * LookFrom(eye, target); }
+
+    // 10 x 10 square at XY plane facing +Z
+    const OccluderMesh Wall {{{-5.0f, -5.0f, 0.0f}, {5.0f, -5.0f, 0.0f}, {5.0f, 5.0f, 0.0f}, {-5.0f, 5.0f, 0.0f}}, {0, 1, 2, 0, 2, 3}};
+
+    bool IsBoxOccluded(const OcclusionBuffer& buffer, const glm::vec3& center, float halfSize = 1.0f)
+    {
+        return buffer.IsOccluded(center - glm::vec3 {halfSize}, center + glm::vec3 {halfSize}, glm::mat4 {1.0f});
+    }
+} // namespace
+
+TEST(OcclusionBuffer, RoundsSizeToTiles)
+{
+    EXPECT_EQ(OcclusionBuffer {glm::uvec2(30, 17)}.GetSize(), glm::uvec2(32, 24));
+    EXPECT_THROW(OcclusionBuffer {glm::uvec2(0, 16)}, AT2Exception);
+}
+
+TEST(OcclusionBuffer, HidesObjectsBehindOccluders)
+{
+    OcclusionBuffer buffer {glm::uvec2(64, 64)};
+    buffer.Clear(ViewProjectionFrom({0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, 0.0f}));
+    buffer.RenderOccluder(Wall, glm::mat4 {1.0f});
+    buffer.Resolve();
+
+    EXPECT_EQ(buffer.GetNumRasterizedTriangles(), 2);
+    EXPECT_LT(buffer.GetDepth(32, 32), 1.0f);
+    EXPECT_EQ(buffer.GetDepth(0, 0), OcclusionBuffer::ClearDepth);
+
+    EXPECT_TRUE(IsBoxOccluded(buffer, {0.0f, 0.0f, -5.0f}));
+    EXPECT_FALSE(IsBoxOccluded(buffer, {0.0f, 0.0f, 2.0f}));
+    // behind the wall, but it's seen past the edge
+    EXPECT_FALSE(IsBoxOccluded(buffer, {10.0f, 0.0f, -5.0f}));
+    // out of the buffer
+    EXPECT_FALSE(IsBoxOccluded(buffer, {100.0f, 0.0f, -5.0f}));
+
+    // the same box with the wall moved away
+    buffer.Clear(ViewProjectionFrom({0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, 0.0f}));
+    buffer.RenderOccluder(Wall, glm::translate(glm::mat4 {1.0f}, {20.0f, 0.0f, 0.0f}));
+    buffer.Resolve();
+    EXPECT_FALSE(IsBoxOccluded(buffer, {0.0f, 0.0f, -5.0f}));
+}
+
+TEST(OcclusionBuffer, SkipsBackFaces)
+{
+    OcclusionBuffer buffer {glm::uvec2(64, 64)};
+    buffer.Clear(ViewProjectionFrom({0.0f, 0.0f, -10.0f}, {0.0f, 0.0f, 0.0f}));
+    buffer.RenderOccluder(Wall, glm::mat4 {1.0f});
+    buffer.Resolve();
+
+    EXPECT_EQ(buffer.GetNumRasterizedTriangles(), 0);
+    EXPECT_FALSE(IsBoxOccluded(buffer, {0.0f, 0.0f, 5.0f}));
+}
+
+TEST(OcclusionBuffer, ClipsOccludersByNearPlane)
+{
+    // floor going from behind of the camera far ahead
+    const OccluderMesh floor {{{-50.0f, -1.0f, 20.0f}, {50.0f, -1.0f, 20.0f}, {50.0f, -1.0f, -50.0f}, {-50.0f, -1.0f, -50.0f}},
+                              {0, 1, 2, 0, 2, 3}};
+
+    OcclusionBuffer buffer {glm::uvec2(64, 64)};
+    buffer.Clear(ViewProjectionFrom({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}));
+    buffer.RenderOccluder(floor, glm::mat4 {1.0f});
+    buffer.Resolve();
+
+    EXPECT_GT(buffer.GetNumRasterizedTriangles(), 0);
+    EXPECT_TRUE(IsBoxOccluded(buffer, {0.0f, -2.5f, -10.0f}, 0.5f));
+    EXPECT_FALSE(IsBoxOccluded(buffer, {0.0f, 0.5f, -10.0f}, 0.5f));
+    // box around the camera
+    EXPECT_FALSE(IsBoxOccluded(buffer, {0.0f, 0.0f, 0.0f}, 0.5f));
+}
+
+TEST(OcclusionBuffer, ChecksOccluders)
+{
+    OcclusionBuffer buffer {glm::uvec2(16, 16)};
+    buffer.Clear(ViewProjectionFrom({0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, 0.0f}));
+
+    const std::vector<uint32_t> notTriangles {0, 1, 2, 3};
+    EXPECT_THROW(buffer.RenderOccluder(Wall.Positions, notTriangles, glm::mat4 {1.0f}), AT2Exception);
+
+    const std::vector<uint32_t> outOfRange {0, 1, 4};
+    EXPECT_THROW(buffer.RenderOccluder(Wall.Positions, outOfRange, glm::mat4 {1.0f}), AT2Exception);
+}
+
+TEST(OcclusionBuffer, BuildsOccludersInsideOfSurface)
+{
+    // unit cube with counter-clockwise faces looking outside, the last vertex isn't used
+    std::vector<glm::vec3> positions;
+    for (unsigned int corner = 0; corner < 8; ++corner)
+        positions.emplace_back(corner & 1 ? 0.5f : -0.5f, corner & 2 ? 0.5f : -0.5f, corner & 4 ? 0.5f : -0.5f);
+    positions.emplace_back(10.0f);
+
+    const std::vector<uint32_t> indices {0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6, 0, 1, 5, 0, 5, 4,
+                                         2, 6, 7, 2, 7, 3, 0, 4, 6, 0, 6, 2, 1, 3, 7, 1, 7, 5};
+
+    const auto occluder = OccluderMesh::Build(positions, indices, 0.1f);
+    ASSERT_EQ(occluder.Positions.size(), 8);
+    ASSERT_EQ(occluder.Indices.size(), indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        EXPECT_EQ(glm::sign(occluder.Positions[occluder.Indices[i]]), glm::sign(positions[indices[i]]));
+    for (const auto& position : occluder.Positions)
+        EXPECT_TRUE(glm::all(glm::lessThan(glm::abs(position), glm::vec3 {0.5f})));
+
+    // vertices are kept as is without the inset
+    const auto exact = OccluderMesh::Build(positions, indices);
+    ASSERT_EQ(exact.Indices.size(), indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        EXPECT_EQ(exact.Positions[exact.Indices[i]], positions[indices[i]]);
+
+    EXPECT_THROW(OccluderMesh::Build(positions, std::vector<uint32_t> {0, 1, 9}), AT2Exception);
+}
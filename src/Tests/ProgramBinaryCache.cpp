@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ProgramBinaryCache.h>
+
+#include <array>
+#include <sstream>
+
+using namespace AT2;
+using namespace std::literals;
+
+namespace
+{
+    ProgramBinaryCache::Entry MakeEntry(std::uint32_t format, size_t size)
+    {
+        ProgramBinaryCache::Entry entry {format, std::vector<std::byte>(size)};
+        for (size_t i = 0; i < size; ++i)
+            entry.Data[i] = static_cast<std::byte>(i * 7 + 3);
+        return entry;
+    }
+} // namespace
+
+TEST(ProgramBinaryCache, KeyDoesNotDependOnStagesOrder)
+{
+    const std::array stages {ProgramBinaryCache::Stage {1, "vertex"sv}, ProgramBinaryCache::Stage {2, "fragment"sv}};
+    const std::array reversedStages {stages[1], stages[0]};
+
+    ASSERT_EQ(ProgramBinaryCache::ComputeKey(stages, "driver"), ProgramBinaryCache::ComputeKey(reversedStages, "driver"));
+}
+
+TEST(ProgramBinaryCache, KeyDependsOnSourcesAndDriver)
+{
+    const std::array stages {ProgramBinaryCache::Stage {1, "vertex"sv}, ProgramBinaryCache::Stage {2, "fragment"sv}};
+    const auto key = ProgramBinaryCache::ComputeKey(stages, "driver");
+
+    ASSERT_NE(key, ProgramBinaryCache::ComputeKey(stages, "driver 2"));
+
+    const std::array changedSource {ProgramBinaryCache::Stage {1, "vertex "sv}, stages[1]};
+    ASSERT_NE(key, ProgramBinaryCache::ComputeKey(changedSource, "driver"));
+
+    const std::array changedType {ProgramBinaryCache::Stage {3, "vertex"sv}, stages[1]};
+    ASSERT_NE(key, ProgramBinaryCache::ComputeKey(changedType, "driver"));
+
+    const std::array movedText {ProgramBinaryCache::Stage {1, "vertexf"sv}, ProgramBinaryCache::Stage {2, "ragment"sv}};
+    ASSERT_NE(key, ProgramBinaryCache::ComputeKey(movedText, "driver"));
+}
+
+TEST(ProgramBinaryCache, EntryRoundTrip)
+{
+    const auto entry = MakeEntry(0x8741, 1000);
+
+    std::stringstream stream;
+    ProgramBinaryCache::Write(stream, 42, entry);
+
+    const auto restored = ProgramBinaryCache::Read(stream, 42);
+    ASSERT_TRUE(restored.has_value());
+    ASSERT_EQ(restored->BinaryFormat, entry.BinaryFormat);
+    ASSERT_EQ(restored->Data, entry.Data);
+}
+
+TEST(ProgramBinaryCache, RejectsMismatchedOrCorruptedEntries)
+{
+    std::stringstream stream;
+    ProgramBinaryCache::Write(stream, 42, MakeEntry(1, 64));
+    const auto serialized = stream.str();
+
+    {
+        std::istringstream wrongKey {serialized};
+        ASSERT_FALSE(ProgramBinaryCache::Read(wrongKey, 43).has_value());
+    }
+    {
+        std::istringstream truncated {serialized.substr(0, serialized.size() - 1)};
+        ASSERT_FALSE(ProgramBinaryCache::Read(truncated, 42).has_value());
+    }
+    {
+        auto flipped = serialized;
+        flipped.back() ^= 0x01;
+        std::istringstream corrupted {flipped};
+        ASSERT_FALSE(ProgramBinaryCache::Read(corrupted, 42).has_value());
+    }
+    {
+        auto badMagic = serialized;
+        badMagic[0] = 'X';
+        std::istringstream foreign {badMagic};
+        ASSERT_FALSE(ProgramBinaryCache::Read(foreign, 42).has_value());
+    }
+}
+
+TEST(ProgramBinaryCache, StoresAndLoadsFromDirectory)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "AT2_ProgramBinaryCache_Test";
+    std::filesystem::remove_all(directory);
+
+    {
+        const ProgramBinaryCache cache {directory, "driver"};
+        ASSERT_FALSE(cache.Load(7).has_value());
+
+        const auto entry = MakeEntry(5, 300);
+        ASSERT_TRUE(cache.Store(7, entry));
+
+        const auto loaded = cache.Load(7);
+        ASSERT_TRUE(loaded.has_value());
+        ASSERT_EQ(loaded->Data, entry.Data);
+
+        cache.Invalidate(7);
+        ASSERT_FALSE(cache.Load(7).has_value());
+    }
+
+    std::filesystem::remove_all(directory);
+}
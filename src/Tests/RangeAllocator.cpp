@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/RangeAllocator.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace AT2;
+
+TEST(RangeAllocator, AllocatesUntilFull)
+{
+    RangeAllocator allocator(100);
+
+    const auto first = allocator.Allocate(60);
+    const auto second = allocator.Allocate(40);
+    ASSERT_TRUE(first && second);
+    ASSERT_EQ(first->Offset, 0);
+    ASSERT_EQ(second->Offset, 60);
+    ASSERT_EQ(allocator.GetFreeSpace(), 0);
+
+    ASSERT_FALSE(allocator.Allocate(1).has_value());
+}
+
+TEST(RangeAllocator, CoalescesFreedNeighbours)
+{
+    RangeAllocator allocator(30);
+
+    const auto a = allocator.Allocate(10);
+    const auto b = allocator.Allocate(10);
+    const auto c = allocator.Allocate(10);
+
+    allocator.Free(*a);
+    allocator.Free(*c);
+    ASSERT_EQ(allocator.GetNumFreeBlocks(), 2);
+    ASSERT_EQ(allocator.GetLargestFreeBlock(), 10);
+    ASSERT_FALSE(allocator.Allocate(20).has_value());
+
+    allocator.Free(*b);
+    ASSERT_EQ(allocator.GetNumFreeBlocks(), 1);
+    ASSERT_EQ(allocator.GetLargestFreeBlock(), 30);
+    ASSERT_DOUBLE_EQ(allocator.GetFragmentation(), 0.0);
+}
+
+TEST(RangeAllocator, PrefersBestFittingBlock)
+{
+    RangeAllocator allocator(100);
+
+    const auto a = allocator.Allocate(50);
+    const auto b = allocator.Allocate(10);
+    const auto c = allocator.Allocate(20);
+    const auto d = allocator.Allocate(20);
+    ASSERT_TRUE(a && b && c && d);
+
+    allocator.Free(*a); // 50 elements hole
+    allocator.Free(*c); // 20 elements hole
+
+    const auto fitting = allocator.Allocate(15);
+    ASSERT_TRUE(fitting.has_value());
+    ASSERT_EQ(fitting->Offset, c->Offset);
+}
+
+TEST(RangeAllocator, RespectsAlignment)
+{
+    RangeAllocator allocator(64);
+
+    ASSERT_TRUE(allocator.Allocate(3).has_value());
+    const auto aligned = allocator.Allocate(8, 16);
+    ASSERT_TRUE(aligned.has_value());
+    ASSERT_EQ(aligned->Offset % 16, 0);
+
+    // padding before aligned block is still usable
+    const auto small = allocator.Allocate(13);
+    ASSERT_TRUE(small.has_value());
+    ASSERT_EQ(small->Offset, 3);
+}
+
+TEST(RangeAllocator, GrowKeepsAllocations)
+{
+    RangeAllocator allocator(10);
+
+    const auto a = allocator.Allocate(8);
+    allocator.Grow(20);
+    ASSERT_EQ(allocator.GetCapacity(), 20);
+    ASSERT_EQ(allocator.GetFreeSpace(), 12);
+
+    // tail of the old range is merged with the new space
+    const auto b = allocator.Allocate(12);
+    ASSERT_TRUE(b.has_value());
+    ASSERT_EQ(b->Offset, 8);
+    ASSERT_EQ(a->Offset, 0);
+}
+
+TEST(RangeAllocator, RandomAllocationsDoNotOverlap)
+{
+    RangeAllocator allocator(1 << 16);
+    std::mt19937 generator {7};
+    std::uniform_int_distribution<size_t> sizeDistribution {1, 512};
+
+    std::vector<RangeAllocator::Allocation> allocations;
+    for (int i = 0; i < 5000; ++i)
+    {
+        if (!allocations.empty() && generator() % 3 == 0)
+        {
+            const size_t index = generator() % allocations.size();
+            allocator.Free(allocations[index]);
+            allocations.erase(allocations.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+        else if (const auto allocation = allocator.Allocate(sizeDistribution(generator)))
+            allocations.push_back(*allocation);
+    }
+
+    std::ranges::sort(allocations, {}, &RangeAllocator::Allocation::Offset);
+    size_t usedSpace = 0;
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+        usedSpace += allocations[i].Size;
+        if (i > 0)
+        {
+            ASSERT_LE(allocations[i - 1].Offset + allocations[i - 1].Size, allocations[i].Offset);
+        }
+    }
+    ASSERT_EQ(usedSpace + allocator.GetFreeSpace(), allocator.GetCapacity());
+
+    for (const auto& allocation : allocations)
+        allocator.Free(allocation);
+    ASSERT_EQ(allocator.GetNumFreeBlocks(), 1);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/DrawBatch.h>
+#include <AT2/Core/LodSelector.h>
+#include <AT2/Core/RecordingRenderer.h>
+
+using namespace AT2;
+
+namespace
+{
+    class FakeRenderer : public IRenderer
+    {
+    public:
+        void Draw(Primitives::Primitive, size_t, long int count, int, int) override { DrawnVertices += static_cast<size_t>(count); }
+        void SetViewport(const AABB2d&) override {}
+        void SetScissorWindow(const AABB2d&) override {}
+
+        [[nodiscard]] IVisualizationSystem& GetVisualizationSystem() override { throw AT2NotImplementedException("FakeRenderer"); }
+        [[nodiscard]] IStateManager& GetStateManager() override { throw AT2NotImplementedException("FakeRenderer"); }
+
+        size_t DrawnVertices = 0;
+    };
+
+    void Submit(IRenderer& renderer, const DrawBatch& batch)
+    {
+        for (const auto& run : batch.GetRuns())
+            renderer.MultiDrawIndexed(run.Type, batch.GetCommands().subspan(run.FirstCommand, run.NumCommands));
+    }
+} // namespace
+
+TEST(RecordingRenderer, CountsTriangles)
+{
+    EXPECT_EQ(RecordingRenderer::GetNumTriangles(Primitives::Triangles {}, 7), 2);
+    EXPECT_EQ(RecordingRenderer::GetNumTriangles(Primitives::TriangleStrip {}, 6), 4);
+    EXPECT_EQ(RecordingRenderer::GetNumTriangles(Primitives::TriangleFan {}, 2), 0);
+    EXPECT_EQ(RecordingRenderer::GetNumTriangles(Primitives::TrianglesAdjacency {}, 12), 2);
+    EXPECT_EQ(RecordingRenderer::GetNumTriangles(Primitives::TriangleStripAdjacency {}, 10), 3);
+    EXPECT_EQ(RecordingRenderer::GetNumTriangles(Primitives::Lines {}, 10), 0);
+    EXPECT_EQ(RecordingRenderer::GetNumTriangles(Primitives::Patches {3}, 9), 0);
+}
+
+TEST(RecordingRenderer, RecordsAndForwardsDraws)
+{
+    FakeRenderer renderer;
+    RecordingRenderer recorder {renderer};
+
+    recorder.Draw(Primitives::Triangles {}, 0, 6, 4);
+    const std::array commands {DrawElementsIndirectCommand {30, 1, 0, 0, 0}, DrawElementsIndirectCommand {12, 2, 30, 0, 0}};
+    recorder.MultiDrawIndexed(Primitives::Triangles {}, commands);
+
+    const auto& statistics = recorder.GetStatistics();
+    EXPECT_EQ(statistics.NumDrawCalls, 2);
+    EXPECT_EQ(statistics.NumCommands, 3);
+    EXPECT_EQ(statistics.NumInstances, 7);
+    EXPECT_EQ(statistics.NumTriangles, 2 * 4 + 10 + 4 * 2);
+    EXPECT_EQ(renderer.DrawnVertices, 6 + 30 + 12);
+
+    recorder.ResetStatistics();
+    EXPECT_EQ(recorder.GetStatistics().NumTriangles, 0);
+}
+
+TEST(RecordingRenderer, MeasuresLodReduction)
+{
+    SubMesh subMesh {std::vector {MeshChunk {Primitives::Triangles {}, 0, 3000}}};
+    subMesh.Lods.push_back({0.1f, {MeshChunk {Primitives::Triangles {}, 3000, 600}}});
+
+    const LodSelector selector {glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 1000.0f), 1000.0f};
+    const auto drawAt = [&](float distance) {
+        FakeRenderer renderer;
+        RecordingRenderer recorder {renderer};
+
+        const auto lod = selector.Select(subMesh, glm::translate(glm::mat4 {1.0f}, {0.0f, 0.0f, -distance}), 0);
+        DrawBatch batch;
+        for (const auto& chunk : subMesh.GetPrimitives(lod))
+            batch.Add(chunk);
+        Submit(recorder, batch);
+
+        return recorder.GetStatistics().NumTriangles;
+    };
+
+    EXPECT_EQ(drawAt(10.0f), 1000);
+    EXPECT_EQ(drawAt(500.0f), 200);
+}
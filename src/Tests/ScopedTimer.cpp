@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ScopedTimer.h>
+
+#include <thread>
+
+using namespace AT2;
+using namespace std::literals;
+
+TEST(ScopedTimer, AddsTimeOfScopes)
+{
+    std::chrono::duration<double, std::milli> total {};
+    {
+        ScopedTimer timer {total};
+        std::this_thread::sleep_for(10ms);
+        EXPECT_EQ(total.count(), 0.0);
+    }
+    EXPECT_GE(total.count(), 10.0);
+
+    const auto first = total;
+    {
+        ScopedTimer timer {total};
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_GE((total - first).count(), 10.0);
+}
+
+TEST(ScopedTimer, TruncatesToIntegralDurations)
+{
+    std::chrono::seconds total {5};
+    {
+        ScopedTimer timer {total};
+    }
+    EXPECT_EQ(total, 5s);
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ShaderPermutations.h>
+
+#include "FakeResources.h"
+
+using namespace AT2;
+using namespace AT2::Tests;
+
+TEST(ShaderPermutations, MakesDefinesFromFeatureBits)
+{
+    FakeResourceFactory factory;
+    const ShaderPermutations permutations {factory, {"mesh.vs.glsl"}, {"SKINNING", "NORMAL_MAP", "ALPHA_TEST"}};
+
+    ASSERT_TRUE(permutations.MakeDefines(0).empty());
+
+    const auto defines = permutations.MakeDefines(0b101);
+    ASSERT_EQ(defines.size(), 2);
+    ASSERT_EQ(defines[0].Name, "SKINNING");
+    ASSERT_EQ(defines[1].Name, "ALPHA_TEST");
+
+    ASSERT_THROW((void)permutations.MakeDefines(0b1000), AT2Exception);
+}
+
+TEST(ShaderPermutations, BuildsOnlyRequestedVariantsOnce)
+{
+    FakeResourceFactory factory;
+    ShaderPermutations permutations {factory, {"mesh.vs.glsl", "mesh.fs.glsl"}, {"SKINNING", "NORMAL_MAP"}};
+
+    const auto skinned = permutations.Get(0b01);
+    const auto plain = permutations.Get(0);
+    ASSERT_EQ(factory.NumCreatedPrograms, 2);
+    ASSERT_EQ(permutations.GetNumVariants(), 2);
+    ASSERT_NE(skinned, plain);
+
+    ASSERT_EQ(permutations.Get(0b01), skinned);
+    ASSERT_EQ(factory.NumCreatedPrograms, 2);
+
+    const auto& skinnedDefines = dynamic_cast<const FakeShaderProgram&>(*skinned).Defines;
+    ASSERT_EQ(skinnedDefines.size(), 1);
+    ASSERT_EQ(skinnedDefines[0].Name, "SKINNING");
+}
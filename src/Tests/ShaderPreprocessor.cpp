@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <AT2/AT2_exceptions.hpp>
+#include <AT2/Core/ShaderPreprocessor.h>
+
+#include <array>
+#include <map>
+
+using namespace AT2;
+using namespace std::literals;
+
+namespace
+{
+    ShaderPreprocessor MakePreprocessor(std::map<std::filesystem::path, std::string> files)
+    {
+        return ShaderPreprocessor {[files = std::move(files)](const std::filesystem::path& path) -> std::optional<std::string> {
+            if (const auto it = files.find(path); it != files.end())
+                return it->second;
+            return std::nullopt;
+        }};
+    }
+
+    size_t CountOccurrences(std::string_view text, std::string_view pattern)
+    {
+        size_t count = 0;
+        for (auto position = text.find(pattern); position != std::string_view::npos; position = text.find(pattern, position + 1))
+            ++count;
+        return count;
+    }
+} // namespace
+
+TEST(ShaderPreprocessor, ResolvesIncludesRelativeToIncludingFile)
+{
+    const auto preprocessor = MakePreprocessor({
+        {"shaders/main.fs.glsl", "#version 420 core\n#include \"lib/common.glsl\"\nvoid main() {}\n"},
+        {"shaders/lib/common.glsl", "#version 420 core\n#include <math.glsl>\nfloat common_func();\n"},
+        {"shaders/lib/math.glsl", "float math_func();\n"},
+    });
+
+    const auto result = preprocessor.Process("shaders/main.fs.glsl");
+
+    ASSERT_EQ(result.Dependencies.size(), 3);
+    ASSERT_EQ(result.Dependencies[1], std::filesystem::path {"shaders/lib/common.glsl"});
+    ASSERT_EQ(result.Dependencies[2], std::filesystem::path {"shaders/lib/math.glsl"});
+
+    ASSERT_EQ(CountOccurrences(result.Source, "#version"), 1);
+    ASSERT_LT(result.Source.find("math_func"), result.Source.find("common_func"));
+    ASSERT_LT(result.Source.find("common_func"), result.Source.find("void main"));
+    ASSERT_EQ(result.Source.find("#include"), std::string::npos);
+}
+
+TEST(ShaderPreprocessor, IncludesEveryFileOnce)
+{
+    const auto preprocessor = MakePreprocessor({
+        {"main.glsl", "#include \"a.glsl\"\n#include \"b.glsl\"\n#include \"./a.glsl\"\n"},
+        {"a.glsl", "#pragma once\n#include \"b.glsl\"\nfloat a();\n"},
+        {"b.glsl", "#include \"a.glsl\"\nfloat b();\n"},
+    });
+
+    const auto result = preprocessor.Process("main.glsl");
+
+    ASSERT_EQ(result.Dependencies.size(), 3);
+    ASSERT_EQ(CountOccurrences(result.Source, "float a();"), 1);
+    ASSERT_EQ(CountOccurrences(result.Source, "float b();"), 1);
+    ASSERT_EQ(result.Source.find("#pragma"), std::string::npos);
+}
+
+TEST(ShaderPreprocessor, InjectsDefinesAfterVersion)
+{
+    const auto preprocessor = MakePreprocessor({});
+    const std::array defines {ShaderDefine {"SKINNING"}, ShaderDefine {"MAX_LIGHTS", "16"}};
+
+    const auto result = preprocessor.ProcessSource("// comment\n#version 420 core\nvoid main() {}\n", "main.vs.glsl", defines);
+
+    ASSERT_EQ(result.Source, "// comment\n#version 420 core\n#define SKINNING 1\n#define MAX_LIGHTS 16\n#line 3 0\nvoid main() {}\n");
+}
+
+TEST(ShaderPreprocessor, InjectsDefinesAtTopWithoutVersion)
+{
+    const auto preprocessor = MakePreprocessor({});
+    const std::array defines {ShaderDefine {"FEATURE"}};
+
+    const auto result = preprocessor.ProcessSource("void main() {}\n", "main.vs.glsl", defines);
+
+    ASSERT_EQ(result.Source, "#define FEATURE 1\n#line 1 0\nvoid main() {}\n");
+}
+
+TEST(ShaderPreprocessor, KeepsLineNumbering)
+{
+    const auto preprocessor = MakePreprocessor({{"lib.glsl", "float lib();\n"}});
+
+    const auto result = preprocessor.ProcessSource("#version 420\n#include \"lib.glsl\"\nvoid main() {}\n", "main.glsl");
+
+    ASSERT_EQ(result.Source, "#version 420\n#line 1 1\nfloat lib();\n#line 3 0\nvoid main() {}\n");
+}
+
+TEST(ShaderPreprocessor, IgnoresIncludesInComments)
+{
+    const auto preprocessor = MakePreprocessor({{"common.glsl", "float common;\n"}});
+
+    const auto result = preprocessor.ProcessSource("/* disabled\n#include \"missing.glsl\"\n*/\n"
+                                                   "/* one-line */\n#include \"common.glsl\"\n",
+                                                   "main.glsl");
+    EXPECT_EQ(result.Dependencies, (std::vector<std::filesystem::path> {"main.glsl", "common.glsl"}));
+    EXPECT_EQ(CountOccurrences(result.Source, "float common;"sv), 1);
+    EXPECT_EQ(CountOccurrences(result.Source, "#include \"missing.glsl\""sv), 1);
+}
+
+TEST(ShaderPreprocessor, RejectsIncludesInConditionalBlocks)
+{
+    const auto preprocessor = MakePreprocessor({{"a.glsl", "float a;\n"}, {"b.glsl", "float b;\n"}});
+
+    EXPECT_THROW((void)preprocessor.ProcessSource("#ifdef A\n#include \"a.glsl\"\n#else\n#include \"a.glsl\"\n#endif\n", "main.glsl"),
+                 AT2ShaderException);
+    EXPECT_THROW((void)preprocessor.ProcessSource("#if 1\n#if defined(A)\n#endif\n#include \"a.glsl\"\n#endif\n", "main.glsl"),
+                 AT2ShaderException);
+
+    // includes after closed blocks are fine
+    const auto result = preprocessor.ProcessSource("#ifndef A\n#define A\n#endif\n#include \"a.glsl\"\n", "main.glsl");
+    EXPECT_EQ(result.Dependencies, (std::vector<std::filesystem::path> {"main.glsl", "a.glsl"}));
+}
+
+TEST(ShaderPreprocessor, ReportsErrors)
+{
+    const auto preprocessor = MakePreprocessor({{"main.glsl", "#include \"missing.glsl\"\n"}});
+
+    ASSERT_THROW((void)preprocessor.Process("missing.glsl"), AT2IOException);
+    ASSERT_THROW((void)preprocessor.Process("main.glsl"), AT2IOException);
+    ASSERT_THROW((void)preprocessor.ProcessSource("#include missing.glsl\n", "main.glsl"), AT2ShaderException);
+
+    const std::array badDefines {ShaderDefine {"1ST"}};
+    ASSERT_THROW((void)preprocessor.ProcessSource("void main() {}\n", "main.glsl", badDefines), AT2ShaderException);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ShadowAtlas.h>
+
+#include <random>
+#include <vector>
+
+using namespace AT2;
+
+namespace
+{
+    bool Overlap(const ShadowAtlas::Tile& a, const ShadowAtlas::Tile& b)
+    {
+        return a.Offset.x < b.Offset.x + b.Size && b.Offset.x < a.Offset.x + a.Size && a.Offset.y < b.Offset.y + b.Size &&
+               b.Offset.y < a.Offset.y + a.Size;
+    }
+} // namespace
+
+TEST(ShadowAtlas, AllocatesQuadrantsUntilFull)
+{
+    ShadowAtlas atlas {256};
+
+    std::vector<ShadowAtlas::Tile> tiles;
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto tile = atlas.Allocate(128);
+        ASSERT_TRUE(tile.has_value());
+        tiles.push_back(*tile);
+    }
+
+    EXPECT_EQ(tiles[0], (ShadowAtlas::Tile {{0, 0}, 128}));
+    EXPECT_EQ(tiles[1], (ShadowAtlas::Tile {{128, 0}, 128}));
+    EXPECT_EQ(tiles[2], (ShadowAtlas::Tile {{0, 128}, 128}));
+    EXPECT_EQ(tiles[3], (ShadowAtlas::Tile {{128, 128}, 128}));
+    EXPECT_EQ(atlas.GetNumTiles(), 4);
+    EXPECT_EQ(atlas.GetFreeArea(), 0);
+
+    EXPECT_FALSE(atlas.Allocate(64).has_value());
+    EXPECT_FALSE(atlas.Allocate(512).has_value());
+}
+
+TEST(ShadowAtlas, RoundsSizesUp)
+{
+    ShadowAtlas atlas {1024, 64};
+
+    EXPECT_EQ(atlas.Allocate(100)->Size, 128);
+    EXPECT_EQ(atlas.Allocate(1)->Size, 64);
+    EXPECT_EQ(atlas.Allocate(0)->Size, 64);
+
+    EXPECT_THROW(ShadowAtlas(1000), AT2Exception);
+    EXPECT_THROW(ShadowAtlas(256, 512), AT2Exception);
+}
+
+TEST(ShadowAtlas, PrefersSmallestFreeNode)
+{
+    ShadowAtlas atlas {256};
+
+    const auto small = atlas.Allocate(64);
+    const auto big = atlas.Allocate(128);
+    const auto second = atlas.Allocate(64);
+    ASSERT_TRUE(small && big && second);
+
+    // the big tile doesn't split the quadrant left after the small one, the second small tile goes there
+    EXPECT_EQ(small->Offset, glm::uvec2(0, 0));
+    EXPECT_EQ(big->Offset, glm::uvec2(128, 0));
+    EXPECT_EQ(second->Offset, glm::uvec2(64, 0));
+}
+
+TEST(ShadowAtlas, MergesFreedQuadrants)
+{
+    ShadowAtlas atlas {256};
+
+    std::vector<ShadowAtlas::Tile> tiles;
+    while (const auto tile = atlas.Allocate(64))
+        tiles.push_back(*tile);
+    ASSERT_EQ(tiles.size(), 16);
+
+    for (const auto& tile : tiles)
+        atlas.Free(tile);
+
+    EXPECT_EQ(atlas.GetNumTiles(), 0);
+    EXPECT_EQ(atlas.GetFreeArea(), 256 * 256);
+    EXPECT_EQ(atlas.Allocate(256), (ShadowAtlas::Tile {{0, 0}, 256}));
+}
+
+TEST(ShadowAtlas, ThrowsOnUnknownTiles)
+{
+    ShadowAtlas atlas {256};
+    EXPECT_THROW(atlas.Free({{0, 0}, 64}), AT2Exception);
+
+    const auto tile = atlas.Allocate(64);
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_THROW(atlas.Free({{0, 0}, 128}), AT2Exception);
+    EXPECT_THROW(atlas.Free({{64, 0}, 64}), AT2Exception);
+
+    atlas.Free(*tile);
+    EXPECT_THROW(atlas.Free(*tile), AT2Exception);
+}
+
+TEST(ShadowAtlas, RandomAllocationsDontOverlap)
+{
+    ShadowAtlas atlas {2048, 32};
+    std::mt19937 random {7};
+
+    std::vector<ShadowAtlas::Tile> tiles;
+    for (int i = 0; i < 2000; ++i)
+    {
+        if (!tiles.empty() && random() % 3 == 0)
+        {
+            const auto index = random() % tiles.size();
+            atlas.Free(tiles[index]);
+            tiles.erase(tiles.begin() + static_cast<std::ptrdiff_t>(index));
+            continue;
+        }
+
+        if (const auto tile = atlas.Allocate(32u << random() % 5))
+        {
+            for (const auto& other : tiles)
+                ASSERT_FALSE(Overlap(*tile, other));
+            tiles.push_back(*tile);
+        }
+    }
+
+    size_t usedArea = 0;
+    for (const auto& tile : tiles)
+        usedArea += static_cast<size_t>(tile.Size) * tile.Size;
+    EXPECT_EQ(usedArea + atlas.GetFreeArea(), 2048 * 2048);
+
+    for (const auto& tile : tiles)
+        atlas.Free(tile);
+    EXPECT_TRUE(atlas.Allocate(2048).has_value());
+}
+
+TEST(ShadowAtlas, TileSizeFollowsCoverage)
+{
+    const ShadowAtlas atlas {4096, 64};
+
+    EXPECT_EQ(atlas.GetTileSize(1.0f, 1024), 1024);
+    EXPECT_EQ(atlas.GetTileSize(0.25f, 1024), 512);
+    EXPECT_EQ(atlas.GetTileSize(0.2f, 1024), 512);
+    EXPECT_EQ(atlas.GetTileSize(0.0f, 1024), 64);
+    EXPECT_EQ(atlas.GetTileSize(1.0f, 8192), 4096);
+    EXPECT_EQ(atlas.GetTileSize(1.0f, 1000), 512);
+}
+
+TEST(ShadowAtlas, TileMatrixMapsClipSpaceToTile)
+{
+    const ShadowAtlas atlas {4096};
+    const auto matrix = atlas.GetTileMatrix({{1024, 2048}, 1024});
+
+    const auto low = matrix * glm::vec4 {-1.0f, -1.0f, -1.0f, 1.0f};
+    const auto high = matrix * glm::vec4 {2.0f, 2.0f, 2.0f, 2.0f}; // not divided by w yet
+
+    EXPECT_FLOAT_EQ(low.x, 0.25f);
+    EXPECT_FLOAT_EQ(low.y, 0.5f);
+    EXPECT_FLOAT_EQ(low.z, 0.0f);
+    EXPECT_FLOAT_EQ(high.x / high.w, 0.5f);
+    EXPECT_FLOAT_EQ(high.y / high.w, 0.75f);
+    EXPECT_FLOAT_EQ(high.z / high.w, 1.0f);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ShadowCache.h>
+
+#include <limits>
+
+using namespace AT2;
+
+namespace
+{
+    // Box views of 20 units around the centers
+    glm::mat4 MakeView(const glm::vec3& center)
+    {
+        return glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, -10.0f, 10.0f) * glm::translate(glm::mat4 {1.0f}, -center);
+    }
+
+    const glm::mat4 LeftView = MakeView({-50.0f, 0.0f, 0.0f});
+    const glm::mat4 RightView = MakeView({50.0f, 0.0f, 0.0f});
+
+    const int CasterA = 0, CasterB = 0;
+
+    void UpdateCasters(ShadowCache& cache, std::initializer_list<std::pair<const void*, glm::vec3>> casters)
+    {
+        for (const auto& [key, position] : casters)
+            cache.UpdateCaster(key, position - 1.0f, position + 1.0f);
+        cache.EndCasterUpdates();
+    }
+} // namespace
+
+TEST(ShadowCache, ReusesStaticViews)
+{
+    ShadowCache cache;
+
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {-50.0f, 0.0f, 0.0f}}});
+    EXPECT_TRUE(cache.UpdateView(1, LeftView));
+    EXPECT_TRUE(cache.UpdateView(2, RightView));
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        cache.BeginFrame();
+        UpdateCasters(cache, {{&CasterA, {-50.0f, 0.0f, 0.0f}}});
+        EXPECT_FALSE(cache.UpdateView(1, LeftView));
+        EXPECT_FALSE(cache.UpdateView(2, RightView));
+    }
+
+    EXPECT_EQ(cache.GetStatistics().NumCasters, 1);
+    EXPECT_EQ(cache.GetStatistics().NumChangedCasters, 0);
+    EXPECT_EQ(cache.GetStatistics().NumViews, 2);
+    EXPECT_EQ(cache.GetStatistics().NumStaleViews, 0);
+
+    // a light moved
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {-50.0f, 0.0f, 0.0f}}});
+    EXPECT_TRUE(cache.UpdateView(1, MakeView({-49.0f, 0.0f, 0.0f})));
+    EXPECT_FALSE(cache.UpdateView(2, RightView));
+}
+
+TEST(ShadowCache, ChangedCastersInvalidateViewsTheyTouch)
+{
+    ShadowCache cache;
+
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {-50.0f, 0.0f, 0.0f}}, {&CasterB, {0.0f, 100.0f, 0.0f}}});
+    (void)cache.UpdateView(1, LeftView);
+    (void)cache.UpdateView(2, RightView);
+
+    // moving inside of the left view
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {-52.0f, 0.0f, 0.0f}}, {&CasterB, {0.0f, 100.0f, 0.0f}}});
+    EXPECT_TRUE(cache.UpdateView(1, LeftView));
+    EXPECT_FALSE(cache.UpdateView(2, RightView));
+    EXPECT_EQ(cache.GetStatistics().NumChangedCasters, 1);
+
+    // moving from the left view to the right one invalidates both of them
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {50.0f, 0.0f, 0.0f}}, {&CasterB, {0.0f, 100.0f, 0.0f}}});
+    EXPECT_TRUE(cache.UpdateView(1, LeftView));
+    EXPECT_TRUE(cache.UpdateView(2, RightView));
+
+    // moving outside of the views
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {50.0f, 0.0f, 0.0f}}, {&CasterB, {0.0f, 110.0f, 0.0f}}});
+    EXPECT_FALSE(cache.UpdateView(1, LeftView));
+    EXPECT_FALSE(cache.UpdateView(2, RightView));
+
+    // removed casters invalidate the views they were in
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterB, {0.0f, 110.0f, 0.0f}}});
+    EXPECT_FALSE(cache.UpdateView(1, LeftView));
+    EXPECT_TRUE(cache.UpdateView(2, RightView));
+    EXPECT_EQ(cache.GetStatistics().NumCasters, 1);
+}
+
+TEST(ShadowCache, ChangedStatesOfUnboundedCastersInvalidateViews)
+{
+    ShadowCache cache;
+    constexpr auto maxFloat = std::numeric_limits<float>::max();
+
+    const auto update = [&cache](std::uint64_t state) {
+        cache.BeginFrame();
+        cache.UpdateCaster(&CasterA, glm::vec3 {-maxFloat}, glm::vec3 {maxFloat}, state);
+        cache.EndCasterUpdates();
+    };
+
+    update(1);
+    (void)cache.UpdateView(1, LeftView);
+    (void)cache.UpdateView(2, RightView);
+
+    update(1);
+    EXPECT_FALSE(cache.UpdateView(1, LeftView));
+    EXPECT_FALSE(cache.UpdateView(2, RightView));
+
+    // the caster moved, but it's bounds are the same
+    update(2);
+    EXPECT_EQ(cache.GetStatistics().NumChangedCasters, 1);
+    EXPECT_TRUE(cache.UpdateView(1, LeftView));
+    EXPECT_TRUE(cache.UpdateView(2, RightView));
+}
+
+TEST(ShadowCache, ForgetsViewsMissingFrames)
+{
+    ShadowCache cache;
+
+    cache.BeginFrame();
+    UpdateCasters(cache, {});
+    EXPECT_TRUE(cache.UpdateView(1, LeftView));
+
+    // the view isn't updated while the caster moves through it
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {-50.0f, 0.0f, 0.0f}}});
+
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {-50.0f, 0.0f, 0.0f}}});
+    EXPECT_TRUE(cache.UpdateView(1, LeftView));
+
+    cache.BeginFrame();
+    UpdateCasters(cache, {{&CasterA, {-50.0f, 0.0f, 0.0f}}});
+    EXPECT_FALSE(cache.UpdateView(1, LeftView));
+
+    cache.Clear();
+    EXPECT_TRUE(cache.UpdateView(1, LeftView));
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ShadowCascades.h>
+
+#include <cmath>
+
+using namespace AT2;
+
+namespace
+{
+    const glm::mat4 Projection = glm::perspective(glm::radians(90.0f), 1.5f, 0.1f, 1000.0f);
+    const glm::vec3 LightDirection = glm::normalize(glm::vec3 {0.3f, 1.0f, 0.2f});
+
+    ShadowCascades::Parameters MakeParameters()
+    {
+        ShadowCascades::Parameters parameters;
+        parameters.ShadowDistance = 200.0f;
+        parameters.CasterDistance = 100.0f;
+        parameters.Resolution = 1024;
+        return parameters;
+    }
+
+    glm::vec3 Unproject(const glm::mat4& viewProjectionInverse, const glm::vec2& ndc, float depth, const glm::mat4& projection)
+    {
+        // NDC depth of the view-space depth
+        const auto clip = projection * glm::vec4 {0.0f, 0.0f, -depth, 1.0f};
+        const auto world = viewProjectionInverse * glm::vec4 {ndc, clip.z / clip.w, 1.0f};
+        return glm::vec3 {world} / world.w;
+    }
+} // namespace
+
+TEST(ShadowCascades, SplitsBlendUniformAndLogarithmic)
+{
+    const auto uniform = ShadowCascades::ComputeSplits(1.0f, 100.0f, 2, 0.0f);
+    ASSERT_EQ(uniform.size(), 3);
+    EXPECT_FLOAT_EQ(uniform[0], 1.0f);
+    EXPECT_FLOAT_EQ(uniform[1], 50.5f);
+    EXPECT_FLOAT_EQ(uniform[2], 100.0f);
+
+    const auto logarithmic = ShadowCascades::ComputeSplits(1.0f, 100.0f, 2, 1.0f);
+    EXPECT_FLOAT_EQ(logarithmic[1], 10.0f);
+
+    const auto blended = ShadowCascades::ComputeSplits(1.0f, 100.0f, 2, 0.5f);
+    EXPECT_FLOAT_EQ(blended[1], 30.25f);
+
+    EXPECT_THROW((void)ShadowCascades::ComputeSplits(0.0f, 100.0f, 2, 0.5f), AT2Exception);
+    EXPECT_THROW((void)ShadowCascades::ComputeSplits(1.0f, 100.0f, 0, 0.5f), AT2Exception);
+    EXPECT_THROW((void)ShadowCascades::ComputeSplits(1.0f, 100.0f, 2, 1.5f), AT2Exception);
+}
+
+TEST(ShadowCascades, CascadesCoverTheirSlices)
+{
+    const auto view = glm::lookAt(glm::vec3 {10.0f, 5.0f, -20.0f}, glm::vec3 {40.0f, 0.0f, -100.0f}, glm::vec3 {0.0f, 1.0f, 0.0f});
+    const auto viewProjectionInverse = glm::inverse(Projection * view);
+
+    ShadowCascades cascades;
+    cascades.Update(view, Projection, LightDirection, MakeParameters());
+
+    const auto result = cascades.GetCascades();
+    ASSERT_EQ(result.size(), ShadowCascades::MaxCascades);
+    EXPECT_FLOAT_EQ(result.back().FarDepth, 200.0f);
+
+    float nearDepth = 0.1f;
+    for (const auto& cascade : result)
+    {
+        EXPECT_GT(cascade.FarDepth, nearDepth);
+
+        const auto lightViewProjection = cascade.Projection * cascade.View;
+        for (const float depth : {nearDepth, cascade.FarDepth})
+            for (const glm::vec2 ndc : {glm::vec2 {-1.0f, -1.0f}, glm::vec2 {1.0f, -1.0f}, glm::vec2 {-1.0f, 1.0f}, glm::vec2 {1.0f, 1.0f}})
+            {
+                const auto corner = lightViewProjection * glm::vec4 {Unproject(viewProjectionInverse, ndc, depth, Projection), 1.0f};
+                EXPECT_LE(std::abs(corner.x), 1.0f);
+                EXPECT_LE(std::abs(corner.y), 1.0f);
+                EXPECT_LE(std::abs(corner.z), 1.0f);
+            }
+
+        // casters between the slice and the light are in the view
+        const auto center = Unproject(viewProjectionInverse, {0.0f, 0.0f}, (nearDepth + cascade.FarDepth) / 2, Projection);
+        const auto caster = lightViewProjection * glm::vec4 {center + LightDirection * 90.0f, 1.0f};
+        EXPECT_LE(std::abs(caster.z), 1.0f);
+
+        nearDepth = cascade.FarDepth;
+    }
+}
+
+TEST(ShadowCascades, CascadesAreSnappedToTexels)
+{
+    ShadowCascades cascades;
+
+    const auto view = glm::lookAt(glm::vec3 {0.0f}, glm::vec3 {0.0f, 0.0f, -1.0f}, glm::vec3 {0.0f, 1.0f, 0.0f});
+    cascades.Update(view, Projection, LightDirection, MakeParameters());
+    const std::vector<ShadowCascades::Cascade> original(cascades.GetCascades().begin(), cascades.GetCascades().end());
+
+    // the rotation of the camera doesn't change sizes of the cascades
+    const auto rotatedView = glm::rotate(view, 0.7f, glm::vec3 {0.0f, 1.0f, 0.0f});
+    cascades.Update(rotatedView, Projection, LightDirection, MakeParameters());
+    for (size_t i = 0; i < original.size(); ++i)
+    {
+        EXPECT_EQ(cascades.GetCascades()[i].Projection, original[i].Projection);
+
+        // views only move by whole texels, the depth is offset by the distance to the near plane
+        const auto& cascade = cascades.GetCascades()[i];
+        const float backDistance = cascade.TexelSize * (static_cast<float>(MakeParameters().Resolution) / 2.0f + 1.0f) + MakeParameters().CasterDistance;
+        for (const float offset : {cascade.View[3].x, cascade.View[3].y, cascade.View[3].z + backDistance})
+        {
+            const float texels = offset / cascade.TexelSize;
+            EXPECT_NEAR(texels, std::round(texels), 1e-2f);
+        }
+    }
+
+    // moves within a texel don't change the views, so cached shadow maps stay valid
+    cascades.Update(view, Projection, LightDirection, MakeParameters());
+    const auto movedView = glm::translate(view, glm::vec3 {0.3f, -0.2f, 0.5f} * (0.01f * original.front().TexelSize));
+    cascades.Update(movedView, Projection, LightDirection, MakeParameters());
+    for (size_t i = 0; i < original.size(); ++i)
+        EXPECT_EQ(cascades.GetCascades()[i].View, original[i].View) << "cascade " << i;
+
+    EXPECT_THROW(cascades.Update(view, glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.1f, 100.0f), LightDirection, MakeParameters()), AT2Exception);
+}
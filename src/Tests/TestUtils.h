@@ -0,0 +1,72 @@
+#pragma once
+
+#include <AT2/AT2.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace AT2::Tests
+{
+    // 90 degrees vertical field of view, so an object-space unit at distance 1 is half of the viewport height
+    inline const glm::mat4 Projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 1000.0f);
+
+    inline glm::mat4 LookFrom(const glm::vec3& eye, const glm::vec3& target)
+    {
+        return glm::lookAt(eye, target, glm::vec3 {0.0f, 1.0f, 0.0f});
+    }
+
+    struct Grid
+    {
+        std::vector<glm::vec3> Positions;
+        std::vector<uint32_t> Indices;
+    };
+
+    // Square grid of size x size quads at XY plane facing +Z, heightFunc displaces it's vertices
+    template <typename HeightFunc>
+    Grid MakeGrid(uint32_t size, HeightFunc&& heightFunc)
+    {
+        Grid grid;
+        for (uint32_t y = 0; y <= size; ++y)
+            for (uint32_t x = 0; x <= size; ++x)
+                grid.Positions.emplace_back(static_cast<float>(x), static_cast<float>(y), heightFunc(static_cast<float>(x), static_cast<float>(y)));
+
+        const auto vertex = [size](uint32_t x, uint32_t y) { return y * (size + 1) + x; };
+        for (uint32_t y = 0; y < size; ++y)
+            for (uint32_t x = 0; x < size; ++x)
+                grid.Indices.insert(grid.Indices.end(), {vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1),
+                                                         vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1)});
+
+        return grid;
+    }
+
+    inline Grid MakeGrid(uint32_t size, float height = 0.0f)
+    {
+        return MakeGrid(size, [height](float, float) { return height; });
+    }
+
+    // Empty directory in the system temporary directory, removed with it's content on destruction
+    class TemporaryDirectory
+    {
+    public:
+        explicit TemporaryDirectory(std::string_view name) : m_path {std::filesystem::temp_directory_path() / name}
+        {
+            std::filesystem::remove_all(m_path);
+            std::filesystem::create_directories(m_path);
+        }
+        ~TemporaryDirectory() { std::filesystem::remove_all(m_path); }
+
+        [[nodiscard]] const std::filesystem::path& GetPath() const noexcept { return m_path; }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    inline void WriteFile(const std::filesystem::path& path, std::string_view content)
+    {
+        std::ofstream {path} << content;
+    }
+
+} // namespace AT2::Tests
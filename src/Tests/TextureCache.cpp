@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/Resources/TextureCache.h>
+
+#include "FakeResources.h"
+
+using namespace AT2;
+using namespace AT2::Resources;
+using namespace AT2::Tests;
+
+namespace
+{
+    const TextureCache::SamplerState NearestClamp {TextureWrapParams::Uniform(TextureWrapMode::ClampToEdge),
+                                                   TextureSamplingParams::Uniform(TextureSamplingMode::Nearest)};
+    const TextureCache::SamplerState LinearRepeat {TextureWrapParams::Uniform(TextureWrapMode::Repeat),
+                                                   TextureSamplingParams::Uniform(TextureSamplingMode::Linear, true)};
+} // namespace
+
+TEST(TextureCache, FindsTextureByContentWhileItIsAlive)
+{
+    FakeVisualizationSystem renderer;
+    TextureCache cache {renderer};
+
+    const std::vector data {std::byte {1}, std::byte {2}, std::byte {3}};
+    const auto hash = TextureCache::ComputeHash(data);
+    ASSERT_NE(hash, TextureCache::ComputeHash(std::span {data}.first(2)));
+    ASSERT_EQ(cache.Find(hash), nullptr);
+
+    auto texture = std::make_shared<FakeTexture>(Texture2D {{4, 4}}, 4);
+    cache.Insert(hash, texture);
+    ASSERT_EQ(cache.Find(hash), texture);
+    ASSERT_EQ(cache.GetMemoryReport().NumHits, 1);
+    ASSERT_EQ(cache.GetMemoryReport().Entries.size(), 1);
+
+    texture.reset();
+    ASSERT_EQ(cache.Find(hash), nullptr);
+    ASSERT_TRUE(cache.GetMemoryReport().Entries.empty());
+}
+
+TEST(TextureCache, SharesViewsWithSameSampler)
+{
+    FakeVisualizationSystem renderer;
+    TextureCache cache {renderer};
+
+    const auto storage = std::make_shared<FakeTexture>(Texture2D {{4, 4}}, 4);
+    cache.Insert(1, storage);
+
+    const auto nearestView = cache.GetView(storage, NearestClamp);
+    const auto linearView = cache.GetView(storage, LinearRepeat);
+    ASSERT_NE(nearestView, linearView);
+    ASSERT_EQ(cache.GetView(storage, NearestClamp), nearestView);
+    ASSERT_EQ(renderer.Factory.NumCreatedViews, 2);
+
+    ASSERT_EQ(nearestView->GetWrapMode(), NearestClamp.Wrap);
+    ASSERT_EQ(linearView->GetSamplingParams(), LinearRepeat.Sampling);
+
+    const auto report = cache.GetMemoryReport();
+    ASSERT_EQ(report.Entries.size(), 1);
+    ASSERT_EQ(report.Entries[0].NumViews, 2);
+    ASSERT_EQ(report.TotalMemorySize, 4 * 4 * 4);
+}
+
+TEST(TextureCache, EstimatesMipChainAndFaces)
+{
+    ASSERT_EQ(TextureCache::EstimateMemorySize(FakeTexture {Texture2D {{4, 4}, 3}, 4}), (16 + 4 + 1) * 4);
+    ASSERT_EQ(TextureCache::EstimateMemorySize(FakeTexture {Texture2DArray {{4, 4, 2}, 2}, 1}), (16 + 4) * 2);
+    ASSERT_EQ(TextureCache::EstimateMemorySize(FakeTexture {Texture3D {{4, 4, 4}, 2}, 1}), 64 + 8);
+    ASSERT_EQ(TextureCache::EstimateMemorySize(FakeTexture {TextureCube {{2, 2}, 2}, 1}), (4 + 1) * 6);
+}
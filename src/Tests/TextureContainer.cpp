@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/Resources/TextureContainer.h>
+
+#include "FakeResources.h"
+
+#include <cstring>
+
+using namespace AT2;
+using namespace AT2::Resources;
+using namespace AT2::Tests;
+
+namespace
+{
+    class ContainerWriter
+    {
+    public:
+        template <typename T>
+        void Put(size_t offset, T value)
+        {
+            if (Data.size() < offset + sizeof(T))
+                Data.resize(offset + sizeof(T));
+            std::memcpy(Data.data() + offset, &value, sizeof(T));
+        }
+
+        void PutBytes(size_t offset, std::string_view bytes)
+        {
+            for (size_t i = 0; i < bytes.size(); ++i)
+                Put(offset + i, static_cast<unsigned char>(bytes[i]));
+        }
+
+        void Append(size_t length) { Data.resize(Data.size() + length); }
+
+        std::vector<std::byte> Data;
+    };
+
+    ContainerWriter MakeDdsHeader(glm::uvec2 size, unsigned numLevels)
+    {
+        ContainerWriter writer;
+        writer.PutBytes(0, "DDS ");
+        writer.Put<std::uint32_t>(4, 124);
+        writer.Put<std::uint32_t>(8, numLevels > 1 ? 0x20000 : 0);
+        writer.Put<std::uint32_t>(12, size.y);
+        writer.Put<std::uint32_t>(16, size.x);
+        writer.Put<std::uint32_t>(28, numLevels);
+        writer.Put<std::uint32_t>(76, 32);
+        writer.Put<std::uint32_t>(124, 0);
+        return writer;
+    }
+
+    ContainerWriter MakeDdsDx10Header(glm::uvec2 size, unsigned numLevels, std::uint32_t dxgiFormat, unsigned arraySize, bool isCube)
+    {
+        auto writer = MakeDdsHeader(size, numLevels);
+        writer.Put<std::uint32_t>(80, 0x4);
+        writer.PutBytes(84, "DX10");
+        writer.Put<std::uint32_t>(128, dxgiFormat);
+        writer.Put<std::uint32_t>(132, 3);
+        writer.Put<std::uint32_t>(136, isCube ? 0x4 : 0);
+        writer.Put<std::uint32_t>(140, arraySize);
+        writer.Put<std::uint32_t>(144, 0);
+        return writer;
+    }
+} // namespace
+
+TEST(TextureContainer, ComputesImageLengths)
+{
+    const ExternalTextureFormat bc1 {TextureLayout::RGB, BufferDataType::UByte, false, BlockCompression::BC1};
+    const ExternalTextureFormat bc7 {TextureLayout::RGBA, BufferDataType::UByte, false, BlockCompression::BC7};
+
+    ASSERT_EQ(GetImageDataLength(bc1, {8, 8, 1}), 4 * 8);
+    ASSERT_EQ(GetImageDataLength(bc7, {8, 8, 1}), 4 * 16);
+    // partial blocks are padded
+    ASSERT_EQ(GetImageDataLength(bc1, {1, 1, 1}), 8);
+    ASSERT_EQ(GetImageDataLength(bc7, {5, 2, 3}), 2 * 16 * 3);
+    ASSERT_EQ(GetImageDataLength({TextureLayout::BGR, BufferDataType::UByte}, {3, 3, 1}), 27);
+    ASSERT_EQ(GetImageDataLength({TextureLayout::RGBA, BufferDataType::HalfFloat}, {2, 2, 1}), 32);
+
+    ASSERT_EQ(TextureContainer::GetLevelSize({16, 4}, 1), glm::uvec2(8, 2));
+    ASSERT_EQ(TextureContainer::GetLevelSize({16, 4}, 3), glm::uvec2(2, 1));
+}
+
+TEST(TextureContainer, ParsesLegacyUncompressedDds)
+{
+    // like resources/rock04.dds: 24-bit BGR without mipmaps
+    auto writer = MakeDdsHeader({4, 2}, 1);
+    writer.Put<std::uint32_t>(80, 0x40);
+    writer.Put<std::uint32_t>(88, 24);
+    writer.Put<std::uint32_t>(92, 0xff0000);
+    writer.Append(4 * 2 * 3);
+
+    ASSERT_TRUE(TextureContainer::IsDds(writer.Data));
+    ASSERT_FALSE(TextureContainer::IsKtx2(writer.Data));
+
+    const auto layout = TextureContainer::Parse(writer.Data);
+    ASSERT_EQ(layout.Format.ChannelsLayout, TextureLayout::BGR);
+    ASSERT_EQ(layout.Format.Compression, BlockCompression::None);
+    ASSERT_EQ(layout.Size, glm::uvec2(4, 2));
+    ASSERT_EQ(layout.NumLevels, 1);
+    ASSERT_EQ(layout.Images.size(), 1);
+    ASSERT_EQ(layout.Images[0].Offset, 128);
+    ASSERT_EQ(layout.Images[0].Length, 24);
+    ASSERT_TRUE(std::holds_alternative<Texture2D>(TextureContainer::MakeDeclaration(layout)));
+}
+
+TEST(TextureContainer, ParsesDxt1MipChain)
+{
+    auto writer = MakeDdsHeader({8, 8}, 4);
+    writer.Put<std::uint32_t>(80, 0x4);
+    writer.PutBytes(84, "DXT1");
+    writer.Append(32 + 8 + 8 + 8);
+
+    const auto layout = TextureContainer::Parse(writer.Data);
+    ASSERT_EQ(layout.Format.Compression, BlockCompression::BC1);
+    ASSERT_EQ(layout.Format.ChannelsLayout, TextureLayout::RGB);
+    ASSERT_EQ(layout.NumLevels, 4);
+    ASSERT_EQ(layout.Images.size(), 4);
+
+    const size_t expectedOffsets[] {128, 160, 168, 176};
+    for (unsigned level = 0; level < 4; ++level)
+    {
+        ASSERT_EQ(layout.Images[level].Level, level);
+        ASSERT_EQ(layout.Images[level].Offset, expectedOffsets[level]);
+        ASSERT_EQ(layout.Images[level].Size, TextureContainer::GetLevelSize({8, 8}, level));
+    }
+
+    // the last level is missing
+    writer.Data.resize(writer.Data.size() - 1);
+    ASSERT_THROW((void)TextureContainer::Parse(writer.Data), AT2TextureException);
+}
+
+TEST(TextureContainer, ParsesDx10ArraysAndCubes)
+{
+    {
+        auto writer = MakeDdsDx10Header({4, 4}, 2, 99, 3, false);
+        writer.Append((16 + 16) * 3);
+
+        const auto layout = TextureContainer::Parse(writer.Data);
+        ASSERT_EQ(layout.Format.Compression, BlockCompression::BC7);
+        ASSERT_TRUE(layout.Format.PreferSRGB);
+        ASSERT_EQ(layout.NumLayers, 3);
+        ASSERT_EQ(layout.Images.size(), 6);
+        // layers are stored with their whole mip chains
+        ASSERT_EQ(layout.Images[1].Layer, 0);
+        ASSERT_EQ(layout.Images[1].Level, 1);
+        ASSERT_EQ(layout.Images[2].Layer, 1);
+        ASSERT_EQ(layout.Images[2].Offset, 148 + 32);
+        ASSERT_TRUE(std::holds_alternative<Texture2DArray>(TextureContainer::MakeDeclaration(layout)));
+    }
+
+    {
+        auto writer = MakeDdsDx10Header({4, 4}, 1, 80, 1, true);
+        writer.Append(8 * 6);
+
+        const auto layout = TextureContainer::Parse(writer.Data);
+        ASSERT_EQ(layout.Format.Compression, BlockCompression::BC4);
+        ASSERT_TRUE(layout.IsCubemap);
+        ASSERT_EQ(layout.NumLayers, 6);
+        ASSERT_EQ(layout.Images.back().Offset, 148 + 8 * 5);
+        ASSERT_TRUE(std::holds_alternative<TextureCube>(TextureContainer::MakeDeclaration(layout)));
+    }
+}
+
+TEST(TextureContainer, UploadsCubeFacesAsLayers)
+{
+    auto writer = MakeDdsDx10Header({4, 4}, 2, 80, 1, true);
+    writer.Append((8 + 8) * 6);
+
+    const auto layout = TextureContainer::Parse(writer.Data);
+    FakeTexture cube {TextureContainer::MakeDeclaration(layout)};
+    ASSERT_EQ(cube.GetSize(), glm::uvec3(4, 4, 6));
+
+    TextureContainer::Upload(cube, layout, writer.Data);
+    ASSERT_EQ(cube.Uploads.size(), 6 * 2);
+    for (unsigned face = 0; face < 6; ++face)
+    {
+        ASSERT_EQ(cube.Uploads[face * 2].Offset, glm::uvec3(0, 0, face));
+        ASSERT_EQ(cube.Uploads[face * 2 + 1].Size, glm::uvec3(2, 2, 1));
+        ASSERT_EQ(cube.Uploads[face * 2 + 1].Level, 1);
+    }
+
+    // layers out of the texture
+    FakeTexture array {Texture2DArray {{4, 4, 5}, 2}};
+    ASSERT_THROW(TextureContainer::Upload(array, layout, writer.Data), AT2TextureException);
+}
+
+TEST(TextureContainer, ParsesKtx2)
+{
+    constexpr size_t LevelIndex = 80, DataOffset = LevelIndex + 2 * 24;
+
+    ContainerWriter writer;
+    writer.PutBytes(0, "\xABKTX 20\xBB\r\n\x1A\n");
+    writer.Put<std::uint32_t>(12, 141); // BC5 unorm
+    writer.Put<std::uint32_t>(16, 1);
+    writer.Put<std::uint32_t>(20, 8);
+    writer.Put<std::uint32_t>(24, 4);
+    writer.Put<std::uint32_t>(28, 0);
+    writer.Put<std::uint32_t>(32, 2);
+    writer.Put<std::uint32_t>(36, 1);
+    writer.Put<std::uint32_t>(40, 2);
+    writer.Put<std::uint32_t>(44, 0);
+
+    // levels are stored from the smallest one
+    writer.Put<std::uint64_t>(LevelIndex, DataOffset + 2 * 16);
+    writer.Put<std::uint64_t>(LevelIndex + 8, 2 * 32);
+    writer.Put<std::uint64_t>(LevelIndex + 24, DataOffset);
+    writer.Put<std::uint64_t>(LevelIndex + 32, 2 * 16);
+    writer.Append(2 * 16 + 2 * 32);
+
+    ASSERT_TRUE(TextureContainer::IsKtx2(writer.Data));
+
+    const auto layout = TextureContainer::Parse(writer.Data);
+    ASSERT_EQ(layout.Format.Compression, BlockCompression::BC5);
+    ASSERT_EQ(layout.Format.ChannelsLayout, TextureLayout::RG);
+    ASSERT_EQ(layout.Size, glm::uvec2(8, 4));
+    ASSERT_EQ(layout.NumLayers, 2);
+    ASSERT_EQ(layout.Images.size(), 4);
+    ASSERT_EQ(layout.Images[1].Layer, 1);
+    ASSERT_EQ(layout.Images[1].Offset, DataOffset + 2 * 16 + 32);
+    ASSERT_EQ(layout.Images[2].Level, 1);
+    ASSERT_EQ(layout.Images[2].Offset, DataOffset);
+    ASSERT_EQ(layout.Images[3].Length, 16);
+
+    writer.Put<std::uint32_t>(44, 2); // zstd
+    ASSERT_THROW((void)TextureContainer::Parse(writer.Data), AT2NotImplementedException);
+}
+
+TEST(TextureContainer, WritesDdsWhichParsesBack)
+{
+    TextureContainerLayout layout;
+    layout.Format = {TextureLayout::RGBA, BufferDataType::UByte, true, BlockCompression::BC3};
+    layout.Size = {8, 4};
+    layout.NumLevels = 2;
+    layout.NumLayers = 2;
+
+    // images are given level by level, but DDS stores whole chain of a layer together
+    std::vector<std::byte> data;
+    for (unsigned level = 0; level < layout.NumLevels; ++level)
+        for (unsigned layer = 0; layer < layout.NumLayers; ++layer)
+        {
+            const auto size = TextureContainer::GetLevelSize(layout.Size, level);
+            const auto length = GetImageDataLength(layout.Format, {size, 1});
+            layout.Images.push_back({level, layer, size, data.size(), length});
+            data.insert(data.end(), length, static_cast<std::byte>(level * 2 + layer));
+        }
+
+    const auto dds = TextureContainer::WriteDds(layout, data);
+    const auto parsed = TextureContainer::Parse(dds);
+    ASSERT_EQ(parsed.Format, layout.Format);
+    ASSERT_EQ(parsed.Size, layout.Size);
+    ASSERT_EQ(parsed.NumLevels, 2);
+    ASSERT_EQ(parsed.NumLayers, 2);
+    ASSERT_EQ(parsed.Images.size(), 4);
+
+    for (const auto& image : parsed.Images)
+        ASSERT_EQ(dds[image.Offset], static_cast<std::byte>(image.Level * 2 + image.Layer));
+
+    layout.Format = {TextureLayout::BGR, BufferDataType::UByte};
+    ASSERT_THROW((void)TextureContainer::WriteDds(layout, data), AT2TextureException);
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include <AT2/AT2.h>
+#include <AT2/Core/Resources/TextureManifest.h>
+
+#include "TestUtils.h"
+
+using namespace AT2;
+using namespace AT2::Resources;
+using namespace AT2::Tests;
+using namespace std::literals;
+
+TEST(TextureManifest, RedirectsToActualCookedFiles)
+{
+    const TemporaryDirectory directory {"AT2_TextureManifest"};
+    const auto source = directory.GetPath() / "stone.png";
+    const auto cooked = directory.GetPath() / "cooked" / "stone.dds";
+    std::filesystem::create_directories(cooked.parent_path());
+    WriteFile(source, "png");
+    WriteFile(cooked, "dds");
+    std::filesystem::last_write_time(cooked, std::filesystem::last_write_time(source) + 1s);
+
+    TextureManifest manifest;
+    manifest.Add(source, cooked);
+    manifest.Save(directory.GetPath() / "cooked" / "textures.json");
+
+    const auto loaded = std::make_shared<TextureManifest>(TextureManifest::Load(directory.GetPath() / "cooked" / "textures.json"));
+    ASSERT_EQ(loaded->GetNumEntries(), 1);
+    ASSERT_EQ(loaded->Find(source), cooked.lexically_normal());
+    ASSERT_FALSE(loaded->Find(directory.GetPath() / "other.png"));
+
+    const std::vector sourceOnly {source};
+    ASSERT_EQ(TextureManifest::GetDependencies(source), sourceOnly);
+
+    TextureManifest::SetActive(loaded);
+    ASSERT_EQ(TextureManifest::Redirect(source), cooked.lexically_normal());
+
+    // edited source is newer than it's cooked version, but cooking it again must be noticed
+    std::filesystem::last_write_time(source, std::filesystem::last_write_time(cooked) + 1s);
+    ASSERT_EQ(TextureManifest::Redirect(source), source);
+    ASSERT_EQ(TextureManifest::GetDependencies(source), (std::vector {source, cooked.lexically_normal()}));
+
+    TextureManifest::SetActive(nullptr);
+    ASSERT_THROW((void)TextureManifest::Load(directory.GetPath() / "missing.json"), AT2IOException);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/TextureSlotTable.h>
+
+#include <string>
+#include <vector>
+
+using namespace AT2;
+
+namespace
+{
+    using Table = TextureSlotTable<std::string, unsigned int>;
+
+    unsigned int MakeHandle(const std::string& key) { return static_cast<unsigned int>(key.size()); }
+}
+
+TEST(TextureSlotTable, RepeatedAcquireIsHit)
+{
+    Table table(4);
+
+    const auto first = table.Acquire("albedo", MakeHandle);
+    ASSERT_TRUE(first.IsNew);
+
+    const auto second = table.Acquire("albedo", MakeHandle);
+    ASSERT_FALSE(second.IsNew);
+    ASSERT_EQ(first.Slot, second.Slot);
+
+    ASSERT_EQ(table.GetStatistics().Hits, 1);
+    ASSERT_EQ(table.GetStatistics().Misses, 1);
+    ASSERT_EQ(table.GetStatistics().Evictions, 0);
+}
+
+TEST(TextureSlotTable, EvictsLeastRecentlyUsed)
+{
+    Table table(2);
+
+    const auto a = table.Acquire("a", MakeHandle).Slot;
+    table.Acquire("b", MakeHandle);
+    table.Acquire("a", MakeHandle); // "b" is least recently used now
+
+    const auto c = table.Acquire("c", MakeHandle);
+    ASSERT_TRUE(c.IsNew);
+    ASSERT_EQ(table.Find("a"), a);
+    ASSERT_FALSE(table.Find("b").has_value());
+    ASSERT_EQ(table.GetStatistics().Evictions, 1);
+}
+
+TEST(TextureSlotTable, PinnedKeysAreNeverEvicted)
+{
+    Table table(2);
+
+    const auto pinnedSlot = table.Pin("gbuffer", MakeHandle);
+    for (int i = 0; i < 10; ++i)
+        table.Acquire("texture" + std::to_string(i), MakeHandle);
+
+    ASSERT_EQ(table.Find("gbuffer"), pinnedSlot);
+    ASSERT_TRUE(table.IsPinned("gbuffer"));
+
+    table.Pin("other", MakeHandle);
+    ASSERT_THROW(table.Acquire("one_more", MakeHandle), AT2Exception);
+
+    ASSERT_TRUE(table.Unpin("other"));
+    ASSERT_NO_THROW(table.Acquire("one_more", MakeHandle));
+    ASSERT_EQ(table.Find("gbuffer"), pinnedSlot);
+}
+
+TEST(TextureSlotTable, FlushesOnlyChangedRanges)
+{
+    Table table(8);
+
+    table.Acquire("a", MakeHandle);
+    table.Acquire("bb", MakeHandle);
+    table.Acquire("ccc", MakeHandle);
+
+    std::vector<std::pair<unsigned int, std::vector<unsigned int>>> ranges;
+    const auto collect = [&](unsigned int first, std::span<const unsigned int> handles) {
+        ranges.emplace_back(first, std::vector<unsigned int>(handles.begin(), handles.end()));
+    };
+
+    table.FlushDirty(collect);
+    ASSERT_EQ(ranges.size(), 1);
+    ASSERT_EQ(ranges[0].first, 0);
+    ASSERT_EQ(ranges[0].second, (std::vector<unsigned int> {1, 2, 3}));
+
+    // nothing changed, nothing to bind
+    ranges.clear();
+    table.Acquire("a", MakeHandle);
+    table.FlushDirty(collect);
+    ASSERT_TRUE(ranges.empty());
+
+    table.Acquire("dddd", MakeHandle);
+    table.FlushDirty(collect);
+    ASSERT_EQ(ranges.size(), 1);
+    ASSERT_EQ(ranges[0].first, 3);
+    ASSERT_EQ(ranges[0].second, (std::vector<unsigned int> {4}));
+}
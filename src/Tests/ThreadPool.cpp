@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/ThreadPool.h>
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace AT2;
+
+TEST(ThreadPool, ReturnsResults)
+{
+    ThreadPool pool {4};
+    ASSERT_EQ(pool.GetNumThreads(), 4);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i)
+        results.push_back(pool.Submit([i] { return i * i; }));
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(results[i].get(), i * i);
+}
+
+TEST(ThreadPool, PassesExceptions)
+{
+    ThreadPool pool {1};
+
+    auto failed = pool.Submit([]() -> int { throw std::runtime_error("task failed"); });
+    auto succeeded = pool.Submit([] { return 42; });
+
+    ASSERT_THROW(failed.get(), std::runtime_error);
+    ASSERT_EQ(succeeded.get(), 42);
+}
+
+TEST(ThreadPool, FinishesTasksOnDestruction)
+{
+    std::atomic<int> counter = 0;
+    {
+        ThreadPool pool {2};
+        for (int i = 0; i < 1000; ++i)
+            static_cast<void>(pool.Submit([&counter] { ++counter; }));
+    }
+
+    ASSERT_EQ(counter, 1000);
+}
+
+TEST(ThreadPool, ParallelForCoversRangeOnce)
+{
+    ThreadPool pool {3};
+
+    std::vector<std::atomic<int>> visits(1001);
+    pool.ParallelFor(visits.size(), 10, [&visits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            ++visits[i];
+    });
+
+    for (const auto& numVisits : visits)
+        ASSERT_EQ(numVisits, 1);
+
+    ASSERT_THROW(pool.ParallelFor(100, 1, [](size_t begin, size_t) {
+        if (begin == 0)
+            throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+}
+
+TEST(ThreadPool, ParallelForDoesntWaitForQueuedTasks)
+{
+    ThreadPool pool {1};
+
+    // the worker is busy, and there are tasks queued behind it
+    std::promise<void> release;
+    auto blocker = pool.Submit([released = release.get_future()] { released.wait(); });
+    auto queued = pool.Submit([] {});
+
+    std::atomic<size_t> numVisited = 0;
+    pool.ParallelFor(100, 1, [&numVisited](size_t begin, size_t end) { numVisited += end - begin; });
+    ASSERT_EQ(numVisited, 100);
+
+    release.set_value();
+    blocker.get();
+    queued.get();
+}
+
+TEST(ThreadPool, ParallelForRunsInTasksOfThePool)
+{
+    ThreadPool pool {2};
+
+    auto sum = pool.Submit([&pool] {
+        std::atomic<size_t> result = 0;
+        pool.ParallelFor(1000, 10, [&result](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                result += i;
+        });
+        return result.load();
+    });
+
+    ASSERT_EQ(sum.get(), 999 * 1000 / 2);
+}
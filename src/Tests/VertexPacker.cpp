@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <AT2/AT2_exceptions.hpp>
+#include <AT2/Core/VertexPacker.h>
+
+#include <cstring>
+
+using namespace AT2;
+
+namespace
+{
+    using Semantic = VertexPacker::Semantic;
+
+    template <typename T>
+    VertexPacker::Attribute MakeAttribute(unsigned int index, Semantic semantic, const std::vector<T>& data)
+    {
+        return {index, semantic, BufferDataTypes::BufferTypeOf<T>, std::as_bytes(std::span {data})};
+    }
+
+    glm::vec4 ReadPacked(const VertexPacker::PackedVertices& vertices, size_t attribute, size_t vertex)
+    {
+        const auto& bindingParams = vertices.Attributes.at(attribute).BindingParams;
+        return VertexPacker::ReadElement(bindingParams, vertices.Data.data() + vertex * vertices.Stride + bindingParams.Offset);
+    }
+} // namespace
+
+TEST(VertexPacker, InterleavesAttributes)
+{
+    const std::vector<glm::vec3> positions {{1, 2, 3}, {4, 5, 6}};
+    const std::vector<glm::vec3> normals {{0, 0, 1}, {0, 1, 0}};
+    const std::vector<glm::vec2> texCoords {{0, 0}, {1, 0.5f}};
+
+    const auto attributes = std::to_array({MakeAttribute(1, Semantic::Position, positions),
+                                           MakeAttribute(2, Semantic::TexCoord, texCoords),
+                                           MakeAttribute(3, Semantic::Normal, normals)});
+    const auto packed = VertexPacker::Pack(attributes);
+
+    ASSERT_EQ(packed.NumVertices, 2u);
+    ASSERT_EQ(packed.Stride, 12u + 4u + 4u);
+    ASSERT_EQ(packed.Data.size(), packed.NumVertices * packed.Stride);
+    ASSERT_EQ(packed.Attributes.size(), 3u);
+
+    const auto expectedOffsets = std::to_array<unsigned int>({0, 12, 16});
+    for (size_t i = 0; i < packed.Attributes.size(); ++i)
+    {
+        const auto& [attributeIndex, bindingParams] = packed.Attributes[i];
+        EXPECT_EQ(attributeIndex, attributes[i].AttributeIndex);
+        EXPECT_EQ(bindingParams.Offset, expectedOffsets[i]);
+        EXPECT_EQ(bindingParams.Stride, packed.Stride);
+    }
+
+    // positions are not quantized
+    EXPECT_EQ(packed.Attributes[0].BindingParams.Type, BufferDataType::Float);
+    EXPECT_EQ(glm::vec3 {ReadPacked(packed, 0, 1)}, positions[1]);
+}
+
+TEST(VertexPacker, QuantizesNormalsAndTangents)
+{
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec4> tangents;
+    for (int i = 0; i < 64; ++i)
+    {
+        const float angle = static_cast<float>(i) * 0.4f;
+        normals.push_back(glm::normalize(glm::vec3 {std::cos(angle), std::sin(angle * 0.7f), std::sin(angle) - 0.3f}));
+        tangents.emplace_back(glm::normalize(glm::vec3 {-std::sin(angle), std::cos(angle), 0.5f}), i % 2 ? 1.0f : -1.0f);
+    }
+
+    const auto attributes = std::to_array({MakeAttribute(3, Semantic::Normal, normals), MakeAttribute(6, Semantic::Tangent, tangents)});
+    const auto packed = VertexPacker::Pack(attributes);
+
+    for (const auto& [attributeIndex, bindingParams] : packed.Attributes)
+    {
+        EXPECT_EQ(bindingParams.Type, BufferDataType::Int2101010Rev);
+        EXPECT_TRUE(bindingParams.IsNormalized);
+    }
+    ASSERT_EQ(packed.Stride, 8u);
+
+    for (size_t i = 0; i < normals.size(); ++i)
+    {
+        const auto normal = glm::vec3 {ReadPacked(packed, 0, i)};
+        const auto tangent = ReadPacked(packed, 1, i);
+
+        // 10 bits per component gives about 0.1 degree precision
+        EXPECT_GT(glm::dot(normal, normals[i]), 0.9999f);
+        EXPECT_GT(glm::dot(glm::vec3 {tangent}, glm::vec3 {tangents[i]}), 0.9999f);
+        EXPECT_EQ(tangent.w, tangents[i].w);
+    }
+}
+
+TEST(VertexPacker, ChoosesTexCoordFormatByRange)
+{
+    const std::vector<glm::vec2> normalizedTexCoords {{0, 0}, {1, 1}, {0.25f, 0.75f}};
+    const std::vector<glm::vec2> tiledTexCoords {{0, 0}, {4, -2}, {0.25f, 0.75f}};
+
+    const auto normalized = VertexPacker::Pack(std::to_array({MakeAttribute(2, Semantic::TexCoord, normalizedTexCoords)}));
+    const auto tiled = VertexPacker::Pack(std::to_array({MakeAttribute(2, Semantic::TexCoord, tiledTexCoords)}));
+
+    EXPECT_EQ(normalized.Attributes[0].BindingParams.Type, BufferDataType::UShort);
+    EXPECT_TRUE(normalized.Attributes[0].BindingParams.IsNormalized);
+    EXPECT_EQ(tiled.Attributes[0].BindingParams.Type, BufferDataType::HalfFloat);
+    EXPECT_FALSE(tiled.Attributes[0].BindingParams.IsNormalized);
+
+    for (size_t i = 0; i < normalizedTexCoords.size(); ++i)
+    {
+        EXPECT_NEAR(ReadPacked(normalized, 0, i).x, normalizedTexCoords[i].x, 1.0f / 65535.0f);
+        EXPECT_NEAR(ReadPacked(normalized, 0, i).y, normalizedTexCoords[i].y, 1.0f / 65535.0f);
+        // values are exactly representable as half floats
+        EXPECT_EQ(glm::vec2 {ReadPacked(tiled, 0, i)}, tiledTexCoords[i]);
+    }
+}
+
+TEST(VertexPacker, KeepsWeightsSumAndJointIndices)
+{
+    const std::vector<glm::vec4> weights {{1.0f / 3, 1.0f / 3, 1.0f / 3, 0}, {0.5f, 0.25f, 0.125f, 0.125f}, {1, 0, 0, 0}};
+    const std::vector<glm::u16vec4> smallJoints {{0, 1, 2, 3}, {255, 4, 0, 0}, {7, 7, 7, 7}};
+    const std::vector<glm::u16vec4> largeJoints {{0, 1, 2, 3}, {256, 4, 0, 0}, {7, 7, 7, 7}};
+
+    const auto packed = VertexPacker::Pack(std::to_array({MakeAttribute(4, Semantic::Joints, smallJoints),
+                                                          MakeAttribute(5, Semantic::Weights, weights)}));
+    ASSERT_EQ(packed.Stride, 8u);
+    EXPECT_EQ(packed.Attributes[0].BindingParams.Type, BufferDataType::UByte);
+    EXPECT_FALSE(packed.Attributes[0].BindingParams.IsNormalized);
+    EXPECT_EQ(packed.Attributes[1].BindingParams.Type, BufferDataType::UByte);
+    EXPECT_TRUE(packed.Attributes[1].BindingParams.IsNormalized);
+
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        EXPECT_EQ(glm::u16vec4 {ReadPacked(packed, 0, i)}, smallJoints[i]);
+
+        glm::u8vec4 packedWeights;
+        std::memcpy(&packedWeights, packed.Data.data() + i * packed.Stride + packed.Attributes[1].BindingParams.Offset, sizeof(packedWeights));
+        EXPECT_EQ(packedWeights.x + packedWeights.y + packedWeights.z + packedWeights.w, 255);
+        for (glm::length_t j = 0; j < 4; ++j)
+            EXPECT_NEAR(packedWeights[j] / 255.0f, weights[i][j], 1.0f / 255.0f);
+    }
+
+    const auto wide = VertexPacker::Pack(std::to_array({MakeAttribute(4, Semantic::Joints, largeJoints)}));
+    EXPECT_EQ(wide.Attributes[0].BindingParams.Type, BufferDataType::UShort);
+    EXPECT_EQ(glm::u16vec4 {ReadPacked(wide, 0, 1)}, largeJoints[1]);
+}
+
+TEST(VertexPacker, RejectsInconsistentAttributes)
+{
+    const std::vector<glm::vec3> positions {{1, 2, 3}, {4, 5, 6}};
+    const std::vector<glm::vec3> normals {{0, 0, 1}};
+
+    EXPECT_THROW((void)VertexPacker::Pack(std::to_array({MakeAttribute(1, Semantic::Position, positions),
+                                                   MakeAttribute(3, Semantic::Normal, normals)})),
+                 AT2Exception);
+    EXPECT_THROW((void)VertexPacker::Pack({}), AT2Exception);
+
+    // interleaved sources are not supported
+    auto strided = MakeAttribute(1, Semantic::Position, positions);
+    strided.BindingParams.Stride = 24;
+    EXPECT_THROW((void)VertexPacker::Pack(std::span {&strided, 1}), AT2Exception);
+}
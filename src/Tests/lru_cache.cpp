@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <AT2/Core/lru_cache.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    struct StringHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view> {}(str); }
+    };
+
+    auto NoDrop = [](auto&&) {};
+}
+
+TEST(LruCache, PutReturnsExistingValue)
+{
+    lru_cache<int, int> cache(4);
+
+    int factoryCalls = 0;
+    const auto factory = [&](int key) { ++factoryCalls; return key * 10; };
+
+    ASSERT_EQ(cache.put(1, factory, NoDrop).second, 10);
+    ASSERT_EQ(cache.put(1, factory, NoDrop).second, 10);
+    ASSERT_EQ(factoryCalls, 1);
+    ASSERT_EQ(cache.size(), 1);
+    ASSERT_TRUE(cache.exists(1));
+    ASSERT_FALSE(cache.exists(2));
+}
+
+TEST(LruCache, DropsLeastRecentlyUsed)
+{
+    lru_cache<int, int> cache(3);
+
+    std::vector<int> dropped;
+    const auto onDrop = [&](std::pair<int, int>&& entry) { dropped.push_back(entry.first); };
+    const auto factory = [](int key) { return key; };
+
+    for (int key : {1, 2, 3})
+        cache.put(key, factory, onDrop);
+
+    cache.put(1, factory, onDrop); // 2 is least recently used now
+    cache.put(4, factory, onDrop);
+    cache.put(5, factory, onDrop);
+
+    ASSERT_EQ(dropped, (std::vector<int> {2, 3}));
+    ASSERT_EQ(cache.size(), 3);
+    ASSERT_TRUE(cache.exists(1) && cache.exists(4) && cache.exists(5));
+}
+
+TEST(LruCache, IndexStaysConsistentUnderChurn)
+{
+    // small capacity with many colliding keys stresses backward shift deletion
+    constexpr int capacity = 7;
+    lru_cache<int, int> cache(capacity);
+
+    for (int key = 0; key < 10000; ++key)
+    {
+        cache.put(key * 16, [](int key) { return -key; }, NoDrop);
+        for (int recent = std::max(0, key - capacity + 1); recent <= key; ++recent)
+        {
+            const auto value = cache.find(recent * 16);
+            ASSERT_TRUE(value.has_value());
+            ASSERT_EQ(value->get(), -recent * 16);
+        }
+        ASSERT_FALSE(cache.exists((key - capacity) * 16));
+    }
+}
+
+TEST(LruCache, HeterogeneousLookup)
+{
+    lru_cache<std::string, int, StringHash, std::equal_to<>> cache(2);
+
+    cache.put(std::string_view {"albedo"}, [](std::string_view) { return 1; }, NoDrop);
+    ASSERT_TRUE(cache.exists("albedo"));
+    ASSERT_TRUE(cache.find(std::string_view {"albedo"}).has_value());
+    ASSERT_FALSE(cache.find("normal").has_value());
+}
+
+TEST(LruCache, EmplaceConstructsInPlace)
+{
+    lru_cache<int, std::unique_ptr<int>> cache(2);
+
+    auto [entry, isNew] = cache.try_emplace(1, std::make_unique<int>(42));
+    ASSERT_TRUE(isNew);
+    ASSERT_EQ(*entry.second, 42);
+
+    auto [sameEntry, isNewAgain] = cache.try_emplace(1, std::make_unique<int>(0));
+    ASSERT_FALSE(isNewAgain);
+    ASSERT_EQ(*sameEntry.second, 42);
+}
+
+TEST(LruCache, FailedConstructionKeepsCacheUsable)
+{
+    lru_cache<int, int> cache(1);
+
+    ASSERT_THROW(cache.put(1, [](int) -> int { throw std::runtime_error("failed"); }, NoDrop), std::runtime_error);
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_FALSE(cache.exists(1));
+
+    ASSERT_EQ(cache.put(2, [](int key) { return key; }, NoDrop).second, 2);
+    ASSERT_EQ(cache.size(), 1);
+}